@@ -0,0 +1,138 @@
+/**
+ * C++ wrapper overhead benchmark for libSzConfigTool
+ *
+ * Runs the same calls through the raw C API and through libSzConfigTool.hpp,
+ * back to back, and reports both means and their ratio:
+ * 1. String API edit (addDataSource)
+ * 2. Handle open / serialize / close
+ * 3. Handle edits (handleAddDataSource)
+ * 4. Borrowed-view reads (handleListFeatures)
+ *
+ * Usage: bench_cpp [config.json] [iterations]
+ *
+ * Generate large configs with:
+ *   cargo bench --bench configtool -- --emit-config 10 g2config_10x.json
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "../../include/libSzConfigTool.hpp"
+
+#define CHECK(condition, message)                                                      \
+    if (!(condition)) {                                                                \
+        std::fprintf(stderr, "FAIL: %s: %s\n", message, SzConfigTool_getLastError()); \
+        std::exit(1);                                                                  \
+    }
+
+static const char *DEFAULT_CONFIG =
+    "{\"G2_CONFIG\":{\"CFG_DSRC\":[],\"CFG_FCLASS\":[{\"FCLASS_ID\":1,\"FCLASS_CODE\":\"OTHER\"}],"
+    "\"CFG_FTYPE\":[{\"FTYPE_ID\":1,\"FTYPE_CODE\":\"NAME\",\"FCLASS_ID\":1}],"
+    "\"CFG_FELEM\":[{\"FELEM_ID\":1,\"FELEM_CODE\":\"FULL_NAME\"}],"
+    "\"CFG_FBOM\":[{\"FTYPE_ID\":1,\"FELEM_ID\":1,\"EXEC_ORDER\":1}],"
+    "\"CFG_GENERIC_THRESHOLD\":[],\"CFG_GPLAN\":[]}}";
+
+/* Keeps results alive so the calls are not optimized away */
+static volatile size_t sink;
+
+template <typename F>
+static double time_us(int iterations, F body) {
+    for (int i = 0; i < iterations / 10 + 1; i++) {
+        body(-1 - i);  // warm-up
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        body(i);
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+static void report(const char *name, int iterations, double c_us, double cpp_us) {
+    std::printf("%-30s %8d iters   C %12.3f us   C++ %12.3f us   ratio %.3f\n", name, iterations, c_us,
+                cpp_us, cpp_us / c_us);
+}
+
+static std::string read_file(const char *path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::perror(path);
+        std::exit(1);
+    }
+    std::ostringstream data;
+    data << in.rdbuf();
+    return data.str();
+}
+
+int main(int argc, char **argv) {
+    std::string config = argc > 1 ? read_file(argv[1]) : DEFAULT_CONFIG;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 100;
+    if (iterations <= 0) {
+        iterations = 100;
+    }
+
+    std::printf("=== libSzConfigTool C++ wrapper benchmark (%zu byte config) ===\n", config.size());
+
+    // 1. String API
+    double c_us = time_us(iterations, [&](int) {
+        SzConfigTool_result r = SzConfigTool_addDataSource(config.c_str(), "BENCH_DS");
+        CHECK(r.returnCode == 0, "addDataSource");
+        sink = std::strlen(r.response);
+        SzConfigTool_free(r.response);
+    });
+    double cpp_us = time_us(iterations, [&](int) {
+        sz::String result = sz::call(SzConfigTool_addDataSource, config, "BENCH_DS");
+        sink = result.view().size();
+    });
+    report("addDataSource (string API)", iterations, c_us, cpp_us);
+
+    // 2. Handle lifecycle
+    c_us = time_us(iterations, [&](int) {
+        SzConfigTool_handle *handle = SzConfigTool_open(config.c_str());
+        CHECK(handle != nullptr, "open");
+        SzConfigTool_result r = SzConfigTool_serialize(handle);
+        CHECK(r.returnCode == 0, "serialize");
+        sink = std::strlen(r.response);
+        SzConfigTool_free(r.response);
+        SzConfigTool_close(handle);
+    });
+    cpp_us = time_us(iterations, [&](int) {
+        sz::Config handle = sz::Config::open(config);
+        sink = handle.serialize().view().size();
+    });
+    report("open + serialize + close", iterations, c_us, cpp_us);
+
+    // 3. Handle edits
+    SzConfigTool_handle *raw = SzConfigTool_open(config.c_str());
+    CHECK(raw != nullptr, "open");
+    sz::Config wrapped = sz::Config::open(config);
+    char code[32];
+
+    c_us = time_us(iterations, [&](int i) {
+        std::snprintf(code, sizeof(code), "BENCH_DS_%d", i);
+        CHECK(SzConfigTool_handleAddDataSource(raw, code) == 0, "handleAddDataSource");
+    });
+    cpp_us = time_us(iterations, [&](int i) {
+        std::snprintf(code, sizeof(code), "BENCH_DS_%d", i);
+        wrapped.addDataSource(code);
+    });
+    report("handleAddDataSource", iterations, c_us, cpp_us);
+
+    // 4. Borrowed views
+    c_us = time_us(iterations, [&](int) {
+        const char *view = nullptr;
+        size_t view_len = 0;
+        CHECK(SzConfigTool_handleListFeatures(raw, &view, &view_len) == 0, "handleListFeatures");
+        sink = view_len;
+    });
+    cpp_us = time_us(iterations, [&](int) { sink = wrapped.listFeatures().size(); });
+    report("handleListFeatures (view)", iterations, c_us, cpp_us);
+
+    SzConfigTool_close(raw);
+    return 0;
+}
@@ -0,0 +1,165 @@
+/**
+ * FFI round-trip benchmark for libSzConfigTool
+ *
+ * Measures the cost of calling the library from C, including string
+ * marshalling and SzConfigTool_free:
+ * 1. String API edit (addDataSource) and read (listFeatures)
+ * 2. Caller-buffer read (listFeaturesToBuffer)
+ * 3. Handle open / serialize / close
+ * 4. Handle edits and borrowed-view reads
+ * 5. Batch command script (applyCommands)
+ *
+ * Usage: bench_ffi [config.json] [iterations]
+ *
+ * Generate large configs with:
+ *   cargo bench --bench configtool -- --emit-config 10 g2config_10x.json
+ *
+ * Reports mean wall time per call and the process peak RSS.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "../../include/libSzConfigTool.h"
+
+#define CHECK(condition, message) \
+    if (!(condition)) { \
+        fprintf(stderr, "FAIL: %s: %s\n", message, SzConfigTool_getLastError()); \
+        exit(1); \
+    }
+
+static const char *DEFAULT_CONFIG =
+    "{\"G2_CONFIG\":{\"CFG_DSRC\":[],\"CFG_FCLASS\":[{\"FCLASS_ID\":1,\"FCLASS_CODE\":\"OTHER\"}],"
+    "\"CFG_FTYPE\":[{\"FTYPE_ID\":1,\"FTYPE_CODE\":\"NAME\",\"FCLASS_ID\":1}],"
+    "\"CFG_FELEM\":[{\"FELEM_ID\":1,\"FELEM_CODE\":\"FULL_NAME\"}],"
+    "\"CFG_FBOM\":[{\"FTYPE_ID\":1,\"FELEM_ID\":1,\"EXEC_ORDER\":1}],"
+    "\"CFG_GENERIC_THRESHOLD\":[],\"CFG_GPLAN\":[]}}";
+
+static const char *SCRIPT =
+    "addConfigSection {\"section\": \"CFG_BENCH\"}\n"
+    "addConfigSection {\"section\": \"CFG_BENCH_2\"}\n";
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void report(const char *name, double elapsed, int iterations) {
+    printf("%-34s %8d iters   mean %12.3f us\n", name, iterations, elapsed * 1e6 / iterations);
+}
+
+static char *read_file(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        exit(1);
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *data = malloc((size_t)size + 1);
+    if (data == NULL || fread(data, 1, (size_t)size, f) != (size_t)size) {
+        fprintf(stderr, "FAIL: could not read %s\n", path);
+        exit(1);
+    }
+    data[size] = '\0';
+    fclose(f);
+    return data;
+}
+
+int main(int argc, char **argv) {
+    char *config = argc > 1 ? read_file(argv[1]) : strdup(DEFAULT_CONFIG);
+    int iterations = argc > 2 ? atoi(argv[2]) : 100;
+    if (iterations <= 0) {
+        iterations = 100;
+    }
+
+    printf("=== libSzConfigTool FFI benchmark (%zu byte config) ===\n", strlen(config));
+
+    // 1. String API round-trips
+    double start = now_seconds();
+    for (int i = 0; i < iterations; i++) {
+        struct SzConfigTool_result r = SzConfigTool_addDataSource(config, "BENCH_DS");
+        CHECK(r.returnCode == 0, "addDataSource");
+        SzConfigTool_free(r.response);
+    }
+    report("addDataSource (string API)", now_seconds() - start, iterations);
+
+    start = now_seconds();
+    for (int i = 0; i < iterations; i++) {
+        struct SzConfigTool_result r = SzConfigTool_listFeatures(config);
+        CHECK(r.returnCode == 0, "listFeatures");
+        SzConfigTool_free(r.response);
+    }
+    report("listFeatures (string API)", now_seconds() - start, iterations);
+
+    // 2. Caller-supplied buffer
+    size_t needed = 0;
+    CHECK(SzConfigTool_listFeaturesToBuffer(config, NULL, 0, &needed) == SZ_CONFIGTOOL_BUFFER_TOO_SMALL,
+          "listFeaturesToBuffer size query");
+    size_t buf_size = needed + 1;
+    char *buf = malloc(buf_size);
+    start = now_seconds();
+    for (int i = 0; i < iterations; i++) {
+        CHECK(SzConfigTool_listFeaturesToBuffer(config, buf, buf_size, &needed) == 0, "listFeaturesToBuffer");
+    }
+    report("listFeaturesToBuffer", now_seconds() - start, iterations);
+    free(buf);
+
+    // 3. Handle lifecycle
+    start = now_seconds();
+    for (int i = 0; i < iterations; i++) {
+        SzConfigTool_handle *handle = SzConfigTool_open(config);
+        CHECK(handle != NULL, "open");
+        struct SzConfigTool_result r = SzConfigTool_serialize(handle);
+        CHECK(r.returnCode == 0, "serialize");
+        SzConfigTool_free(r.response);
+        SzConfigTool_close(handle);
+    }
+    report("open + serialize + close", now_seconds() - start, iterations);
+
+    // 4. Handle edits and borrowed views
+    SzConfigTool_handle *handle = SzConfigTool_open(config);
+    CHECK(handle != NULL, "open");
+
+    char code[32];
+    start = now_seconds();
+    for (int i = 0; i < iterations; i++) {
+        snprintf(code, sizeof(code), "BENCH_DS_%d", i);
+        CHECK(SzConfigTool_handleAddDataSource(handle, code) == 0, "handleAddDataSource");
+    }
+    report("handleAddDataSource", now_seconds() - start, iterations);
+
+    const char *view = NULL;
+    size_t view_len = 0;
+    start = now_seconds();
+    for (int i = 0; i < iterations; i++) {
+        CHECK(SzConfigTool_handleListFeatures(handle, &view, &view_len) == 0, "handleListFeatures");
+    }
+    report("handleListFeatures (view)", now_seconds() - start, iterations);
+    SzConfigTool_close(handle);
+
+    // 5. Batch command script
+    start = now_seconds();
+    for (int i = 0; i < iterations; i++) {
+        struct SzConfigTool_result r = SzConfigTool_applyCommands(config, SCRIPT, strlen(SCRIPT));
+        CHECK(r.returnCode == 0, "applyCommands");
+        SzConfigTool_free(r.response);
+    }
+    report("applyCommands (2 lines)", now_seconds() - start, iterations);
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    long peak_kib = usage.ru_maxrss / 1024; /* bytes on macOS */
+#else
+    long peak_kib = usage.ru_maxrss; /* KiB on Linux */
+#endif
+    printf("peak RSS: %ld KiB\n", peak_kib);
+
+    free(config);
+    return 0;
+}
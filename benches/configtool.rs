@@ -0,0 +1,579 @@
+//! Benchmarks over generated configurations of increasing size
+//!
+//! Each benchmark runs against synthetic g2config documents at 1×, 10× and
+//! 100× the stock feature/attribute counts and reports wall time and peak
+//! heap allocation per iteration (tracked by a counting global allocator).
+//!
+//! ```text
+//! cargo bench --bench configtool                      # everything
+//! cargo bench --bench configtool -- list_features     # name filter
+//! cargo bench --bench configtool -- --scales 1,10     # subset of sizes
+//! cargo bench --bench configtool -- --emit-config 10 g2config_10x.json
+//! ```
+//!
+//! `--emit-config` writes a generated configuration for the C/C++ harness in
+//! `benches/c`.
+
+use serde_json::{Value, json};
+use std::alloc::{GlobalAlloc, Layout, System};
+use std::ffi::{CStr, CString};
+use std::hint::black_box;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::time::{Duration, Instant};
+use sz_configtool_lib::command_processor::CommandProcessor;
+use sz_configtool_lib::datasources::{self, AddDataSourceParams, SetDataSourceParams};
+use sz_configtool_lib::features::{self, AddFeatureParams};
+use sz_configtool_lib::shared::SharedConfig;
+use sz_configtool_lib::{ConfigHandle, ffi, versioning};
+
+// ============================================================================
+// Allocation Tracking
+// ============================================================================
+
+struct CountingAlloc;
+
+static CURRENT: AtomicUsize = AtomicUsize::new(0);
+static PEAK: AtomicUsize = AtomicUsize::new(0);
+
+unsafe impl GlobalAlloc for CountingAlloc {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        let ptr = unsafe { System.alloc(layout) };
+        if !ptr.is_null() {
+            let now = CURRENT.fetch_add(layout.size(), Ordering::Relaxed) + layout.size();
+            PEAK.fetch_max(now, Ordering::Relaxed);
+        }
+        ptr
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        unsafe { System.dealloc(ptr, layout) };
+        CURRENT.fetch_sub(layout.size(), Ordering::Relaxed);
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        let new_ptr = unsafe { System.realloc(ptr, layout, new_size) };
+        if !new_ptr.is_null() {
+            if new_size > layout.size() {
+                let grow = new_size - layout.size();
+                let now = CURRENT.fetch_add(grow, Ordering::Relaxed) + grow;
+                PEAK.fetch_max(now, Ordering::Relaxed);
+            } else {
+                CURRENT.fetch_sub(layout.size() - new_size, Ordering::Relaxed);
+            }
+        }
+        new_ptr
+    }
+}
+
+#[global_allocator]
+static GLOBAL: CountingAlloc = CountingAlloc;
+
+// ============================================================================
+// Config Generator
+// ============================================================================
+
+/// Approximate entity counts of a stock g2config
+const STOCK_FEATURES: usize = 60;
+const STOCK_ATTRS_PER_FEATURE: usize = 2;
+const STOCK_ELEMENTS_PER_FEATURE: usize = 3;
+const STOCK_DATA_SOURCES: usize = 2;
+
+/// Generate a configuration with `scale` × the stock feature/attribute counts
+fn generate_config(scale: usize) -> Value {
+    let features = STOCK_FEATURES * scale;
+
+    let mut felem = Vec::new();
+    let mut ftype = Vec::new();
+    let mut fbom = Vec::new();
+    let mut attr = Vec::new();
+    let mut sfcall = Vec::new();
+    let mut efcall = Vec::new();
+    let mut efbom = Vec::new();
+    let mut cfcall = Vec::new();
+    let mut cfbom = Vec::new();
+    let mut dfcall = Vec::new();
+    let mut dfbom = Vec::new();
+
+    for f in 1..=features {
+        let code = format!("FEATURE_{f}");
+        ftype.push(json!({
+            "FTYPE_ID": f, "FTYPE_CODE": code, "FTYPE_DESC": code, "FCLASS_ID": 1,
+            "FTYPE_FREQ": "FM", "FTYPE_EXCL": "No", "FTYPE_STAB": "No",
+            "ANONYMIZE": "No", "DERIVED": "No", "DERIVATION": null,
+            "USED_FOR_CAND": "No", "PERSIST_HISTORY": "Yes", "SHOW_IN_MATCH_KEY": "Yes",
+            "VERSION": 1, "RTYPE_ID": 0
+        }));
+        sfcall.push(
+            json!({"SFCALL_ID": f, "FTYPE_ID": f, "FELEM_ID": -1, "SFUNC_ID": 1, "EXEC_ORDER": 1}),
+        );
+        efcall.push(json!({
+            "EFCALL_ID": f, "FTYPE_ID": f, "FELEM_ID": -1, "EFUNC_ID": 1, "EXEC_ORDER": 1,
+            "EFEAT_FTYPE_ID": -1, "IS_VIRTUAL": "No"
+        }));
+        cfcall.push(json!({"CFCALL_ID": f, "FTYPE_ID": f, "CFUNC_ID": 1}));
+        dfcall.push(json!({"DFCALL_ID": f, "FTYPE_ID": f, "DFUNC_ID": 1, "EXEC_ORDER": 1}));
+
+        for e in 1..=STOCK_ELEMENTS_PER_FEATURE {
+            let felem_id = (f - 1) * STOCK_ELEMENTS_PER_FEATURE + e;
+            felem.push(json!({
+                "FELEM_ID": felem_id, "FELEM_CODE": format!("ELEMENT_{felem_id}"),
+                "FELEM_DESC": format!("ELEMENT_{felem_id}"), "TOKENIZE": "No", "DATA_TYPE": "string"
+            }));
+            fbom.push(json!({
+                "FTYPE_ID": f, "FELEM_ID": felem_id, "EXEC_ORDER": e,
+                "DISPLAY_LEVEL": 1, "DISPLAY_DELIM": null, "DERIVED": "No"
+            }));
+            efbom.push(json!({"EFCALL_ID": f, "FTYPE_ID": f, "FELEM_ID": felem_id, "EXEC_ORDER": e, "FELEM_REQ": "Yes"}));
+            cfbom.push(
+                json!({"CFCALL_ID": f, "FTYPE_ID": f, "FELEM_ID": felem_id, "EXEC_ORDER": e}),
+            );
+            dfbom.push(
+                json!({"DFCALL_ID": f, "FTYPE_ID": f, "FELEM_ID": felem_id, "EXEC_ORDER": e}),
+            );
+        }
+
+        for a in 1..=STOCK_ATTRS_PER_FEATURE {
+            let attr_id = (f - 1) * STOCK_ATTRS_PER_FEATURE + a;
+            let felem_id = (f - 1) * STOCK_ELEMENTS_PER_FEATURE + a;
+            attr.push(json!({
+                "ATTR_ID": attr_id, "ATTR_CODE": format!("ATTR_{attr_id}"), "ATTR_CLASS": "OTHER",
+                "FTYPE_CODE": code, "FELEM_CODE": format!("ELEMENT_{felem_id}"),
+                "FELEM_REQ": "Yes", "DEFAULT_VALUE": null, "INTERNAL": "No"
+            }));
+        }
+    }
+
+    let dsrc: Vec<Value> = (1..=STOCK_DATA_SOURCES)
+        .map(|d| json!({"DSRC_ID": d, "DSRC_CODE": format!("DS_{d}"), "DSRC_DESC": format!("DS_{d}"), "RETENTION_LEVEL": "Remember"}))
+        .collect();
+
+    json!({"G2_CONFIG": {
+        "CFG_ATTR": attr,
+        "CFG_CFBOM": cfbom,
+        "CFG_CFCALL": cfcall,
+        "CFG_CFRTN": [],
+        "CFG_CFUNC": [{"CFUNC_ID": 1, "CFUNC_CODE": "GENERIC_COMP", "CONNECT_STR": "g2GenericComp", "ANON_SUPPORT": "Yes", "LANGUAGE": null}],
+        "CFG_DFBOM": dfbom,
+        "CFG_DFCALL": dfcall,
+        "CFG_DFUNC": [{"DFUNC_ID": 1, "DFUNC_CODE": "GENERIC_DIST", "CONNECT_STR": "g2GenericDist", "ANON_SUPPORT": "Yes", "LANGUAGE": null}],
+        "CFG_DSRC": dsrc,
+        "CFG_EFBOM": efbom,
+        "CFG_EFCALL": efcall,
+        "CFG_EFUNC": [{"EFUNC_ID": 1, "EFUNC_CODE": "EXPRESS_ID", "CONNECT_STR": "g2ExpressId", "LANGUAGE": null}],
+        "CFG_ERFRAG": [],
+        "CFG_ERRULE": [],
+        "CFG_FBOM": fbom,
+        "CFG_FBOVR": [],
+        "CFG_FCLASS": [{"FCLASS_ID": 1, "FCLASS_CODE": "OTHER", "FCLASS_DESC": "Other"}],
+        "CFG_FELEM": felem,
+        "CFG_FTYPE": ftype,
+        "CFG_GENERIC_THRESHOLD": [],
+        "CFG_GPLAN": [{"GPLAN_ID": 1, "GPLAN_CODE": "INGEST", "GPLAN_DESC": "Ingestion"}],
+        "CFG_RTYPE": [],
+        "CFG_SFCALL": sfcall,
+        "CFG_SFUNC": [{"SFUNC_ID": 1, "SFUNC_CODE": "PARSE_ID", "CONNECT_STR": "g2ParseId", "LANGUAGE": null}],
+        "SYS_OOM": {"NAME_HASH": [], "SSN_LAST4_HASH": []},
+        "CONFIG_BASE_VERSION": {
+            "VERSION": "4.0.0",
+            "BUILD_VERSION": "4.0.0.00000",
+            "BUILD_DATE": "2025-01-01",
+            "BUILD_NUMBER": "00000",
+            "COMPATIBILITY_VERSION": {"CONFIG_VERSION": "10"}
+        }
+    }})
+}
+
+/// Upgrade-style script touching features, attributes, calls and sections
+fn upgrade_script(scale: usize) -> String {
+    let mut script = String::from(
+        "verifyCompatibilityVersion {\"expectedVersion\": \"10\"}\n\
+         updateCompatibilityVersion {\"fromVersion\": \"10\", \"toVersion\": \"11\"}\n\
+         addConfigSection {\"section\": \"CFG_BENCH\"}\n",
+    );
+    for i in 0..10 {
+        script.push_str(&format!(
+            "addFeature {{\"feature\": \"NEW_FEATURE_{i}\", \"class\": \"OTHER\", \"behavior\": \"FM\", \
+             \"elementList\": [{{\"element\": \"ELEMENT_1\"}}]}}\n\
+             addAttribute {{\"attribute\": \"NEW_ATTR_{i}\", \"class\": \"OTHER\", \
+             \"feature\": \"NEW_FEATURE_{i}\", \"element\": \"ELEMENT_1\"}}\n"
+        ));
+    }
+    for f in (1..=STOCK_FEATURES * scale).step_by(STOCK_FEATURES / 6) {
+        script.push_str(&format!(
+            "setFeature {{\"feature\": \"FEATURE_{f}\", \"candidates\": \"Yes\"}}\n\
+             deleteComparisonCallElement {{\"feature\": \"FEATURE_{f}\", \"element\": \"ELEMENT_{}\"}}\n",
+            (f - 1) * STOCK_ELEMENTS_PER_FEATURE + 1
+        ));
+    }
+    script.push_str("save\n");
+    script
+}
+
+// ============================================================================
+// Harness
+// ============================================================================
+
+/// Minimum measuring time and iteration bounds per benchmark
+const TARGET: Duration = Duration::from_millis(500);
+const MIN_ITERS: u32 = 3;
+const MAX_ITERS: u32 = 10_000;
+
+/// Reads per thread in the shared-config benchmarks
+const SHARED_READS: usize = 100;
+
+struct Bench {
+    filter: Option<String>,
+}
+
+impl Bench {
+    /// Time `op` on fresh input from `setup`; setup is excluded from time and peak
+    fn run<I, O>(
+        &self,
+        name: &str,
+        scale: usize,
+        mut setup: impl FnMut() -> I,
+        mut op: impl FnMut(I) -> O,
+    ) {
+        if self.filter.as_deref().is_some_and(|f| !name.contains(f)) {
+            return;
+        }
+
+        let mut total = Duration::ZERO;
+        let mut min = Duration::MAX;
+        let mut peak = 0;
+        let mut iters = 0;
+
+        while iters < MIN_ITERS || (total < TARGET && iters < MAX_ITERS) {
+            let input = setup();
+            let baseline = CURRENT.load(Ordering::Relaxed);
+            PEAK.store(baseline, Ordering::Relaxed);
+
+            let start = Instant::now();
+            let output = op(input);
+            let elapsed = start.elapsed();
+
+            peak = peak.max(PEAK.load(Ordering::Relaxed) - baseline);
+            drop(black_box(output));
+
+            total += elapsed;
+            min = min.min(elapsed);
+            iters += 1;
+        }
+
+        println!(
+            "{:<34} {:>4}x {:>6} iters   mean {:>12.3?}   min {:>12.3?}   peak {:>10} KiB",
+            name,
+            scale,
+            iters,
+            total / iters,
+            min,
+            peak / 1024
+        );
+    }
+}
+
+fn main() {
+    let mut filter = None;
+    let mut scales = vec![1, 10, 100];
+    let mut args = std::env::args().skip(1);
+
+    while let Some(arg) = args.next() {
+        match arg.as_str() {
+            "--bench" => {}
+            "--scales" => {
+                scales = args
+                    .next()
+                    .expect("--scales needs a list, e.g. 1,10")
+                    .split(',')
+                    .map(|s| s.trim().parse().expect("scale must be a number"))
+                    .collect();
+            }
+            "--emit-config" => {
+                let scale: usize = args
+                    .next()
+                    .and_then(|s| s.parse().ok())
+                    .expect("--emit-config SCALE PATH");
+                let path = args.next().expect("--emit-config SCALE PATH");
+                std::fs::write(&path, generate_config(scale).to_string())
+                    .expect("failed to write config");
+                println!("Wrote {scale}x config to {path}");
+                return;
+            }
+            _ => filter = Some(arg),
+        }
+    }
+
+    let bench = Bench { filter };
+
+    for scale in scales {
+        let config = generate_config(scale);
+        let config_json = config.to_string();
+        let handle = ConfigHandle::from_value(config);
+        let script = upgrade_script(scale);
+        let element_list = json!([{"element": "ELEMENT_1"}, {"element": "ELEMENT_2"}]);
+        let victim = format!("FEATURE_{}", STOCK_FEATURES * scale / 2);
+
+        println!(
+            "--- {scale}x: {} features, {} KiB JSON ---",
+            STOCK_FEATURES * scale,
+            config_json.len() / 1024
+        );
+
+        bench.run(
+            "parse_serialize",
+            scale,
+            || (),
+            |_| {
+                ConfigHandle::from_json(&config_json)
+                    .unwrap()
+                    .to_json()
+                    .unwrap()
+            },
+        );
+
+        // Peak includes the returned value, so these compare resident sizes
+        bench.run(
+            "resident_handle",
+            scale,
+            || (),
+            |_| ConfigHandle::from_json(&config_json).unwrap(),
+        );
+
+        bench.run("resident_compact", scale, || (), |_| handle.to_compact());
+
+        let snapshot = handle.to_snapshot_bytes();
+        bench.run(
+            "load_binary_snapshot",
+            scale,
+            || (),
+            |_| ConfigHandle::from_snapshot_bytes(&snapshot).unwrap(),
+        );
+
+        // The handle keeps its parsed text, so only CFG_DSRC is written fresh
+        // (it is returned so dropping it stays outside the timing)
+        let saved = ConfigHandle::from_json_cached(&config_json).unwrap();
+        bench.run(
+            "serialize_after_small_edit",
+            scale,
+            || saved.clone(),
+            |mut config| {
+                config
+                    .set_data_source(SetDataSourceParams {
+                        code: "DS_1",
+                        reliability: Some(2),
+                        ..Default::default()
+                    })
+                    .unwrap();
+                let json = config.to_json().unwrap();
+                (config, json)
+            },
+        );
+
+        bench.run(
+            "config_fingerprint",
+            scale,
+            || (),
+            |_| handle.config_fingerprint(),
+        );
+
+        bench.run(
+            "command_processor_upgrade",
+            scale,
+            || CommandProcessor::new(config_json.clone()),
+            |mut p| p.process_script(&script).unwrap(),
+        );
+
+        bench.run(
+            "list_features",
+            scale,
+            || (),
+            |_| handle.list_features().unwrap(),
+        );
+
+        bench.run(
+            "list_features_json",
+            scale,
+            || (),
+            |_| features::list_features(&config_json).unwrap(),
+        );
+
+        bench.run(
+            "get_version_json",
+            scale,
+            || (),
+            |_| versioning::get_version(&config_json).unwrap(),
+        );
+
+        bench.run(
+            "list_data_sources_json",
+            scale,
+            || (),
+            |_| datasources::list_data_sources(&config_json).unwrap(),
+        );
+
+        bench.run(
+            "validate_config",
+            scale,
+            || (),
+            |_| handle.validate_config().unwrap(),
+        );
+
+        bench.run(
+            "add_feature",
+            scale,
+            || handle.clone(),
+            |mut config| {
+                config
+                    .add_feature(AddFeatureParams {
+                        class: Some("OTHER"),
+                        ..AddFeatureParams::new("BENCH_FEATURE", &element_list)
+                    })
+                    .unwrap();
+                config
+            },
+        );
+
+        bench.run(
+            "delete_feature",
+            scale,
+            || handle.clone(),
+            |mut config| {
+                config.delete_feature(&victim).unwrap();
+                config
+            },
+        );
+
+        bench.run(
+            "add_data_sources_x100",
+            scale,
+            || handle.clone(),
+            |mut config| {
+                for i in 0..100 {
+                    let code = format!("BENCH_DS_{i}");
+                    config
+                        .add_data_source(AddDataSourceParams {
+                            code: &code,
+                            ..Default::default()
+                        })
+                        .unwrap();
+                }
+                config
+            },
+        );
+
+        let codes: Vec<String> = (0..100).map(|i| format!("BENCH_DS_{i}")).collect();
+        let batch: Vec<AddDataSourceParams> = codes
+            .iter()
+            .map(|code| AddDataSourceParams {
+                code,
+                ..Default::default()
+            })
+            .collect();
+        bench.run(
+            "add_data_sources_bulk_x100",
+            scale,
+            || handle.clone(),
+            |mut config| {
+                config.add_data_sources(&batch).unwrap();
+                config
+            },
+        );
+
+        bench.run(
+            "add_data_sources_json_x100",
+            scale,
+            || (),
+            |_| datasources::add_data_sources(&config_json, &batch).unwrap(),
+        );
+
+        let c_config = CString::new(config_json.as_str()).unwrap();
+        let c_code = CString::new("BENCH_DS").unwrap();
+
+        bench.run(
+            "ffi_add_data_source",
+            scale,
+            || (),
+            |_| unsafe {
+                let result = ffi::SzConfigTool_addDataSource(c_config.as_ptr(), c_code.as_ptr());
+                assert_eq!(result.returnCode, 0);
+                let len = CStr::from_ptr(result.response).to_bytes().len();
+                ffi::SzConfigTool_free(result.response);
+                len
+            },
+        );
+
+        bench.run(
+            "ffi_list_features",
+            scale,
+            || (),
+            |_| unsafe {
+                let result = ffi::SzConfigTool_listFeatures(c_config.as_ptr());
+                assert_eq!(result.returnCode, 0);
+                let len = CStr::from_ptr(result.response).to_bytes().len();
+                ffi::SzConfigTool_free(result.response);
+                len
+            },
+        );
+
+        bench.run(
+            "ffi_handle_open_serialize_close",
+            scale,
+            || (),
+            |_| unsafe {
+                let handle = ffi::SzConfigTool_open(c_config.as_ptr());
+                assert!(!handle.is_null());
+                let result = ffi::SzConfigTool_serialize(handle);
+                ffi::SzConfigTool_close(handle);
+                ffi::SzConfigTool_free(result.response);
+            },
+        );
+
+        let ffi_handle = unsafe { ffi::SzConfigTool_open(c_config.as_ptr()) };
+        bench.run(
+            "ffi_handle_list_features_view",
+            scale,
+            || (),
+            |_| unsafe {
+                let mut out = std::ptr::null();
+                let mut len = 0;
+                assert_eq!(
+                    ffi::SzConfigTool_handleListFeatures(ffi_handle, &mut out, &mut len),
+                    0
+                );
+                len
+            },
+        );
+        unsafe { ffi::SzConfigTool_close(ffi_handle) };
+
+        // Each of `threads` threads reads SHARED_READS features through its own
+        // reader, so the same mean at 1 and 4 threads means reads scale
+        bench.run(
+            "get_feature_json",
+            scale,
+            || (),
+            |_| features::get_feature(&config_json, &victim).unwrap(),
+        );
+
+        let shared = SharedConfig::new(handle.clone());
+        for threads in [1, 4] {
+            bench.run(
+                &format!("shared_get_feature_{SHARED_READS}x{threads}"),
+                scale,
+                || (),
+                |_| {
+                    std::thread::scope(|s| {
+                        for _ in 0..threads {
+                            let mut reader = shared.reader();
+                            let victim = &victim;
+                            s.spawn(move || {
+                                for _ in 0..SHARED_READS {
+                                    black_box(reader.get().get_feature(victim).unwrap());
+                                }
+                            });
+                        }
+                    })
+                },
+            );
+        }
+    }
+}
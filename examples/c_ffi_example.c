@@ -23,7 +23,7 @@
 
 /* Helper function to print results */
 void print_result(const char *operation, SzConfigTool_result result) {
-    if (result.return_code == 0) {
+    if (result.returnCode == 0) {
         printf("✓ %s succeeded\n", operation);
         if (result.response) {
             printf("  Response: %s\n", result.response);
@@ -60,7 +60,7 @@ int main() {
         NULL   /* retention_level - use default */
     );
 
-    if (result.return_code == 0) {
+    if (result.returnCode == 0) {
         printf("  ✓ Data source added\n");
         free(config);
         config = result.response;  /* Take ownership of modified config */
@@ -81,7 +81,7 @@ int main() {
         NULL
     );
 
-    if (result.return_code == 0) {
+    if (result.returnCode == 0) {
         printf("  ✓ Data source added\n");
         free(config);
         config = result.response;
@@ -96,7 +96,7 @@ int main() {
     printf("\n3. Listing all data sources...\n");
     result = SzConfigTool_listDataSources(config, "JSON");
 
-    if (result.return_code == 0) {
+    if (result.returnCode == 0) {
         printf("  Data sources:\n%s\n", result.response);
         SzConfigTool_free(result.response);  /* Free response, keep config */
     } else {
@@ -108,7 +108,7 @@ int main() {
     printf("\n4. Getting details for 'CUSTOMERS'...\n");
     result = SzConfigTool_getDataSource(config, "CUSTOMERS", "JSON");
 
-    if (result.return_code == 0) {
+    if (result.returnCode == 0) {
         printf("  Customer data source:\n%s\n", result.response);
         SzConfigTool_free(result.response);
     } else {
@@ -125,7 +125,7 @@ int main() {
         NULL  /* Keep retention level */
     );
 
-    if (result.return_code == 0) {
+    if (result.returnCode == 0) {
         printf("  ✓ Data source updated\n");
         free(config);
         config = result.response;
@@ -138,7 +138,7 @@ int main() {
     printf("\n6. Deleting 'VENDORS' data source...\n");
     result = SzConfigTool_deleteDataSource(config, "VENDORS");
 
-    if (result.return_code == 0) {
+    if (result.returnCode == 0) {
         printf("  ✓ Data source deleted\n");
         free(config);
         config = result.response;
@@ -151,7 +151,7 @@ int main() {
     printf("\n7. Final data source list:\n");
     result = SzConfigTool_listDataSources(config, "JSON");
 
-    if (result.return_code == 0) {
+    if (result.returnCode == 0) {
         printf("  Remaining data sources:\n%s\n", result.response);
         SzConfigTool_free(result.response);
     } else {
@@ -163,7 +163,7 @@ int main() {
     printf("\n8. Attempting to get deleted 'VENDORS' (should fail)...\n");
     result = SzConfigTool_getDataSource(config, "VENDORS", "JSON");
 
-    if (result.return_code == 0) {
+    if (result.returnCode == 0) {
         printf("  ✗ Unexpected success!\n");
         SzConfigTool_free(result.response);
     } else {
@@ -1,10 +1,12 @@
 //! Config validation example
 //!
 //! Demonstrates validating Senzing configuration JSON structure.
-//! Checks for required sections and basic structural integrity.
+//! Checks for required sections and basic structural integrity, then runs the
+//! library's referential integrity check (`validate::validate_config`).
 
 use serde_json::Value;
 use std::env;
+use sz_configtool_lib::ConfigHandle;
 
 fn main() -> Result<(), Box<dyn std::error::Error>> {
     println!("=== Senzing Config Validator ===\n");
@@ -107,6 +109,14 @@ fn main() -> Result<(), Box<dyn std::error::Error>> {
         println!("  Elements: {}", count_array(g2_config, "CFG_FELEM"));
         println!("  Fragments: {}", count_array(g2_config, "CFG_ERFRAG"));
         println!("  Rules: {}", count_array(g2_config, "CFG_ERRULE"));
+
+        // Referential integrity and duplicate keys
+        println!("\nChecking references...");
+        let report = ConfigHandle::from_value(config.clone()).validate_config()?;
+        println!("  Rows checked: {}", report.rows_checked);
+        for finding in &report.findings {
+            errors.push(finding.message());
+        }
     }
 
     println!();
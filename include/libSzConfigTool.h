@@ -36,23 +36,24 @@ typedef struct SzConfigTool_result {
 void SzConfigTool_free(char *ptr);
 
 /**
- * Get the last error message
+ * Get the last error message of the calling thread
  *
  * # Returns
- * Pointer to error string (do not free), or null if no error
+ * Pointer to error string (do not free), or null if no error. The pointer is
+ * valid until the next library call on the same thread.
  */
 const char *SzConfigTool_getLastError(void);
 
 /**
- * Get the last error code
+ * Get the last error code of the calling thread
  *
  * # Returns
- * Error code (0 = no error, negative = error
+ * Error code (0 = no error, negative = error)
  */
 int64_t SzConfigTool_getLastErrorCode(void);
 
 /**
- * Clear the last error
+ * Clear the last error of the calling thread
  */
 void SzConfigTool_clearLastError(void);
 
@@ -366,6 +367,21 @@ struct SzConfigTool_result SzConfigTool_setScoringFunctionWithJson(const char *c
 
 struct SzConfigTool_result SzConfigTool_setFragmentWithJson(const char *config_json, const char *fragment_code, const char *updates_json);
 struct SzConfigTool_result SzConfigTool_cloneGenericPlan(const char *config_json, const char *source_code, const char *new_code, const char *new_desc);
+
+/**
+ * Clone a generic plan and apply threshold overrides to the copy in one call
+ *
+ * thresholds_json is a JSON array of objects with "behavior" and the optional
+ * "feature" (default "ALL"), "candidateCap", "scoringCap" and "sendToRedo".
+ * Each override updates the cloned row with the same behavior and feature,
+ * or adds a row (all three values required) if there is none. Every override
+ * is checked first, so on error nothing changes. new_desc may be null.
+ */
+struct SzConfigTool_result SzConfigTool_buildGenericPlan(const char *config_json,
+                                                         const char *source_code,
+                                                         const char *new_code,
+                                                         const char *new_desc,
+                                                         const char *thresholds_json);
 struct SzConfigTool_result SzConfigTool_setGenericPlan(const char *config_json, const char *gplan_code, const char *gplan_desc, const char *updates_json);
 struct SzConfigTool_result SzConfigTool_listGenericPlans(const char *config_json, const char *filter_code);
 struct SzConfigTool_result SzConfigTool_addToSsnLast4Hash(const char *config_json, const char *name);
@@ -579,6 +595,662 @@ struct SzConfigTool_result SzConfigTool_setScoringFunction(const char *config_js
                                                            const char *rtype_code,
                                                            const char *scoring_func);
 
+/* ============================================================================
+ * Handle Functions
+ * ============================================================================
+ * A handle owns a parsed configuration. Mutators edit it in place and return
+ * 0 on success or a negative error code (see SzConfigTool_getLastError), so a
+ * batch of edits costs one parse and one serialization.
+ */
+
+/**
+ * Opaque parsed configuration
+ */
+typedef struct SzConfigTool_handle SzConfigTool_handle;
+
+/**
+ * Parse a configuration into a new handle
+ *
+ * # Returns
+ * Handle to release with SzConfigTool_close, or null on error
+ *
+ * # Safety
+ * configJson must be a valid null-terminated C string
+ */
+SzConfigTool_handle *SzConfigTool_open(const char *config_json);
+
+/**
+ * Parse a configuration into a new handle that keeps its text
+ *
+ * Like SzConfigTool_open, but SzConfigTool_serialize and SzConfigTool_saveFile
+ * then copy the sections not edited since instead of serializing them again.
+ * The handle holds a copy of config_json until every section has been edited.
+ *
+ * # Returns
+ * Handle to release with SzConfigTool_close, or null on error
+ */
+SzConfigTool_handle *SzConfigTool_openCached(const char *config_json);
+
+/**
+ * Open a configuration file as a new handle
+ *
+ * Parses through a buffered reader without reading the file into a string.
+ *
+ * # Returns
+ * Handle to release with SzConfigTool_close, or null on error
+ */
+SzConfigTool_handle *SzConfigTool_openFile(const char *path);
+
+/**
+ * Save the configuration held by a handle to a file as compact JSON (0 = success)
+ *
+ * Streams to a buffered writer without serializing to a string first.
+ */
+int64_t SzConfigTool_saveFile(SzConfigTool_handle *handle, const char *path);
+
+/**
+ * Open a binary snapshot file (from SzConfigTool_saveSnapshot) as a new handle
+ *
+ * Loads without parsing JSON. When expected_compatibility is not null or
+ * empty, a snapshot with another compatibility version is rejected.
+ *
+ * # Returns
+ * Handle to release with SzConfigTool_close, or null on error
+ */
+SzConfigTool_handle *SzConfigTool_openSnapshot(const char *path,
+                                               const char *expected_compatibility);
+
+/**
+ * Save the configuration held by a handle to a binary snapshot file (0 = success)
+ */
+int64_t SzConfigTool_saveSnapshot(SzConfigTool_handle *handle, const char *path);
+
+/**
+ * Release a handle (null is ignored)
+ */
+void SzConfigTool_close(SzConfigTool_handle *handle);
+
+/**
+ * Serialize the configuration held by a handle
+ * (caller must free response with SzConfigTool_free)
+ */
+struct SzConfigTool_result SzConfigTool_serialize(const SzConfigTool_handle *handle);
+
+// Data Source Operations
+int64_t SzConfigTool_handleAddDataSource(SzConfigTool_handle *handle, const char *data_source_code);
+int64_t SzConfigTool_handleDeleteDataSource(SzConfigTool_handle *handle, const char *data_source_code);
+int64_t SzConfigTool_handleSetDataSource(SzConfigTool_handle *handle, const char *code, const char *updates_json);
+
+// Attribute Operations (default_value, internal and required may be null)
+int64_t SzConfigTool_handleAddAttribute(SzConfigTool_handle *handle,
+                                        const char *attribute_code,
+                                        const char *feature_code,
+                                        const char *element_code,
+                                        const char *attr_class,
+                                        const char *default_value,
+                                        const char *internal,
+                                        const char *required);
+int64_t SzConfigTool_handleDeleteAttribute(SzConfigTool_handle *handle, const char *attribute_code);
+int64_t SzConfigTool_handleSetAttribute(SzConfigTool_handle *handle,
+                                        const char *attribute_code,
+                                        const char *updates_json);
+
+// Feature and Element Operations
+int64_t SzConfigTool_handleAddFeature(SzConfigTool_handle *handle, const char *feature_code, const char *feature_json);
+int64_t SzConfigTool_handleDeleteFeature(SzConfigTool_handle *handle, const char *feature_code_or_id);
+int64_t SzConfigTool_handleSetFeature(SzConfigTool_handle *handle,
+                                      const char *feature_code_or_id,
+                                      const char *updates_json);
+int64_t SzConfigTool_handleAddElement(SzConfigTool_handle *handle, const char *element_code, const char *element_json);
+int64_t SzConfigTool_handleDeleteElement(SzConfigTool_handle *handle, const char *element_code);
+int64_t SzConfigTool_handleSetElement(SzConfigTool_handle *handle, const char *element_code, const char *updates_json);
+int64_t SzConfigTool_handleAddBehaviorOverride(SzConfigTool_handle *handle,
+                                               const char *feature_code,
+                                               const char *usage_type,
+                                               const char *behavior);
+int64_t SzConfigTool_handleDeleteBehaviorOverride(SzConfigTool_handle *handle,
+                                                  const char *feature_code,
+                                                  const char *usage_type);
+
+// Fragment, Rule and Generic Plan Operations (new_gplan_desc may be null)
+int64_t SzConfigTool_handleAddFragment(SzConfigTool_handle *handle, const char *fragment_json);
+int64_t SzConfigTool_handleDeleteFragment(SzConfigTool_handle *handle, const char *fragment_code);
+int64_t SzConfigTool_handleSetFragmentWithJson(SzConfigTool_handle *handle,
+                                               const char *fragment_code,
+                                               const char *updates_json);
+int64_t SzConfigTool_handleAddRule(SzConfigTool_handle *handle, const char *rule_json);
+int64_t SzConfigTool_handleDeleteRule(SzConfigTool_handle *handle, const char *rule_code);
+int64_t SzConfigTool_handleSetRule(SzConfigTool_handle *handle, const char *rule_code, const char *rule_json);
+int64_t SzConfigTool_handleCloneGenericPlan(SzConfigTool_handle *handle,
+                                            const char *source_gplan_code,
+                                            const char *new_gplan_code,
+                                            const char *new_gplan_desc);
+int64_t SzConfigTool_handleBuildGenericPlan(SzConfigTool_handle *handle,
+                                            const char *source_gplan_code,
+                                            const char *new_gplan_code,
+                                            const char *new_gplan_desc,
+                                            const char *thresholds_json);
+int64_t SzConfigTool_handleSetGenericPlan(SzConfigTool_handle *handle,
+                                          const char *gplan_code,
+                                          const char *gplan_desc);
+
+// Hash, System Parameter and Version Operations
+int64_t SzConfigTool_handleAddToSsnLast4Hash(SzConfigTool_handle *handle, const char *name);
+int64_t SzConfigTool_handleDeleteFromSsnLast4Hash(SzConfigTool_handle *handle, const char *name);
+int64_t SzConfigTool_handleSetSystemParameterWithJson(SzConfigTool_handle *handle,
+                                                      const char *parameter_name,
+                                                      const char *parameter_value_json);
+int64_t SzConfigTool_handleUpdateCompatibilityVersion(SzConfigTool_handle *handle, const char *new_version);
+int64_t SzConfigTool_handleUpdateFeatureVersion(SzConfigTool_handle *handle, const char *version);
+
+// Config Section Operations
+int64_t SzConfigTool_handleAddConfigSection(SzConfigTool_handle *handle, const char *section_name);
+int64_t SzConfigTool_handleRemoveConfigSection(SzConfigTool_handle *handle, const char *section_name);
+int64_t SzConfigTool_handleAddConfigSectionField(SzConfigTool_handle *handle,
+                                                 const char *section_name,
+                                                 const char *field_name,
+                                                 const char *field_value_json);
+int64_t SzConfigTool_handleRemoveConfigSectionField(SzConfigTool_handle *handle,
+                                                    const char *section_name,
+                                                    const char *field_name);
+
+// Function Operations (description, language and anon_support may be null;
+// for set*, null or empty = leave unchanged)
+int64_t SzConfigTool_handleAddStandardizeFunction(SzConfigTool_handle *handle,
+                                                  const char *sfunc_code,
+                                                  const char *connect_str,
+                                                  const char *sfunc_desc,
+                                                  const char *language);
+int64_t SzConfigTool_handleDeleteStandardizeFunction(SzConfigTool_handle *handle, const char *sfunc_code);
+int64_t SzConfigTool_handleSetStandardizeFunction(SzConfigTool_handle *handle,
+                                                  const char *sfunc_code,
+                                                  const char *connect_str,
+                                                  const char *sfunc_desc,
+                                                  const char *language);
+int64_t SzConfigTool_handleAddExpressionFunction(SzConfigTool_handle *handle,
+                                                 const char *efunc_code,
+                                                 const char *connect_str,
+                                                 const char *efunc_desc,
+                                                 const char *language);
+int64_t SzConfigTool_handleDeleteExpressionFunction(SzConfigTool_handle *handle, const char *efunc_code);
+int64_t SzConfigTool_handleSetExpressionFunction(SzConfigTool_handle *handle,
+                                                 const char *efunc_code,
+                                                 const char *connect_str,
+                                                 const char *efunc_desc,
+                                                 const char *language);
+int64_t SzConfigTool_handleAddComparisonFunction(SzConfigTool_handle *handle,
+                                                 const char *cfunc_code,
+                                                 const char *connect_str,
+                                                 const char *cfunc_desc,
+                                                 const char *language,
+                                                 const char *anon_support);
+int64_t SzConfigTool_handleDeleteComparisonFunction(SzConfigTool_handle *handle, const char *cfunc_code);
+int64_t SzConfigTool_handleSetComparisonFunction(SzConfigTool_handle *handle,
+                                                 const char *cfunc_code,
+                                                 const char *connect_str,
+                                                 const char *cfunc_desc,
+                                                 const char *language,
+                                                 const char *anon_support);
+int64_t SzConfigTool_handleAddDistinctFunction(SzConfigTool_handle *handle,
+                                               const char *dfunc_code,
+                                               const char *connect_str,
+                                               const char *dfunc_desc,
+                                               const char *language);
+int64_t SzConfigTool_handleDeleteDistinctFunction(SzConfigTool_handle *handle, const char *dfunc_code);
+int64_t SzConfigTool_handleSetDistinctFunction(SzConfigTool_handle *handle,
+                                               const char *dfunc_code,
+                                               const char *connect_str,
+                                               const char *dfunc_desc,
+                                               const char *language);
+
+// Call Operations (element_list_json is a JSON array of element codes;
+// negative exec_order = next available, null ftype/felem = not specified)
+int64_t SzConfigTool_handleAddStandardizeCall(SzConfigTool_handle *handle,
+                                              const char *ftype_code,
+                                              const char *felem_code,
+                                              int64_t exec_order,
+                                              const char *sfunc_code);
+int64_t SzConfigTool_handleDeleteStandardizeCall(SzConfigTool_handle *handle, int64_t sfcall_id);
+// element_list_json items: ["element", "required", "feature"] or {"element", "required", "feature"}
+int64_t SzConfigTool_handleAddExpressionCall(SzConfigTool_handle *handle,
+                                             const char *ftype_code,
+                                             const char *felem_code,
+                                             int64_t exec_order,
+                                             const char *efunc_code,
+                                             const char *element_list_json,
+                                             const char *expression_feature,
+                                             const char *is_virtual);
+int64_t SzConfigTool_handleDeleteExpressionCall(SzConfigTool_handle *handle, int64_t efcall_id);
+int64_t SzConfigTool_handleAddComparisonCall(SzConfigTool_handle *handle,
+                                             const char *ftype_code,
+                                             const char *cfunc_code,
+                                             const char *element_list_json);
+int64_t SzConfigTool_handleDeleteComparisonCall(SzConfigTool_handle *handle, int64_t cfcall_id);
+int64_t SzConfigTool_handleAddDistinctCall(SzConfigTool_handle *handle,
+                                           const char *ftype_code,
+                                           const char *dfunc_code,
+                                           const char *element_list_json);
+int64_t SzConfigTool_handleDeleteDistinctCall(SzConfigTool_handle *handle, int64_t dfcall_id);
+
+// Threshold Operations (negative integers = not specified, null feature = "ALL")
+int64_t SzConfigTool_handleAddComparisonThreshold(SzConfigTool_handle *handle,
+                                                  int64_t cfunc_id,
+                                                  const char *cfunc_rtnval,
+                                                  int64_t ftype_id,
+                                                  int64_t exec_order,
+                                                  int64_t same_score,
+                                                  int64_t close_score,
+                                                  int64_t likely_score,
+                                                  int64_t plausible_score,
+                                                  int64_t un_likely_score);
+int64_t SzConfigTool_handleDeleteComparisonThreshold(SzConfigTool_handle *handle, int64_t cfrtn_id);
+// updates_json keys: sameScore, closeScore, likelyScore, plausibleScore, unlikelyScore
+int64_t SzConfigTool_handleSetComparisonThreshold(SzConfigTool_handle *handle,
+                                                  int64_t cfrtn_id,
+                                                  const char *updates_json);
+int64_t SzConfigTool_handleAddGenericThreshold(SzConfigTool_handle *handle,
+                                               const char *plan,
+                                               const char *behavior,
+                                               int64_t scoring_cap,
+                                               int64_t candidate_cap,
+                                               const char *send_to_redo,
+                                               const char *feature);
+int64_t SzConfigTool_handleDeleteGenericThreshold(SzConfigTool_handle *handle,
+                                                  const char *plan,
+                                                  const char *behavior,
+                                                  const char *feature);
+// updates_json keys: feature, candidateCap, scoringCap, sendToRedo
+int64_t SzConfigTool_handleSetGenericThreshold(SzConfigTool_handle *handle,
+                                               int64_t gplan_id,
+                                               const char *behavior,
+                                               const char *updates_json);
+
+/* ============================================================================
+ * Batch Command Functions
+ * ============================================================================ */
+
+/**
+ * Apply a buffer of command-script lines (.gtc format) to a configuration
+ *
+ * Parses the configuration once, runs every line and serializes once. On a
+ * failing line returnCode is -2 and SzConfigTool_getLastError() starts with
+ * "Line N:".
+ *
+ * # Safety
+ * configJson must be a valid null-terminated C string; commands must point to
+ * at least len bytes of UTF-8 (need not be null-terminated)
+ */
+struct SzConfigTool_result SzConfigTool_applyCommands(const char *config_json, const char *commands, size_t len);
+
+/**
+ * Apply a buffer of command-script lines to a handle (0 = success)
+ *
+ * Commands before a failing line remain applied.
+ */
+int64_t SzConfigTool_handleApplyCommands(SzConfigTool_handle *handle, const char *commands, size_t len);
+
+/**
+ * Apply a buffer of command-script lines with per-command profiling
+ *
+ * Returns a JSON report {"config", "error", "profile": {"totalMicros",
+ * "compileMicros", "scriptBytes", "finishMicros", "finishBytesSerialized",
+ * "commands": [{"line", "command", "micros", "bytesParsed",
+ * "bytesSerialized", "sections", "error"}]}}. If a line fails "config" is
+ * null and "error" starts with "Line N:"; returnCode is 0 unless an argument
+ * is invalid.
+ *
+ * # Safety
+ * configJson must be a valid null-terminated C string; commands must point to
+ * at least len bytes of UTF-8 (need not be null-terminated)
+ */
+struct SzConfigTool_result SzConfigTool_profileCommands(const char *config_json, const char *commands, size_t len);
+
+/**
+ * Apply one command script to many configuration files in parallel
+ *
+ * jobsJson is a JSON array of {"input": path, "output": path}; threads <= 0
+ * uses all cores. Returns a JSON report {"summary", "succeeded", "failed",
+ * "results": [{"input", "output", "commandsExecuted", "error"}]} in job order.
+ * returnCode is 0 even if individual jobs failed.
+ *
+ * # Safety
+ * script and jobsJson must be valid null-terminated C strings
+ */
+struct SzConfigTool_result SzConfigTool_upgradeFiles(const char *script, const char *jobs_json, int64_t threads);
+
+/* ============================================================================
+ * Bulk Operations
+ * ============================================================================ */
+
+/**
+ * Delete several features and their dependent records in one pass
+ *
+ * featuresJson is a JSON array of feature codes or IDs, e.g. ["LOYALTY_ID", "105"].
+ * The result matches deleting them one at a time. If any feature is missing or
+ * protected, nothing is deleted.
+ *
+ * # Safety
+ * configJson and featuresJson must be valid null-terminated C strings
+ */
+struct SzConfigTool_result SzConfigTool_deleteFeatures(const char *config_json, const char *features_json);
+
+/**
+ * Delete several features from a handle (0 = success; unchanged on error)
+ */
+int64_t SzConfigTool_handleDeleteFeatures(SzConfigTool_handle *handle, const char *features_json);
+
+/**
+ * Add several data sources or attributes in one call
+ *
+ * dataSourcesJson is a JSON array of objects with "code" and the optional
+ * "retentionLevel", "conversational" and "reliability"; attributesJson is a
+ * JSON array of objects with "attribute", "feature", "element", "class" and
+ * the optional "default", "internal" and "required". The result is the same
+ * as adding the entries one at a time. Every entry is checked before
+ * anything changes: an existing or repeated code fails (-2) and an entry
+ * missing a field fails (-3, the message names the entry), leaving the
+ * configuration unchanged.
+ */
+struct SzConfigTool_result SzConfigTool_addDataSources(const char *config_json, const char *data_sources_json);
+struct SzConfigTool_result SzConfigTool_addAttributes(const char *config_json, const char *attributes_json);
+int64_t SzConfigTool_handleAddDataSources(SzConfigTool_handle *handle, const char *data_sources_json);
+int64_t SzConfigTool_handleAddAttributes(SzConfigTool_handle *handle, const char *attributes_json);
+
+/**
+ * Add or delete many NAME_HASH / SSN_LAST4_HASH entries in one call
+ *
+ * The string forms take a JSON array of strings (namesJson / valuesJson); the
+ * handle forms take an array of count C strings. Every entry is checked
+ * before anything changes: adding an existing or repeated entry, or deleting
+ * a missing one, fails and leaves the configuration unchanged.
+ */
+struct SzConfigTool_result SzConfigTool_addToNameHashMany(const char *config_json, const char *names_json);
+struct SzConfigTool_result SzConfigTool_deleteFromNameHashMany(const char *config_json, const char *names_json);
+struct SzConfigTool_result SzConfigTool_addToSsnLast4HashMany(const char *config_json, const char *values_json);
+struct SzConfigTool_result SzConfigTool_deleteFromSsnLast4HashMany(const char *config_json,
+                                                                   const char *values_json);
+int64_t SzConfigTool_handleAddToNameHashMany(SzConfigTool_handle *handle, const char *const *names, size_t count);
+int64_t SzConfigTool_handleDeleteFromNameHashMany(SzConfigTool_handle *handle,
+                                                  const char *const *names,
+                                                  size_t count);
+int64_t SzConfigTool_handleAddToSsnLast4HashMany(SzConfigTool_handle *handle,
+                                                 const char *const *values,
+                                                 size_t count);
+int64_t SzConfigTool_handleDeleteFromSsnLast4HashMany(SzConfigTool_handle *handle,
+                                                      const char *const *values,
+                                                      size_t count);
+
+/* ============================================================================
+ * Borrowed and Caller-Buffer Reads
+ * ============================================================================ */
+
+/**
+ * Returned by the *ToBuffer functions when the buffer is too small
+ */
+#define SZ_CONFIGTOOL_BUFFER_TOO_SMALL (-6)
+
+/**
+ * Read from a handle without allocating (0 = success)
+ *
+ * On success *out points to null-terminated JSON of *outLen bytes (excluding
+ * the terminator). The memory belongs to the handle: do not free it. It stays
+ * valid until the next call that reads or modifies this handle, or
+ * SzConfigTool_close. filter may be null.
+ */
+int64_t SzConfigTool_handleListFeatures(SzConfigTool_handle *handle, const char **out, size_t *out_len);
+int64_t SzConfigTool_handleGetConfigSection(SzConfigTool_handle *handle,
+                                            const char *section_name,
+                                            const char *filter,
+                                            const char **out,
+                                            size_t *out_len);
+int64_t SzConfigTool_handleListGenericThresholds(SzConfigTool_handle *handle, const char **out, size_t *out_len);
+
+/**
+ * Index a field of a handle's section for filtered reads (0 = success)
+ *
+ * Config-section filters are "FIELD=value", "FIELD^=prefix" or "FIELD*=text"
+ * conditions joined by '&', or free text matched against record values.
+ * "FIELD=value" conditions on an indexed field visit only the matching rows.
+ * The index is dropped when the section is modified.
+ */
+int64_t SzConfigTool_handleIndexField(SzConfigTool_handle *handle, const char *section_name, const char *field);
+
+/**
+ * Read into a caller-supplied buffer (0 = success)
+ *
+ * *outLen always receives the JSON length (excluding the terminator). If
+ * bufSize < *outLen + 1 (e.g. buf = NULL, bufSize = 0 as a size query),
+ * nothing is written and SZ_CONFIGTOOL_BUFFER_TOO_SMALL is returned.
+ *
+ *   size_t len = 0;
+ *   SzConfigTool_listFeaturesToBuffer(config, NULL, 0, &len);
+ *   char *buf = malloc(len + 1);
+ *   SzConfigTool_listFeaturesToBuffer(config, buf, len + 1, &len);
+ */
+int64_t SzConfigTool_listFeaturesToBuffer(const char *config_json, char *buf, size_t buf_size, size_t *out_len);
+int64_t SzConfigTool_getConfigSectionToBuffer(const char *config_json,
+                                              const char *section_name,
+                                              const char *filter,
+                                              char *buf,
+                                              size_t buf_size,
+                                              size_t *out_len);
+int64_t SzConfigTool_listGenericThresholdsToBuffer(const char *config_json,
+                                                   char *buf,
+                                                   size_t buf_size,
+                                                   size_t *out_len);
+
+/* ============================================================================
+ * JSON Patch
+ * ============================================================================ */
+
+/**
+ * Apply a JSON Patch (RFC 6902) to a configuration
+ *
+ * Atomic: if any operation fails (returnCode -2) none are applied.
+ *
+ * # Safety
+ * configJson and patchJson must be valid null-terminated C strings
+ */
+struct SzConfigTool_result SzConfigTool_applyPatch(const char *config_json, const char *patch_json);
+
+/**
+ * Compute the JSON Patch (RFC 6902) that turns beforeJson into afterJson
+ *
+ * # Safety
+ * beforeJson and afterJson must be valid null-terminated C strings
+ */
+struct SzConfigTool_result SzConfigTool_diffAsPatch(const char *before_json, const char *after_json);
+
+/**
+ * Apply a JSON Patch to a handle (0 = success, handle unchanged on failure)
+ */
+int64_t SzConfigTool_handleApplyPatch(SzConfigTool_handle *handle, const char *patch_json);
+
+/**
+ * Apply a buffer of command-script lines to a handle and return their JSON Patch
+ *
+ * On a failing line returnCode is -2, SzConfigTool_getLastError() starts with
+ * "Line N:" and the handle is left unchanged.
+ *
+ * # Safety
+ * commands must point to at least len bytes of UTF-8 (need not be null-terminated)
+ */
+struct SzConfigTool_result SzConfigTool_handleApplyCommandsAsPatch(SzConfigTool_handle *handle, const char *commands, size_t len);
+
+/* ============================================================================
+ * Config Diff
+ * ============================================================================ */
+
+/**
+ * Structural diff between two configurations
+ *
+ * Rows of each CFG_* section are joined on the section's primary key
+ * (DSRC_CODE, FTYPE_ID, ATTR_CODE, ...), so reordered rows are not reported.
+ * Returns {"summary": {"sections", "added", "removed", "changed"},
+ * "sections": [{"section", "key", "added", "removed", "changed": [{"key",
+ * "fields", "before", "after"}]}]}; members that are not row arrays are
+ * reported with "status": "added" | "removed" | "replaced".
+ *
+ * # Safety
+ * configA and configB must be valid null-terminated C strings
+ */
+struct SzConfigTool_result SzConfigTool_diffConfigs(const char *config_a, const char *config_b);
+
+/* ============================================================================
+ * Snapshots
+ * ============================================================================ */
+
+/**
+ * Open a snapshot of a handle to roll back to later
+ *
+ * O(1); each config section is copied when it is first changed afterwards.
+ * Returns the snapshot ID (positive) or a negative error code.
+ */
+int64_t SzConfigTool_handleSnapshot(SzConfigTool_handle *handle);
+
+/**
+ * Restore a handle to a snapshot, ending it and any snapshot taken after it
+ * (0 = success, -2 if the snapshot is not open)
+ */
+int64_t SzConfigTool_handleRollback(SzConfigTool_handle *handle, int64_t snapshot);
+
+/**
+ * End a snapshot (and any taken after it), keeping the changes
+ * (0 = success, -2 if the snapshot is not open)
+ */
+int64_t SzConfigTool_handleRelease(SzConfigTool_handle *handle, int64_t snapshot);
+
+/**
+ * Apply a buffer of command-script lines to a handle, all or nothing
+ *
+ * On a failing line SzConfigTool_getLastError() starts with "Line N:" and the
+ * handle is unchanged.
+ *
+ * # Safety
+ * commands must point to at least len bytes of UTF-8 (need not be null-terminated)
+ */
+int64_t SzConfigTool_handleApplyCommandsAtomic(SzConfigTool_handle *handle, const char *commands, size_t len);
+
+/* ============================================================================
+ * Config Validation
+ * ============================================================================ */
+
+/**
+ * Check the referential integrity of a configuration
+ *
+ * Every cross-table reference (CFG_FBOM.FTYPE_ID, CFG_ATTR.FTYPE_CODE,
+ * CFG_CFCALL.CFUNC_ID, ...) must resolve and no section may hold two rows with
+ * the same key. Null, empty and non-positive references are not checked.
+ * Returns {"valid", "rowsChecked", "summary": {"duplicate",
+ * "danglingReference", "missingSection"}, "findings": [{"kind", "section",
+ * "row", "fields", "value", "target", "message"}]}.
+ *
+ * # Safety
+ * configJson must be a valid null-terminated C string
+ */
+struct SzConfigTool_result SzConfigTool_validateConfig(const char *config_json);
+
+/**
+ * Check the referential integrity of a handle's configuration
+ * (same report as SzConfigTool_validateConfig)
+ */
+struct SzConfigTool_result SzConfigTool_handleValidateConfig(SzConfigTool_handle *handle);
+
+/* ============================================================================
+ * Fingerprints
+ * ============================================================================ */
+
+/**
+ * Fingerprint a configuration's content
+ *
+ * Formatting (whitespace, string escapes) does not change the fingerprint.
+ * Returns {"fingerprint": "<32 hex digits>", "sections": {"<member>":
+ * "<32 hex digits>", ...}}; comparing the section fingerprints of two results
+ * shows which G2_CONFIG members differ.
+ *
+ * # Safety
+ * configJson must be a valid null-terminated C string
+ */
+struct SzConfigTool_result SzConfigTool_configFingerprint(const char *config_json);
+
+/**
+ * Fingerprint a handle's configuration (same result as SzConfigTool_configFingerprint)
+ */
+struct SzConfigTool_result SzConfigTool_handleConfigFingerprint(SzConfigTool_handle *handle);
+
+/* ============================================================================
+ * Shared Configurations
+ * ============================================================================ */
+
+/**
+ * Opaque configuration read by many threads and occasionally replaced
+ *
+ * Readers always see one whole version. Edits are applied to a copy and
+ * published as a new version; each thread picks up the new version on its
+ * next read. Between publishes a read only loads one shared counter: it takes
+ * no lock and parses no JSON, so reads scale across cores.
+ */
+typedef struct SzConfigTool_shared SzConfigTool_shared;
+
+/**
+ * Parse a configuration into a new shared configuration
+ *
+ * Returns the shared configuration (release with SzConfigTool_sharedClose), or
+ * null on error.
+ */
+SzConfigTool_shared *SzConfigTool_sharedOpen(const char *config_json);
+
+/**
+ * Release a shared configuration
+ *
+ * No other thread may use it during or after this call.
+ */
+void SzConfigTool_sharedClose(SzConfigTool_shared *shared);
+
+/**
+ * Get a feature from the current version (same result as SzConfigTool_getFeature)
+ */
+struct SzConfigTool_result SzConfigTool_sharedGetFeature(const SzConfigTool_shared *shared,
+                                                         const char *feature_code);
+
+/**
+ * List attributes of the current version (same result as SzConfigTool_listAttributes)
+ */
+struct SzConfigTool_result SzConfigTool_sharedListAttributes(const SzConfigTool_shared *shared);
+
+/**
+ * List comparison thresholds of the current version
+ * (same result as SzConfigTool_listComparisonThresholds)
+ */
+struct SzConfigTool_result SzConfigTool_sharedListComparisonThresholds(const SzConfigTool_shared *shared);
+
+/**
+ * Serialize the current version
+ */
+struct SzConfigTool_result SzConfigTool_sharedSerialize(const SzConfigTool_shared *shared);
+
+/**
+ * Number of versions published so far (0 initially), or -1 if shared is null
+ */
+int64_t SzConfigTool_sharedGeneration(const SzConfigTool_shared *shared);
+
+/**
+ * Apply command-script lines to a copy of the current version and publish it
+ *
+ * Readers see the previous version until the whole script has been applied.
+ * On a failing line SzConfigTool_getLastError() starts with "Line N:" and
+ * nothing is published. Concurrent writers run one after the other.
+ *
+ * # Safety
+ * commands must point to at least len bytes of UTF-8 (need not be null-terminated)
+ */
+int64_t SzConfigTool_sharedApplyCommands(const SzConfigTool_shared *shared, const char *commands, size_t len);
+
+/**
+ * Publish a copy of a handle's configuration as the new version
+ */
+int64_t SzConfigTool_sharedPublish(const SzConfigTool_shared *shared, const SzConfigTool_handle *handle);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,424 @@
+/*
+ * C++17 wrapper for libSzConfigTool
+ *
+ * Header-only RAII layer over libSzConfigTool.h:
+ *
+ * - sz::Config owns a SzConfigTool_handle (move-only, closed on destruction)
+ * - sz::String owns a library-allocated string (move-only, freed with
+ *   SzConfigTool_free) and exposes it as std::string_view without copying
+ * - failures throw sz::Error (message and code from SzConfigTool_getLastError
+ *   / SzConfigTool_getLastErrorCode); the try* functions return
+ *   sz::Expected<T> instead
+ *
+ * Every wrapper is an inline call of the C function plus a return-code check,
+ * so it costs the same as calling the C API directly. Handle functions without
+ * a dedicated method are reachable through Config::call:
+ *
+ *     sz::Config config = sz::Config::open(json);
+ *     config.addDataSource("CUSTOMERS");
+ *     config.call(SzConfigTool_handleAddFeature, "MY_FEATURE", feature_json);
+ *     std::string_view features = config.listFeatures();   // borrowed view
+ *     sz::String saved = config.serialize();                // owned, no copy
+ *
+ * String arguments are passed straight to the C API, so they must be
+ * null-terminated: sz::ZStr accepts const char * and const std::string &
+ * (not std::string_view). Script buffers are (pointer, length) in the C API
+ * and take std::string_view.
+ *
+ * A Config must not be used from several threads at once.
+ */
+
+#ifndef LIBSZCONFIGTOOL_HPP
+#define LIBSZCONFIGTOOL_HPP
+
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "libSzConfigTool.h"
+
+namespace sz {
+
+/* ============================================================================
+ * Errors
+ * ============================================================================ */
+
+/**
+ * A failed library call: the message and code of the calling thread's last error
+ */
+class Error : public std::runtime_error {
+public:
+  Error(const std::string &message, int64_t code) : std::runtime_error(message), code_(code) {}
+
+  /** Library error code (negative) */
+  int64_t code() const noexcept { return code_; }
+
+  /** The last error of the calling thread, for a call that returned `code` */
+  static Error last(int64_t code) {
+    const char *message = SzConfigTool_getLastError();
+    int64_t last_code = SzConfigTool_getLastErrorCode();
+    return Error(message != nullptr ? message : "unknown libSzConfigTool error",
+                 last_code != 0 ? last_code : code);
+  }
+
+private:
+  int64_t code_;
+};
+
+/**
+ * Either a value or the Error that prevented it (a C++17 stand-in for std::expected)
+ */
+template <typename T>
+class Expected {
+public:
+  Expected(T value) : state_(std::move(value)) {}
+  Expected(Error error) : state_(std::move(error)) {}
+
+  bool has_value() const noexcept { return state_.index() == 0; }
+  explicit operator bool() const noexcept { return has_value(); }
+
+  /** The value; throws the Error if there is none */
+  T &value() & {
+    if (!has_value()) throw std::get<1>(state_);
+    return std::get<0>(state_);
+  }
+  T &&value() && {
+    if (!has_value()) throw std::get<1>(state_);
+    return std::get<0>(std::move(state_));
+  }
+
+  /** The error (only valid when !has_value()) */
+  const Error &error() const { return std::get<1>(state_); }
+
+  T &operator*() & { return std::get<0>(state_); }
+  T &&operator*() && { return std::get<0>(std::move(state_)); }
+  T *operator->() { return &std::get<0>(state_); }
+
+private:
+  std::variant<T, Error> state_;
+};
+
+/**
+ * Success or the Error of a call without a value
+ */
+template <>
+class Expected<void> {
+public:
+  Expected() = default;
+  Expected(Error error) : error_(std::move(error)), failed_(true) {}
+
+  bool has_value() const noexcept { return !failed_; }
+  explicit operator bool() const noexcept { return has_value(); }
+
+  /** Throws the Error if the call failed */
+  void value() const {
+    if (failed_) throw error_;
+  }
+
+  /** The error (only valid when !has_value()) */
+  const Error &error() const { return error_; }
+
+private:
+  Error error_{std::string(), 0};
+  bool failed_ = false;
+};
+
+/* ============================================================================
+ * Strings
+ * ============================================================================ */
+
+/**
+ * Null-terminated string argument (const char * or const std::string &)
+ *
+ * nullptr is passed through for the optional arguments of the C API.
+ */
+class ZStr {
+public:
+  ZStr(const char *s) noexcept : s_(s) {}
+  ZStr(const std::string &s) noexcept : s_(s.c_str()) {}
+  ZStr(std::nullptr_t) noexcept : s_(nullptr) {}
+
+  const char *c_str() const noexcept { return s_; }
+
+private:
+  const char *s_;
+};
+
+/**
+ * A string allocated by the library, freed with SzConfigTool_free (move-only)
+ */
+class String {
+public:
+  String() noexcept = default;
+  explicit String(char *owned) noexcept : data_(owned) {}
+
+  String(const String &) = delete;
+  String &operator=(const String &) = delete;
+
+  String(String &&other) noexcept : data_(std::exchange(other.data_, nullptr)) {}
+  String &operator=(String &&other) noexcept {
+    if (this != &other) {
+      SzConfigTool_free(data_);
+      data_ = std::exchange(other.data_, nullptr);
+    }
+    return *this;
+  }
+
+  ~String() { SzConfigTool_free(data_); }
+
+  /** The contents, valid while this String lives */
+  std::string_view view() const noexcept {
+    return data_ != nullptr ? std::string_view(data_) : std::string_view();
+  }
+  operator std::string_view() const noexcept { return view(); }
+
+  /** Null-terminated contents (never null) */
+  const char *c_str() const noexcept { return data_ != nullptr ? data_ : ""; }
+
+  bool empty() const noexcept { return data_ == nullptr || *data_ == '\0'; }
+
+  /** Give up ownership; the caller must SzConfigTool_free the pointer */
+  char *release() noexcept { return std::exchange(data_, nullptr); }
+
+private:
+  char *data_ = nullptr;
+};
+
+namespace detail {
+
+inline void check(int64_t code) {
+  if (code < 0) throw Error::last(code);
+}
+
+inline Expected<void> try_check(int64_t code) {
+  if (code < 0) return Error::last(code);
+  return {};
+}
+
+inline String take(SzConfigTool_result result) {
+  if (result.returnCode != 0) {
+    SzConfigTool_free(result.response);
+    throw Error::last(result.returnCode);
+  }
+  return String(result.response);
+}
+
+inline Expected<String> try_take(SzConfigTool_result result) {
+  if (result.returnCode != 0) {
+    SzConfigTool_free(result.response);
+    return Error::last(result.returnCode);
+  }
+  return String(result.response);
+}
+
+/** Convert wrapper arguments to what the C API takes (strings to const char *) */
+template <typename T>
+decltype(auto) arg(T &&value) noexcept {
+  using U = std::decay_t<T>;
+  if constexpr (std::is_same_v<U, std::string> || std::is_same_v<U, String> || std::is_same_v<U, ZStr>) {
+    return value.c_str();
+  } else {
+    return std::forward<T>(value);
+  }
+}
+
+}  // namespace detail
+
+/**
+ * Call a string-API function returning SzConfigTool_result, e.g.
+ * `sz::call(SzConfigTool_addDataSource, json, "CUSTOMERS")`
+ *
+ * Throws sz::Error on failure.
+ */
+template <typename F, typename... Args>
+String call(F function, Args &&...args) {
+  return detail::take(function(detail::arg(std::forward<Args>(args))...));
+}
+
+/** Like sz::call, but returns the error instead of throwing */
+template <typename F, typename... Args>
+Expected<String> try_call(F function, Args &&...args) {
+  return detail::try_take(function(detail::arg(std::forward<Args>(args))...));
+}
+
+/* ============================================================================
+ * Config
+ * ============================================================================ */
+
+/**
+ * A parsed configuration (owns a SzConfigTool_handle; move-only)
+ */
+class Config {
+public:
+  /** Parse configuration JSON; throws sz::Error */
+  static Config open(ZStr config_json) { return Config(checked(SzConfigTool_open(config_json.c_str()))); }
+
+  /** Parse a configuration file; throws sz::Error */
+  static Config openFile(ZStr path) { return Config(checked(SzConfigTool_openFile(path.c_str()))); }
+
+  /** Load a binary snapshot file, optionally requiring a compatibility version; throws sz::Error */
+  static Config openSnapshot(ZStr path, ZStr expected_compatibility = nullptr) {
+    return Config(checked(SzConfigTool_openSnapshot(path.c_str(), expected_compatibility.c_str())));
+  }
+
+  /** Parse configuration JSON, returning the error instead of throwing */
+  static Expected<Config> tryOpen(ZStr config_json) {
+    SzConfigTool_handle *handle = SzConfigTool_open(config_json.c_str());
+    if (handle == nullptr) return Error::last(-1);
+    return Config(handle);
+  }
+
+  /** Take ownership of a handle from SzConfigTool_open* */
+  explicit Config(SzConfigTool_handle *handle) noexcept : handle_(handle) {}
+
+  Config(const Config &) = delete;
+  Config &operator=(const Config &) = delete;
+
+  Config(Config &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+  Config &operator=(Config &&other) noexcept {
+    if (this != &other) {
+      SzConfigTool_close(handle_);
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+
+  ~Config() { SzConfigTool_close(handle_); }
+
+  /** The underlying handle (still owned by this Config) */
+  SzConfigTool_handle *get() const noexcept { return handle_; }
+
+  /** Give up ownership; the caller must SzConfigTool_close the handle */
+  SzConfigTool_handle *release() noexcept { return std::exchange(handle_, nullptr); }
+
+  /**
+   * Call any SzConfigTool_handle* function returning a status code, e.g.
+   * `config.call(SzConfigTool_handleDeleteFeature, "MY_FEATURE")`
+   *
+   * Returns the (non-negative) code; throws sz::Error on failure.
+   */
+  template <typename F, typename... Args>
+  int64_t call(F function, Args &&...args) {
+    int64_t code = function(handle_, detail::arg(std::forward<Args>(args))...);
+    detail::check(code);
+    return code;
+  }
+
+  /** Like call, but returns the error instead of throwing */
+  template <typename F, typename... Args>
+  Expected<void> tryCall(F function, Args &&...args) {
+    return detail::try_check(function(handle_, detail::arg(std::forward<Args>(args))...));
+  }
+
+  /* ----- Serialization ----- */
+
+  /** Compact JSON of the configuration */
+  String serialize() const { return detail::take(SzConfigTool_serialize(handle_)); }
+
+  void saveFile(ZStr path) { call(SzConfigTool_saveFile, path); }
+  void saveSnapshot(ZStr path) { call(SzConfigTool_saveSnapshot, path); }
+
+  /* ----- Edits ----- */
+
+  void addDataSource(ZStr code) { call(SzConfigTool_handleAddDataSource, code); }
+  void deleteDataSource(ZStr code) { call(SzConfigTool_handleDeleteDataSource, code); }
+  void setDataSource(ZStr code, ZStr updates_json) { call(SzConfigTool_handleSetDataSource, code, updates_json); }
+
+  void addFeature(ZStr code, ZStr feature_json) { call(SzConfigTool_handleAddFeature, code, feature_json); }
+  void deleteFeature(ZStr code_or_id) { call(SzConfigTool_handleDeleteFeature, code_or_id); }
+
+  void addConfigSection(ZStr section) { call(SzConfigTool_handleAddConfigSection, section); }
+  void removeConfigSection(ZStr section) { call(SzConfigTool_handleRemoveConfigSection, section); }
+
+  void applyPatch(ZStr patch_json) { call(SzConfigTool_handleApplyPatch, patch_json); }
+
+  /** Run command-script lines; lines before a failing one remain applied */
+  void applyCommands(std::string_view script) {
+    call(SzConfigTool_handleApplyCommands, script.data(), script.size());
+  }
+
+  /** Run command-script lines as a transaction: all applied or none */
+  void applyCommandsAtomic(std::string_view script) {
+    call(SzConfigTool_handleApplyCommandsAtomic, script.data(), script.size());
+  }
+
+  /* ----- Borrowed reads (valid until the next call on this Config) ----- */
+
+  std::string_view listFeatures() { return view(SzConfigTool_handleListFeatures); }
+  std::string_view listGenericThresholds() { return view(SzConfigTool_handleListGenericThresholds); }
+  std::string_view getConfigSection(ZStr section, ZStr filter = nullptr) {
+    return view(SzConfigTool_handleGetConfigSection, section, filter);
+  }
+
+  /* ----- Owned reads ----- */
+
+  String validate() { return detail::take(SzConfigTool_handleValidateConfig(handle_)); }
+  String fingerprint() { return detail::take(SzConfigTool_handleConfigFingerprint(handle_)); }
+
+  /* ----- Snapshots ----- */
+
+  class Transaction;
+
+  /** Open a snapshot; returns its ID for rollback / releaseSnapshot */
+  int64_t snapshot() { return call(SzConfigTool_handleSnapshot); }
+  void rollback(int64_t snapshot) { call(SzConfigTool_handleRollback, snapshot); }
+  void releaseSnapshot(int64_t snapshot) { call(SzConfigTool_handleRelease, snapshot); }
+
+private:
+  static SzConfigTool_handle *checked(SzConfigTool_handle *handle) {
+    if (handle == nullptr) throw Error::last(-1);
+    return handle;
+  }
+
+  template <typename F, typename... Args>
+  std::string_view view(F function, Args &&...args) {
+    const char *out = nullptr;
+    size_t out_len = 0;
+    call(function, std::forward<Args>(args)..., &out, &out_len);
+    return std::string_view(out, out_len);
+  }
+
+  SzConfigTool_handle *handle_ = nullptr;
+};
+
+/**
+ * Scoped snapshot: rolled back on destruction unless commit() was called
+ *
+ *     {
+ *         sz::Config::Transaction tx(config);
+ *         config.addDataSource("A");
+ *         config.addDataSource("B");   // throws: both are rolled back
+ *         tx.commit();
+ *     }
+ */
+class Config::Transaction {
+public:
+  explicit Transaction(Config &config) : config_(&config), snapshot_(config.snapshot()) {}
+
+  Transaction(const Transaction &) = delete;
+  Transaction &operator=(const Transaction &) = delete;
+
+  /** Keep the changes */
+  void commit() {
+    config_->releaseSnapshot(snapshot_);
+    config_ = nullptr;
+  }
+
+  ~Transaction() {
+    if (config_ != nullptr) SzConfigTool_handleRollback(config_->get(), snapshot_);
+  }
+
+private:
+  Config *config_;
+  int64_t snapshot_;
+};
+
+}  // namespace sz
+
+#endif /* LIBSZCONFIGTOOL_HPP */
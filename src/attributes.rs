@@ -1,6 +1,18 @@
 use crate::error::{Result, SzConfigError};
-use crate::helpers;
+use crate::handle::{self, ConfigHandle};
 use serde_json::{Value, json};
+use std::collections::HashSet;
+
+/// Attribute classes accepted by [`add_attribute`]
+const VALID_CLASSES: [&str; 7] = [
+    "NAME",
+    "ATTRIBUTE",
+    "IDENTIFIER",
+    "ADDRESS",
+    "PHONE",
+    "RELATIONSHIP",
+    "OTHER",
+];
 
 // ============================================================================
 // Parameter Structs
@@ -71,6 +83,128 @@ impl<'a> TryFrom<&'a Value> for SetAttributeParams<'a> {
     }
 }
 
+impl ConfigHandle {
+    /// Add a new attribute (in-place form of [`add_attribute`])
+    ///
+    /// Returns the newly created attribute.
+    pub fn add_attribute(&mut self, params: AddAttributeParams) -> Result<Value> {
+        let mut added = self.add_attributes(std::slice::from_ref(&params))?;
+        Ok(added.pop().expect("one attribute added"))
+    }
+
+    /// Add several attributes (in-place form of [`add_attributes`])
+    ///
+    /// Returns the newly created attributes, in order.
+    pub fn add_attributes(&mut self, attributes: &[AddAttributeParams]) -> Result<Vec<Value>> {
+        // Validate the whole batch before touching the document
+        let mut codes = Vec::with_capacity(attributes.len());
+        for params in attributes {
+            // Validate attribute class (matches Python line 173-181)
+            if !VALID_CLASSES.contains(&params.class) {
+                return Err(SzConfigError::InvalidInput(format!(
+                    "Invalid attribute class '{}'. Must be one of: {}",
+                    params.class,
+                    VALID_CLASSES.join(", ")
+                )));
+            }
+            codes.push(params.attribute.to_uppercase());
+        }
+
+        self.section("CFG_ATTR")?;
+        let mut batch = HashSet::with_capacity(codes.len());
+        for code in &codes {
+            if !batch.insert(code.as_str())
+                || self.has_code("CFG_ATTR", "ATTR_CODE", "ATTR_ID", code)
+            {
+                return Err(SzConfigError::AlreadyExists(format!("Attribute: {}", code)));
+            }
+        }
+
+        let first_id = self.next_id("CFG_ATTR", "ATTR_ID", None)?;
+        let mut added = Vec::with_capacity(attributes.len());
+        for ((params, attribute_upper), id) in attributes.iter().zip(codes).zip(first_id..) {
+            // Create CFG_ATTR entry (matching Python lines 2342-2350)
+            let new_attribute = json!({
+                "ATTR_ID": id,
+                "ATTR_CODE": attribute_upper,
+                "ATTR_CLASS": params.class,
+                "FTYPE_CODE": params.feature.to_uppercase(),  // Use actual feature code, not Null
+                "FELEM_CODE": params.element.to_uppercase(),  // Use actual element code, not Null
+                "FELEM_REQ": params.required.unwrap_or("No"),
+                "DEFAULT_VALUE": params.default_value.map(|v| json!(v)).unwrap_or(Value::Null),
+                "INTERNAL": params.internal.unwrap_or("No")
+            });
+
+            // Add to CFG_ATTR only (Python does not create FBOM in addAttribute)
+            self.push_row("CFG_ATTR", new_attribute.clone())?;
+            added.push(new_attribute);
+        }
+        Ok(added)
+    }
+
+    /// Delete an attribute (in-place form of [`delete_attribute`])
+    pub fn delete_attribute(&mut self, code: &str) -> Result<()> {
+        self.delete_from_config_array("CFG_ATTR", "ATTR_CODE", &code.to_uppercase())
+    }
+
+    /// Get a specific attribute by code (see [`get_attribute`])
+    pub fn get_attribute(&self, code: &str) -> Result<Value> {
+        let code_upper = code.to_uppercase();
+        self.section("CFG_ATTR")?
+            .iter()
+            .find(|attr| attr["ATTR_CODE"].as_str() == Some(&code_upper))
+            .cloned()
+            .ok_or_else(|| SzConfigError::NotFound(format!("Attribute not found: {}", code_upper)))
+    }
+
+    /// List all attributes (see [`list_attributes`])
+    pub fn list_attributes(&self) -> Result<Vec<Value>> {
+        let attrs = self.section("CFG_ATTR")?;
+
+        Ok(attrs
+            .iter()
+            .map(|item| {
+                json!({
+                    "id": item.get("ATTR_ID").and_then(|v| v.as_i64()).unwrap_or(0),
+                    "attribute": item.get("ATTR_CODE").and_then(|v| v.as_str()).unwrap_or(""),
+                    "class": item.get("ATTR_CLASS").and_then(|v| v.as_str()).unwrap_or(""),
+                    "feature": item.get("FTYPE_CODE").cloned().unwrap_or(Value::Null),
+                    "element": item.get("FELEM_CODE").cloned().unwrap_or(Value::Null),
+                    "required": item.get("FELEM_REQ").and_then(|v| v.as_str()).unwrap_or(""),
+                    "default": item.get("DEFAULT_VALUE").cloned().unwrap_or(Value::Null),
+                    "internal": item.get("INTERNAL").and_then(|v| v.as_str()).unwrap_or("")
+                })
+            })
+            .collect())
+    }
+
+    /// Set (update) an attribute's properties (in-place form of [`set_attribute`])
+    pub fn set_attribute(&mut self, params: SetAttributeParams) -> Result<()> {
+        let code_upper = params.attribute.to_uppercase();
+        let attrs = self.section_mut("CFG_ATTR")?;
+
+        let attr = attrs
+            .iter_mut()
+            .find(|a| a["ATTR_CODE"].as_str() == Some(&code_upper))
+            .ok_or_else(|| {
+                SzConfigError::NotFound(format!("Attribute not found: {}", code_upper))
+            })?;
+
+        // Update fields if provided
+        if let Some(val) = params.internal {
+            attr["INTERNAL"] = json!(val);
+        }
+        if let Some(val) = params.required {
+            attr["FELEM_REQ"] = json!(val);
+        }
+        if let Some(val) = params.default_value {
+            attr["DEFAULT_VALUE"] = json!(val);
+        }
+
+        Ok(())
+    }
+}
+
 /// Add a new attribute to the configuration
 ///
 /// # Arguments
@@ -87,68 +221,32 @@ impl<'a> TryFrom<&'a Value> for SetAttributeParams<'a> {
 /// - `JsonParse` if config_json is invalid
 /// - `MissingSection` if required sections don't exist
 pub fn add_attribute(config_json: &str, params: AddAttributeParams) -> Result<(String, Value)> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Validate attribute class (matches Python line 173-181)
-    let valid_classes = [
-        "NAME",
-        "ATTRIBUTE",
-        "IDENTIFIER",
-        "ADDRESS",
-        "PHONE",
-        "RELATIONSHIP",
-        "OTHER",
-    ];
-    if !valid_classes.contains(&params.class) {
-        return Err(SzConfigError::InvalidInput(format!(
-            "Invalid attribute class '{}'. Must be one of: {}",
-            params.class,
-            valid_classes.join(", ")
-        )));
-    }
-
-    let attribute_upper = params.attribute.to_uppercase();
-    let feature_upper = params.feature.to_uppercase();
-    let element_upper = params.element.to_uppercase();
-
-    // Check if attribute already exists
-    let attrs = config
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_ATTR"))
-        .and_then(|v| v.as_array())
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_ATTR".to_string()))?;
-
-    if attrs
-        .iter()
-        .any(|attr| attr["ATTR_CODE"].as_str() == Some(&attribute_upper))
-    {
-        return Err(SzConfigError::AlreadyExists(format!(
-            "Attribute: {}",
-            attribute_upper
-        )));
-    }
-
-    // Get next ATTR_ID
-    let next_attr_id = helpers::get_next_id_from_array(attrs, "ATTR_ID")?;
-
-    // Create CFG_ATTR entry (matching Python lines 2342-2350)
-    let new_attribute = json!({
-        "ATTR_ID": next_attr_id,
-        "ATTR_CODE": attribute_upper.clone(),
-        "ATTR_CLASS": params.class,
-        "FTYPE_CODE": feature_upper,  // Use actual feature code, not Null
-        "FELEM_CODE": element_upper,  // Use actual element code, not Null
-        "FELEM_REQ": params.required.unwrap_or("No"),
-        "DEFAULT_VALUE": params.default_value.map(|v| json!(v)).unwrap_or(Value::Null),
-        "INTERNAL": params.internal.unwrap_or("No")
-    });
-
-    // Add to CFG_ATTR only (Python does not create FBOM in addAttribute)
-    let modified_json =
-        helpers::add_to_config_array(config_json, "CFG_ATTR", new_attribute.clone())?;
+    handle::edit_returning(config_json, |config| config.add_attribute(params))
+}
 
-    Ok((modified_json, new_attribute))
+/// Add several attributes to the configuration
+///
+/// Produces the same configuration as calling [`add_attribute`] for each
+/// entry in turn, with one parse and one serialize for the whole batch. Every
+/// entry is checked first, so on error nothing is added.
+///
+/// # Arguments
+/// * `config_json` - JSON configuration string
+/// * `attributes` - Attribute parameters, added in order
+///
+/// # Returns
+/// Tuple of (modified_json, new_attributes)
+///
+/// # Errors
+/// - `AlreadyExists` if an attribute code already exists or is listed twice
+/// - `InvalidInput` if an attribute class is invalid
+/// - `JsonParse` if config_json is invalid
+/// - `MissingSection` if CFG_ATTR section doesn't exist
+pub fn add_attributes(
+    config_json: &str,
+    attributes: &[AddAttributeParams],
+) -> Result<(String, Vec<Value>)> {
+    handle::edit_returning(config_json, |config| config.add_attributes(attributes))
 }
 
 /// Delete an attribute from the configuration
@@ -165,7 +263,7 @@ pub fn add_attribute(config_json: &str, params: AddAttributeParams) -> Result<(S
 /// - `JsonParse` if config_json is invalid
 /// - `MissingSection` if CFG_ATTR section doesn't exist
 pub fn delete_attribute(config_json: &str, code: &str) -> Result<String> {
-    helpers::delete_from_config_array(config_json, "CFG_ATTR", "ATTR_CODE", &code.to_uppercase())
+    handle::edit(config_json, |config| config.delete_attribute(code))
 }
 
 /// Get a specific attribute by code
@@ -182,19 +280,9 @@ pub fn delete_attribute(config_json: &str, code: &str) -> Result<String> {
 /// - `JsonParse` if config_json is invalid
 /// - `MissingSection` if CFG_ATTR section doesn't exist
 pub fn get_attribute(config_json: &str, code: &str) -> Result<Value> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let code_upper = code.to_uppercase();
-    config
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_ATTR"))
-        .and_then(|v| v.as_array())
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_ATTR".to_string()))?
-        .iter()
-        .find(|attr| attr["ATTR_CODE"].as_str() == Some(&code_upper))
-        .cloned()
-        .ok_or_else(|| SzConfigError::NotFound(format!("Attribute not found: {}", code_upper)))
+    handle::read_sections(config_json, &["CFG_ATTR"], |config| {
+        config.get_attribute(code)
+    })
 }
 
 /// List all attributes
@@ -209,30 +297,9 @@ pub fn get_attribute(config_json: &str, code: &str) -> Result<Value> {
 /// - `JsonParse` if config_json is invalid
 /// - `MissingSection` if CFG_ATTR section doesn't exist
 pub fn list_attributes(config_json: &str) -> Result<Vec<Value>> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let attrs = config
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_ATTR"))
-        .and_then(|v| v.as_array())
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_ATTR".to_string()))?;
-
-    Ok(attrs
-        .iter()
-        .map(|item| {
-            json!({
-                "id": item.get("ATTR_ID").and_then(|v| v.as_i64()).unwrap_or(0),
-                "attribute": item.get("ATTR_CODE").and_then(|v| v.as_str()).unwrap_or(""),
-                "class": item.get("ATTR_CLASS").and_then(|v| v.as_str()).unwrap_or(""),
-                "feature": item.get("FTYPE_CODE").cloned().unwrap_or(Value::Null),
-                "element": item.get("FELEM_CODE").cloned().unwrap_or(Value::Null),
-                "required": item.get("FELEM_REQ").and_then(|v| v.as_str()).unwrap_or(""),
-                "default": item.get("DEFAULT_VALUE").cloned().unwrap_or(Value::Null),
-                "internal": item.get("INTERNAL").and_then(|v| v.as_str()).unwrap_or("")
-            })
-        })
-        .collect())
+    handle::read_sections(config_json, &["CFG_ATTR"], |config| {
+        config.list_attributes()
+    })
 }
 
 /// Set (update) an attribute's properties
@@ -250,31 +317,5 @@ pub fn list_attributes(config_json: &str) -> Result<Vec<Value>> {
 /// - `JsonParse` if config_json is invalid
 /// - `MissingSection` if CFG_ATTR section doesn't exist
 pub fn set_attribute(config_json: &str, params: SetAttributeParams) -> Result<String> {
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let code_upper = params.attribute.to_uppercase();
-    let attrs = config
-        .get_mut("G2_CONFIG")
-        .and_then(|g| g.get_mut("CFG_ATTR"))
-        .and_then(|v| v.as_array_mut())
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_ATTR".to_string()))?;
-
-    let attr = attrs
-        .iter_mut()
-        .find(|a| a["ATTR_CODE"].as_str() == Some(&code_upper))
-        .ok_or_else(|| SzConfigError::NotFound(format!("Attribute not found: {}", code_upper)))?;
-
-    // Update fields if provided
-    if let Some(val) = params.internal {
-        attr["INTERNAL"] = json!(val);
-    }
-    if let Some(val) = params.required {
-        attr["FELEM_REQ"] = json!(val);
-    }
-    if let Some(val) = params.default_value {
-        attr["DEFAULT_VALUE"] = json!(val);
-    }
-
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config_json, |config| config.set_attribute(params))
 }
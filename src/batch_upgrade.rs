@@ -0,0 +1,627 @@
+//! Parallel upgrade of many configurations with one command script
+//!
+//! [`BatchUpgrader`] compiles a `.gtc` script once and applies it to a list of
+//! configurations on a pool of worker threads. Workers claim the next
+//! configuration from a shared cursor as soon as they finish the previous
+//! one, so a few large configurations don't hold up the rest.
+//!
+//! [`BatchUpgrader::upgrade_files`] reads each input and writes its output
+//! inside the worker, streaming both through buffered I/O, so at most one
+//! parsed configuration per thread is in memory at a time however many files
+//! are processed.
+//!
+//! With an [`UpgradeMemo`] ([`BatchUpgrader::memo`]) an input whose content
+//! was already upgraded with the same script gets the stored result instead
+//! of being upgraded again. Byte-identical inputs are recognized without being
+//! parsed. The memo can be shared by several upgraders and batches, holds a
+//! bounded number of results, and keys on SHA-256 digests, so a crafted input
+//! cannot be mistaken for another tenant's configuration.
+//!
+//! # Example
+//!
+//! ```no_run
+//! use sz_configtool_lib::batch_upgrade::BatchUpgrader;
+//! use std::path::PathBuf;
+//!
+//! let script = std::fs::read_to_string("upgrade-10-to-11.gtc")?;
+//! let upgrader = BatchUpgrader::new(&script)?;
+//!
+//! let jobs: Vec<(PathBuf, PathBuf)> = ["tenant1", "tenant2"]
+//!     .iter()
+//!     .map(|t| (format!("{t}/g2config.json").into(), format!("{t}/g2config_v11.json").into()))
+//!     .collect();
+//!
+//! let report = upgrader.upgrade_files(&jobs);
+//! println!("{}", report.summary());
+//! # Ok::<(), Box<dyn std::error::Error>>(())
+//! ```
+
+use crate::command_processor::CompiledScript;
+use crate::error::{Result, SzConfigError};
+use crate::fingerprint::Digest;
+use crate::handle::{self, ConfigHandle};
+use crate::helpers::run_parallel;
+use std::collections::HashMap;
+use std::fs::File;
+use std::hash::Hash;
+use std::io::BufReader;
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::{Arc, Mutex, OnceLock, PoisonError};
+use std::thread;
+
+/// Result of upgrading one configuration
+#[derive(Debug)]
+pub struct UpgradeOutcome {
+    /// Commands executed (the full script length on success)
+    pub commands_executed: usize,
+    /// Upgraded configuration JSON (only for [`BatchUpgrader::upgrade_configs`])
+    pub config: Option<String>,
+    /// Why the upgrade failed, if it did
+    pub error: Option<SzConfigError>,
+}
+
+impl UpgradeOutcome {
+    /// True if the whole script was applied
+    pub fn is_ok(&self) -> bool {
+        self.error.is_none()
+    }
+}
+
+/// Outcomes of a batch upgrade, in input order
+#[derive(Debug)]
+pub struct BatchReport {
+    pub outcomes: Vec<UpgradeOutcome>,
+}
+
+impl BatchReport {
+    /// Number of configurations upgraded successfully
+    pub fn succeeded(&self) -> usize {
+        self.outcomes.iter().filter(|o| o.is_ok()).count()
+    }
+
+    /// Number of configurations that failed
+    pub fn failed(&self) -> usize {
+        self.outcomes.len() - self.succeeded()
+    }
+
+    /// Get execution summary
+    pub fn summary(&self) -> String {
+        format!(
+            "Upgraded {} of {} configs ({} failed), executed {} commands",
+            self.succeeded(),
+            self.outcomes.len(),
+            self.failed(),
+            self.outcomes
+                .iter()
+                .map(|o| o.commands_executed)
+                .sum::<usize>()
+        )
+    }
+}
+
+/// Results an [`UpgradeMemo::new`] memo holds
+pub const DEFAULT_MEMO_CAPACITY: usize = 32;
+
+/// Input and key digests remembered per result slot; they are 32-64 bytes
+/// each, against a whole configuration per result
+const DIGESTS_PER_RESULT: usize = 16;
+
+/// Upgrade results keyed on (configuration digest, script digest)
+///
+/// Digests are SHA-256 over the same content as the
+/// [fingerprints](crate::fingerprint) (formatting does not count); unlike
+/// fingerprints they are collision-resistant.
+///
+/// Each result is computed once while it is stored: a worker asking for a
+/// result that another worker is computing waits for it. Failed upgrades are
+/// remembered too. When the memo is full, the least recently used result is
+/// evicted.
+///
+/// [`BatchUpgrader::upgrade_files`] stores a result only when its key comes
+/// up a second time, so inputs that never repeat are streamed as without a
+/// memo.
+#[derive(Debug)]
+pub struct UpgradeMemo {
+    /// Digest of the raw input → digest of its content
+    inputs: Mutex<Lru<Digest, Digest>>,
+    results: Mutex<Lru<MemoKey, Arc<OnceLock<Memoized>>>>,
+    /// Keys upgraded once from a file without storing the result
+    seen: Mutex<Lru<MemoKey, ()>>,
+    hits: AtomicUsize,
+}
+
+impl Default for UpgradeMemo {
+    fn default() -> Self {
+        Self::with_capacity(DEFAULT_MEMO_CAPACITY)
+    }
+}
+
+/// (configuration digest, script digest)
+type MemoKey = (Digest, Digest);
+
+/// Upgraded JSON and commands executed, or the error
+type Memoized = Result<(String, usize)>;
+
+impl UpgradeMemo {
+    /// Empty memo holding up to [`DEFAULT_MEMO_CAPACITY`] results
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Empty memo holding up to `results` results (at least one)
+    pub fn with_capacity(results: usize) -> Self {
+        let results = results.max(1);
+        let digests = results.saturating_mul(DIGESTS_PER_RESULT);
+        Self {
+            inputs: Mutex::new(Lru::new(digests)),
+            results: Mutex::new(Lru::new(results)),
+            seen: Mutex::new(Lru::new(digests)),
+            hits: AtomicUsize::new(0),
+        }
+    }
+
+    /// Upgrades answered from the memo
+    pub fn hits(&self) -> usize {
+        self.hits.load(Ordering::Relaxed)
+    }
+
+    /// Number of stored results
+    pub fn len(&self) -> usize {
+        self.results
+            .lock()
+            .unwrap_or_else(PoisonError::into_inner)
+            .len()
+    }
+
+    /// True if no result is stored
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Content digest of an input seen before
+    fn known_input(&self, raw: Digest) -> Option<Digest> {
+        let mut inputs = self.inputs.lock().unwrap_or_else(PoisonError::into_inner);
+        inputs.get(&raw).copied()
+    }
+
+    fn remember_input(&self, raw: Digest, content: Digest) {
+        let mut inputs = self.inputs.lock().unwrap_or_else(PoisonError::into_inner);
+        inputs.insert(raw, content);
+    }
+
+    /// The stored result for `key`, computing it with `f` if there is none
+    fn get_or_compute<F>(&self, key: MemoKey, f: F) -> Memoized
+    where
+        F: FnOnce() -> Memoized,
+    {
+        let cell = {
+            let mut results = self.results.lock().unwrap_or_else(PoisonError::into_inner);
+            Arc::clone(results.get_or_insert_with(key, Arc::default))
+        };
+
+        let mut computed = false;
+        let result = cell.get_or_init(|| {
+            computed = true;
+            f()
+        });
+        if !computed {
+            self.hits.fetch_add(1, Ordering::Relaxed);
+        }
+        result.clone()
+    }
+
+    /// The result for `key` if one is already computed
+    fn ready(&self, key: MemoKey) -> Option<Memoized> {
+        let cell = {
+            let mut results = self.results.lock().unwrap_or_else(PoisonError::into_inner);
+            Arc::clone(results.get(&key)?)
+        };
+        let result = cell.get()?.clone();
+        self.hits.fetch_add(1, Ordering::Relaxed);
+        Some(result)
+    }
+
+    /// True if `key` was asked for before; otherwise remember it
+    fn recurred(&self, key: MemoKey) -> bool {
+        let stored = {
+            let mut results = self.results.lock().unwrap_or_else(PoisonError::into_inner);
+            results.get(&key).is_some()
+        };
+        let mut seen = self.seen.lock().unwrap_or_else(PoisonError::into_inner);
+        if stored || seen.remove(&key).is_some() {
+            return true;
+        }
+        seen.get_or_insert_with(key, || ());
+        false
+    }
+}
+
+/// Map of at most `capacity` entries that evicts the least recently used
+#[derive(Debug)]
+struct Lru<K, V> {
+    /// Value and the tick of its last use
+    entries: HashMap<K, (V, u64)>,
+    tick: u64,
+    capacity: usize,
+}
+
+impl<K: Hash + Eq + Copy, V> Lru<K, V> {
+    fn new(capacity: usize) -> Self {
+        Self {
+            entries: HashMap::new(),
+            tick: 0,
+            capacity: capacity.max(1),
+        }
+    }
+
+    fn len(&self) -> usize {
+        self.entries.len()
+    }
+
+    fn get(&mut self, key: &K) -> Option<&V> {
+        self.tick += 1;
+        let (value, used) = self.entries.get_mut(key)?;
+        *used = self.tick;
+        Some(value)
+    }
+
+    fn get_or_insert_with(&mut self, key: K, f: impl FnOnce() -> V) -> &V {
+        if !self.entries.contains_key(&key) && self.entries.len() >= self.capacity {
+            // Linear, but only on insert into a full map, and the maps are small
+            let oldest = self
+                .entries
+                .iter()
+                .min_by_key(|(_, (_, used))| *used)
+                .map(|(key, _)| *key);
+            if let Some(oldest) = oldest {
+                self.entries.remove(&oldest);
+            }
+        }
+        self.tick += 1;
+        let entry = self.entries.entry(key).or_insert_with(|| (f(), 0));
+        entry.1 = self.tick;
+        &entry.0
+    }
+
+    fn insert(&mut self, key: K, value: V) {
+        self.entries.remove(&key);
+        self.get_or_insert_with(key, || value);
+    }
+
+    fn remove(&mut self, key: &K) -> Option<V> {
+        self.entries.remove(key).map(|(value, _)| value)
+    }
+}
+
+/// Applies one compiled command script to many configurations in parallel
+pub struct BatchUpgrader {
+    script: CompiledScript,
+    threads: usize,
+    memo: Option<Arc<UpgradeMemo>>,
+    script_digest: Digest,
+}
+
+impl BatchUpgrader {
+    /// Compile a command script for batch use
+    ///
+    /// # Arguments
+    /// * `script` - Script content with line-based commands
+    ///
+    /// # Errors
+    /// - `InvalidConfig` naming the first line that cannot be compiled
+    pub fn new(script: &str) -> Result<Self> {
+        Ok(Self::from_script(CompiledScript::compile(script)?))
+    }
+
+    /// Use an already compiled command script
+    pub fn from_script(script: CompiledScript) -> Self {
+        Self {
+            script_digest: script.digest(),
+            script,
+            threads: thread::available_parallelism().map_or(1, |n| n.get()),
+            memo: None,
+        }
+    }
+
+    /// Reuse results for identical inputs through `memo` (off by default)
+    ///
+    /// With a memo, [`upgrade_files`](Self::upgrade_files) reads each input
+    /// twice: once to digest its bytes, then, unless a stored result is
+    /// written instead, to parse it as a stream.
+    pub fn memo(mut self, memo: Arc<UpgradeMemo>) -> Self {
+        self.memo = Some(memo);
+        self
+    }
+
+    /// Set the number of worker threads (default: available parallelism)
+    ///
+    /// # Arguments
+    /// * `threads` - Worker count; 0 keeps the default
+    pub fn threads(mut self, threads: usize) -> Self {
+        if threads > 0 {
+            self.threads = threads;
+        }
+        self
+    }
+
+    /// Upgrade in-memory configurations
+    ///
+    /// # Returns
+    /// Report with the upgraded JSON in each successful outcome
+    pub fn upgrade_configs(&self, configs: &[String]) -> BatchReport {
+        self.run(configs.len(), |i| {
+            let (json, commands_executed) = self.upgrade_one(&configs[i])?;
+            Ok((Some(json), commands_executed))
+        })
+    }
+
+    /// Upgrade configuration files
+    ///
+    /// # Arguments
+    /// * `jobs` - (input path, output path) pairs; input and output may be the same file
+    ///
+    /// # Returns
+    /// Report without configuration JSON (it is written to the output paths)
+    pub fn upgrade_files(&self, jobs: &[(PathBuf, PathBuf)]) -> BatchReport {
+        self.run(jobs.len(), |i| {
+            let (input, output) = &jobs[i];
+            let commands_executed = match &self.memo {
+                Some(memo) => self.upgrade_file_memoized(memo, input, output)?,
+                None => {
+                    let mut config = handle::open_config_file(input)?;
+                    let commands_executed = self.script.apply(&mut config)?;
+                    handle::save_config_file(&config, output)?;
+                    commands_executed
+                }
+            };
+            Ok((None, commands_executed))
+        })
+    }
+
+    /// Upgrade one file, writing a stored result if the memo has one
+    ///
+    /// The result is stored only if the input's key was seen before;
+    /// otherwise the upgraded handle is streamed to `output` as without a memo.
+    fn upgrade_file_memoized(
+        &self,
+        memo: &UpgradeMemo,
+        input: &Path,
+        output: &Path,
+    ) -> Result<usize> {
+        let read_error = |e: std::io::Error| {
+            SzConfigError::InvalidConfig(format!("Failed to read {}: {}", input.display(), e))
+        };
+        let write = |json: &str| {
+            std::fs::write(output, json).map_err(|e| {
+                SzConfigError::InvalidConfig(format!("Failed to write {}: {}", output.display(), e))
+            })
+        };
+
+        let file = File::open(input).map_err(read_error)?;
+        let raw = Digest::of_reader(BufReader::new(file)).map_err(read_error)?;
+        let known = memo.known_input(raw);
+        if let Some(content) = known
+            && let Some(result) = memo.ready((content, self.script_digest))
+        {
+            let (json, commands_executed) = result?;
+            write(&json)?;
+            return Ok(commands_executed);
+        }
+
+        let mut config = handle::open_config_file(input)?;
+        let content = known.unwrap_or_else(|| {
+            let content = Digest::of_value(config.as_value());
+            memo.remember_input(raw, content);
+            content
+        });
+        let key = (content, self.script_digest);
+
+        if !memo.recurred(key) {
+            let commands_executed = self.script.apply(&mut config)?;
+            handle::save_config_file(&config, output)?;
+            return Ok(commands_executed);
+        }
+
+        let (json, commands_executed) = memo.get_or_compute(key, || {
+            let executed = self.script.apply(&mut config)?;
+            Ok((config.to_json()?, executed))
+        })?;
+        write(&json)?;
+        Ok(commands_executed)
+    }
+
+    /// Apply the script to one configuration (or take the memoized result)
+    fn upgrade_one(&self, config_json: &str) -> Result<(String, usize)> {
+        let Some(memo) = &self.memo else {
+            return self.apply(config_json, None);
+        };
+
+        let raw = Digest::of_bytes(config_json.as_bytes());
+        let (content, parsed) = match memo.known_input(raw) {
+            Some(content) => (content, None),
+            None => {
+                let config = ConfigHandle::from_json_with_spans(config_json)?;
+                let content = Digest::of_value(config.as_value());
+                memo.remember_input(raw, content);
+                (content, Some(config))
+            }
+        };
+
+        memo.get_or_compute((content, self.script_digest), || {
+            self.apply(config_json, parsed)
+        })
+    }
+
+    /// Apply the script to `config_json`, or to `parsed` when it was already
+    /// parsed from it; sections the script leaves alone are copied as is
+    fn apply(&self, config_json: &str, parsed: Option<ConfigHandle>) -> Result<(String, usize)> {
+        let mut config = match parsed {
+            Some(config) => config,
+            None => ConfigHandle::from_json_with_spans(config_json)?,
+        };
+        let executed = self.script.apply(&mut config)?;
+        Ok((config.to_json_from(config_json)?, executed))
+    }
+
+    /// Run `job` for indexes 0..count on the worker pool
+    fn run<F>(&self, count: usize, job: F) -> BatchReport
+    where
+        F: Fn(usize) -> Result<(Option<String>, usize)> + Sync,
+    {
+        let outcomes = run_parallel(count, self.threads, |i| match job(i) {
+            Ok((config, commands_executed)) => UpgradeOutcome {
+                commands_executed,
+                config,
+                error: None,
+            },
+            Err(e) => UpgradeOutcome {
+                commands_executed: 0,
+                config: None,
+                error: Some(e),
+            },
+        });
+        BatchReport { outcomes }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const SCRIPT: &str = r#"
+addConfigSection {"section": "CFG_TEST"}
+save
+"#;
+
+    #[test]
+    fn test_upgrade_configs_in_order() {
+        let configs: Vec<String> = (0..20)
+            .map(|i| {
+                if i == 7 {
+                    "{not json".to_string()
+                } else {
+                    format!(r#"{{"G2_CONFIG":{{"CFG_DSRC":[{{"DSRC_ID":{i}}}]}}}}"#)
+                }
+            })
+            .collect();
+
+        let report = BatchUpgrader::new(SCRIPT)
+            .unwrap()
+            .threads(4)
+            .upgrade_configs(&configs);
+
+        assert_eq!(report.outcomes.len(), 20);
+        assert_eq!(report.succeeded(), 19);
+        assert!(report.outcomes[7].error.is_some());
+        let third = report.outcomes[3].config.as_deref().unwrap();
+        assert!(third.contains(r#""DSRC_ID":3"#) && third.contains("CFG_TEST"));
+        assert_eq!(
+            report.summary(),
+            "Upgraded 19 of 20 configs (1 failed), executed 19 commands"
+        );
+    }
+
+    #[test]
+    fn test_memo_computes_identical_inputs_once() {
+        let memo = Arc::new(UpgradeMemo::new());
+        let upgrader = BatchUpgrader::new(SCRIPT)
+            .unwrap()
+            .threads(4)
+            .memo(Arc::clone(&memo));
+
+        let same = r#"{"G2_CONFIG":{"CFG_DSRC":[]}}"#;
+        let reformatted = r#"{ "G2_CONFIG": { "CFG_DSRC": [ ] } }"#;
+        let configs: Vec<String> = [same, same, reformatted, same, r#"{"G2_CONFIG":{}}"#]
+            .iter()
+            .map(|s| s.to_string())
+            .collect();
+
+        let report = upgrader.upgrade_configs(&configs);
+        assert_eq!(report.succeeded(), 5);
+        assert_eq!(memo.len(), 2);
+        assert_eq!(memo.hits(), 3);
+        assert_eq!(report.outcomes[2].config, report.outcomes[0].config);
+
+        // The failure of an already upgraded config (CFG_TEST exists) is kept too
+        let upgraded = vec![report.outcomes[0].config.clone().unwrap(); 2];
+        let report = upgrader.upgrade_configs(&upgraded);
+        assert_eq!(report.failed(), 2);
+        assert_eq!(memo.hits(), 4);
+
+        // A different script is a different key
+        let other = BatchUpgrader::new("addConfigSection {\"section\": \"CFG_OTHER\"}")
+            .unwrap()
+            .memo(Arc::clone(&memo));
+        assert_eq!(other.upgrade_configs(&configs[..1]).succeeded(), 1);
+        assert_eq!(memo.len(), 4);
+    }
+
+    #[test]
+    fn test_memo_evicts_least_recently_used() {
+        let memo = Arc::new(UpgradeMemo::with_capacity(2));
+        let upgrader = BatchUpgrader::new(SCRIPT)
+            .unwrap()
+            .threads(1)
+            .memo(Arc::clone(&memo));
+        let config = |i: i64| format!(r#"{{"G2_CONFIG":{{"CFG_DSRC":[{{"DSRC_ID":{i}}}]}}}}"#);
+
+        upgrader.upgrade_configs(&[config(1), config(2)]);
+        upgrader.upgrade_configs(&[config(1)]);
+        assert_eq!(memo.hits(), 1);
+
+        // 2 is the least recently used, so 3 takes its place
+        upgrader.upgrade_configs(&[config(3)]);
+        assert_eq!(memo.len(), 2);
+        upgrader.upgrade_configs(&[config(1), config(2)]);
+        assert_eq!(memo.hits(), 2);
+        assert_eq!(memo.len(), 2);
+    }
+
+    #[test]
+    fn test_memo_stores_only_recurring_files() {
+        let dir = std::env::temp_dir().join(format!("sz_batch_memo_{}", std::process::id()));
+        std::fs::create_dir_all(&dir).unwrap();
+        let path = |name: &str| dir.join(name);
+        let same = r#"{"G2_CONFIG":{"CFG_DSRC":[]}}"#;
+        std::fs::write(path("a.json"), same).unwrap();
+        std::fs::write(path("b.json"), same).unwrap();
+        std::fs::write(path("c.json"), r#"{"G2_CONFIG":{}}"#).unwrap();
+
+        let memo = Arc::new(UpgradeMemo::new());
+        let upgrader = BatchUpgrader::new(SCRIPT)
+            .unwrap()
+            .threads(1)
+            .memo(Arc::clone(&memo));
+        let jobs = |pairs: &[(&str, &str)]| -> Vec<(PathBuf, PathBuf)> {
+            pairs.iter().map(|(i, o)| (path(i), path(o))).collect()
+        };
+
+        // Nothing repeats yet, so nothing is stored
+        let report = upgrader.upgrade_files(&jobs(&[("a.json", "a1.out"), ("c.json", "c1.out")]));
+        assert_eq!(report.succeeded(), 2);
+        assert!(memo.is_empty());
+
+        // Same content again: upgraded once more and stored
+        upgrader.upgrade_files(&jobs(&[("b.json", "b1.out")]));
+        assert_eq!((memo.len(), memo.hits()), (1, 0));
+
+        // Same bytes again: the stored result is written
+        upgrader.upgrade_files(&jobs(&[("a.json", "a2.out")]));
+        assert_eq!(memo.hits(), 1);
+
+        let read = |name: &str| std::fs::read_to_string(path(name)).unwrap();
+        assert!(read("a1.out").contains("CFG_TEST"));
+        assert_eq!(read("b1.out"), read("a1.out"));
+        assert_eq!(read("a2.out"), read("a1.out"));
+        std::fs::remove_dir_all(&dir).unwrap();
+    }
+
+    #[test]
+    fn test_script_parsed_up_front() {
+        let err = BatchUpgrader::new("addConfigSection {bad json}")
+            .err()
+            .unwrap();
+        assert!(err.to_string().contains("Line 1"));
+    }
+}
@@ -5,7 +5,7 @@
 //! (e.g., BUSINESS vs MOBILE usage).
 
 use crate::error::{Result, SzConfigError};
-use crate::helpers;
+use crate::handle::{self, ConfigHandle};
 use serde_json::{Value, json};
 
 // ============================================================================
@@ -30,6 +30,97 @@ impl<'a> AddBehaviorOverrideParams<'a> {
     }
 }
 
+impl ConfigHandle {
+    /// Add a behavior override (in-place form of [`add_behavior_override`])
+    pub fn add_behavior_override(&mut self, params: AddBehaviorOverrideParams) -> Result<()> {
+        // Lookup FTYPE_ID from feature code
+        let ftype_id = self.lookup_feature_id(params.feature_code)?;
+
+        // Parse behavior code into frequency, exclusivity, stability
+        let (frequency, exclusivity, stability) = parse_behavior_code(params.behavior)?;
+
+        let utype_upper = params.usage_type.to_uppercase();
+
+        // Check for existing override for this feature+usage combination
+        let fbovr_array = self.section_mut("CFG_FBOVR")?;
+
+        if fbovr_array.iter().any(|item| {
+            item["FTYPE_ID"].as_i64() == Some(ftype_id)
+                && item["UTYPE_CODE"].as_str() == Some(&utype_upper)
+        }) {
+            return Err(SzConfigError::AlreadyExists(format!(
+                "Behavior override already exists for feature {} with usage type {}",
+                params.feature_code, utype_upper
+            )));
+        }
+
+        // Add override record to CFG_FBOVR
+        fbovr_array.push(json!({
+            "FTYPE_ID": ftype_id,
+            "UTYPE_CODE": utype_upper,
+            "FTYPE_FREQ": frequency,
+            "FTYPE_EXCL": exclusivity,
+            "FTYPE_STAB": stability
+        }));
+
+        Ok(())
+    }
+
+    /// Delete a behavior override (in-place form of [`delete_behavior_override`])
+    pub fn delete_behavior_override(&mut self, feature_code: &str, usage_type: &str) -> Result<()> {
+        // Lookup FTYPE_ID
+        let ftype_id = self.lookup_feature_id(feature_code)?;
+        let utype_upper = usage_type.to_uppercase();
+
+        let fbovr_array = self.section_mut("CFG_FBOVR")?;
+
+        let original_len = fbovr_array.len();
+        fbovr_array.retain(|item| {
+            !(item["FTYPE_ID"].as_i64() == Some(ftype_id)
+                && item["UTYPE_CODE"].as_str() == Some(&utype_upper))
+        });
+
+        if fbovr_array.len() == original_len {
+            return Err(SzConfigError::NotFound(format!(
+                "Behavior override not found for feature {} with usage type {}",
+                feature_code, utype_upper
+            )));
+        }
+
+        Ok(())
+    }
+
+    /// Get a specific behavior override (see [`get_behavior_override`])
+    pub fn get_behavior_override(&self, feature_code: &str, usage_type: &str) -> Result<Value> {
+        let ftype_id = self.lookup_feature_id(feature_code)?;
+        let utype_upper = usage_type.to_uppercase();
+
+        self.section("CFG_FBOVR")?
+            .iter()
+            .find(|item| {
+                item["FTYPE_ID"].as_i64() == Some(ftype_id)
+                    && item["UTYPE_CODE"].as_str() == Some(&utype_upper)
+            })
+            .cloned()
+            .ok_or_else(|| {
+                SzConfigError::NotFound(format!(
+                    "Behavior override not found for feature {} with usage type {}",
+                    feature_code, utype_upper
+                ))
+            })
+    }
+
+    /// List all behavior overrides (see [`list_behavior_overrides`])
+    pub fn list_behavior_overrides(&self) -> Result<Vec<Value>> {
+        let mut result: Vec<Value> = self.section("CFG_FBOVR")?.to_vec();
+
+        // Sort by FTYPE_ID
+        result.sort_by_key(|item| item["FTYPE_ID"].as_i64().unwrap_or(0));
+
+        Ok(result)
+    }
+}
+
 /// Add a behavior override for a feature based on usage type
 ///
 /// # Arguments
@@ -58,45 +149,7 @@ pub fn add_behavior_override(
     config_json: &str,
     params: AddBehaviorOverrideParams,
 ) -> Result<String> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Lookup FTYPE_ID from feature code
-    let ftype_id = helpers::lookup_feature_id(config_json, params.feature_code)?;
-
-    // Parse behavior code into frequency, exclusivity, stability
-    let (frequency, exclusivity, stability) = parse_behavior_code(params.behavior)?;
-
-    let utype_upper = params.usage_type.to_uppercase();
-
-    // Check for existing override for this feature+usage combination
-    let fbovr_array = config
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_FBOVR"))
-        .and_then(|v| v.as_array())
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FBOVR".to_string()))?;
-
-    if fbovr_array.iter().any(|item| {
-        item["FTYPE_ID"].as_i64() == Some(ftype_id)
-            && item["UTYPE_CODE"].as_str() == Some(&utype_upper)
-    }) {
-        return Err(SzConfigError::AlreadyExists(format!(
-            "Behavior override already exists for feature {} with usage type {}",
-            params.feature_code, utype_upper
-        )));
-    }
-
-    // Create override record
-    let override_record = json!({
-        "FTYPE_ID": ftype_id,
-        "UTYPE_CODE": utype_upper,
-        "FTYPE_FREQ": frequency,
-        "FTYPE_EXCL": exclusivity,
-        "FTYPE_STAB": stability
-    });
-
-    // Add to CFG_FBOVR
-    helpers::add_to_config_array(config_json, "CFG_FBOVR", override_record)
+    handle::edit(config_json, |config| config.add_behavior_override(params))
 }
 
 /// Delete a behavior override for a feature and usage type
@@ -116,33 +169,9 @@ pub fn delete_behavior_override(
     feature_code: &str,
     usage_type: &str,
 ) -> Result<String> {
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Lookup FTYPE_ID
-    let ftype_id = helpers::lookup_feature_id(config_json, feature_code)?;
-    let utype_upper = usage_type.to_uppercase();
-
-    let fbovr_array = config
-        .get_mut("G2_CONFIG")
-        .and_then(|g| g.get_mut("CFG_FBOVR"))
-        .and_then(|v| v.as_array_mut())
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FBOVR".to_string()))?;
-
-    let original_len = fbovr_array.len();
-    fbovr_array.retain(|item| {
-        !(item["FTYPE_ID"].as_i64() == Some(ftype_id)
-            && item["UTYPE_CODE"].as_str() == Some(&utype_upper))
-    });
-
-    if fbovr_array.len() == original_len {
-        return Err(SzConfigError::NotFound(format!(
-            "Behavior override not found for feature {} with usage type {}",
-            feature_code, utype_upper
-        )));
-    }
-
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config_json, |config| {
+        config.delete_behavior_override(feature_code, usage_type)
+    })
 }
 
 /// Get a specific behavior override
@@ -159,29 +188,9 @@ pub fn get_behavior_override(
     feature_code: &str,
     usage_type: &str,
 ) -> Result<Value> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let ftype_id = helpers::lookup_feature_id(config_json, feature_code)?;
-    let utype_upper = usage_type.to_uppercase();
-
-    config
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_FBOVR"))
-        .and_then(|v| v.as_array())
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FBOVR".to_string()))?
-        .iter()
-        .find(|item| {
-            item["FTYPE_ID"].as_i64() == Some(ftype_id)
-                && item["UTYPE_CODE"].as_str() == Some(&utype_upper)
-        })
-        .cloned()
-        .ok_or_else(|| {
-            SzConfigError::NotFound(format!(
-                "Behavior override not found for feature {} with usage type {}",
-                feature_code, utype_upper
-            ))
-        })
+    handle::read_sections(config_json, &["CFG_FTYPE", "CFG_FBOVR"], |config| {
+        config.get_behavior_override(feature_code, usage_type)
+    })
 }
 
 /// List all behavior overrides
@@ -192,21 +201,9 @@ pub fn get_behavior_override(
 /// # Returns
 /// Vector of JSON Values representing behavior overrides, sorted by FTYPE_ID
 pub fn list_behavior_overrides(config_json: &str) -> Result<Vec<Value>> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let fbovr_array = config
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_FBOVR"))
-        .and_then(|v| v.as_array())
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FBOVR".to_string()))?;
-
-    let mut result: Vec<Value> = fbovr_array.to_vec();
-
-    // Sort by FTYPE_ID
-    result.sort_by_key(|item| item["FTYPE_ID"].as_i64().unwrap_or(0));
-
-    Ok(result)
+    handle::read_sections(config_json, &["CFG_FBOVR"], |config| {
+        config.list_behavior_overrides()
+    })
 }
 
 /// Parse a behavior code string into (frequency, exclusivity, stability)
@@ -0,0 +1,435 @@
+//! Binary snapshots of a parsed configuration
+//!
+//! JSON stays the interchange format, but parsing it dominates the cost of
+//! loading a large configuration. [`ConfigHandle::save_snapshot`] writes the
+//! parsed document in a compact binary encoding that
+//! [`ConfigHandle::load_snapshot`] turns back into a handle without any text
+//! parsing: every string is length-prefixed (no escape processing), object
+//! keys are stored once in a key table, and integers are varints.
+//!
+//! The header records the configuration's compatibility version (see
+//! [`ConfigHandle::get_compatibility_version`]); pass the version a service
+//! expects to `load_snapshot` and a snapshot of other configurations is
+//! rejected, so the caller falls back to the JSON. [`compatibility_version`]
+//! reads it without decoding the document.
+//!
+//! # Format
+//!
+//! ```text
+//! "SZCFGBIN"  format: u16 LE  compat: 0 | 1 varint-len bytes
+//! value       (tag byte, then payload)
+//! keys        varint count, then varint-len bytes each
+//! u64 LE      offset of the key table
+//! ```
+//!
+//! Value tags: null, false, true, integer (zigzag varint), unsigned (varint,
+//! above `i64::MAX` only), float (f64 LE), string (varint-len bytes), array
+//! (varint count, values) and object (varint count, then key index and value
+//! per member).
+//!
+//! # Example
+//!
+//! ```
+//! use sz_configtool_lib::ConfigHandle;
+//!
+//! let json = r#"{"G2_CONFIG":{"CONFIG_BASE_VERSION":{"COMPATIBILITY_VERSION":
+//!     {"CONFIG_VERSION":"11"}},"CFG_DSRC":[{"DSRC_ID":1,"DSRC_CODE":"TEST"}]}}"#;
+//! let config = ConfigHandle::from_json(json)?;
+//!
+//! let bytes = config.to_snapshot_bytes();
+//! assert_eq!(
+//!     sz_configtool_lib::binary::compatibility_version(&bytes)?.as_deref(),
+//!     Some("11")
+//! );
+//! let loaded = ConfigHandle::from_snapshot_bytes(&bytes)?;
+//! assert_eq!(loaded.to_json()?, config.to_json()?);
+//! # Ok::<(), sz_configtool_lib::SzConfigError>(())
+//! ```
+
+use crate::error::{Result, SzConfigError};
+use crate::handle::ConfigHandle;
+use serde_json::{Map, Number, Value};
+use std::collections::HashMap;
+use std::path::Path;
+
+/// Version of the snapshot encoding written by this library
+pub const FORMAT_VERSION: u16 = 1;
+
+const MAGIC: &[u8; 8] = b"SZCFGBIN";
+
+/// Nesting limit when decoding (same as serde_json's recursion limit)
+const MAX_DEPTH: usize = 128;
+
+const NULL: u8 = 0;
+const FALSE: u8 = 1;
+const TRUE: u8 = 2;
+const INT: u8 = 3;
+const UINT: u8 = 4;
+const FLOAT: u8 = 5;
+const STRING: u8 = 6;
+const ARRAY: u8 = 7;
+const OBJECT: u8 = 8;
+
+impl ConfigHandle {
+    /// Encode the configuration as a binary snapshot (see [`crate::binary`])
+    pub fn to_snapshot_bytes(&self) -> Vec<u8> {
+        let mut out = Vec::new();
+        out.extend_from_slice(MAGIC);
+        out.extend_from_slice(&FORMAT_VERSION.to_le_bytes());
+        match self.get_compatibility_version() {
+            Ok(version) => {
+                out.push(1);
+                write_bytes(&mut out, version.as_bytes());
+            }
+            Err(_) => out.push(0),
+        }
+
+        let mut keys = Keys::default();
+        encode(self.as_value(), &mut out, &mut keys);
+
+        let key_table = out.len() as u64;
+        write_varint(&mut out, keys.names.len() as u64);
+        for name in &keys.names {
+            write_bytes(&mut out, name.as_bytes());
+        }
+        out.extend_from_slice(&key_table.to_le_bytes());
+        out
+    }
+
+    /// Decode a binary snapshot made by [`to_snapshot_bytes`](Self::to_snapshot_bytes)
+    ///
+    /// # Errors
+    /// - `InvalidConfig` if the bytes are not a snapshot of a supported format
+    ///   or are truncated
+    pub fn from_snapshot_bytes(bytes: &[u8]) -> Result<Self> {
+        let (mut reader, _) = header(bytes)?;
+
+        let tail = bytes.len().checked_sub(8).ok_or_else(truncated)?;
+        let key_table = u64::from_le_bytes(bytes[tail..].try_into().expect("8 bytes"));
+        let key_table = usize::try_from(key_table)
+            .ok()
+            .filter(|&offset| offset >= reader.pos && offset <= tail)
+            .ok_or_else(truncated)?;
+
+        let mut keys_reader = Reader {
+            bytes: &bytes[..tail],
+            pos: key_table,
+        };
+        let count = keys_reader.len()?;
+        let mut keys = Vec::with_capacity(count);
+        for _ in 0..count {
+            keys.push(keys_reader.str()?.to_string());
+        }
+        if keys_reader.pos != tail {
+            return Err(truncated());
+        }
+
+        reader.bytes = &bytes[..key_table];
+        let root = reader.value(&keys, 0)?;
+        if reader.pos != key_table {
+            return Err(truncated());
+        }
+        Ok(Self::from_value(root))
+    }
+
+    /// Write the configuration to a binary snapshot file
+    ///
+    /// # Errors
+    /// - `InvalidConfig` if the file cannot be written
+    pub fn save_snapshot<P: AsRef<Path>>(&self, path: P) -> Result<()> {
+        let path = path.as_ref();
+        std::fs::write(path, self.to_snapshot_bytes()).map_err(|e| {
+            SzConfigError::InvalidConfig(format!("Failed to write {}: {}", path.display(), e))
+        })
+    }
+
+    /// Load a binary snapshot file written by [`save_snapshot`](Self::save_snapshot)
+    ///
+    /// With `expected_compatibility`, a snapshot whose compatibility version
+    /// differs (or is missing) is rejected.
+    ///
+    /// # Errors
+    /// - `InvalidConfig` if the file cannot be read, is not a snapshot of a
+    ///   supported format, or has another compatibility version
+    pub fn load_snapshot<P: AsRef<Path>>(
+        path: P,
+        expected_compatibility: Option<&str>,
+    ) -> Result<Self> {
+        let path = path.as_ref();
+        let bytes = std::fs::read(path).map_err(|e| {
+            SzConfigError::InvalidConfig(format!("Failed to read {}: {}", path.display(), e))
+        })?;
+
+        if let Some(expected) = expected_compatibility {
+            let found = compatibility_version(&bytes)?;
+            if found.as_deref() != Some(expected) {
+                return Err(SzConfigError::InvalidConfig(format!(
+                    "Snapshot {} has compatibility version {}, expected {}",
+                    path.display(),
+                    found.as_deref().unwrap_or("(none)"),
+                    expected
+                )));
+            }
+        }
+        Self::from_snapshot_bytes(&bytes)
+    }
+}
+
+/// Compatibility version recorded in a snapshot's header
+///
+/// # Errors
+/// - `InvalidConfig` if the bytes are not a snapshot of a supported format
+pub fn compatibility_version(bytes: &[u8]) -> Result<Option<String>> {
+    header(bytes).map(|(_, version)| version.map(str::to_string))
+}
+
+/// Check the header; returns a reader positioned at the root value
+fn header(bytes: &[u8]) -> Result<(Reader<'_>, Option<&str>)> {
+    if bytes.len() < MAGIC.len() + 3 || &bytes[..MAGIC.len()] != MAGIC {
+        return Err(SzConfigError::InvalidConfig(
+            "Not a configuration snapshot".to_string(),
+        ));
+    }
+    let format = u16::from_le_bytes([bytes[8], bytes[9]]);
+    if format != FORMAT_VERSION {
+        return Err(SzConfigError::InvalidConfig(format!(
+            "Unsupported snapshot format version {} (expected {})",
+            format, FORMAT_VERSION
+        )));
+    }
+
+    let mut reader = Reader { bytes, pos: 10 };
+    let version = match reader.byte()? {
+        0 => None,
+        _ => Some(reader.str()?),
+    };
+    Ok((reader, version))
+}
+
+/// Object keys in order of first use
+#[derive(Default)]
+struct Keys<'a> {
+    names: Vec<&'a str>,
+    index: HashMap<&'a str, u64>,
+}
+
+fn encode<'a>(value: &'a Value, out: &mut Vec<u8>, keys: &mut Keys<'a>) {
+    match value {
+        Value::Null => out.push(NULL),
+        Value::Bool(false) => out.push(FALSE),
+        Value::Bool(true) => out.push(TRUE),
+        Value::Number(n) => {
+            if let Some(i) = n.as_i64() {
+                out.push(INT);
+                write_varint(out, ((i << 1) ^ (i >> 63)) as u64);
+            } else if let Some(u) = n.as_u64() {
+                out.push(UINT);
+                write_varint(out, u);
+            } else {
+                out.push(FLOAT);
+                out.extend_from_slice(&n.as_f64().unwrap_or_default().to_le_bytes());
+            }
+        }
+        Value::String(s) => {
+            out.push(STRING);
+            write_bytes(out, s.as_bytes());
+        }
+        Value::Array(items) => {
+            out.push(ARRAY);
+            write_varint(out, items.len() as u64);
+            for item in items {
+                encode(item, out, keys);
+            }
+        }
+        Value::Object(members) => {
+            out.push(OBJECT);
+            write_varint(out, members.len() as u64);
+            for (key, member) in members {
+                let next = keys.names.len() as u64;
+                let index = *keys.index.entry(key).or_insert_with(|| {
+                    keys.names.push(key);
+                    next
+                });
+                write_varint(out, index);
+                encode(member, out, keys);
+            }
+        }
+    }
+}
+
+fn write_varint(out: &mut Vec<u8>, mut n: u64) {
+    while n >= 0x80 {
+        out.push(n as u8 | 0x80);
+        n >>= 7;
+    }
+    out.push(n as u8);
+}
+
+fn write_bytes(out: &mut Vec<u8>, bytes: &[u8]) {
+    write_varint(out, bytes.len() as u64);
+    out.extend_from_slice(bytes);
+}
+
+fn truncated() -> SzConfigError {
+    SzConfigError::InvalidConfig("Snapshot is truncated or corrupt".to_string())
+}
+
+struct Reader<'a> {
+    bytes: &'a [u8],
+    pos: usize,
+}
+
+impl<'a> Reader<'a> {
+    fn byte(&mut self) -> Result<u8> {
+        let byte = *self.bytes.get(self.pos).ok_or_else(truncated)?;
+        self.pos += 1;
+        Ok(byte)
+    }
+
+    fn take(&mut self, len: usize) -> Result<&'a [u8]> {
+        let end = self
+            .pos
+            .checked_add(len)
+            .filter(|&end| end <= self.bytes.len())
+            .ok_or_else(truncated)?;
+        let bytes = &self.bytes[self.pos..end];
+        self.pos = end;
+        Ok(bytes)
+    }
+
+    fn varint(&mut self) -> Result<u64> {
+        let mut n = 0u64;
+        for shift in (0..64).step_by(7) {
+            let byte = self.byte()?;
+            n |= u64::from(byte & 0x7f) << shift;
+            if byte < 0x80 {
+                return Ok(n);
+            }
+        }
+        Err(truncated())
+    }
+
+    /// A count or length, bounded by the bytes left (each item takes one or more)
+    fn len(&mut self) -> Result<usize> {
+        usize::try_from(self.varint()?)
+            .ok()
+            .filter(|&len| len <= self.bytes.len() - self.pos)
+            .ok_or_else(truncated)
+    }
+
+    fn str(&mut self) -> Result<&'a str> {
+        let len = self.len()?;
+        std::str::from_utf8(self.take(len)?).map_err(|_| truncated())
+    }
+
+    fn value(&mut self, keys: &[String], depth: usize) -> Result<Value> {
+        if depth > MAX_DEPTH {
+            return Err(truncated());
+        }
+        Ok(match self.byte()? {
+            NULL => Value::Null,
+            FALSE => Value::Bool(false),
+            TRUE => Value::Bool(true),
+            INT => {
+                let n = self.varint()?;
+                Value::from(((n >> 1) as i64) ^ -((n & 1) as i64))
+            }
+            UINT => Value::from(self.varint()?),
+            FLOAT => {
+                let bytes = self.take(8)?.try_into().expect("8 bytes");
+                Number::from_f64(f64::from_le_bytes(bytes))
+                    .map(Value::Number)
+                    .ok_or_else(truncated)?
+            }
+            STRING => Value::String(self.str()?.to_string()),
+            ARRAY => {
+                let count = self.len()?;
+                let mut items = Vec::with_capacity(count);
+                for _ in 0..count {
+                    items.push(self.value(keys, depth + 1)?);
+                }
+                Value::Array(items)
+            }
+            OBJECT => {
+                let count = self.len()?;
+                let mut members = Map::with_capacity(count);
+                for _ in 0..count {
+                    let key = usize::try_from(self.varint()?)
+                        .ok()
+                        .and_then(|i| keys.get(i))
+                        .ok_or_else(truncated)?;
+                    let member = self.value(keys, depth + 1)?;
+                    members.insert(key.clone(), member);
+                }
+                Value::Object(members)
+            }
+            _ => return Err(truncated()),
+        })
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use serde_json::json;
+
+    #[test]
+    fn test_round_trip() {
+        let document = json!({
+            "G2_CONFIG": {
+                "CFG_FTYPE": [
+                    {"FTYPE_ID": 1, "FTYPE_CODE": "NAME", "DERIVATION": null},
+                    {"FTYPE_CODE": "ÄDDR\n\"x\"", "FTYPE_ID": -12345678901i64, "W": 0.25}
+                ],
+                "SYS_OOM": {"BIG": u64::MAX, "FLAGS": [true, false, [], {}]}
+            },
+            "OTHER": "top level"
+        });
+        let config = ConfigHandle::from_value(document.clone());
+        let bytes = config.to_snapshot_bytes();
+
+        let loaded = ConfigHandle::from_snapshot_bytes(&bytes).unwrap();
+        assert_eq!(loaded.as_value(), &document);
+        assert_eq!(loaded.to_json().unwrap(), config.to_json().unwrap());
+        assert_eq!(compatibility_version(&bytes).unwrap(), None);
+    }
+
+    #[test]
+    fn test_rejects_bad_input() {
+        let config = ConfigHandle::from_value(json!({"G2_CONFIG": {"CFG_DSRC": [{"A": 1}]}}));
+        let bytes = config.to_snapshot_bytes();
+
+        for bad in [
+            &b"{\"G2_CONFIG\":{}}"[..],
+            &bytes[..bytes.len() - 1],
+            &bytes[..12],
+        ] {
+            assert!(matches!(
+                ConfigHandle::from_snapshot_bytes(bad),
+                Err(SzConfigError::InvalidConfig(_))
+            ));
+        }
+
+        let mut newer = bytes.clone();
+        newer[8] = 99;
+        assert!(ConfigHandle::from_snapshot_bytes(&newer).is_err());
+    }
+
+    #[test]
+    fn test_file_compatibility_check() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("config.bin");
+        let config = ConfigHandle::from_value(json!({"G2_CONFIG": {"CONFIG_BASE_VERSION": {
+            "COMPATIBILITY_VERSION": {"CONFIG_VERSION": "11"}
+        }}}));
+        config.save_snapshot(&path).unwrap();
+
+        let loaded = ConfigHandle::load_snapshot(&path, Some("11")).unwrap();
+        assert_eq!(loaded.get_compatibility_version().unwrap(), "11");
+        assert!(ConfigHandle::load_snapshot(&path, None).is_ok());
+        assert!(matches!(
+            ConfigHandle::load_snapshot(&path, Some("10")),
+            Err(SzConfigError::InvalidConfig(_))
+        ));
+    }
+}
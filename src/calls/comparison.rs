@@ -4,9 +4,7 @@
 //! (comparison bill of materials) configuration sections.
 
 use crate::error::{Result, SzConfigError};
-use crate::helpers::{
-    find_in_config_array, get_next_id, lookup_cfunc_id, lookup_element_id, lookup_feature_id,
-};
+use crate::handle::{self, ConfigHandle};
 use serde_json::{Value, json};
 
 // ============================================================================
@@ -123,6 +121,238 @@ pub struct SetComparisonCallElementParams {
     pub updates: Value,
 }
 
+impl ConfigHandle {
+    /// Add a new comparison call with element list (in-place form of [`add_comparison_call`])
+    ///
+    /// Returns the new CFG_CFCALL record.
+    pub fn add_comparison_call(&mut self, params: AddComparisonCallParams) -> Result<Value> {
+        // Get next CFCALL_ID (seed at 1000 for user-created calls)
+        let cfcall_id = self.next_id("CFG_CFCALL", "CFCALL_ID", Some(1000))?;
+
+        // Lookup feature ID
+        let ftype_id = self.lookup_feature_id(&params.ftype_code)?;
+
+        // Check if comparison call already exists for this feature (only one allowed per feature)
+        let call_exists = self
+            .section("CFG_CFCALL")
+            .map(|arr| {
+                arr.iter()
+                    .any(|call| call["FTYPE_ID"].as_i64() == Some(ftype_id))
+            })
+            .unwrap_or(false);
+
+        if call_exists {
+            return Err(SzConfigError::AlreadyExists(format!(
+                "Comparison call for feature {} already set",
+                params.ftype_code
+            )));
+        }
+
+        // Lookup function ID
+        let cfunc_id = self.lookup_cfunc_id(&params.cfunc_code)?;
+
+        // Process element list and create CFBOM records
+        let mut cfbom_records = Vec::new();
+        let mut exec_order = 0;
+
+        for element_code in &params.element_list {
+            exec_order += 1;
+
+            // Lookup element ID (must belong to the feature)
+            let bom_felem_id = self
+                .section("CFG_FBOM")
+                .ok()
+                .and_then(|arr| {
+                    arr.iter()
+                        .find(|fbom| {
+                            fbom["FTYPE_ID"].as_i64() == Some(ftype_id)
+                                && fbom["FELEM_CODE"]
+                                    .as_str()
+                                    .map(|s| s.eq_ignore_ascii_case(element_code))
+                                    .unwrap_or(false)
+                        })
+                        .and_then(|fbom| fbom["FELEM_ID"].as_i64())
+                })
+                .or_else(|| {
+                    // Fallback: lookup element globally
+                    self.lookup_element_id(element_code).ok()
+                })
+                .ok_or_else(|| {
+                    SzConfigError::NotFound(format!(
+                        "Element '{}' not found in feature '{}'",
+                        element_code, params.ftype_code
+                    ))
+                })?;
+
+            // Create CFBOM record
+            cfbom_records.push(json!({
+                "CFCALL_ID": cfcall_id,
+                "FTYPE_ID": ftype_id,
+                "FELEM_ID": bom_felem_id,
+                "EXEC_ORDER": exec_order
+            }));
+        }
+
+        // Create new CFG_CFCALL record
+        let new_record = json!({
+            "CFCALL_ID": cfcall_id,
+            "FTYPE_ID": ftype_id,
+            "CFUNC_ID": cfunc_id
+        });
+
+        // Both sections must exist before either is modified
+        self.section("CFG_CFCALL")?;
+        self.section("CFG_CFBOM")?;
+
+        self.section_mut("CFG_CFCALL")?.push(new_record.clone());
+        self.section_mut("CFG_CFBOM")?.extend(cfbom_records);
+
+        Ok(new_record)
+    }
+
+    /// Delete a comparison call and its CFBOM records (in-place form of [`delete_comparison_call`])
+    pub fn delete_comparison_call(&mut self, cfcall_id: i64) -> Result<()> {
+        // Validate that the call exists
+        let call_exists = self
+            .section("CFG_CFCALL")
+            .map(|arr| {
+                arr.iter()
+                    .any(|call| call["CFCALL_ID"].as_i64() == Some(cfcall_id))
+            })
+            .unwrap_or(false);
+
+        if !call_exists {
+            return Err(SzConfigError::NotFound(format!(
+                "Comparison call ID {}",
+                cfcall_id
+            )));
+        }
+
+        // Delete the comparison call and associated CFBOM records
+        for section in ["CFG_CFCALL", "CFG_CFBOM"] {
+            if let Ok(array) = self.section_mut(section) {
+                array.retain(|record| record["CFCALL_ID"].as_i64() != Some(cfcall_id));
+            }
+        }
+
+        Ok(())
+    }
+
+    /// Get a single comparison call by ID (see [`get_comparison_call`])
+    pub fn get_comparison_call(&self, cfcall_id: i64) -> Result<Value> {
+        self.find_in_config_array("CFG_CFCALL", "CFCALL_ID", &cfcall_id.to_string())
+            .cloned()
+            .ok_or_else(|| SzConfigError::NotFound(format!("Comparison call ID {}", cfcall_id)))
+    }
+
+    /// List all comparison calls with resolved names (see [`list_comparison_calls`])
+    pub fn list_comparison_calls(&self) -> Vec<Value> {
+        let empty_array = vec![];
+        let cfcall_array = self.section("CFG_CFCALL").unwrap_or(&empty_array);
+        let ftype_array = self.section("CFG_FTYPE").unwrap_or(&empty_array);
+        let cfunc_array = self.section("CFG_CFUNC").unwrap_or(&empty_array);
+
+        // Helper functions for ID resolution
+        let resolve_ftype = |ftype_id: i64| -> String {
+            ftype_array
+                .iter()
+                .find(|ft| ft.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(ftype_id))
+                .and_then(|ft| ft.get("FTYPE_CODE"))
+                .and_then(|v| v.as_str())
+                .unwrap_or("unknown")
+                .to_string()
+        };
+
+        let resolve_cfunc = |cfunc_id: i64| -> String {
+            cfunc_array
+                .iter()
+                .find(|df| df.get("CFUNC_ID").and_then(|v| v.as_i64()) == Some(cfunc_id))
+                .and_then(|df| df.get("CFUNC_CODE"))
+                .and_then(|v| v.as_str())
+                .unwrap_or("unknown")
+                .to_string()
+        };
+
+        // Transform comparison calls
+        cfcall_array
+            .iter()
+            .map(|item| {
+                let ftype_id = item.get("FTYPE_ID").and_then(|v| v.as_i64()).unwrap_or(0);
+                let cfunc_id = item.get("CFUNC_ID").and_then(|v| v.as_i64()).unwrap_or(0);
+
+                json!({
+                    "id": item.get("CFCALL_ID").and_then(|v| v.as_i64()).unwrap_or(0),
+                    "feature": resolve_ftype(ftype_id),
+                    "function": resolve_cfunc(cfunc_id)
+                })
+            })
+            .collect()
+    }
+
+    /// Add a comparison call element (in-place form of [`add_comparison_call_element`])
+    ///
+    /// Returns the new CFBOM record.
+    pub fn add_comparison_call_element(
+        &mut self,
+        params: AddComparisonCallElementParams,
+    ) -> Result<Value> {
+        let cfbom_array = self.section_mut("CFG_CFBOM")?;
+
+        // Check if element already exists
+        if cfbom_array.iter().any(|item| {
+            item.get("CFCALL_ID").and_then(|v| v.as_i64()) == Some(params.cfcall_id)
+                && item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(params.ftype_id)
+                && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(params.felem_id)
+                && item.get("EXEC_ORDER").and_then(|v| v.as_i64()) == Some(params.exec_order)
+        }) {
+            return Err(SzConfigError::AlreadyExists(
+                "Comparison call element already exists".to_string(),
+            ));
+        }
+
+        // Create new CFBOM record
+        let new_record = json!({
+            "CFCALL_ID": params.cfcall_id,
+            "FTYPE_ID": params.ftype_id,
+            "FELEM_ID": params.felem_id,
+            "EXEC_ORDER": params.exec_order
+        });
+
+        cfbom_array.push(new_record.clone());
+
+        Ok(new_record)
+    }
+
+    /// Delete a comparison call element (in-place form of [`delete_comparison_call_element`])
+    pub fn delete_comparison_call_element(
+        &mut self,
+        cfcall_id: i64,
+        params: DeleteComparisonCallElementParams,
+    ) -> Result<()> {
+        let matches = |item: &Value| {
+            item.get("CFCALL_ID").and_then(|v| v.as_i64()) == Some(cfcall_id)
+                && item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(params.ftype_id)
+                && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(params.felem_id)
+                && item.get("EXEC_ORDER").and_then(|v| v.as_i64()) == Some(params.exec_order)
+        };
+
+        // Validate that the element exists
+        let cfbom_array = match self.section_mut("CFG_CFBOM") {
+            Ok(array) if array.iter().any(matches) => array,
+            _ => {
+                return Err(SzConfigError::NotFound(
+                    "Comparison call element not found".to_string(),
+                ));
+            }
+        };
+
+        // Delete the element
+        cfbom_array.retain(|item| !matches(item));
+
+        Ok(())
+    }
+}
+
 /// Add a new comparison call with element list
 ///
 /// Creates a new comparison call linking a function to a feature
@@ -143,99 +373,7 @@ pub fn add_comparison_call(
     config: &str,
     params: AddComparisonCallParams,
 ) -> Result<(String, Value)> {
-    let mut config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Get next CFCALL_ID (seed at 1000 for user-created calls)
-    let cfcall_id = get_next_id(&config_data, "G2_CONFIG.CFG_CFCALL", "CFCALL_ID", 1000)?;
-
-    // Lookup feature ID
-    let ftype_id = lookup_feature_id(config, &params.ftype_code)?;
-
-    // Check if comparison call already exists for this feature (only one allowed per feature)
-    let call_exists = config_data["G2_CONFIG"]["CFG_CFCALL"]
-        .as_array()
-        .map(|arr| {
-            arr.iter()
-                .any(|call| call["FTYPE_ID"].as_i64() == Some(ftype_id))
-        })
-        .unwrap_or(false);
-
-    if call_exists {
-        return Err(SzConfigError::AlreadyExists(format!(
-            "Comparison call for feature {} already set",
-            params.ftype_code
-        )));
-    }
-
-    // Lookup function ID
-    let cfunc_id = lookup_cfunc_id(config, &params.cfunc_code)?;
-
-    // Process element list and create CFBOM records
-    let mut cfbom_records = Vec::new();
-    let mut exec_order = 0;
-
-    for element_code in params.element_list {
-        exec_order += 1;
-
-        // Lookup element ID (must belong to the feature)
-        let bom_felem_id = config_data["G2_CONFIG"]["CFG_FBOM"]
-            .as_array()
-            .and_then(|arr| {
-                arr.iter()
-                    .find(|fbom| {
-                        fbom["FTYPE_ID"].as_i64() == Some(ftype_id)
-                            && fbom["FELEM_CODE"]
-                                .as_str()
-                                .map(|s| s.eq_ignore_ascii_case(&element_code))
-                                .unwrap_or(false)
-                    })
-                    .and_then(|fbom| fbom["FELEM_ID"].as_i64())
-            })
-            .or_else(|| {
-                // Fallback: lookup element globally
-                lookup_element_id(config, &element_code).ok()
-            })
-            .ok_or_else(|| {
-                SzConfigError::NotFound(format!(
-                    "Element '{}' not found in feature '{}'",
-                    element_code, params.ftype_code
-                ))
-            })?;
-
-        // Create CFBOM record
-        cfbom_records.push(json!({
-            "CFCALL_ID": cfcall_id,
-            "FTYPE_ID": ftype_id,
-            "FELEM_ID": bom_felem_id,
-            "EXEC_ORDER": exec_order
-        }));
-    }
-
-    // Create new CFG_CFCALL record
-    let new_record = json!({
-        "CFCALL_ID": cfcall_id,
-        "FTYPE_ID": ftype_id,
-        "CFUNC_ID": cfunc_id
-    });
-
-    // Add to config
-    if let Some(cfcall_array) = config_data["G2_CONFIG"]["CFG_CFCALL"].as_array_mut() {
-        cfcall_array.push(new_record.clone());
-    } else {
-        return Err(SzConfigError::MissingSection("CFG_CFCALL".to_string()));
-    }
-
-    if let Some(cfbom_array) = config_data["G2_CONFIG"]["CFG_CFBOM"].as_array_mut() {
-        cfbom_array.extend(cfbom_records);
-    } else {
-        return Err(SzConfigError::MissingSection("CFG_CFBOM".to_string()));
-    }
-
-    let modified_config =
-        serde_json::to_string(&config_data).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    Ok((modified_config, new_record))
+    handle::edit_returning(config, |config| config.add_comparison_call(params))
 }
 
 /// Delete a comparison call by ID
@@ -252,36 +390,7 @@ pub fn add_comparison_call(
 /// # Errors
 /// - `NotFound` if call ID doesn't exist
 pub fn delete_comparison_call(config: &str, cfcall_id: i64) -> Result<String> {
-    let mut config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Validate that the call exists
-    let call_exists = config_data["G2_CONFIG"]["CFG_CFCALL"]
-        .as_array()
-        .map(|arr| {
-            arr.iter()
-                .any(|call| call["CFCALL_ID"].as_i64() == Some(cfcall_id))
-        })
-        .unwrap_or(false);
-
-    if !call_exists {
-        return Err(SzConfigError::NotFound(format!(
-            "Comparison call ID {}",
-            cfcall_id
-        )));
-    }
-
-    // Delete the comparison call
-    if let Some(cfcall_array) = config_data["G2_CONFIG"]["CFG_CFCALL"].as_array_mut() {
-        cfcall_array.retain(|record| record["CFCALL_ID"].as_i64() != Some(cfcall_id));
-    }
-
-    // Delete associated CFBOM records
-    if let Some(cfbom_array) = config_data["G2_CONFIG"]["CFG_CFBOM"].as_array_mut() {
-        cfbom_array.retain(|record| record["CFCALL_ID"].as_i64() != Some(cfcall_id));
-    }
-
-    serde_json::to_string(&config_data).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config, |config| config.delete_comparison_call(cfcall_id))
 }
 
 /// Get a single comparison call by ID
@@ -296,8 +405,7 @@ pub fn delete_comparison_call(config: &str, cfcall_id: i64) -> Result<String> {
 /// # Errors
 /// - `NotFound` if call ID doesn't exist
 pub fn get_comparison_call(config: &str, cfcall_id: i64) -> Result<Value> {
-    find_in_config_array(config, "CFG_CFCALL", "CFCALL_ID", &cfcall_id.to_string())?
-        .ok_or_else(|| SzConfigError::NotFound(format!("Comparison call ID {}", cfcall_id)))
+    handle::read(config, |config| config.get_comparison_call(cfcall_id))
 }
 
 /// List all comparison calls with resolved names
@@ -310,65 +418,7 @@ pub fn get_comparison_call(config: &str, cfcall_id: i64) -> Result<Value> {
 /// # Returns
 /// Vector of JSON Values with resolved names
 pub fn list_comparison_calls(config: &str) -> Result<Vec<Value>> {
-    let config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let empty_array = vec![];
-    let cfcall_array = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_CFCALL"))
-        .and_then(|v| v.as_array())
-        .unwrap_or(&empty_array);
-
-    let ftype_array = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_FTYPE"))
-        .and_then(|v| v.as_array())
-        .unwrap_or(&empty_array);
-
-    let cfunc_array = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_CFUNC"))
-        .and_then(|v| v.as_array())
-        .unwrap_or(&empty_array);
-
-    // Helper functions for ID resolution
-    let resolve_ftype = |ftype_id: i64| -> String {
-        ftype_array
-            .iter()
-            .find(|ft| ft.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(ftype_id))
-            .and_then(|ft| ft.get("FTYPE_CODE"))
-            .and_then(|v| v.as_str())
-            .unwrap_or("unknown")
-            .to_string()
-    };
-
-    let resolve_cfunc = |cfunc_id: i64| -> String {
-        cfunc_array
-            .iter()
-            .find(|cf| cf.get("CFUNC_ID").and_then(|v| v.as_i64()) == Some(cfunc_id))
-            .and_then(|cf| cf.get("CFUNC_CODE"))
-            .and_then(|v| v.as_str())
-            .unwrap_or("unknown")
-            .to_string()
-    };
-
-    // Transform comparison calls
-    let items: Vec<Value> = cfcall_array
-        .iter()
-        .map(|item| {
-            let ftype_id = item.get("FTYPE_ID").and_then(|v| v.as_i64()).unwrap_or(0);
-            let cfunc_id = item.get("CFUNC_ID").and_then(|v| v.as_i64()).unwrap_or(0);
-
-            json!({
-                "id": item.get("CFCALL_ID").and_then(|v| v.as_i64()).unwrap_or(0),
-                "feature": resolve_ftype(ftype_id),
-                "function": resolve_cfunc(cfunc_id)
-            })
-        })
-        .collect();
-
-    Ok(items)
+    handle::read(config, |config| Ok(config.list_comparison_calls()))
 }
 
 /// Update a comparison call (stub - not implemented in Python)
@@ -398,47 +448,7 @@ pub fn add_comparison_call_element(
     config: &str,
     params: AddComparisonCallElementParams,
 ) -> Result<(String, Value)> {
-    let mut config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Check if element already exists
-    if let Some(cbom_array) = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_CFBOM"))
-        .and_then(|v| v.as_array())
-    {
-        for item in cbom_array {
-            if item.get("CFCALL_ID").and_then(|v| v.as_i64()) == Some(params.cfcall_id)
-                && item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(params.ftype_id)
-                && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(params.felem_id)
-                && item.get("EXEC_ORDER").and_then(|v| v.as_i64()) == Some(params.exec_order)
-            {
-                return Err(SzConfigError::AlreadyExists(
-                    "Comparison call element already exists".to_string(),
-                ));
-            }
-        }
-    }
-
-    // Create new CBOM record
-    let new_record = json!({
-        "CFCALL_ID": params.cfcall_id,
-        "FTYPE_ID": params.ftype_id,
-        "FELEM_ID": params.felem_id,
-        "EXEC_ORDER": params.exec_order
-    });
-
-    // Add to CFG_CFBOM
-    if let Some(cbom_array) = config_data["G2_CONFIG"]["CFG_CFBOM"].as_array_mut() {
-        cbom_array.push(new_record.clone());
-    } else {
-        return Err(SzConfigError::MissingSection("CFG_CFBOM".to_string()));
-    }
-
-    let modified_config =
-        serde_json::to_string(&config_data).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    Ok((modified_config, new_record))
+    handle::edit_returning(config, |config| config.add_comparison_call_element(params))
 }
 
 /// Delete a comparison call element
@@ -455,39 +465,9 @@ pub fn delete_comparison_call_element(
     cfcall_id: i64,
     params: DeleteComparisonCallElementParams,
 ) -> Result<String> {
-    let mut config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Validate that the element exists
-    let element_exists = config_data["G2_CONFIG"]["CFG_CFBOM"]
-        .as_array()
-        .map(|arr| {
-            arr.iter().any(|item| {
-                item.get("CFCALL_ID").and_then(|v| v.as_i64()) == Some(cfcall_id)
-                    && item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(params.ftype_id)
-                    && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(params.felem_id)
-                    && item.get("EXEC_ORDER").and_then(|v| v.as_i64()) == Some(params.exec_order)
-            })
-        })
-        .unwrap_or(false);
-
-    if !element_exists {
-        return Err(SzConfigError::NotFound(
-            "Comparison call element not found".to_string(),
-        ));
-    }
-
-    // Delete the element
-    if let Some(cbom_array) = config_data["G2_CONFIG"]["CFG_CFBOM"].as_array_mut() {
-        cbom_array.retain(|item| {
-            !(item.get("CFCALL_ID").and_then(|v| v.as_i64()) == Some(cfcall_id)
-                && item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(params.ftype_id)
-                && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(params.felem_id)
-                && item.get("EXEC_ORDER").and_then(|v| v.as_i64()) == Some(params.exec_order))
-        });
-    }
-
-    serde_json::to_string(&config_data).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config, |config| {
+        config.delete_comparison_call_element(cfcall_id, params)
+    })
 }
 
 /// Update a comparison call element (stub - not typically used)
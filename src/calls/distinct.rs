@@ -4,9 +4,7 @@
 //! (distinct bill of materials) configuration sections.
 
 use crate::error::{Result, SzConfigError};
-use crate::helpers::{
-    find_in_config_array, get_next_id, lookup_dfunc_id, lookup_element_id, lookup_feature_id,
-};
+use crate::handle::{self, ConfigHandle};
 use serde_json::{Value, json};
 
 // ============================================================================
@@ -100,117 +98,257 @@ pub struct SetDistinctCallElementParams {
     pub updates: Value,
 }
 
-/// Add a new distinct call with element list
-///
-/// Creates a new distinct call linking a function to a feature
-/// with associated elements (DBOM records).
-/// Note: Only one distinct call is allowed per feature.
-///
-/// # Arguments
-/// * `config` - Configuration JSON string
-/// * `params` - Distinct call parameters (ftype_code, dfunc_code, element_list required)
-///
-/// # Returns
-/// Tuple of (modified_config, new_dfcall_record)
-///
-/// # Errors
-/// - `Duplicate` if a distinct call already exists for this feature
-/// - `NotFound` if function/feature/element codes don't exist
-pub fn add_distinct_call(config: &str, params: AddDistinctCallParams) -> Result<(String, Value)> {
-    let mut config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
+impl ConfigHandle {
+    /// Add a new distinct call with element list (in-place form of [`add_distinct_call`])
+    ///
+    /// Returns the new CFG_DFCALL record.
+    pub fn add_distinct_call(&mut self, params: AddDistinctCallParams) -> Result<Value> {
+        // Get next DFCALL_ID (seed at 1000 for user-created calls)
+        let dfcall_id = self.next_id("CFG_DFCALL", "DFCALL_ID", Some(1000))?;
+
+        // Lookup feature ID
+        let ftype_id = self.lookup_feature_id(&params.ftype_code)?;
+
+        // Check if distinct call already exists for this feature (only one allowed per feature)
+        let call_exists = self
+            .section("CFG_DFCALL")
+            .map(|arr| {
+                arr.iter()
+                    .any(|call| call["FTYPE_ID"].as_i64() == Some(ftype_id))
+            })
+            .unwrap_or(false);
 
-    // Get next DFCALL_ID (seed at 1000 for user-created calls)
-    let dfcall_id = get_next_id(&config_data, "G2_CONFIG.CFG_DFCALL", "DFCALL_ID", 1000)?;
+        if call_exists {
+            return Err(SzConfigError::AlreadyExists(format!(
+                "Distinct call for feature {} already set",
+                params.ftype_code
+            )));
+        }
 
-    // Lookup feature ID
-    let ftype_id = lookup_feature_id(config, &params.ftype_code)?;
+        // Lookup function ID
+        let dfunc_id = self.lookup_dfunc_id(&params.dfunc_code)?;
 
-    // Check if distinct call already exists for this feature (only one allowed per feature)
-    let call_exists = config_data["G2_CONFIG"]["CFG_DFCALL"]
-        .as_array()
-        .map(|arr| {
-            arr.iter()
-                .any(|call| call["FTYPE_ID"].as_i64() == Some(ftype_id))
-        })
-        .unwrap_or(false);
+        // Process element list and create DFBOM records
+        let mut dfbom_records = Vec::new();
+        let mut exec_order = 0;
 
-    if call_exists {
-        return Err(SzConfigError::AlreadyExists(format!(
-            "Distinct call for feature {} already set",
-            params.ftype_code
-        )));
-    }
+        for element_code in &params.element_list {
+            exec_order += 1;
 
-    // Lookup function ID
-    let dfunc_id = lookup_dfunc_id(config, &params.dfunc_code)?;
+            // Lookup element ID (must belong to the feature)
+            let bom_felem_id = self
+                .section("CFG_FBOM")
+                .ok()
+                .and_then(|arr| {
+                    arr.iter()
+                        .find(|fbom| {
+                            fbom["FTYPE_ID"].as_i64() == Some(ftype_id)
+                                && fbom["FELEM_CODE"]
+                                    .as_str()
+                                    .map(|s| s.eq_ignore_ascii_case(element_code))
+                                    .unwrap_or(false)
+                        })
+                        .and_then(|fbom| fbom["FELEM_ID"].as_i64())
+                })
+                .or_else(|| {
+                    // Fallback: lookup element globally
+                    self.lookup_element_id(element_code).ok()
+                })
+                .ok_or_else(|| {
+                    SzConfigError::NotFound(format!(
+                        "Element '{}' not found in feature '{}'",
+                        element_code, params.ftype_code
+                    ))
+                })?;
+
+            // Create DFBOM record
+            dfbom_records.push(json!({
+                "DFCALL_ID": dfcall_id,
+                "FTYPE_ID": ftype_id,
+                "FELEM_ID": bom_felem_id,
+                "EXEC_ORDER": exec_order
+            }));
+        }
+
+        // Create new CFG_DFCALL record (EXEC_ORDER is always 1 for distinct calls)
+        let new_record = json!({
+            "DFCALL_ID": dfcall_id,
+            "FTYPE_ID": ftype_id,
+            "DFUNC_ID": dfunc_id,
+            "EXEC_ORDER": 1
+        });
 
-    // Process element list and create DFBOM records
-    let mut dfbom_records = Vec::new();
-    let mut exec_order = 0;
+        // Both sections must exist before either is modified
+        self.section("CFG_DFCALL")?;
+        self.section("CFG_DFBOM")?;
 
-    for element_code in params.element_list {
-        exec_order += 1;
+        self.section_mut("CFG_DFCALL")?.push(new_record.clone());
+        self.section_mut("CFG_DFBOM")?.extend(dfbom_records);
 
-        // Lookup element ID (must belong to the feature)
-        let bom_felem_id = config_data["G2_CONFIG"]["CFG_FBOM"]
-            .as_array()
-            .and_then(|arr| {
+        Ok(new_record)
+    }
+
+    /// Delete a distinct call and its DFBOM records (in-place form of [`delete_distinct_call`])
+    pub fn delete_distinct_call(&mut self, dfcall_id: i64) -> Result<()> {
+        // Validate that the call exists
+        let call_exists = self
+            .section("CFG_DFCALL")
+            .map(|arr| {
                 arr.iter()
-                    .find(|fbom| {
-                        fbom["FTYPE_ID"].as_i64() == Some(ftype_id)
-                            && fbom["FELEM_CODE"]
-                                .as_str()
-                                .map(|s| s.eq_ignore_ascii_case(&element_code))
-                                .unwrap_or(false)
-                    })
-                    .and_then(|fbom| fbom["FELEM_ID"].as_i64())
+                    .any(|call| call["DFCALL_ID"].as_i64() == Some(dfcall_id))
             })
-            .or_else(|| {
-                // Fallback: lookup element globally
-                lookup_element_id(config, &element_code).ok()
-            })
-            .ok_or_else(|| {
-                SzConfigError::NotFound(format!(
-                    "Element '{}' not found in feature '{}'",
-                    element_code, params.ftype_code
-                ))
-            })?;
-
-        // Create DFBOM record
-        dfbom_records.push(json!({
-            "DFCALL_ID": dfcall_id,
-            "FTYPE_ID": ftype_id,
-            "FELEM_ID": bom_felem_id,
-            "EXEC_ORDER": exec_order
-        }));
+            .unwrap_or(false);
+
+        if !call_exists {
+            return Err(SzConfigError::NotFound(format!(
+                "Distinct call ID {}",
+                dfcall_id
+            )));
+        }
+
+        // Delete the distinct call and associated DFBOM records
+        for section in ["CFG_DFCALL", "CFG_DFBOM"] {
+            if let Ok(array) = self.section_mut(section) {
+                array.retain(|record| record["DFCALL_ID"].as_i64() != Some(dfcall_id));
+            }
+        }
+
+        Ok(())
     }
 
-    // Create new CFG_DFCALL record (EXEC_ORDER is always 1 for distinct calls)
-    let new_record = json!({
-        "DFCALL_ID": dfcall_id,
-        "FTYPE_ID": ftype_id,
-        "DFUNC_ID": dfunc_id,
-        "EXEC_ORDER": 1
-    });
-
-    // Add to config
-    if let Some(dfcall_array) = config_data["G2_CONFIG"]["CFG_DFCALL"].as_array_mut() {
-        dfcall_array.push(new_record.clone());
-    } else {
-        return Err(SzConfigError::MissingSection("CFG_DFCALL".to_string()));
+    /// Get a single distinct call by ID (see [`get_distinct_call`])
+    pub fn get_distinct_call(&self, dfcall_id: i64) -> Result<Value> {
+        self.find_in_config_array("CFG_DFCALL", "DFCALL_ID", &dfcall_id.to_string())
+            .cloned()
+            .ok_or_else(|| SzConfigError::NotFound(format!("Distinct call ID {}", dfcall_id)))
     }
 
-    if let Some(dfbom_array) = config_data["G2_CONFIG"]["CFG_DFBOM"].as_array_mut() {
-        dfbom_array.extend(dfbom_records);
-    } else {
-        return Err(SzConfigError::MissingSection("CFG_DFBOM".to_string()));
+    /// List all distinct calls with resolved names (see [`list_distinct_calls`])
+    pub fn list_distinct_calls(&self) -> Vec<Value> {
+        let empty_array = vec![];
+        let dfcall_array = self.section("CFG_DFCALL").unwrap_or(&empty_array);
+        let ftype_array = self.section("CFG_FTYPE").unwrap_or(&empty_array);
+        let dfunc_array = self.section("CFG_DFUNC").unwrap_or(&empty_array);
+
+        // Helper functions for ID resolution
+        let resolve_ftype = |ftype_id: i64| -> String {
+            ftype_array
+                .iter()
+                .find(|ft| ft.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(ftype_id))
+                .and_then(|ft| ft.get("FTYPE_CODE"))
+                .and_then(|v| v.as_str())
+                .unwrap_or("unknown")
+                .to_string()
+        };
+
+        let resolve_dfunc = |dfunc_id: i64| -> String {
+            dfunc_array
+                .iter()
+                .find(|df| df.get("DFUNC_ID").and_then(|v| v.as_i64()) == Some(dfunc_id))
+                .and_then(|df| df.get("DFUNC_CODE"))
+                .and_then(|v| v.as_str())
+                .unwrap_or("unknown")
+                .to_string()
+        };
+
+        // Transform distinct calls
+        dfcall_array
+            .iter()
+            .map(|item| {
+                let ftype_id = item.get("FTYPE_ID").and_then(|v| v.as_i64()).unwrap_or(0);
+                let dfunc_id = item.get("DFUNC_ID").and_then(|v| v.as_i64()).unwrap_or(0);
+
+                json!({
+                    "id": item.get("DFCALL_ID").and_then(|v| v.as_i64()).unwrap_or(0),
+                    "feature": resolve_ftype(ftype_id),
+                    "function": resolve_dfunc(dfunc_id),
+                    "execOrder": item.get("EXEC_ORDER").and_then(|v| v.as_i64()).unwrap_or(1)
+                })
+            })
+            .collect()
     }
 
-    let modified_config =
-        serde_json::to_string(&config_data).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
+    /// Add a distinct call element (in-place form of [`add_distinct_call_element`])
+    ///
+    /// Returns the new DFBOM record.
+    pub fn add_distinct_call_element(
+        &mut self,
+        params: AddDistinctCallElementParams,
+    ) -> Result<Value> {
+        let dfbom_array = self.section_mut("CFG_DFBOM")?;
+
+        // Check if element already exists
+        if dfbom_array.iter().any(|item| {
+            item.get("DFCALL_ID").and_then(|v| v.as_i64()) == Some(params.dfcall_id)
+                && item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(params.ftype_id)
+                && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(params.felem_id)
+                && item.get("EXEC_ORDER").and_then(|v| v.as_i64()) == Some(params.exec_order)
+        }) {
+            return Err(SzConfigError::AlreadyExists(
+                "Distinct call element already exists".to_string(),
+            ));
+        }
+
+        // Create new DFBOM record
+        let new_record = json!({
+            "DFCALL_ID": params.dfcall_id,
+            "FTYPE_ID": params.ftype_id,
+            "FELEM_ID": params.felem_id,
+            "EXEC_ORDER": params.exec_order
+        });
+
+        dfbom_array.push(new_record.clone());
+
+        Ok(new_record)
+    }
 
-    Ok((modified_config, new_record))
+    /// Delete a distinct call element (in-place form of [`delete_distinct_call_element`])
+    pub fn delete_distinct_call_element(
+        &mut self,
+        params: DeleteDistinctCallElementParams,
+    ) -> Result<()> {
+        let matches = |item: &Value| {
+            item.get("DFCALL_ID").and_then(|v| v.as_i64()) == Some(params.dfcall_id)
+                && item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(params.ftype_id)
+                && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(params.felem_id)
+                && item.get("EXEC_ORDER").and_then(|v| v.as_i64()) == Some(params.exec_order)
+        };
+
+        // Validate that the element exists
+        let dfbom_array = match self.section_mut("CFG_DFBOM") {
+            Ok(array) if array.iter().any(matches) => array,
+            _ => {
+                return Err(SzConfigError::NotFound(
+                    "Distinct call element not found".to_string(),
+                ));
+            }
+        };
+
+        // Delete the element
+        dfbom_array.retain(|item| !matches(item));
+
+        Ok(())
+    }
+}
+
+/// Add a new distinct call with element list
+///
+/// Creates a new distinct call linking a function to a feature
+/// with associated elements (DBOM records).
+/// Note: Only one distinct call is allowed per feature.
+///
+/// # Arguments
+/// * `config` - Configuration JSON string
+/// * `params` - Distinct call parameters (ftype_code, dfunc_code, element_list required)
+///
+/// # Returns
+/// Tuple of (modified_config, new_dfcall_record)
+///
+/// # Errors
+/// - `Duplicate` if a distinct call already exists for this feature
+/// - `NotFound` if function/feature/element codes don't exist
+pub fn add_distinct_call(config: &str, params: AddDistinctCallParams) -> Result<(String, Value)> {
+    handle::edit_returning(config, |config| config.add_distinct_call(params))
 }
 
 /// Delete a distinct call by ID
@@ -227,36 +365,7 @@ pub fn add_distinct_call(config: &str, params: AddDistinctCallParams) -> Result<
 /// # Errors
 /// - `NotFound` if call ID doesn't exist
 pub fn delete_distinct_call(config: &str, dfcall_id: i64) -> Result<String> {
-    let mut config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Validate that the call exists
-    let call_exists = config_data["G2_CONFIG"]["CFG_DFCALL"]
-        .as_array()
-        .map(|arr| {
-            arr.iter()
-                .any(|call| call["DFCALL_ID"].as_i64() == Some(dfcall_id))
-        })
-        .unwrap_or(false);
-
-    if !call_exists {
-        return Err(SzConfigError::NotFound(format!(
-            "Distinct call ID {}",
-            dfcall_id
-        )));
-    }
-
-    // Delete the distinct call
-    if let Some(dfcall_array) = config_data["G2_CONFIG"]["CFG_DFCALL"].as_array_mut() {
-        dfcall_array.retain(|record| record["DFCALL_ID"].as_i64() != Some(dfcall_id));
-    }
-
-    // Delete associated DFBOM records
-    if let Some(dfbom_array) = config_data["G2_CONFIG"]["CFG_DFBOM"].as_array_mut() {
-        dfbom_array.retain(|record| record["DFCALL_ID"].as_i64() != Some(dfcall_id));
-    }
-
-    serde_json::to_string(&config_data).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config, |config| config.delete_distinct_call(dfcall_id))
 }
 
 /// Get a single distinct call by ID
@@ -271,8 +380,7 @@ pub fn delete_distinct_call(config: &str, dfcall_id: i64) -> Result<String> {
 /// # Errors
 /// - `NotFound` if call ID doesn't exist
 pub fn get_distinct_call(config: &str, dfcall_id: i64) -> Result<Value> {
-    find_in_config_array(config, "CFG_DFCALL", "DFCALL_ID", &dfcall_id.to_string())?
-        .ok_or_else(|| SzConfigError::NotFound(format!("Distinct call ID {}", dfcall_id)))
+    handle::read(config, |config| config.get_distinct_call(dfcall_id))
 }
 
 /// List all distinct calls with resolved names
@@ -285,66 +393,7 @@ pub fn get_distinct_call(config: &str, dfcall_id: i64) -> Result<Value> {
 /// # Returns
 /// Vector of JSON Values with resolved names
 pub fn list_distinct_calls(config: &str) -> Result<Vec<Value>> {
-    let config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let empty_array = vec![];
-    let dfcall_array = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_DFCALL"))
-        .and_then(|v| v.as_array())
-        .unwrap_or(&empty_array);
-
-    let ftype_array = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_FTYPE"))
-        .and_then(|v| v.as_array())
-        .unwrap_or(&empty_array);
-
-    let dfunc_array = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_DFUNC"))
-        .and_then(|v| v.as_array())
-        .unwrap_or(&empty_array);
-
-    // Helper functions for ID resolution
-    let resolve_ftype = |ftype_id: i64| -> String {
-        ftype_array
-            .iter()
-            .find(|ft| ft.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(ftype_id))
-            .and_then(|ft| ft.get("FTYPE_CODE"))
-            .and_then(|v| v.as_str())
-            .unwrap_or("unknown")
-            .to_string()
-    };
-
-    let resolve_dfunc = |dfunc_id: i64| -> String {
-        dfunc_array
-            .iter()
-            .find(|df| df.get("DFUNC_ID").and_then(|v| v.as_i64()) == Some(dfunc_id))
-            .and_then(|df| df.get("DFUNC_CODE"))
-            .and_then(|v| v.as_str())
-            .unwrap_or("unknown")
-            .to_string()
-    };
-
-    // Transform distinct calls
-    let items: Vec<Value> = dfcall_array
-        .iter()
-        .map(|item| {
-            let ftype_id = item.get("FTYPE_ID").and_then(|v| v.as_i64()).unwrap_or(0);
-            let dfunc_id = item.get("DFUNC_ID").and_then(|v| v.as_i64()).unwrap_or(0);
-
-            json!({
-                "id": item.get("DFCALL_ID").and_then(|v| v.as_i64()).unwrap_or(0),
-                "feature": resolve_ftype(ftype_id),
-                "function": resolve_dfunc(dfunc_id),
-                "execOrder": item.get("EXEC_ORDER").and_then(|v| v.as_i64()).unwrap_or(1)
-            })
-        })
-        .collect();
-
-    Ok(items)
+    handle::read(config, |config| Ok(config.list_distinct_calls()))
 }
 
 /// Update a distinct call (stub - not implemented in Python)
@@ -374,47 +423,7 @@ pub fn add_distinct_call_element(
     config: &str,
     params: AddDistinctCallElementParams,
 ) -> Result<(String, Value)> {
-    let mut config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Check if element already exists
-    if let Some(dbom_array) = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_DFBOM"))
-        .and_then(|v| v.as_array())
-    {
-        for item in dbom_array {
-            if item.get("DFCALL_ID").and_then(|v| v.as_i64()) == Some(params.dfcall_id)
-                && item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(params.ftype_id)
-                && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(params.felem_id)
-                && item.get("EXEC_ORDER").and_then(|v| v.as_i64()) == Some(params.exec_order)
-            {
-                return Err(SzConfigError::AlreadyExists(
-                    "Distinct call element already exists".to_string(),
-                ));
-            }
-        }
-    }
-
-    // Create new DBOM record
-    let new_record = json!({
-        "DFCALL_ID": params.dfcall_id,
-        "FTYPE_ID": params.ftype_id,
-        "FELEM_ID": params.felem_id,
-        "EXEC_ORDER": params.exec_order
-    });
-
-    // Add to CFG_DFBOM
-    if let Some(dbom_array) = config_data["G2_CONFIG"]["CFG_DFBOM"].as_array_mut() {
-        dbom_array.push(new_record.clone());
-    } else {
-        return Err(SzConfigError::MissingSection("CFG_DFBOM".to_string()));
-    }
-
-    let modified_config =
-        serde_json::to_string(&config_data).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    Ok((modified_config, new_record))
+    handle::edit_returning(config, |config| config.add_distinct_call_element(params))
 }
 
 /// Delete a distinct call element
@@ -429,39 +438,7 @@ pub fn delete_distinct_call_element(
     config: &str,
     params: DeleteDistinctCallElementParams,
 ) -> Result<String> {
-    let mut config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Validate that the element exists
-    let element_exists = config_data["G2_CONFIG"]["CFG_DFBOM"]
-        .as_array()
-        .map(|arr| {
-            arr.iter().any(|item| {
-                item.get("DFCALL_ID").and_then(|v| v.as_i64()) == Some(params.dfcall_id)
-                    && item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(params.ftype_id)
-                    && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(params.felem_id)
-                    && item.get("EXEC_ORDER").and_then(|v| v.as_i64()) == Some(params.exec_order)
-            })
-        })
-        .unwrap_or(false);
-
-    if !element_exists {
-        return Err(SzConfigError::NotFound(
-            "Distinct call element not found".to_string(),
-        ));
-    }
-
-    // Delete the element
-    if let Some(dbom_array) = config_data["G2_CONFIG"]["CFG_DFBOM"].as_array_mut() {
-        dbom_array.retain(|item| {
-            !(item.get("DFCALL_ID").and_then(|v| v.as_i64()) == Some(params.dfcall_id)
-                && item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(params.ftype_id)
-                && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(params.felem_id)
-                && item.get("EXEC_ORDER").and_then(|v| v.as_i64()) == Some(params.exec_order))
-        });
-    }
-
-    serde_json::to_string(&config_data).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config, |config| config.delete_distinct_call_element(params))
 }
 
 /// Update a distinct call element (stub - not typically used)
@@ -4,9 +4,7 @@
 //! (expression bill of materials) configuration sections.
 
 use crate::error::{Result, SzConfigError};
-use crate::helpers::{
-    find_in_config_array, get_next_id, lookup_efunc_id, lookup_element_id, lookup_feature_id,
-};
+use crate::handle::{self, ConfigHandle};
 use serde_json::{Value, json};
 
 // ============================================================================
@@ -100,187 +98,349 @@ impl TryFrom<&Value> for SetExpressionCallParams {
     }
 }
 
-/// Add a new expression call with element list
-///
-/// Creates a new expression call linking a function to a feature or element
-/// with an execution order and associated elements (EBOM records).
-///
-/// # Arguments
-/// * `config` - Configuration JSON string
-/// * `params` - Expression call parameters
-///
-/// # Returns
-/// Tuple of (modified_config, new_efcall_record)
-///
-/// # Errors
-/// - `InvalidParameter` if both ftype_code and felem_code are specified or both missing
-/// - `Duplicate` if exec_order is already taken for the feature/element
-/// - `NotFound` if function/feature/element codes don't exist
-pub fn add_expression_call(
-    config: &str,
-    params: AddExpressionCallParams,
-) -> Result<(String, Value)> {
-    let mut config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Get next EFCALL_ID (seed at 1000 for user-created calls)
-    let efcall_id = get_next_id(&config_data, "G2_CONFIG.CFG_EFCALL", "EFCALL_ID", 1000)?;
+impl ConfigHandle {
+    /// Add a new expression call (in-place form of [`add_expression_call`])
+    ///
+    /// Returns the new CFG_EFCALL record.
+    pub fn add_expression_call(&mut self, params: AddExpressionCallParams) -> Result<Value> {
+        // Get next EFCALL_ID (seed at 1000 for user-created calls)
+        let efcall_id = self.next_id("CFG_EFCALL", "EFCALL_ID", Some(1000))?;
 
-    // Lookup function ID
-    let efunc_id = lookup_efunc_id(config, params.efunc_code)?;
+        // Lookup function ID
+        let efunc_id = self.lookup_efunc_id(params.efunc_code)?;
 
-    // Determine FTYPE_ID and FELEM_ID (-1 means not specified)
-    let mut ftype_id: i64 = -1;
-    let mut felem_id: i64 = -1;
+        // Determine FTYPE_ID and FELEM_ID (-1 means not specified)
+        let mut ftype_id: i64 = -1;
+        let mut felem_id: i64 = -1;
 
-    if let Some(feature) = params.ftype_code.filter(|f| !f.eq_ignore_ascii_case("ALL")) {
-        ftype_id = lookup_feature_id(config, feature)?;
-    }
+        if let Some(feature) = params.ftype_code.filter(|f| !f.eq_ignore_ascii_case("ALL")) {
+            ftype_id = self.lookup_feature_id(feature)?;
+        }
 
-    if let Some(element) = params.felem_code.filter(|e| !e.eq_ignore_ascii_case("N/A")) {
-        felem_id = lookup_element_id(config, element)?;
-    }
+        if let Some(element) = params.felem_code.filter(|e| !e.eq_ignore_ascii_case("N/A")) {
+            felem_id = self.lookup_element_id(element)?;
+        }
 
-    // Validate: exactly one of (feature, element) must be specified
-    if (ftype_id > 0 && felem_id > 0) || (ftype_id < 0 && felem_id < 0) {
-        return Err(SzConfigError::InvalidInput(
-            "Either a feature or an element must be specified, but not both".to_string(),
-        ));
-    }
+        // Validate: exactly one of (feature, element) must be specified
+        if (ftype_id > 0 && felem_id > 0) || (ftype_id < 0 && felem_id < 0) {
+            return Err(SzConfigError::InvalidInput(
+                "Either a feature or an element must be specified, but not both".to_string(),
+            ));
+        }
 
-    // Determine exec_order
-    let final_exec_order = if let Some(order) = params.exec_order {
-        // Check if this exec_order is already taken for this feature/element
-        let order_taken = config_data["G2_CONFIG"]["CFG_EFCALL"]
-            .as_array()
-            .map(|arr| {
-                arr.iter().any(|call| {
+        let empty_array = vec![];
+        let efcall_array = self.section("CFG_EFCALL").unwrap_or(&empty_array);
+
+        // Determine exec_order
+        let final_exec_order = if let Some(order) = params.exec_order {
+            // Check if this exec_order is already taken for this feature/element
+            let order_taken = efcall_array.iter().any(|call| {
+                call["FTYPE_ID"].as_i64() == Some(ftype_id)
+                    && call["FELEM_ID"].as_i64() == Some(felem_id)
+                    && call["EXEC_ORDER"].as_i64() == Some(order)
+            });
+
+            if order_taken {
+                return Err(SzConfigError::AlreadyExists(format!(
+                    "Execution order {} already taken for this feature/element",
+                    order
+                )));
+            }
+            order
+        } else {
+            // Get next available exec_order for this feature/element combination
+            efcall_array
+                .iter()
+                .filter(|call| {
                     call["FTYPE_ID"].as_i64() == Some(ftype_id)
                         && call["FELEM_ID"].as_i64() == Some(felem_id)
-                        && call["EXEC_ORDER"].as_i64() == Some(order)
                 })
-            })
-            .unwrap_or(false);
+                .filter_map(|call| call["EXEC_ORDER"].as_i64())
+                .max()
+                .map(|max| max + 1)
+                .unwrap_or(1)
+        };
 
-        if order_taken {
-            return Err(SzConfigError::AlreadyExists(format!(
-                "Execution order {} already taken for this feature/element",
-                order
-            )));
-        }
-        order
-    } else {
-        // Get next available exec_order for this feature/element combination
-        config_data["G2_CONFIG"]["CFG_EFCALL"]
-            .as_array()
-            .map(|arr| {
-                arr.iter()
-                    .filter(|call| {
-                        call["FTYPE_ID"].as_i64() == Some(ftype_id)
-                            && call["FELEM_ID"].as_i64() == Some(felem_id)
-                    })
-                    .filter_map(|call| call["EXEC_ORDER"].as_i64())
-                    .max()
-                    .map(|max| max + 1)
-                    .unwrap_or(1)
-            })
-            .unwrap_or(1)
-    };
-
-    // Lookup expression feature ID if specified
-    let efeat_ftype_id = if let Some(expr_feat) = params
-        .expression_feature
-        .filter(|f| !f.eq_ignore_ascii_case("N/A"))
-    {
-        lookup_feature_id(config, expr_feat)?
-    } else {
-        -1
-    };
-
-    // Process element list and create EFBOM records
-    let mut efbom_records = Vec::new();
-    let mut bom_exec_order = 0;
-
-    for (element_code, required, feature_opt) in params.element_list {
-        bom_exec_order += 1;
-
-        // Determine BOM FTYPE_ID
-        let bom_ftype_id =
-            if let Some(bom_feature) = feature_opt.filter(|f| !f.eq_ignore_ascii_case("PARENT")) {
+        // Lookup expression feature ID if specified
+        let efeat_ftype_id = if let Some(expr_feat) = params
+            .expression_feature
+            .filter(|f| !f.eq_ignore_ascii_case("N/A"))
+        {
+            self.lookup_feature_id(expr_feat)?
+        } else {
+            -1
+        };
+
+        // Process element list and create EFBOM records
+        let mut efbom_records = Vec::new();
+        let mut bom_exec_order = 0;
+
+        for (element_code, required, feature_opt) in params.element_list {
+            bom_exec_order += 1;
+
+            // Determine BOM FTYPE_ID
+            let bom_ftype_id = if let Some(bom_feature) =
+                feature_opt.filter(|f| !f.eq_ignore_ascii_case("PARENT"))
+            {
                 if bom_feature.eq_ignore_ascii_case("parent") {
                     0 // Special value for parent feature link
                 } else {
-                    lookup_feature_id(config, &bom_feature)?
+                    self.lookup_feature_id(&bom_feature)?
                 }
             } else {
                 -1
             };
 
-        // Lookup element ID
-        let bom_felem_id = if bom_ftype_id > 0 {
-            // Lookup element within specific feature
-            config_data["G2_CONFIG"]["CFG_FBOM"]
-                .as_array()
-                .and_then(|arr| {
-                    arr.iter()
-                        .find(|fbom| {
-                            fbom["FTYPE_ID"].as_i64() == Some(bom_ftype_id)
-                                && fbom["FELEM_CODE"]
-                                    .as_str()
-                                    .map(|s| s.eq_ignore_ascii_case(&element_code))
-                                    .unwrap_or(false)
-                        })
-                        .and_then(|fbom| fbom["FELEM_ID"].as_i64())
-                })
-                .ok_or_else(|| {
-                    SzConfigError::NotFound(format!(
-                        "Element '{}' not found in feature",
-                        element_code
-                    ))
-                })?
-        } else {
-            // Lookup element globally
-            lookup_element_id(config, &element_code)?
-        };
+            // Lookup element ID
+            let bom_felem_id = if bom_ftype_id > 0 {
+                // Lookup element within specific feature
+                self.section("CFG_FBOM")
+                    .ok()
+                    .and_then(|arr| {
+                        arr.iter()
+                            .find(|fbom| {
+                                fbom["FTYPE_ID"].as_i64() == Some(bom_ftype_id)
+                                    && fbom["FELEM_CODE"]
+                                        .as_str()
+                                        .map(|s| s.eq_ignore_ascii_case(&element_code))
+                                        .unwrap_or(false)
+                            })
+                            .and_then(|fbom| fbom["FELEM_ID"].as_i64())
+                    })
+                    .ok_or_else(|| {
+                        SzConfigError::NotFound(format!(
+                            "Element '{}' not found in feature",
+                            element_code
+                        ))
+                    })?
+            } else {
+                // Lookup element globally
+                self.lookup_element_id(&element_code)?
+            };
+
+            // Create EFBOM record
+            efbom_records.push(json!({
+                "EFCALL_ID": efcall_id,
+                "FTYPE_ID": bom_ftype_id,
+                "FELEM_ID": bom_felem_id,
+                "EXEC_ORDER": bom_exec_order,
+                "FELEM_REQ": required
+            }));
+        }
 
-        // Create EFBOM record
-        efbom_records.push(json!({
+        // Create new CFG_EFCALL record
+        let new_record = json!({
             "EFCALL_ID": efcall_id,
-            "FTYPE_ID": bom_ftype_id,
-            "FELEM_ID": bom_felem_id,
-            "EXEC_ORDER": bom_exec_order,
-            "FELEM_REQ": required
-        }));
+            "FTYPE_ID": ftype_id,
+            "FELEM_ID": felem_id,
+            "EFUNC_ID": efunc_id,
+            "EXEC_ORDER": final_exec_order,
+            "EFEAT_FTYPE_ID": efeat_ftype_id,
+            "IS_VIRTUAL": params.is_virtual
+        });
+
+        // Both sections must exist before either is modified
+        self.section("CFG_EFCALL")?;
+        self.section("CFG_EFBOM")?;
+
+        self.section_mut("CFG_EFCALL")?.push(new_record.clone());
+        self.section_mut("CFG_EFBOM")?.extend(efbom_records);
+
+        Ok(new_record)
     }
 
-    // Create new CFG_EFCALL record
-    let new_record = json!({
-        "EFCALL_ID": efcall_id,
-        "FTYPE_ID": ftype_id,
-        "FELEM_ID": felem_id,
-        "EFUNC_ID": efunc_id,
-        "EXEC_ORDER": final_exec_order,
-        "EFEAT_FTYPE_ID": efeat_ftype_id,
-        "IS_VIRTUAL": params.is_virtual
-    });
-
-    // Add to config
-    if let Some(efcall_array) = config_data["G2_CONFIG"]["CFG_EFCALL"].as_array_mut() {
-        efcall_array.push(new_record.clone());
-    } else {
-        return Err(SzConfigError::MissingSection("CFG_EFCALL".to_string()));
+    /// Delete an expression call and its EFBOM records (in-place form of [`delete_expression_call`])
+    pub fn delete_expression_call(&mut self, efcall_id: i64) -> Result<()> {
+        // Validate that the call exists
+        let call_exists = self
+            .section("CFG_EFCALL")
+            .map(|arr| {
+                arr.iter()
+                    .any(|call| call["EFCALL_ID"].as_i64() == Some(efcall_id))
+            })
+            .unwrap_or(false);
+
+        if !call_exists {
+            return Err(SzConfigError::NotFound(format!(
+                "Expression call ID {}",
+                efcall_id
+            )));
+        }
+
+        // Delete the expression call and associated EFBOM records
+        for section in ["CFG_EFCALL", "CFG_EFBOM"] {
+            if let Ok(array) = self.section_mut(section) {
+                array.retain(|record| record["EFCALL_ID"].as_i64() != Some(efcall_id));
+            }
+        }
+
+        Ok(())
     }
 
-    if let Some(efbom_array) = config_data["G2_CONFIG"]["CFG_EFBOM"].as_array_mut() {
-        efbom_array.extend(efbom_records);
-    } else {
-        return Err(SzConfigError::MissingSection("CFG_EFBOM".to_string()));
+    /// Get a single expression call by ID (see [`get_expression_call`])
+    pub fn get_expression_call(&self, efcall_id: i64) -> Result<Value> {
+        self.find_in_config_array("CFG_EFCALL", "EFCALL_ID", &efcall_id.to_string())
+            .cloned()
+            .ok_or_else(|| SzConfigError::NotFound(format!("Expression call ID {}", efcall_id)))
     }
 
-    let modified_config =
-        serde_json::to_string(&config_data).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
+    /// List all expression calls with resolved names (see [`list_expression_calls`])
+    pub fn list_expression_calls(&self) -> Vec<Value> {
+        let empty_array = vec![];
+        let efcall_array = self.section("CFG_EFCALL").unwrap_or(&empty_array);
+        let ftype_array = self.section("CFG_FTYPE").unwrap_or(&empty_array);
+        let felem_array = self.section("CFG_FELEM").unwrap_or(&empty_array);
+        let efunc_array = self.section("CFG_EFUNC").unwrap_or(&empty_array);
+
+        // Helper functions for ID resolution
+        let resolve_ftype = |ftype_id: i64| -> String {
+            if ftype_id <= 0 {
+                "all".to_string()
+            } else {
+                ftype_array
+                    .iter()
+                    .find(|ft| ft.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(ftype_id))
+                    .and_then(|ft| ft.get("FTYPE_CODE"))
+                    .and_then(|v| v.as_str())
+                    .unwrap_or("all")
+                    .to_string()
+            }
+        };
+
+        let resolve_felem = |felem_id: i64| -> String {
+            if felem_id <= 0 {
+                "n/a".to_string()
+            } else {
+                felem_array
+                    .iter()
+                    .find(|fe| fe.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(felem_id))
+                    .and_then(|fe| fe.get("FELEM_CODE"))
+                    .and_then(|v| v.as_str())
+                    .unwrap_or("n/a")
+                    .to_string()
+            }
+        };
+
+        let resolve_efunc = |efunc_id: i64| -> String {
+            efunc_array
+                .iter()
+                .find(|ef| ef.get("EFUNC_ID").and_then(|v| v.as_i64()) == Some(efunc_id))
+                .and_then(|ef| ef.get("EFUNC_CODE"))
+                .and_then(|v| v.as_str())
+                .unwrap_or("unknown")
+                .to_string()
+        };
+
+        // Transform expression calls
+        efcall_array
+            .iter()
+            .map(|item| {
+                let ftype_id = item.get("FTYPE_ID").and_then(|v| v.as_i64()).unwrap_or(0);
+                let felem_id = item.get("FELEM_ID").and_then(|v| v.as_i64()).unwrap_or(0);
+                let efunc_id = item.get("EFUNC_ID").and_then(|v| v.as_i64()).unwrap_or(0);
+
+                let efeat_ftype_id = item.get("EFEAT_FTYPE_ID").and_then(|v| v.as_i64()).unwrap_or(-1);
+
+                json!({
+                    "id": item.get("EFCALL_ID").and_then(|v| v.as_i64()).unwrap_or(0),
+                    "feature": resolve_ftype(ftype_id),
+                    "element": resolve_felem(felem_id),
+                    "execOrder": item.get("EXEC_ORDER").and_then(|v| v.as_i64()).unwrap_or(0),
+                    "function": resolve_efunc(efunc_id),
+                    "isVirtual": item.get("IS_VIRTUAL").and_then(|v| v.as_str()).unwrap_or("No"),
+                    "expressionFeature": if efeat_ftype_id <= 0 { "n/a".to_string() } else { resolve_ftype(efeat_ftype_id) }
+                })
+            })
+            .collect()
+    }
 
-    Ok((modified_config, new_record))
+    /// Add an expression call element (in-place form of [`add_expression_call_element`])
+    ///
+    /// Returns the new EFBOM record.
+    pub fn add_expression_call_element(
+        &mut self,
+        efcall_id: i64,
+        params: ExpressionCallElementParams,
+    ) -> Result<Value> {
+        let ebom_array = self.section_mut("CFG_EFBOM")?;
+
+        // Check if element already exists
+        if ebom_array.iter().any(|item| {
+            item.get("EFCALL_ID").and_then(|v| v.as_i64()) == Some(efcall_id)
+                && item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(params.ftype_id)
+                && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(params.felem_id)
+                && item.get("EXEC_ORDER").and_then(|v| v.as_i64()) == Some(params.exec_order)
+        }) {
+            return Err(SzConfigError::AlreadyExists(
+                "Expression call element already exists".to_string(),
+            ));
+        }
+
+        // Create new EBOM record
+        let new_record = json!({
+            "EFCALL_ID": efcall_id,
+            "FTYPE_ID": params.ftype_id,
+            "FELEM_ID": params.felem_id,
+            "EXEC_ORDER": params.exec_order,
+            "FELEM_REQ": params.felem_req
+        });
+
+        ebom_array.push(new_record.clone());
+
+        Ok(new_record)
+    }
+
+    /// Delete an expression call element (in-place form of [`delete_expression_call_element`])
+    pub fn delete_expression_call_element(
+        &mut self,
+        efcall_id: i64,
+        key: ExpressionCallElementKey,
+    ) -> Result<()> {
+        let matches = |item: &Value| {
+            item.get("EFCALL_ID").and_then(|v| v.as_i64()) == Some(efcall_id)
+                && item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(key.ftype_id)
+                && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(key.felem_id)
+                && item.get("EXEC_ORDER").and_then(|v| v.as_i64()) == Some(key.exec_order)
+        };
+
+        // Validate that the element exists
+        let ebom_array = match self.section_mut("CFG_EFBOM") {
+            Ok(array) if array.iter().any(matches) => array,
+            _ => {
+                return Err(SzConfigError::NotFound(
+                    "Expression call element not found".to_string(),
+                ));
+            }
+        };
+
+        // Delete the element
+        ebom_array.retain(|item| !matches(item));
+
+        Ok(())
+    }
+}
+
+/// Add a new expression call with element list
+///
+/// Creates a new expression call linking a function to a feature or element
+/// with an execution order and associated elements (EBOM records).
+///
+/// # Arguments
+/// * `config` - Configuration JSON string
+/// * `params` - Expression call parameters
+///
+/// # Returns
+/// Tuple of (modified_config, new_efcall_record)
+///
+/// # Errors
+/// - `InvalidParameter` if both ftype_code and felem_code are specified or both missing
+/// - `Duplicate` if exec_order is already taken for the feature/element
+/// - `NotFound` if function/feature/element codes don't exist
+pub fn add_expression_call(
+    config: &str,
+    params: AddExpressionCallParams,
+) -> Result<(String, Value)> {
+    handle::edit_returning(config, |config| config.add_expression_call(params))
 }
 
 /// Delete an expression call by ID
@@ -297,36 +457,7 @@ pub fn add_expression_call(
 /// # Errors
 /// - `NotFound` if call ID doesn't exist
 pub fn delete_expression_call(config: &str, efcall_id: i64) -> Result<String> {
-    let mut config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Validate that the call exists
-    let call_exists = config_data["G2_CONFIG"]["CFG_EFCALL"]
-        .as_array()
-        .map(|arr| {
-            arr.iter()
-                .any(|call| call["EFCALL_ID"].as_i64() == Some(efcall_id))
-        })
-        .unwrap_or(false);
-
-    if !call_exists {
-        return Err(SzConfigError::NotFound(format!(
-            "Expression call ID {}",
-            efcall_id
-        )));
-    }
-
-    // Delete the expression call
-    if let Some(efcall_array) = config_data["G2_CONFIG"]["CFG_EFCALL"].as_array_mut() {
-        efcall_array.retain(|record| record["EFCALL_ID"].as_i64() != Some(efcall_id));
-    }
-
-    // Delete associated EFBOM records
-    if let Some(efbom_array) = config_data["G2_CONFIG"]["CFG_EFBOM"].as_array_mut() {
-        efbom_array.retain(|record| record["EFCALL_ID"].as_i64() != Some(efcall_id));
-    }
-
-    serde_json::to_string(&config_data).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config, |config| config.delete_expression_call(efcall_id))
 }
 
 /// Get a single expression call by ID
@@ -341,8 +472,7 @@ pub fn delete_expression_call(config: &str, efcall_id: i64) -> Result<String> {
 /// # Errors
 /// - `NotFound` if call ID doesn't exist
 pub fn get_expression_call(config: &str, efcall_id: i64) -> Result<Value> {
-    find_in_config_array(config, "CFG_EFCALL", "EFCALL_ID", &efcall_id.to_string())?
-        .ok_or_else(|| SzConfigError::NotFound(format!("Expression call ID {}", efcall_id)))
+    handle::read(config, |config| config.get_expression_call(efcall_id))
 }
 
 /// List all expression calls with resolved names
@@ -355,96 +485,7 @@ pub fn get_expression_call(config: &str, efcall_id: i64) -> Result<Value> {
 /// # Returns
 /// Vector of JSON Values with resolved names
 pub fn list_expression_calls(config: &str) -> Result<Vec<Value>> {
-    let config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let empty_array = vec![];
-    let efcall_array = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_EFCALL"))
-        .and_then(|v| v.as_array())
-        .unwrap_or(&empty_array);
-
-    let ftype_array = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_FTYPE"))
-        .and_then(|v| v.as_array())
-        .unwrap_or(&empty_array);
-
-    let felem_array = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_FELEM"))
-        .and_then(|v| v.as_array())
-        .unwrap_or(&empty_array);
-
-    let efunc_array = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_EFUNC"))
-        .and_then(|v| v.as_array())
-        .unwrap_or(&empty_array);
-
-    // Helper functions for ID resolution
-    let resolve_ftype = |ftype_id: i64| -> String {
-        if ftype_id <= 0 {
-            "all".to_string()
-        } else {
-            ftype_array
-                .iter()
-                .find(|ft| ft.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(ftype_id))
-                .and_then(|ft| ft.get("FTYPE_CODE"))
-                .and_then(|v| v.as_str())
-                .unwrap_or("all")
-                .to_string()
-        }
-    };
-
-    let resolve_felem = |felem_id: i64| -> String {
-        if felem_id <= 0 {
-            "n/a".to_string()
-        } else {
-            felem_array
-                .iter()
-                .find(|fe| fe.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(felem_id))
-                .and_then(|fe| fe.get("FELEM_CODE"))
-                .and_then(|v| v.as_str())
-                .unwrap_or("n/a")
-                .to_string()
-        }
-    };
-
-    let resolve_efunc = |efunc_id: i64| -> String {
-        efunc_array
-            .iter()
-            .find(|ef| ef.get("EFUNC_ID").and_then(|v| v.as_i64()) == Some(efunc_id))
-            .and_then(|ef| ef.get("EFUNC_CODE"))
-            .and_then(|v| v.as_str())
-            .unwrap_or("unknown")
-            .to_string()
-    };
-
-    // Transform expression calls
-    let items: Vec<Value> = efcall_array
-        .iter()
-        .map(|item| {
-            let ftype_id = item.get("FTYPE_ID").and_then(|v| v.as_i64()).unwrap_or(0);
-            let felem_id = item.get("FELEM_ID").and_then(|v| v.as_i64()).unwrap_or(0);
-            let efunc_id = item.get("EFUNC_ID").and_then(|v| v.as_i64()).unwrap_or(0);
-
-            let efeat_ftype_id = item.get("EFEAT_FTYPE_ID").and_then(|v| v.as_i64()).unwrap_or(-1);
-
-            json!({
-                "id": item.get("EFCALL_ID").and_then(|v| v.as_i64()).unwrap_or(0),
-                "feature": resolve_ftype(ftype_id),
-                "element": resolve_felem(felem_id),
-                "execOrder": item.get("EXEC_ORDER").and_then(|v| v.as_i64()).unwrap_or(0),
-                "function": resolve_efunc(efunc_id),
-                "isVirtual": item.get("IS_VIRTUAL").and_then(|v| v.as_str()).unwrap_or("No"),
-                "expressionFeature": if efeat_ftype_id <= 0 { "n/a".to_string() } else { resolve_ftype(efeat_ftype_id) }
-            })
-        })
-        .collect();
-
-    Ok(items)
+    handle::read(config, |config| Ok(config.list_expression_calls()))
 }
 
 /// Update an expression call (stub - not implemented in Python)
@@ -476,48 +517,9 @@ pub fn add_expression_call_element(
     efcall_id: i64,
     params: ExpressionCallElementParams,
 ) -> Result<(String, Value)> {
-    let mut config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Check if element already exists
-    if let Some(ebom_array) = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_EFBOM"))
-        .and_then(|v| v.as_array())
-    {
-        for item in ebom_array {
-            if item.get("EFCALL_ID").and_then(|v| v.as_i64()) == Some(efcall_id)
-                && item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(params.ftype_id)
-                && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(params.felem_id)
-                && item.get("EXEC_ORDER").and_then(|v| v.as_i64()) == Some(params.exec_order)
-            {
-                return Err(SzConfigError::AlreadyExists(
-                    "Expression call element already exists".to_string(),
-                ));
-            }
-        }
-    }
-
-    // Create new EBOM record
-    let new_record = json!({
-        "EFCALL_ID": efcall_id,
-        "FTYPE_ID": params.ftype_id,
-        "FELEM_ID": params.felem_id,
-        "EXEC_ORDER": params.exec_order,
-        "FELEM_REQ": params.felem_req
-    });
-
-    // Add to CFG_EFBOM
-    if let Some(ebom_array) = config_data["G2_CONFIG"]["CFG_EFBOM"].as_array_mut() {
-        ebom_array.push(new_record.clone());
-    } else {
-        return Err(SzConfigError::MissingSection("CFG_EFBOM".to_string()));
-    }
-
-    let modified_config =
-        serde_json::to_string(&config_data).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    Ok((modified_config, new_record))
+    handle::edit_returning(config, |config| {
+        config.add_expression_call_element(efcall_id, params)
+    })
 }
 
 /// Delete an expression call element
@@ -534,39 +536,9 @@ pub fn delete_expression_call_element(
     efcall_id: i64,
     key: ExpressionCallElementKey,
 ) -> Result<String> {
-    let mut config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Validate that the element exists
-    let element_exists = config_data["G2_CONFIG"]["CFG_EFBOM"]
-        .as_array()
-        .map(|arr| {
-            arr.iter().any(|item| {
-                item.get("EFCALL_ID").and_then(|v| v.as_i64()) == Some(efcall_id)
-                    && item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(key.ftype_id)
-                    && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(key.felem_id)
-                    && item.get("EXEC_ORDER").and_then(|v| v.as_i64()) == Some(key.exec_order)
-            })
-        })
-        .unwrap_or(false);
-
-    if !element_exists {
-        return Err(SzConfigError::NotFound(
-            "Expression call element not found".to_string(),
-        ));
-    }
-
-    // Delete the element
-    if let Some(ebom_array) = config_data["G2_CONFIG"]["CFG_EFBOM"].as_array_mut() {
-        ebom_array.retain(|item| {
-            !(item.get("EFCALL_ID").and_then(|v| v.as_i64()) == Some(efcall_id)
-                && item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(key.ftype_id)
-                && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(key.felem_id)
-                && item.get("EXEC_ORDER").and_then(|v| v.as_i64()) == Some(key.exec_order))
-        });
-    }
-
-    serde_json::to_string(&config_data).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config, |config| {
+        config.delete_expression_call_element(efcall_id, key)
+    })
 }
 
 /// Update an expression call element (stub - not typically used)
@@ -4,9 +4,7 @@
 //! (standardize bill of materials) configuration sections.
 
 use crate::error::{Result, SzConfigError};
-use crate::helpers::{
-    find_in_config_array, get_next_id, lookup_element_id, lookup_feature_id, lookup_sfunc_id,
-};
+use crate::handle::{self, ConfigHandle};
 use serde_json::{Value, json};
 
 // ============================================================================
@@ -82,6 +80,252 @@ pub struct SetStandardizeCallElementParams {
     pub updates: Value,
 }
 
+impl ConfigHandle {
+    /// Add a new standardize call (in-place form of [`add_standardize_call`])
+    ///
+    /// Returns the new CFG_SFCALL record.
+    pub fn add_standardize_call(&mut self, params: AddStandardizeCallParams) -> Result<Value> {
+        // Get next SFCALL_ID (seed at 1000 for user-created calls)
+        let sfcall_id = self.next_id("CFG_SFCALL", "SFCALL_ID", Some(1000))?;
+
+        // Lookup function ID
+        let sfunc_id = self.lookup_sfunc_id(params.sfunc_code)?;
+
+        // Determine FTYPE_ID and FELEM_ID (-1 means not specified)
+        let mut ftype_id: i64 = -1;
+        let mut felem_id: i64 = -1;
+
+        if let Some(feature) = params.ftype_code.filter(|f| !f.eq_ignore_ascii_case("ALL")) {
+            ftype_id = self.lookup_feature_id(feature)?;
+        }
+
+        if let Some(element) = params.felem_code.filter(|e| !e.eq_ignore_ascii_case("N/A")) {
+            felem_id = self.lookup_element_id(element)?;
+        }
+
+        // Validate: exactly one of (feature, element) must be specified
+        if (ftype_id > 0 && felem_id > 0) || (ftype_id < 0 && felem_id < 0) {
+            return Err(SzConfigError::InvalidInput(
+                "Either a feature or an element must be specified, but not both".to_string(),
+            ));
+        }
+
+        let sfcall_array = self.section_mut("CFG_SFCALL")?;
+
+        // Determine exec_order: use provided value or get next available for this feature/element
+        let final_exec_order = if let Some(order) = params.exec_order {
+            // Check if this exec_order is already taken for this feature/element
+            let order_taken = sfcall_array.iter().any(|call| {
+                call["FTYPE_ID"].as_i64() == Some(ftype_id)
+                    && call["FELEM_ID"].as_i64() == Some(felem_id)
+                    && call["EXEC_ORDER"].as_i64() == Some(order)
+            });
+
+            if order_taken {
+                return Err(SzConfigError::AlreadyExists(format!(
+                    "Execution order {} already taken for this feature/element",
+                    order
+                )));
+            }
+            order
+        } else {
+            // Get next available exec_order for this feature/element combination
+            sfcall_array
+                .iter()
+                .filter(|call| {
+                    call["FTYPE_ID"].as_i64() == Some(ftype_id)
+                        && call["FELEM_ID"].as_i64() == Some(felem_id)
+                })
+                .filter_map(|call| call["EXEC_ORDER"].as_i64())
+                .max()
+                .map(|max| max + 1)
+                .unwrap_or(1)
+        };
+
+        // Create new CFG_SFCALL record
+        let new_record = json!({
+            "SFCALL_ID": sfcall_id,
+            "FTYPE_ID": ftype_id,
+            "FELEM_ID": felem_id,
+            "SFUNC_ID": sfunc_id,
+            "EXEC_ORDER": final_exec_order
+        });
+
+        sfcall_array.push(new_record.clone());
+
+        Ok(new_record)
+    }
+
+    /// Delete a standardize call by ID (in-place form of [`delete_standardize_call`])
+    pub fn delete_standardize_call(&mut self, sfcall_id: i64) -> Result<()> {
+        let sfcall_array = self
+            .section_mut("CFG_SFCALL")
+            .map_err(|_| SzConfigError::NotFound(format!("Standardize call ID {}", sfcall_id)))?;
+
+        // Validate that the call exists
+        if !sfcall_array
+            .iter()
+            .any(|call| call["SFCALL_ID"].as_i64() == Some(sfcall_id))
+        {
+            return Err(SzConfigError::NotFound(format!(
+                "Standardize call ID {}",
+                sfcall_id
+            )));
+        }
+
+        // Delete the standardize call
+        sfcall_array.retain(|record| record["SFCALL_ID"].as_i64() != Some(sfcall_id));
+
+        Ok(())
+    }
+
+    /// Get a single standardize call by ID (see [`get_standardize_call`])
+    pub fn get_standardize_call(&self, sfcall_id: i64) -> Result<Value> {
+        self.find_in_config_array("CFG_SFCALL", "SFCALL_ID", &sfcall_id.to_string())
+            .cloned()
+            .ok_or_else(|| SzConfigError::NotFound(format!("Standardize call ID {}", sfcall_id)))
+    }
+
+    /// List all standardize calls with resolved names (see [`list_standardize_calls`])
+    pub fn list_standardize_calls(&self) -> Vec<Value> {
+        let empty_array = vec![];
+        let sfcall_array = self.section("CFG_SFCALL").unwrap_or(&empty_array);
+        let ftype_array = self.section("CFG_FTYPE").unwrap_or(&empty_array);
+        let felem_array = self.section("CFG_FELEM").unwrap_or(&empty_array);
+        let sfunc_array = self.section("CFG_SFUNC").unwrap_or(&empty_array);
+
+        // Helper functions for ID resolution
+        let resolve_ftype = |ftype_id: i64| -> String {
+            if ftype_id <= 0 {
+                "all".to_string()
+            } else {
+                ftype_array
+                    .iter()
+                    .find(|ft| ft.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(ftype_id))
+                    .and_then(|ft| ft.get("FTYPE_CODE"))
+                    .and_then(|v| v.as_str())
+                    .unwrap_or("all")
+                    .to_string()
+            }
+        };
+
+        let resolve_felem = |felem_id: i64| -> String {
+            if felem_id <= 0 {
+                "n/a".to_string()
+            } else {
+                felem_array
+                    .iter()
+                    .find(|fe| fe.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(felem_id))
+                    .and_then(|fe| fe.get("FELEM_CODE"))
+                    .and_then(|v| v.as_str())
+                    .unwrap_or("n/a")
+                    .to_string()
+            }
+        };
+
+        let resolve_sfunc = |sfunc_id: i64| -> String {
+            sfunc_array
+                .iter()
+                .find(|sf| sf.get("SFUNC_ID").and_then(|v| v.as_i64()) == Some(sfunc_id))
+                .and_then(|sf| sf.get("SFUNC_CODE"))
+                .and_then(|v| v.as_str())
+                .unwrap_or("unknown")
+                .to_string()
+        };
+
+        // Transform standardize calls
+        sfcall_array
+            .iter()
+            .map(|item| {
+                let ftype_id = item.get("FTYPE_ID").and_then(|v| v.as_i64()).unwrap_or(0);
+                let felem_id = item.get("FELEM_ID").and_then(|v| v.as_i64()).unwrap_or(0);
+                let sfunc_id = item.get("SFUNC_ID").and_then(|v| v.as_i64()).unwrap_or(0);
+
+                json!({
+                    "id": item.get("SFCALL_ID").and_then(|v| v.as_i64()).unwrap_or(0),
+                    "feature": resolve_ftype(ftype_id),
+                    "element": resolve_felem(felem_id),
+                    "execOrder": item.get("EXEC_ORDER").and_then(|v| v.as_i64()).unwrap_or(0),
+                    "function": resolve_sfunc(sfunc_id)
+                })
+            })
+            .collect()
+    }
+
+    /// Add a standardize call element (in-place form of [`add_standardize_call_element`])
+    ///
+    /// Returns the new record.
+    pub fn add_standardize_call_element(
+        &mut self,
+        params: AddStandardizeCallElementParams,
+    ) -> Result<Value> {
+        let final_felem_id = params.felem_id.unwrap_or(-1);
+
+        // Get next SFCALL_ID
+        let sfcall_id = self.next_id("CFG_SFCALL", "SFCALL_ID", Some(1000))?;
+
+        let sfcall_array = self.section_mut("CFG_SFCALL")?;
+
+        // Check if call element already exists
+        if sfcall_array.iter().any(|item| {
+            item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(params.ftype_id)
+                && item.get("SFUNC_ID").and_then(|v| v.as_i64()) == Some(params.sfunc_id)
+                && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(final_felem_id)
+        }) {
+            return Err(SzConfigError::AlreadyExists(
+                "Standardize call element already exists".to_string(),
+            ));
+        }
+
+        // Create new call element record
+        let mut new_record = json!({
+            "SFCALL_ID": sfcall_id,
+            "FTYPE_ID": params.ftype_id,
+            "FELEM_ID": final_felem_id,
+            "SFUNC_ID": params.sfunc_id,
+        });
+
+        // Add optional exec_order if provided
+        if let Some(order) = params.exec_order
+            && let Some(obj) = new_record.as_object_mut()
+        {
+            obj.insert("EXEC_ORDER".to_string(), json!(order));
+        }
+
+        sfcall_array.push(new_record.clone());
+
+        Ok(new_record)
+    }
+
+    /// Delete a standardize call element (in-place form of [`delete_standardize_call_element`])
+    pub fn delete_standardize_call_element(
+        &mut self,
+        params: DeleteStandardizeCallElementParams,
+    ) -> Result<()> {
+        let final_felem_id = params.felem_id.unwrap_or(-1);
+        let matches = |item: &Value| {
+            item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(params.ftype_id)
+                && item.get("SFUNC_ID").and_then(|v| v.as_i64()) == Some(params.sfunc_id)
+                && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(final_felem_id)
+        };
+
+        // Validate that the element exists
+        let sfcall_array = match self.section_mut("CFG_SFCALL") {
+            Ok(array) if array.iter().any(matches) => array,
+            _ => {
+                return Err(SzConfigError::NotFound(
+                    "Standardize call element not found".to_string(),
+                ));
+            }
+        };
+
+        // Delete the element
+        sfcall_array.retain(|item| !matches(item));
+
+        Ok(())
+    }
+}
+
 /// Add a new standardize call
 ///
 /// Creates a new standardize call linking a function to a feature or element
@@ -102,93 +346,7 @@ pub fn add_standardize_call(
     config: &str,
     params: AddStandardizeCallParams,
 ) -> Result<(String, Value)> {
-    let mut config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Get next SFCALL_ID (seed at 1000 for user-created calls)
-    let sfcall_id = get_next_id(&config_data, "G2_CONFIG.CFG_SFCALL", "SFCALL_ID", 1000)?;
-
-    // Lookup function ID
-    let sfunc_id = lookup_sfunc_id(config, params.sfunc_code)?;
-
-    // Determine FTYPE_ID and FELEM_ID (-1 means not specified)
-    let mut ftype_id: i64 = -1;
-    let mut felem_id: i64 = -1;
-
-    if let Some(feature) = params.ftype_code.filter(|f| !f.eq_ignore_ascii_case("ALL")) {
-        ftype_id = lookup_feature_id(config, feature)?;
-    }
-
-    if let Some(element) = params.felem_code.filter(|e| !e.eq_ignore_ascii_case("N/A")) {
-        felem_id = lookup_element_id(config, element)?;
-    }
-
-    // Validate: exactly one of (feature, element) must be specified
-    if (ftype_id > 0 && felem_id > 0) || (ftype_id < 0 && felem_id < 0) {
-        return Err(SzConfigError::InvalidInput(
-            "Either a feature or an element must be specified, but not both".to_string(),
-        ));
-    }
-
-    // Determine exec_order: use provided value or get next available for this feature/element
-    let final_exec_order = if let Some(order) = params.exec_order {
-        // Check if this exec_order is already taken for this feature/element
-        let order_taken = config_data["G2_CONFIG"]["CFG_SFCALL"]
-            .as_array()
-            .map(|arr| {
-                arr.iter().any(|call| {
-                    call["FTYPE_ID"].as_i64() == Some(ftype_id)
-                        && call["FELEM_ID"].as_i64() == Some(felem_id)
-                        && call["EXEC_ORDER"].as_i64() == Some(order)
-                })
-            })
-            .unwrap_or(false);
-
-        if order_taken {
-            return Err(SzConfigError::AlreadyExists(format!(
-                "Execution order {} already taken for this feature/element",
-                order
-            )));
-        }
-        order
-    } else {
-        // Get next available exec_order for this feature/element combination
-        config_data["G2_CONFIG"]["CFG_SFCALL"]
-            .as_array()
-            .map(|arr| {
-                arr.iter()
-                    .filter(|call| {
-                        call["FTYPE_ID"].as_i64() == Some(ftype_id)
-                            && call["FELEM_ID"].as_i64() == Some(felem_id)
-                    })
-                    .filter_map(|call| call["EXEC_ORDER"].as_i64())
-                    .max()
-                    .map(|max| max + 1)
-                    .unwrap_or(1)
-            })
-            .unwrap_or(1)
-    };
-
-    // Create new CFG_SFCALL record
-    let new_record = json!({
-        "SFCALL_ID": sfcall_id,
-        "FTYPE_ID": ftype_id,
-        "FELEM_ID": felem_id,
-        "SFUNC_ID": sfunc_id,
-        "EXEC_ORDER": final_exec_order
-    });
-
-    // Add to config
-    if let Some(sfcall_array) = config_data["G2_CONFIG"]["CFG_SFCALL"].as_array_mut() {
-        sfcall_array.push(new_record.clone());
-    } else {
-        return Err(SzConfigError::MissingSection("CFG_SFCALL".to_string()));
-    }
-
-    let modified_config =
-        serde_json::to_string(&config_data).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    Ok((modified_config, new_record))
+    handle::edit_returning(config, |config| config.add_standardize_call(params))
 }
 
 /// Delete a standardize call by ID
@@ -203,31 +361,7 @@ pub fn add_standardize_call(
 /// # Errors
 /// - `NotFound` if call ID doesn't exist
 pub fn delete_standardize_call(config: &str, sfcall_id: i64) -> Result<String> {
-    let mut config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Validate that the call exists
-    let call_exists = config_data["G2_CONFIG"]["CFG_SFCALL"]
-        .as_array()
-        .map(|arr| {
-            arr.iter()
-                .any(|call| call["SFCALL_ID"].as_i64() == Some(sfcall_id))
-        })
-        .unwrap_or(false);
-
-    if !call_exists {
-        return Err(SzConfigError::NotFound(format!(
-            "Standardize call ID {}",
-            sfcall_id
-        )));
-    }
-
-    // Delete the standardize call
-    if let Some(sfcall_array) = config_data["G2_CONFIG"]["CFG_SFCALL"].as_array_mut() {
-        sfcall_array.retain(|record| record["SFCALL_ID"].as_i64() != Some(sfcall_id));
-    }
-
-    serde_json::to_string(&config_data).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config, |config| config.delete_standardize_call(sfcall_id))
 }
 
 /// Get a single standardize call by ID
@@ -242,8 +376,7 @@ pub fn delete_standardize_call(config: &str, sfcall_id: i64) -> Result<String> {
 /// # Errors
 /// - `NotFound` if call ID doesn't exist
 pub fn get_standardize_call(config: &str, sfcall_id: i64) -> Result<Value> {
-    find_in_config_array(config, "CFG_SFCALL", "SFCALL_ID", &sfcall_id.to_string())?
-        .ok_or_else(|| SzConfigError::NotFound(format!("Standardize call ID {}", sfcall_id)))
+    handle::read(config, |config| config.get_standardize_call(sfcall_id))
 }
 
 /// List all standardize calls with resolved names
@@ -256,92 +389,7 @@ pub fn get_standardize_call(config: &str, sfcall_id: i64) -> Result<Value> {
 /// # Returns
 /// Vector of JSON Values with resolved names (id, feature, element, execOrder, function)
 pub fn list_standardize_calls(config: &str) -> Result<Vec<Value>> {
-    let config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let empty_array = vec![];
-    let sfcall_array = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_SFCALL"))
-        .and_then(|v| v.as_array())
-        .unwrap_or(&empty_array);
-
-    let ftype_array = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_FTYPE"))
-        .and_then(|v| v.as_array())
-        .unwrap_or(&empty_array);
-
-    let felem_array = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_FELEM"))
-        .and_then(|v| v.as_array())
-        .unwrap_or(&empty_array);
-
-    let sfunc_array = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_SFUNC"))
-        .and_then(|v| v.as_array())
-        .unwrap_or(&empty_array);
-
-    // Helper functions for ID resolution
-    let resolve_ftype = |ftype_id: i64| -> String {
-        if ftype_id <= 0 {
-            "all".to_string()
-        } else {
-            ftype_array
-                .iter()
-                .find(|ft| ft.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(ftype_id))
-                .and_then(|ft| ft.get("FTYPE_CODE"))
-                .and_then(|v| v.as_str())
-                .unwrap_or("all")
-                .to_string()
-        }
-    };
-
-    let resolve_felem = |felem_id: i64| -> String {
-        if felem_id <= 0 {
-            "n/a".to_string()
-        } else {
-            felem_array
-                .iter()
-                .find(|fe| fe.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(felem_id))
-                .and_then(|fe| fe.get("FELEM_CODE"))
-                .and_then(|v| v.as_str())
-                .unwrap_or("n/a")
-                .to_string()
-        }
-    };
-
-    let resolve_sfunc = |sfunc_id: i64| -> String {
-        sfunc_array
-            .iter()
-            .find(|sf| sf.get("SFUNC_ID").and_then(|v| v.as_i64()) == Some(sfunc_id))
-            .and_then(|sf| sf.get("SFUNC_CODE"))
-            .and_then(|v| v.as_str())
-            .unwrap_or("unknown")
-            .to_string()
-    };
-
-    // Transform standardize calls
-    let items: Vec<Value> = sfcall_array
-        .iter()
-        .map(|item| {
-            let ftype_id = item.get("FTYPE_ID").and_then(|v| v.as_i64()).unwrap_or(0);
-            let felem_id = item.get("FELEM_ID").and_then(|v| v.as_i64()).unwrap_or(0);
-            let sfunc_id = item.get("SFUNC_ID").and_then(|v| v.as_i64()).unwrap_or(0);
-
-            json!({
-                "id": item.get("SFCALL_ID").and_then(|v| v.as_i64()).unwrap_or(0),
-                "feature": resolve_ftype(ftype_id),
-                "element": resolve_felem(felem_id),
-                "execOrder": item.get("EXEC_ORDER").and_then(|v| v.as_i64()).unwrap_or(0),
-                "function": resolve_sfunc(sfunc_id)
-            })
-        })
-        .collect();
-
-    Ok(items)
+    handle::read(config, |config| Ok(config.list_standardize_calls()))
 }
 
 /// Update a standardize call (stub - not implemented in Python)
@@ -371,58 +419,7 @@ pub fn add_standardize_call_element(
     config: &str,
     params: AddStandardizeCallElementParams,
 ) -> Result<(String, Value)> {
-    let mut config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let final_felem_id = params.felem_id.unwrap_or(-1);
-
-    // Check if call element already exists
-    if let Some(sfcall_array) = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_SFCALL"))
-        .and_then(|v| v.as_array())
-    {
-        for item in sfcall_array {
-            if item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(params.ftype_id)
-                && item.get("SFUNC_ID").and_then(|v| v.as_i64()) == Some(params.sfunc_id)
-                && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(final_felem_id)
-            {
-                return Err(SzConfigError::AlreadyExists(
-                    "Standardize call element already exists".to_string(),
-                ));
-            }
-        }
-    }
-
-    // Get next SFCALL_ID
-    let sfcall_id = get_next_id(&config_data, "G2_CONFIG.CFG_SFCALL", "SFCALL_ID", 1000)?;
-
-    // Create new call element record
-    let mut new_record = json!({
-        "SFCALL_ID": sfcall_id,
-        "FTYPE_ID": params.ftype_id,
-        "FELEM_ID": final_felem_id,
-        "SFUNC_ID": params.sfunc_id,
-    });
-
-    // Add optional exec_order if provided
-    if let Some(order) = params.exec_order {
-        if let Some(obj) = new_record.as_object_mut() {
-            obj.insert("EXEC_ORDER".to_string(), json!(order));
-        }
-    }
-
-    // Add to CFG_SFCALL
-    if let Some(sfcall_array) = config_data["G2_CONFIG"]["CFG_SFCALL"].as_array_mut() {
-        sfcall_array.push(new_record.clone());
-    } else {
-        return Err(SzConfigError::MissingSection("CFG_SFCALL".to_string()));
-    }
-
-    let modified_config =
-        serde_json::to_string(&config_data).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    Ok((modified_config, new_record))
+    handle::edit_returning(config, |config| config.add_standardize_call_element(params))
 }
 
 /// Delete a standardize call element
@@ -437,39 +434,9 @@ pub fn delete_standardize_call_element(
     config: &str,
     params: DeleteStandardizeCallElementParams,
 ) -> Result<String> {
-    let mut config_data: Value =
-        serde_json::from_str(config).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let final_felem_id = params.felem_id.unwrap_or(-1);
-
-    // Validate that the element exists
-    let element_exists = config_data["G2_CONFIG"]["CFG_SFCALL"]
-        .as_array()
-        .map(|arr| {
-            arr.iter().any(|item| {
-                item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(params.ftype_id)
-                    && item.get("SFUNC_ID").and_then(|v| v.as_i64()) == Some(params.sfunc_id)
-                    && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(final_felem_id)
-            })
-        })
-        .unwrap_or(false);
-
-    if !element_exists {
-        return Err(SzConfigError::NotFound(
-            "Standardize call element not found".to_string(),
-        ));
-    }
-
-    // Delete the element
-    if let Some(sfcall_array) = config_data["G2_CONFIG"]["CFG_SFCALL"].as_array_mut() {
-        sfcall_array.retain(|item| {
-            !(item.get("FTYPE_ID").and_then(|v| v.as_i64()) == Some(params.ftype_id)
-                && item.get("SFUNC_ID").and_then(|v| v.as_i64()) == Some(params.sfunc_id)
-                && item.get("FELEM_ID").and_then(|v| v.as_i64()) == Some(final_felem_id))
-        });
-    }
-
-    serde_json::to_string(&config_data).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config, |config| {
+        config.delete_standardize_call_element(params)
+    })
 }
 
 /// Update a standardize call element (stub - not typically used)
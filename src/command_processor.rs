@@ -30,15 +30,113 @@
 //! ```
 
 use crate::error::{Result, SzConfigError};
-use serde_json::Value;
+use crate::fingerprint::{Digest, Fingerprint, Hasher, Tokens};
+use crate::handle::ConfigHandle;
+use serde_json::{Value, json};
 use std::fs;
 use std::path::Path;
+use std::sync::OnceLock;
+use std::time::{Duration, Instant};
 
 /// Processes Senzing command scripts (.gtc files)
+///
+/// The configuration is parsed once, when the first command runs, and every
+/// command edits that parsed document in place. It is serialized again only
+/// at `save` lines and when the script finishes, so a script costs one parse
+/// and a handful of serializations regardless of its length.
 pub struct CommandProcessor {
-    config: String,
+    /// Configuration JSON as of the last serialization
+    config_json: String,
+    /// Parsed configuration, created on first use
+    config: Option<ConfigHandle>,
+    /// True when `config` has changes not yet written to `config_json`
+    dirty: bool,
+    /// `config` serialized by [`get_config`](Self::get_config) while dirty,
+    /// until the next mutable access
+    unsynced: OnceLock<String>,
     commands_executed: Vec<String>,
     dry_run: bool,
+    /// Roll back a failing script entirely instead of keeping its earlier lines
+    transactional: bool,
+    /// Per-command measurements of the last script, when profiling is enabled
+    profile: Option<ProfileReport>,
+    /// Configuration JSON bytes parsed so far
+    bytes_parsed: usize,
+    /// Configuration JSON bytes serialized so far
+    bytes_serialized: usize,
+}
+
+/// Measurements of one script line, recorded in profiling mode
+#[derive(Debug, Clone)]
+pub struct CommandProfile {
+    /// One-based line number in the script
+    pub line: usize,
+    /// Command name (`save` for save lines)
+    pub command: String,
+    /// Wall time spent on the line, including any parse or serialization
+    pub elapsed: Duration,
+    /// Configuration JSON bytes parsed (the first command parses the config)
+    pub bytes_parsed: usize,
+    /// Configuration JSON bytes serialized (`save` lines)
+    pub bytes_serialized: usize,
+    /// `G2_CONFIG` members the command accessed mutably, in name order
+    /// ("G2_CONFIG" if it accessed the whole document)
+    pub sections: Vec<String>,
+    /// Error message if the command failed
+    pub error: Option<String>,
+}
+
+/// Per-command profile of a script run (see [`CommandProcessor::profile`])
+#[derive(Debug, Clone, Default)]
+pub struct ProfileReport {
+    /// Time spent compiling the script
+    pub compile_time: Duration,
+    /// Script bytes compiled
+    pub script_bytes: usize,
+    /// One entry per command or `save` line that ran, in script order
+    pub commands: Vec<CommandProfile>,
+    /// Time spent on the final serialization after the last line
+    pub finish_time: Duration,
+    /// Configuration JSON bytes written by the final serialization
+    pub finish_bytes_serialized: usize,
+}
+
+impl ProfileReport {
+    /// Total time of the run (compile, commands and final serialization)
+    pub fn total_time(&self) -> Duration {
+        self.compile_time
+            + self.finish_time
+            + self.commands.iter().map(|c| c.elapsed).sum::<Duration>()
+    }
+
+    /// Report as JSON (times in microseconds)
+    ///
+    /// ```text
+    /// {"totalMicros": 1830, "compileMicros": 40, "scriptBytes": 512,
+    ///  "finishMicros": 600, "finishBytesSerialized": 130000,
+    ///  "commands": [{"line": 3, "command": "addFeature", "micros": 210,
+    ///                "bytesParsed": 130000, "bytesSerialized": 0,
+    ///                "sections": ["CFG_FBOM", "CFG_FTYPE"], "error": null}, ...]}
+    /// ```
+    pub fn to_json(&self) -> Value {
+        let micros = |d: Duration| d.as_micros() as u64;
+        json!({
+            "totalMicros": micros(self.total_time()),
+            "compileMicros": micros(self.compile_time),
+            "scriptBytes": self.script_bytes,
+            "finishMicros": micros(self.finish_time),
+            "finishBytesSerialized": self.finish_bytes_serialized,
+            "commands": self.commands.iter().map(|c| json!({
+                "line": c.line,
+                "command": c.command,
+                "micros": micros(c.elapsed),
+                "bytesParsed": c.bytes_parsed,
+                "bytesSerialized": c.bytes_serialized,
+                "sections": c.sections,
+                "error": c.error,
+            })).collect::<Vec<_>>(),
+        })
+    }
 }
 
 impl CommandProcessor {
@@ -48,9 +146,47 @@ impl CommandProcessor {
     /// * `config_json` - Initial configuration JSON string
     pub fn new(config_json: String) -> Self {
         Self {
-            config: config_json,
+            config_json,
+            config: None,
+            dirty: false,
+            unsynced: OnceLock::new(),
             commands_executed: Vec::new(),
             dry_run: false,
+            transactional: false,
+            profile: None,
+            bytes_parsed: 0,
+            bytes_serialized: 0,
+        }
+    }
+
+    /// Create a new processor from a configuration file
+    ///
+    /// The file is parsed through a buffered reader (see
+    /// [`handle::open_config_file`](crate::handle::open_config_file)).
+    ///
+    /// # Errors
+    /// - `InvalidConfig` if the file cannot be opened
+    /// - `JsonParse` if the content is invalid
+    pub fn from_config_file<P: AsRef<Path>>(path: P) -> Result<Self> {
+        Ok(Self::from_handle(crate::handle::open_config_file(path)?))
+    }
+
+    /// Create a new processor from an already parsed configuration
+    ///
+    /// # Arguments
+    /// * `config` - Initial configuration
+    pub fn from_handle(config: ConfigHandle) -> Self {
+        Self {
+            config_json: String::new(),
+            config: Some(config),
+            dirty: true,
+            unsynced: OnceLock::new(),
+            commands_executed: Vec::new(),
+            dry_run: false,
+            transactional: false,
+            profile: None,
+            bytes_parsed: 0,
+            bytes_serialized: 0,
         }
     }
 
@@ -65,6 +201,40 @@ impl CommandProcessor {
         self
     }
 
+    /// Enable or disable transactional mode
+    ///
+    /// In transactional mode a script that fails part-way is rolled back (see
+    /// [`crate::snapshot`]), so the configuration and the executed-command log
+    /// are as they were before the script. By default the commands before the
+    /// failing line remain applied.
+    ///
+    /// # Arguments
+    /// * `enabled` - true to enable transactional mode
+    pub fn transactional(mut self, enabled: bool) -> Self {
+        self.transactional = enabled;
+        self
+    }
+
+    /// Enable or disable profiling
+    ///
+    /// When enabled, each script run records the wall time, bytes parsed and
+    /// serialized, and sections touched of every line; read the result with
+    /// [`profile_report`](Self::profile_report).
+    ///
+    /// # Arguments
+    /// * `enabled` - true to enable profiling
+    pub fn profile(mut self, enabled: bool) -> Self {
+        self.profile = enabled.then(ProfileReport::default);
+        self
+    }
+
+    /// Profile of the last `process_script` / `process_file` call
+    ///
+    /// None unless profiling is enabled.
+    pub fn profile_report(&self) -> Option<&ProfileReport> {
+        self.profile.as_ref()
+    }
+
     /// Process a command script from a file
     ///
     /// # Arguments
@@ -81,57 +251,199 @@ impl CommandProcessor {
 
     /// Process a command script from a string
     ///
+    /// The script is compiled first, so a line with invalid syntax or
+    /// parameters fails the script before any command is applied.
+    ///
     /// # Arguments
     /// * `script` - Script content with line-based commands
     ///
     /// # Returns
     /// Modified configuration JSON string
     pub fn process_script(&mut self, script: &str) -> Result<String> {
-        for (line_num, line) in script.lines().enumerate() {
-            let trimmed = line.trim();
+        let compile_start = Instant::now();
+        let script_bytes = script.len();
+
+        // Reject the whole script before running any of it if a line is invalid
+        let script = CompiledScript::compile(script);
+        let steps = script.as_ref().map_or(&[][..], |s| s.steps.as_slice());
+
+        if let Some(profile) = &mut self.profile {
+            *profile = ProfileReport {
+                compile_time: compile_start.elapsed(),
+                script_bytes,
+                ..Default::default()
+            };
+        }
 
-            // Skip blank lines and comments
-            if trimmed.is_empty() || trimmed.starts_with('#') {
-                continue;
-            }
+        let checkpoint = match (&script, self.transactional && !self.dry_run) {
+            (Ok(_), true) => Some((self.handle()?.snapshot(), self.commands_executed.len())),
+            _ => None,
+        };
 
+        for step in steps {
             // Process command
-            if let Err(e) = self.process_command(trimmed) {
-                return Err(SzConfigError::InvalidConfig(format!(
-                    "Line {}: {} - Error: {}",
-                    line_num + 1,
-                    trimmed,
-                    e
-                )));
+            if let Err(e) = self.profile_step(step) {
+                if let Some((snapshot, executed)) = checkpoint {
+                    self.handle()?.rollback(snapshot)?;
+                    self.commands_executed.truncate(executed);
+                    // A `save` line may have serialized part of the script
+                    self.dirty = true;
+                }
+                // Keep get_config() in step with the commands that did succeed
+                self.finish()?;
+                return Err(e);
             }
 
             // Track executed command (skip "save" which is a no-op)
-            if trimmed != "save" {
+            if !matches!(step.command, Command::Save) {
                 self.commands_executed
-                    .push(format!("Line {}: {}", line_num + 1, trimmed));
+                    .push(format!("Line {}: {}", step.line_num + 1, step.text));
             }
         }
 
-        Ok(self.config.clone())
+        if let Some((snapshot, _)) = checkpoint {
+            self.handle()?.release(snapshot)?;
+        }
+        self.finish()?;
+        script?;
+        Ok(self.config_json.clone())
+    }
+
+    /// Process a command script and return the JSON Patch of its changes
+    ///
+    /// Runs the script like [`process_script`](Self::process_script); the
+    /// returned patch (see [`crate::patch`]) turns the configuration as it was
+    /// before the script into the result. In dry-run mode it is empty.
+    ///
+    /// The script runs under a [snapshot](crate::snapshot), so only the
+    /// sections it changes are copied and diffed.
+    ///
+    /// # Errors
+    /// As `process_script`. A failing script is always rolled back, as in
+    /// [transactional](Self::transactional) mode, so no change goes
+    /// unreported.
+    pub fn process_script_as_patch(&mut self, script: &str) -> Result<Value> {
+        let snapshot = self.handle()?.snapshot();
+        let executed = self.commands_executed.len();
+
+        if let Err(e) = self.process_script(script) {
+            self.handle()?.rollback(snapshot)?;
+            self.commands_executed.truncate(executed);
+            // A `save` line may have serialized part of the script
+            self.dirty = true;
+            self.finish()?;
+            return Err(e);
+        }
+
+        let config = self.handle()?;
+        let patch = config.patch_since(&snapshot)?;
+        config.release(snapshot)?;
+        Ok(patch)
+    }
+
+    /// Process a single compiled command, measuring it when profiling
+    fn profile_step(&mut self, step: &Step) -> Result<()> {
+        if self.profile.is_none() {
+            return self.process_step(step);
+        }
+
+        let (parsed, serialized) = (self.bytes_parsed, self.bytes_serialized);
+        let start = Instant::now();
+        let result = self.process_step(step);
+        let elapsed = start.elapsed();
+
+        let sections = self
+            .config
+            .as_mut()
+            .map(|config| config.take_touched_sections())
+            .unwrap_or_default();
+
+        let entry = CommandProfile {
+            line: step.line_num + 1,
+            command: step
+                .text
+                .split(|c: char| c.is_whitespace() || c == '{')
+                .next()
+                .unwrap_or("")
+                .to_string(),
+            elapsed,
+            bytes_parsed: self.bytes_parsed - parsed,
+            bytes_serialized: self.bytes_serialized - serialized,
+            sections,
+            error: result.as_ref().err().map(|e| e.to_string()),
+        };
+        if let Some(profile) = &mut self.profile {
+            profile.commands.push(entry);
+        }
+
+        result
+    }
+
+    /// Final serialization at the end of a script, measured when profiling
+    fn finish(&mut self) -> Result<()> {
+        let serialized = self.bytes_serialized;
+        let start = Instant::now();
+        let result = self.sync();
+
+        if let Some(profile) = &mut self.profile {
+            profile.finish_time = start.elapsed();
+            profile.finish_bytes_serialized = self.bytes_serialized - serialized;
+        }
+
+        result
     }
 
-    /// Process a single command line
-    fn process_command(&mut self, line: &str) -> Result<()> {
-        // Handle save command (no-op in library context)
-        if line == "save" {
-            return Ok(());
+    /// Process a single compiled command
+    fn process_step(&mut self, step: &Step) -> Result<()> {
+        // Handle save command (serialize pending changes)
+        if matches!(step.command, Command::Save) {
+            return self.sync();
+        }
+
+        let dry_run = self.dry_run;
+        let config = self
+            .handle()
+            .map_err(|e| line_error(step.line_num, &step.text, e))?;
+
+        // In dry-run mode, undo each command so the config is unchanged; only
+        // the sections it changed are copied
+        if dry_run {
+            let snapshot = config.snapshot();
+            let result = step.execute(config);
+            config.rollback(snapshot)?;
+            return result;
         }
 
-        let (cmd, params) = parse_command_line(line)?;
+        step.execute(config)?;
+        self.dirty = true;
 
-        // Execute command
-        let new_config = execute_command(&self.config, &cmd, &params)?;
+        Ok(())
+    }
 
-        // Update config unless dry-run
-        if !self.dry_run {
-            self.config = new_config;
+    /// Parsed configuration, parsing `config_json` on first use
+    fn handle(&mut self) -> Result<&mut ConfigHandle> {
+        self.unsynced.take();
+        if self.config.is_none() {
+            self.config = Some(ConfigHandle::from_json_with_spans(&self.config_json)?);
+            self.bytes_parsed += self.config_json.len();
+        }
+        let config = self.config.as_mut().expect("config parsed above");
+        if self.profile.is_some() {
+            config.record_touched_sections();
         }
+        Ok(config)
+    }
 
+    /// Serialize pending changes into `config_json`
+    fn sync(&mut self) -> Result<()> {
+        if self.dirty
+            && let Some(config) = &mut self.config
+        {
+            // Copies the sections unchanged since the previous sync
+            config.sync_json(&mut self.config_json)?;
+            self.bytes_serialized += self.config_json.len();
+            self.dirty = false;
+        }
         Ok(())
     }
 
@@ -150,550 +462,1148 @@ impl CommandProcessor {
     }
 
     /// Get current configuration
+    ///
+    /// Reflects every command applied by the last `process_script` or
+    /// `process_file` call. A processor created with
+    /// [`from_handle`](Self::from_handle) or
+    /// [`from_config_file`](Self::from_config_file) serializes its handle on
+    /// the first call before any script has run.
     pub fn get_config(&self) -> &str {
-        &self.config
+        match &self.config {
+            Some(config) if self.dirty => self.unsynced.get_or_init(|| {
+                // Serializing a parsed document cannot fail
+                config.to_json().unwrap_or_default()
+            }),
+            _ => &self.config_json,
+        }
     }
-}
-
-/// Parse a command line into (command_name, parameters)
-fn parse_command_line(line: &str) -> Result<(String, Value)> {
-    let parts: Vec<&str> = line.splitn(2, ' ').collect();
 
-    if parts.is_empty() {
-        return Err(SzConfigError::InvalidInput("Empty command".to_string()));
+    /// Save the current configuration to a file as compact JSON
+    ///
+    /// Once the configuration has been parsed it is streamed from the parsed
+    /// document to a buffered writer.
+    ///
+    /// # Errors
+    /// - `InvalidConfig` if the file cannot be written
+    pub fn save_config_file<P: AsRef<Path>>(&self, path: P) -> Result<()> {
+        match &self.config {
+            Some(config) => crate::handle::save_config_file(config, path),
+            None => fs::write(path.as_ref(), &self.config_json).map_err(|e| {
+                SzConfigError::InvalidConfig(format!(
+                    "Failed to write {}: {}",
+                    path.as_ref().display(),
+                    e
+                ))
+            }),
+        }
     }
+}
 
-    let cmd = parts[0].to_string();
+/// Apply a command script directly to a parsed configuration
+///
+/// Runs the same commands as [`CommandProcessor::process_script`] without
+/// any serialization (`save` lines are no-ops), for callers that already hold
+/// a [`ConfigHandle`]. Equivalent to compiling the script with
+/// [`CompiledScript::compile`] and applying it once.
+///
+/// # Arguments
+/// * `config` - Configuration to modify
+/// * `script` - Script content with line-based commands
+///
+/// # Returns
+/// Number of commands executed
+///
+/// # Errors
+/// `InvalidConfig` naming the first failing line. A line that cannot be
+/// compiled fails before anything is applied; if a command fails while
+/// running, the commands before it remain applied.
+///
+/// # Example
+/// ```
+/// use sz_configtool_lib::command_processor::apply_commands;
+/// use sz_configtool_lib::ConfigHandle;
+///
+/// let mut config = ConfigHandle::from_json(r#"{"G2_CONFIG":{"CFG_DSRC":[]}}"#)?;
+/// let err = apply_commands(&mut config, "save\nunknownCommand {}").unwrap_err();
+/// assert!(err.to_string().contains("Line 2"));
+/// # Ok::<(), sz_configtool_lib::SzConfigError>(())
+/// ```
+pub fn apply_commands(config: &mut ConfigHandle, script: &str) -> Result<usize> {
+    CompiledScript::compile(script)?.apply(config)
+}
 
-    let params = if parts.len() > 1 {
-        serde_json::from_str(parts[1])
-            .map_err(|e| SzConfigError::JsonParse(format!("Invalid JSON in '{}': {}", cmd, e)))?
-    } else {
-        Value::Null
-    };
+/// A command script validated and lowered once, ready to apply to many configs
+///
+/// [`compile`](Self::compile) parses every line, checks its parameters and
+/// converts it into a typed command, so syntax errors, unknown commands and
+/// missing parameters are reported before any configuration is touched.
+/// [`apply`](Self::apply) then runs the commands without any JSON parsing or
+/// command-name matching.
+///
+/// # Example
+/// ```
+/// use sz_configtool_lib::command_processor::CompiledScript;
+/// use sz_configtool_lib::ConfigHandle;
+///
+/// let script = CompiledScript::compile(r#"addConfigSection {"section": "CFG_TEST"}"#)?;
+///
+/// for json in [r#"{"G2_CONFIG":{}}"#, r#"{"G2_CONFIG":{"CFG_DSRC":[]}}"#] {
+///     let mut config = ConfigHandle::from_json(json)?;
+///     script.apply(&mut config)?;
+///     assert!(config.section("CFG_TEST").is_ok());
+/// }
+/// # Ok::<(), sz_configtool_lib::SzConfigError>(())
+/// ```
+#[derive(Debug, Clone)]
+pub struct CompiledScript {
+    steps: Vec<Step>,
+}
 
-    Ok((cmd, params))
+/// One compiled line of a script
+#[derive(Debug, Clone)]
+struct Step {
+    /// Zero-based line number in the script
+    line_num: usize,
+    /// Trimmed line text (for error messages and the executed-command log)
+    text: String,
+    command: Command,
 }
 
-/// Execute a command and return updated config
-fn execute_command(config: &str, cmd: &str, params: &Value) -> Result<String> {
-    match cmd {
-        // ===== Versioning Commands =====
-        "verifyCompatibilityVersion" => {
-            let expected = get_str_param(params, "expectedVersion")?;
-            crate::versioning::verify_compatibility_version(config, expected)?;
-            Ok(config.to_string()) // Verification only, no modification
-        }
+impl CompiledScript {
+    /// Validate and lower a command script
+    ///
+    /// # Arguments
+    /// * `script` - Script content with line-based commands
+    ///
+    /// # Errors
+    /// - `InvalidConfig` naming the first line that cannot be compiled
+    pub fn compile(script: &str) -> Result<Self> {
+        let mut steps = Vec::new();
 
-        "updateCompatibilityVersion" => {
-            // Note: Function only takes new version, ignores fromVersion
-            let to = get_str_param(params, "toVersion")?;
-            crate::versioning::update_compatibility_version(config, to)
-        }
+        for (line_num, line) in script.lines().enumerate() {
+            let trimmed = line.trim();
 
-        // ===== Config Section Commands =====
-        "removeConfigSection" => {
-            let section = get_str_param(params, "section")?;
-            crate::config_sections::remove_config_section(config, section)
-        }
+            // Skip blank lines and comments
+            if trimmed.is_empty() || trimmed.starts_with('#') {
+                continue;
+            }
 
-        "removeConfigSectionField" => {
-            let section = get_str_param(params, "section")?;
-            let field = get_str_param(params, "field")?;
-            crate::config_sections::remove_config_section_field(config, section, field)
-                .map(|(cfg, _)| cfg)
-        }
+            let command = if trimmed == "save" {
+                Command::Save
+            } else {
+                parse_command_line(trimmed)
+                    .and_then(|(cmd, params)| Command::compile(&cmd, &params))
+                    .map_err(|e| line_error(line_num, trimmed, e))?
+            };
 
-        "addConfigSection" => {
-            let section = get_str_param(params, "section")?;
-            // add_config_section only takes section name, creates empty array
-            crate::config_sections::add_config_section(config, section)
+            steps.push(Step {
+                line_num,
+                text: trimmed.to_string(),
+                command,
+            });
         }
 
-        "addConfigSectionField" => {
-            let section = get_str_param(params, "section")?;
-            let field = get_str_param(params, "field")?;
-            let value = &params["value"];
-            crate::config_sections::add_config_section_field(config, section, field, value)
-                .map(|(cfg, _)| cfg)
-        }
+        Ok(Self { steps })
+    }
 
-        // ===== Attribute Commands =====
-        "addAttribute" => {
-            let attr = get_str_param(params, "attribute")?;
-            let class = get_str_param(params, "class")?;
-            let feature = get_str_param(params, "feature")?;
-            let element = get_str_param(params, "element")?;
-            let required = get_opt_str_param(params, "required");
-            let internal = get_opt_str_param(params, "internal");
-            let default_value = get_opt_str_param(params, "default");
-
-            crate::attributes::add_attribute(
-                config,
-                crate::attributes::AddAttributeParams {
-                    attribute: attr,
-                    feature,
-                    element,
-                    class,
-                    default_value,
-                    internal,
-                    required,
-                },
-            )
-            .map(|(cfg, _)| cfg)
+    /// Run the script against a configuration
+    ///
+    /// # Returns
+    /// Number of commands executed (`save` lines are not counted)
+    ///
+    /// # Errors
+    /// - `InvalidConfig` naming the first failing line; commands before it
+    ///   remain applied
+    pub fn apply(&self, config: &mut ConfigHandle) -> Result<usize> {
+        let mut executed = 0;
+        for step in &self.steps {
+            if !matches!(step.command, Command::Save) {
+                step.execute(config)?;
+                executed += 1;
+            }
         }
+        Ok(executed)
+    }
 
-        "deleteAttribute" => {
-            let attr = get_str_param(params, "attribute")?;
-            crate::attributes::delete_attribute(config, attr)
-        }
+    /// Run the script as a transaction: all commands are applied or none
+    ///
+    /// # Returns
+    /// Number of commands executed (`save` lines are not counted)
+    ///
+    /// # Errors
+    /// - `InvalidConfig` naming the first failing line; the configuration is
+    ///   rolled back to its state before the script
+    pub fn apply_atomic(&self, config: &mut ConfigHandle) -> Result<usize> {
+        config.transaction(|config| self.apply(config))
+    }
 
-        "setAttribute" => {
-            let set_params = crate::attributes::SetAttributeParams::try_from(params)?;
-            crate::attributes::set_attribute(config, set_params)
-        }
+    /// Number of commands in the script (excluding `save` lines)
+    pub fn len(&self) -> usize {
+        self.steps
+            .iter()
+            .filter(|s| !matches!(s.command, Command::Save))
+            .count()
+    }
 
-        // ===== Element Commands =====
-        "addElement" => {
-            let element = get_str_param(params, "element")?;
-            let datatype = get_opt_str_param(params, "datatype");
+    /// True if the script has no commands
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
 
-            let add_params = crate::elements::AddElementParams {
-                code: element,
-                description: None, // Will default to code
-                data_type: datatype,
-                tokenized: None,
-            };
+    /// Fingerprint of the compiled lines and their line numbers
+    ///
+    /// Blank lines, comments and surrounding whitespace don't count; line
+    /// numbers do, since they appear in error messages.
+    pub fn fingerprint(&self) -> Fingerprint {
+        let mut hasher = Hasher::default();
+        self.tokens(&mut hasher);
+        hasher.finish()
+    }
 
-            crate::elements::add_element(config, add_params)
+    /// SHA-256 of the same content as [`fingerprint`](Self::fingerprint)
+    pub(crate) fn digest(&self) -> Digest {
+        Digest::of_tokens(|sha| self.tokens(sha))
+    }
+
+    fn tokens(&self, out: &mut dyn Tokens) {
+        out.word(self.steps.len() as u64);
+        for step in &self.steps {
+            out.word(step.line_num as u64);
+            out.str(&step.text);
         }
+    }
+}
 
-        "setFeatureElement" => {
-            let feature = get_str_param(params, "feature")?;
-            let element = get_str_param(params, "element")?;
+impl Step {
+    fn execute(&self, config: &mut ConfigHandle) -> Result<()> {
+        self.command
+            .execute(config)
+            .map_err(|e| line_error(self.line_num, &self.text, e))
+    }
+}
 
-            // Check which property to set
-            if let Some(derived) = get_opt_str_param(params, "derived") {
-                crate::elements::set_feature_element_derived(config, feature, element, derived)
-            } else if let Some(display_level) = params.get("displayLevel").and_then(|v| v.as_i64())
-            {
-                crate::elements::set_feature_element_display_level(
-                    config,
-                    feature,
-                    element,
-                    display_level,
-                )
-            } else {
-                Err(SzConfigError::InvalidInput(
-                    "setFeatureElement requires 'derived' or 'displayLevel'".to_string(),
-                ))
-            }
-        }
+/// A script command with its parameters already extracted
+#[derive(Debug, Clone)]
+enum Command {
+    Save,
+    VerifyCompatibilityVersion {
+        expected: String,
+    },
+    UpdateCompatibilityVersion {
+        to: String,
+    },
+    RemoveConfigSection {
+        section: String,
+    },
+    RemoveConfigSectionField {
+        section: String,
+        field: String,
+    },
+    AddConfigSection {
+        section: String,
+    },
+    AddConfigSectionField {
+        section: String,
+        field: String,
+        value: Value,
+    },
+    AddAttribute {
+        attribute: String,
+        feature: String,
+        element: String,
+        class: String,
+        default_value: Option<String>,
+        internal: Option<String>,
+        required: Option<String>,
+    },
+    DeleteAttribute {
+        attribute: String,
+    },
+    SetAttribute {
+        attribute: String,
+        internal: Option<String>,
+        required: Option<String>,
+        default_value: Option<String>,
+    },
+    AddElement {
+        element: String,
+        data_type: Option<String>,
+    },
+    SetFeatureElementDerived {
+        feature: String,
+        element: String,
+        derived: String,
+    },
+    SetFeatureElementDisplayLevel {
+        feature: String,
+        element: String,
+        display_level: i64,
+    },
+    AddFeature(Box<AddFeatureCommand>),
+    SetFeature(Box<SetFeatureCommand>),
+    AddBehaviorOverride {
+        feature: String,
+        usage_type: String,
+        behavior: String,
+    },
+    DeleteFragment {
+        fragment: String,
+    },
+    SetFragment {
+        fragment: String,
+        fragment_config: Value,
+    },
+    AddFragment {
+        fragment_config: Value,
+    },
+    AddRule {
+        rule_config: Value,
+    },
+    SetRule {
+        code: String,
+        resolve: Option<String>,
+        relate: Option<String>,
+        rtype_id: Option<i64>,
+    },
+    SetSetting {
+        name: String,
+        value: Value,
+    },
+    DeleteStandardizeFunction {
+        function: String,
+    },
+    AddStandardizeFunction {
+        function: String,
+        connect_str: String,
+        description: Option<String>,
+        language: Option<String>,
+    },
+    DeleteComparisonFunction {
+        function: String,
+    },
+    AddComparisonFunction {
+        function: String,
+        connect_str: String,
+        description: Option<String>,
+        anon_support: Option<String>,
+    },
+    AddExpressionFunction {
+        function: String,
+        connect_str: String,
+        description: Option<String>,
+        language: Option<String>,
+    },
+    AddComparisonThreshold {
+        function: String,
+        /// None for "ALL"
+        feature: Option<String>,
+        score_name: String,
+        scores: [Option<i64>; 5],
+    },
+    AddGenericThreshold {
+        plan: Option<String>,
+        behavior: Option<String>,
+        scoring_cap: Option<i64>,
+        candidate_cap: Option<i64>,
+        send_to_redo: Option<String>,
+        feature: Option<String>,
+    },
+    CloneGenericPlan {
+        existing_plan: String,
+        new_plan: String,
+        description: Option<String>,
+        thresholds: Vec<ThresholdOverrideCommand>,
+    },
+    AddExpressionCall {
+        feature: String,
+        function: String,
+        exec_order: Option<i64>,
+        expression_feature: Option<String>,
+        is_virtual: String,
+        element_list: Vec<(String, String, Option<String>)>,
+    },
+    DeleteComparisonCallElement {
+        feature: String,
+        element: String,
+    },
+    AddComparisonCallElement {
+        feature: String,
+        element: String,
+    },
+    DeleteDistinctCallElement {
+        feature: String,
+        element: String,
+    },
+}
 
-        // ===== Feature Commands =====
-        "addFeature" => {
-            let feature = get_str_param(params, "feature")?;
-            let element_list = params
-                .get("elementList")
-                .ok_or_else(|| SzConfigError::MissingField("elementList".to_string()))?;
+/// Owned fields of [`crate::features::AddFeatureParams`]
+#[derive(Debug, Clone)]
+struct AddFeatureCommand {
+    feature: String,
+    element_list: Value,
+    class: Option<String>,
+    behavior: Option<String>,
+    candidates: Option<String>,
+    anonymize: Option<String>,
+    derived: Option<String>,
+    history: Option<String>,
+    matchkey: Option<String>,
+    standardize: Option<String>,
+    expression: Option<String>,
+    comparison: Option<String>,
+    version: Option<i64>,
+    rtype_id: Option<i64>,
+}
 
-            crate::features::add_feature(
-                config,
-                crate::features::AddFeatureParams {
-                    feature,
-                    element_list,
-                    class: get_opt_str_param(params, "class"),
-                    behavior: get_opt_str_param(params, "behavior"),
-                    candidates: get_opt_str_param(params, "candidates"),
-                    anonymize: get_opt_str_param(params, "anonymize"),
-                    derived: get_opt_str_param(params, "derived"),
-                    history: get_opt_str_param(params, "history"),
-                    matchkey: get_opt_str_param(params, "matchKey"),
-                    standardize: get_opt_str_param(params, "standardize").filter(|s| !s.is_empty()),
-                    expression: get_opt_str_param(params, "expression").filter(|s| !s.is_empty()),
-                    comparison: get_opt_str_param(params, "comparison").filter(|s| !s.is_empty()),
-                    version: params.get("version").and_then(|v| v.as_i64()),
-                    rtype_id: params.get("rtypeId").and_then(|v| v.as_i64()),
-                },
-            )
-        }
+/// Owned fields of [`crate::generic_plans::GenericThresholdOverride`]
+#[derive(Debug, Clone)]
+struct ThresholdOverrideCommand {
+    behavior: String,
+    feature: Option<String>,
+    candidate_cap: Option<i64>,
+    scoring_cap: Option<i64>,
+    send_to_redo: Option<String>,
+}
 
-        "setFeature" => {
-            let feature = get_str_param(params, "feature")?;
+/// Owned fields of [`crate::features::SetFeatureParams`]
+#[derive(Debug, Clone)]
+struct SetFeatureCommand {
+    feature: String,
+    candidates: Option<String>,
+    anonymize: Option<String>,
+    derived: Option<String>,
+    history: Option<String>,
+    matchkey: Option<String>,
+    behavior: Option<String>,
+    class: Option<String>,
+    version: Option<i64>,
+    rtype_id: Option<i64>,
+}
 
-            crate::features::set_feature(
-                config,
-                crate::features::SetFeatureParams {
-                    feature,
-                    candidates: get_opt_str_param(params, "candidates"),
-                    anonymize: get_opt_str_param(params, "anonymize"),
-                    derived: get_opt_str_param(params, "derived"),
-                    history: get_opt_str_param(params, "history"),
-                    matchkey: get_opt_str_param(params, "matchKey"),
-                    behavior: get_opt_str_param(params, "behavior"),
-                    class: get_opt_str_param(params, "class"),
-                    version: params.get("version").and_then(|v| v.as_i64()),
-                    rtype_id: params.get("rtypeId").and_then(|v| v.as_i64()),
-                },
-            )
-        }
+impl Command {
+    /// Lower a parsed command line into a typed command
+    fn compile(cmd: &str, params: &Value) -> Result<Self> {
+        let str_param = |key: &str| get_str_param(params, key).map(str::to_string);
+        let opt_param = |key: &str| get_opt_str_param(params, key).map(str::to_string);
+        let int_param = |key: &str| params.get(key).and_then(|v| v.as_i64());
 
-        // ===== Behavior Override Commands =====
-        "addBehaviorOverride" => {
-            let feature = get_str_param(params, "feature")?;
-            let usage_type = get_str_param(params, "usageType")?;
-            let behavior = get_str_param(params, "behavior")?;
+        Ok(match cmd {
+            // ===== Versioning Commands =====
+            "verifyCompatibilityVersion" => Command::VerifyCompatibilityVersion {
+                expected: str_param("expectedVersion")?,
+            },
 
-            crate::behavior_overrides::add_behavior_override(
-                config,
-                crate::behavior_overrides::AddBehaviorOverrideParams::new(
-                    feature, usage_type, behavior,
-                ),
-            )
-        }
+            // Note: Function only takes new version, ignores fromVersion
+            "updateCompatibilityVersion" => Command::UpdateCompatibilityVersion {
+                to: str_param("toVersion")?,
+            },
 
-        // ===== Fragment Commands =====
-        "deleteFragment" => {
-            let fragment = get_str_param(params, "fragment").or_else(|_| {
-                // Support old format: deleteFragment FRAGMENT_NAME
-                params
-                    .as_str()
-                    .ok_or_else(|| SzConfigError::MissingField("fragment".to_string()))
-            })?;
-            crate::fragments::delete_fragment(config, fragment)
-        }
+            // ===== Config Section Commands =====
+            "removeConfigSection" => Command::RemoveConfigSection {
+                section: str_param("section")?,
+            },
 
-        "setFragment" => {
-            let fragment = get_str_param(params, "fragment")?;
-            let source = get_str_param(params, "source")?;
+            "removeConfigSectionField" => Command::RemoveConfigSectionField {
+                section: str_param("section")?,
+                field: str_param("field")?,
+            },
 
-            // Construct fragment config with ERFRAG_SOURCE
-            let fragment_config = serde_json::json!({
-                "ERFRAG_SOURCE": source
-            });
+            // add_config_section only takes section name, creates empty array
+            "addConfigSection" => Command::AddConfigSection {
+                section: str_param("section")?,
+            },
+
+            "addConfigSectionField" => Command::AddConfigSectionField {
+                section: str_param("section")?,
+                field: str_param("field")?,
+                value: params["value"].clone(),
+            },
+
+            // ===== Attribute Commands =====
+            "addAttribute" => Command::AddAttribute {
+                attribute: str_param("attribute")?,
+                class: str_param("class")?,
+                feature: str_param("feature")?,
+                element: str_param("element")?,
+                required: opt_param("required"),
+                internal: opt_param("internal"),
+                default_value: opt_param("default"),
+            },
+
+            "deleteAttribute" => Command::DeleteAttribute {
+                attribute: str_param("attribute")?,
+            },
+
+            "setAttribute" => {
+                let set_params = crate::attributes::SetAttributeParams::try_from(params)?;
+                Command::SetAttribute {
+                    attribute: set_params.attribute.to_string(),
+                    internal: set_params.internal.map(str::to_string),
+                    required: set_params.required.map(str::to_string),
+                    default_value: set_params.default_value.map(str::to_string),
+                }
+            }
 
-            crate::fragments::set_fragment(config, fragment, &fragment_config)
-        }
+            // ===== Element Commands =====
+            "addElement" => Command::AddElement {
+                element: str_param("element")?,
+                data_type: opt_param("datatype"),
+            },
+
+            "setFeatureElement" => {
+                let feature = str_param("feature")?;
+                let element = str_param("element")?;
+
+                // Check which property to set
+                if let Some(derived) = opt_param("derived") {
+                    Command::SetFeatureElementDerived {
+                        feature,
+                        element,
+                        derived,
+                    }
+                } else if let Some(display_level) = int_param("displayLevel") {
+                    Command::SetFeatureElementDisplayLevel {
+                        feature,
+                        element,
+                        display_level,
+                    }
+                } else {
+                    return Err(SzConfigError::InvalidInput(
+                        "setFeatureElement requires 'derived' or 'displayLevel'".to_string(),
+                    ));
+                }
+            }
+
+            // ===== Feature Commands =====
+            "addFeature" => Command::AddFeature(Box::new(AddFeatureCommand {
+                feature: str_param("feature")?,
+                element_list: params
+                    .get("elementList")
+                    .cloned()
+                    .ok_or_else(|| SzConfigError::MissingField("elementList".to_string()))?,
+                class: opt_param("class"),
+                behavior: opt_param("behavior"),
+                candidates: opt_param("candidates"),
+                anonymize: opt_param("anonymize"),
+                derived: opt_param("derived"),
+                history: opt_param("history"),
+                matchkey: opt_param("matchKey"),
+                standardize: opt_param("standardize").filter(|s| !s.is_empty()),
+                expression: opt_param("expression").filter(|s| !s.is_empty()),
+                comparison: opt_param("comparison").filter(|s| !s.is_empty()),
+                version: int_param("version"),
+                rtype_id: int_param("rtypeId"),
+            })),
+
+            "setFeature" => Command::SetFeature(Box::new(SetFeatureCommand {
+                feature: str_param("feature")?,
+                candidates: opt_param("candidates"),
+                anonymize: opt_param("anonymize"),
+                derived: opt_param("derived"),
+                history: opt_param("history"),
+                matchkey: opt_param("matchKey"),
+                behavior: opt_param("behavior"),
+                class: opt_param("class"),
+                version: int_param("version"),
+                rtype_id: int_param("rtypeId"),
+            })),
+
+            // ===== Behavior Override Commands =====
+            "addBehaviorOverride" => Command::AddBehaviorOverride {
+                feature: str_param("feature")?,
+                usage_type: str_param("usageType")?,
+                behavior: str_param("behavior")?,
+            },
+
+            // ===== Fragment Commands =====
+            "deleteFragment" => {
+                let fragment = get_str_param(params, "fragment").or_else(|_| {
+                    // Support old format: deleteFragment FRAGMENT_NAME
+                    params
+                        .as_str()
+                        .ok_or_else(|| SzConfigError::MissingField("fragment".to_string()))
+                })?;
+                Command::DeleteFragment {
+                    fragment: fragment.to_string(),
+                }
+            }
+
+            // Construct fragment config with ERFRAG_SOURCE
+            "setFragment" => Command::SetFragment {
+                fragment: str_param("fragment")?,
+                fragment_config: serde_json::json!({
+                    "ERFRAG_SOURCE": str_param("source")?
+                }),
+            },
 
-        "addFragment" => {
             // add_fragment takes a full fragment config as Value
-            crate::fragments::add_fragment(config, params).map(|(cfg, _)| cfg)
-        }
+            "addFragment" => Command::AddFragment {
+                fragment_config: params.clone(),
+            },
+
+            // ===== Rule Commands =====
+            "addRule" => Command::AddRule {
+                rule_config: params.clone(),
+            },
+
+            "setRule" => {
+                let set_params = crate::rules::SetRuleParams::try_from(params)?;
+                Command::SetRule {
+                    code: set_params.code.to_string(),
+                    resolve: set_params.resolve.map(str::to_string),
+                    relate: set_params.relate.map(str::to_string),
+                    rtype_id: set_params.rtype_id,
+                }
+            }
 
-        // ===== Rule Commands =====
-        "addRule" => crate::rules::add_rule(config, params).map(|(cfg, _)| cfg),
+            // ===== System Parameter Commands =====
+            "setSetting" => Command::SetSetting {
+                name: str_param("name")?,
+                value: params["value"].clone(),
+            },
+
+            // ===== Function Commands - Standardize =====
+            "removeStandardizeFunction" | "deleteStandardizeFunction" => {
+                Command::DeleteStandardizeFunction {
+                    function: str_param("function")?,
+                }
+            }
 
-        "setRule" => {
-            let set_params = crate::rules::SetRuleParams::try_from(params)?;
-            crate::rules::set_rule(config, set_params)
-        }
+            "addStandardizeFunction" => Command::AddStandardizeFunction {
+                function: str_param("function")?,
+                connect_str: str_param("connectStr")?,
+                description: opt_param("description"),
+                language: opt_param("language"),
+            },
+
+            // ===== Function Commands - Comparison =====
+            "removeComparisonFunction" | "deleteComparisonFunction" => {
+                Command::DeleteComparisonFunction {
+                    function: str_param("function")?,
+                }
+            }
 
-        // ===== System Parameter Commands =====
-        "setSetting" => {
-            let name = get_str_param(params, "name")?;
-            let value = &params["value"];
-            crate::system_params::set_system_parameter(config, name, value)
-        }
+            "addComparisonFunction" => Command::AddComparisonFunction {
+                function: str_param("function")?,
+                connect_str: str_param("connectStr")?,
+                description: opt_param("description"),
+                anon_support: opt_param("anonSupport"),
+            },
+
+            // ===== Function Commands - Expression =====
+            "addExpressionFunction" => Command::AddExpressionFunction {
+                function: str_param("function")?,
+                connect_str: str_param("connectStr")?,
+                description: opt_param("description"),
+                language: opt_param("language"),
+            },
+
+            // ===== Threshold Commands =====
+            "addComparisonThreshold" => {
+                let function = str_param("function")?;
+                let feature = str_param("feature")?;
+                Command::AddComparisonThreshold {
+                    function,
+                    feature: (!feature.eq_ignore_ascii_case("ALL")).then_some(feature),
+                    score_name: str_param("scoreName")?,
+                    scores: [
+                        int_param("sameScore"),
+                        int_param("closeScore"),
+                        int_param("likelyScore"),
+                        int_param("plausibleScore"),
+                        int_param("unlikelyScore"),
+                    ],
+                }
+            }
 
-        // ===== Function Commands - Standardize =====
-        "removeStandardizeFunction" | "deleteStandardizeFunction" => {
-            let func = get_str_param(params, "function")?;
-            crate::functions::standardize::delete_standardize_function(config, func)
-                .map(|(cfg, _)| cfg)
-        }
+            "addGenericThreshold" => {
+                let t = crate::thresholds::AddGenericThresholdParams::try_from(params)?;
+                Command::AddGenericThreshold {
+                    plan: t.plan.map(str::to_string),
+                    behavior: t.behavior.map(str::to_string),
+                    scoring_cap: t.scoring_cap,
+                    candidate_cap: t.candidate_cap,
+                    send_to_redo: t.send_to_redo.map(str::to_string),
+                    feature: t.feature.map(str::to_string),
+                }
+            }
 
-        "addStandardizeFunction" => {
-            let func = get_str_param(params, "function")?;
-            let connect = get_str_param(params, "connectStr")?;
-            let desc = get_opt_str_param(params, "description");
-            let language = get_opt_str_param(params, "language");
-
-            crate::functions::standardize::add_standardize_function(
-                config,
-                func,
-                crate::functions::standardize::AddStandardizeFunctionParams {
-                    connect_str: connect,
-                    description: desc,
-                    language,
-                },
-            )
-            .map(|(cfg, _)| cfg)
-        }
+            // "thresholds" (optional): overrides applied to the clone, see
+            // GenericThresholdOverride
+            "cloneGenericPlan" => {
+                let thresholds = match params.get("thresholds") {
+                    None | Some(Value::Null) => Vec::new(),
+                    Some(Value::Array(items)) => items
+                        .iter()
+                        .map(|item| {
+                            let t = crate::generic_plans::GenericThresholdOverride::try_from(item)?;
+                            Ok(ThresholdOverrideCommand {
+                                behavior: t.behavior.to_string(),
+                                feature: t.feature.map(str::to_string),
+                                candidate_cap: t.candidate_cap,
+                                scoring_cap: t.scoring_cap,
+                                send_to_redo: t.send_to_redo.map(str::to_string),
+                            })
+                        })
+                        .collect::<Result<_>>()?,
+                    Some(_) => {
+                        return Err(SzConfigError::InvalidInput(
+                            "thresholds must be an array".to_string(),
+                        ));
+                    }
+                };
+                Command::CloneGenericPlan {
+                    existing_plan: str_param("existingPlan")?,
+                    new_plan: str_param("newPlan")?,
+                    description: opt_param("newDescription"),
+                    thresholds,
+                }
+            }
 
-        // ===== Function Commands - Comparison =====
-        "removeComparisonFunction" | "deleteComparisonFunction" => {
-            let func = get_str_param(params, "function")?;
-            crate::functions::comparison::delete_comparison_function(config, func)
-                .map(|(cfg, _)| cfg)
-        }
+            // ===== Call Commands - Expression =====
+            "addExpressionCall" => {
+                let feature = str_param("feature")?;
+                let function = str_param("function")?;
+                let element_list_json = params
+                    .get("elementList")
+                    .ok_or_else(|| SzConfigError::MissingField("elementList".to_string()))?;
 
-        "addComparisonFunction" => {
-            let func = get_str_param(params, "function")?;
-            let connect = get_str_param(params, "connectStr")?;
-            let anon = get_opt_str_param(params, "anonSupport");
-            let desc = get_opt_str_param(params, "description");
-
-            crate::functions::comparison::add_comparison_function(
-                config,
-                func,
-                crate::functions::comparison::AddComparisonFunctionParams {
-                    connect_str: connect,
-                    description: desc,
-                    language: None,
-                    anon_support: anon,
-                },
-            )
-            .map(|(cfg, _)| cfg)
-        }
+                // Parse elementList: [{"element": "NAME", "required": "Yes", "feature": "NAME"}, ...]
+                Command::AddExpressionCall {
+                    feature,
+                    function,
+                    exec_order: int_param("execOrder"),
+                    expression_feature: opt_param("expressionFeature"),
+                    is_virtual: opt_param("virtual").unwrap_or_else(|| "No".to_string()),
+                    element_list: parse_element_list(element_list_json)?,
+                }
+            }
 
-        // ===== Function Commands - Expression =====
-        "addExpressionFunction" => {
-            let func = get_str_param(params, "function")?;
-            let connect = get_str_param(params, "connectStr")?;
-            let desc = get_opt_str_param(params, "description");
-            let language = get_opt_str_param(params, "language");
-
-            crate::functions::expression::add_expression_function(
-                config,
-                func,
-                crate::functions::expression::AddExpressionFunctionParams {
-                    connect_str: connect,
-                    description: desc,
-                    language,
-                },
-            )
-            .map(|(cfg, _)| cfg)
-        }
+            // ===== Call Commands - Comparison and Distinct =====
+            "deleteComparisonCallElement" => Command::DeleteComparisonCallElement {
+                feature: str_param("feature")?,
+                element: str_param("element")?,
+            },
+
+            "addComparisonCallElement" => Command::AddComparisonCallElement {
+                feature: str_param("feature")?,
+                element: str_param("element")?,
+            },
+
+            "deleteDistinctCallElement" => Command::DeleteDistinctCallElement {
+                feature: str_param("feature")?,
+                element: str_param("element")?,
+            },
+
+            // ===== No-op Commands =====
+            "save" => Command::Save,
+
+            // ===== Unknown Command =====
+            _ => {
+                return Err(SzConfigError::InvalidInput(format!(
+                    "Unknown command: '{}'",
+                    cmd
+                )));
+            }
+        })
+    }
 
-        // ===== Threshold Commands =====
-        "addComparisonThreshold" => {
-            let func = get_str_param(params, "function")?;
-            let feature = get_str_param(params, "feature")?;
-            let score_name = get_str_param(params, "scoreName")?;
-            let same = params.get("sameScore").and_then(|v| v.as_i64());
-            let close = params.get("closeScore").and_then(|v| v.as_i64());
-            let likely = params.get("likelyScore").and_then(|v| v.as_i64());
-            let plausible = params.get("plausibleScore").and_then(|v| v.as_i64());
-            let unlikely = params.get("unlikelyScore").and_then(|v| v.as_i64());
-
-            crate::thresholds::add_comparison_threshold(
-                config,
-                crate::thresholds::AddComparisonThresholdParams {
-                    cfunc_code: Some(func),
-                    ftype_code: if feature.eq_ignore_ascii_case("ALL") {
-                        None
-                    } else {
-                        Some(feature)
-                    },
-                    cfunc_rtnval: Some(score_name),
-                    exec_order: None,
-                    same_score: same,
-                    close_score: close,
-                    likely_score: likely,
-                    plausible_score: plausible,
-                    un_likely_score: unlikely,
-                },
-            )
-        }
+    /// Run the command against the parsed configuration
+    fn execute(&self, config: &mut ConfigHandle) -> Result<()> {
+        match self {
+            Command::Save => Ok(()),
 
-        "addGenericThreshold" => {
-            let threshold_params = crate::thresholds::AddGenericThresholdParams::try_from(params)?;
-            crate::thresholds::add_generic_threshold(config, threshold_params)
-        }
+            // ===== Versioning Commands =====
+            Command::VerifyCompatibilityVersion { expected } => {
+                config.verify_compatibility_version(expected)?;
+                Ok(()) // Verification only, no modification
+            }
 
-        // ===== Call Commands - Expression =====
-        "addExpressionCall" => {
-            let feature = get_str_param(params, "feature")?;
-            let function = get_str_param(params, "function")?;
-            let exec_order = params.get("execOrder").and_then(|v| v.as_i64());
-            let expr_feature = get_opt_str_param(params, "expressionFeature");
-            let virtual_flag = get_opt_str_param(params, "virtual").unwrap_or("No");
-            let element_list_json = params
-                .get("elementList")
-                .ok_or_else(|| SzConfigError::MissingField("elementList".to_string()))?;
-
-            // Parse elementList: [{"element": "NAME", "required": "Yes", "feature": "NAME"}, ...]
-            let element_list = parse_element_list(element_list_json)?;
-
-            let call_params = crate::calls::expression::AddExpressionCallParams {
-                efunc_code: function,
-                element_list,
-                ftype_code: Some(feature),
-                felem_code: None,
-                exec_order,
-                expression_feature: expr_feature,
-                is_virtual: virtual_flag,
-            };
+            Command::UpdateCompatibilityVersion { to } => config.update_compatibility_version(to),
 
-            let (new_config, _) =
-                crate::calls::expression::add_expression_call(config, call_params)?;
+            // ===== Config Section Commands =====
+            Command::RemoveConfigSection { section } => config.remove_config_section(section),
 
-            Ok(new_config)
-        }
+            Command::RemoveConfigSectionField { section, field } => {
+                config.remove_config_section_field(section, field)?;
+                Ok(())
+            }
 
-        // ===== Call Commands - Comparison =====
-        "deleteComparisonCallElement" => {
-            let feature = get_str_param(params, "feature")?;
-            let element = get_str_param(params, "element")?;
-
-            // Lookup IDs
-            let ftype_id = crate::helpers::lookup_feature_id(config, feature)?;
-            let felem_id = crate::helpers::lookup_element_id(config, element)?;
-
-            // Find the cfcall_id for this feature
-            let config_val: Value = serde_json::from_str(config)?;
-            let cfcall_array = config_val["G2_CONFIG"]["CFG_CFCALL"]
-                .as_array()
-                .ok_or_else(|| SzConfigError::MissingSection("CFG_CFCALL".to_string()))?;
-
-            // Find comparison call for this feature
-            let cfcall = cfcall_array
-                .iter()
-                .find(|call| call["FTYPE_ID"].as_i64() == Some(ftype_id))
-                .ok_or_else(|| {
-                    SzConfigError::NotFound(format!(
-                        "No comparison call found for feature {}",
-                        feature
-                    ))
+            Command::AddConfigSection { section } => config.add_config_section(section),
+
+            Command::AddConfigSectionField {
+                section,
+                field,
+                value,
+            } => {
+                config.add_config_section_field(section, field, value)?;
+                Ok(())
+            }
+
+            // ===== Attribute Commands =====
+            Command::AddAttribute {
+                attribute,
+                feature,
+                element,
+                class,
+                default_value,
+                internal,
+                required,
+            } => {
+                config.add_attribute(crate::attributes::AddAttributeParams {
+                    attribute,
+                    feature,
+                    element,
+                    class,
+                    default_value: default_value.as_deref(),
+                    internal: internal.as_deref(),
+                    required: required.as_deref(),
                 })?;
+                Ok(())
+            }
 
-            let cfcall_id = cfcall["CFCALL_ID"]
-                .as_i64()
-                .ok_or_else(|| SzConfigError::InvalidStructure("CFCALL_ID missing".to_string()))?;
-
-            // Find exec_order from CFBOM
-            let cfbom_array = config_val["G2_CONFIG"]["CFG_CFBOM"]
-                .as_array()
-                .ok_or_else(|| SzConfigError::MissingSection("CFG_CFBOM".to_string()))?;
-
-            let cfbom = cfbom_array
-                .iter()
-                .find(|bom| {
-                    bom["CFCALL_ID"].as_i64() == Some(cfcall_id)
-                        && bom["FTYPE_ID"].as_i64() == Some(ftype_id)
-                        && bom["FELEM_ID"].as_i64() == Some(felem_id)
+            Command::DeleteAttribute { attribute } => config.delete_attribute(attribute),
+
+            Command::SetAttribute {
+                attribute,
+                internal,
+                required,
+                default_value,
+            } => config.set_attribute(crate::attributes::SetAttributeParams {
+                attribute,
+                internal: internal.as_deref(),
+                required: required.as_deref(),
+                default_value: default_value.as_deref(),
+            }),
+
+            // ===== Element Commands =====
+            Command::AddElement { element, data_type } => {
+                config.add_element(crate::elements::AddElementParams {
+                    code: element,
+                    description: None, // Will default to code
+                    data_type: data_type.as_deref(),
+                    tokenized: None,
                 })
-                .ok_or_else(|| {
-                    SzConfigError::NotFound(format!(
-                        "Element {} not found in comparison call for feature {}",
-                        element, feature
-                    ))
-                })?;
+            }
 
-            let exec_order = cfbom["EXEC_ORDER"]
-                .as_i64()
-                .ok_or_else(|| SzConfigError::InvalidStructure("EXEC_ORDER missing".to_string()))?;
-
-            // Call underlying SDK function
-            crate::calls::comparison::delete_comparison_call_element(
-                config,
-                cfcall_id,
-                crate::calls::comparison::DeleteComparisonCallElementParams {
-                    ftype_id,
-                    felem_id,
-                    exec_order,
-                },
-            )
-        }
+            Command::SetFeatureElementDerived {
+                feature,
+                element,
+                derived,
+            } => config.set_feature_element(
+                crate::elements::SetFeatureElementParams::new(feature, element)
+                    .with_derived(derived),
+            ),
+
+            Command::SetFeatureElementDisplayLevel {
+                feature,
+                element,
+                display_level,
+            } => config.set_feature_element(
+                crate::elements::SetFeatureElementParams::new(feature, element)
+                    .with_display_level(*display_level),
+            ),
+
+            // ===== Feature Commands =====
+            Command::AddFeature(f) => config.add_feature(crate::features::AddFeatureParams {
+                feature: &f.feature,
+                element_list: &f.element_list,
+                class: f.class.as_deref(),
+                behavior: f.behavior.as_deref(),
+                candidates: f.candidates.as_deref(),
+                anonymize: f.anonymize.as_deref(),
+                derived: f.derived.as_deref(),
+                history: f.history.as_deref(),
+                matchkey: f.matchkey.as_deref(),
+                standardize: f.standardize.as_deref(),
+                expression: f.expression.as_deref(),
+                comparison: f.comparison.as_deref(),
+                version: f.version,
+                rtype_id: f.rtype_id,
+            }),
+
+            Command::SetFeature(f) => config.set_feature(crate::features::SetFeatureParams {
+                feature: &f.feature,
+                candidates: f.candidates.as_deref(),
+                anonymize: f.anonymize.as_deref(),
+                derived: f.derived.as_deref(),
+                history: f.history.as_deref(),
+                matchkey: f.matchkey.as_deref(),
+                behavior: f.behavior.as_deref(),
+                class: f.class.as_deref(),
+                version: f.version,
+                rtype_id: f.rtype_id,
+            }),
+
+            // ===== Behavior Override Commands =====
+            Command::AddBehaviorOverride {
+                feature,
+                usage_type,
+                behavior,
+            } => config.add_behavior_override(
+                crate::behavior_overrides::AddBehaviorOverrideParams::new(
+                    feature, usage_type, behavior,
+                ),
+            ),
 
-        "addComparisonCallElement" => {
-            let feature = get_str_param(params, "feature")?;
-            let element = get_str_param(params, "element")?;
+            // ===== Fragment Commands =====
+            Command::DeleteFragment { fragment } => config.delete_fragment(fragment),
 
-            // Lookup IDs
-            let ftype_id = crate::helpers::lookup_feature_id(config, feature)?;
-            let felem_id = crate::helpers::lookup_element_id(config, element)?;
+            Command::SetFragment {
+                fragment,
+                fragment_config,
+            } => config.set_fragment(fragment, fragment_config),
 
-            // Find the cfcall_id for this feature
-            let config_val: Value = serde_json::from_str(config)?;
-            let cfcall_array = config_val["G2_CONFIG"]["CFG_CFCALL"]
-                .as_array()
-                .ok_or_else(|| SzConfigError::MissingSection("CFG_CFCALL".to_string()))?;
+            Command::AddFragment { fragment_config } => {
+                config.add_fragment(fragment_config)?;
+                Ok(())
+            }
 
-            let cfcall = cfcall_array
-                .iter()
-                .find(|call| call["FTYPE_ID"].as_i64() == Some(ftype_id))
-                .ok_or_else(|| {
-                    SzConfigError::NotFound(format!(
-                        "No comparison call found for feature {}",
-                        feature
-                    ))
-                })?;
+            // ===== Rule Commands =====
+            Command::AddRule { rule_config } => {
+                config.add_rule(rule_config)?;
+                Ok(())
+            }
 
-            let cfcall_id = cfcall["CFCALL_ID"]
-                .as_i64()
-                .ok_or_else(|| SzConfigError::InvalidStructure("CFCALL_ID missing".to_string()))?;
+            Command::SetRule {
+                code,
+                resolve,
+                relate,
+                rtype_id,
+            } => config.set_rule(crate::rules::SetRuleParams {
+                code,
+                resolve: resolve.as_deref(),
+                relate: relate.as_deref(),
+                rtype_id: *rtype_id,
+            }),
+
+            // ===== System Parameter Commands =====
+            Command::SetSetting { name, value } => config.set_system_parameter(name, value),
+
+            // ===== Function Commands =====
+            Command::DeleteStandardizeFunction { function } => {
+                config.delete_standardize_function(function)?;
+                Ok(())
+            }
 
-            // Determine next exec_order
-            let cfbom_array = config_val["G2_CONFIG"]["CFG_CFBOM"]
-                .as_array()
-                .ok_or_else(|| SzConfigError::MissingSection("CFG_CFBOM".to_string()))?;
+            Command::AddStandardizeFunction {
+                function,
+                connect_str,
+                description,
+                language,
+            } => {
+                config.add_standardize_function(
+                    function,
+                    crate::functions::standardize::AddStandardizeFunctionParams {
+                        connect_str,
+                        description: description.as_deref(),
+                        language: language.as_deref(),
+                    },
+                )?;
+                Ok(())
+            }
 
-            let next_order = cfbom_array
-                .iter()
-                .filter(|bom| {
-                    bom["CFCALL_ID"].as_i64() == Some(cfcall_id)
-                        && bom["FTYPE_ID"].as_i64() == Some(ftype_id)
-                })
-                .filter_map(|bom| bom["EXEC_ORDER"].as_i64())
-                .max()
-                .unwrap_or(0)
-                + 1;
-
-            // Call underlying SDK function
-            crate::calls::comparison::add_comparison_call_element(
-                config,
-                crate::calls::comparison::AddComparisonCallElementParams {
-                    cfcall_id,
-                    ftype_id,
-                    felem_id,
-                    exec_order: next_order,
-                },
-            )
-            .map(|(cfg, _)| cfg)
-        }
+            Command::DeleteComparisonFunction { function } => {
+                config.delete_comparison_function(function)?;
+                Ok(())
+            }
 
-        // ===== Call Commands - Distinct =====
-        "deleteDistinctCallElement" => {
-            let feature = get_str_param(params, "feature")?;
-            let element = get_str_param(params, "element")?;
+            Command::AddComparisonFunction {
+                function,
+                connect_str,
+                description,
+                anon_support,
+            } => {
+                config.add_comparison_function(
+                    function,
+                    crate::functions::comparison::AddComparisonFunctionParams {
+                        connect_str,
+                        description: description.as_deref(),
+                        language: None,
+                        anon_support: anon_support.as_deref(),
+                    },
+                )?;
+                Ok(())
+            }
+
+            Command::AddExpressionFunction {
+                function,
+                connect_str,
+                description,
+                language,
+            } => {
+                config.add_expression_function(
+                    function,
+                    crate::functions::expression::AddExpressionFunctionParams {
+                        connect_str,
+                        description: description.as_deref(),
+                        language: language.as_deref(),
+                    },
+                )?;
+                Ok(())
+            }
+
+            // ===== Threshold Commands =====
+            Command::AddComparisonThreshold {
+                function,
+                feature,
+                score_name,
+                scores: [same, close, likely, plausible, unlikely],
+            } => config.add_comparison_threshold(crate::thresholds::AddComparisonThresholdParams {
+                cfunc_code: Some(function),
+                ftype_code: feature.as_deref(),
+                cfunc_rtnval: Some(score_name),
+                exec_order: None,
+                same_score: *same,
+                close_score: *close,
+                likely_score: *likely,
+                plausible_score: *plausible,
+                un_likely_score: *unlikely,
+            }),
+
+            Command::AddGenericThreshold {
+                plan,
+                behavior,
+                scoring_cap,
+                candidate_cap,
+                send_to_redo,
+                feature,
+            } => config.add_generic_threshold(crate::thresholds::AddGenericThresholdParams {
+                plan: plan.as_deref(),
+                behavior: behavior.as_deref(),
+                scoring_cap: *scoring_cap,
+                candidate_cap: *candidate_cap,
+                send_to_redo: send_to_redo.as_deref(),
+                feature: feature.as_deref(),
+            }),
+
+            Command::CloneGenericPlan {
+                existing_plan,
+                new_plan,
+                description,
+                thresholds,
+            } => {
+                let overrides: Vec<_> = thresholds
+                    .iter()
+                    .map(|t| crate::generic_plans::GenericThresholdOverride {
+                        behavior: &t.behavior,
+                        feature: t.feature.as_deref(),
+                        candidate_cap: t.candidate_cap,
+                        scoring_cap: t.scoring_cap,
+                        send_to_redo: t.send_to_redo.as_deref(),
+                    })
+                    .collect();
+                config
+                    .build_generic_plan(existing_plan, new_plan, description.as_deref(), &overrides)
+                    .map(|_| ())
+            }
 
-            // Lookup IDs
-            let ftype_id = crate::helpers::lookup_feature_id(config, feature)?;
-            let felem_id = crate::helpers::lookup_element_id(config, element)?;
+            // ===== Call Commands =====
+            Command::AddExpressionCall {
+                feature,
+                function,
+                exec_order,
+                expression_feature,
+                is_virtual,
+                element_list,
+            } => {
+                config.add_expression_call(crate::calls::expression::AddExpressionCallParams {
+                    efunc_code: function,
+                    element_list: element_list.clone(),
+                    ftype_code: Some(feature),
+                    felem_code: None,
+                    exec_order: *exec_order,
+                    expression_feature: expression_feature.as_deref(),
+                    is_virtual,
+                })?;
+                Ok(())
+            }
 
-            // Find the dfcall_id for this feature
-            let config_val: Value = serde_json::from_str(config)?;
-            let dfcall_array = config_val["G2_CONFIG"]["CFG_DFCALL"]
-                .as_array()
-                .ok_or_else(|| SzConfigError::MissingSection("CFG_DFCALL".to_string()))?;
+            Command::DeleteComparisonCallElement { feature, element } => {
+                let (cfcall_id, ftype_id, felem_id) = find_call(
+                    config,
+                    "CFG_CFCALL",
+                    "CFCALL_ID",
+                    "comparison",
+                    feature,
+                    element,
+                )?;
 
-            let dfcall = dfcall_array
-                .iter()
-                .find(|call| call["FTYPE_ID"].as_i64() == Some(ftype_id))
+                // Find exec_order from CFBOM
+                let exec_order = find_bom_exec_order(
+                    config,
+                    "CFG_CFBOM",
+                    "CFCALL_ID",
+                    (cfcall_id, ftype_id, felem_id),
+                )?
                 .ok_or_else(|| {
                     SzConfigError::NotFound(format!(
-                        "No distinct call found for feature {}",
-                        feature
+                        "Element {} not found in comparison call for feature {}",
+                        element, feature
                     ))
                 })?;
 
-            let dfcall_id = dfcall["DFCALL_ID"]
-                .as_i64()
-                .ok_or_else(|| SzConfigError::InvalidStructure("DFCALL_ID missing".to_string()))?;
-
-            // Find exec_order from DFBOM
-            let dfbom_array = config_val["G2_CONFIG"]["CFG_DFBOM"]
-                .as_array()
-                .ok_or_else(|| SzConfigError::MissingSection("CFG_DFBOM".to_string()))?;
-
-            let dfbom = dfbom_array
-                .iter()
-                .find(|bom| {
-                    bom["DFCALL_ID"].as_i64() == Some(dfcall_id)
-                        && bom["FTYPE_ID"].as_i64() == Some(ftype_id)
-                        && bom["FELEM_ID"].as_i64() == Some(felem_id)
-                })
+                config.delete_comparison_call_element(
+                    cfcall_id,
+                    crate::calls::comparison::DeleteComparisonCallElementParams {
+                        ftype_id,
+                        felem_id,
+                        exec_order,
+                    },
+                )
+            }
+
+            Command::AddComparisonCallElement { feature, element } => {
+                let (cfcall_id, ftype_id, felem_id) = find_call(
+                    config,
+                    "CFG_CFCALL",
+                    "CFCALL_ID",
+                    "comparison",
+                    feature,
+                    element,
+                )?;
+
+                // Determine next exec_order
+                let next_order = config
+                    .section("CFG_CFBOM")?
+                    .iter()
+                    .filter(|bom| {
+                        bom["CFCALL_ID"].as_i64() == Some(cfcall_id)
+                            && bom["FTYPE_ID"].as_i64() == Some(ftype_id)
+                    })
+                    .filter_map(|bom| bom["EXEC_ORDER"].as_i64())
+                    .max()
+                    .unwrap_or(0)
+                    + 1;
+
+                config.add_comparison_call_element(
+                    crate::calls::comparison::AddComparisonCallElementParams {
+                        cfcall_id,
+                        ftype_id,
+                        felem_id,
+                        exec_order: next_order,
+                    },
+                )?;
+                Ok(())
+            }
+
+            Command::DeleteDistinctCallElement { feature, element } => {
+                let (dfcall_id, ftype_id, felem_id) = find_call(
+                    config,
+                    "CFG_DFCALL",
+                    "DFCALL_ID",
+                    "distinct",
+                    feature,
+                    element,
+                )?;
+
+                // Find exec_order from DFBOM
+                let exec_order = find_bom_exec_order(
+                    config,
+                    "CFG_DFBOM",
+                    "DFCALL_ID",
+                    (dfcall_id, ftype_id, felem_id),
+                )?
                 .ok_or_else(|| {
                     SzConfigError::NotFound(format!(
                         "Element {} not found in distinct call for feature {}",
@@ -701,31 +1611,94 @@ fn execute_command(config: &str, cmd: &str, params: &Value) -> Result<String> {
                     ))
                 })?;
 
-            let exec_order = dfbom["EXEC_ORDER"]
-                .as_i64()
-                .ok_or_else(|| SzConfigError::InvalidStructure("EXEC_ORDER missing".to_string()))?;
-
-            // Call underlying SDK function
-            crate::calls::distinct::delete_distinct_call_element(
-                config,
-                crate::calls::distinct::DeleteDistinctCallElementParams {
-                    dfcall_id,
-                    ftype_id,
-                    felem_id,
-                    exec_order,
-                },
-            )
+                config.delete_distinct_call_element(
+                    crate::calls::distinct::DeleteDistinctCallElementParams {
+                        dfcall_id,
+                        ftype_id,
+                        felem_id,
+                        exec_order,
+                    },
+                )
+            }
         }
+    }
+}
+
+/// Resolve (call ID, feature ID, element ID) for the comparison or distinct
+/// call of a feature
+fn find_call(
+    config: &ConfigHandle,
+    call_section: &str,
+    call_id_field: &str,
+    kind: &str,
+    feature: &str,
+    element: &str,
+) -> Result<(i64, i64, i64)> {
+    // Lookup IDs
+    let ftype_id = config.lookup_feature_id(feature)?;
+    let felem_id = config.lookup_element_id(element)?;
+
+    let call = config
+        .section(call_section)?
+        .iter()
+        .find(|call| call["FTYPE_ID"].as_i64() == Some(ftype_id))
+        .ok_or_else(|| {
+            SzConfigError::NotFound(format!("No {} call found for feature {}", kind, feature))
+        })?;
+
+    let call_id = call[call_id_field]
+        .as_i64()
+        .ok_or_else(|| SzConfigError::InvalidStructure(format!("{} missing", call_id_field)))?;
+
+    Ok((call_id, ftype_id, felem_id))
+}
+
+/// EXEC_ORDER of the BOM record for (call ID, feature ID, element ID)
+///
+/// Ok(None) if there is no such record.
+fn find_bom_exec_order(
+    config: &ConfigHandle,
+    bom_section: &str,
+    call_id_field: &str,
+    (call_id, ftype_id, felem_id): (i64, i64, i64),
+) -> Result<Option<i64>> {
+    let Some(bom) = config.section(bom_section)?.iter().find(|bom| {
+        bom[call_id_field].as_i64() == Some(call_id)
+            && bom["FTYPE_ID"].as_i64() == Some(ftype_id)
+            && bom["FELEM_ID"].as_i64() == Some(felem_id)
+    }) else {
+        return Ok(None);
+    };
+
+    bom["EXEC_ORDER"]
+        .as_i64()
+        .map(Some)
+        .ok_or_else(|| SzConfigError::InvalidStructure("EXEC_ORDER missing".to_string()))
+}
+
+/// Error for a failed script line (`line_num` is zero-based)
+fn line_error(line_num: usize, line: &str, e: SzConfigError) -> SzConfigError {
+    SzConfigError::InvalidConfig(format!("Line {}: {} - Error: {}", line_num + 1, line, e))
+}
 
-        // ===== No-op Commands =====
-        "save" => Ok(config.to_string()),
+/// Parse a command line into (command_name, parameters)
+fn parse_command_line(line: &str) -> Result<(String, Value)> {
+    let parts: Vec<&str> = line.splitn(2, ' ').collect();
 
-        // ===== Unknown Command =====
-        _ => Err(SzConfigError::InvalidInput(format!(
-            "Unknown command: '{}'",
-            cmd
-        ))),
+    if parts.is_empty() {
+        return Err(SzConfigError::InvalidInput("Empty command".to_string()));
     }
+
+    let cmd = parts[0].to_string();
+
+    let params = if parts.len() > 1 {
+        serde_json::from_str(parts[1])
+            .map_err(|e| SzConfigError::JsonParse(format!("Invalid JSON in '{}': {}", cmd, e)))?
+    } else {
+        Value::Null
+    };
+
+    Ok((cmd, params))
 }
 
 // ===== Helper Functions =====
@@ -875,6 +1848,229 @@ save
         assert!(result.unwrap_err().to_string().contains("Invalid JSON"));
     }
 
+    #[test]
+    fn test_command_processor_keeps_applied_commands_on_error() {
+        let script = r#"
+updateCompatibilityVersion {"fromVersion": "10", "toVersion": "11"}
+save
+deleteAttribute {"attribute": "MISSING"}
+"#;
+
+        let mut processor = CommandProcessor::new(TEST_CONFIG.to_string());
+        assert!(processor.process_script(script).is_err());
+
+        // Commands before the failing line were applied
+        let config: Value = serde_json::from_str(processor.get_config()).unwrap();
+        assert_eq!(
+            config["G2_CONFIG"]["CONFIG_BASE_VERSION"]["COMPATIBILITY_VERSION"]["CONFIG_VERSION"],
+            "11"
+        );
+    }
+
+    #[test]
+    fn test_command_processor_transactional_rolls_back() {
+        let script = r#"
+updateCompatibilityVersion {"fromVersion": "10", "toVersion": "11"}
+save
+deleteAttribute {"attribute": "MISSING"}
+"#;
+
+        let mut processor = CommandProcessor::new(TEST_CONFIG.to_string()).transactional(true);
+        assert!(processor.process_script(script).is_err());
+        assert!(processor.get_executed_commands().is_empty());
+
+        let config: Value = serde_json::from_str(processor.get_config()).unwrap();
+        assert_eq!(
+            config["G2_CONFIG"]["CONFIG_BASE_VERSION"]["COMPATIBILITY_VERSION"]["CONFIG_VERSION"],
+            "10"
+        );
+
+        let script = CompiledScript::compile(script).unwrap();
+        let mut handle = ConfigHandle::from_json(TEST_CONFIG).unwrap();
+        assert!(script.apply_atomic(&mut handle).is_err());
+        assert_eq!(
+            handle.as_value(),
+            &serde_json::from_str::<Value>(TEST_CONFIG).unwrap()
+        );
+    }
+
+    #[test]
+    fn test_command_processor_rejects_script_before_running() {
+        let script = r#"
+updateCompatibilityVersion {"fromVersion": "10", "toVersion": "11"}
+addFeature {"feature": "MISSING_ELEMENT_LIST"}
+"#;
+
+        let mut processor = CommandProcessor::new(TEST_CONFIG.to_string());
+        let err = processor.process_script(script).unwrap_err();
+        assert!(err.to_string().contains("Line 3"));
+        assert!(processor.get_executed_commands().is_empty());
+
+        // Nothing was applied
+        let config: Value = serde_json::from_str(processor.get_config()).unwrap();
+        assert_eq!(
+            config["G2_CONFIG"]["CONFIG_BASE_VERSION"]["COMPATIBILITY_VERSION"]["CONFIG_VERSION"],
+            "10"
+        );
+    }
+
+    #[test]
+    fn test_compiled_script_reused_across_configs() {
+        let script = CompiledScript::compile(
+            r#"
+# comment
+updateCompatibilityVersion {"toVersion": "11"}
+save
+addConfigSection {"section": "CFG_TEST"}
+"#,
+        )
+        .unwrap();
+        assert_eq!(script.len(), 2);
+
+        for _ in 0..2 {
+            let mut config = ConfigHandle::from_json(TEST_CONFIG).unwrap();
+            assert_eq!(script.apply(&mut config).unwrap(), 2);
+            assert!(config.section("CFG_TEST").is_ok());
+        }
+    }
+
+    #[test]
+    fn test_clone_generic_plan_with_overrides() {
+        let config = r#"{"G2_CONFIG":{"CFG_FTYPE":[{"FTYPE_ID":1,"FTYPE_CODE":"NAME"}],
+            "CFG_GPLAN":[{"GPLAN_ID":1,"GPLAN_CODE":"INGEST","GPLAN_DESC":"Ingest"}],
+            "CFG_GENERIC_THRESHOLD":[
+                {"GPLAN_ID":1,"BEHAVIOR":"NAME","FTYPE_ID":0,"CANDIDATE_CAP":10,"SCORING_CAP":-1,"SEND_TO_REDO":"Yes"},
+                {"GPLAN_ID":1,"BEHAVIOR":"FF","FTYPE_ID":1,"CANDIDATE_CAP":5,"SCORING_CAP":5,"SEND_TO_REDO":"No"}]}}"#;
+        let script = r#"cloneGenericPlan {"existingPlan": "INGEST", "newPlan": "TENANT_A", "thresholds": [{"behavior": "FF", "feature": "NAME", "scoringCap": 50}, {"behavior": "F1", "candidateCap": 1, "scoringCap": 2, "sendToRedo": "yes"}]}"#;
+
+        let mut processor = CommandProcessor::new(config.to_string());
+        let result: Value =
+            serde_json::from_str(&processor.process_script(script).unwrap()).unwrap();
+        let plan = &result["G2_CONFIG"]["CFG_GPLAN"][1];
+        assert_eq!(
+            plan,
+            &json!({"GPLAN_ID": 2, "GPLAN_CODE": "TENANT_A", "GPLAN_DESC": "TENANT_A"})
+        );
+        let rows = result["G2_CONFIG"]["CFG_GENERIC_THRESHOLD"]
+            .as_array()
+            .unwrap();
+        assert_eq!(rows.len(), 5);
+        assert_eq!(rows[2]["CANDIDATE_CAP"], 10);
+        assert_eq!(
+            rows[3],
+            json!({"GPLAN_ID": 2, "BEHAVIOR": "FF", "FTYPE_ID": 1, "CANDIDATE_CAP": 5, "SCORING_CAP": 50, "SEND_TO_REDO": "No"})
+        );
+        assert_eq!(rows[4]["SEND_TO_REDO"], "YES");
+
+        // A new row without all of its fields rejects the whole clone
+        let script = r#"cloneGenericPlan {"existingPlan": "INGEST", "newPlan": "TENANT_B", "thresholds": [{"behavior": "F1", "candidateCap": 1}]}"#;
+        let mut handle = ConfigHandle::from_json(config).unwrap();
+        let before = handle.to_json().unwrap();
+        let err = apply_commands(&mut handle, script).unwrap_err();
+        assert!(err.to_string().contains("sendToRedo"));
+        assert_eq!(handle.to_json().unwrap(), before);
+
+        // A plan without a usable ID still holds its code
+        handle.as_value_mut()["G2_CONFIG"]["CFG_GPLAN"]
+            .as_array_mut()
+            .unwrap()
+            .push(json!({"GPLAN_CODE": "TENANT_C"}));
+        let script = r#"cloneGenericPlan {"existingPlan": "INGEST", "newPlan": "TENANT_C"}"#;
+        let err = apply_commands(&mut handle, script).unwrap_err();
+        assert!(err.to_string().contains("already exists"));
+    }
+
+    #[test]
+    fn test_command_processor_profile() {
+        let script = r#"
+addConfigSection {"section": "CFG_TEST"}
+save
+addElement {"element": "TEST_ELEM", "datatype": "string"}
+"#;
+
+        let mut processor = CommandProcessor::new(TEST_CONFIG.to_string()).profile(true);
+        processor.process_script(script).unwrap();
+
+        let report = processor.profile_report().unwrap();
+        assert_eq!(report.script_bytes, script.len());
+        let commands: Vec<_> = report.commands.iter().map(|c| c.command.as_str()).collect();
+        assert_eq!(commands, ["addConfigSection", "save", "addElement"]);
+
+        let add = &report.commands[0];
+        assert_eq!(add.line, 2);
+        assert_eq!(add.bytes_parsed, TEST_CONFIG.len());
+        assert_eq!(add.sections, ["CFG_TEST"]);
+        assert!(report.commands[1].bytes_serialized > 0);
+        assert_eq!(report.commands[2].bytes_parsed, 0);
+        assert_eq!(report.commands[2].sections, ["CFG_FELEM"]);
+        assert_eq!(report.finish_bytes_serialized, processor.get_config().len());
+
+        let json = report.to_json();
+        assert_eq!(json["commands"].as_array().unwrap().len(), 3);
+        assert!(json["commands"][0]["error"].is_null());
+
+        // Off by default
+        let processor = CommandProcessor::new(TEST_CONFIG.to_string());
+        assert!(processor.profile_report().is_none());
+    }
+
+    #[test]
+    fn test_command_processor_profile_records_failure() {
+        let mut processor = CommandProcessor::new(TEST_CONFIG.to_string())
+            .profile(true)
+            .dry_run(true);
+        let script = r#"addConfigSection {"section": "CFG_DSRC"}"#;
+        assert!(processor.process_script(script).is_err());
+
+        let report = processor.profile_report().unwrap();
+        assert_eq!(report.commands.len(), 1);
+        assert!(report.commands[0].error.is_some());
+    }
+
+    #[test]
+    fn test_command_processor_as_patch() {
+        let mut processor = CommandProcessor::new(TEST_CONFIG.to_string());
+        let patch = processor
+            .process_script_as_patch(r#"addConfigSection {"section": "CFG_TEST"}"#)
+            .unwrap();
+        assert_eq!(
+            patch,
+            serde_json::json!([{"op": "add", "path": "/G2_CONFIG/CFG_TEST", "value": []}])
+        );
+
+        let replayed = crate::patch::apply_patch(TEST_CONFIG, &patch).unwrap();
+        assert_eq!(replayed, processor.get_config());
+
+        // A failing script leaves nothing applied
+        let config = processor.get_config().to_string();
+        let script = "addConfigSection {\"section\": \"CFG_MORE\"}\naddConfigSection {\"section\": \"CFG_TEST\"}";
+        assert!(processor.process_script_as_patch(script).is_err());
+        assert_eq!(processor.get_config(), config);
+        assert_eq!(processor.get_executed_commands().len(), 1);
+    }
+
+    #[test]
+    fn test_command_processor_from_handle() {
+        let handle = ConfigHandle::from_json(TEST_CONFIG).unwrap();
+        let mut processor = CommandProcessor::from_handle(handle);
+
+        // The configuration is available before any script runs
+        let before: Value = serde_json::from_str(processor.get_config()).unwrap();
+        assert_eq!(before, serde_json::from_str::<Value>(TEST_CONFIG).unwrap());
+
+        // An empty script still yields the configuration
+        let result = processor.process_script("# nothing to do").unwrap();
+        assert_eq!(result, processor.get_config());
+        let config: Value = serde_json::from_str(&result).unwrap();
+        assert!(config["G2_CONFIG"]["CFG_FBOVR"].is_array());
+
+        let result = processor
+            .process_script(r#"addConfigSection {"section": "CFG_FROM_HANDLE"}"#)
+            .unwrap();
+        assert!(result.contains("CFG_FROM_HANDLE"));
+        assert_eq!(result, processor.get_config());
+    }
+
     #[test]
     fn test_execute_add_behavior_override() {
         let config_with_feature = r#"{
@@ -892,11 +2088,11 @@ save
             "behavior": "F1E"
         });
 
-        let result = execute_command(config_with_feature, "addBehaviorOverride", &params);
-        assert!(result.is_ok());
+        let mut config = ConfigHandle::from_json(config_with_feature).unwrap();
+        let command = Command::compile("addBehaviorOverride", &params).unwrap();
+        assert!(command.execute(&mut config).is_ok());
 
-        let config: Value = serde_json::from_str(&result.unwrap()).unwrap();
-        let overrides = &config["G2_CONFIG"]["CFG_FBOVR"];
+        let overrides = &config.as_value()["G2_CONFIG"]["CFG_FBOVR"];
         assert_eq!(overrides.as_array().unwrap().len(), 1);
         assert_eq!(overrides[0]["UTYPE_CODE"], "BUSINESS");
     }
@@ -0,0 +1,521 @@
+//! Compact resident form of a configuration
+//!
+//! A parsed [`ConfigHandle`] stores every row of every section as an
+//! insertion-ordered map of heap-allocated keys to [`Value`]s. That is the
+//! right shape for editing, but a process that keeps many tenant configs
+//! resident mostly holds the same few thousand field names and codes over and
+//! over.
+//!
+//! [`CompactConfig`] stores the high-volume sections ([`COMPACT_SECTIONS`]) in
+//! a schema-specialized layout instead:
+//!
+//! - every distinct string (field name, code, `"Yes"`, ...) is stored once in
+//!   a table shared by all sections and referenced by a 4-byte symbol,
+//! - each distinct field order of a section (its *layout*) is stored once, so
+//!   rows carry no keys at all,
+//! - the cells of all rows of a section are kept contiguously, as small typed
+//!   values (integer, symbol, bool, null). Anything else (floats, nested
+//!   arrays or objects) is kept as a boxed [`Value`].
+//!
+//! Unknown fields are simply more layout entries, so the conversion is
+//! lossless: [`CompactConfig::to_value`] rebuilds the original document,
+//! including field order. Other members of `G2_CONFIG` are kept as they are.
+//!
+//! [`SectionView`] and [`RowView`] read the compact form in place;
+//! [`SectionView::column`] resolves a field once per layout and then walks the
+//! cells, which makes whole-section scans cache-friendly.
+//!
+//! # Example
+//!
+//! ```
+//! use sz_configtool_lib::ConfigHandle;
+//! use sz_configtool_lib::compact::CompactConfig;
+//!
+//! let json = r#"{"G2_CONFIG":{"CFG_FTYPE":[
+//!     {"FTYPE_ID":1,"FTYPE_CODE":"NAME","FTYPE_FREQ":"NAME"},
+//!     {"FTYPE_ID":2,"FTYPE_CODE":"PHONE","FTYPE_FREQ":"FF","CUSTOM":[1,2]}]}}"#;
+//! let config = ConfigHandle::from_json(json)?;
+//!
+//! let compact = CompactConfig::from_handle(&config);
+//! let ftypes = compact.section("CFG_FTYPE").unwrap();
+//! assert_eq!(ftypes.row(1).unwrap().get("FTYPE_CODE").unwrap().as_str(), Some("PHONE"));
+//!
+//! // Lossless, including unknown fields and field order
+//! assert_eq!(compact.to_json()?, config.to_json()?);
+//! # Ok::<(), sz_configtool_lib::SzConfigError>(())
+//! ```
+
+use crate::error::{Result, SzConfigError};
+use crate::handle::ConfigHandle;
+use serde_json::{Map, Value};
+use std::collections::HashMap;
+
+/// `G2_CONFIG` sections stored in compact form
+pub const COMPACT_SECTIONS: &[&str] = &[
+    "CFG_ATTR",
+    "CFG_CFBOM",
+    "CFG_CFCALL",
+    "CFG_CFRTN",
+    "CFG_DFBOM",
+    "CFG_DFCALL",
+    "CFG_EFBOM",
+    "CFG_EFCALL",
+    "CFG_FBOM",
+    "CFG_FELEM",
+    "CFG_FTYPE",
+    "CFG_GENERIC_THRESHOLD",
+    "CFG_SFCALL",
+];
+
+/// Layout of rows that are not objects (stored as a single `Other` cell)
+const NOT_AN_OBJECT: u32 = u32::MAX;
+
+/// One stored field value
+#[derive(Debug, Clone, PartialEq)]
+enum Cell {
+    Null,
+    Bool(bool),
+    Int(i64),
+    /// Index into the string table
+    Str(u32),
+    Other(Box<Value>),
+}
+
+/// Where a row's cells start and which layout they follow
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+struct RowSlot {
+    layout: u32,
+    start: u32,
+}
+
+/// The rows of one section
+#[derive(Debug, Clone, Default, PartialEq)]
+struct CompactSection {
+    /// Distinct field orders, as string-table symbols
+    layouts: Vec<Box<[u32]>>,
+    rows: Vec<RowSlot>,
+    cells: Vec<Cell>,
+}
+
+/// A configuration with its high-volume sections in compact form
+///
+/// Build one with [`from_handle`](Self::from_handle) or
+/// [`from_json`](Self::from_json); turn it back into an editable handle with
+/// [`to_handle`](Self::to_handle).
+#[derive(Debug, Clone, PartialEq)]
+pub struct CompactConfig {
+    /// The document, with each compacted section left as a null placeholder
+    root: Value,
+    sections: Vec<(String, CompactSection)>,
+    strings: Vec<Box<str>>,
+}
+
+/// Builds the string table and layouts while compacting
+#[derive(Default)]
+struct Builder<'a> {
+    strings: Vec<Box<str>>,
+    symbols: HashMap<&'a str, u32>,
+}
+
+impl<'a> Builder<'a> {
+    fn intern(&mut self, s: &'a str) -> u32 {
+        *self.symbols.entry(s).or_insert_with(|| {
+            self.strings.push(s.into());
+            (self.strings.len() - 1) as u32
+        })
+    }
+
+    fn cell(&mut self, value: &'a Value) -> Cell {
+        match value {
+            Value::Null => Cell::Null,
+            Value::Bool(b) => Cell::Bool(*b),
+            Value::Number(n) => match n.as_i64() {
+                Some(i) => Cell::Int(i),
+                None => Cell::Other(Box::new(value.clone())),
+            },
+            Value::String(s) => Cell::Str(self.intern(s)),
+            Value::Array(_) | Value::Object(_) => Cell::Other(Box::new(value.clone())),
+        }
+    }
+
+    fn section(&mut self, rows: &'a [Value]) -> CompactSection {
+        let mut section = CompactSection {
+            rows: Vec::with_capacity(rows.len()),
+            ..Default::default()
+        };
+        let mut layouts: HashMap<Vec<u32>, u32> = HashMap::new();
+        let mut keys = Vec::new();
+
+        for row in rows {
+            let start = section.cells.len() as u32;
+            let Value::Object(fields) = row else {
+                section.cells.push(Cell::Other(Box::new(row.clone())));
+                section.rows.push(RowSlot {
+                    layout: NOT_AN_OBJECT,
+                    start,
+                });
+                continue;
+            };
+
+            keys.clear();
+            for (key, value) in fields {
+                keys.push(self.intern(key));
+                let cell = self.cell(value);
+                section.cells.push(cell);
+            }
+            let layout = match layouts.get(&keys) {
+                Some(&layout) => layout,
+                None => {
+                    let layout = section.layouts.len() as u32;
+                    section.layouts.push(keys.clone().into_boxed_slice());
+                    layouts.insert(keys.clone(), layout);
+                    layout
+                }
+            };
+            section.rows.push(RowSlot { layout, start });
+        }
+
+        section.cells.shrink_to_fit();
+        section
+    }
+}
+
+impl CompactConfig {
+    /// Compact a parsed configuration
+    pub fn from_handle(config: &ConfigHandle) -> Self {
+        let source = config.as_value();
+        let mut builder = Builder::default();
+        let mut sections = Vec::new();
+
+        if let Some(g2_config) = source.get("G2_CONFIG").and_then(|g| g.as_object()) {
+            for &name in COMPACT_SECTIONS {
+                if let Some(Value::Array(rows)) = g2_config.get(name) {
+                    sections.push((name.to_string(), builder.section(rows)));
+                }
+            }
+        }
+
+        // Copy the document without the compacted sections
+        let root = match source {
+            Value::Object(top) => Value::Object(
+                top.iter()
+                    .map(|(key, value)| {
+                        let value = match value {
+                            Value::Object(members) if key == "G2_CONFIG" => Value::Object(
+                                members
+                                    .iter()
+                                    .map(|(name, member)| {
+                                        let compacted = sections.iter().any(|(n, _)| n == name);
+                                        let member = if compacted {
+                                            Value::Null
+                                        } else {
+                                            member.clone()
+                                        };
+                                        (name.clone(), member)
+                                    })
+                                    .collect(),
+                            ),
+                            other => other.clone(),
+                        };
+                        (key.clone(), value)
+                    })
+                    .collect(),
+            ),
+            other => other.clone(),
+        };
+
+        let mut strings = builder.strings;
+        strings.shrink_to_fit();
+        Self {
+            root,
+            sections,
+            strings,
+        }
+    }
+
+    /// Parse and compact a configuration JSON string
+    ///
+    /// # Errors
+    /// - `JsonParse` if config_json is invalid
+    pub fn from_json(config_json: &str) -> Result<Self> {
+        Ok(Self::from_handle(&ConfigHandle::from_json(config_json)?))
+    }
+
+    /// Rebuild the full configuration document
+    pub fn to_value(&self) -> Value {
+        let mut root = self.root.clone();
+        if let Some(g2_config) = root.get_mut("G2_CONFIG").and_then(|g| g.as_object_mut()) {
+            for (name, section) in &self.sections {
+                if let Some(slot) = g2_config.get_mut(name) {
+                    *slot = Value::Array(
+                        self.view(section)
+                            .rows()
+                            .map(|row| row.to_value())
+                            .collect(),
+                    );
+                }
+            }
+        }
+        root
+    }
+
+    /// Serialize the configuration to a compact JSON string
+    ///
+    /// # Errors
+    /// - `JsonParse` if serialization fails
+    pub fn to_json(&self) -> Result<String> {
+        serde_json::to_string(&self.to_value()).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    }
+
+    /// Expand into an editable handle
+    pub fn to_handle(&self) -> ConfigHandle {
+        ConfigHandle::from_value(self.to_value())
+    }
+
+    /// A compacted section (None if it is missing or not in [`COMPACT_SECTIONS`])
+    pub fn section(&self, name: &str) -> Option<SectionView<'_>> {
+        self.sections
+            .iter()
+            .find(|(n, _)| n == name)
+            .map(|(_, section)| self.view(section))
+    }
+
+    /// Number of distinct strings stored
+    pub fn string_count(&self) -> usize {
+        self.strings.len()
+    }
+
+    fn view<'a>(&'a self, section: &'a CompactSection) -> SectionView<'a> {
+        SectionView {
+            strings: &self.strings,
+            section,
+        }
+    }
+}
+
+impl ConfigHandle {
+    /// Compact this configuration for resident storage (see [`crate::compact`])
+    pub fn to_compact(&self) -> CompactConfig {
+        CompactConfig::from_handle(self)
+    }
+}
+
+/// A field value read from the compact form
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub enum Field<'a> {
+    Null,
+    Bool(bool),
+    Int(i64),
+    Str(&'a str),
+    /// Floats, nested arrays and objects
+    Other(&'a Value),
+}
+
+impl<'a> Field<'a> {
+    /// The value as an integer, if it is one
+    pub fn as_i64(&self) -> Option<i64> {
+        match self {
+            Field::Int(i) => Some(*i),
+            Field::Other(v) => v.as_i64(),
+            _ => None,
+        }
+    }
+
+    /// The value as a string, if it is one
+    pub fn as_str(&self) -> Option<&'a str> {
+        match self {
+            Field::Str(s) => Some(s),
+            _ => None,
+        }
+    }
+
+    /// The value as a [`Value`]
+    pub fn to_value(&self) -> Value {
+        match self {
+            Field::Null => Value::Null,
+            Field::Bool(b) => Value::Bool(*b),
+            Field::Int(i) => Value::from(*i),
+            Field::Str(s) => Value::from(*s),
+            Field::Other(v) => (*v).clone(),
+        }
+    }
+}
+
+/// Read access to a compacted section
+#[derive(Debug, Clone, Copy)]
+pub struct SectionView<'a> {
+    strings: &'a [Box<str>],
+    section: &'a CompactSection,
+}
+
+impl<'a> SectionView<'a> {
+    /// Number of rows
+    pub fn len(&self) -> usize {
+        self.section.rows.len()
+    }
+
+    /// True if the section has no rows
+    pub fn is_empty(&self) -> bool {
+        self.section.rows.is_empty()
+    }
+
+    /// Row at a position
+    pub fn row(&self, index: usize) -> Option<RowView<'a>> {
+        let slot = *self.section.rows.get(index)?;
+        let start = slot.start as usize;
+        let (layout, len) = match slot.layout {
+            NOT_AN_OBJECT => (None, 1),
+            layout => {
+                let keys = &self.section.layouts[layout as usize];
+                (Some(&keys[..]), keys.len())
+            }
+        };
+        Some(RowView {
+            strings: self.strings,
+            layout,
+            cells: &self.section.cells[start..start + len],
+        })
+    }
+
+    /// All rows in order
+    pub fn rows(&self) -> impl Iterator<Item = RowView<'a>> + '_ {
+        (0..self.len()).map(|i| self.row(i).expect("index in range"))
+    }
+
+    /// One field of every row, in row order (None where a row lacks it)
+    ///
+    /// The field is resolved once per layout rather than once per row.
+    pub fn column(&self, field: &str) -> impl Iterator<Item = Option<Field<'a>>> + '_ {
+        let positions: Vec<Option<usize>> = self
+            .section
+            .layouts
+            .iter()
+            .map(|keys| {
+                keys.iter()
+                    .position(|&k| &*self.strings[k as usize] == field)
+            })
+            .collect();
+        let strings = self.strings;
+
+        self.section.rows.iter().map(move |slot| {
+            let position = positions.get(slot.layout as usize).copied().flatten()?;
+            Some(field_of(
+                strings,
+                &self.section.cells[slot.start as usize + position],
+            ))
+        })
+    }
+
+    /// Position of the first row whose string field equals `value`
+    pub fn find(&self, field: &str, value: &str) -> Option<usize> {
+        self.column(field)
+            .position(|f| f.and_then(|f| f.as_str()) == Some(value))
+    }
+}
+
+/// Read access to one compacted row
+#[derive(Debug, Clone, Copy)]
+pub struct RowView<'a> {
+    strings: &'a [Box<str>],
+    /// None for a row that is not an object
+    layout: Option<&'a [u32]>,
+    cells: &'a [Cell],
+}
+
+impl<'a> RowView<'a> {
+    /// A field of the row
+    pub fn get(&self, field: &str) -> Option<Field<'a>> {
+        let position = self
+            .layout?
+            .iter()
+            .position(|&k| &*self.strings[k as usize] == field)?;
+        Some(field_of(self.strings, &self.cells[position]))
+    }
+
+    /// Field names and values, in document order
+    pub fn fields(&self) -> impl Iterator<Item = (&'a str, Field<'a>)> + '_ {
+        self.layout
+            .unwrap_or_default()
+            .iter()
+            .zip(self.cells)
+            .map(|(&k, cell)| (&*self.strings[k as usize], field_of(self.strings, cell)))
+    }
+
+    /// The row as a [`Value`]
+    pub fn to_value(&self) -> Value {
+        match self.layout {
+            None => field_of(self.strings, &self.cells[0]).to_value(),
+            Some(_) => Value::Object(
+                self.fields()
+                    .map(|(key, field)| (key.to_string(), field.to_value()))
+                    .collect::<Map<String, Value>>(),
+            ),
+        }
+    }
+}
+
+fn field_of<'a>(strings: &'a [Box<str>], cell: &'a Cell) -> Field<'a> {
+    match cell {
+        Cell::Null => Field::Null,
+        Cell::Bool(b) => Field::Bool(*b),
+        Cell::Int(i) => Field::Int(*i),
+        Cell::Str(s) => Field::Str(&strings[*s as usize]),
+        Cell::Other(v) => Field::Other(v),
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use serde_json::json;
+
+    #[test]
+    fn test_round_trip_is_lossless() {
+        let document = json!({
+            "VERSION": 1,
+            "G2_CONFIG": {
+                "CFG_DSRC": [{"DSRC_ID": 1, "DSRC_CODE": "TEST"}],
+                "CFG_FBOM": [
+                    {"FTYPE_ID": 1, "FELEM_ID": 2, "DISPLAY_LEVEL": 1},
+                    {"FELEM_ID": 3, "FTYPE_ID": 1, "WEIGHT": 0.5, "EXTRA": {"A": [1, null]}},
+                    "not a row",
+                    {"FTYPE_ID": 18446744073709551615u64, "FLAG": true, "NOTE": null}
+                ],
+                "CFG_FTYPE": [],
+                "SYS_OOM": {"NAME_HASH": ["X"]}
+            }
+        });
+        let config = ConfigHandle::from_value(document.clone());
+        let compact = config.to_compact();
+
+        assert_eq!(compact.to_value(), document);
+        assert_eq!(compact.to_json().unwrap(), config.to_json().unwrap());
+        assert_eq!(compact.to_handle().as_value(), &document);
+        assert!(compact.section("CFG_DSRC").is_none());
+    }
+
+    #[test]
+    fn test_section_views() {
+        let config = ConfigHandle::from_value(json!({"G2_CONFIG": {"CFG_FELEM": [
+            {"FELEM_ID": 2, "FELEM_CODE": "GIVEN_NAME", "DATA_TYPE": "string"},
+            {"FELEM_ID": 3, "FELEM_CODE": "SUR_NAME", "DATA_TYPE": "string"},
+            {"FELEM_CODE": "ODD", "FELEM_ID": 4}
+        ]}}));
+        let compact = config.to_compact();
+        let felem = compact.section("CFG_FELEM").unwrap();
+
+        assert_eq!(felem.len(), 3);
+        let ids: Vec<Option<i64>> = felem.column("FELEM_ID").map(|f| f?.as_i64()).collect();
+        assert_eq!(ids, vec![Some(2), Some(3), Some(4)]);
+        let types: Vec<Option<&str>> = felem.column("DATA_TYPE").map(|f| f?.as_str()).collect();
+        assert_eq!(types, vec![Some("string"), Some("string"), None]);
+        assert_eq!(felem.find("FELEM_CODE", "ODD"), Some(2));
+
+        let row = felem.row(2).unwrap();
+        assert_eq!(row.get("FELEM_ID"), Some(Field::Int(4)));
+        assert_eq!(row.get("MISSING"), None);
+
+        // Field names and shared values are stored once
+        assert_eq!(compact.string_count(), 7);
+    }
+}
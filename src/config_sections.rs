@@ -4,7 +4,317 @@
 //! These functions allow adding, removing, and querying configuration sections.
 
 use crate::error::{Result, SzConfigError};
+use crate::handle::{self, ConfigHandle};
 use serde_json::{Value, json};
+use std::io::Write;
+
+/// How a [`Condition`] compares a value (ASCII case-insensitive)
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum MatchOp {
+    /// `FIELD=value`
+    Equals,
+    /// `FIELD^=value`
+    Prefix,
+    /// `FIELD*=value`, or free text
+    Contains,
+}
+
+/// One condition of a [`SectionFilter`]
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct Condition {
+    /// Field to compare; None compares every value of the record
+    pub field: Option<String>,
+    pub op: MatchOp,
+    pub text: String,
+}
+
+/// A `get_config_section` filter
+///
+/// A filter is either a list of field conditions joined by `&`, e.g.
+/// `FTYPE_CODE=NAME&FELEM_CODE^=GIVEN`, with `=` (equals), `^=` (starts with)
+/// or `*=` (contains); or free text, matched as a substring of any value of
+/// the record (not of its field names). Comparisons are ASCII
+/// case-insensitive; numbers and booleans compare by their JSON text, and a
+/// field holding an array or object matches if any value inside it does.
+/// Records are compared in place, without serializing them.
+///
+/// # Example
+/// ```
+/// use sz_configtool_lib::config_sections::SectionFilter;
+/// use serde_json::json;
+///
+/// let filter = SectionFilter::parse("FTYPE_ID=1&FELEM_CODE^=given");
+/// assert!(filter.matches(&json!({"FTYPE_ID": 1, "FELEM_CODE": "GIVEN_NAME"})));
+/// assert!(!filter.matches(&json!({"FTYPE_ID": 2, "FELEM_CODE": "GIVEN_NAME"})));
+///
+/// // Free text looks at values only
+/// assert!(!SectionFilter::parse("felem").matches(&json!({"FELEM_CODE": "X"})));
+/// ```
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct SectionFilter {
+    conditions: Vec<Condition>,
+}
+
+impl SectionFilter {
+    /// Parse a filter string (anything that is not a condition list is free text)
+    pub fn parse(filter: &str) -> Self {
+        let conditions: Option<Vec<Condition>> = filter.split('&').map(parse_condition).collect();
+        Self {
+            conditions: conditions.unwrap_or_else(|| {
+                vec![Condition {
+                    field: None,
+                    op: MatchOp::Contains,
+                    text: filter.to_string(),
+                }]
+            }),
+        }
+    }
+
+    /// The parsed conditions (all must match)
+    pub fn conditions(&self) -> &[Condition] {
+        &self.conditions
+    }
+
+    /// True if a record satisfies every condition
+    pub fn matches(&self, record: &Value) -> bool {
+        self.conditions.iter().all(|c| match &c.field {
+            Some(field) => record
+                .get(field)
+                .is_some_and(|value| value_matches(value, c.op, &c.text)),
+            None => value_matches(record, c.op, &c.text),
+        })
+    }
+}
+
+/// Parse `FIELD=value`, `FIELD^=value` or `FIELD*=value`
+fn parse_condition(part: &str) -> Option<Condition> {
+    let eq = part.find('=')?;
+    let (field, op) = match part[..eq].trim_end() {
+        f if f.ends_with('^') => (&f[..f.len() - 1], MatchOp::Prefix),
+        f if f.ends_with('*') => (&f[..f.len() - 1], MatchOp::Contains),
+        f => (f, MatchOp::Equals),
+    };
+    let field = field.trim();
+
+    let mut chars = field.chars();
+    let valid = chars
+        .next()
+        .is_some_and(|c| c.is_ascii_alphabetic() || c == '_')
+        && chars.all(|c| c.is_ascii_alphanumeric() || c == '_');
+    valid.then(|| Condition {
+        field: Some(field.to_ascii_uppercase()),
+        op,
+        text: part[eq + 1..].trim().to_string(),
+    })
+}
+
+/// Compare a value (recursively for arrays and objects) without serializing it
+fn value_matches(value: &Value, op: MatchOp, text: &str) -> bool {
+    match value {
+        Value::String(s) => text_matches(s, op, text),
+        Value::Number(n) => {
+            // Format into a stack buffer; numbers are at most a few dozen bytes
+            let mut buf = [0u8; 40];
+            let mut cursor = std::io::Cursor::new(&mut buf[..]);
+            if write!(cursor, "{}", n).is_ok() {
+                let len = cursor.position() as usize;
+                std::str::from_utf8(&buf[..len]).is_ok_and(|s| text_matches(s, op, text))
+            } else {
+                text_matches(&n.to_string(), op, text)
+            }
+        }
+        Value::Bool(b) => text_matches(if *b { "true" } else { "false" }, op, text),
+        Value::Null => false,
+        Value::Array(items) => items.iter().any(|v| value_matches(v, op, text)),
+        Value::Object(map) => map.values().any(|v| value_matches(v, op, text)),
+    }
+}
+
+fn text_matches(value: &str, op: MatchOp, text: &str) -> bool {
+    let (value, text) = (value.as_bytes(), text.as_bytes());
+    match op {
+        MatchOp::Equals => value.eq_ignore_ascii_case(text),
+        MatchOp::Prefix => {
+            value.len() >= text.len() && value[..text.len()].eq_ignore_ascii_case(text)
+        }
+        MatchOp::Contains => {
+            text.is_empty()
+                || value
+                    .windows(text.len())
+                    .any(|w| w.eq_ignore_ascii_case(text))
+        }
+    }
+}
+
+impl ConfigHandle {
+    /// Add a new configuration section (in-place form of [`add_config_section`])
+    pub fn add_config_section(&mut self, section_name: &str) -> Result<()> {
+        let section_name = section_name.to_uppercase();
+
+        // Check if section already exists
+        if self.g2_entry(&section_name).is_some() {
+            return Err(SzConfigError::AlreadyExists(
+                "Configuration section already exists".to_string(),
+            ));
+        }
+
+        // Add new section as empty array
+        if !self.insert_member(&section_name, json!([])) {
+            return Err(SzConfigError::NotFound(
+                "G2_CONFIG section not found in configuration".to_string(),
+            ));
+        }
+
+        Ok(())
+    }
+
+    /// Remove a configuration section (in-place form of [`remove_config_section`])
+    pub fn remove_config_section(&mut self, section_name: &str) -> Result<()> {
+        let section_name = section_name.to_uppercase();
+
+        let removed = self.remove_member(&section_name).is_some();
+
+        if !removed {
+            return Err(SzConfigError::NotFound(format!(
+                "Config section not found: {}",
+                section_name
+            )));
+        }
+
+        Ok(())
+    }
+
+    /// Get items from a configuration section (see [`get_config_section`])
+    ///
+    /// For a `FIELD=value` condition on a field indexed with
+    /// [`index_field`](Self::index_field), only the rows with that value are
+    /// visited.
+    pub fn get_config_section(
+        &self,
+        section_name: &str,
+        filter: Option<&str>,
+    ) -> Result<Vec<Value>> {
+        // Check if section exists
+        let section_data = self.g2_entry(section_name).ok_or_else(|| {
+            SzConfigError::NotFound(format!(
+                "Configuration section '{}' not found",
+                section_name
+            ))
+        })?;
+
+        let filter = filter
+            .filter(|f| !f.trim().is_empty())
+            .map(SectionFilter::parse);
+        let rows: &[Value] = match section_data {
+            // Handle empty section
+            Value::Null => return Ok(Vec::new()),
+            Value::Array(rows) => rows,
+            other => std::slice::from_ref(other),
+        };
+
+        let Some(filter) = filter else {
+            // No filter - return all
+            return Ok(rows.to_vec());
+        };
+
+        let indexed = filter
+            .conditions
+            .iter()
+            .find_map(|c| match (&c.field, c.op) {
+                (Some(field), MatchOp::Equals) => self
+                    .field_index(section_name, field)
+                    .map(|index| index.candidates(&c.text)),
+                _ => None,
+            });
+
+        Ok(match indexed {
+            Some(candidates) => candidates
+                .into_iter()
+                .filter_map(|i| rows.get(i))
+                .filter(|row| filter.matches(row))
+                .cloned()
+                .collect(),
+            None => rows
+                .iter()
+                .filter(|row| filter.matches(row))
+                .cloned()
+                .collect(),
+        })
+    }
+
+    /// List all configuration section names (see [`list_config_sections`])
+    pub fn list_config_sections(&self) -> Vec<String> {
+        self.g2_config()
+            .map(|obj| obj.keys().cloned().collect())
+            .unwrap_or_default()
+    }
+
+    /// Add a field to all items in a section (in-place form of [`add_config_section_field`])
+    ///
+    /// Returns the number of items updated.
+    pub fn add_config_section_field(
+        &mut self,
+        section_name: &str,
+        field_name: &str,
+        field_value: &Value,
+    ) -> Result<usize> {
+        let section_name = section_name.to_uppercase();
+        let field_name = field_name.to_uppercase();
+        let mut item_count = 0;
+
+        // Navigate to section and add field to all items in the array
+        if self.g2_config().is_some() {
+            if let Ok(section_array) = self.section_mut(&section_name) {
+                for item in section_array.iter_mut() {
+                    if let Some(item_obj) = item.as_object_mut() {
+                        item_obj.insert(field_name.clone(), field_value.clone());
+                        item_count += 1;
+                    }
+                }
+            } else {
+                return Err(SzConfigError::NotFound(format!(
+                    "Section not found or not an array: {}",
+                    section_name
+                )));
+            }
+        }
+
+        Ok(item_count)
+    }
+
+    /// Remove a field from all items in a section (in-place form of [`remove_config_section_field`])
+    ///
+    /// Returns the number of items that had the field.
+    pub fn remove_config_section_field(
+        &mut self,
+        section_name: &str,
+        field_name: &str,
+    ) -> Result<usize> {
+        let section_name = section_name.to_uppercase();
+        let field_name = field_name.to_uppercase();
+        let mut item_count = 0;
+
+        // Navigate to section and remove field from all items in the array
+        if self.g2_config().is_some() {
+            if let Ok(section_array) = self.section_mut(&section_name) {
+                for item in section_array.iter_mut() {
+                    if let Some(item_obj) = item.as_object_mut() {
+                        if item_obj.remove(&field_name).is_some() {
+                            item_count += 1;
+                        }
+                    }
+                }
+            } else {
+                return Err(SzConfigError::NotFound(format!(
+                    "Section not found or not an array: {}",
+                    section_name
+                )));
+            }
+        }
+
+        Ok(item_count)
+    }
+}
 
 /// Add a new configuration section
 ///
@@ -26,30 +336,9 @@ use serde_json::{Value, json};
 /// let modified = config_sections::add_config_section(config, "CFG_CUSTOM").unwrap();
 /// ```
 pub fn add_config_section(config_json: &str, section_name: &str) -> Result<String> {
-    let section_name = section_name.to_uppercase();
-    let mut config_data: Value = serde_json::from_str(config_json)?;
-
-    // Check if section already exists
-    if let Some(g2_config) = config_data.get("G2_CONFIG") {
-        if g2_config.get(&section_name).is_some() {
-            return Err(SzConfigError::AlreadyExists(
-                "Configuration section already exists".to_string(),
-            ));
-        }
-    }
-
-    // Add new section as empty array
-    if let Some(g2_config) = config_data.get_mut("G2_CONFIG") {
-        if let Some(obj) = g2_config.as_object_mut() {
-            obj.insert(section_name.clone(), json!([]));
-        }
-    } else {
-        return Err(SzConfigError::NotFound(
-            "G2_CONFIG section not found in configuration".to_string(),
-        ));
-    }
-
-    Ok(serde_json::to_string(&config_data)?)
+    handle::edit(config_json, |config| {
+        config.add_config_section(section_name)
+    })
 }
 
 /// Remove a configuration section
@@ -72,26 +361,9 @@ pub fn add_config_section(config_json: &str, section_name: &str) -> Result<Strin
 /// let modified = config_sections::remove_config_section(config, "CFG_CUSTOM").unwrap();
 /// ```
 pub fn remove_config_section(config_json: &str, section_name: &str) -> Result<String> {
-    let section_name = section_name.to_uppercase();
-    let mut config_data: Value = serde_json::from_str(config_json)?;
-    let mut removed = false;
-
-    if let Some(g2_config) = config_data.get_mut("G2_CONFIG") {
-        if let Some(g2_config_obj) = g2_config.as_object_mut() {
-            if g2_config_obj.remove(&section_name).is_some() {
-                removed = true;
-            }
-        }
-    }
-
-    if !removed {
-        return Err(SzConfigError::NotFound(format!(
-            "Config section not found: {}",
-            section_name
-        )));
-    }
-
-    Ok(serde_json::to_string(&config_data)?)
+    handle::edit(config_json, |config| {
+        config.remove_config_section(section_name)
+    })
 }
 
 /// Get items from a configuration section with optional filtering
@@ -100,7 +372,9 @@ pub fn remove_config_section(config_json: &str, section_name: &str) -> Result<St
 ///
 /// * `config_json` - Configuration JSON string
 /// * `section_name` - Name of the section to get
-/// * `filter` - Optional filter string to search in records
+/// * `filter` - Optional filter: `FIELD=value` / `FIELD^=prefix` /
+///   `FIELD*=text` conditions joined by `&`, or free text matched against
+///   record values (see [`SectionFilter`])
 ///
 /// # Returns
 ///
@@ -120,60 +394,9 @@ pub fn get_config_section(
     section_name: &str,
     filter: Option<&str>,
 ) -> Result<Vec<Value>> {
-    let config_data: Value = serde_json::from_str(config_json)?;
-
-    // Check if section exists
-    let section_data = config_data
-        .get("G2_CONFIG")
-        .and_then(|g2| g2.get(section_name))
-        .ok_or_else(|| {
-            SzConfigError::NotFound(format!(
-                "Configuration section '{}' not found",
-                section_name
-            ))
-        })?;
-
-    // Handle empty section
-    if section_data.is_null()
-        || (section_data.is_array() && section_data.as_array().unwrap().is_empty())
-    {
-        return Ok(Vec::new());
-    }
-
-    // Apply filter if provided
-    let output_data = if let Some(filter_str) = filter {
-        if let Some(array) = section_data.as_array() {
-            array
-                .iter()
-                .filter(|record| {
-                    serde_json::to_string(record)
-                        .unwrap_or_default()
-                        .to_lowercase()
-                        .contains(&filter_str.to_lowercase())
-                })
-                .cloned()
-                .collect()
-        } else {
-            // Not an array, just check the single value
-            let as_string = serde_json::to_string(section_data)
-                .unwrap_or_default()
-                .to_lowercase();
-            if as_string.contains(&filter_str.to_lowercase()) {
-                vec![section_data.clone()]
-            } else {
-                Vec::new()
-            }
-        }
-    } else {
-        // No filter - return all
-        if let Some(array) = section_data.as_array() {
-            array.clone()
-        } else {
-            vec![section_data.clone()]
-        }
-    };
-
-    Ok(output_data)
+    handle::read_sections(config_json, &[section_name], |config| {
+        config.get_config_section(section_name, filter)
+    })
 }
 
 /// List all configuration section names
@@ -196,19 +419,7 @@ pub fn get_config_section(
 /// assert!(sections.contains(&"CFG_ATTR".to_string()));
 /// ```
 pub fn list_config_sections(config_json: &str) -> Result<Vec<String>> {
-    let config_data: Value = serde_json::from_str(config_json)?;
-
-    let sections = if let Some(g2_config) = config_data.get("G2_CONFIG") {
-        if let Some(obj) = g2_config.as_object() {
-            obj.keys().cloned().collect()
-        } else {
-            Vec::new()
-        }
-    } else {
-        Vec::new()
-    };
-
-    Ok(sections)
+    handle::read(config_json, |config| Ok(config.list_config_sections()))
 }
 
 /// Add a field to all items in a configuration section
@@ -245,32 +456,9 @@ pub fn add_config_section_field(
     field_name: &str,
     field_value: &Value,
 ) -> Result<(String, usize)> {
-    let section_name = section_name.to_uppercase();
-    let field_name = field_name.to_uppercase();
-    let mut config_data: Value = serde_json::from_str(config_json)?;
-    let mut item_count = 0;
-
-    // Navigate to section and add field to all items in the array
-    if let Some(g2_config) = config_data.get_mut("G2_CONFIG") {
-        if let Some(section_array) = g2_config
-            .get_mut(&section_name)
-            .and_then(|v| v.as_array_mut())
-        {
-            for item in section_array.iter_mut() {
-                if let Some(item_obj) = item.as_object_mut() {
-                    item_obj.insert(field_name.clone(), field_value.clone());
-                    item_count += 1;
-                }
-            }
-        } else {
-            return Err(SzConfigError::NotFound(format!(
-                "Section not found or not an array: {}",
-                section_name
-            )));
-        }
-    }
-
-    Ok((serde_json::to_string(&config_data)?, item_count))
+    handle::edit_returning(config_json, |config| {
+        config.add_config_section_field(section_name, field_name, field_value)
+    })
 }
 
 /// Remove a field from all items in a configuration section
@@ -303,31 +491,72 @@ pub fn remove_config_section_field(
     section_name: &str,
     field_name: &str,
 ) -> Result<(String, usize)> {
-    let section_name = section_name.to_uppercase();
-    let field_name = field_name.to_uppercase();
-    let mut config_data: Value = serde_json::from_str(config_json)?;
-    let mut item_count = 0;
-
-    // Navigate to section and remove field from all items in the array
-    if let Some(g2_config) = config_data.get_mut("G2_CONFIG") {
-        if let Some(section_array) = g2_config
-            .get_mut(&section_name)
-            .and_then(|v| v.as_array_mut())
-        {
-            for item in section_array.iter_mut() {
-                if let Some(item_obj) = item.as_object_mut() {
-                    if item_obj.remove(&field_name).is_some() {
-                        item_count += 1;
-                    }
-                }
-            }
-        } else {
-            return Err(SzConfigError::NotFound(format!(
-                "Section not found or not an array: {}",
-                section_name
-            )));
-        }
+    handle::edit_returning(config_json, |config| {
+        config.remove_config_section_field(section_name, field_name)
+    })
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn config() -> ConfigHandle {
+        ConfigHandle::from_value(json!({"G2_CONFIG": {"CFG_FBOM": [
+            {"FTYPE_ID": 1, "FELEM_ID": 2, "FELEM_CODE": "GIVEN_NAME"},
+            {"FTYPE_ID": 1, "FELEM_ID": 3, "FELEM_CODE": "SUR_NAME"},
+            {"FTYPE_ID": 10, "FELEM_ID": 2, "FELEM_CODE": "GIVEN_NAME"}
+        ]}}))
+    }
+
+    #[test]
+    fn test_get_config_section_field_filters() {
+        let config = config();
+        let ids = |filter: &str| -> Vec<i64> {
+            config
+                .get_config_section("CFG_FBOM", Some(filter))
+                .unwrap()
+                .iter()
+                .map(|row| {
+                    row["FTYPE_ID"].as_i64().unwrap() * 10 + row["FELEM_ID"].as_i64().unwrap()
+                })
+                .collect()
+        };
+
+        assert_eq!(ids("FTYPE_ID=1"), vec![12, 13]);
+        assert_eq!(ids("ftype_id = 1 & felem_code^=sur"), vec![13]);
+        assert_eq!(ids("FELEM_CODE*=VEN"), vec![12, 102]);
+        // Free text matches values, not field names
+        assert_eq!(ids("given"), vec![12, 102]);
+        assert!(ids("FELEM").is_empty());
+        assert_eq!(ids(" ").len(), 3);
     }
 
-    Ok((serde_json::to_string(&config_data)?, item_count))
+    #[test]
+    fn test_get_config_section_uses_field_index() {
+        let mut config = config();
+        config.index_field("CFG_FBOM", "FELEM_ID").unwrap();
+        config
+            .push_row("CFG_FBOM", json!({"FTYPE_ID": 20, "FELEM_ID": 2}))
+            .unwrap();
+
+        let rows = config
+            .get_config_section("CFG_FBOM", Some("FELEM_ID=2&FTYPE_ID^=1"))
+            .unwrap();
+        assert_eq!(rows.len(), 2);
+        let rows = config
+            .get_config_section("CFG_FBOM", Some("FELEM_ID=2"))
+            .unwrap();
+        assert_eq!(rows.len(), 3);
+        assert_eq!(rows[2]["FTYPE_ID"], 20);
+
+        // Dropped on other mutations
+        config.section_mut("CFG_FBOM").unwrap().truncate(1);
+        assert_eq!(
+            config
+                .get_config_section("CFG_FBOM", Some("FELEM_ID=2"))
+                .unwrap()
+                .len(),
+            1
+        );
+    }
 }
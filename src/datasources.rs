@@ -1,6 +1,7 @@
 use crate::error::{Result, SzConfigError};
-use crate::helpers;
+use crate::handle::{self, ConfigHandle};
 use serde_json::{Value, json};
+use std::collections::HashSet;
 
 // ============================================================================
 // Parameter Structs
@@ -60,6 +61,125 @@ impl<'a> TryFrom<&'a Value> for SetDataSourceParams<'a> {
     }
 }
 
+impl ConfigHandle {
+    /// Add a new data source (in-place form of [`add_data_source`])
+    pub fn add_data_source(&mut self, params: AddDataSourceParams) -> Result<()> {
+        self.add_data_sources(std::slice::from_ref(&params))
+    }
+
+    /// Add several data sources (in-place form of [`add_data_sources`])
+    pub fn add_data_sources(&mut self, data_sources: &[AddDataSourceParams]) -> Result<()> {
+        // Validate the whole batch before touching the document
+        self.section("CFG_DSRC")?;
+        let codes: Vec<String> = data_sources.iter().map(|p| p.code.to_uppercase()).collect();
+        let mut batch = HashSet::with_capacity(codes.len());
+        for code in &codes {
+            if !batch.insert(code.as_str())
+                || self.has_code("CFG_DSRC", "DSRC_CODE", "DSRC_ID", code)
+            {
+                return Err(SzConfigError::AlreadyExists(format!(
+                    "Data source already exists: {}",
+                    code
+                )));
+            }
+        }
+
+        let first_id = self.next_id("CFG_DSRC", "DSRC_ID", None)?;
+        for ((params, code_upper), id) in data_sources.iter().zip(codes).zip(first_id..) {
+            // Use parameters or defaults (matching Python behavior)
+            let retention = params.retention_level.unwrap_or("Remember");
+            let conversational_flag = params.conversational.unwrap_or("No");
+            let reliability_score = params.reliability.unwrap_or(1);
+
+            self.push_row(
+                "CFG_DSRC",
+                json!({
+                    "DSRC_ID": id,
+                    "DSRC_CODE": code_upper.clone(),
+                    "DSRC_DESC": code_upper,  // Python uses code as description, not formatted string
+                    "DSRC_RELY": reliability_score,
+                    "RETENTION_LEVEL": retention,
+                    "CONVERSATIONAL": conversational_flag,
+                }),
+            )?;
+        }
+        Ok(())
+    }
+
+    /// Delete a data source (in-place form of [`delete_data_source`])
+    pub fn delete_data_source(&mut self, code: &str) -> Result<()> {
+        let dsrcs = self.section_mut("CFG_DSRC")?;
+
+        let code_upper = code.to_uppercase();
+        let original_len = dsrcs.len();
+        dsrcs.retain(|d| d["DSRC_CODE"].as_str() != Some(&code_upper));
+
+        if dsrcs.len() == original_len {
+            return Err(SzConfigError::NotFound(format!(
+                "Data source not found: {}",
+                code_upper
+            )));
+        }
+
+        Ok(())
+    }
+
+    /// Get a specific data source by code (see [`get_data_source`])
+    pub fn get_data_source(&self, code: &str) -> Result<Value> {
+        let code_upper = code.to_uppercase();
+        self.section("CFG_DSRC")?
+            .iter()
+            .find(|d| d["DSRC_CODE"].as_str() == Some(&code_upper))
+            .cloned()
+            .ok_or_else(|| {
+                SzConfigError::NotFound(format!("Data source not found: {}", code_upper))
+            })
+    }
+
+    /// List all data sources (see [`list_data_sources`])
+    pub fn list_data_sources(&self) -> Result<Vec<Value>> {
+        let dsrcs = self.section("CFG_DSRC")?;
+
+        Ok(dsrcs
+            .iter()
+            .map(|item| {
+                json!({
+                    "id": item.get("DSRC_ID").and_then(|v| v.as_i64()).unwrap_or(0),
+                    "dataSource": item.get("DSRC_CODE").and_then(|v| v.as_str()).unwrap_or("")
+                })
+            })
+            .collect())
+    }
+
+    /// Set (update) a data source's properties (in-place form of [`set_data_source`])
+    pub fn set_data_source(&mut self, params: SetDataSourceParams) -> Result<()> {
+        let code_upper = params.code.to_uppercase();
+        let dsrcs = self.section_mut("CFG_DSRC")?;
+
+        let dsrc = dsrcs
+            .iter_mut()
+            .find(|d| d["DSRC_CODE"].as_str() == Some(&code_upper))
+            .ok_or_else(|| {
+                SzConfigError::NotFound(format!("Data source not found: {}", code_upper))
+            })?;
+
+        // Update fields if provided
+        if let Some(dsrc_obj) = dsrc.as_object_mut() {
+            if let Some(retention) = params.retention_level {
+                dsrc_obj.insert("RETENTION_LEVEL".to_string(), json!(retention));
+            }
+            if let Some(conversational) = params.conversational {
+                dsrc_obj.insert("CONVERSATIONAL".to_string(), json!(conversational));
+            }
+            if let Some(reliability) = params.reliability {
+                dsrc_obj.insert("DSRC_RELY".to_string(), json!(reliability));
+            }
+        }
+
+        Ok(())
+    }
+}
+
 /// Add a new data source to the configuration
 ///
 /// # Arguments
@@ -74,44 +194,50 @@ impl<'a> TryFrom<&'a Value> for SetDataSourceParams<'a> {
 /// - `JsonParse` if config_json is invalid
 /// - `MissingSection` if CFG_DSRC section doesn't exist
 pub fn add_data_source(config_json: &str, params: AddDataSourceParams) -> Result<String> {
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let dsrcs = config
-        .get_mut("G2_CONFIG")
-        .and_then(|g| g.get_mut("CFG_DSRC"))
-        .and_then(|v| v.as_array_mut())
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_DSRC".to_string()))?;
-
-    // Check for duplicates
-    let code_upper = params.code.to_uppercase();
-    if dsrcs
-        .iter()
-        .any(|d| d["DSRC_CODE"].as_str() == Some(&code_upper))
-    {
-        return Err(SzConfigError::AlreadyExists(format!(
-            "Data source already exists: {}",
-            code_upper
-        )));
-    }
-
-    let next_id = helpers::get_next_id_from_array(dsrcs, "DSRC_ID")?;
-
-    // Use parameters or defaults (matching Python behavior)
-    let retention = params.retention_level.unwrap_or("Remember");
-    let conversational_flag = params.conversational.unwrap_or("No");
-    let reliability_score = params.reliability.unwrap_or(1);
-
-    dsrcs.push(json!({
-        "DSRC_ID": next_id,
-        "DSRC_CODE": code_upper.clone(),
-        "DSRC_DESC": code_upper,  // Python uses code as description, not formatted string
-        "DSRC_RELY": reliability_score,
-        "RETENTION_LEVEL": retention,
-        "CONVERSATIONAL": conversational_flag,
-    }));
+    handle::edit(config_json, |config| config.add_data_source(params))
+}
 
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+/// Add several data sources to the configuration
+///
+/// Produces the same configuration as calling [`add_data_source`] for each
+/// entry in turn, with one parse and one serialize for the whole batch. Every
+/// code is checked first, so on error nothing is added.
+///
+/// # Arguments
+/// * `config_json` - JSON configuration string
+/// * `data_sources` - Data source parameters, added in order
+///
+/// # Returns
+/// Modified configuration JSON string
+///
+/// # Errors
+/// - `AlreadyExists` if a code already exists or is listed twice
+/// - `JsonParse` if config_json is invalid
+/// - `MissingSection` if CFG_DSRC section doesn't exist
+///
+/// # Example
+/// ```
+/// use sz_configtool_lib::datasources::{self, AddDataSourceParams};
+///
+/// let config = r#"{"G2_CONFIG":{"CFG_DSRC":[{"DSRC_ID":1,"DSRC_CODE":"TEST"}]}}"#;
+/// let batch = ["CUSTOMERS", "WATCHLIST"].map(|code| AddDataSourceParams {
+///     code,
+///     ..Default::default()
+/// });
+/// let modified = datasources::add_data_sources(config, &batch)?;
+/// assert!(modified.contains(r#""DSRC_ID":3,"DSRC_CODE":"WATCHLIST""#));
+///
+/// // "TEST" exists already, so neither code is added
+/// let test = AddDataSourceParams {
+///     code: "test",
+///     ..Default::default()
+/// };
+/// let clash = [batch[0].clone(), test];
+/// assert!(datasources::add_data_sources(config, &clash).is_err());
+/// # Ok::<(), sz_configtool_lib::SzConfigError>(())
+/// ```
+pub fn add_data_sources(config_json: &str, data_sources: &[AddDataSourceParams]) -> Result<String> {
+    handle::edit(config_json, |config| config.add_data_sources(data_sources))
 }
 
 /// Delete a data source from the configuration
@@ -128,27 +254,7 @@ pub fn add_data_source(config_json: &str, params: AddDataSourceParams) -> Result
 /// - `JsonParse` if config_json is invalid
 /// - `MissingSection` if CFG_DSRC section doesn't exist
 pub fn delete_data_source(config_json: &str, code: &str) -> Result<String> {
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let dsrcs = config
-        .get_mut("G2_CONFIG")
-        .and_then(|g| g.get_mut("CFG_DSRC"))
-        .and_then(|v| v.as_array_mut())
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_DSRC".to_string()))?;
-
-    let code_upper = code.to_uppercase();
-    let original_len = dsrcs.len();
-    dsrcs.retain(|d| d["DSRC_CODE"].as_str() != Some(&code_upper));
-
-    if dsrcs.len() == original_len {
-        return Err(SzConfigError::NotFound(format!(
-            "Data source not found: {}",
-            code_upper
-        )));
-    }
-
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config_json, |config| config.delete_data_source(code))
 }
 
 /// Get a specific data source by code
@@ -165,19 +271,9 @@ pub fn delete_data_source(config_json: &str, code: &str) -> Result<String> {
 /// - `JsonParse` if config_json is invalid
 /// - `MissingSection` if CFG_DSRC section doesn't exist
 pub fn get_data_source(config_json: &str, code: &str) -> Result<Value> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let code_upper = code.to_uppercase();
-    config
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_DSRC"))
-        .and_then(|v| v.as_array())
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_DSRC".to_string()))?
-        .iter()
-        .find(|d| d["DSRC_CODE"].as_str() == Some(&code_upper))
-        .cloned()
-        .ok_or_else(|| SzConfigError::NotFound(format!("Data source not found: {}", code_upper)))
+    handle::read_sections(config_json, &["CFG_DSRC"], |config| {
+        config.get_data_source(code)
+    })
 }
 
 /// List all data sources
@@ -193,24 +289,9 @@ pub fn get_data_source(config_json: &str, code: &str) -> Result<Value> {
 /// - `JsonParse` if config_json is invalid
 /// - `MissingSection` if CFG_DSRC section doesn't exist
 pub fn list_data_sources(config_json: &str) -> Result<Vec<Value>> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let dsrcs = config
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_DSRC"))
-        .and_then(|v| v.as_array())
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_DSRC".to_string()))?;
-
-    Ok(dsrcs
-        .iter()
-        .map(|item| {
-            json!({
-                "id": item.get("DSRC_ID").and_then(|v| v.as_i64()).unwrap_or(0),
-                "dataSource": item.get("DSRC_CODE").and_then(|v| v.as_str()).unwrap_or("")
-            })
-        })
-        .collect())
+    handle::read_sections(config_json, &["CFG_DSRC"], |config| {
+        config.list_data_sources()
+    })
 }
 
 /// Set (update) a data source's properties
@@ -227,33 +308,5 @@ pub fn list_data_sources(config_json: &str) -> Result<Vec<Value>> {
 /// - `JsonParse` if config_json is invalid
 /// - `MissingSection` if CFG_DSRC section doesn't exist
 pub fn set_data_source(config_json: &str, params: SetDataSourceParams) -> Result<String> {
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let code_upper = params.code.to_uppercase();
-    let dsrcs = config
-        .get_mut("G2_CONFIG")
-        .and_then(|g| g.get_mut("CFG_DSRC"))
-        .and_then(|v| v.as_array_mut())
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_DSRC".to_string()))?;
-
-    let dsrc = dsrcs
-        .iter_mut()
-        .find(|d| d["DSRC_CODE"].as_str() == Some(&code_upper))
-        .ok_or_else(|| SzConfigError::NotFound(format!("Data source not found: {}", code_upper)))?;
-
-    // Update fields if provided
-    if let Some(dsrc_obj) = dsrc.as_object_mut() {
-        if let Some(retention) = params.retention_level {
-            dsrc_obj.insert("RETENTION_LEVEL".to_string(), json!(retention));
-        }
-        if let Some(conversational) = params.conversational {
-            dsrc_obj.insert("CONVERSATIONAL".to_string(), json!(conversational));
-        }
-        if let Some(reliability) = params.reliability {
-            dsrc_obj.insert("DSRC_RELY".to_string(), json!(reliability));
-        }
-    }
-
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config_json, |config| config.set_data_source(params))
 }
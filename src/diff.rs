@@ -0,0 +1,464 @@
+//! Structural diff between two configurations
+//!
+//! The `CFG_*` sections are arrays whose order carries no meaning, so a
+//! positional JSON diff reports every row after a reordering or insertion as
+//! changed. [`diff_configs`] instead joins the rows of each section on the
+//! section's primary key (see [`SECTION_KEYS`]) and reports rows that were
+//! added, removed or changed. Arrays without a known key are compared as
+//! multisets of whole rows; other members (`SYS_OOM`, `CONFIG_BASE_VERSION`,
+//! ...) are compared as values.
+//!
+//! Sections are diffed in parallel when the configurations are large.
+//!
+//! # Example
+//!
+//! ```
+//! use sz_configtool_lib::diff;
+//!
+//! let live = r#"{"G2_CONFIG":{"CFG_DSRC":[
+//!     {"DSRC_ID":1,"DSRC_CODE":"TEST","DSRC_DESC":"Test"},
+//!     {"DSRC_ID":2,"DSRC_CODE":"SEARCH","DSRC_DESC":"Search"}]}}"#;
+//! let candidate = r#"{"G2_CONFIG":{"CFG_DSRC":[
+//!     {"DSRC_ID":2,"DSRC_CODE":"SEARCH","DSRC_DESC":"Search"},
+//!     {"DSRC_ID":1,"DSRC_CODE":"TEST","DSRC_DESC":"Testing"}]}}"#;
+//!
+//! let report: serde_json::Value = serde_json::from_str(&diff::diff_configs(live, candidate)?)?;
+//! let dsrc = &report["sections"][0];
+//! assert_eq!(dsrc["section"], "CFG_DSRC");
+//! assert_eq!(dsrc["changed"][0]["key"]["DSRC_CODE"], "TEST");
+//! assert_eq!(dsrc["changed"][0]["fields"][0], "DSRC_DESC");
+//! # Ok::<(), Box<dyn std::error::Error>>(())
+//! ```
+
+use crate::error::{Result, SzConfigError};
+use crate::handle::ConfigHandle;
+use crate::helpers::run_parallel;
+use serde_json::{Map, Value, json};
+use std::collections::HashMap;
+use std::thread;
+
+/// Primary key fields of each known `CFG_*` section
+pub const SECTION_KEYS: &[(&str, &[&str])] = &[
+    ("CFG_ATTR", &["ATTR_CODE"]),
+    ("CFG_CFBOM", &["CFCALL_ID", "FTYPE_ID", "FELEM_ID"]),
+    ("CFG_CFCALL", &["CFCALL_ID"]),
+    ("CFG_CFRTN", &["CFRTN_ID"]),
+    ("CFG_CFUNC", &["CFUNC_ID"]),
+    ("CFG_DFBOM", &["DFCALL_ID", "FTYPE_ID", "FELEM_ID"]),
+    ("CFG_DFCALL", &["DFCALL_ID"]),
+    ("CFG_DFUNC", &["DFUNC_ID"]),
+    ("CFG_DSRC", &["DSRC_CODE"]),
+    ("CFG_EFBOM", &["EFCALL_ID", "FTYPE_ID", "FELEM_ID"]),
+    ("CFG_EFCALL", &["EFCALL_ID"]),
+    ("CFG_EFUNC", &["EFUNC_ID"]),
+    ("CFG_ERFRAG", &["ERFRAG_CODE"]),
+    ("CFG_ERRULE", &["ERRULE_CODE"]),
+    ("CFG_FBOM", &["FTYPE_ID", "FELEM_ID"]),
+    ("CFG_FBOVR", &["FTYPE_ID", "UTYPE_CODE"]),
+    ("CFG_FCLASS", &["FCLASS_ID"]),
+    ("CFG_FELEM", &["FELEM_ID"]),
+    ("CFG_FTYPE", &["FTYPE_ID"]),
+    (
+        "CFG_GENERIC_THRESHOLD",
+        &["GPLAN_ID", "BEHAVIOR", "FTYPE_ID"],
+    ),
+    ("CFG_GPLAN", &["GPLAN_ID"]),
+    ("CFG_RTYPE", &["RTYPE_ID"]),
+    ("CFG_SFCALL", &["SFCALL_ID"]),
+    ("CFG_SFUNC", &["SFUNC_ID"]),
+];
+
+/// Total rows above which sections are diffed on several threads
+const PARALLEL_THRESHOLD: usize = 20_000;
+
+/// Key fields of a section (empty if unknown)
+fn key_fields(section: &str) -> &'static [&'static str] {
+    SECTION_KEYS
+        .iter()
+        .find(|(name, _)| *name == section)
+        .map_or(&[], |(_, fields)| fields)
+}
+
+/// A row present in both configurations whose fields differ
+#[derive(Debug, Clone, PartialEq)]
+pub struct RowChange {
+    /// Key fields of the row
+    pub key: Value,
+    /// Names of the fields that were added, removed or changed
+    pub fields: Vec<String>,
+    pub before: Value,
+    pub after: Value,
+}
+
+/// How one `G2_CONFIG` member differs
+#[derive(Debug, Clone, PartialEq)]
+pub enum SectionChange {
+    /// Array section present in both configurations, joined on its key
+    Rows {
+        added: Vec<Value>,
+        removed: Vec<Value>,
+        changed: Vec<RowChange>,
+    },
+    /// Member only in the second configuration
+    Added(Value),
+    /// Member only in the first configuration
+    Removed(Value),
+    /// Non-array member whose value differs
+    Replaced { before: Value, after: Value },
+}
+
+/// Differences in one `G2_CONFIG` member
+#[derive(Debug, Clone, PartialEq)]
+pub struct SectionDiff {
+    pub section: String,
+    pub change: SectionChange,
+}
+
+/// Differences between two configurations, one entry per differing member
+#[derive(Debug, Clone, Default, PartialEq)]
+pub struct ConfigDiff {
+    /// Members in the order of the first configuration, then new members
+    pub sections: Vec<SectionDiff>,
+}
+
+impl ConfigDiff {
+    /// True if the configurations are equal
+    pub fn is_empty(&self) -> bool {
+        self.sections.is_empty()
+    }
+
+    /// Report as JSON
+    ///
+    /// ```text
+    /// {"summary": {"sections": 2, "added": 1, "removed": 0, "changed": 1},
+    ///  "sections": [
+    ///    {"section": "CFG_DSRC", "key": ["DSRC_CODE"], "added": [...],
+    ///     "removed": [...], "changed": [{"key": {...}, "fields": [...],
+    ///                                    "before": {...}, "after": {...}}]},
+    ///    {"section": "CFG_NEW", "status": "added", "value": [...]},
+    ///    {"section": "SYS_OOM", "status": "replaced", "before": {...}, "after": {...}}]}
+    /// ```
+    pub fn to_json(&self) -> Value {
+        let (mut added, mut removed, mut changed) = (0, 0, 0);
+        let sections: Vec<Value> = self
+            .sections
+            .iter()
+            .map(|s| match &s.change {
+                SectionChange::Rows {
+                    added: a,
+                    removed: r,
+                    changed: c,
+                } => {
+                    added += a.len();
+                    removed += r.len();
+                    changed += c.len();
+                    json!({
+                        "section": s.section,
+                        "key": key_fields(&s.section),
+                        "added": a,
+                        "removed": r,
+                        "changed": c.iter().map(|c| json!({
+                            "key": c.key,
+                            "fields": c.fields,
+                            "before": c.before,
+                            "after": c.after,
+                        })).collect::<Vec<_>>(),
+                    })
+                }
+                SectionChange::Added(value) => {
+                    json!({"section": s.section, "status": "added", "value": value})
+                }
+                SectionChange::Removed(value) => {
+                    json!({"section": s.section, "status": "removed", "value": value})
+                }
+                SectionChange::Replaced { before, after } => json!({
+                    "section": s.section,
+                    "status": "replaced",
+                    "before": before,
+                    "after": after,
+                }),
+            })
+            .collect();
+
+        json!({
+            "summary": {
+                "sections": sections.len(),
+                "added": added,
+                "removed": removed,
+                "changed": changed,
+            },
+            "sections": sections,
+        })
+    }
+}
+
+/// Diff two configuration JSON strings
+///
+/// The documents are parsed in parallel.
+///
+/// # Returns
+/// JSON report (see [`ConfigDiff::to_json`])
+///
+/// # Errors
+/// - `JsonParse` if either document is invalid
+/// - `MissingSection` if either has no `G2_CONFIG` object
+pub fn diff_configs(config_a: &str, config_b: &str) -> Result<String> {
+    let (a, b) = thread::scope(|scope| {
+        let a = scope.spawn(|| ConfigHandle::from_json(config_a));
+        let b = ConfigHandle::from_json(config_b);
+        (a.join().expect("parse thread panicked"), b)
+    });
+    Ok(a?.diff_configs(&b?)?.to_json().to_string())
+}
+
+impl ConfigHandle {
+    /// Diff this configuration against another (in-place form of [`diff_configs`])
+    ///
+    /// # Errors
+    /// - `MissingSection` if either configuration has no `G2_CONFIG` object
+    pub fn diff_configs(&self, other: &ConfigHandle) -> Result<ConfigDiff> {
+        let missing = || SzConfigError::MissingSection("G2_CONFIG".to_string());
+        let a = self.g2_config().ok_or_else(missing)?;
+        let b = other.g2_config().ok_or_else(missing)?;
+
+        let members: Vec<(&str, Option<&Value>, Option<&Value>)> = a
+            .iter()
+            .map(|(name, value)| (name.as_str(), Some(value), b.get(name)))
+            .chain(
+                b.iter()
+                    .filter(|(name, _)| !a.contains_key(*name))
+                    .map(|(name, value)| (name.as_str(), None, Some(value))),
+            )
+            .collect();
+
+        let rows: usize = members
+            .iter()
+            .map(|(_, x, y)| row_count(*x) + row_count(*y))
+            .sum();
+        let threads = if rows > PARALLEL_THRESHOLD {
+            thread::available_parallelism().map_or(1, |n| n.get())
+        } else {
+            1
+        };
+
+        let sections = run_parallel(members.len(), threads, |i| {
+            let (name, before, after) = members[i];
+            diff_member(name, before, after)
+        });
+
+        Ok(ConfigDiff {
+            sections: sections.into_iter().flatten().collect(),
+        })
+    }
+}
+
+fn row_count(value: Option<&Value>) -> usize {
+    value
+        .and_then(|v| v.as_array())
+        .map_or(0, |rows| rows.len())
+}
+
+fn diff_member(name: &str, before: Option<&Value>, after: Option<&Value>) -> Option<SectionDiff> {
+    let change = match (before, after) {
+        (Some(a), Some(b)) if a == b => return None,
+        (Some(Value::Array(a)), Some(Value::Array(b))) => match diff_rows(key_fields(name), a, b) {
+            // Only the row order differs
+            SectionChange::Rows {
+                added,
+                removed,
+                changed,
+            } if added.is_empty() && removed.is_empty() && changed.is_empty() => return None,
+            rows => rows,
+        },
+        (Some(a), Some(b)) => SectionChange::Replaced {
+            before: a.clone(),
+            after: b.clone(),
+        },
+        (Some(a), None) => SectionChange::Removed(a.clone()),
+        (None, Some(b)) => SectionChange::Added(b.clone()),
+        (None, None) => return None,
+    };
+    Some(SectionDiff {
+        section: name.to_string(),
+        change,
+    })
+}
+
+/// Hash-join two sections on their key fields
+///
+/// Rows sharing a key are paired in order of appearance. Without key fields
+/// the whole row is the key, so rows can only be added or removed.
+fn diff_rows(fields: &[&str], a: &[Value], b: &[Value]) -> SectionChange {
+    let key_of = |row: &Value| -> String {
+        if fields.is_empty() {
+            return row.to_string();
+        }
+        let mut key = String::new();
+        for field in fields {
+            key.push_str(&row.get(*field).unwrap_or(&Value::Null).to_string());
+            key.push('\u{1f}');
+        }
+        key
+    };
+
+    // Key → indexes into `a`, last first so pop() pairs in order of appearance
+    let mut before: HashMap<String, Vec<usize>> = HashMap::with_capacity(a.len());
+    for (i, row) in a.iter().enumerate().rev() {
+        before.entry(key_of(row)).or_default().push(i);
+    }
+
+    let mut claimed = vec![false; a.len()];
+    let mut added = Vec::new();
+    let mut changed = Vec::new();
+    for row in b {
+        let Some(i) = before.get_mut(&key_of(row)).and_then(|rows| rows.pop()) else {
+            added.push(row.clone());
+            continue;
+        };
+        claimed[i] = true;
+        let old = &a[i];
+        if old != row {
+            changed.push(RowChange {
+                key: Value::Object(
+                    fields
+                        .iter()
+                        .map(|f| (f.to_string(), row.get(*f).cloned().unwrap_or_default()))
+                        .collect::<Map<_, _>>(),
+                ),
+                fields: changed_fields(old, row),
+                before: old.clone(),
+                after: row.clone(),
+            });
+        }
+    }
+
+    let removed = a
+        .iter()
+        .zip(&claimed)
+        .filter(|(_, claimed)| !**claimed)
+        .map(|(row, _)| row.clone())
+        .collect();
+
+    SectionChange::Rows {
+        added,
+        removed,
+        changed,
+    }
+}
+
+/// Names of the fields that differ between two rows
+fn changed_fields(before: &Value, after: &Value) -> Vec<String> {
+    match (before.as_object(), after.as_object()) {
+        (Some(a), Some(b)) => a
+            .iter()
+            .filter(|(k, v)| b.get(*k) != Some(*v))
+            .map(|(k, _)| k.clone())
+            .chain(b.keys().filter(|k| !a.contains_key(*k)).cloned())
+            .collect(),
+        _ => Vec::new(),
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_diff_ignores_row_order() {
+        let a = ConfigHandle::from_value(json!({"G2_CONFIG": {
+            "CFG_FTYPE": [{"FTYPE_ID": 1, "FTYPE_CODE": "NAME"},
+                          {"FTYPE_ID": 2, "FTYPE_CODE": "ADDRESS"},
+                          {"FTYPE_ID": 3, "FTYPE_CODE": "PHONE"}],
+            "CFG_CUSTOM": [1, 2, 2],
+            "SYS_OOM": {"NAME_HASH": []},
+            "CFG_OLD": [],
+        }}));
+        let b = ConfigHandle::from_value(json!({"G2_CONFIG": {
+            "CFG_FTYPE": [{"FTYPE_ID": 3, "FTYPE_CODE": "PHONE_NUMBER"},
+                          {"FTYPE_ID": 1, "FTYPE_CODE": "NAME"},
+                          {"FTYPE_ID": 4, "FTYPE_CODE": "EMAIL"}],
+            "CFG_CUSTOM": [2, 1, 3],
+            "SYS_OOM": {"NAME_HASH": ["X"]},
+        }}));
+
+        let diff = a.diff_configs(&b).unwrap();
+        let names: Vec<&str> = diff.sections.iter().map(|s| s.section.as_str()).collect();
+        assert_eq!(names, ["CFG_FTYPE", "CFG_CUSTOM", "SYS_OOM", "CFG_OLD"]);
+
+        let SectionChange::Rows {
+            added,
+            removed,
+            changed,
+        } = &diff.sections[0].change
+        else {
+            panic!("expected rows");
+        };
+        assert_eq!(added, &[json!({"FTYPE_ID": 4, "FTYPE_CODE": "EMAIL"})]);
+        assert_eq!(removed, &[json!({"FTYPE_ID": 2, "FTYPE_CODE": "ADDRESS"})]);
+        assert_eq!(changed[0].key, json!({"FTYPE_ID": 3}));
+        assert_eq!(changed[0].fields, ["FTYPE_CODE"]);
+
+        // Unkeyed arrays are compared as multisets
+        assert_eq!(
+            diff.sections[1].change,
+            SectionChange::Rows {
+                added: vec![json!(3)],
+                removed: vec![json!(2)],
+                changed: vec![],
+            }
+        );
+        assert!(matches!(diff.sections[3].change, SectionChange::Removed(_)));
+
+        let report = diff.to_json();
+        assert_eq!(report["summary"]["added"], 2);
+        assert_eq!(report["sections"][2]["status"], "replaced");
+
+        assert!(a.diff_configs(&a).unwrap().is_empty());
+    }
+
+    #[test]
+    fn test_diff_reorder_only_is_empty() {
+        let a = ConfigHandle::from_value(json!({"G2_CONFIG": {
+            "CFG_DSRC": [{"DSRC_ID": 1, "DSRC_CODE": "A"}, {"DSRC_ID": 2, "DSRC_CODE": "B"}],
+            "CFG_CUSTOM": [1, 2],
+        }}));
+        let b = ConfigHandle::from_value(json!({"G2_CONFIG": {
+            "CFG_DSRC": [{"DSRC_ID": 2, "DSRC_CODE": "B"}, {"DSRC_ID": 1, "DSRC_CODE": "A"}],
+            "CFG_CUSTOM": [2, 1],
+        }}));
+
+        let diff = a.diff_configs(&b).unwrap();
+        assert!(diff.is_empty());
+        assert_eq!(diff.to_json()["summary"]["sections"], 0);
+    }
+
+    #[test]
+    fn test_parallel_matches_serial() {
+        let rows = |n: i64, desc: &str| -> Vec<Value> {
+            (0..n)
+                .map(|i| json!({"FELEM_ID": i, "FELEM_CODE": format!("E{i}"), "FELEM_DESC": desc}))
+                .collect()
+        };
+        let a = json!({"G2_CONFIG": {"CFG_FELEM": rows(15_000, "a"), "CFG_FBOM": []}});
+        let mut b = json!({"G2_CONFIG": {"CFG_FELEM": rows(15_001, "a"), "CFG_FBOM": []}});
+        b["G2_CONFIG"]["CFG_FELEM"][7]["FELEM_DESC"] = json!("b");
+
+        let a = ConfigHandle::from_value(a);
+        let b = ConfigHandle::from_value(b);
+        let diff = a.diff_configs(&b).unwrap();
+        let SectionChange::Rows { added, changed, .. } = &diff.sections[0].change else {
+            panic!("expected rows");
+        };
+        assert_eq!(added.len(), 1);
+        assert_eq!(changed.len(), 1);
+        assert_eq!(changed[0].key, json!({"FELEM_ID": 7}));
+    }
+
+    #[test]
+    fn test_diff_configs_requires_g2_config() {
+        assert!(matches!(
+            diff_configs("{}", r#"{"G2_CONFIG":{}}"#),
+            Err(SzConfigError::MissingSection(_))
+        ));
+    }
+}
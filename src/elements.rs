@@ -1,5 +1,5 @@
 use crate::error::{Result, SzConfigError};
-use crate::helpers;
+use crate::handle::{self, ConfigHandle};
 use serde_json::{Value, json};
 
 // ============================================================================
@@ -146,59 +146,186 @@ impl<'a> TryFrom<&'a Value> for SetFeatureElementParams<'a> {
     }
 }
 
-/// Add a new element (CFG_FELEM record)
-///
-/// # Arguments
-/// * `config_json` - JSON configuration string
-/// * `params` - Element parameters (code required, others optional)
-///
-/// # Returns
-/// Modified configuration JSON string
-pub fn add_element(config_json: &str, params: AddElementParams) -> Result<String> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let code_upper = params.code.to_uppercase();
-
-    // Check if already exists
-    let felem_array = config["G2_CONFIG"]["CFG_FELEM"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FELEM".to_string()))?;
-
-    if felem_array
-        .iter()
-        .any(|e| e["FELEM_CODE"].as_str() == Some(code_upper.as_str()))
-    {
-        return Err(SzConfigError::AlreadyExists(format!(
-            "Element already exists: {}",
-            code_upper
-        )));
+impl ConfigHandle {
+    /// Add a new element (in-place form of [`add_element`])
+    pub fn add_element(&mut self, params: AddElementParams) -> Result<()> {
+        let code_upper = params.code.to_uppercase();
+
+        // Check if already exists
+        let felem_array = self.section("CFG_FELEM")?;
+
+        if felem_array
+            .iter()
+            .any(|e| e["FELEM_CODE"].as_str() == Some(code_upper.as_str()))
+        {
+            return Err(SzConfigError::AlreadyExists(format!(
+                "Element already exists: {}",
+                code_upper
+            )));
+        }
+
+        // Get next ID
+        let felem_id = self.next_id("CFG_FELEM", "FELEM_ID", Some(1000))?;
+
+        // Build record from params
+        let mut new_record = json!({
+            "FELEM_ID": felem_id,
+            "FELEM_CODE": code_upper.clone(),
+        });
+
+        if let Some(obj) = new_record.as_object_mut() {
+            if let Some(desc) = params.description {
+                obj.insert("FELEM_DESC".to_string(), json!(desc));
+            } else {
+                obj.insert("FELEM_DESC".to_string(), json!(code_upper));
+            }
+            if let Some(dt) = params.data_type {
+                obj.insert("DATA_TYPE".to_string(), json!(dt));
+            }
+            if let Some(tok) = params.tokenized {
+                obj.insert("TOKENIZED".to_string(), json!(tok));
+            }
+        }
+
+        self.push_row("CFG_FELEM", new_record)
     }
 
-    // Get next ID
-    let felem_id = helpers::get_next_id_with_min(felem_array, "FELEM_ID", 1000)?;
+    /// Delete an element (in-place form of [`delete_element`])
+    pub fn delete_element(&mut self, felem_code: &str) -> Result<()> {
+        let code_upper = felem_code.to_uppercase();
+
+        let felem_array = self.section_mut("CFG_FELEM")?;
 
-    // Build record from params
-    let mut new_record = json!({
-        "FELEM_ID": felem_id,
-        "FELEM_CODE": code_upper.clone(),
-    });
+        let original_len = felem_array.len();
+        felem_array.retain(|e| e["FELEM_CODE"].as_str() != Some(code_upper.as_str()));
 
-    if let Some(obj) = new_record.as_object_mut() {
-        if let Some(desc) = params.description {
-            obj.insert("FELEM_DESC".to_string(), json!(desc));
-        } else {
-            obj.insert("FELEM_DESC".to_string(), json!(code_upper));
+        if felem_array.len() == original_len {
+            return Err(SzConfigError::NotFound(format!(
+                "Element not found: {}",
+                code_upper
+            )));
         }
-        if let Some(dt) = params.data_type {
-            obj.insert("DATA_TYPE".to_string(), json!(dt));
+
+        Ok(())
+    }
+
+    /// Get a specific element by code (see [`get_element`])
+    pub fn get_element(&self, felem_code: &str) -> Result<Value> {
+        let code_upper = felem_code.to_uppercase();
+
+        self.section("CFG_FELEM")?
+            .iter()
+            .find(|e| e["FELEM_CODE"].as_str() == Some(code_upper.as_str()))
+            .cloned()
+            .ok_or_else(|| SzConfigError::NotFound(format!("Element not found: {}", code_upper)))
+    }
+
+    /// List all elements (see [`list_elements`])
+    pub fn list_elements(&self) -> Result<Vec<Value>> {
+        let felem_array = self.section("CFG_FELEM")?;
+
+        let mut result: Vec<Value> = felem_array
+            .iter()
+            .map(|item| {
+                json!({
+                    "id": item["FELEM_ID"].as_i64().unwrap_or(0),
+                    "element": item["FELEM_CODE"].as_str().unwrap_or(""),
+                    "datatype": item["DATA_TYPE"].as_str().unwrap_or("")
+                })
+            })
+            .collect();
+
+        // Sort by element code (alphabetic) like Python
+        result.sort_by_key(|e| e["element"].as_str().unwrap_or("").to_string());
+
+        Ok(result)
+    }
+
+    /// Set (update) an element's properties (in-place form of [`set_element`])
+    pub fn set_element(&mut self, params: SetElementParams) -> Result<()> {
+        let code_upper = params.code.to_uppercase();
+
+        let felem_array = self.section_mut("CFG_FELEM")?;
+
+        // Find and update the element
+        let felem = felem_array
+            .iter_mut()
+            .find(|e| e["FELEM_CODE"].as_str() == Some(code_upper.as_str()))
+            .ok_or_else(|| SzConfigError::NotFound(format!("Element: {}", code_upper.clone())))?;
+
+        // Update fields from params
+        if let Some(dest_obj) = felem.as_object_mut() {
+            if let Some(desc) = params.description {
+                dest_obj.insert("FELEM_DESC".to_string(), json!(desc));
+            }
+            if let Some(dt) = params.data_type {
+                dest_obj.insert("DATA_TYPE".to_string(), json!(dt));
+            }
+            if let Some(tok) = params.tokenized {
+                dest_obj.insert("TOKENIZED".to_string(), json!(tok));
+            }
         }
-        if let Some(tok) = params.tokenized {
-            obj.insert("TOKENIZED".to_string(), json!(tok));
+
+        Ok(())
+    }
+
+    /// Set feature element (in-place form of [`set_feature_element`])
+    pub fn set_feature_element(&mut self, params: SetFeatureElementParams) -> Result<()> {
+        // Resolve codes to IDs
+        let feature_code = params
+            .feature_code
+            .ok_or_else(|| SzConfigError::MissingField("feature_code".to_string()))?;
+        let element_code = params
+            .element_code
+            .ok_or_else(|| SzConfigError::MissingField("element_code".to_string()))?;
+
+        let ftype_id = self.lookup_feature_id(feature_code)?;
+        let felem_id = self.lookup_element_id(element_code)?;
+
+        let fbom_array = self.section_mut("CFG_FBOM")?;
+
+        // Find the FBOM record
+        let fbom = fbom_array
+            .iter_mut()
+            .find(|item| {
+                item["FTYPE_ID"].as_i64() == Some(ftype_id)
+                    && item["FELEM_ID"].as_i64() == Some(felem_id)
+            })
+            .ok_or_else(|| {
+                SzConfigError::NotFound(format!(
+                    "Feature element mapping not found: FTYPE_ID={}, FELEM_ID={}",
+                    ftype_id, felem_id
+                ))
+            })?;
+
+        // Update fields if provided
+        if let Some(order) = params.exec_order {
+            fbom["EXEC_ORDER"] = json!(order);
+        }
+        if let Some(level) = params.display_level {
+            fbom["DISPLAY_LEVEL"] = json!(level);
+        }
+        if let Some(delim) = params.display_delim {
+            fbom["DISPLAY_DELIM"] = json!(delim);
         }
+        if let Some(der) = params.derived {
+            fbom["DERIVED"] = json!(der);
+        }
+
+        Ok(())
     }
+}
 
-    helpers::add_to_config_array(config_json, "CFG_FELEM", new_record)
+/// Add a new element (CFG_FELEM record)
+///
+/// # Arguments
+/// * `config_json` - JSON configuration string
+/// * `params` - Element parameters (code required, others optional)
+///
+/// # Returns
+/// Modified configuration JSON string
+pub fn add_element(config_json: &str, params: AddElementParams) -> Result<String> {
+    handle::edit(config_json, |config| config.add_element(params))
 }
 
 /// Delete an element (CFG_FELEM record)
@@ -210,32 +337,7 @@ pub fn add_element(config_json: &str, params: AddElementParams) -> Result<String
 /// # Returns
 /// Modified configuration JSON string
 pub fn delete_element(config_json: &str, felem_code: &str) -> Result<String> {
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let code_upper = felem_code.to_uppercase();
-
-    // Verify exists
-    let felem_array = config["G2_CONFIG"]["CFG_FELEM"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FELEM".to_string()))?;
-
-    if !felem_array
-        .iter()
-        .any(|e| e["FELEM_CODE"].as_str() == Some(code_upper.as_str()))
-    {
-        return Err(SzConfigError::NotFound(format!(
-            "Element not found: {}",
-            code_upper
-        )));
-    }
-
-    // Remove from array
-    if let Some(array) = config["G2_CONFIG"]["CFG_FELEM"].as_array_mut() {
-        array.retain(|e| e["FELEM_CODE"].as_str() != Some(code_upper.as_str()));
-    }
-
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config_json, |config| config.delete_element(felem_code))
 }
 
 /// Get a specific element by code
@@ -247,20 +349,9 @@ pub fn delete_element(config_json: &str, felem_code: &str) -> Result<String> {
 /// # Returns
 /// JSON Value representing the element
 pub fn get_element(config_json: &str, felem_code: &str) -> Result<Value> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let code_upper = felem_code.to_uppercase();
-
-    let felem_array = config["G2_CONFIG"]["CFG_FELEM"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FELEM".to_string()))?;
-
-    felem_array
-        .iter()
-        .find(|e| e["FELEM_CODE"].as_str() == Some(code_upper.as_str()))
-        .cloned()
-        .ok_or_else(|| SzConfigError::NotFound(format!("Element not found: {}", code_upper)))
+    handle::read_sections(config_json, &["CFG_FELEM"], |config| {
+        config.get_element(felem_code)
+    })
 }
 
 /// List all elements
@@ -271,28 +362,7 @@ pub fn get_element(config_json: &str, felem_code: &str) -> Result<Value> {
 /// # Returns
 /// Vector of JSON Values representing elements with id, element, and datatype fields, sorted by FELEM_ID
 pub fn list_elements(config_json: &str) -> Result<Vec<Value>> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let felem_array = config["G2_CONFIG"]["CFG_FELEM"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FELEM".to_string()))?;
-
-    let mut result: Vec<Value> = felem_array
-        .iter()
-        .map(|item| {
-            json!({
-                "id": item["FELEM_ID"].as_i64().unwrap_or(0),
-                "element": item["FELEM_CODE"].as_str().unwrap_or(""),
-                "datatype": item["DATA_TYPE"].as_str().unwrap_or("")
-            })
-        })
-        .collect();
-
-    // Sort by element code (alphabetic) like Python
-    result.sort_by_key(|e| e["element"].as_str().unwrap_or("").to_string());
-
-    Ok(result)
+    handle::read_sections(config_json, &["CFG_FELEM"], |config| config.list_elements())
 }
 
 /// Set (update) an element's properties
@@ -304,35 +374,7 @@ pub fn list_elements(config_json: &str) -> Result<Vec<Value>> {
 /// # Returns
 /// Modified configuration JSON string
 pub fn set_element(config_json: &str, params: SetElementParams) -> Result<String> {
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let code_upper = params.code.to_uppercase();
-
-    let felem_array = config["G2_CONFIG"]["CFG_FELEM"]
-        .as_array_mut()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FELEM".to_string()))?;
-
-    // Find and update the element
-    let felem = felem_array
-        .iter_mut()
-        .find(|e| e["FELEM_CODE"].as_str() == Some(code_upper.as_str()))
-        .ok_or_else(|| SzConfigError::NotFound(format!("Element: {}", code_upper.clone())))?;
-
-    // Update fields from params
-    if let Some(dest_obj) = felem.as_object_mut() {
-        if let Some(desc) = params.description {
-            dest_obj.insert("FELEM_DESC".to_string(), json!(desc));
-        }
-        if let Some(dt) = params.data_type {
-            dest_obj.insert("DATA_TYPE".to_string(), json!(dt));
-        }
-        if let Some(tok) = params.tokenized {
-            dest_obj.insert("TOKENIZED".to_string(), json!(tok));
-        }
-    }
-
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config_json, |config| config.set_element(params))
 }
 
 /// Set feature element (update FBOM record)
@@ -357,53 +399,7 @@ pub fn set_element(config_json: &str, params: SetElementParams) -> Result<String
 /// # Ok::<(), sz_configtool_lib::error::SzConfigError>(())
 /// ```
 pub fn set_feature_element(config_json: &str, params: SetFeatureElementParams) -> Result<String> {
-    // Resolve codes to IDs
-    let feature_code = params
-        .feature_code
-        .ok_or_else(|| SzConfigError::MissingField("feature_code".to_string()))?;
-    let element_code = params
-        .element_code
-        .ok_or_else(|| SzConfigError::MissingField("element_code".to_string()))?;
-
-    let ftype_id = helpers::lookup_feature_id(config_json, feature_code)?;
-    let felem_id = helpers::lookup_element_id(config_json, element_code)?;
-
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let fbom_array = config["G2_CONFIG"]["CFG_FBOM"]
-        .as_array_mut()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FBOM".to_string()))?;
-
-    // Find the FBOM record
-    let fbom = fbom_array
-        .iter_mut()
-        .find(|item| {
-            item["FTYPE_ID"].as_i64() == Some(ftype_id)
-                && item["FELEM_ID"].as_i64() == Some(felem_id)
-        })
-        .ok_or_else(|| {
-            SzConfigError::NotFound(format!(
-                "Feature element mapping not found: FTYPE_ID={}, FELEM_ID={}",
-                ftype_id, felem_id
-            ))
-        })?;
-
-    // Update fields if provided
-    if let Some(order) = params.exec_order {
-        fbom["EXEC_ORDER"] = json!(order);
-    }
-    if let Some(level) = params.display_level {
-        fbom["DISPLAY_LEVEL"] = json!(level);
-    }
-    if let Some(delim) = params.display_delim {
-        fbom["DISPLAY_DELIM"] = json!(delim);
-    }
-    if let Some(der) = params.derived {
-        fbom["DERIVED"] = json!(der);
-    }
-
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config_json, |config| config.set_feature_element(params))
 }
 
 /// Set feature element display level
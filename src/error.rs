@@ -1,7 +1,7 @@
 use std::fmt;
 
 /// Custom error type for configuration operations
-#[derive(Debug)]
+#[derive(Debug, Clone)]
 pub enum SzConfigError {
     /// JSON parsing error
     JsonParse(String),
@@ -1,6 +1,8 @@
 use crate::error::{Result, SzConfigError};
+use crate::handle::{self, ConfigHandle};
 use crate::helpers;
 use serde_json::{Value, json};
+use std::collections::{HashMap, HashSet};
 
 // ============================================================================
 // Parameter Structs
@@ -276,97 +278,117 @@ const LOCKED_FEATURES: &[&str] = &[
     "DRIVERS_LICENSE_NUM",
 ];
 
-/// Add a new feature to the configuration
-///
-/// # Arguments
-/// * `config_json` - JSON configuration string
-/// * `params` - Feature parameters (feature, element_list required; others optional)
-///
-/// # Returns
-/// Modified configuration JSON string
-///
-/// # Example
-/// ```no_run
-/// use sz_configtool_lib::features::{add_feature, AddFeatureParams};
-/// use serde_json::json;
-///
-/// let config = r#"{"G2_CONFIG":{"CFG_FTYPE":[],...}}"#;
-/// let elements = json!([{"element": "NAME"}]);
-/// let result = add_feature(config, AddFeatureParams {
-///     feature: "PERSON",
-///     element_list: &elements,
-///     class: Some("IDENTITY"),
-///     behavior: Some("FM"),
-///     ..Default::default()
-/// })?;
-/// # Ok::<(), sz_configtool_lib::error::SzConfigError>(())
-/// ```
-pub fn add_feature(config_json: &str, params: AddFeatureParams) -> Result<String> {
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let feature_upper = params.feature.to_uppercase();
-
-    // Check if feature already exists
-    let ftypes = config
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_FTYPE"))
-        .and_then(|v| v.as_array())
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FTYPE".to_string()))?;
-
-    if ftypes
-        .iter()
-        .any(|f| f["FTYPE_CODE"].as_str() == Some(&feature_upper))
-    {
-        return Err(SzConfigError::AlreadyExists(format!(
-            "Feature already exists: {}",
-            feature_upper
-        )));
-    }
-
-    // Validate element_list
-    let elements = params
-        .element_list
-        .as_array()
-        .ok_or_else(|| SzConfigError::InvalidInput("elementList must be an array".to_string()))?;
+/// One `elementList` entry of [`AddFeatureParams`], normalized before any edit is made
+struct FeatureElement {
+    code: String,
+    expressed: String,
+    compared: String,
+    display_level: i64,
+    display_delim: Option<String>,
+    derived: String,
+}
 
-    if elements.is_empty() {
-        return Err(SzConfigError::InvalidInput(
-            "elementList must contain at least one element".to_string(),
-        ));
+/// Parse an `elementList` entry (either a plain element code or an object)
+fn parse_feature_element(element_item: &Value, fbom_order: usize) -> Result<FeatureElement> {
+    if let Some(elem_str) = element_item.as_str() {
+        return Ok(FeatureElement {
+            code: elem_str.to_uppercase(),
+            expressed: "No".to_string(),
+            compared: "No".to_string(),
+            display_level: 1,
+            display_delim: None,
+            derived: "No".to_string(),
+        });
     }
 
-    // Get defaults from params
-    let class = params.class.unwrap_or("OTHER");
-    let behavior = params.behavior.unwrap_or("FM");
-    let candidates_val = params.candidates.unwrap_or("No");
-    let anonymize_val = params.anonymize.unwrap_or("No");
-    let derived_val = params.derived.unwrap_or("No");
-    let history_val = params.history.unwrap_or("Yes");
-
-    // matchkey default depends on whether comparison is specified
-    let matchkey_val = params.matchkey.unwrap_or(if params.comparison.is_some() {
-        "Yes"
+    let elem_obj = element_item.as_object().ok_or_else(|| {
+        SzConfigError::InvalidInput(format!(
+            "Invalid element in elementList item {}",
+            fbom_order
+        ))
+    })?;
+
+    let code = elem_obj
+        .get("element")
+        .or_else(|| elem_obj.get("ELEMENT"))
+        .and_then(|v| v.as_str())
+        .ok_or_else(|| {
+            SzConfigError::InvalidInput(format!(
+                "Missing element code in elementList item {}",
+                fbom_order
+            ))
+        })?
+        .to_uppercase();
+
+    let expressed = elem_obj
+        .get("expressed")
+        .or_else(|| elem_obj.get("EXPRESSED"))
+        .and_then(|v| v.as_str())
+        .unwrap_or("No")
+        .to_uppercase();
+
+    let compared = elem_obj
+        .get("compared")
+        .or_else(|| elem_obj.get("COMPARED"))
+        .and_then(|v| v.as_str())
+        .unwrap_or("No")
+        .to_uppercase();
+
+    // Handle display (backwards compatibility)
+    let display_level = if let Some(display) = elem_obj
+        .get("display")
+        .or_else(|| elem_obj.get("DISPLAY"))
+        .and_then(|v| v.as_str())
+    {
+        if display.eq_ignore_ascii_case("yes") {
+            1
+        } else {
+            0
+        }
     } else {
-        "No"
-    });
-
-    // Get next FTYPE_ID (seed at 1000 for user-created features)
-    let ftype_id = helpers::get_next_id_with_min(ftypes, "FTYPE_ID", 1000)?;
-
-    // Parse behavior code (like Python's parseFeatureBehavior)
-    // Valid frequency codes: A1, F1, FF, FM, FVM, NONE, NAME
-    // E suffix means EXCLUSIVITY = "Yes"
-    // S suffix means STABILITY = "Yes"
-    let behavior_upper = behavior.to_uppercase();
-    let (frequency, exclusivity, stability) = parse_behavior_code(&behavior_upper)?;
+        elem_obj
+            .get("displaylevel")
+            .or_else(|| elem_obj.get("DISPLAYLEVEL"))
+            .or_else(|| elem_obj.get("display_level"))
+            .and_then(|v| v.as_i64())
+            .unwrap_or(1)
+    };
 
-    // Lookup feature class
-    let fclass_array = config["G2_CONFIG"]["CFG_FCLASS"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FCLASS".to_string()))?;
+    let display_delim = elem_obj
+        .get("displaydelim")
+        .or_else(|| elem_obj.get("DISPLAYDELIM"))
+        .or_else(|| elem_obj.get("display_delim"))
+        .and_then(|v| v.as_str())
+        .map(|s| s.to_string());
+
+    let derived = elem_obj
+        .get("derived")
+        .or_else(|| elem_obj.get("DERIVED"))
+        .and_then(|v| v.as_str())
+        .map(|s| {
+            if s.eq_ignore_ascii_case("yes") {
+                "Yes"
+            } else {
+                "No"
+            }
+            .to_string()
+        })
+        .unwrap_or_else(|| "No".to_string());
+
+    Ok(FeatureElement {
+        code,
+        expressed,
+        compared,
+        display_level,
+        display_delim,
+        derived,
+    })
+}
 
-    let fclass_id = fclass_array
+/// Find a feature class ID by code (case-insensitive)
+fn lookup_fclass_id(config: &ConfigHandle, class: &str) -> Result<i64> {
+    config
+        .section("CFG_FCLASS")?
         .iter()
         .find(|c| {
             c["FCLASS_CODE"]
@@ -375,469 +397,837 @@ pub fn add_feature(config_json: &str, params: AddFeatureParams) -> Result<String
                 .unwrap_or(false)
         })
         .and_then(|c| c["FCLASS_ID"].as_i64())
-        .ok_or_else(|| SzConfigError::NotFound(format!("Feature class: {}", class)))?;
+        .ok_or_else(|| SzConfigError::NotFound(format!("Feature class: {}", class)))
+}
 
-    // Lookup optional functions
-    let sfunc_id = if let Some(func_code) = params.standardize {
-        lookup_sfunc_id(&config, func_code).unwrap_or(0)
-    } else {
-        0
-    };
+impl ConfigHandle {
+    /// Add a new feature (in-place form of [`add_feature`])
+    ///
+    /// All inputs are validated before the first record is written, so a
+    /// failed call leaves the configuration untouched.
+    pub fn add_feature(&mut self, params: AddFeatureParams) -> Result<()> {
+        let feature_upper = params.feature.to_uppercase();
 
-    let efunc_id = if let Some(func_code) = params.expression {
-        lookup_efunc_id(&config, func_code).unwrap_or(0)
-    } else {
-        0
-    };
+        // Check if feature already exists
+        let ftypes = self.section("CFG_FTYPE")?;
 
-    let cfunc_id = if let Some(func_code) = params.comparison {
-        lookup_cfunc_id(&config, func_code).unwrap_or(0)
-    } else {
-        0
-    };
+        if ftypes
+            .iter()
+            .any(|f| f["FTYPE_CODE"].as_str() == Some(&feature_upper))
+        {
+            return Err(SzConfigError::AlreadyExists(format!(
+                "Feature already exists: {}",
+                feature_upper
+            )));
+        }
 
-    // Validate that elements are marked expressed/compared if functions are specified
-    if efunc_id > 0 || cfunc_id > 0 {
-        let mut expressed_cnt = 0;
-        let mut compared_cnt = 0;
-
-        for element_item in elements {
-            if let Some(obj) = element_item.as_object() {
-                if obj
-                    .get("expressed")
-                    .or_else(|| obj.get("EXPRESSED"))
-                    .and_then(|v| v.as_str())
-                    .map(|s| s.eq_ignore_ascii_case("yes"))
-                    .unwrap_or(false)
-                {
-                    expressed_cnt += 1;
+        // Validate element_list
+        let elements = params.element_list.as_array().ok_or_else(|| {
+            SzConfigError::InvalidInput("elementList must be an array".to_string())
+        })?;
+
+        if elements.is_empty() {
+            return Err(SzConfigError::InvalidInput(
+                "elementList must contain at least one element".to_string(),
+            ));
+        }
+
+        // Get defaults from params
+        let class = params.class.unwrap_or("OTHER");
+        let behavior = params.behavior.unwrap_or("FM");
+        let candidates_val = params.candidates.unwrap_or("No");
+        let anonymize_val = params.anonymize.unwrap_or("No");
+        let derived_val = params.derived.unwrap_or("No");
+        let history_val = params.history.unwrap_or("Yes");
+
+        // matchkey default depends on whether comparison is specified
+        let matchkey_val = params.matchkey.unwrap_or(if params.comparison.is_some() {
+            "Yes"
+        } else {
+            "No"
+        });
+
+        // Get next FTYPE_ID (seed at 1000 for user-created features)
+        let ftype_id = self.next_id("CFG_FTYPE", "FTYPE_ID", Some(1000))?;
+
+        // Parse behavior code (like Python's parseFeatureBehavior)
+        // Valid frequency codes: A1, F1, FF, FM, FVM, NONE, NAME
+        // E suffix means EXCLUSIVITY = "Yes"
+        // S suffix means STABILITY = "Yes"
+        let behavior_upper = behavior.to_uppercase();
+        let (frequency, exclusivity, stability) = parse_behavior_code(&behavior_upper)?;
+
+        // Lookup feature class
+        let fclass_id = lookup_fclass_id(self, class)?;
+
+        // Lookup optional functions
+        let sfunc_id = if let Some(func_code) = params.standardize {
+            lookup_sfunc_id(self.as_value(), func_code).unwrap_or(0)
+        } else {
+            0
+        };
+
+        let efunc_id = if let Some(func_code) = params.expression {
+            lookup_efunc_id(self.as_value(), func_code).unwrap_or(0)
+        } else {
+            0
+        };
+
+        let cfunc_id = if let Some(func_code) = params.comparison {
+            lookup_cfunc_id(self.as_value(), func_code).unwrap_or(0)
+        } else {
+            0
+        };
+
+        // Validate that elements are marked expressed/compared if functions are specified
+        if efunc_id > 0 || cfunc_id > 0 {
+            let mut expressed_cnt = 0;
+            let mut compared_cnt = 0;
+
+            for element_item in elements {
+                if let Some(obj) = element_item.as_object() {
+                    if obj
+                        .get("expressed")
+                        .or_else(|| obj.get("EXPRESSED"))
+                        .and_then(|v| v.as_str())
+                        .map(|s| s.eq_ignore_ascii_case("yes"))
+                        .unwrap_or(false)
+                    {
+                        expressed_cnt += 1;
+                    }
+                    if obj
+                        .get("compared")
+                        .or_else(|| obj.get("COMPARED"))
+                        .and_then(|v| v.as_str())
+                        .map(|s| s.eq_ignore_ascii_case("yes"))
+                        .unwrap_or(false)
+                    {
+                        compared_cnt += 1;
+                    }
                 }
-                if obj
-                    .get("compared")
-                    .or_else(|| obj.get("COMPARED"))
-                    .and_then(|v| v.as_str())
-                    .map(|s| s.eq_ignore_ascii_case("yes"))
-                    .unwrap_or(false)
-                {
-                    compared_cnt += 1;
+            }
+
+            if efunc_id > 0 && expressed_cnt == 0 {
+                return Err(SzConfigError::InvalidInput(
+                    "No elements marked \"expressed\" for expression routine".to_string(),
+                ));
+            }
+            if cfunc_id > 0 && compared_cnt == 0 {
+                return Err(SzConfigError::InvalidInput(
+                    "No elements marked \"compared\" for comparison routine".to_string(),
+                ));
+            }
+        }
+
+        // Normalize the element list and check every section we are about to
+        // write, so nothing below can fail halfway through
+        let parsed_elements = elements
+            .iter()
+            .enumerate()
+            .map(|(i, item)| parse_feature_element(item, i + 1))
+            .collect::<Result<Vec<_>>>()?;
+
+        let sfcall_id = if sfunc_id > 0 {
+            Some(self.next_id("CFG_SFCALL", "SFCALL_ID", Some(1000))?)
+        } else {
+            None
+        };
+        let efcall_id = if efunc_id > 0 {
+            self.next_id("CFG_EFCALL", "EFCALL_ID", Some(1000))?
+        } else {
+            0
+        };
+        let cfcall_id = if cfunc_id > 0 {
+            self.next_id("CFG_CFCALL", "CFCALL_ID", Some(1000))?
+        } else {
+            0
+        };
+
+        let felem_array = self.section("CFG_FELEM")?;
+        for element in &parsed_elements {
+            if let Some(felem) = felem_array
+                .iter()
+                .find(|e| e["FELEM_CODE"].as_str() == Some(element.code.as_str()))
+            {
+                if felem["FELEM_ID"].as_i64().is_none() {
+                    return Err(SzConfigError::InvalidStructure(
+                        "Invalid FELEM_ID".to_string(),
+                    ));
                 }
             }
         }
 
-        if efunc_id > 0 && expressed_cnt == 0 {
-            return Err(SzConfigError::InvalidInput(
-                "No elements marked \"expressed\" for expression routine".to_string(),
-            ));
+        // Create CFG_FTYPE record
+        let ftype_record = json!({
+            "FTYPE_ID": ftype_id,
+            "FTYPE_CODE": feature_upper.clone(),
+            "FTYPE_DESC": feature_upper.clone(),
+            "FCLASS_ID": fclass_id,
+            "FTYPE_FREQ": frequency,
+            "FTYPE_EXCL": exclusivity,
+            "FTYPE_STAB": stability,
+            "ANONYMIZE": anonymize_val,
+            "DERIVED": derived_val,
+            "USED_FOR_CAND": candidates_val,
+            "SHOW_IN_MATCH_KEY": matchkey_val,
+            "PERSIST_HISTORY": history_val,
+            "VERSION": params.version.unwrap_or(1),
+            "RTYPE_ID": params.rtype_id.unwrap_or(0)
+        });
+
+        // Add to CFG_FTYPE
+        self.push_row("CFG_FTYPE", ftype_record)?;
+
+        // Add standardize call if function specified
+        if let Some(id) = sfcall_id {
+            self.push_row(
+                "CFG_SFCALL",
+                json!({
+                    "SFCALL_ID": id,
+                    "SFUNC_ID": sfunc_id,
+                    "EXEC_ORDER": 1,
+                    "FTYPE_ID": ftype_id,
+                    "FELEM_ID": -1
+                }),
+            )?;
         }
-        if cfunc_id > 0 && compared_cnt == 0 {
-            return Err(SzConfigError::InvalidInput(
-                "No elements marked \"compared\" for comparison routine".to_string(),
-            ));
+
+        // Add expression call if function specified
+        if efcall_id > 0 {
+            self.push_row(
+                "CFG_EFCALL",
+                json!({
+                    "EFCALL_ID": efcall_id,
+                    "EFUNC_ID": efunc_id,
+                    "EXEC_ORDER": 1,
+                    "FTYPE_ID": ftype_id,
+                    "FELEM_ID": -1,
+                    "EFEAT_FTYPE_ID": -1,
+                    "IS_VIRTUAL": "No"
+                }),
+            )?;
         }
+
+        // Add comparison call if function specified
+        if cfcall_id > 0 {
+            self.push_row(
+                "CFG_CFCALL",
+                json!({
+                    "CFCALL_ID": cfcall_id,
+                    "CFUNC_ID": cfunc_id,
+                    "FTYPE_ID": ftype_id
+                }),
+            )?;
+        }
+
+        // Process element list
+        for (index, element) in parsed_elements.into_iter().enumerate() {
+            let fbom_order = index + 1;
+
+            // Get or create element
+            let existing_id = self
+                .section("CFG_FELEM")?
+                .iter()
+                .find(|e| e["FELEM_CODE"].as_str() == Some(element.code.as_str()))
+                .and_then(|felem| felem["FELEM_ID"].as_i64());
+
+            let felem_id = match existing_id {
+                Some(id) => id,
+                None => {
+                    // Create new element
+                    let new_id = self.next_id("CFG_FELEM", "FELEM_ID", Some(1000))?;
+                    self.push_row(
+                        "CFG_FELEM",
+                        json!({
+                            "FELEM_ID": new_id,
+                            "FELEM_CODE": element.code.clone(),
+                            "FELEM_DESC": element.code.clone(),
+                            "DATA_TYPE": "string",
+                            "TOKENIZE": "No"
+                        }),
+                    )?;
+                    new_id
+                }
+            };
+
+            // Add to EFBOM if expressed
+            if efcall_id > 0 && element.expressed.eq_ignore_ascii_case("yes") {
+                if let Ok(array) = self.section_mut("CFG_EFBOM") {
+                    array.push(json!({
+                        "EFCALL_ID": efcall_id,
+                        "EXEC_ORDER": fbom_order,
+                        "FTYPE_ID": ftype_id,
+                        "FELEM_ID": felem_id,
+                        "FELEM_REQ": "Yes"
+                    }));
+                }
+            }
+
+            // Add to CFBOM if compared
+            if cfcall_id > 0 && element.compared.eq_ignore_ascii_case("yes") {
+                if let Ok(array) = self.section_mut("CFG_CFBOM") {
+                    array.push(json!({
+                        "CFCALL_ID": cfcall_id,
+                        "EXEC_ORDER": fbom_order,
+                        "FTYPE_ID": ftype_id,
+                        "FELEM_ID": felem_id
+                    }));
+                }
+            }
+
+            // Add to FBOM (always)
+            let mut fbom_record = json!({
+                "FTYPE_ID": ftype_id,
+                "FELEM_ID": felem_id,
+                "EXEC_ORDER": fbom_order,
+                "DISPLAY_LEVEL": element.display_level,
+                "DERIVED": element.derived
+            });
+
+            if let Some(delim) = element.display_delim {
+                fbom_record["DISPLAY_DELIM"] = json!(delim);
+            }
+
+            if let Ok(array) = self.section_mut("CFG_FBOM") {
+                array.push(fbom_record);
+            }
+        }
+
+        Ok(())
     }
 
-    // Create CFG_FTYPE record
-    let ftype_record = json!({
-        "FTYPE_ID": ftype_id,
-        "FTYPE_CODE": feature_upper.clone(),
-        "FTYPE_DESC": feature_upper.clone(),
-        "FCLASS_ID": fclass_id,
-        "FTYPE_FREQ": frequency,
-        "FTYPE_EXCL": exclusivity,
-        "FTYPE_STAB": stability,
-        "ANONYMIZE": anonymize_val,
-        "DERIVED": derived_val,
-        "USED_FOR_CAND": candidates_val,
-        "SHOW_IN_MATCH_KEY": matchkey_val,
-        "PERSIST_HISTORY": history_val,
-        "VERSION": params.version.unwrap_or(1),
-        "RTYPE_ID": params.rtype_id.unwrap_or(0)
-    });
-
-    // Add to CFG_FTYPE
-    if let Some(ftype_array) = config["G2_CONFIG"]["CFG_FTYPE"].as_array_mut() {
-        ftype_array.push(ftype_record);
+    /// Delete a feature and its dependent records (in-place form of [`delete_feature`])
+    pub fn delete_feature(&mut self, feature_code_or_id: &str) -> Result<()> {
+        self.delete_features(&[feature_code_or_id])
     }
 
-    // Add standardize call if function specified
-    if sfunc_id > 0 {
-        let sfcall_array = config["G2_CONFIG"]["CFG_SFCALL"]
-            .as_array()
-            .ok_or_else(|| SzConfigError::MissingSection("CFG_SFCALL".to_string()))?;
-        let id = helpers::get_next_id_with_min(sfcall_array, "SFCALL_ID", 1000)?;
-        let record = json!({
-            "SFCALL_ID": id,
-            "SFUNC_ID": sfunc_id,
-            "EXEC_ORDER": 1,
-            "FTYPE_ID": ftype_id,
-            "FELEM_ID": -1
-        });
-        if let Some(array) = config["G2_CONFIG"]["CFG_SFCALL"].as_array_mut() {
-            array.push(record);
+    /// Delete several features and their dependent records (in-place form of
+    /// [`delete_features`])
+    pub fn delete_features(&mut self, features: &[&str]) -> Result<()> {
+        // Validate every feature before touching the document
+        let mut ftype_ids = HashSet::new();
+        let mut feature_codes = HashSet::new();
+        for feature_code_or_id in features {
+            let (ftype_id, feature_code) = self.deletable_feature(feature_code_or_id)?;
+
+            // A repeated feature is already gone by the time it comes up again
+            if !ftype_ids.insert(ftype_id) {
+                return Err(SzConfigError::NotFound(format!(
+                    "Feature: {}",
+                    feature_code_or_id
+                )));
+            }
+            feature_codes.insert(feature_code.to_ascii_uppercase());
         }
-    }
 
-    // Add expression call if function specified
-    let efcall_id = if efunc_id > 0 {
-        let efcall_array = config["G2_CONFIG"]["CFG_EFCALL"]
-            .as_array()
-            .ok_or_else(|| SzConfigError::MissingSection("CFG_EFCALL".to_string()))?;
-        let id = helpers::get_next_id_with_min(efcall_array, "EFCALL_ID", 1000)?;
-        let record = json!({
-            "EFCALL_ID": id,
-            "EFUNC_ID": efunc_id,
-            "EXEC_ORDER": 1,
-            "FTYPE_ID": ftype_id,
-            "FELEM_ID": -1,
-            "EFEAT_FTYPE_ID": -1,
-            "IS_VIRTUAL": "No"
-        });
-        if let Some(array) = config["G2_CONFIG"]["CFG_EFCALL"].as_array_mut() {
-            array.push(record);
+        if ftype_ids.is_empty() {
+            return Ok(());
         }
-        id
-    } else {
-        0
-    };
 
-    // Add comparison call if function specified
-    let cfcall_id = if cfunc_id > 0 {
-        let cfcall_array = config["G2_CONFIG"]["CFG_CFCALL"]
-            .as_array()
-            .ok_or_else(|| SzConfigError::MissingSection("CFG_CFCALL".to_string()))?;
-        let id = helpers::get_next_id_with_min(cfcall_array, "CFCALL_ID", 1000)?;
-        let record = json!({
-            "CFCALL_ID": id,
-            "CFUNC_ID": cfunc_id,
-            "FTYPE_ID": ftype_id
+        let owned_by_deleted = |record: &Value| {
+            record["FTYPE_ID"]
+                .as_i64()
+                .is_some_and(|id| ftype_ids.contains(&id))
+        };
+
+        // Sections without dependent rows are left untouched (their indexes
+        // and serialized bytes stay valid)
+        self.remove_rows("CFG_FBOM", owned_by_deleted);
+        self.remove_rows("CFG_ATTR", |record| {
+            record["FTYPE_CODE"]
+                .as_str()
+                .is_some_and(|s| feature_codes.contains(&s.to_ascii_uppercase()))
         });
-        if let Some(array) = config["G2_CONFIG"]["CFG_CFCALL"].as_array_mut() {
-            array.push(record);
+        self.remove_rows("CFG_SFCALL", owned_by_deleted);
+
+        // Delete expression, comparison and distinct calls with their BOM records
+        for (call_section, bom_section, call_id_field) in [
+            ("CFG_EFCALL", "CFG_EFBOM", "EFCALL_ID"),
+            ("CFG_CFCALL", "CFG_CFBOM", "CFCALL_ID"),
+            ("CFG_DFCALL", "CFG_DFBOM", "DFCALL_ID"),
+        ] {
+            let call_ids: HashSet<i64> = self
+                .section(call_section)
+                .map(|arr| {
+                    arr.iter()
+                        .filter(|call| owned_by_deleted(call))
+                        .filter_map(|call| call[call_id_field].as_i64())
+                        .collect()
+                })
+                .unwrap_or_default();
+
+            if !call_ids.is_empty() {
+                self.remove_rows(bom_section, |record| {
+                    record[call_id_field]
+                        .as_i64()
+                        .is_some_and(|id| call_ids.contains(&id))
+                });
+            }
+            self.remove_rows(call_section, owned_by_deleted);
         }
-        id
-    } else {
-        0
-    };
 
-    // Process element list
-    let mut fbom_order = 0;
-    for element_item in elements {
-        fbom_order += 1;
+        // Finally, delete the features themselves
+        self.remove_rows("CFG_FTYPE", owned_by_deleted);
 
-        // Parse element (can be string or object)
-        let (element_code, expressed, compared, display_level, display_delim, elem_derived) =
-            if let Some(elem_str) = element_item.as_str() {
-                (
-                    elem_str.to_uppercase(),
-                    "No".to_string(),
-                    "No".to_string(),
-                    1,
-                    None,
-                    "No".to_string(),
-                )
-            } else if let Some(elem_obj) = element_item.as_object() {
-                let code = elem_obj
-                    .get("element")
-                    .or_else(|| elem_obj.get("ELEMENT"))
-                    .and_then(|v| v.as_str())
-                    .ok_or_else(|| {
-                        SzConfigError::InvalidInput(format!(
-                            "Missing element code in elementList item {}",
-                            fbom_order
-                        ))
-                    })?
-                    .to_uppercase();
-
-                let expr = elem_obj
-                    .get("expressed")
-                    .or_else(|| elem_obj.get("EXPRESSED"))
-                    .and_then(|v| v.as_str())
-                    .unwrap_or("No")
-                    .to_uppercase();
-
-                let comp = elem_obj
-                    .get("compared")
-                    .or_else(|| elem_obj.get("COMPARED"))
-                    .and_then(|v| v.as_str())
-                    .unwrap_or("No")
-                    .to_uppercase();
-
-                // Handle display (backwards compatibility)
-                let disp_level = if let Some(display) = elem_obj
-                    .get("display")
-                    .or_else(|| elem_obj.get("DISPLAY"))
-                    .and_then(|v| v.as_str())
-                {
-                    if display.eq_ignore_ascii_case("yes") {
-                        1
-                    } else {
-                        0
-                    }
-                } else {
-                    elem_obj
-                        .get("displaylevel")
-                        .or_else(|| elem_obj.get("DISPLAYLEVEL"))
-                        .or_else(|| elem_obj.get("display_level"))
-                        .and_then(|v| v.as_i64())
-                        .unwrap_or(1)
-                };
+        Ok(())
+    }
 
-                let disp_delim = elem_obj
-                    .get("displaydelim")
-                    .or_else(|| elem_obj.get("DISPLAYDELIM"))
-                    .or_else(|| elem_obj.get("display_delim"))
-                    .and_then(|v| v.as_str())
-                    .map(|s| s.to_string());
-
-                let elem_deriv = elem_obj
-                    .get("derived")
-                    .or_else(|| elem_obj.get("DERIVED"))
-                    .and_then(|v| v.as_str())
-                    .map(|s| {
-                        if s.eq_ignore_ascii_case("yes") {
-                            "Yes"
-                        } else {
-                            "No"
-                        }
-                        .to_string()
-                    })
-                    .unwrap_or_else(|| "No".to_string());
+    /// Resolve a feature code or ID to (FTYPE_ID, FTYPE_CODE), rejecting
+    /// protected system features
+    fn deletable_feature(&self, feature_code_or_id: &str) -> Result<(i64, &str)> {
+        // Try to parse as ID first, then as code
+        let ftype_id = if let Ok(id) = feature_code_or_id.trim().parse::<i64>() {
+            // Validate ID exists
+            let ftypes = self.section("CFG_FTYPE")?;
 
-                (code, expr, comp, disp_level, disp_delim, elem_deriv)
-            } else {
-                return Err(SzConfigError::InvalidInput(format!(
-                    "Invalid element in elementList item {}",
-                    fbom_order
-                )));
-            };
+            if !ftypes.iter().any(|f| f["FTYPE_ID"].as_i64() == Some(id)) {
+                return Err(SzConfigError::NotFound(format!("Feature: {}", id)));
+            }
+            id
+        } else {
+            lookup_feature_id(self.as_value(), feature_code_or_id)?
+        };
 
-        // Get or create element
-        let felem_array = config["G2_CONFIG"]["CFG_FELEM"]
-            .as_array()
-            .ok_or_else(|| SzConfigError::MissingSection("CFG_FELEM".to_string()))?;
+        // Get feature code for validation
+        let feature_code = self
+            .section("CFG_FTYPE")
+            .ok()
+            .and_then(|arr| {
+                arr.iter()
+                    .find(|f| f["FTYPE_ID"].as_i64() == Some(ftype_id))
+                    .and_then(|f| f["FTYPE_CODE"].as_str())
+            })
+            .ok_or_else(|| SzConfigError::NotFound(format!("Feature: {}", ftype_id)))?;
 
-        let felem_id = if let Some(felem) = felem_array
+        // Check if feature is locked
+        if LOCKED_FEATURES
             .iter()
-            .find(|e| e["FELEM_CODE"].as_str() == Some(element_code.as_str()))
+            .any(|&locked| locked.eq_ignore_ascii_case(feature_code))
         {
-            felem["FELEM_ID"]
-                .as_i64()
-                .ok_or_else(|| SzConfigError::InvalidStructure("Invalid FELEM_ID".to_string()))?
+            return Err(SzConfigError::InvalidInput(format!(
+                "The feature {} cannot be deleted (it is a protected system feature)",
+                feature_code
+            )));
+        }
+
+        Ok((ftype_id, feature_code))
+    }
+
+    /// Get a specific feature by code or ID (see [`get_feature`])
+    pub fn get_feature(&self, feature_code_or_id: &str) -> Result<Value> {
+        let ftypes = self.section("CFG_FTYPE").ok();
+
+        // Try to parse as ID first, then as code
+        let ftype = if let Ok(id) = feature_code_or_id.trim().parse::<i64>() {
+            ftypes
+                .and_then(|arr| arr.iter().find(|f| f["FTYPE_ID"].as_i64() == Some(id)))
+                .ok_or_else(|| SzConfigError::NotFound(format!("Feature: {}", id)))?
         } else {
-            // Create new element
-            let new_id = helpers::get_next_id_with_min(felem_array, "FELEM_ID", 1000)?;
-            let new_element = json!({
-                "FELEM_ID": new_id,
-                "FELEM_CODE": element_code.clone(),
-                "FELEM_DESC": element_code.clone(),
-                "DATA_TYPE": "string",
-                "TOKENIZE": "No"
-            });
-            if let Some(array) = config["G2_CONFIG"]["CFG_FELEM"].as_array_mut() {
-                array.push(new_element);
-            }
-            new_id
+            let code_upper = feature_code_or_id.to_uppercase();
+            ftypes
+                .and_then(|arr| {
+                    arr.iter()
+                        .find(|f| f["FTYPE_CODE"].as_str() == Some(code_upper.as_str()))
+                })
+                .ok_or_else(|| SzConfigError::NotFound(format!("Feature: {}", code_upper)))?
         };
 
-        // Add to EFBOM if expressed
-        if efcall_id > 0 && expressed.eq_ignore_ascii_case("yes") {
-            let record = json!({
-                "EFCALL_ID": efcall_id,
-                "EXEC_ORDER": fbom_order,
-                "FTYPE_ID": ftype_id,
-                "FELEM_ID": felem_id,
-                "FELEM_REQ": "Yes"
-            });
-            if let Some(array) = config["G2_CONFIG"]["CFG_EFBOM"].as_array_mut() {
-                array.push(record);
-            }
+        build_feature_json(self.as_value(), ftype)
+    }
+
+    /// List all features (see [`list_features`])
+    pub fn list_features(&self) -> Result<Vec<Value>> {
+        Ok(self.iter_features()?.collect())
+    }
+
+    /// Iterate over all features in FTYPE_ID order, building each on demand
+    ///
+    /// Yields the same values as [`list_features`] without holding the whole
+    /// list in memory. The child tables are grouped once up front (see
+    /// [`FeatureJoin`]), so each feature costs O(its own rows).
+    ///
+    /// # Errors
+    /// - `MissingSection` if CFG_FTYPE doesn't exist
+    ///
+    /// # Example
+    /// ```
+    /// use sz_configtool_lib::ConfigHandle;
+    ///
+    /// let config = ConfigHandle::from_json(
+    ///     r#"{"G2_CONFIG":{"CFG_FTYPE":[
+    ///         {"FTYPE_ID":2,"FTYPE_CODE":"ADDRESS"},
+    ///         {"FTYPE_ID":1,"FTYPE_CODE":"NAME"}
+    ///     ]}}"#,
+    /// )?;
+    /// let codes: Vec<String> = config
+    ///     .iter_features()?
+    ///     .map(|f| f["feature"].as_str().unwrap_or("").to_string())
+    ///     .collect();
+    /// assert_eq!(codes, ["NAME", "ADDRESS"]);
+    /// # Ok::<(), sz_configtool_lib::SzConfigError>(())
+    /// ```
+    pub fn iter_features(&self) -> Result<impl Iterator<Item = Value> + '_> {
+        let mut ftypes: Vec<&Value> = self.section("CFG_FTYPE")?.iter().collect();
+
+        // Sort by FTYPE_ID
+        ftypes.sort_by_key(|ftype| ftype["FTYPE_ID"].as_i64().unwrap_or(0));
+
+        let join = FeatureJoin::new(self.as_value());
+        Ok(ftypes
+            .into_iter()
+            .map(move |ftype| join.feature_json(ftype)))
+    }
+
+    /// Set (update) a feature's properties (in-place form of [`set_feature`])
+    pub fn set_feature(&mut self, params: SetFeatureParams) -> Result<()> {
+        // Try to parse as ID first, then as code
+        let ftype_id = if let Ok(id) = params.feature.trim().parse::<i64>() {
+            id
+        } else {
+            lookup_feature_id(self.as_value(), params.feature)?
+        };
+
+        // Resolve behavior and class before touching the record
+        let behavior = params.behavior.map(parse_behavior_code).transpose()?;
+        let fclass_id = params
+            .class
+            .map(|class_name| lookup_fclass_id(self, class_name))
+            .transpose()?;
+
+        let ftypes = self.section_mut("CFG_FTYPE")?;
+
+        let ftype = ftypes
+            .iter_mut()
+            .find(|f| f["FTYPE_ID"].as_i64() == Some(ftype_id))
+            .ok_or_else(|| SzConfigError::NotFound(format!("Feature: {}", ftype_id)))?;
+
+        // Update fields if provided
+        if let Some(val) = params.candidates {
+            ftype["USED_FOR_CAND"] = json!(val);
+        }
+        if let Some(val) = params.anonymize {
+            ftype["ANONYMIZE"] = json!(val);
+        }
+        if let Some(val) = params.derived {
+            ftype["DERIVED"] = json!(val);
+        }
+        if let Some(val) = params.history {
+            ftype["PERSIST_HISTORY"] = json!(val);
+        }
+        if let Some(val) = params.matchkey {
+            ftype["SHOW_IN_MATCH_KEY"] = json!(val);
+        }
+        if let Some(val) = params.version {
+            ftype["VERSION"] = json!(val);
+        }
+        if let Some(val) = params.rtype_id {
+            ftype["RTYPE_ID"] = json!(val);
         }
 
-        // Add to CFBOM if compared
-        if cfcall_id > 0 && compared.eq_ignore_ascii_case("yes") {
-            let record = json!({
-                "CFCALL_ID": cfcall_id,
-                "EXEC_ORDER": fbom_order,
-                "FTYPE_ID": ftype_id,
-                "FELEM_ID": felem_id
-            });
-            if let Some(array) = config["G2_CONFIG"]["CFG_CFBOM"].as_array_mut() {
-                array.push(record);
-            }
+        // Set behavior (FTYPE_FREQ, FTYPE_EXCL, FTYPE_STAB)
+        if let Some((frequency, exclusivity, stability)) = behavior {
+            ftype["FTYPE_FREQ"] = json!(frequency);
+            ftype["FTYPE_EXCL"] = json!(exclusivity);
+            ftype["FTYPE_STAB"] = json!(stability);
+        }
+
+        // Set class (FCLASS_ID)
+        if let Some(fclass_id) = fclass_id {
+            ftype["FCLASS_ID"] = json!(fclass_id);
+        }
+
+        Ok(())
+    }
+
+    /// Add a feature comparison element (in-place form of [`add_feature_comparison`])
+    pub fn add_feature_comparison(&mut self, params: AddFeatureComparisonParams) -> Result<()> {
+        let feature_code = params
+            .feature_code
+            .ok_or_else(|| SzConfigError::MissingField("feature_code".to_string()))?;
+        let element_code = params
+            .element_code
+            .ok_or_else(|| SzConfigError::MissingField("element_code".to_string()))?;
+
+        let ftype_id = self.lookup_feature_id(feature_code)?;
+        let felem_id = self.lookup_element_id(element_code)?;
+
+        // Check if already exists
+        let fbom_array = self.section_mut("CFG_FBOM")?;
+
+        if fbom_array.iter().any(|item| {
+            item["FTYPE_ID"].as_i64() == Some(ftype_id)
+                && item["FELEM_ID"].as_i64() == Some(felem_id)
+        }) {
+            return Err(SzConfigError::AlreadyExists(format!(
+                "Feature comparison: {:?}+{:?}",
+                params.feature_code, params.element_code
+            )));
         }
 
-        // Add to FBOM (always)
-        let mut fbom_record = json!({
+        // Build record
+        let mut record = json!({
             "FTYPE_ID": ftype_id,
             "FELEM_ID": felem_id,
-            "EXEC_ORDER": fbom_order,
-            "DISPLAY_LEVEL": display_level,
-            "DERIVED": elem_derived
         });
 
-        if let Some(delim) = display_delim {
-            fbom_record["DISPLAY_DELIM"] = json!(delim);
+        if let Some(order) = params.exec_order {
+            record["EXEC_ORDER"] = json!(order);
         }
-
-        if let Some(array) = config["G2_CONFIG"]["CFG_FBOM"].as_array_mut() {
-            array.push(fbom_record);
+        if let Some(level) = params.display_level {
+            record["DISPLAY_LEVEL"] = json!(level);
         }
+        if let Some(delim) = params.display_delim {
+            record["DISPLAY_DELIM"] = json!(delim);
+        }
+        if let Some(der) = params.derived {
+            record["DERIVED"] = json!(der);
+        }
+
+        fbom_array.push(record);
+        Ok(())
     }
 
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
-}
+    /// Delete a feature comparison element (in-place form of [`delete_feature_comparison`])
+    pub fn delete_feature_comparison(
+        &mut self,
+        feature_code: &str,
+        element_code: &str,
+    ) -> Result<()> {
+        let ftype_id = self.lookup_feature_id(feature_code)?;
+        let felem_id = self.lookup_element_id(element_code)?;
+
+        let mut found = false;
+
+        if let Ok(fbom_array) = self.section_mut("CFG_FBOM") {
+            fbom_array.retain(|item| {
+                let matches = item["FTYPE_ID"].as_i64() == Some(ftype_id)
+                    && item["FELEM_ID"].as_i64() == Some(felem_id);
+                if matches {
+                    found = true;
+                }
+                !matches
+            });
+        }
 
-/// Delete a feature from the configuration
-///
-/// # Arguments
-/// * `config_json` - JSON configuration string
-/// * `feature_code_or_id` - Feature code or numeric ID
-///
-/// # Returns
-/// Modified configuration JSON string
-///
-/// # Errors
-/// - `NotFound` if feature doesn't exist
-/// - `InvalidInput` if trying to delete a protected feature
-pub fn delete_feature(config_json: &str, feature_code_or_id: &str) -> Result<String> {
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Try to parse as ID first, then as code
-    let ftype_id = if let Ok(id) = feature_code_or_id.trim().parse::<i64>() {
-        // Validate ID exists
-        let ftypes = config["G2_CONFIG"]["CFG_FTYPE"]
-            .as_array()
-            .ok_or_else(|| SzConfigError::MissingSection("CFG_FTYPE".to_string()))?;
-
-        if !ftypes.iter().any(|f| f["FTYPE_ID"].as_i64() == Some(id)) {
-            return Err(SzConfigError::NotFound(format!("Feature: {}", id)));
+        if !found {
+            return Err(SzConfigError::NotFound(format!(
+                "Feature comparison: FTYPE_ID={}, FELEM_ID={}",
+                ftype_id, felem_id
+            )));
         }
-        id
-    } else {
-        lookup_feature_id(&config, feature_code_or_id)?
-    };
 
-    // Get feature code for validation
-    let feature_code = config["G2_CONFIG"]["CFG_FTYPE"]
-        .as_array()
-        .and_then(|arr| {
-            arr.iter()
-                .find(|f| f["FTYPE_ID"].as_i64() == Some(ftype_id))
-                .and_then(|f| f["FTYPE_CODE"].as_str())
-        })
-        .ok_or_else(|| SzConfigError::NotFound(format!("Feature: {}", ftype_id)))?
-        .to_string();
+        Ok(())
+    }
 
-    // Check if feature is locked
-    if LOCKED_FEATURES
-        .iter()
-        .any(|&locked| locked.eq_ignore_ascii_case(&feature_code))
-    {
-        return Err(SzConfigError::InvalidInput(format!(
-            "The feature {} cannot be deleted (it is a protected system feature)",
-            feature_code
-        )));
+    /// Get a specific feature comparison element (see [`get_feature_comparison`])
+    pub fn get_feature_comparison(&self, params: GetFeatureComparisonParams) -> Result<Value> {
+        let feature_code = params
+            .feature_code
+            .ok_or_else(|| SzConfigError::MissingField("feature_code".to_string()))?;
+        let element_code = params
+            .element_code
+            .ok_or_else(|| SzConfigError::MissingField("element_code".to_string()))?;
+
+        let ftype_id = self.lookup_feature_id(feature_code)?;
+        let felem_id = self.lookup_element_id(element_code)?;
+
+        self.section("CFG_FBOM")?
+            .iter()
+            .find(|item| {
+                item["FTYPE_ID"].as_i64() == Some(ftype_id)
+                    && item["FELEM_ID"].as_i64() == Some(felem_id)
+            })
+            .cloned()
+            .ok_or_else(|| {
+                SzConfigError::NotFound(format!(
+                    "Feature comparison: {:?}+{:?}",
+                    params.feature_code, params.element_code
+                ))
+            })
     }
 
-    // Delete FBOM records
-    if let Some(fbom_array) = config["G2_CONFIG"]["CFG_FBOM"].as_array_mut() {
-        fbom_array.retain(|record| record["FTYPE_ID"].as_i64() != Some(ftype_id));
+    /// List all feature comparison elements (see [`list_feature_comparisons`])
+    pub fn list_feature_comparisons(&self) -> Result<Vec<Value>> {
+        let mut result: Vec<Value> = self.section("CFG_FBOM")?.to_vec();
+
+        // Sort by FTYPE_ID and EXEC_ORDER
+        result.sort_by(|a, b| {
+            let a_ftype = a["FTYPE_ID"].as_i64().unwrap_or(0);
+            let b_ftype = b["FTYPE_ID"].as_i64().unwrap_or(0);
+            let a_exec = a["EXEC_ORDER"].as_i64().unwrap_or(0);
+            let b_exec = b["EXEC_ORDER"].as_i64().unwrap_or(0);
+            (a_ftype, a_exec).cmp(&(b_ftype, b_exec))
+        });
+
+        Ok(result)
     }
 
-    // Delete CFG_ATTR records
-    if let Some(attr_array) = config["G2_CONFIG"]["CFG_ATTR"].as_array_mut() {
-        attr_array.retain(|record| {
-            record["FTYPE_CODE"]
-                .as_str()
-                .map(|s| !s.eq_ignore_ascii_case(&feature_code))
-                .unwrap_or(true)
+    /// Add a feature distinct call element (in-place form of [`add_feature_distinct_call_element`])
+    pub fn add_feature_distinct_call_element(
+        &mut self,
+        params: AddFeatureDistinctCallElementParams,
+    ) -> Result<()> {
+        let feature_code = params
+            .feature_code
+            .ok_or_else(|| SzConfigError::MissingField("feature_code".to_string()))?;
+        let distinct_func_code = params
+            .distinct_func_code
+            .ok_or_else(|| SzConfigError::MissingField("distinct_func_code".to_string()))?;
+
+        let ftype_id = self.lookup_feature_id(feature_code)?;
+        let dfunc_id = self.lookup_dfunc_id(distinct_func_code)?;
+        let felem_id = if let Some(code) = params.element_code {
+            self.lookup_element_id(code)?
+        } else {
+            -1
+        };
+
+        // Check if already exists
+        let dfcall_array = self.section_mut("CFG_DFCALL")?;
+
+        if dfcall_array.iter().any(|item| {
+            item["FTYPE_ID"].as_i64() == Some(ftype_id)
+                && item["DFUNC_ID"].as_i64() == Some(dfunc_id)
+                && item["FELEM_ID"].as_i64() == Some(felem_id)
+        }) {
+            return Err(SzConfigError::AlreadyExists(format!(
+                "Feature distinct call element: {:?}+{:?}",
+                params.feature_code, params.distinct_func_code
+            )));
+        }
+
+        // Get next DFCALL_ID
+        let dfcall_id = helpers::get_next_id_with_min(dfcall_array, "DFCALL_ID", 1000)?;
+
+        // Build record
+        let mut record = json!({
+            "DFCALL_ID": dfcall_id,
+            "FTYPE_ID": ftype_id,
+            "DFUNC_ID": dfunc_id,
+            "FELEM_ID": felem_id,
         });
-    }
 
-    // Delete standardize calls
-    if let Some(sfcall_array) = config["G2_CONFIG"]["CFG_SFCALL"].as_array_mut() {
-        sfcall_array.retain(|record| record["FTYPE_ID"].as_i64() != Some(ftype_id));
+        if let Some(order) = params.exec_order {
+            record["EXEC_ORDER"] = json!(order);
+        }
+
+        dfcall_array.push(record);
+        Ok(())
     }
 
-    // Delete expression calls and their BOM records
-    let efcall_ids: Vec<i64> = config["G2_CONFIG"]["CFG_EFCALL"]
-        .as_array()
-        .map(|arr| {
-            arr.iter()
-                .filter(|call| call["FTYPE_ID"].as_i64() == Some(ftype_id))
-                .filter_map(|call| call["EFCALL_ID"].as_i64())
-                .collect()
-        })
-        .unwrap_or_default();
+    /// List all feature classes (see [`list_feature_classes`])
+    pub fn list_feature_classes(&self) -> Result<Vec<Value>> {
+        let mut result: Vec<Value> = self.section("CFG_FCLASS")?.to_vec();
 
-    if let Some(efbom_array) = config["G2_CONFIG"]["CFG_EFBOM"].as_array_mut() {
-        efbom_array.retain(|record| {
-            record["EFCALL_ID"]
-                .as_i64()
-                .map(|id| !efcall_ids.contains(&id))
-                .unwrap_or(true)
-        });
-    }
+        // Sort by FCLASS_ID
+        result.sort_by_key(|item| item["FCLASS_ID"].as_i64().unwrap_or(0));
 
-    if let Some(efcall_array) = config["G2_CONFIG"]["CFG_EFCALL"].as_array_mut() {
-        efcall_array.retain(|record| record["FTYPE_ID"].as_i64() != Some(ftype_id));
+        Ok(result)
     }
 
-    // Delete comparison calls and their BOM records
-    let cfcall_ids: Vec<i64> = config["G2_CONFIG"]["CFG_CFCALL"]
-        .as_array()
-        .map(|arr| {
-            arr.iter()
-                .filter(|call| call["FTYPE_ID"].as_i64() == Some(ftype_id))
-                .filter_map(|call| call["CFCALL_ID"].as_i64())
-                .collect()
-        })
-        .unwrap_or_default();
+    /// Get a specific feature class by ID or code (see [`get_feature_class`])
+    pub fn get_feature_class(&self, fclass_id_or_code: &str) -> Result<Value> {
+        let fclass_array = self.section("CFG_FCLASS")?;
 
-    if let Some(cfbom_array) = config["G2_CONFIG"]["CFG_CFBOM"].as_array_mut() {
-        cfbom_array.retain(|record| {
-            record["CFCALL_ID"]
-                .as_i64()
-                .map(|id| !cfcall_ids.contains(&id))
-                .unwrap_or(true)
-        });
+        // Try to parse as ID first
+        if let Ok(id) = fclass_id_or_code.trim().parse::<i64>() {
+            fclass_array
+                .iter()
+                .find(|item| item["FCLASS_ID"].as_i64() == Some(id))
+                .cloned()
+                .ok_or_else(|| SzConfigError::NotFound(format!("Feature class: {}", id)))
+        } else {
+            // Try as code
+            let code_upper = fclass_id_or_code.to_uppercase();
+            fclass_array
+                .iter()
+                .find(|item| item["FCLASS_CODE"].as_str() == Some(code_upper.as_str()))
+                .cloned()
+                .ok_or_else(|| SzConfigError::NotFound(format!("Feature class: {}", code_upper)))
+        }
     }
 
-    if let Some(cfcall_array) = config["G2_CONFIG"]["CFG_CFCALL"].as_array_mut() {
-        cfcall_array.retain(|record| record["FTYPE_ID"].as_i64() != Some(ftype_id));
-    }
+    /// Update the feature version (in-place form of [`update_feature_version`])
+    pub fn update_feature_version(&mut self, version: &str) -> Result<()> {
+        // Navigate to COMPATIBILITY_VERSION
+        let compat_version = self
+            .g2_entry_mut("CONFIG_BASE_VERSION")
+            .and_then(|v| v.get_mut("COMPATIBILITY_VERSION"))
+            .and_then(|v| v.as_object_mut())
+            .ok_or_else(|| SzConfigError::MissingSection("COMPATIBILITY_VERSION".to_string()))?;
 
-    // Delete distinct calls and their BOM records
-    let dfcall_ids: Vec<i64> = config["G2_CONFIG"]["CFG_DFCALL"]
-        .as_array()
-        .map(|arr| {
-            arr.iter()
-                .filter(|call| call["FTYPE_ID"].as_i64() == Some(ftype_id))
-                .filter_map(|call| call["DFCALL_ID"].as_i64())
-                .collect()
-        })
-        .unwrap_or_default();
+        compat_version.insert("FEATURE_VERSION".to_string(), json!(version));
 
-    if let Some(dfbom_array) = config["G2_CONFIG"]["CFG_DFBOM"].as_array_mut() {
-        dfbom_array.retain(|record| {
-            record["DFCALL_ID"]
-                .as_i64()
-                .map(|id| !dfcall_ids.contains(&id))
-                .unwrap_or(true)
-        });
+        Ok(())
     }
+}
 
-    if let Some(dfcall_array) = config["G2_CONFIG"]["CFG_DFCALL"].as_array_mut() {
-        dfcall_array.retain(|record| record["FTYPE_ID"].as_i64() != Some(ftype_id));
-    }
+/// Add a new feature to the configuration
+///
+/// # Arguments
+/// * `config_json` - JSON configuration string
+/// * `params` - Feature parameters (feature, element_list required; others optional)
+///
+/// # Returns
+/// Modified configuration JSON string
+///
+/// # Example
+/// ```no_run
+/// use sz_configtool_lib::features::{add_feature, AddFeatureParams};
+/// use serde_json::json;
+///
+/// let config = r#"{"G2_CONFIG":{"CFG_FTYPE":[],...}}"#;
+/// let elements = json!([{"element": "NAME"}]);
+/// let result = add_feature(config, AddFeatureParams {
+///     feature: "PERSON",
+///     element_list: &elements,
+///     class: Some("IDENTITY"),
+///     behavior: Some("FM"),
+///     ..Default::default()
+/// })?;
+/// # Ok::<(), sz_configtool_lib::error::SzConfigError>(())
+/// ```
+pub fn add_feature(config_json: &str, params: AddFeatureParams) -> Result<String> {
+    handle::edit(config_json, |config| config.add_feature(params))
+}
 
-    // Finally, delete the feature itself
-    if let Some(ftype_array) = config["G2_CONFIG"]["CFG_FTYPE"].as_array_mut() {
-        ftype_array.retain(|record| record["FTYPE_ID"].as_i64() != Some(ftype_id));
-    }
+/// Delete a feature from the configuration
+///
+/// # Arguments
+/// * `config_json` - JSON configuration string
+/// * `feature_code_or_id` - Feature code or numeric ID
+///
+/// # Returns
+/// Modified configuration JSON string
+///
+/// # Errors
+/// - `NotFound` if feature doesn't exist
+/// - `InvalidInput` if trying to delete a protected feature
+pub fn delete_feature(config_json: &str, feature_code_or_id: &str) -> Result<String> {
+    handle::edit(config_json, |config| {
+        config.delete_feature(feature_code_or_id)
+    })
+}
 
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+/// Delete several features and their dependent records
+///
+/// Produces the same configuration as calling [`delete_feature`] for each
+/// feature in turn, but sweeps each dependent table (CFG_FBOM, CFG_ATTR,
+/// the call and BOM tables) once for the whole batch. Every feature is
+/// validated first, so on error nothing is deleted.
+///
+/// # Arguments
+/// * `config_json` - JSON configuration string
+/// * `features` - Feature codes or numeric IDs
+///
+/// # Returns
+/// Modified configuration JSON string
+///
+/// # Errors
+/// - `NotFound` if a feature doesn't exist (or is listed twice)
+/// - `InvalidInput` if trying to delete a protected feature
+pub fn delete_features(config_json: &str, features: &[&str]) -> Result<String> {
+    handle::edit(config_json, |config| config.delete_features(features))
 }
 
 /// Get a specific feature by code or ID
@@ -849,27 +1239,7 @@ pub fn delete_feature(config_json: &str, feature_code_or_id: &str) -> Result<Str
 /// # Returns
 /// JSON Value representing the complete feature with elementList
 pub fn get_feature(config_json: &str, feature_code_or_id: &str) -> Result<Value> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Try to parse as ID first, then as code
-    let ftype = if let Ok(id) = feature_code_or_id.trim().parse::<i64>() {
-        config["G2_CONFIG"]["CFG_FTYPE"]
-            .as_array()
-            .and_then(|arr| arr.iter().find(|f| f["FTYPE_ID"].as_i64() == Some(id)))
-            .ok_or_else(|| SzConfigError::NotFound(format!("Feature: {}", id)))?
-    } else {
-        let code_upper = feature_code_or_id.to_uppercase();
-        config["G2_CONFIG"]["CFG_FTYPE"]
-            .as_array()
-            .and_then(|arr| {
-                arr.iter()
-                    .find(|f| f["FTYPE_CODE"].as_str() == Some(code_upper.as_str()))
-            })
-            .ok_or_else(|| SzConfigError::NotFound(format!("Feature: {}", code_upper)))?
-    };
-
-    build_feature_json(&config, ftype)
+    handle::read(config_json, |config| config.get_feature(feature_code_or_id))
 }
 
 /// List all features in the configuration
@@ -880,22 +1250,7 @@ pub fn get_feature(config_json: &str, feature_code_or_id: &str) -> Result<Value>
 /// # Returns
 /// Vector of JSON Values representing features with elementList
 pub fn list_features(config_json: &str) -> Result<Vec<Value>> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let ftype_array = config["G2_CONFIG"]["CFG_FTYPE"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FTYPE".to_string()))?;
-
-    let mut result: Vec<Value> = ftype_array
-        .iter()
-        .map(|ftype| build_feature_json(&config, ftype))
-        .collect::<Result<Vec<_>>>()?;
-
-    // Sort by FTYPE_ID
-    result.sort_by_key(|item| item["id"].as_i64().unwrap_or(0));
-
-    Ok(result)
+    handle::read(config_json, |config| config.list_features())
 }
 
 /// Set (update) a feature's properties
@@ -922,257 +1277,254 @@ pub fn list_features(config_json: &str) -> Result<Vec<Value>> {
 /// # Ok::<(), sz_configtool_lib::error::SzConfigError>(())
 /// ```
 pub fn set_feature(config_json: &str, params: SetFeatureParams) -> Result<String> {
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Try to parse as ID first, then as code
-    let ftype_id = if let Ok(id) = params.feature.trim().parse::<i64>() {
-        id
-    } else {
-        lookup_feature_id(&config, params.feature)?
-    };
+    handle::edit(config_json, |config| config.set_feature(params))
+}
 
-    let ftypes = config["G2_CONFIG"]["CFG_FTYPE"]
-        .as_array_mut()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FTYPE".to_string()))?;
+// Helper functions
 
-    let ftype = ftypes
-        .iter_mut()
-        .find(|f| f["FTYPE_ID"].as_i64() == Some(ftype_id))
-        .ok_or_else(|| SzConfigError::NotFound(format!("Feature: {}", ftype_id)))?;
+/// Build complete feature JSON with elementList for display
+///
+/// To render many features, use [`ConfigHandle::iter_features`] or
+/// [`ConfigHandle::list_features`], which share one [`FeatureJoin`] instead
+/// of scanning the child tables again for each feature.
+pub fn build_feature_json(config: &Value, ftype: &Value) -> Result<Value> {
+    Ok(FeatureJoin::for_feature(config, ftype).feature_json(ftype))
+}
 
-    // Update fields if provided
-    if let Some(val) = params.candidates {
-        ftype["USED_FOR_CAND"] = json!(val);
-    }
-    if let Some(val) = params.anonymize {
-        ftype["ANONYMIZE"] = json!(val);
-    }
-    if let Some(val) = params.derived {
-        ftype["DERIVED"] = json!(val);
-    }
-    if let Some(val) = params.history {
-        ftype["PERSIST_HISTORY"] = json!(val);
-    }
-    if let Some(val) = params.matchkey {
-        ftype["SHOW_IN_MATCH_KEY"] = json!(val);
-    }
-    if let Some(val) = params.version {
-        ftype["VERSION"] = json!(val);
-    }
-    if let Some(val) = params.rtype_id {
-        ftype["RTYPE_ID"] = json!(val);
-    }
+/// Child tables of `CFG_FTYPE` grouped by FTYPE_ID in one pass
+///
+/// Holds everything [`build_feature_json`] looks up for a feature, so
+/// rendering N features costs one pass over each table plus O(1) lookups per
+/// feature instead of N scans of every table. Where several records match,
+/// the same one is chosen as by a linear scan (first match, or the first
+/// record with the lowest EXEC_ORDER / CFCALL_ID).
+pub struct FeatureJoin<'a> {
+    fclass_codes: HashMap<i64, &'a str>,
+    sfunc_codes: HashMap<i64, &'a str>,
+    efunc_codes: HashMap<i64, &'a str>,
+    cfunc_codes: HashMap<i64, &'a str>,
+    felem_codes: HashMap<i64, &'a str>,
+    /// FTYPE_ID → first SFCALL with the lowest EXEC_ORDER
+    sfcalls: HashMap<i64, &'a Value>,
+    /// FTYPE_ID → first EFCALL with the lowest EXEC_ORDER
+    efcalls: HashMap<i64, &'a Value>,
+    /// FTYPE_ID → first CFCALL with the lowest CFCALL_ID
+    cfcalls: HashMap<i64, &'a Value>,
+    /// FTYPE_ID → FBOM records in config order
+    fboms: HashMap<i64, Vec<&'a Value>>,
+    /// (EFCALL_ID, FTYPE_ID, FELEM_ID) present in CFG_EFBOM
+    efboms: HashSet<(i64, i64, i64)>,
+    /// (CFCALL_ID, FTYPE_ID, FELEM_ID) present in CFG_CFBOM
+    cfboms: HashSet<(i64, i64, i64)>,
+}
 
-    // Parse and set behavior (FTYPE_FREQ, FTYPE_EXCL, FTYPE_STAB)
-    if let Some(behavior_code) = params.behavior {
-        let (frequency, exclusivity, stability) = parse_behavior_code(behavior_code)?;
-        ftype["FTYPE_FREQ"] = json!(frequency);
-        ftype["FTYPE_EXCL"] = json!(exclusivity);
-        ftype["FTYPE_STAB"] = json!(stability);
+impl<'a> FeatureJoin<'a> {
+    /// Group the feature child tables of a configuration document
+    pub fn new(config: &'a Value) -> Self {
+        Self::collect(config, None)
     }
 
-    // Lookup and set class (FCLASS_ID) - must do before modifying ftype
-    if let Some(class_name) = params.class {
-        // Parse config again to avoid borrow conflict
-        let config_for_lookup: Value = serde_json::from_str(config_json)
-            .map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-        let fclass_array = config_for_lookup["G2_CONFIG"]["CFG_FCLASS"]
-            .as_array()
-            .ok_or_else(|| SzConfigError::MissingSection("CFG_FCLASS".to_string()))?;
-
-        let fclass_id = fclass_array
-            .iter()
-            .find(|c| {
-                c["FCLASS_CODE"]
-                    .as_str()
-                    .map(|s| s.eq_ignore_ascii_case(class_name))
-                    .unwrap_or(false)
-            })
-            .and_then(|c| c["FCLASS_ID"].as_i64())
-            .ok_or_else(|| SzConfigError::NotFound(format!("Feature class: {}", class_name)))?;
-
-        ftype["FCLASS_ID"] = json!(fclass_id);
+    /// Collect only what [`feature_json`](Self::feature_json) needs for
+    /// `ftype`, for rendering a single feature
+    ///
+    /// Each table is still scanned once, but only the rows of this FTYPE_ID
+    /// and the codes they reference are kept.
+    pub fn for_feature(config: &'a Value, ftype: &Value) -> Self {
+        Self::collect(config, Some(ftype))
     }
 
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
-}
+    fn collect(config: &'a Value, only: Option<&Value>) -> Self {
+        let g2 = &config["G2_CONFIG"];
+        let rows = |section: &str| g2[section].as_array().map_or(&[][..], |a| a.as_slice());
+        let only_id = only.map(|ftype| ftype["FTYPE_ID"].as_i64().unwrap_or(0));
+        let wanted = |row: &Value| {
+            let ftype_id = row["FTYPE_ID"].as_i64();
+            ftype_id.is_some() && only_id.is_none_or(|id| ftype_id == Some(id))
+        };
 
-// Helper functions
+        // Codes of a lookup table; with `only`, just the IDs in `used`
+        let codes = |section: &str, id_field: &str, code_field: &str, used: &[i64]| {
+            let mut map = HashMap::new();
+            for row in rows(section) {
+                if let (Some(id), Some(code)) = (row[id_field].as_i64(), row[code_field].as_str())
+                    && (only.is_none() || used.contains(&id))
+                {
+                    map.entry(id).or_insert(code);
+                }
+            }
+            map
+        };
 
-/// Build complete feature JSON with elementList for display
-pub fn build_feature_json(config: &Value, ftype: &Value) -> Result<Value> {
-    let empty_array = vec![];
+        // First record per FTYPE_ID with the lowest `order_field`
+        let first_calls = |section: &str, order_field: &str| {
+            let mut map: HashMap<i64, &'a Value> = HashMap::new();
+            for row in rows(section).iter().filter(|row| wanted(row)) {
+                let Some(ftype_id) = row["FTYPE_ID"].as_i64() else {
+                    continue;
+                };
+                let order = row[order_field].as_i64().unwrap_or(0);
+                map.entry(ftype_id)
+                    .and_modify(|best| {
+                        if order < best[order_field].as_i64().unwrap_or(0) {
+                            *best = row;
+                        }
+                    })
+                    .or_insert(row);
+            }
+            map
+        };
 
-    let fclass_array = config["G2_CONFIG"]["CFG_FCLASS"]
-        .as_array()
-        .unwrap_or(&empty_array);
-    let sfcall_array = config["G2_CONFIG"]["CFG_SFCALL"]
-        .as_array()
-        .unwrap_or(&empty_array);
-    let efcall_array = config["G2_CONFIG"]["CFG_EFCALL"]
-        .as_array()
-        .unwrap_or(&empty_array);
-    let cfcall_array = config["G2_CONFIG"]["CFG_CFCALL"]
-        .as_array()
-        .unwrap_or(&empty_array);
-    let sfunc_array = config["G2_CONFIG"]["CFG_SFUNC"]
-        .as_array()
-        .unwrap_or(&empty_array);
-    let efunc_array = config["G2_CONFIG"]["CFG_EFUNC"]
-        .as_array()
-        .unwrap_or(&empty_array);
-    let cfunc_array = config["G2_CONFIG"]["CFG_CFUNC"]
-        .as_array()
-        .unwrap_or(&empty_array);
-    let felem_array = config["G2_CONFIG"]["CFG_FELEM"]
-        .as_array()
-        .unwrap_or(&empty_array);
-    let fbom_array = config["G2_CONFIG"]["CFG_FBOM"]
-        .as_array()
-        .unwrap_or(&empty_array);
-    let efbom_array = config["G2_CONFIG"]["CFG_EFBOM"]
-        .as_array()
-        .unwrap_or(&empty_array);
-    let cfbom_array = config["G2_CONFIG"]["CFG_CFBOM"]
-        .as_array()
-        .unwrap_or(&empty_array);
+        let bom_keys = |section: &str, call_id_field: &str| {
+            rows(section)
+                .iter()
+                .filter(|bom| wanted(bom))
+                .filter_map(|bom| {
+                    Some((
+                        bom[call_id_field].as_i64()?,
+                        bom["FTYPE_ID"].as_i64()?,
+                        bom["FELEM_ID"].as_i64()?,
+                    ))
+                })
+                .collect()
+        };
 
-    let ftype_id = ftype["FTYPE_ID"].as_i64().unwrap_or(0);
-    let fclass_id = ftype["FCLASS_ID"].as_i64().unwrap_or(0);
+        let mut fboms: HashMap<i64, Vec<&'a Value>> = HashMap::new();
+        for fbom in rows("CFG_FBOM").iter().filter(|fbom| wanted(fbom)) {
+            if let Some(ftype_id) = fbom["FTYPE_ID"].as_i64() {
+                fboms.entry(ftype_id).or_default().push(fbom);
+            }
+        }
 
-    // Resolve class name
-    let class_name = fclass_array
-        .iter()
-        .find(|fc| fc["FCLASS_ID"].as_i64() == Some(fclass_id))
-        .and_then(|fc| fc["FCLASS_CODE"].as_str())
-        .unwrap_or("OTHER")
-        .to_string();
+        let sfcalls = first_calls("CFG_SFCALL", "EXEC_ORDER");
+        let efcalls = first_calls("CFG_EFCALL", "EXEC_ORDER");
+        let cfcalls = first_calls("CFG_CFCALL", "CFCALL_ID");
 
-    // Compute behavior
-    let behavior = compute_behavior(ftype);
+        // IDs referenced by the collected rows, for the lookup tables
+        let used = |calls: &HashMap<i64, &Value>, field: &str| -> Vec<i64> {
+            calls
+                .values()
+                .filter_map(|call| call[field].as_i64())
+                .collect()
+        };
+        let fclass_ids = [only.map_or(0, |ftype| ftype["FCLASS_ID"].as_i64().unwrap_or(0))];
+        let felem_ids: Vec<i64> = fboms
+            .values()
+            .flatten()
+            .map(|fbom| fbom["FELEM_ID"].as_i64().unwrap_or(0))
+            .collect();
 
-    // Find standardize function
-    let standardize = sfcall_array
-        .iter()
-        .filter(|sc| sc["FTYPE_ID"].as_i64() == Some(ftype_id))
-        .min_by_key(|sc| sc["EXEC_ORDER"].as_i64().unwrap_or(0))
-        .and_then(|sc| sc["SFUNC_ID"].as_i64())
-        .and_then(|sfunc_id| {
-            sfunc_array
-                .iter()
-                .find(|sf| sf["SFUNC_ID"].as_i64() == Some(sfunc_id))
-        })
-        .and_then(|sf| sf["SFUNC_CODE"].as_str())
-        .unwrap_or("")
-        .to_string();
+        Self {
+            fclass_codes: codes("CFG_FCLASS", "FCLASS_ID", "FCLASS_CODE", &fclass_ids),
+            sfunc_codes: codes(
+                "CFG_SFUNC",
+                "SFUNC_ID",
+                "SFUNC_CODE",
+                &used(&sfcalls, "SFUNC_ID"),
+            ),
+            efunc_codes: codes(
+                "CFG_EFUNC",
+                "EFUNC_ID",
+                "EFUNC_CODE",
+                &used(&efcalls, "EFUNC_ID"),
+            ),
+            cfunc_codes: codes(
+                "CFG_CFUNC",
+                "CFUNC_ID",
+                "CFUNC_CODE",
+                &used(&cfcalls, "CFUNC_ID"),
+            ),
+            felem_codes: codes("CFG_FELEM", "FELEM_ID", "FELEM_CODE", &felem_ids),
+            sfcalls,
+            efcalls,
+            cfcalls,
+            fboms,
+            efboms: bom_keys("CFG_EFBOM", "EFCALL_ID"),
+            cfboms: bom_keys("CFG_CFBOM", "CFCALL_ID"),
+        }
+    }
 
-    // Find expression function
-    let efcall = efcall_array
-        .iter()
-        .filter(|ec| ec["FTYPE_ID"].as_i64() == Some(ftype_id))
-        .min_by_key(|ec| ec["EXEC_ORDER"].as_i64().unwrap_or(0));
+    /// Build the display JSON of one `CFG_FTYPE` record
+    pub fn feature_json(&self, ftype: &Value) -> Value {
+        let ftype_id = ftype["FTYPE_ID"].as_i64().unwrap_or(0);
+        let fclass_id = ftype["FCLASS_ID"].as_i64().unwrap_or(0);
+
+        // Resolve class name
+        let class_name = self
+            .fclass_codes
+            .get(&fclass_id)
+            .copied()
+            .unwrap_or("OTHER");
+
+        // Compute behavior
+        let behavior = compute_behavior(ftype);
+
+        // Resolve the function code of a call record
+        let function_code = |call: Option<&&Value>, id_field: &str, codes: &HashMap<i64, &str>| {
+            call.and_then(|c| c[id_field].as_i64())
+                .and_then(|id| codes.get(&id).copied())
+                .unwrap_or("")
+                .to_string()
+        };
 
-    let expression = efcall
-        .and_then(|ec| ec["EFUNC_ID"].as_i64())
-        .and_then(|efunc_id| {
-            efunc_array
-                .iter()
-                .find(|ef| ef["EFUNC_ID"].as_i64() == Some(efunc_id))
-        })
-        .and_then(|ef| ef["EFUNC_CODE"].as_str())
-        .unwrap_or("")
-        .to_string();
+        let efcall = self.efcalls.get(&ftype_id);
+        let cfcall = self.cfcalls.get(&ftype_id);
 
-    // Find comparison function
-    let cfcall = cfcall_array
-        .iter()
-        .filter(|cc| cc["FTYPE_ID"].as_i64() == Some(ftype_id))
-        .min_by_key(|cc| cc["CFCALL_ID"].as_i64().unwrap_or(0));
+        let standardize = function_code(self.sfcalls.get(&ftype_id), "SFUNC_ID", &self.sfunc_codes);
+        let expression = function_code(efcall, "EFUNC_ID", &self.efunc_codes);
+        let comparison = function_code(cfcall, "CFUNC_ID", &self.cfunc_codes);
 
-    let comparison = cfcall
-        .and_then(|cc| cc["CFUNC_ID"].as_i64())
-        .and_then(|cfunc_id| {
-            cfunc_array
-                .iter()
-                .find(|cf| cf["CFUNC_ID"].as_i64() == Some(cfunc_id))
-        })
-        .and_then(|cf| cf["CFUNC_CODE"].as_str())
-        .unwrap_or("")
-        .to_string();
+        let efcall_id = efcall.and_then(|ec| ec["EFCALL_ID"].as_i64());
+        let cfcall_id = cfcall.and_then(|cc| cc["CFCALL_ID"].as_i64());
 
-    // Build elementList
-    let mut element_list: Vec<(i64, Value)> = fbom_array
-        .iter()
-        .filter(|fbom| fbom["FTYPE_ID"].as_i64() == Some(ftype_id))
-        .map(|fbom| {
-            let felem_id = fbom["FELEM_ID"].as_i64().unwrap_or(0);
-            let exec_order = fbom["EXEC_ORDER"].as_i64().unwrap_or(0);
+        // Build elementList
+        let fboms = self.fboms.get(&ftype_id).map_or(&[][..], |v| v.as_slice());
+        let mut element_list: Vec<(i64, Value)> = fboms
+            .iter()
+            .map(|fbom| {
+                let felem_id = fbom["FELEM_ID"].as_i64().unwrap_or(0);
+                let exec_order = fbom["EXEC_ORDER"].as_i64().unwrap_or(0);
 
-            let element_code = felem_array
-                .iter()
-                .find(|fe| fe["FELEM_ID"].as_i64() == Some(felem_id))
-                .and_then(|fe| fe["FELEM_CODE"].as_str())
-                .unwrap_or("")
-                .to_string();
-
-            let expressed = efcall
-                .and_then(|ec| ec["EFCALL_ID"].as_i64())
-                .map(|efcall_id| {
-                    efbom_array.iter().any(|efbom| {
-                        efbom["EFCALL_ID"].as_i64() == Some(efcall_id)
-                            && efbom["FTYPE_ID"].as_i64() == Some(ftype_id)
-                            && efbom["FELEM_ID"].as_i64() == Some(felem_id)
-                    })
-                })
-                .unwrap_or(false);
-
-            let compared = cfcall
-                .and_then(|cc| cc["CFCALL_ID"].as_i64())
-                .map(|cfcall_id| {
-                    cfbom_array.iter().any(|cfbom| {
-                        cfbom["CFCALL_ID"].as_i64() == Some(cfcall_id)
-                            && cfbom["FTYPE_ID"].as_i64() == Some(ftype_id)
-                            && cfbom["FELEM_ID"].as_i64() == Some(felem_id)
-                    })
-                })
-                .unwrap_or(false);
+                let element_code = self.felem_codes.get(&felem_id).copied().unwrap_or("");
+                let expressed =
+                    efcall_id.is_some_and(|id| self.efboms.contains(&(id, ftype_id, felem_id)));
+                let compared =
+                    cfcall_id.is_some_and(|id| self.cfboms.contains(&(id, ftype_id, felem_id)));
 
-            let derived = fbom["DERIVED"].as_str().unwrap_or("No");
-            let display_level = fbom["DISPLAY_LEVEL"].as_i64().unwrap_or(1);
-            let display = if display_level == 0 { "No" } else { "Yes" };
+                let derived = fbom["DERIVED"].as_str().unwrap_or("No");
+                let display_level = fbom["DISPLAY_LEVEL"].as_i64().unwrap_or(1);
+                let display = if display_level == 0 { "No" } else { "Yes" };
 
-            (
-                exec_order,
-                json!({
-                    "element": element_code,
-                    "expressed": if expressed { "Yes" } else { "No" },
-                    "compared": if compared { "Yes" } else { "No" },
-                    "derived": derived,
-                    "display": display
-                }),
-            )
+                (
+                    exec_order,
+                    json!({
+                        "element": element_code,
+                        "expressed": if expressed { "Yes" } else { "No" },
+                        "compared": if compared { "Yes" } else { "No" },
+                        "derived": derived,
+                        "display": display
+                    }),
+                )
+            })
+            .collect();
+
+        element_list.sort_by_key(|(order, _)| *order);
+        let element_list: Vec<Value> = element_list.into_iter().map(|(_, v)| v).collect();
+
+        json!({
+            "id": ftype_id,
+            "feature": ftype["FTYPE_CODE"].as_str().unwrap_or(""),
+            "class": class_name,
+            "behavior": behavior,
+            "anonymize": ftype["ANONYMIZE"].as_str().unwrap_or(""),
+            "candidates": ftype["USED_FOR_CAND"].as_str().unwrap_or(""),
+            "standardize": standardize,
+            "expression": expression,
+            "comparison": comparison,
+            "matchKey": ftype["SHOW_IN_MATCH_KEY"].as_str().unwrap_or(""),
+            "version": ftype["VERSION"].as_i64().unwrap_or(0),
+            "elementList": element_list
         })
-        .collect();
-
-    element_list.sort_by_key(|(order, _)| *order);
-    let element_list: Vec<Value> = element_list.into_iter().map(|(_, v)| v).collect();
-
-    Ok(json!({
-        "id": ftype_id,
-        "feature": ftype["FTYPE_CODE"].as_str().unwrap_or(""),
-        "class": class_name,
-        "behavior": behavior,
-        "anonymize": ftype["ANONYMIZE"].as_str().unwrap_or(""),
-        "candidates": ftype["USED_FOR_CAND"].as_str().unwrap_or(""),
-        "standardize": standardize,
-        "expression": expression,
-        "comparison": comparison,
-        "matchKey": ftype["SHOW_IN_MATCH_KEY"].as_str().unwrap_or(""),
-        "version": ftype["VERSION"].as_i64().unwrap_or(0),
-        "elementList": element_list
-    }))
+    }
 }
 
 /// Parse a behavior code string into (frequency, exclusivity, stability)
@@ -1291,53 +1643,7 @@ pub fn add_feature_comparison(
     config_json: &str,
     params: AddFeatureComparisonParams,
 ) -> Result<String> {
-    let feature_code = params
-        .feature_code
-        .ok_or_else(|| SzConfigError::MissingField("feature_code".to_string()))?;
-    let element_code = params
-        .element_code
-        .ok_or_else(|| SzConfigError::MissingField("element_code".to_string()))?;
-
-    let ftype_id = helpers::lookup_feature_id(config_json, feature_code)?;
-    let felem_id = helpers::lookup_element_id(config_json, element_code)?;
-
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Check if already exists
-    let fbom_array = config["G2_CONFIG"]["CFG_FBOM"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FBOM".to_string()))?;
-
-    if fbom_array.iter().any(|item| {
-        item["FTYPE_ID"].as_i64() == Some(ftype_id) && item["FELEM_ID"].as_i64() == Some(felem_id)
-    }) {
-        return Err(SzConfigError::AlreadyExists(format!(
-            "Feature comparison: {:?}+{:?}",
-            params.feature_code, params.element_code
-        )));
-    }
-
-    // Build record
-    let mut record = json!({
-        "FTYPE_ID": ftype_id,
-        "FELEM_ID": felem_id,
-    });
-
-    if let Some(order) = params.exec_order {
-        record["EXEC_ORDER"] = json!(order);
-    }
-    if let Some(level) = params.display_level {
-        record["DISPLAY_LEVEL"] = json!(level);
-    }
-    if let Some(delim) = params.display_delim {
-        record["DISPLAY_DELIM"] = json!(delim);
-    }
-    if let Some(der) = params.derived {
-        record["DERIVED"] = json!(der);
-    }
-
-    helpers::add_to_config_array(config_json, "CFG_FBOM", record)
+    handle::edit(config_json, |config| config.add_feature_comparison(params))
 }
 
 /// Delete a feature comparison element (FBOM record)
@@ -1354,33 +1660,9 @@ pub fn delete_feature_comparison(
     feature_code: &str,
     element_code: &str,
 ) -> Result<String> {
-    let ftype_id = helpers::lookup_feature_id(config_json, feature_code)?;
-    let felem_id = helpers::lookup_element_id(config_json, element_code)?;
-
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let mut found = false;
-
-    if let Some(fbom_array) = config["G2_CONFIG"]["CFG_FBOM"].as_array_mut() {
-        fbom_array.retain(|item| {
-            let matches = item["FTYPE_ID"].as_i64() == Some(ftype_id)
-                && item["FELEM_ID"].as_i64() == Some(felem_id);
-            if matches {
-                found = true;
-            }
-            !matches
-        });
-    }
-
-    if !found {
-        return Err(SzConfigError::NotFound(format!(
-            "Feature comparison: FTYPE_ID={}, FELEM_ID={}",
-            ftype_id, felem_id
-        )));
-    }
-
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config_json, |config| {
+        config.delete_feature_comparison(feature_code, element_code)
+    })
 }
 
 /// Get a specific feature comparison element
@@ -1395,36 +1677,7 @@ pub fn get_feature_comparison(
     config_json: &str,
     params: GetFeatureComparisonParams,
 ) -> Result<Value> {
-    let feature_code = params
-        .feature_code
-        .ok_or_else(|| SzConfigError::MissingField("feature_code".to_string()))?;
-    let element_code = params
-        .element_code
-        .ok_or_else(|| SzConfigError::MissingField("element_code".to_string()))?;
-
-    let ftype_id = helpers::lookup_feature_id(config_json, feature_code)?;
-    let felem_id = helpers::lookup_element_id(config_json, element_code)?;
-
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let fbom_array = config["G2_CONFIG"]["CFG_FBOM"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FBOM".to_string()))?;
-
-    fbom_array
-        .iter()
-        .find(|item| {
-            item["FTYPE_ID"].as_i64() == Some(ftype_id)
-                && item["FELEM_ID"].as_i64() == Some(felem_id)
-        })
-        .cloned()
-        .ok_or_else(|| {
-            SzConfigError::NotFound(format!(
-                "Feature comparison: {:?}+{:?}",
-                params.feature_code, params.element_code
-            ))
-        })
+    handle::read(config_json, |config| config.get_feature_comparison(params))
 }
 
 /// List all feature comparison elements (FBOM records)
@@ -1435,25 +1688,7 @@ pub fn get_feature_comparison(
 /// # Returns
 /// Vector of JSON Values representing feature comparisons, sorted by FTYPE_ID and EXEC_ORDER
 pub fn list_feature_comparisons(config_json: &str) -> Result<Vec<Value>> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let fbom_array = config["G2_CONFIG"]["CFG_FBOM"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FBOM".to_string()))?;
-
-    let mut result: Vec<Value> = fbom_array.to_vec();
-
-    // Sort by FTYPE_ID and EXEC_ORDER
-    result.sort_by(|a, b| {
-        let a_ftype = a["FTYPE_ID"].as_i64().unwrap_or(0);
-        let b_ftype = b["FTYPE_ID"].as_i64().unwrap_or(0);
-        let a_exec = a["EXEC_ORDER"].as_i64().unwrap_or(0);
-        let b_exec = b["EXEC_ORDER"].as_i64().unwrap_or(0);
-        (a_ftype, a_exec).cmp(&(b_ftype, b_exec))
-    });
-
-    Ok(result)
+    handle::read(config_json, |config| config.list_feature_comparisons())
 }
 
 /// Add a feature comparison element (same as add_feature_comparison, for compatibility)
@@ -1503,56 +1738,9 @@ pub fn add_feature_distinct_call_element(
     config_json: &str,
     params: AddFeatureDistinctCallElementParams,
 ) -> Result<String> {
-    let feature_code = params
-        .feature_code
-        .ok_or_else(|| SzConfigError::MissingField("feature_code".to_string()))?;
-    let distinct_func_code = params
-        .distinct_func_code
-        .ok_or_else(|| SzConfigError::MissingField("distinct_func_code".to_string()))?;
-
-    let ftype_id = helpers::lookup_feature_id(config_json, feature_code)?;
-    let dfunc_id = helpers::lookup_dfunc_id(config_json, distinct_func_code)?;
-    let felem_id = if let Some(code) = params.element_code {
-        helpers::lookup_element_id(config_json, code)?
-    } else {
-        -1
-    };
-
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    // Check if already exists
-    let dfcall_array = config["G2_CONFIG"]["CFG_DFCALL"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_DFCALL".to_string()))?;
-
-    if dfcall_array.iter().any(|item| {
-        item["FTYPE_ID"].as_i64() == Some(ftype_id)
-            && item["DFUNC_ID"].as_i64() == Some(dfunc_id)
-            && item["FELEM_ID"].as_i64() == Some(felem_id)
-    }) {
-        return Err(SzConfigError::AlreadyExists(format!(
-            "Feature distinct call element: {:?}+{:?}",
-            params.feature_code, params.distinct_func_code
-        )));
-    }
-
-    // Get next DFCALL_ID
-    let dfcall_id = helpers::get_next_id_with_min(dfcall_array, "DFCALL_ID", 1000)?;
-
-    // Build record
-    let mut record = json!({
-        "DFCALL_ID": dfcall_id,
-        "FTYPE_ID": ftype_id,
-        "DFUNC_ID": dfunc_id,
-        "FELEM_ID": felem_id,
-    });
-
-    if let Some(order) = params.exec_order {
-        record["EXEC_ORDER"] = json!(order);
-    }
-
-    helpers::add_to_config_array(config_json, "CFG_DFCALL", record)
+    handle::edit(config_json, |config| {
+        config.add_feature_distinct_call_element(params)
+    })
 }
 
 /// List all feature classes (CFG_FCLASS records)
@@ -1563,19 +1751,7 @@ pub fn add_feature_distinct_call_element(
 /// # Returns
 /// Vector of JSON Values representing feature classes
 pub fn list_feature_classes(config_json: &str) -> Result<Vec<Value>> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let fclass_array = config["G2_CONFIG"]["CFG_FCLASS"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FCLASS".to_string()))?;
-
-    let mut result: Vec<Value> = fclass_array.to_vec();
-
-    // Sort by FCLASS_ID
-    result.sort_by_key(|item| item["FCLASS_ID"].as_i64().unwrap_or(0));
-
-    Ok(result)
+    handle::read(config_json, |config| config.list_feature_classes())
 }
 
 /// Get a specific feature class by ID or code
@@ -1587,29 +1763,9 @@ pub fn list_feature_classes(config_json: &str) -> Result<Vec<Value>> {
 /// # Returns
 /// JSON Value representing the feature class
 pub fn get_feature_class(config_json: &str, fclass_id_or_code: &str) -> Result<Value> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let fclass_array = config["G2_CONFIG"]["CFG_FCLASS"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FCLASS".to_string()))?;
-
-    // Try to parse as ID first
-    if let Ok(id) = fclass_id_or_code.trim().parse::<i64>() {
-        fclass_array
-            .iter()
-            .find(|item| item["FCLASS_ID"].as_i64() == Some(id))
-            .cloned()
-            .ok_or_else(|| SzConfigError::NotFound(format!("Feature class: {}", id)))
-    } else {
-        // Try as code
-        let code_upper = fclass_id_or_code.to_uppercase();
-        fclass_array
-            .iter()
-            .find(|item| item["FCLASS_CODE"].as_str() == Some(code_upper.as_str()))
-            .cloned()
-            .ok_or_else(|| SzConfigError::NotFound(format!("Feature class: {}", code_upper)))
-    }
+    handle::read(config_json, |config| {
+        config.get_feature_class(fclass_id_or_code)
+    })
 }
 
 /// Update the feature version in compatibility settings
@@ -1621,15 +1777,148 @@ pub fn get_feature_class(config_json: &str, fclass_id_or_code: &str) -> Result<V
 /// # Returns
 /// Modified configuration JSON string
 pub fn update_feature_version(config_json: &str, version: &str) -> Result<String> {
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
+    handle::edit(config_json, |config| config.update_feature_version(version))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_list_features_joins_child_tables() {
+        let config = ConfigHandle::from_value(json!({"G2_CONFIG": {
+            "CFG_FCLASS": [{"FCLASS_ID": 2, "FCLASS_CODE": "ADDRESS"}],
+            "CFG_FTYPE": [
+                {"FTYPE_ID": 20, "FTYPE_CODE": "ADDR", "FCLASS_ID": 2, "FTYPE_FREQ": "FM", "FTYPE_EXCL": "Yes"},
+                {"FTYPE_ID": 10, "FTYPE_CODE": "PHONE", "FCLASS_ID": 9}
+            ],
+            "CFG_FELEM": [
+                {"FELEM_ID": 1, "FELEM_CODE": "LINE1"},
+                {"FELEM_ID": 2, "FELEM_CODE": "CITY"}
+            ],
+            "CFG_FBOM": [
+                {"FTYPE_ID": 20, "FELEM_ID": 2, "EXEC_ORDER": 2, "DISPLAY_LEVEL": 0},
+                {"FTYPE_ID": 20, "FELEM_ID": 1, "EXEC_ORDER": 1}
+            ],
+            "CFG_SFUNC": [{"SFUNC_ID": 5, "SFUNC_CODE": "PARSE_ADDR"}],
+            "CFG_SFCALL": [{"FTYPE_ID": 20, "SFUNC_ID": 5, "EXEC_ORDER": 1}],
+            "CFG_EFUNC": [
+                {"EFUNC_ID": 7, "EFUNC_CODE": "LATE"},
+                {"EFUNC_ID": 8, "EFUNC_CODE": "EARLY"}
+            ],
+            "CFG_EFCALL": [
+                {"EFCALL_ID": 100, "FTYPE_ID": 20, "EFUNC_ID": 7, "EXEC_ORDER": 5},
+                {"EFCALL_ID": 101, "FTYPE_ID": 20, "EFUNC_ID": 8, "EXEC_ORDER": 1}
+            ],
+            "CFG_EFBOM": [
+                {"EFCALL_ID": 100, "FTYPE_ID": 20, "FELEM_ID": 1},
+                {"EFCALL_ID": 101, "FTYPE_ID": 20, "FELEM_ID": 2}
+            ],
+            "CFG_CFUNC": [{"CFUNC_ID": 3, "CFUNC_CODE": "ADDR_COMP"}],
+            "CFG_CFCALL": [{"CFCALL_ID": 50, "FTYPE_ID": 20, "CFUNC_ID": 3}],
+            "CFG_CFBOM": [{"CFCALL_ID": 50, "FTYPE_ID": 20, "FELEM_ID": 1}]
+        }}));
+
+        let features = config.list_features().unwrap();
+        assert_eq!(features.len(), 2);
+
+        // Sorted by ID; unknown class falls back to OTHER
+        assert_eq!(features[0]["feature"], "PHONE");
+        assert_eq!(features[0]["class"], "OTHER");
+        assert_eq!(features[0]["elementList"], json!([]));
+
+        let addr = &features[1];
+        assert_eq!(addr["class"], "ADDRESS");
+        assert_eq!(addr["behavior"], "FME");
+        assert_eq!(addr["standardize"], "PARSE_ADDR");
+        assert_eq!(addr["expression"], "EARLY");
+        assert_eq!(addr["comparison"], "ADDR_COMP");
+        assert_eq!(
+            addr["elementList"],
+            json!([
+                {"element": "LINE1", "expressed": "No", "compared": "Yes", "derived": "No", "display": "Yes"},
+                {"element": "CITY", "expressed": "Yes", "compared": "No", "derived": "No", "display": "No"}
+            ])
+        );
+
+        // A single feature collects only its own rows but renders the same
+        assert_eq!(config.get_feature("ADDR").unwrap(), *addr);
+        assert_eq!(config.get_feature("10").unwrap(), features[0]);
+    }
+
+    fn custom_features_config() -> ConfigHandle {
+        ConfigHandle::from_value(json!({"G2_CONFIG": {
+            "CFG_FTYPE": [
+                {"FTYPE_ID": 1, "FTYPE_CODE": "NAME"},
+                {"FTYPE_ID": 100, "FTYPE_CODE": "LOYALTY_ID"},
+                {"FTYPE_ID": 101, "FTYPE_CODE": "BADGE"},
+                {"FTYPE_ID": 102, "FTYPE_CODE": "KEEP"}
+            ],
+            "CFG_FBOM": [
+                {"FTYPE_ID": 100, "FELEM_ID": 1},
+                {"FTYPE_ID": 101, "FELEM_ID": 1},
+                {"FTYPE_ID": 102, "FELEM_ID": 1}
+            ],
+            "CFG_ATTR": [
+                {"ATTR_ID": 1, "FTYPE_CODE": "loyalty_id"},
+                {"ATTR_ID": 2, "FTYPE_CODE": "KEEP"},
+                {"ATTR_ID": 3, "FTYPE_CODE": "BADGE"}
+            ],
+            "CFG_SFCALL": [{"SFCALL_ID": 1, "FTYPE_ID": 101}],
+            "CFG_EFCALL": [{"EFCALL_ID": 5, "FTYPE_ID": 100}, {"EFCALL_ID": 6, "FTYPE_ID": 102}],
+            "CFG_EFBOM": [{"EFCALL_ID": 5, "FTYPE_ID": 100}, {"EFCALL_ID": 6, "FTYPE_ID": 102}],
+            "CFG_CFCALL": [{"CFCALL_ID": 7, "FTYPE_ID": 101}],
+            "CFG_CFBOM": [{"CFCALL_ID": 7, "FTYPE_ID": 101}],
+            "CFG_DFCALL": [],
+            "CFG_DFBOM": []
+        }}))
+    }
 
-    // Navigate to COMPATIBILITY_VERSION
-    let compat_version = config["G2_CONFIG"]["CONFIG_BASE_VERSION"]["COMPATIBILITY_VERSION"]
-        .as_object_mut()
-        .ok_or_else(|| SzConfigError::MissingSection("COMPATIBILITY_VERSION".to_string()))?;
+    #[test]
+    fn test_delete_features_matches_per_feature_deletes() {
+        let mut one_by_one = custom_features_config();
+        one_by_one.delete_feature("LOYALTY_ID").unwrap();
+        one_by_one.delete_feature("101").unwrap();
 
-    compat_version.insert("FEATURE_VERSION".to_string(), json!(version));
+        let mut bulk = custom_features_config();
+        bulk.delete_features(&["LOYALTY_ID", "101"]).unwrap();
 
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+        assert_eq!(bulk.as_value(), one_by_one.as_value());
+        assert_eq!(bulk.section("CFG_FTYPE").unwrap().len(), 2);
+        assert_eq!(bulk.section("CFG_ATTR").unwrap().len(), 1);
+        assert_eq!(bulk.section("CFG_EFBOM").unwrap().len(), 1);
+    }
+
+    #[test]
+    fn test_delete_features_touches_only_sections_with_dependents() {
+        let mut config = custom_features_config();
+        config.record_touched_sections();
+        config.delete_features(&["LOYALTY_ID"]).unwrap();
+        assert_eq!(
+            config.take_touched_sections(),
+            [
+                "CFG_ATTR",
+                "CFG_EFBOM",
+                "CFG_EFCALL",
+                "CFG_FBOM",
+                "CFG_FTYPE"
+            ]
+        );
+    }
+
+    #[test]
+    fn test_delete_features_validates_all_first() {
+        let mut config = custom_features_config();
+        let before = config.as_value().clone();
+
+        assert!(matches!(
+            config.delete_features(&["BADGE", "NAME"]),
+            Err(SzConfigError::InvalidInput(_))
+        ));
+        assert!(matches!(
+            config.delete_features(&["BADGE", "badge"]),
+            Err(SzConfigError::NotFound(_))
+        ));
+        assert_eq!(config.as_value(), &before);
+    }
 }
@@ -13,15 +13,20 @@
 #![allow(clippy::missing_safety_doc)]
 #![allow(clippy::not_unsafe_ptr_arg_deref)]
 
+use std::cell::{Cell, RefCell};
 use std::ffi::{CStr, CString};
 use std::os::raw::c_char;
-use std::sync::Mutex;
 
 use crate::error::SzConfigError;
+use crate::handle::ConfigHandle;
+use crate::shared::{SharedConfig, SharedReader};
 
-// Thread-safe error storage
-static LAST_ERROR: Mutex<Option<String>> = Mutex::new(None);
-static LAST_ERROR_CODE: Mutex<i64> = Mutex::new(0);
+// Per-thread error storage: each thread sees only the errors of its own calls,
+// and recording or clearing an error takes no locks
+thread_local! {
+    static LAST_ERROR: RefCell<Option<CString>> = const { RefCell::new(None) };
+    static LAST_ERROR_CODE: Cell<i64> = const { Cell::new(0) };
+}
 
 /// Platform-specific export macro
 #[cfg(target_os = "windows")]
@@ -61,33 +66,32 @@ pub unsafe extern "C" fn SzConfigTool_free(ptr: *mut c_char) {
     }
 }
 
-/// Get the last error message
+/// Get the last error message of the calling thread
 ///
 /// # Returns
-/// Pointer to error string (do not free), or null if no error
+/// Pointer to error string (do not free), or null if no error. The pointer is
+/// valid until the next library call on the same thread.
 #[unsafe(no_mangle)]
 pub extern "C" fn SzConfigTool_getLastError() -> *const c_char {
-    let error = LAST_ERROR.lock().unwrap();
-    match error.as_ref() {
-        Some(err) => err.as_ptr() as *const c_char,
+    LAST_ERROR.with_borrow(|error| match error {
+        Some(err) => err.as_ptr(),
         None => std::ptr::null(),
-    }
+    })
 }
 
-/// Get the last error code
+/// Get the last error code of the calling thread
 ///
 /// # Returns
 /// Error code (0 = no error, negative = error)
 #[unsafe(no_mangle)]
 pub extern "C" fn SzConfigTool_getLastErrorCode() -> i64 {
-    *LAST_ERROR_CODE.lock().unwrap()
+    LAST_ERROR_CODE.get()
 }
 
-/// Clear the last error
+/// Clear the last error of the calling thread
 #[unsafe(no_mangle)]
 pub extern "C" fn SzConfigTool_clearLastError() {
-    *LAST_ERROR.lock().unwrap() = None;
-    *LAST_ERROR_CODE.lock().unwrap() = 0;
+    clear_error();
 }
 
 // ============================================================================
@@ -125,13 +129,158 @@ macro_rules! handle_result {
 }
 
 fn set_error(msg: String, code: i64) {
-    *LAST_ERROR.lock().unwrap() = Some(msg);
-    *LAST_ERROR_CODE.lock().unwrap() = code;
+    // Messages can echo caller input; keep everything up to an interior NUL
+    let msg = CString::new(msg).unwrap_or_else(|e| {
+        let nul = e.nul_position();
+        let mut bytes = e.into_vec();
+        bytes.truncate(nul);
+        CString::new(bytes).unwrap_or_default()
+    });
+    LAST_ERROR.set(Some(msg));
+    LAST_ERROR_CODE.set(code);
 }
 
 fn clear_error() {
-    *LAST_ERROR.lock().unwrap() = None;
-    *LAST_ERROR_CODE.lock().unwrap() = 0;
+    LAST_ERROR.take();
+    LAST_ERROR_CODE.set(0);
+}
+
+// ============================================================================
+// Parameter Builders (shared by the string and handle entry points)
+// ============================================================================
+
+/// Build data source update parameters from an updates JSON object
+fn set_data_source_params<'a>(
+    code: &'a str,
+    updates: &'a serde_json::Value,
+) -> crate::datasources::SetDataSourceParams<'a> {
+    crate::datasources::SetDataSourceParams {
+        code,
+        retention_level: updates.get("retentionLevel").and_then(|v| v.as_str()),
+        conversational: updates.get("conversational").and_then(|v| v.as_str()),
+        reliability: updates.get("reliability").and_then(|v| v.as_i64()),
+    }
+}
+
+/// Build attribute update parameters from an updates JSON object
+fn set_attribute_params<'a>(
+    attribute: &'a str,
+    updates: &'a serde_json::Value,
+) -> crate::attributes::SetAttributeParams<'a> {
+    crate::attributes::SetAttributeParams {
+        attribute,
+        internal: updates.get("internal").and_then(|v| v.as_str()),
+        required: updates.get("required").and_then(|v| v.as_str()),
+        default_value: updates.get("default").and_then(|v| v.as_str()),
+    }
+}
+
+/// Build feature parameters from a feature JSON object (elementList required)
+fn add_feature_params<'a>(
+    feature: &'a str,
+    feature_config: &'a serde_json::Value,
+) -> Result<crate::features::AddFeatureParams<'a>, String> {
+    let element_list = feature_config
+        .get("elementList")
+        .or_else(|| feature_config.get("element_list"))
+        .ok_or_else(|| "Missing required field: elementList".to_string())?;
+
+    Ok(crate::features::AddFeatureParams {
+        feature,
+        element_list,
+        class: feature_config.get("class").and_then(|v| v.as_str()),
+        behavior: feature_config.get("behavior").and_then(|v| v.as_str()),
+        candidates: feature_config.get("candidates").and_then(|v| v.as_str()),
+        anonymize: feature_config.get("anonymize").and_then(|v| v.as_str()),
+        derived: feature_config.get("derived").and_then(|v| v.as_str()),
+        history: feature_config.get("history").and_then(|v| v.as_str()),
+        matchkey: feature_config
+            .get("matchkey")
+            .or_else(|| feature_config.get("matchKey"))
+            .and_then(|v| v.as_str()),
+        standardize: feature_config.get("standardize").and_then(|v| v.as_str()),
+        expression: feature_config.get("expression").and_then(|v| v.as_str()),
+        comparison: feature_config.get("comparison").and_then(|v| v.as_str()),
+        version: feature_config.get("version").and_then(|v| v.as_i64()),
+        rtype_id: feature_config
+            .get("rtype_id")
+            .or_else(|| feature_config.get("rtypeId"))
+            .and_then(|v| v.as_i64()),
+    })
+}
+
+/// Build feature update parameters from an updates JSON object
+fn set_feature_params<'a>(
+    feature: &'a str,
+    updates: &'a serde_json::Value,
+) -> crate::features::SetFeatureParams<'a> {
+    crate::features::SetFeatureParams {
+        feature,
+        candidates: updates.get("candidates").and_then(|v| v.as_str()),
+        anonymize: updates.get("anonymize").and_then(|v| v.as_str()),
+        derived: updates.get("derived").and_then(|v| v.as_str()),
+        history: updates.get("history").and_then(|v| v.as_str()),
+        matchkey: updates
+            .get("matchkey")
+            .or_else(|| updates.get("matchKey"))
+            .and_then(|v| v.as_str()),
+        behavior: updates.get("behavior").and_then(|v| v.as_str()),
+        class: updates.get("class").and_then(|v| v.as_str()),
+        version: updates.get("version").and_then(|v| v.as_i64()),
+        rtype_id: updates
+            .get("rtypeId")
+            .or_else(|| updates.get("RTYPE_ID"))
+            .and_then(|v| v.as_i64()),
+    }
+}
+
+/// Look up a string field by its camelCase or raw config name
+fn str_field<'a>(json: &'a serde_json::Value, name: &str, raw_name: &str) -> Option<&'a str> {
+    json.get(name)
+        .and_then(|v| v.as_str())
+        .or_else(|| json.get(raw_name).and_then(|v| v.as_str()))
+}
+
+/// Build element parameters from an element JSON object
+fn add_element_params<'a>(
+    code: &'a str,
+    element_config: &'a serde_json::Value,
+) -> crate::elements::AddElementParams<'a> {
+    crate::elements::AddElementParams {
+        code,
+        description: str_field(element_config, "description", "FELEM_DESC"),
+        data_type: str_field(element_config, "dataType", "DATA_TYPE"),
+        tokenized: str_field(element_config, "tokenized", "TOKENIZED"),
+    }
+}
+
+/// Build element update parameters from an updates JSON object
+fn set_element_params<'a>(
+    code: &'a str,
+    updates: &'a serde_json::Value,
+) -> crate::elements::SetElementParams<'a> {
+    crate::elements::SetElementParams {
+        code,
+        description: str_field(updates, "description", "FELEM_DESC"),
+        data_type: str_field(updates, "dataType", "DATA_TYPE"),
+        tokenized: str_field(updates, "tokenized", "TOKENIZED"),
+    }
+}
+
+/// Build rule update parameters from a rule JSON object
+fn set_rule_params<'a>(
+    code: &'a str,
+    rule_value: &'a serde_json::Value,
+) -> crate::rules::SetRuleParams<'a> {
+    crate::rules::SetRuleParams {
+        code,
+        resolve: str_field(rule_value, "resolve", "RESOLVE"),
+        relate: str_field(rule_value, "relate", "RELATE"),
+        rtype_id: rule_value
+            .get("rtypeId")
+            .and_then(|v| v.as_i64())
+            .or_else(|| rule_value.get("RTYPE_ID").and_then(|v| v.as_i64())),
+    }
 }
 
 // ============================================================================
@@ -597,15 +746,10 @@ pub unsafe extern "C" fn SzConfigTool_setAttribute(
         }
     };
 
-    // Build params with attribute from parameter and optional updates from JSON
-    let params = crate::attributes::SetAttributeParams {
-        attribute: attr_code,
-        internal: updates.get("internal").and_then(|v| v.as_str()),
-        required: updates.get("required").and_then(|v| v.as_str()),
-        default_value: updates.get("default").and_then(|v| v.as_str()),
-    };
-
-    handle_result!(crate::attributes::set_attribute(config, params))
+    handle_result!(crate::attributes::set_attribute(
+        config,
+        set_attribute_params(attr_code, &updates)
+    ))
 }
 
 // ============================================================================
@@ -2342,23 +2486,10 @@ pub extern "C" fn SzConfigTool_setRule(
     };
 
     // Build params from code and JSON config
-    let params = crate::rules::SetRuleParams {
-        code,
-        resolve: rule_value
-            .get("resolve")
-            .and_then(|v| v.as_str())
-            .or_else(|| rule_value.get("RESOLVE").and_then(|v| v.as_str())),
-        relate: rule_value
-            .get("relate")
-            .and_then(|v| v.as_str())
-            .or_else(|| rule_value.get("RELATE").and_then(|v| v.as_str())),
-        rtype_id: rule_value
-            .get("rtypeId")
-            .and_then(|v| v.as_i64())
-            .or_else(|| rule_value.get("RTYPE_ID").and_then(|v| v.as_i64())),
-    };
-
-    handle_result!(crate::rules::set_rule(config, params))
+    handle_result!(crate::rules::set_rule(
+        config,
+        set_rule_params(code, &rule_value)
+    ))
 }
 
 /* ============================================================================
@@ -5299,15 +5430,10 @@ pub extern "C" fn SzConfigTool_setDataSource(
         }
     };
 
-    // Build params with code from parameter and optional updates from JSON
-    let params = crate::datasources::SetDataSourceParams {
-        code: ds_code,
-        retention_level: updates_value.get("retentionLevel").and_then(|v| v.as_str()),
-        conversational: updates_value.get("conversational").and_then(|v| v.as_str()),
-        reliability: updates_value.get("reliability").and_then(|v| v.as_i64()),
-    };
-
-    handle_result!(crate::datasources::set_data_source(config, params))
+    handle_result!(crate::datasources::set_data_source(
+        config,
+        set_data_source_params(ds_code, &updates_value)
+    ))
 }
 
 /* ============================================================================
@@ -5407,14 +5533,10 @@ pub extern "C" fn SzConfigTool_addFeature(
         }
     };
 
-    // Extract parameters from JSON
-    let element_list = match feature_config
-        .get("elementList")
-        .or_else(|| feature_config.get("element_list"))
-    {
-        Some(v) => v,
-        None => {
-            set_error("Missing required field: elementList".to_string(), -3);
+    let params = match add_feature_params(code, &feature_config) {
+        Ok(params) => params,
+        Err(e) => {
+            set_error(e.to_string(), -3);
             return SzConfigTool_result {
                 response: std::ptr::null_mut(),
                 returnCode: -3,
@@ -5422,44 +5544,7 @@ pub extern "C" fn SzConfigTool_addFeature(
         }
     };
 
-    let class = feature_config.get("class").and_then(|v| v.as_str());
-    let behavior = feature_config.get("behavior").and_then(|v| v.as_str());
-    let candidates = feature_config.get("candidates").and_then(|v| v.as_str());
-    let anonymize = feature_config.get("anonymize").and_then(|v| v.as_str());
-    let derived = feature_config.get("derived").and_then(|v| v.as_str());
-    let history = feature_config.get("history").and_then(|v| v.as_str());
-    let matchkey = feature_config
-        .get("matchkey")
-        .or_else(|| feature_config.get("matchKey"))
-        .and_then(|v| v.as_str());
-    let standardize = feature_config.get("standardize").and_then(|v| v.as_str());
-    let expression = feature_config.get("expression").and_then(|v| v.as_str());
-    let comparison = feature_config.get("comparison").and_then(|v| v.as_str());
-    let version = feature_config.get("version").and_then(|v| v.as_i64());
-    let rtype_id = feature_config
-        .get("rtype_id")
-        .or_else(|| feature_config.get("rtypeId"))
-        .and_then(|v| v.as_i64());
-
-    match crate::features::add_feature(
-        config,
-        crate::features::AddFeatureParams {
-            feature: code,
-            element_list,
-            class,
-            behavior,
-            candidates,
-            anonymize,
-            derived,
-            history,
-            matchkey,
-            standardize,
-            expression,
-            comparison,
-            version,
-            rtype_id,
-        },
-    ) {
+    match crate::features::add_feature(config, params) {
         Ok(modified_config) => match CString::new(modified_config) {
             Ok(c_str) => {
                 clear_error();
@@ -5614,37 +5699,9 @@ pub extern "C" fn SzConfigTool_setFeature(
         }
     };
 
-    // Extract optional parameters
-    let candidates = updates_config.get("candidates").and_then(|v| v.as_str());
-    let anonymize = updates_config.get("anonymize").and_then(|v| v.as_str());
-    let derived = updates_config.get("derived").and_then(|v| v.as_str());
-    let history = updates_config.get("history").and_then(|v| v.as_str());
-    let matchkey = updates_config
-        .get("matchkey")
-        .or_else(|| updates_config.get("matchKey"))
-        .and_then(|v| v.as_str());
-    let behavior = updates_config.get("behavior").and_then(|v| v.as_str());
-    let class = updates_config.get("class").and_then(|v| v.as_str());
-    let version = updates_config.get("version").and_then(|v| v.as_i64());
-    let rtype_id = updates_config
-        .get("rtypeId")
-        .or_else(|| updates_config.get("RTYPE_ID"))
-        .and_then(|v| v.as_i64());
-
     handle_result!(crate::features::set_feature(
         config,
-        crate::features::SetFeatureParams {
-            feature: code_or_id,
-            candidates,
-            anonymize,
-            derived,
-            history,
-            matchkey,
-            behavior,
-            class,
-            version,
-            rtype_id,
-        }
+        set_feature_params(code_or_id, &updates_config)
     ))
 }
 
@@ -5928,23 +5985,10 @@ pub extern "C" fn SzConfigTool_addElement(
     };
 
     // Build params from code and JSON config
-    let params = crate::elements::AddElementParams {
-        code,
-        description: element_config
-            .get("description")
-            .and_then(|v| v.as_str())
-            .or_else(|| element_config.get("FELEM_DESC").and_then(|v| v.as_str())),
-        data_type: element_config
-            .get("dataType")
-            .and_then(|v| v.as_str())
-            .or_else(|| element_config.get("DATA_TYPE").and_then(|v| v.as_str())),
-        tokenized: element_config
-            .get("tokenized")
-            .and_then(|v| v.as_str())
-            .or_else(|| element_config.get("TOKENIZED").and_then(|v| v.as_str())),
-    };
-
-    handle_result!(crate::elements::add_element(config, params))
+    handle_result!(crate::elements::add_element(
+        config,
+        add_element_params(code, &element_config)
+    ))
 }
 
 /// Delete an element by code
@@ -6075,23 +6119,10 @@ pub extern "C" fn SzConfigTool_setElement(
     };
 
     // Build params from code and JSON updates
-    let params = crate::elements::SetElementParams {
-        code,
-        description: updates_config
-            .get("description")
-            .and_then(|v| v.as_str())
-            .or_else(|| updates_config.get("FELEM_DESC").and_then(|v| v.as_str())),
-        data_type: updates_config
-            .get("dataType")
-            .and_then(|v| v.as_str())
-            .or_else(|| updates_config.get("DATA_TYPE").and_then(|v| v.as_str())),
-        tokenized: updates_config
-            .get("tokenized")
-            .and_then(|v| v.as_str())
-            .or_else(|| updates_config.get("TOKENIZED").and_then(|v| v.as_str())),
-    };
-
-    handle_result!(crate::elements::set_element(config, params))
+    handle_result!(crate::elements::set_element(
+        config,
+        set_element_params(code, &updates_config)
+    ))
 }
 
 /* ============================================================================
@@ -9544,3 +9575,3627 @@ pub extern "C" fn SzConfigTool_setScoringFunction(
         }
     }
 }
+
+// ============================================================================
+// Handle Functions
+// ============================================================================
+// A handle owns a parsed configuration. The handle mutators edit it in place
+// and return 0 on success or a negative error code (message available from
+// SzConfigTool_getLastError), so a sequence of N edits costs one parse in
+// SzConfigTool_open and one serialization in SzConfigTool_serialize.
+
+/// Opaque parsed configuration created by `SzConfigTool_open`
+#[allow(non_camel_case_types)] // Match C convention from SzHelpers
+pub struct SzConfigTool_handle {
+    config: ConfigHandle,
+    /// Output of the last borrowed read (see `with_view`), reused across reads
+    view: Vec<u8>,
+}
+
+/// Failure while running a handle entry point (message, return code)
+struct HandleError(String, i64);
+
+impl From<SzConfigError> for HandleError {
+    fn from(e: SzConfigError) -> Self {
+        HandleError(e.to_string(), -2)
+    }
+}
+
+/// Read a required C string argument
+unsafe fn arg_str<'a>(ptr: *const c_char, name: &str) -> Result<&'a str, HandleError> {
+    if ptr.is_null() {
+        return Err(HandleError(format!("{} is null", name), -1));
+    }
+    unsafe { CStr::from_ptr(ptr) }
+        .to_str()
+        .map_err(|e| HandleError(format!("Invalid UTF-8 in {}: {}", name, e), -2))
+}
+
+/// Read an optional C string argument (null or empty = None)
+unsafe fn arg_opt_str<'a>(ptr: *const c_char, name: &str) -> Result<Option<&'a str>, HandleError> {
+    if ptr.is_null() {
+        return Ok(None);
+    }
+    Ok(Some(unsafe { arg_str(ptr, name) }?).filter(|s| !s.is_empty()))
+}
+
+/// Read a required JSON argument
+unsafe fn arg_json(ptr: *const c_char, name: &str) -> Result<serde_json::Value, HandleError> {
+    let json = unsafe { arg_str(ptr, name) }?;
+    serde_json::from_str(json)
+        .map_err(|e| HandleError(format!("Invalid JSON in {}: {}", name, e), -3))
+}
+
+/// Convert a "negative = None" integer argument
+fn arg_opt_i64(value: i64) -> Option<i64> {
+    (value >= 0).then_some(value)
+}
+
+/// Read an optional field value for a set* edit (null or empty = unchanged)
+unsafe fn arg_opt_field<'a>(
+    ptr: *const c_char,
+    name: &str,
+) -> Result<Option<&'a str>, HandleError> {
+    Ok(unsafe { arg_opt_str(ptr, name) }?.filter(|s| !s.is_empty()))
+}
+
+/// Run an in-place edit against a handle and convert the outcome to a return code
+fn with_handle<F>(handle: *mut SzConfigTool_handle, f: F) -> i64
+where
+    F: FnOnce(&mut ConfigHandle) -> Result<(), HandleError>,
+{
+    let Some(handle) = (unsafe { handle.as_mut() }) else {
+        set_error("handle is null".to_string(), -1);
+        return -1;
+    };
+
+    match f(&mut handle.config) {
+        Ok(()) => {
+            clear_error();
+            0
+        }
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            code
+        }
+    }
+}
+
+/// Parse a configuration into a new handle
+///
+/// # Returns
+/// Handle to pass to the SzConfigTool_handle* functions (release with
+/// SzConfigTool_close), or null on error
+///
+/// # Safety
+/// configJson must be a valid null-terminated C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_open(config_json: *const c_char) -> *mut SzConfigTool_handle {
+    let result = unsafe { arg_str(config_json, "config_json") }
+        .and_then(|json| Ok(ConfigHandle::from_json(json)?));
+
+    match result {
+        Ok(config) => {
+            clear_error();
+            Box::into_raw(Box::new(SzConfigTool_handle {
+                config,
+                view: Vec::new(),
+            }))
+        }
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            std::ptr::null_mut()
+        }
+    }
+}
+
+/// Parse a configuration into a new handle that keeps its text
+///
+/// Like SzConfigTool_open, but SzConfigTool_serialize and
+/// SzConfigTool_saveFile then copy the sections not edited since instead of
+/// serializing them again (see `ConfigHandle::from_json_cached`). The handle
+/// holds a copy of configJson until every section has been edited.
+///
+/// # Returns
+/// Handle to pass to the SzConfigTool_handle* functions (release with
+/// SzConfigTool_close), or null on error
+///
+/// # Safety
+/// configJson must be a valid null-terminated C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_openCached(
+    config_json: *const c_char,
+) -> *mut SzConfigTool_handle {
+    let result = unsafe { arg_str(config_json, "config_json") }
+        .and_then(|json| Ok(ConfigHandle::from_json_cached(json)?));
+
+    match result {
+        Ok(config) => {
+            clear_error();
+            Box::into_raw(Box::new(SzConfigTool_handle {
+                config,
+                view: Vec::new(),
+            }))
+        }
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            std::ptr::null_mut()
+        }
+    }
+}
+
+/// Open a configuration file as a new handle
+///
+/// The file is parsed through a buffered reader without first being read
+/// into memory as a string.
+///
+/// # Returns
+/// Handle to pass to the SzConfigTool_handle* functions (release with
+/// SzConfigTool_close), or null on error
+///
+/// # Safety
+/// path must be a valid null-terminated C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_openFile(path: *const c_char) -> *mut SzConfigTool_handle {
+    let result = unsafe { arg_str(path, "path") }
+        .and_then(|path| Ok(crate::handle::open_config_file(path)?));
+
+    match result {
+        Ok(config) => {
+            clear_error();
+            Box::into_raw(Box::new(SzConfigTool_handle {
+                config,
+                view: Vec::new(),
+            }))
+        }
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            std::ptr::null_mut()
+        }
+    }
+}
+
+/// Save the configuration held by a handle to a file as compact JSON
+///
+/// The document is streamed to a buffered writer instead of being
+/// serialized to a string first.
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; path must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_saveFile(
+    handle: *mut SzConfigTool_handle,
+    path: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let path = unsafe { arg_str(path, "path") }?;
+        crate::handle::save_config_file(config, path)?;
+        Ok(())
+    })
+}
+
+/// Open a binary snapshot file as a new handle
+///
+/// Loads a file written by SzConfigTool_saveSnapshot without parsing JSON.
+/// When expected_compatibility is given (not null or empty), a snapshot with
+/// another compatibility version is rejected.
+///
+/// # Returns
+/// Handle to pass to the SzConfigTool_handle* functions (release with
+/// SzConfigTool_close), or null on error
+///
+/// # Safety
+/// path must be a valid null-terminated C string; expected_compatibility must
+/// be a valid C string or null
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_openSnapshot(
+    path: *const c_char,
+    expected_compatibility: *const c_char,
+) -> *mut SzConfigTool_handle {
+    let result = unsafe { arg_str(path, "path") }.and_then(|path| {
+        let expected = unsafe { arg_opt_str(expected_compatibility, "expected_compatibility") }?;
+        Ok(ConfigHandle::load_snapshot(path, expected)?)
+    });
+
+    match result {
+        Ok(config) => {
+            clear_error();
+            Box::into_raw(Box::new(SzConfigTool_handle {
+                config,
+                view: Vec::new(),
+            }))
+        }
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            std::ptr::null_mut()
+        }
+    }
+}
+
+/// Save the configuration held by a handle to a binary snapshot file
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; path must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_saveSnapshot(
+    handle: *mut SzConfigTool_handle,
+    path: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let path = unsafe { arg_str(path, "path") }?;
+        config.save_snapshot(path)?;
+        Ok(())
+    })
+}
+
+/// Release a handle created by SzConfigTool_open
+///
+/// # Safety
+/// handle must have been returned by SzConfigTool_open and not already closed, or be null
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_close(handle: *mut SzConfigTool_handle) {
+    if !handle.is_null() {
+        unsafe {
+            drop(Box::from_raw(handle));
+        }
+    }
+}
+
+/// Serialize the configuration held by a handle
+///
+/// # Safety
+/// handle must have been returned by SzConfigTool_open
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_serialize(
+    handle: *const SzConfigTool_handle,
+) -> SzConfigTool_result {
+    let Some(handle) = (unsafe { handle.as_ref() }) else {
+        set_error("handle is null".to_string(), -1);
+        return SzConfigTool_result {
+            response: std::ptr::null_mut(),
+            returnCode: -1,
+        };
+    };
+
+    handle_result!(handle.config.to_json())
+}
+
+// ===== Handle: Data Sources =====
+
+/// Add a data source to a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; dataSourceCode must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddDataSource(
+    handle: *mut SzConfigTool_handle,
+    data_source_code: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(data_source_code, "data_source_code") }?;
+        Ok(
+            config.add_data_source(crate::datasources::AddDataSourceParams {
+                code,
+                ..Default::default()
+            })?,
+        )
+    })
+}
+
+/// Delete a data source from a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; dataSourceCode must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteDataSource(
+    handle: *mut SzConfigTool_handle,
+    data_source_code: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(data_source_code, "data_source_code") }?;
+        Ok(config.delete_data_source(code)?)
+    })
+}
+
+/// Update a data source in a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; code and updatesJson must be valid C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleSetDataSource(
+    handle: *mut SzConfigTool_handle,
+    code: *const c_char,
+    updates_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(code, "code") }?;
+        let updates = unsafe { arg_json(updates_json, "updates_json") }?;
+        Ok(config.set_data_source(set_data_source_params(code, &updates))?)
+    })
+}
+
+// ===== Handle: Attributes =====
+
+/// Add an attribute to a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; string parameters must be valid C strings
+/// (defaultValue, internal and required may be null)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddAttribute(
+    handle: *mut SzConfigTool_handle,
+    attribute_code: *const c_char,
+    feature_code: *const c_char,
+    element_code: *const c_char,
+    attr_class: *const c_char,
+    default_value: *const c_char,
+    internal: *const c_char,
+    required: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let params = crate::attributes::AddAttributeParams {
+            attribute: unsafe { arg_str(attribute_code, "attribute_code") }?,
+            feature: unsafe { arg_str(feature_code, "feature_code") }?,
+            element: unsafe { arg_str(element_code, "element_code") }?,
+            class: unsafe { arg_str(attr_class, "attr_class") }?,
+            default_value: unsafe { arg_opt_str(default_value, "default_value") }?,
+            internal: unsafe { arg_opt_str(internal, "internal") }?,
+            required: unsafe { arg_opt_str(required, "required") }?,
+        };
+        config.add_attribute(params)?;
+        Ok(())
+    })
+}
+
+/// Delete an attribute from a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; attributeCode must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteAttribute(
+    handle: *mut SzConfigTool_handle,
+    attribute_code: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(attribute_code, "attribute_code") }?;
+        Ok(config.delete_attribute(code)?)
+    })
+}
+
+/// Update an attribute in a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; attributeCode and updatesJson must be valid C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleSetAttribute(
+    handle: *mut SzConfigTool_handle,
+    attribute_code: *const c_char,
+    updates_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(attribute_code, "attribute_code") }?;
+        let updates = unsafe { arg_json(updates_json, "updates_json") }?;
+        Ok(config.set_attribute(set_attribute_params(code, &updates))?)
+    })
+}
+
+// ===== Handle: Features and Elements =====
+
+/// Add a feature to a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; featureCode and featureJson must be valid C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddFeature(
+    handle: *mut SzConfigTool_handle,
+    feature_code: *const c_char,
+    feature_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(feature_code, "feature_code") }?;
+        let feature_config = unsafe { arg_json(feature_json, "feature_json") }?;
+        let params = add_feature_params(code, &feature_config).map_err(|e| HandleError(e, -3))?;
+        Ok(config.add_feature(params)?)
+    })
+}
+
+/// Delete a feature (by code or ID) from a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; featureCodeOrId must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteFeature(
+    handle: *mut SzConfigTool_handle,
+    feature_code_or_id: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(feature_code_or_id, "feature_code_or_id") }?;
+        Ok(config.delete_feature(code)?)
+    })
+}
+
+/// Update a feature (by code or ID) in a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; featureCodeOrId and updatesJson must be valid C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleSetFeature(
+    handle: *mut SzConfigTool_handle,
+    feature_code_or_id: *const c_char,
+    updates_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(feature_code_or_id, "feature_code_or_id") }?;
+        let updates = unsafe { arg_json(updates_json, "updates_json") }?;
+        Ok(config.set_feature(set_feature_params(code, &updates))?)
+    })
+}
+
+/// Add an element to a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; elementCode and elementJson must be valid C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddElement(
+    handle: *mut SzConfigTool_handle,
+    element_code: *const c_char,
+    element_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(element_code, "element_code") }?;
+        let element_config = unsafe { arg_json(element_json, "element_json") }?;
+        Ok(config.add_element(add_element_params(code, &element_config))?)
+    })
+}
+
+/// Delete an element from a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; elementCode must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteElement(
+    handle: *mut SzConfigTool_handle,
+    element_code: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(element_code, "element_code") }?;
+        Ok(config.delete_element(code)?)
+    })
+}
+
+/// Update an element in a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; elementCode and updatesJson must be valid C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleSetElement(
+    handle: *mut SzConfigTool_handle,
+    element_code: *const c_char,
+    updates_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(element_code, "element_code") }?;
+        let updates = unsafe { arg_json(updates_json, "updates_json") }?;
+        Ok(config.set_element(set_element_params(code, &updates))?)
+    })
+}
+
+/// Add a behavior override to a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; string parameters must be valid C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddBehaviorOverride(
+    handle: *mut SzConfigTool_handle,
+    feature_code: *const c_char,
+    usage_type: *const c_char,
+    behavior: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let feature = unsafe { arg_str(feature_code, "feature_code") }?;
+        let utype = unsafe { arg_str(usage_type, "usage_type") }?;
+        let bhvr = unsafe { arg_str(behavior, "behavior") }?;
+        Ok(config.add_behavior_override(
+            crate::behavior_overrides::AddBehaviorOverrideParams::new(feature, utype, bhvr),
+        )?)
+    })
+}
+
+/// Delete a behavior override from a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; string parameters must be valid C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteBehaviorOverride(
+    handle: *mut SzConfigTool_handle,
+    feature_code: *const c_char,
+    usage_type: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let feature = unsafe { arg_str(feature_code, "feature_code") }?;
+        let utype = unsafe { arg_str(usage_type, "usage_type") }?;
+        Ok(config.delete_behavior_override(feature, utype)?)
+    })
+}
+
+// ===== Handle: Fragments, Rules and Generic Plans =====
+
+/// Add a fragment to a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; fragmentJson must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddFragment(
+    handle: *mut SzConfigTool_handle,
+    fragment_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let fragment = unsafe { arg_json(fragment_json, "fragment_json") }?;
+        config.add_fragment(&fragment)?;
+        Ok(())
+    })
+}
+
+/// Delete a fragment from a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; fragmentCode must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteFragment(
+    handle: *mut SzConfigTool_handle,
+    fragment_code: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(fragment_code, "fragment_code") }?;
+        Ok(config.delete_fragment(code)?)
+    })
+}
+
+/// Update a fragment in a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; fragmentCode and updatesJson must be valid C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleSetFragmentWithJson(
+    handle: *mut SzConfigTool_handle,
+    fragment_code: *const c_char,
+    updates_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(fragment_code, "fragment_code") }?;
+        let updates = unsafe { arg_json(updates_json, "updates_json") }?;
+        Ok(config.set_fragment(code, &updates)?)
+    })
+}
+
+/// Add a rule to a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; ruleJson must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddRule(
+    handle: *mut SzConfigTool_handle,
+    rule_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let rule = unsafe { arg_json(rule_json, "rule_json") }?;
+        config.add_rule(&rule)?;
+        Ok(())
+    })
+}
+
+/// Delete a rule from a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; ruleCode must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteRule(
+    handle: *mut SzConfigTool_handle,
+    rule_code: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(rule_code, "rule_code") }?;
+        Ok(config.delete_rule(code)?)
+    })
+}
+
+/// Update a rule in a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; ruleCode and ruleJson must be valid C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleSetRule(
+    handle: *mut SzConfigTool_handle,
+    rule_code: *const c_char,
+    rule_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(rule_code, "rule_code") }?;
+        let rule = unsafe { arg_json(rule_json, "rule_json") }?;
+        Ok(config.set_rule(set_rule_params(code, &rule))?)
+    })
+}
+
+/// Clone a generic plan within a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; string parameters must be valid C strings
+/// (newGplanDesc may be null)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleCloneGenericPlan(
+    handle: *mut SzConfigTool_handle,
+    source_gplan_code: *const c_char,
+    new_gplan_code: *const c_char,
+    new_gplan_desc: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let source = unsafe { arg_str(source_gplan_code, "source_gplan_code") }?;
+        let new_code = unsafe { arg_str(new_gplan_code, "new_gplan_code") }?;
+        let new_desc = unsafe { arg_opt_str(new_gplan_desc, "new_gplan_desc") }?;
+        config.clone_generic_plan(source, new_code, new_desc)?;
+        Ok(())
+    })
+}
+
+/// Clone a generic plan and apply threshold overrides to the copy in one call
+///
+/// thresholdsJson is a JSON array of objects with "behavior" and the optional
+/// "feature" (default "ALL"), "candidateCap", "scoringCap" and "sendToRedo".
+/// Each override updates the cloned row with the same behavior and feature,
+/// or adds a row (all three values required) if there is none. Every override
+/// is checked first, so on error nothing changes.
+///
+/// # Safety
+/// configJson, sourceGplanCode, newGplanCode and thresholdsJson must be valid
+/// C strings; newGplanDesc may be null
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_buildGenericPlan(
+    config_json: *const c_char,
+    source_gplan_code: *const c_char,
+    new_gplan_code: *const c_char,
+    new_gplan_desc: *const c_char,
+    thresholds_json: *const c_char,
+) -> SzConfigTool_result {
+    let result = unsafe { arg_str(config_json, "config_json") }.and_then(|json| {
+        let source = unsafe { arg_str(source_gplan_code, "source_gplan_code") }?;
+        let new_code = unsafe { arg_str(new_gplan_code, "new_gplan_code") }?;
+        let new_desc = unsafe { arg_opt_str(new_gplan_desc, "new_gplan_desc") }?;
+        let thresholds = unsafe { arg_json(thresholds_json, "thresholds_json") }?;
+        let overrides = arg_params(&thresholds, "thresholds_json")?;
+        let (json, _gplan_id) =
+            crate::generic_plans::build_generic_plan(json, source, new_code, new_desc, &overrides)?;
+        Ok(json)
+    });
+
+    match result {
+        Ok(json) => handle_result!(Ok::<String, SzConfigError>(json)),
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            SzConfigTool_result {
+                response: std::ptr::null_mut(),
+                returnCode: code,
+            }
+        }
+    }
+}
+
+/// Clone a generic plan with threshold overrides within a handle
+/// (see SzConfigTool_buildGenericPlan)
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; string parameters must be valid C strings
+/// (newGplanDesc may be null)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleBuildGenericPlan(
+    handle: *mut SzConfigTool_handle,
+    source_gplan_code: *const c_char,
+    new_gplan_code: *const c_char,
+    new_gplan_desc: *const c_char,
+    thresholds_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let source = unsafe { arg_str(source_gplan_code, "source_gplan_code") }?;
+        let new_code = unsafe { arg_str(new_gplan_code, "new_gplan_code") }?;
+        let new_desc = unsafe { arg_opt_str(new_gplan_desc, "new_gplan_desc") }?;
+        let thresholds = unsafe { arg_json(thresholds_json, "thresholds_json") }?;
+        let overrides = arg_params(&thresholds, "thresholds_json")?;
+        config.build_generic_plan(source, new_code, new_desc, &overrides)?;
+        Ok(())
+    })
+}
+
+/// Set (add or update) a generic plan on a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; gplanCode and gplanDesc must be valid C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleSetGenericPlan(
+    handle: *mut SzConfigTool_handle,
+    gplan_code: *const c_char,
+    gplan_desc: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(gplan_code, "gplan_code") }?;
+        let desc = unsafe { arg_str(gplan_desc, "gplan_desc") }?;
+        config.set_generic_plan(code, desc)?;
+        Ok(())
+    })
+}
+
+// ===== Handle: Hashes, System Parameters and Versions =====
+
+/// Add a name to the SSN_LAST4 hash in a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; name must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddToSsnLast4Hash(
+    handle: *mut SzConfigTool_handle,
+    name: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let name = unsafe { arg_str(name, "name") }?;
+        Ok(config.add_to_ssn_last4_hash(name)?)
+    })
+}
+
+/// Delete a name from the SSN_LAST4 hash in a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; name must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteFromSsnLast4Hash(
+    handle: *mut SzConfigTool_handle,
+    name: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let name = unsafe { arg_str(name, "name") }?;
+        Ok(config.delete_from_ssn_last4_hash(name)?)
+    })
+}
+
+/// Set a system parameter in a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; parameterName and parameterValueJson must be
+/// valid C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleSetSystemParameterWithJson(
+    handle: *mut SzConfigTool_handle,
+    parameter_name: *const c_char,
+    parameter_value_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let name = unsafe { arg_str(parameter_name, "parameter_name") }?;
+        let value = unsafe { arg_json(parameter_value_json, "parameter_value_json") }?;
+        Ok(config.set_system_parameter(name, &value)?)
+    })
+}
+
+/// Update the compatibility version in a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; newVersion must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleUpdateCompatibilityVersion(
+    handle: *mut SzConfigTool_handle,
+    new_version: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let version = unsafe { arg_str(new_version, "new_version") }?;
+        Ok(config.update_compatibility_version(version)?)
+    })
+}
+
+/// Update the feature version in a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; version must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleUpdateFeatureVersion(
+    handle: *mut SzConfigTool_handle,
+    version: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let version = unsafe { arg_str(version, "version") }?;
+        Ok(config.update_feature_version(version)?)
+    })
+}
+
+// ===== Handle: Config Sections =====
+
+/// Add an empty config section to a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; sectionName must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddConfigSection(
+    handle: *mut SzConfigTool_handle,
+    section_name: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let section = unsafe { arg_str(section_name, "section_name") }?;
+        Ok(config.add_config_section(section)?)
+    })
+}
+
+/// Remove a config section from a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; sectionName must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleRemoveConfigSection(
+    handle: *mut SzConfigTool_handle,
+    section_name: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let section = unsafe { arg_str(section_name, "section_name") }?;
+        Ok(config.remove_config_section(section)?)
+    })
+}
+
+/// Add a field to every record of a config section in a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; string parameters must be valid C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddConfigSectionField(
+    handle: *mut SzConfigTool_handle,
+    section_name: *const c_char,
+    field_name: *const c_char,
+    field_value_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let section = unsafe { arg_str(section_name, "section_name") }?;
+        let field = unsafe { arg_str(field_name, "field_name") }?;
+        let value = unsafe { arg_json(field_value_json, "field_value_json") }?;
+        config.add_config_section_field(section, field, &value)?;
+        Ok(())
+    })
+}
+
+/// Remove a field from every record of a config section in a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; string parameters must be valid C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleRemoveConfigSectionField(
+    handle: *mut SzConfigTool_handle,
+    section_name: *const c_char,
+    field_name: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let section = unsafe { arg_str(section_name, "section_name") }?;
+        let field = unsafe { arg_str(field_name, "field_name") }?;
+        config.remove_config_section_field(section, field)?;
+        Ok(())
+    })
+}
+
+// ===== Handle: Functions =====
+
+/// Add a standardize function to a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; sfuncCode and connectStr must be valid C strings
+/// (sfuncDesc and language may be null)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddStandardizeFunction(
+    handle: *mut SzConfigTool_handle,
+    sfunc_code: *const c_char,
+    connect_str: *const c_char,
+    sfunc_desc: *const c_char,
+    language: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(sfunc_code, "sfunc_code") }?;
+        let params = crate::functions::standardize::AddStandardizeFunctionParams {
+            connect_str: unsafe { arg_str(connect_str, "connect_str") }?,
+            description: unsafe { arg_opt_str(sfunc_desc, "sfunc_desc") }?,
+            language: unsafe { arg_opt_str(language, "language") }?,
+        };
+        config.add_standardize_function(code, params)?;
+        Ok(())
+    })
+}
+
+/// Delete a standardize function from a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; sfuncCode must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteStandardizeFunction(
+    handle: *mut SzConfigTool_handle,
+    sfunc_code: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(sfunc_code, "sfunc_code") }?;
+        config.delete_standardize_function(code)?;
+        Ok(())
+    })
+}
+
+/// Set (update) a standardize function on a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; sfuncCode must be a valid C string
+/// (other parameters may be null or empty to leave the field unchanged)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleSetStandardizeFunction(
+    handle: *mut SzConfigTool_handle,
+    sfunc_code: *const c_char,
+    connect_str: *const c_char,
+    sfunc_desc: *const c_char,
+    language: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(sfunc_code, "sfunc_code") }?;
+        let params = crate::functions::standardize::SetStandardizeFunctionParams {
+            connect_str: unsafe { arg_opt_field(connect_str, "connect_str") }?,
+            description: unsafe { arg_opt_field(sfunc_desc, "sfunc_desc") }?,
+            language: unsafe { arg_opt_field(language, "language") }?,
+        };
+        config.set_standardize_function(code, params)?;
+        Ok(())
+    })
+}
+
+/// Add an expression function to a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; efuncCode and connectStr must be valid C strings
+/// (efuncDesc and language may be null)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddExpressionFunction(
+    handle: *mut SzConfigTool_handle,
+    efunc_code: *const c_char,
+    connect_str: *const c_char,
+    efunc_desc: *const c_char,
+    language: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(efunc_code, "efunc_code") }?;
+        let params = crate::functions::expression::AddExpressionFunctionParams {
+            connect_str: unsafe { arg_str(connect_str, "connect_str") }?,
+            description: unsafe { arg_opt_str(efunc_desc, "efunc_desc") }?,
+            language: unsafe { arg_opt_str(language, "language") }?,
+        };
+        config.add_expression_function(code, params)?;
+        Ok(())
+    })
+}
+
+/// Delete an expression function from a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; efuncCode must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteExpressionFunction(
+    handle: *mut SzConfigTool_handle,
+    efunc_code: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(efunc_code, "efunc_code") }?;
+        config.delete_expression_function(code)?;
+        Ok(())
+    })
+}
+
+/// Set (update) an expression function on a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; efuncCode must be a valid C string
+/// (other parameters may be null or empty to leave the field unchanged)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleSetExpressionFunction(
+    handle: *mut SzConfigTool_handle,
+    efunc_code: *const c_char,
+    connect_str: *const c_char,
+    efunc_desc: *const c_char,
+    language: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(efunc_code, "efunc_code") }?;
+        let params = crate::functions::expression::SetExpressionFunctionParams {
+            connect_str: unsafe { arg_opt_field(connect_str, "connect_str") }?,
+            description: unsafe { arg_opt_field(efunc_desc, "efunc_desc") }?,
+            language: unsafe { arg_opt_field(language, "language") }?,
+        };
+        config.set_expression_function(code, params)?;
+        Ok(())
+    })
+}
+
+/// Add a comparison function to a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; cfuncCode and connectStr must be valid C strings
+/// (cfuncDesc, language and anonSupport may be null)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddComparisonFunction(
+    handle: *mut SzConfigTool_handle,
+    cfunc_code: *const c_char,
+    connect_str: *const c_char,
+    cfunc_desc: *const c_char,
+    language: *const c_char,
+    anon_support: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(cfunc_code, "cfunc_code") }?;
+        let params = crate::functions::comparison::AddComparisonFunctionParams {
+            connect_str: unsafe { arg_str(connect_str, "connect_str") }?,
+            description: unsafe { arg_opt_str(cfunc_desc, "cfunc_desc") }?,
+            language: unsafe { arg_opt_str(language, "language") }?,
+            anon_support: unsafe { arg_opt_str(anon_support, "anon_support") }?,
+        };
+        config.add_comparison_function(code, params)?;
+        Ok(())
+    })
+}
+
+/// Delete a comparison function from a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; cfuncCode must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteComparisonFunction(
+    handle: *mut SzConfigTool_handle,
+    cfunc_code: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(cfunc_code, "cfunc_code") }?;
+        config.delete_comparison_function(code)?;
+        Ok(())
+    })
+}
+
+/// Set (update) a comparison function on a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; cfuncCode must be a valid C string
+/// (other parameters may be null or empty to leave the field unchanged)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleSetComparisonFunction(
+    handle: *mut SzConfigTool_handle,
+    cfunc_code: *const c_char,
+    connect_str: *const c_char,
+    cfunc_desc: *const c_char,
+    language: *const c_char,
+    anon_support: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(cfunc_code, "cfunc_code") }?;
+        let params = crate::functions::comparison::SetComparisonFunctionParams {
+            connect_str: unsafe { arg_opt_field(connect_str, "connect_str") }?,
+            description: unsafe { arg_opt_field(cfunc_desc, "cfunc_desc") }?,
+            language: unsafe { arg_opt_field(language, "language") }?,
+            anon_support: unsafe { arg_opt_field(anon_support, "anon_support") }?,
+        };
+        config.set_comparison_function(code, params)?;
+        Ok(())
+    })
+}
+
+/// Add a distinct function to a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; dfuncCode and connectStr must be valid C strings
+/// (dfuncDesc and language may be null)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddDistinctFunction(
+    handle: *mut SzConfigTool_handle,
+    dfunc_code: *const c_char,
+    connect_str: *const c_char,
+    dfunc_desc: *const c_char,
+    language: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(dfunc_code, "dfunc_code") }?;
+        let params = crate::functions::distinct::AddDistinctFunctionParams {
+            connect_str: unsafe { arg_str(connect_str, "connect_str") }?,
+            description: unsafe { arg_opt_str(dfunc_desc, "dfunc_desc") }?,
+            language: unsafe { arg_opt_str(language, "language") }?,
+        };
+        config.add_distinct_function(code, params)?;
+        Ok(())
+    })
+}
+
+/// Delete a distinct function from a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; dfuncCode must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteDistinctFunction(
+    handle: *mut SzConfigTool_handle,
+    dfunc_code: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(dfunc_code, "dfunc_code") }?;
+        config.delete_distinct_function(code)?;
+        Ok(())
+    })
+}
+
+/// Set (update) a distinct function on a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; dfuncCode must be a valid C string
+/// (other parameters may be null or empty to leave the field unchanged)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleSetDistinctFunction(
+    handle: *mut SzConfigTool_handle,
+    dfunc_code: *const c_char,
+    connect_str: *const c_char,
+    dfunc_desc: *const c_char,
+    language: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let code = unsafe { arg_str(dfunc_code, "dfunc_code") }?;
+        let params = crate::functions::distinct::SetDistinctFunctionParams {
+            connect_str: unsafe { arg_opt_field(connect_str, "connect_str") }?,
+            description: unsafe { arg_opt_field(dfunc_desc, "dfunc_desc") }?,
+            language: unsafe { arg_opt_field(language, "language") }?,
+        };
+        config.set_distinct_function(code, params)?;
+        Ok(())
+    })
+}
+
+// ===== Handle: Calls =====
+
+/// Add a standardize call to a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; sfuncCode must be a valid C string
+/// (ftypeCode and felemCode may be null; negative execOrder = next available)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddStandardizeCall(
+    handle: *mut SzConfigTool_handle,
+    ftype_code: *const c_char,
+    felem_code: *const c_char,
+    exec_order: i64,
+    sfunc_code: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let params = crate::calls::standardize::AddStandardizeCallParams {
+            ftype_code: unsafe { arg_opt_str(ftype_code, "ftype_code") }?,
+            felem_code: unsafe { arg_opt_str(felem_code, "felem_code") }?,
+            exec_order: arg_opt_i64(exec_order),
+            sfunc_code: unsafe { arg_str(sfunc_code, "sfunc_code") }?,
+        };
+        config.add_standardize_call(params)?;
+        Ok(())
+    })
+}
+
+/// Delete a standardize call from a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteStandardizeCall(
+    handle: *mut SzConfigTool_handle,
+    sfcall_id: i64,
+) -> i64 {
+    with_handle(handle, |config| {
+        Ok(config.delete_standardize_call(sfcall_id)?)
+    })
+}
+
+/// Read a JSON array of expression call elements
+///
+/// Each item is `["element", "required", "feature"]` (feature optional) or
+/// `{"element": ..., "required": ..., "feature": ...}`; required defaults to "Yes".
+unsafe fn arg_expression_element_list(
+    ptr: *const c_char,
+    name: &str,
+) -> Result<Vec<(String, String, Option<String>)>, HandleError> {
+    let value = unsafe { arg_json(ptr, name) }?;
+    let items = value
+        .as_array()
+        .ok_or_else(|| HandleError(format!("{} must be a JSON array", name), -3))?;
+    let field = |item: &serde_json::Value, i: usize, key: &str| {
+        item.get(i)
+            .or_else(|| item.get(key))
+            .and_then(|v| v.as_str())
+            .map(|s| s.to_string())
+    };
+    Ok(items
+        .iter()
+        .filter(|item| item.is_object() || item.as_array().is_some_and(|a| a.len() >= 2))
+        .map(|item| {
+            (
+                field(item, 0, "element").unwrap_or_default(),
+                field(item, 1, "required").unwrap_or_else(|| "Yes".to_string()),
+                field(item, 2, "feature"),
+            )
+        })
+        .collect())
+}
+
+/// Add an expression call to a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; efuncCode, elementListJson and isVirtual must be
+/// valid C strings (ftypeCode, felemCode and expressionFeature may be null; negative
+/// execOrder = next available)
+#[unsafe(no_mangle)]
+#[allow(clippy::too_many_arguments)]
+pub unsafe extern "C" fn SzConfigTool_handleAddExpressionCall(
+    handle: *mut SzConfigTool_handle,
+    ftype_code: *const c_char,
+    felem_code: *const c_char,
+    exec_order: i64,
+    efunc_code: *const c_char,
+    element_list_json: *const c_char,
+    expression_feature: *const c_char,
+    is_virtual: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let params = crate::calls::expression::AddExpressionCallParams {
+            efunc_code: unsafe { arg_str(efunc_code, "efunc_code") }?,
+            element_list: unsafe {
+                arg_expression_element_list(element_list_json, "element_list_json")
+            }?,
+            ftype_code: unsafe { arg_opt_str(ftype_code, "ftype_code") }?,
+            felem_code: unsafe { arg_opt_str(felem_code, "felem_code") }?,
+            exec_order: arg_opt_i64(exec_order),
+            expression_feature: unsafe { arg_opt_str(expression_feature, "expression_feature") }?,
+            is_virtual: unsafe { arg_str(is_virtual, "is_virtual") }?,
+        };
+        config.add_expression_call(params)?;
+        Ok(())
+    })
+}
+
+/// Delete an expression call (and its EFBOM records) from a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteExpressionCall(
+    handle: *mut SzConfigTool_handle,
+    efcall_id: i64,
+) -> i64 {
+    with_handle(handle, |config| {
+        Ok(config.delete_expression_call(efcall_id)?)
+    })
+}
+
+/// Read a JSON array of element codes
+unsafe fn arg_element_list(ptr: *const c_char, name: &str) -> Result<Vec<String>, HandleError> {
+    let value = unsafe { arg_json(ptr, name) }?;
+    value
+        .as_array()
+        .map(|arr| {
+            arr.iter()
+                .filter_map(|v| v.as_str())
+                .map(|s| s.to_string())
+                .collect()
+        })
+        .ok_or_else(|| HandleError(format!("{} must be a JSON array", name), -3))
+}
+
+/// Add a comparison call to a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; string parameters must be valid C strings
+/// (elementListJson is a JSON array of element codes)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddComparisonCall(
+    handle: *mut SzConfigTool_handle,
+    ftype_code: *const c_char,
+    cfunc_code: *const c_char,
+    element_list_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let params = crate::calls::comparison::AddComparisonCallParams {
+            ftype_code: unsafe { arg_str(ftype_code, "ftype_code") }?.to_string(),
+            cfunc_code: unsafe { arg_str(cfunc_code, "cfunc_code") }?.to_string(),
+            element_list: unsafe { arg_element_list(element_list_json, "element_list_json") }?,
+        };
+        config.add_comparison_call(params)?;
+        Ok(())
+    })
+}
+
+/// Delete a comparison call (and its CFBOM records) from a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteComparisonCall(
+    handle: *mut SzConfigTool_handle,
+    cfcall_id: i64,
+) -> i64 {
+    with_handle(handle, |config| {
+        Ok(config.delete_comparison_call(cfcall_id)?)
+    })
+}
+
+/// Add a distinct call to a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; string parameters must be valid C strings
+/// (elementListJson is a JSON array of element codes)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddDistinctCall(
+    handle: *mut SzConfigTool_handle,
+    ftype_code: *const c_char,
+    dfunc_code: *const c_char,
+    element_list_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let params = crate::calls::distinct::AddDistinctCallParams {
+            ftype_code: unsafe { arg_str(ftype_code, "ftype_code") }?.to_string(),
+            dfunc_code: unsafe { arg_str(dfunc_code, "dfunc_code") }?.to_string(),
+            element_list: unsafe { arg_element_list(element_list_json, "element_list_json") }?,
+        };
+        config.add_distinct_call(params)?;
+        Ok(())
+    })
+}
+
+/// Delete a distinct call (and its DFBOM records) from a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteDistinctCall(
+    handle: *mut SzConfigTool_handle,
+    dfcall_id: i64,
+) -> i64 {
+    with_handle(handle, |config| Ok(config.delete_distinct_call(dfcall_id)?))
+}
+
+// ===== Handle: Thresholds =====
+
+/// Add a comparison threshold to a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; cfuncRtnval must be a valid C string
+/// (negative integer parameters = not specified)
+#[unsafe(no_mangle)]
+#[allow(clippy::too_many_arguments)]
+pub unsafe extern "C" fn SzConfigTool_handleAddComparisonThreshold(
+    handle: *mut SzConfigTool_handle,
+    cfunc_id: i64,
+    cfunc_rtnval: *const c_char,
+    ftype_id: i64,
+    exec_order: i64,
+    same_score: i64,
+    close_score: i64,
+    likely_score: i64,
+    plausible_score: i64,
+    un_likely_score: i64,
+) -> i64 {
+    with_handle(handle, |config| {
+        let rtnval = unsafe { arg_str(cfunc_rtnval, "cfunc_rtnval") }?;
+        Ok(config.add_comparison_threshold_by_id(
+            cfunc_id,
+            arg_opt_i64(ftype_id),
+            rtnval,
+            arg_opt_i64(exec_order),
+            arg_opt_i64(same_score),
+            arg_opt_i64(close_score),
+            arg_opt_i64(likely_score),
+            arg_opt_i64(plausible_score),
+            arg_opt_i64(un_likely_score),
+        )?)
+    })
+}
+
+/// Delete a comparison threshold (by CFRTN_ID) from a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteComparisonThreshold(
+    handle: *mut SzConfigTool_handle,
+    cfrtn_id: i64,
+) -> i64 {
+    with_handle(handle, |config| {
+        Ok(config.delete_comparison_threshold_by_id(cfrtn_id)?)
+    })
+}
+
+/// Set (update) a comparison threshold (by CFRTN_ID) on a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; updatesJson must be a valid C string
+/// (keys sameScore, closeScore, likelyScore, plausibleScore, unlikelyScore)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleSetComparisonThreshold(
+    handle: *mut SzConfigTool_handle,
+    cfrtn_id: i64,
+    updates_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let updates = unsafe { arg_json(updates_json, "updates_json") }?;
+        let score = |key: &str| updates.get(key).and_then(|v| v.as_i64());
+        Ok(config.set_comparison_threshold_by_id(
+            cfrtn_id,
+            score("sameScore"),
+            score("closeScore"),
+            score("likelyScore"),
+            score("plausibleScore"),
+            score("unlikelyScore"),
+        )?)
+    })
+}
+
+/// Add a generic threshold to a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; string parameters must be valid C strings
+/// (feature may be null for "ALL")
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddGenericThreshold(
+    handle: *mut SzConfigTool_handle,
+    plan: *const c_char,
+    behavior: *const c_char,
+    scoring_cap: i64,
+    candidate_cap: i64,
+    send_to_redo: *const c_char,
+    feature: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let params = crate::thresholds::AddGenericThresholdParams {
+            plan: Some(unsafe { arg_str(plan, "plan") }?),
+            behavior: Some(unsafe { arg_str(behavior, "behavior") }?),
+            scoring_cap: Some(scoring_cap),
+            candidate_cap: Some(candidate_cap),
+            send_to_redo: Some(unsafe { arg_str(send_to_redo, "send_to_redo") }?),
+            feature: unsafe { arg_opt_str(feature, "feature") }?,
+        };
+        Ok(config.add_generic_threshold(params)?)
+    })
+}
+
+/// Delete a generic threshold from a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; plan and behavior must be valid C strings
+/// (feature may be null for "ALL")
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteGenericThreshold(
+    handle: *mut SzConfigTool_handle,
+    plan: *const c_char,
+    behavior: *const c_char,
+    feature: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let params = crate::thresholds::DeleteGenericThresholdParams {
+            plan: Some(unsafe { arg_str(plan, "plan") }?),
+            behavior: Some(unsafe { arg_str(behavior, "behavior") }?),
+            feature: unsafe { arg_opt_str(feature, "feature") }?,
+        };
+        Ok(config.delete_generic_threshold(params)?)
+    })
+}
+
+/// Set (update) a generic threshold on a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; behavior and updatesJson must be valid C strings
+/// (keys feature, candidateCap, scoringCap, sendToRedo)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleSetGenericThreshold(
+    handle: *mut SzConfigTool_handle,
+    gplan_id: i64,
+    behavior: *const c_char,
+    updates_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let behavior = unsafe { arg_str(behavior, "behavior") }?;
+        let updates = unsafe { arg_json(updates_json, "updates_json") }?;
+        let plan = config.lookup_gplan_code(gplan_id)?;
+        let params = crate::thresholds::SetGenericThresholdParams {
+            plan: Some(&plan),
+            behavior: Some(behavior),
+            feature: updates.get("feature").and_then(|v| v.as_str()),
+            candidate_cap: updates.get("candidateCap").and_then(|v| v.as_i64()),
+            scoring_cap: updates.get("scoringCap").and_then(|v| v.as_i64()),
+            send_to_redo: updates.get("sendToRedo").and_then(|v| v.as_str()),
+        };
+        Ok(config.set_generic_threshold(params)?)
+    })
+}
+
+// ============================================================================
+// Batch Command Functions
+// ============================================================================
+
+/// Read a length-delimited UTF-8 buffer (need not be null-terminated)
+unsafe fn arg_buf<'a>(ptr: *const c_char, len: usize, name: &str) -> Result<&'a str, HandleError> {
+    if len == 0 {
+        return Ok("");
+    }
+    if ptr.is_null() {
+        return Err(HandleError(format!("{} is null", name), -1));
+    }
+    let bytes = unsafe { std::slice::from_raw_parts(ptr as *const u8, len) };
+    std::str::from_utf8(bytes)
+        .map_err(|e| HandleError(format!("Invalid UTF-8 in {}: {}", name, e), -2))
+}
+
+/// Apply a buffer of command-script lines to a configuration in one call
+///
+/// The configuration is parsed once, every line is run against the parsed
+/// document (same commands and format as CommandProcessor / .gtc files) and
+/// the result is serialized once.
+///
+/// # Returns
+/// SzConfigTool_result with the modified configuration JSON. If a line fails,
+/// returnCode is -2, no configuration is returned and the error message starts
+/// with "Line N:" naming the failing line.
+///
+/// # Safety
+/// configJson must be a valid null-terminated C string; commands must point to
+/// at least len bytes of UTF-8 (may be null when len is 0)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_applyCommands(
+    config_json: *const c_char,
+    commands: *const c_char,
+    len: usize,
+) -> SzConfigTool_result {
+    let result = unsafe { arg_str(config_json, "config_json") }.and_then(|json| {
+        let script = unsafe { arg_buf(commands, len, "commands") }?;
+        // Sections no line touches are copied from the input
+        Ok(crate::handle::edit(json, |config| {
+            crate::command_processor::apply_commands(config, script).map(|_| ())
+        })?)
+    });
+
+    match result {
+        Ok(json) => handle_result!(Ok::<String, SzConfigError>(json)),
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            SzConfigTool_result {
+                response: std::ptr::null_mut(),
+                returnCode: code,
+            }
+        }
+    }
+}
+
+/// Apply a buffer of command-script lines to a handle
+///
+/// On failure the message starts with "Line N:"; commands before the failing
+/// line remain applied to the handle.
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; commands must point to at least
+/// len bytes of UTF-8 (may be null when len is 0)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleApplyCommands(
+    handle: *mut SzConfigTool_handle,
+    commands: *const c_char,
+    len: usize,
+) -> i64 {
+    with_handle(handle, |config| {
+        let script = unsafe { arg_buf(commands, len, "commands") }?;
+        crate::command_processor::apply_commands(config, script)?;
+        Ok(())
+    })
+}
+
+/// Apply a buffer of command-script lines with per-command profiling
+///
+/// Runs the lines like SzConfigTool_applyCommands and reports the wall time,
+/// bytes parsed and serialized, and config sections touched of each line.
+///
+/// # Returns
+/// SzConfigTool_result with a JSON report:
+/// {"config": "...", "error": null, "profile": {"totalMicros", "compileMicros",
+///  "scriptBytes", "finishMicros", "finishBytesSerialized",
+///  "commands": [{"line", "command", "micros", "bytesParsed",
+///                "bytesSerialized", "sections", "error"}, ...]}}
+/// If a line fails, "config" is null, "error" holds the "Line N:" message and
+/// the profile covers the lines run up to and including the failing one.
+/// returnCode is 0 unless an argument is invalid.
+///
+/// # Safety
+/// configJson must be a valid null-terminated C string; commands must point to
+/// at least len bytes of UTF-8 (may be null when len is 0)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_profileCommands(
+    config_json: *const c_char,
+    commands: *const c_char,
+    len: usize,
+) -> SzConfigTool_result {
+    let result = unsafe { arg_str(config_json, "config_json") }.and_then(|json| {
+        let script = unsafe { arg_buf(commands, len, "commands") }?;
+        let mut processor =
+            crate::command_processor::CommandProcessor::new(json.to_string()).profile(true);
+        let outcome = processor.process_script(script);
+        let profile = processor
+            .profile_report()
+            .map(|report| report.to_json())
+            .unwrap_or_default();
+
+        let report = match outcome {
+            Ok(config) => serde_json::json!({"config": config, "error": null, "profile": profile}),
+            Err(e) => {
+                serde_json::json!({"config": null, "error": e.to_string(), "profile": profile})
+            }
+        };
+        Ok(report.to_string())
+    });
+
+    match result {
+        Ok(json) => handle_result!(Ok::<String, SzConfigError>(json)),
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            SzConfigTool_result {
+                response: std::ptr::null_mut(),
+                returnCode: code,
+            }
+        }
+    }
+}
+
+/// Apply one command script to many configuration files in parallel
+///
+/// # Arguments
+/// * `script` - Command script content (.gtc format), parsed once
+/// * `jobsJson` - JSON array of {"input": path, "output": path} objects
+/// * `threads` - Worker threads (0 or negative = available parallelism)
+///
+/// # Returns
+/// SzConfigTool_result with a JSON report:
+/// {"summary": "...", "succeeded": n, "failed": n,
+///  "results": [{"input", "output", "commandsExecuted", "error"}, ...]}
+/// in job order. returnCode is 0 even if individual jobs failed.
+///
+/// # Safety
+/// script and jobsJson must be valid null-terminated C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_upgradeFiles(
+    script: *const c_char,
+    jobs_json: *const c_char,
+    threads: i64,
+) -> SzConfigTool_result {
+    let result = unsafe { arg_str(script, "script") }.and_then(|script| {
+        let jobs_value = unsafe { arg_json(jobs_json, "jobs_json") }?;
+        let jobs = jobs_value
+            .as_array()
+            .ok_or_else(|| HandleError("jobs_json must be a JSON array".to_string(), -3))?
+            .iter()
+            .map(
+                |job| match (job["input"].as_str(), job["output"].as_str()) {
+                    (Some(input), Some(output)) => Ok((input.into(), output.into())),
+                    _ => Err(HandleError(
+                        "Each job needs string 'input' and 'output' paths".to_string(),
+                        -3,
+                    )),
+                },
+            )
+            .collect::<Result<Vec<(std::path::PathBuf, std::path::PathBuf)>, HandleError>>()?;
+
+        let upgrader = crate::batch_upgrade::BatchUpgrader::new(script)?
+            .threads(usize::try_from(threads).unwrap_or(0));
+        let report = upgrader.upgrade_files(&jobs);
+
+        let results: Vec<serde_json::Value> = jobs
+            .iter()
+            .zip(&report.outcomes)
+            .map(|((input, output), outcome)| {
+                serde_json::json!({
+                    "input": input.to_string_lossy(),
+                    "output": output.to_string_lossy(),
+                    "commandsExecuted": outcome.commands_executed,
+                    "error": outcome.error.as_ref().map(|e| e.to_string()),
+                })
+            })
+            .collect();
+
+        Ok(serde_json::json!({
+            "summary": report.summary(),
+            "succeeded": report.succeeded(),
+            "failed": report.failed(),
+            "results": results,
+        })
+        .to_string())
+    });
+
+    match result {
+        Ok(json) => handle_result!(Ok::<String, SzConfigError>(json)),
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            SzConfigTool_result {
+                response: std::ptr::null_mut(),
+                returnCode: code,
+            }
+        }
+    }
+}
+
+/// Delete several features (codes or IDs) and their dependent records
+///
+/// featuresJson is a JSON array of feature codes or IDs. Every feature is
+/// validated first, so on error the configuration is not returned modified.
+///
+/// # Safety
+/// configJson and featuresJson must be valid null-terminated C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_deleteFeatures(
+    config_json: *const c_char,
+    features_json: *const c_char,
+) -> SzConfigTool_result {
+    let result = unsafe { arg_str(config_json, "config_json") }.and_then(|json| {
+        let features = unsafe { arg_element_list(features_json, "features_json") }?;
+        let features: Vec<&str> = features.iter().map(String::as_str).collect();
+        Ok(crate::features::delete_features(json, &features)?)
+    });
+
+    match result {
+        Ok(json) => handle_result!(Ok::<String, SzConfigError>(json)),
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            SzConfigTool_result {
+                response: std::ptr::null_mut(),
+                returnCode: code,
+            }
+        }
+    }
+}
+
+/// Delete several features (codes or IDs) from a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; featuresJson must be a valid C string
+/// (a JSON array of feature codes or IDs)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteFeatures(
+    handle: *mut SzConfigTool_handle,
+    features_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let features = unsafe { arg_element_list(features_json, "features_json") }?;
+        let features: Vec<&str> = features.iter().map(String::as_str).collect();
+        Ok(config.delete_features(&features)?)
+    })
+}
+
+/// Convert each entry of a JSON array argument to a parameter struct
+fn arg_params<'a, P>(value: &'a serde_json::Value, name: &str) -> Result<Vec<P>, HandleError>
+where
+    P: TryFrom<&'a serde_json::Value, Error = SzConfigError>,
+{
+    value
+        .as_array()
+        .ok_or_else(|| HandleError(format!("{} must be a JSON array", name), -3))?
+        .iter()
+        .enumerate()
+        .map(|(i, item)| {
+            P::try_from(item).map_err(|e| HandleError(format!("{}[{}]: {}", name, i, e), -3))
+        })
+        .collect()
+}
+
+/// Add several data sources in one call
+///
+/// dataSourcesJson is a JSON array of objects with "code" and the optional
+/// "retentionLevel", "conversational" and "reliability". Every entry is
+/// checked first, so on error nothing is added.
+///
+/// # Safety
+/// configJson and dataSourcesJson must be valid null-terminated C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_addDataSources(
+    config_json: *const c_char,
+    data_sources_json: *const c_char,
+) -> SzConfigTool_result {
+    let result = unsafe { arg_str(config_json, "config_json") }.and_then(|json| {
+        let data_sources = unsafe { arg_json(data_sources_json, "data_sources_json") }?;
+        let params = arg_params(&data_sources, "data_sources_json")?;
+        Ok(crate::datasources::add_data_sources(json, &params)?)
+    });
+
+    match result {
+        Ok(json) => handle_result!(Ok::<String, SzConfigError>(json)),
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            SzConfigTool_result {
+                response: std::ptr::null_mut(),
+                returnCode: code,
+            }
+        }
+    }
+}
+
+/// Add several data sources to a handle (see SzConfigTool_addDataSources)
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; dataSourcesJson must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddDataSources(
+    handle: *mut SzConfigTool_handle,
+    data_sources_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let data_sources = unsafe { arg_json(data_sources_json, "data_sources_json") }?;
+        let params = arg_params(&data_sources, "data_sources_json")?;
+        Ok(config.add_data_sources(&params)?)
+    })
+}
+
+/// Add several attributes in one call
+///
+/// attributesJson is a JSON array of objects with "attribute", "feature",
+/// "element" and "class" and the optional "default", "internal" and
+/// "required". Every entry is checked first, so on error nothing is added.
+///
+/// # Safety
+/// configJson and attributesJson must be valid null-terminated C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_addAttributes(
+    config_json: *const c_char,
+    attributes_json: *const c_char,
+) -> SzConfigTool_result {
+    let result = unsafe { arg_str(config_json, "config_json") }.and_then(|json| {
+        let attributes = unsafe { arg_json(attributes_json, "attributes_json") }?;
+        let params = arg_params(&attributes, "attributes_json")?;
+        Ok(crate::attributes::add_attributes(json, &params)?.0)
+    });
+
+    match result {
+        Ok(json) => handle_result!(Ok::<String, SzConfigError>(json)),
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            SzConfigTool_result {
+                response: std::ptr::null_mut(),
+                returnCode: code,
+            }
+        }
+    }
+}
+
+/// Add several attributes to a handle (see SzConfigTool_addAttributes)
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; attributesJson must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddAttributes(
+    handle: *mut SzConfigTool_handle,
+    attributes_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let attributes = unsafe { arg_json(attributes_json, "attributes_json") }?;
+        let params = arg_params(&attributes, "attributes_json")?;
+        config.add_attributes(&params)?;
+        Ok(())
+    })
+}
+
+/// Borrow an array of `count` C strings
+///
+/// # Safety
+/// ptr must point to `count` valid C strings (may be null when count is 0)
+unsafe fn arg_str_list<'a>(
+    ptr: *const *const c_char,
+    count: usize,
+    name: &str,
+) -> Result<Vec<&'a str>, HandleError> {
+    if count == 0 {
+        return Ok(Vec::new());
+    }
+    if ptr.is_null() {
+        return Err(HandleError(format!("{} is null", name), -1));
+    }
+    unsafe { std::slice::from_raw_parts(ptr, count) }
+        .iter()
+        .map(|&item| unsafe { arg_str(item, name) })
+        .collect()
+}
+
+/// Add names to the NAME_HASH hash in one call
+///
+/// namesJson is a JSON array of strings. Every entry is checked first,
+/// so on error the configuration is not returned modified.
+///
+/// # Safety
+/// configJson and namesJson must be valid null-terminated C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_addToNameHashMany(
+    config_json: *const c_char,
+    names_json: *const c_char,
+) -> SzConfigTool_result {
+    let result = unsafe { arg_str(config_json, "config_json") }.and_then(|json| {
+        let names = unsafe { arg_element_list(names_json, "names_json") }?;
+        let names: Vec<&str> = names.iter().map(String::as_str).collect();
+        Ok(crate::hashes::add_to_name_hash_many(json, &names)?)
+    });
+
+    match result {
+        Ok(json) => handle_result!(Ok::<String, SzConfigError>(json)),
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            SzConfigTool_result {
+                response: std::ptr::null_mut(),
+                returnCode: code,
+            }
+        }
+    }
+}
+
+/// Add names to the NAME_HASH hash in a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; names must point to count valid C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddToNameHashMany(
+    handle: *mut SzConfigTool_handle,
+    names: *const *const c_char,
+    count: usize,
+) -> i64 {
+    with_handle(handle, |config| {
+        let names = unsafe { arg_str_list(names, count, "names") }?;
+        Ok(config.add_to_name_hash_many(&names)?)
+    })
+}
+
+/// Delete names from the NAME_HASH hash in one call
+///
+/// namesJson is a JSON array of strings. Every entry is checked first,
+/// so on error the configuration is not returned modified.
+///
+/// # Safety
+/// configJson and namesJson must be valid null-terminated C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_deleteFromNameHashMany(
+    config_json: *const c_char,
+    names_json: *const c_char,
+) -> SzConfigTool_result {
+    let result = unsafe { arg_str(config_json, "config_json") }.and_then(|json| {
+        let names = unsafe { arg_element_list(names_json, "names_json") }?;
+        let names: Vec<&str> = names.iter().map(String::as_str).collect();
+        Ok(crate::hashes::delete_from_name_hash_many(json, &names)?)
+    });
+
+    match result {
+        Ok(json) => handle_result!(Ok::<String, SzConfigError>(json)),
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            SzConfigTool_result {
+                response: std::ptr::null_mut(),
+                returnCode: code,
+            }
+        }
+    }
+}
+
+/// Delete names from the NAME_HASH hash in a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; names must point to count valid C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteFromNameHashMany(
+    handle: *mut SzConfigTool_handle,
+    names: *const *const c_char,
+    count: usize,
+) -> i64 {
+    with_handle(handle, |config| {
+        let names = unsafe { arg_str_list(names, count, "names") }?;
+        Ok(config.delete_from_name_hash_many(&names)?)
+    })
+}
+
+/// Add values to the SSN_LAST4_HASH hash in one call
+///
+/// valuesJson is a JSON array of strings. Every entry is checked first,
+/// so on error the configuration is not returned modified.
+///
+/// # Safety
+/// configJson and valuesJson must be valid null-terminated C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_addToSsnLast4HashMany(
+    config_json: *const c_char,
+    values_json: *const c_char,
+) -> SzConfigTool_result {
+    let result = unsafe { arg_str(config_json, "config_json") }.and_then(|json| {
+        let values = unsafe { arg_element_list(values_json, "values_json") }?;
+        let values: Vec<&str> = values.iter().map(String::as_str).collect();
+        Ok(crate::hashes::add_to_ssn_last4_hash_many(json, &values)?)
+    });
+
+    match result {
+        Ok(json) => handle_result!(Ok::<String, SzConfigError>(json)),
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            SzConfigTool_result {
+                response: std::ptr::null_mut(),
+                returnCode: code,
+            }
+        }
+    }
+}
+
+/// Add values to the SSN_LAST4_HASH hash in a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; values must point to count valid C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleAddToSsnLast4HashMany(
+    handle: *mut SzConfigTool_handle,
+    values: *const *const c_char,
+    count: usize,
+) -> i64 {
+    with_handle(handle, |config| {
+        let values = unsafe { arg_str_list(values, count, "values") }?;
+        Ok(config.add_to_ssn_last4_hash_many(&values)?)
+    })
+}
+
+/// Delete values from the SSN_LAST4_HASH hash in one call
+///
+/// valuesJson is a JSON array of strings. Every entry is checked first,
+/// so on error the configuration is not returned modified.
+///
+/// # Safety
+/// configJson and valuesJson must be valid null-terminated C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_deleteFromSsnLast4HashMany(
+    config_json: *const c_char,
+    values_json: *const c_char,
+) -> SzConfigTool_result {
+    let result = unsafe { arg_str(config_json, "config_json") }.and_then(|json| {
+        let values = unsafe { arg_element_list(values_json, "values_json") }?;
+        let values: Vec<&str> = values.iter().map(String::as_str).collect();
+        Ok(crate::hashes::delete_from_ssn_last4_hash_many(
+            json, &values,
+        )?)
+    });
+
+    match result {
+        Ok(json) => handle_result!(Ok::<String, SzConfigError>(json)),
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            SzConfigTool_result {
+                response: std::ptr::null_mut(),
+                returnCode: code,
+            }
+        }
+    }
+}
+
+/// Delete values from the SSN_LAST4_HASH hash in a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; values must point to count valid C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleDeleteFromSsnLast4HashMany(
+    handle: *mut SzConfigTool_handle,
+    values: *const *const c_char,
+    count: usize,
+) -> i64 {
+    with_handle(handle, |config| {
+        let values = unsafe { arg_str_list(values, count, "values") }?;
+        Ok(config.delete_from_ssn_last4_hash_many(&values)?)
+    })
+}
+
+// ===== Borrowed and Caller-Buffer Reads =====
+
+/// Return code when a caller-supplied buffer is too small
+const BUFFER_TOO_SMALL: i64 = -6;
+
+thread_local! {
+    /// Reused output buffer for the string-based `*ToBuffer` reads
+    static SCRATCH: RefCell<Vec<u8>> = const { RefCell::new(Vec::new()) };
+}
+
+/// Serialize `value` as JSON onto the end of `buf`
+fn write_json<T: serde::Serialize + ?Sized>(
+    buf: &mut Vec<u8>,
+    value: &T,
+) -> Result<(), HandleError> {
+    serde_json::to_writer(buf, value)
+        .map_err(|e| HandleError(format!("Failed to serialize result: {}", e), -3))
+}
+
+/// Write the `listFeatures` array one feature at a time
+fn write_features(config: &ConfigHandle, buf: &mut Vec<u8>) -> Result<(), HandleError> {
+    buf.push(b'[');
+    for (i, feature) in config.iter_features()?.enumerate() {
+        if i > 0 {
+            buf.push(b',');
+        }
+        write_json(buf, &feature)?;
+    }
+    buf.push(b']');
+    Ok(())
+}
+
+/// Run a read against a handle and expose its output as a borrowed view
+///
+/// The output is written into the handle's reusable `view` buffer and
+/// null-terminated; `*out` / `*out_len` receive its address and length
+/// (excluding the terminator). Nothing is allocated once the buffer has
+/// grown to the largest response, and the caller frees nothing.
+unsafe fn with_view<F>(
+    handle: *mut SzConfigTool_handle,
+    out: *mut *const c_char,
+    out_len: *mut usize,
+    f: F,
+) -> i64
+where
+    F: FnOnce(&ConfigHandle, &mut Vec<u8>) -> Result<(), HandleError>,
+{
+    let Some(handle) = (unsafe { handle.as_mut() }) else {
+        set_error("handle is null".to_string(), -1);
+        return -1;
+    };
+    if out.is_null() || out_len.is_null() {
+        set_error("out and out_len must not be null".to_string(), -1);
+        return -1;
+    }
+
+    handle.view.clear();
+    match f(&handle.config, &mut handle.view) {
+        Ok(()) => {
+            let len = handle.view.len();
+            handle.view.push(0);
+            unsafe {
+                *out = handle.view.as_ptr() as *const c_char;
+                *out_len = len;
+            }
+            clear_error();
+            0
+        }
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            code
+        }
+    }
+}
+
+/// Run a read and copy its output into a caller-supplied buffer
+///
+/// `*out_len` always receives the output length (excluding the terminator).
+/// If `buf_size` is too small (including 0 with a null `buf`, the size query),
+/// nothing is copied and BUFFER_TOO_SMALL is returned so the caller can retry
+/// with a buffer of at least `*out_len + 1` bytes.
+unsafe fn with_buffer<F>(buf: *mut c_char, buf_size: usize, out_len: *mut usize, f: F) -> i64
+where
+    F: FnOnce(&mut Vec<u8>) -> Result<(), HandleError>,
+{
+    if out_len.is_null() {
+        set_error("out_len is null".to_string(), -1);
+        return -1;
+    }
+
+    SCRATCH.with_borrow_mut(|scratch| {
+        scratch.clear();
+        if let Err(HandleError(msg, code)) = f(scratch) {
+            set_error(msg, code);
+            return code;
+        }
+
+        let len = scratch.len();
+        unsafe { *out_len = len };
+        if buf.is_null() || buf_size <= len {
+            set_error(
+                format!("Buffer too small: {} bytes needed", len + 1),
+                BUFFER_TOO_SMALL,
+            );
+            return BUFFER_TOO_SMALL;
+        }
+
+        unsafe {
+            std::ptr::copy_nonoverlapping(scratch.as_ptr(), buf as *mut u8, len);
+            *buf.add(len) = 0;
+        }
+        clear_error();
+        0
+    })
+}
+
+/// List features of a handle as a borrowed JSON view
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; out and outLen must be valid pointers.
+/// The view is valid until the next call that reads or modifies this handle.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleListFeatures(
+    handle: *mut SzConfigTool_handle,
+    out: *mut *const c_char,
+    out_len: *mut usize,
+) -> i64 {
+    unsafe { with_view(handle, out, out_len, write_features) }
+}
+
+/// Get a configuration section of a handle as a borrowed JSON view
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; sectionName must be a valid C string;
+/// filter may be null; out and outLen must be valid pointers. The view is valid
+/// until the next call that reads or modifies this handle.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleGetConfigSection(
+    handle: *mut SzConfigTool_handle,
+    section_name: *const c_char,
+    filter: *const c_char,
+    out: *mut *const c_char,
+    out_len: *mut usize,
+) -> i64 {
+    unsafe {
+        with_view(handle, out, out_len, |config, buf| {
+            let section = arg_str(section_name, "section_name")?;
+            let filter = arg_opt_str(filter, "filter")?;
+            write_json(buf, &config.get_config_section(section, filter)?)
+        })
+    }
+}
+
+/// Index a field of a handle's section for filtered SzConfigTool_handleGetConfigSection reads
+///
+/// `FIELD=value` filters on an indexed field visit only the matching rows. The
+/// index is kept across reads and dropped when the section is modified.
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; sectionName and field must be valid
+/// C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleIndexField(
+    handle: *mut SzConfigTool_handle,
+    section_name: *const c_char,
+    field: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let section = unsafe { arg_str(section_name, "section_name") }?;
+        let field = unsafe { arg_str(field, "field") }?;
+        config.index_field(section, field)?;
+        Ok(())
+    })
+}
+
+/// List generic thresholds of a handle as a borrowed JSON view
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; out and outLen must be valid pointers.
+/// The view is valid until the next call that reads or modifies this handle.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleListGenericThresholds(
+    handle: *mut SzConfigTool_handle,
+    out: *mut *const c_char,
+    out_len: *mut usize,
+) -> i64 {
+    unsafe {
+        with_view(handle, out, out_len, |config, buf| {
+            write_json(buf, &config.list_generic_thresholds()?)
+        })
+    }
+}
+
+/// List features into a caller-supplied buffer
+///
+/// # Returns
+/// 0 with the null-terminated JSON in buf, or -6 if bufSize is too small
+/// (*outLen then holds the length needed, excluding the terminator)
+///
+/// # Safety
+/// configJson must be a valid C string; buf must point to bufSize writable bytes
+/// (may be null when bufSize is 0); outLen must be a valid pointer
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_listFeaturesToBuffer(
+    config_json: *const c_char,
+    buf: *mut c_char,
+    buf_size: usize,
+    out_len: *mut usize,
+) -> i64 {
+    unsafe {
+        with_buffer(buf, buf_size, out_len, |out| {
+            let config = ConfigHandle::from_json(arg_str(config_json, "config_json")?)?;
+            write_features(&config, out)
+        })
+    }
+}
+
+/// Get a configuration section into a caller-supplied buffer
+///
+/// Return codes as for SzConfigTool_listFeaturesToBuffer.
+///
+/// # Safety
+/// configJson and sectionName must be valid C strings; filter may be null;
+/// buf must point to bufSize writable bytes (may be null when bufSize is 0);
+/// outLen must be a valid pointer
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_getConfigSectionToBuffer(
+    config_json: *const c_char,
+    section_name: *const c_char,
+    filter: *const c_char,
+    buf: *mut c_char,
+    buf_size: usize,
+    out_len: *mut usize,
+) -> i64 {
+    unsafe {
+        with_buffer(buf, buf_size, out_len, |out| {
+            let config_json = arg_str(config_json, "config_json")?;
+            let section = arg_str(section_name, "section_name")?;
+            let filter = arg_opt_str(filter, "filter")?;
+            // Parses only the requested member
+            let items = crate::config_sections::get_config_section(config_json, section, filter)?;
+            write_json(out, &items)
+        })
+    }
+}
+
+/// List generic thresholds into a caller-supplied buffer
+///
+/// Return codes as for SzConfigTool_listFeaturesToBuffer.
+///
+/// # Safety
+/// configJson must be a valid C string; buf must point to bufSize writable bytes
+/// (may be null when bufSize is 0); outLen must be a valid pointer
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_listGenericThresholdsToBuffer(
+    config_json: *const c_char,
+    buf: *mut c_char,
+    buf_size: usize,
+    out_len: *mut usize,
+) -> i64 {
+    unsafe {
+        with_buffer(buf, buf_size, out_len, |out| {
+            let config = ConfigHandle::from_json(arg_str(config_json, "config_json")?)?;
+            write_json(out, &config.list_generic_thresholds()?)
+        })
+    }
+}
+
+// ===== JSON Patch =====
+
+/// Apply a JSON Patch (RFC 6902) to a configuration
+///
+/// The patch is applied atomically: if any operation fails none are applied.
+///
+/// # Safety
+/// configJson and patchJson must be valid null-terminated C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_applyPatch(
+    config_json: *const c_char,
+    patch_json: *const c_char,
+) -> SzConfigTool_result {
+    let result = unsafe { arg_str(config_json, "config_json") }.and_then(|json| {
+        let patch = unsafe { arg_json(patch_json, "patch_json") }?;
+        Ok(crate::patch::apply_patch(json, &patch)?)
+    });
+
+    match result {
+        Ok(json) => handle_result!(Ok::<String, SzConfigError>(json)),
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            SzConfigTool_result {
+                response: std::ptr::null_mut(),
+                returnCode: code,
+            }
+        }
+    }
+}
+
+/// Compute the JSON Patch (RFC 6902) that turns one configuration into another
+///
+/// # Safety
+/// beforeJson and afterJson must be valid null-terminated C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_diffAsPatch(
+    before_json: *const c_char,
+    after_json: *const c_char,
+) -> SzConfigTool_result {
+    let result = unsafe { arg_str(before_json, "before_json") }.and_then(|before| {
+        let after = unsafe { arg_str(after_json, "after_json") }?;
+        Ok(crate::patch::diff_json(before, after)?)
+    });
+
+    match result {
+        Ok(json) => handle_result!(Ok::<String, SzConfigError>(json)),
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            SzConfigTool_result {
+                response: std::ptr::null_mut(),
+                returnCode: code,
+            }
+        }
+    }
+}
+
+/// Apply a JSON Patch (RFC 6902) to a handle
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; patchJson must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleApplyPatch(
+    handle: *mut SzConfigTool_handle,
+    patch_json: *const c_char,
+) -> i64 {
+    with_handle(handle, |config| {
+        let patch = unsafe { arg_json(patch_json, "patch_json") }?;
+        config.apply_patch(&patch)?;
+        Ok(())
+    })
+}
+
+/// Apply a buffer of command-script lines to a handle and return their JSON Patch
+///
+/// # Returns
+/// SzConfigTool_result with the JSON Patch of the changes. On a failing line
+/// returnCode is -2, the message starts with "Line N:" and the handle is left
+/// unchanged.
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; commands must point to at least
+/// len bytes of UTF-8 (may be null when len is 0)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleApplyCommandsAsPatch(
+    handle: *mut SzConfigTool_handle,
+    commands: *const c_char,
+    len: usize,
+) -> SzConfigTool_result {
+    let mut patch = serde_json::Value::Null;
+    let code = with_handle(handle, |config| {
+        let script = unsafe { arg_buf(commands, len, "commands") }?;
+        patch = config
+            .edit_as_patch(|c| crate::command_processor::apply_commands(c, script).map(|_| ()))?;
+        Ok(())
+    });
+
+    if code != 0 {
+        return SzConfigTool_result {
+            response: std::ptr::null_mut(),
+            returnCode: code,
+        };
+    }
+    handle_result!(Ok::<String, SzConfigError>(patch.to_string()))
+}
+
+// ===== Config Diff =====
+
+/// Structural diff between two configurations, joined on each section's key
+///
+/// # Returns
+/// SzConfigTool_result with a JSON report:
+/// {"summary": {"sections", "added", "removed", "changed"},
+///  "sections": [{"section", "key", "added", "removed", "changed"}, ...]}
+/// (see `diff::ConfigDiff::to_json`)
+///
+/// # Safety
+/// configA and configB must be valid null-terminated C strings
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_diffConfigs(
+    config_a: *const c_char,
+    config_b: *const c_char,
+) -> SzConfigTool_result {
+    let result = unsafe { arg_str(config_a, "config_a") }.and_then(|a| {
+        let b = unsafe { arg_str(config_b, "config_b") }?;
+        Ok(crate::diff::diff_configs(a, b)?)
+    });
+
+    match result {
+        Ok(json) => handle_result!(Ok::<String, SzConfigError>(json)),
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            SzConfigTool_result {
+                response: std::ptr::null_mut(),
+                returnCode: code,
+            }
+        }
+    }
+}
+
+/// Open a snapshot of a handle to roll back to later
+///
+/// O(1); each config section is copied when it is first changed afterwards.
+///
+/// # Returns
+/// Snapshot ID (positive) to pass to SzConfigTool_handleRollback or
+/// SzConfigTool_handleRelease, or a negative error code
+///
+/// # Safety
+/// handle must come from SzConfigTool_open
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleSnapshot(handle: *mut SzConfigTool_handle) -> i64 {
+    let mut id = 0;
+    let code = with_handle(handle, |config| {
+        id = config.snapshot().id() as i64;
+        Ok(())
+    });
+    if code != 0 { code } else { id }
+}
+
+/// Restore a handle to a snapshot, ending it and any snapshot taken after it
+///
+/// # Safety
+/// handle must come from SzConfigTool_open
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleRollback(
+    handle: *mut SzConfigTool_handle,
+    snapshot: i64,
+) -> i64 {
+    with_handle(handle, |config| {
+        config.rollback(crate::snapshot::Snapshot::from_id(snapshot.max(0) as u64))?;
+        Ok(())
+    })
+}
+
+/// End a snapshot (and any taken after it), keeping the changes
+///
+/// # Safety
+/// handle must come from SzConfigTool_open
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleRelease(
+    handle: *mut SzConfigTool_handle,
+    snapshot: i64,
+) -> i64 {
+    with_handle(handle, |config| {
+        config.release(crate::snapshot::Snapshot::from_id(snapshot.max(0) as u64))?;
+        Ok(())
+    })
+}
+
+/// Apply a buffer of command-script lines to a handle, all or nothing
+///
+/// On failure the message starts with "Line N:" and the handle is unchanged.
+///
+/// # Safety
+/// handle must come from SzConfigTool_open; commands must point to at least
+/// len bytes of UTF-8 (may be null when len is 0)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleApplyCommandsAtomic(
+    handle: *mut SzConfigTool_handle,
+    commands: *const c_char,
+    len: usize,
+) -> i64 {
+    with_handle(handle, |config| {
+        let script = unsafe { arg_buf(commands, len, "commands") }?;
+        crate::command_processor::CompiledScript::compile(script)?.apply_atomic(config)?;
+        Ok(())
+    })
+}
+
+/// Check the referential integrity of a configuration
+///
+/// Every cross-table reference (CFG_FBOM.FTYPE_ID, CFG_ATTR.FTYPE_CODE,
+/// CFG_CFCALL.CFUNC_ID, ...) must resolve and no section may hold two rows with
+/// the same key. Large configurations are checked in parallel.
+///
+/// # Returns
+/// SzConfigTool_result with a JSON report:
+/// {"valid", "rowsChecked", "summary": {"duplicate", "danglingReference",
+///  "missingSection"}, "findings": [{"kind", "section", "row", "fields",
+///  "value", "target", "message"}, ...]}
+///
+/// # Safety
+/// configJson must be a valid null-terminated C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_validateConfig(
+    config_json: *const c_char,
+) -> SzConfigTool_result {
+    let result = unsafe { arg_str(config_json, "config_json") }
+        .and_then(|json| Ok(crate::validate::validate_config(json)?));
+
+    match result {
+        Ok(json) => handle_result!(Ok::<String, SzConfigError>(json)),
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            SzConfigTool_result {
+                response: std::ptr::null_mut(),
+                returnCode: code,
+            }
+        }
+    }
+}
+
+/// Check the referential integrity of a handle's configuration
+///
+/// # Returns
+/// SzConfigTool_result with the report of SzConfigTool_validateConfig
+///
+/// # Safety
+/// handle must come from SzConfigTool_open
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleValidateConfig(
+    handle: *mut SzConfigTool_handle,
+) -> SzConfigTool_result {
+    let mut report = String::new();
+    let code = with_handle(handle, |config| {
+        report = config.validate_config()?.to_json().to_string();
+        Ok(())
+    });
+
+    if code != 0 {
+        return SzConfigTool_result {
+            response: std::ptr::null_mut(),
+            returnCode: code,
+        };
+    }
+    handle_result!(Ok::<String, SzConfigError>(report))
+}
+
+/// Fingerprint a configuration's content
+///
+/// Formatting (whitespace, string escapes) does not change the fingerprint.
+/// Each G2_CONFIG member is fingerprinted too, so two results show which
+/// sections differ.
+///
+/// # Returns
+/// SzConfigTool_result with JSON {"fingerprint": "<32 hex digits>",
+/// "sections": {"<member>": "<32 hex digits>", ...}}
+///
+/// # Safety
+/// configJson must be a valid null-terminated C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_configFingerprint(
+    config_json: *const c_char,
+) -> SzConfigTool_result {
+    let result = unsafe { arg_str(config_json, "config_json") }
+        .and_then(|json| Ok(crate::fingerprint::config_fingerprint(json)?));
+
+    match result {
+        Ok(json) => handle_result!(Ok::<String, SzConfigError>(json)),
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            SzConfigTool_result {
+                response: std::ptr::null_mut(),
+                returnCode: code,
+            }
+        }
+    }
+}
+
+/// Fingerprint a handle's configuration
+///
+/// # Returns
+/// SzConfigTool_result with the JSON of SzConfigTool_configFingerprint
+///
+/// # Safety
+/// handle must come from SzConfigTool_open
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_handleConfigFingerprint(
+    handle: *mut SzConfigTool_handle,
+) -> SzConfigTool_result {
+    let mut fingerprint = String::new();
+    let code = with_handle(handle, |config| {
+        fingerprint = config.config_fingerprint().to_json().to_string();
+        Ok(())
+    });
+
+    if code != 0 {
+        return SzConfigTool_result {
+            response: std::ptr::null_mut(),
+            returnCode: code,
+        };
+    }
+    handle_result!(Ok::<String, SzConfigError>(fingerprint))
+}
+
+// ============================================================================
+// Shared Configurations
+// ============================================================================
+
+/// Opaque configuration shared between threads, created by `SzConfigTool_sharedOpen`
+#[allow(non_camel_case_types)] // Match C convention from SzHelpers
+pub struct SzConfigTool_shared {
+    config: SharedConfig,
+}
+
+thread_local! {
+    /// This thread's readers, one per shared configuration it has read
+    static SHARED_READERS: RefCell<Vec<SharedReader>> = const { RefCell::new(Vec::new()) };
+}
+
+/// Run a read against the calling thread's current version of a shared configuration
+///
+/// The first read of a shared configuration on a thread registers a reader
+/// for it; later reads only check the shared generation counter.
+fn with_shared_read<T, F>(shared: *const SzConfigTool_shared, f: F) -> Result<T, HandleError>
+where
+    F: FnOnce(&ConfigHandle) -> Result<T, HandleError>,
+{
+    let Some(shared) = (unsafe { shared.as_ref() }) else {
+        return Err(HandleError("shared is null".to_string(), -1));
+    };
+
+    SHARED_READERS.with_borrow_mut(|readers| {
+        let slot = match readers.iter().position(|r| r.reads(&shared.config)) {
+            Some(slot) => slot,
+            None => {
+                // Drop readers of closed configurations before adding one
+                readers.retain(|r| !r.is_detached());
+                readers.push(shared.config.reader());
+                readers.len() - 1
+            }
+        };
+        f(readers[slot].get())
+    })
+}
+
+/// Serialize `value` as a JSON string
+fn json_string<T: serde::Serialize + ?Sized>(value: &T) -> Result<String, HandleError> {
+    serde_json::to_string(value)
+        .map_err(|e| HandleError(format!("Failed to serialize result: {}", e), -3))
+}
+
+/// Convert the outcome of a shared read into an SzConfigTool_result
+fn shared_result(result: Result<String, HandleError>) -> SzConfigTool_result {
+    match result {
+        Ok(json) => handle_result!(Ok::<String, SzConfigError>(json)),
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            SzConfigTool_result {
+                response: std::ptr::null_mut(),
+                returnCode: code,
+            }
+        }
+    }
+}
+
+/// Parse a configuration into a new shared configuration
+///
+/// # Returns
+/// Shared configuration to pass to the SzConfigTool_shared* functions from any
+/// number of threads (release with SzConfigTool_sharedClose), or null on error
+///
+/// # Safety
+/// configJson must be a valid null-terminated C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_sharedOpen(
+    config_json: *const c_char,
+) -> *mut SzConfigTool_shared {
+    let result = unsafe { arg_str(config_json, "config_json") }
+        .and_then(|json| Ok(SharedConfig::from_json(json)?));
+
+    match result {
+        Ok(config) => {
+            clear_error();
+            Box::into_raw(Box::new(SzConfigTool_shared { config }))
+        }
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            std::ptr::null_mut()
+        }
+    }
+}
+
+/// Release a shared configuration created by SzConfigTool_sharedOpen
+///
+/// No other thread may use it during or after this call.
+///
+/// # Safety
+/// shared must have been returned by SzConfigTool_sharedOpen and not already
+/// closed, or be null
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_sharedClose(shared: *mut SzConfigTool_shared) {
+    if !shared.is_null() {
+        unsafe {
+            drop(Box::from_raw(shared));
+        }
+        SHARED_READERS.with_borrow_mut(|readers| readers.retain(|r| !r.is_detached()));
+    }
+}
+
+/// Get a feature from the current version of a shared configuration
+///
+/// # Safety
+/// shared must come from SzConfigTool_sharedOpen; featureCode must be a valid C string
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_sharedGetFeature(
+    shared: *const SzConfigTool_shared,
+    feature_code: *const c_char,
+) -> SzConfigTool_result {
+    shared_result(with_shared_read(shared, |config| {
+        let code = unsafe { arg_str(feature_code, "feature_code") }?;
+        json_string(&config.get_feature(code)?)
+    }))
+}
+
+/// List the attributes of the current version of a shared configuration
+///
+/// # Safety
+/// shared must come from SzConfigTool_sharedOpen
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_sharedListAttributes(
+    shared: *const SzConfigTool_shared,
+) -> SzConfigTool_result {
+    shared_result(with_shared_read(shared, |config| {
+        json_string(&config.list_attributes()?)
+    }))
+}
+
+/// List the comparison thresholds of the current version of a shared configuration
+///
+/// # Safety
+/// shared must come from SzConfigTool_sharedOpen
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_sharedListComparisonThresholds(
+    shared: *const SzConfigTool_shared,
+) -> SzConfigTool_result {
+    shared_result(with_shared_read(shared, |config| {
+        json_string(&config.list_comparison_thresholds()?)
+    }))
+}
+
+/// Serialize the current version of a shared configuration
+///
+/// # Safety
+/// shared must come from SzConfigTool_sharedOpen
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_sharedSerialize(
+    shared: *const SzConfigTool_shared,
+) -> SzConfigTool_result {
+    shared_result(with_shared_read(shared, |config| Ok(config.to_json()?)))
+}
+
+/// Generation of a shared configuration (number of versions published, 0 initially)
+///
+/// # Returns
+/// The generation, or -1 if shared is null
+///
+/// # Safety
+/// shared must come from SzConfigTool_sharedOpen
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_sharedGeneration(shared: *const SzConfigTool_shared) -> i64 {
+    match unsafe { shared.as_ref() } {
+        Some(shared) => {
+            clear_error();
+            shared.config.generation() as i64
+        }
+        None => {
+            set_error("shared is null".to_string(), -1);
+            -1
+        }
+    }
+}
+
+/// Apply command-script lines to a copy of a shared configuration and publish it
+///
+/// Readers keep seeing the previous version until the whole script has been
+/// applied. On a failing line SzConfigTool_getLastError() starts with
+/// "Line N:" and nothing is published.
+///
+/// # Safety
+/// shared must come from SzConfigTool_sharedOpen; commands must point to at
+/// least len bytes of UTF-8 (may be null when len is 0)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_sharedApplyCommands(
+    shared: *const SzConfigTool_shared,
+    commands: *const c_char,
+    len: usize,
+) -> i64 {
+    let result = unsafe { shared.as_ref() }
+        .ok_or_else(|| HandleError("shared is null".to_string(), -1))
+        .and_then(|shared| {
+            let script = unsafe { arg_buf(commands, len, "commands") }?;
+            shared
+                .config
+                .update(|config| crate::command_processor::apply_commands(config, script))?;
+            Ok(())
+        });
+
+    match result {
+        Ok(()) => {
+            clear_error();
+            0
+        }
+        Err(HandleError(msg, code)) => {
+            set_error(msg, code);
+            code
+        }
+    }
+}
+
+/// Publish a copy of a handle's configuration as the new version of a shared configuration
+///
+/// # Safety
+/// shared must come from SzConfigTool_sharedOpen; handle must come from SzConfigTool_open
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn SzConfigTool_sharedPublish(
+    shared: *const SzConfigTool_shared,
+    handle: *const SzConfigTool_handle,
+) -> i64 {
+    let (Some(shared), Some(handle)) = (unsafe { shared.as_ref() }, unsafe { handle.as_ref() })
+    else {
+        set_error("shared or handle is null".to_string(), -1);
+        return -1;
+    };
+    shared.config.publish(handle.config.clone());
+    clear_error();
+    0
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::ffi::CString;
+
+    fn take_response(result: SzConfigTool_result) -> String {
+        assert_eq!(result.returnCode, 0);
+        let json = unsafe { CStr::from_ptr(result.response) }
+            .to_str()
+            .unwrap()
+            .to_string();
+        unsafe { SzConfigTool_free(result.response) };
+        json
+    }
+
+    #[test]
+    fn test_handle_edits_and_serialize() {
+        let config = CString::new(r#"{"G2_CONFIG":{"CFG_DSRC":[]}}"#).unwrap();
+        let handle = unsafe { SzConfigTool_open(config.as_ptr()) };
+        assert!(!handle.is_null());
+
+        for code in ["CUSTOMERS", "WATCHLIST"] {
+            let code = CString::new(code).unwrap();
+            assert_eq!(
+                unsafe { SzConfigTool_handleAddDataSource(handle, code.as_ptr()) },
+                0
+            );
+        }
+
+        // A failed edit reports the error and leaves the handle usable
+        let dup = CString::new("CUSTOMERS").unwrap();
+        assert_eq!(
+            unsafe { SzConfigTool_handleAddDataSource(handle, dup.as_ptr()) },
+            -2
+        );
+        assert_eq!(SzConfigTool_getLastErrorCode(), -2);
+        let msg = unsafe { CStr::from_ptr(SzConfigTool_getLastError()) };
+        assert!(msg.to_str().unwrap().contains("CUSTOMERS"));
+
+        let json = take_response(unsafe { SzConfigTool_serialize(handle) });
+        assert!(json.contains("CUSTOMERS"));
+        assert!(json.contains("WATCHLIST"));
+
+        unsafe { SzConfigTool_close(handle) };
+    }
+
+    #[test]
+    fn test_open_cached_serializes_like_open() {
+        let config =
+            CString::new(r#"{"G2_CONFIG":{"CFG_DSRC":[],"CFG_FTYPE":[{"FTYPE_ID":1}]}}"#).unwrap();
+        let code = CString::new("CUSTOMERS").unwrap();
+        let mut outputs = Vec::new();
+        for open in [SzConfigTool_open, SzConfigTool_openCached] {
+            let handle = unsafe { open(config.as_ptr()) };
+            assert!(!handle.is_null());
+            assert_eq!(
+                unsafe { SzConfigTool_handleAddDataSource(handle, code.as_ptr()) },
+                0
+            );
+            outputs.push(take_response(unsafe { SzConfigTool_serialize(handle) }));
+            unsafe { SzConfigTool_close(handle) };
+        }
+        assert_eq!(outputs[0], outputs[1]);
+        assert!(unsafe { SzConfigTool_openCached(std::ptr::null()) }.is_null());
+    }
+
+    #[test]
+    fn test_handle_set_mutators_match_string_api() {
+        let config = r#"{"G2_CONFIG":{
+            "CFG_FTYPE":[{"FTYPE_ID":1,"FTYPE_CODE":"NAME"}],
+            "CFG_FELEM":[{"FELEM_ID":2,"FELEM_CODE":"FULL_NAME"}],
+            "CFG_FBOM":[{"FTYPE_ID":1,"FELEM_ID":2,"FELEM_CODE":"FULL_NAME","EXEC_ORDER":1}],
+            "CFG_SFUNC":[{"SFUNC_ID":1,"SFUNC_CODE":"PARSE_NAME","SFUNC_DESC":"Parse","CONNECT_STR":"g2ParseName","LANGUAGE":null}],
+            "CFG_EFUNC":[{"EFUNC_ID":1,"EFUNC_CODE":"EXPR","EFUNC_DESC":"Expr","CONNECT_STR":"g2Expr","LANGUAGE":null}],
+            "CFG_EFCALL":[],"CFG_EFBOM":[],
+            "CFG_GPLAN":[{"GPLAN_ID":1,"GPLAN_CODE":"INGEST","GPLAN_DESC":"Ingest"}],
+            "CFG_GENERIC_THRESHOLD":[{"GPLAN_ID":1,"BEHAVIOR":"NAME","FTYPE_ID":0,"CANDIDATE_CAP":10,"SCORING_CAP":20,"SEND_TO_REDO":"YES"}],
+            "CFG_CFRTN":[{"CFRTN_ID":1,"CFUNC_ID":1,"FTYPE_ID":0,"CFUNC_RTNVAL":"FULL_SCORE","EXEC_ORDER":1,"SAME_SCORE":100,"CLOSE_SCORE":90,"LIKELY_SCORE":80,"PLAUSIBLE_SCORE":70,"UN_LIKELY_SCORE":60}]
+        }}"#;
+        let c = |s: &str| CString::new(s).unwrap();
+        let handle = unsafe { SzConfigTool_open(c(config).as_ptr()) };
+
+        let mut expected = config.to_string();
+        let step = |string_api: SzConfigTool_result, handle_rc: i64| {
+            assert_eq!(handle_rc, 0, "{:?}", unsafe {
+                CStr::from_ptr(SzConfigTool_getLastError())
+            });
+            take_response(string_api)
+        };
+
+        let (code, desc) = (c("SEARCH"), c("Search"));
+        expected = step(
+            unsafe {
+                SzConfigTool_setGenericPlan(c(&expected).as_ptr(), code.as_ptr(), desc.as_ptr())
+            },
+            unsafe { SzConfigTool_handleSetGenericPlan(handle, code.as_ptr(), desc.as_ptr()) },
+        );
+
+        let (sfunc, desc, empty) = (c("PARSE_NAME"), c("Parse names"), c(""));
+        expected = step(
+            SzConfigTool_setStandardizeFunction(
+                c(&expected).as_ptr(),
+                sfunc.as_ptr(),
+                empty.as_ptr(),
+                desc.as_ptr(),
+                std::ptr::null(),
+            ),
+            unsafe {
+                SzConfigTool_handleSetStandardizeFunction(
+                    handle,
+                    sfunc.as_ptr(),
+                    empty.as_ptr(),
+                    desc.as_ptr(),
+                    std::ptr::null(),
+                )
+            },
+        );
+
+        let updates = c(r#"{"sameScore": 99, "unlikelyScore": 50}"#);
+        expected = step(
+            SzConfigTool_setComparisonThreshold(c(&expected).as_ptr(), 1, updates.as_ptr()),
+            unsafe { SzConfigTool_handleSetComparisonThreshold(handle, 1, updates.as_ptr()) },
+        );
+
+        let (behavior, updates) = (c("NAME"), c(r#"{"candidateCap": 11, "sendToRedo": "NO"}"#));
+        expected = step(
+            SzConfigTool_setGenericThreshold(
+                c(&expected).as_ptr(),
+                1,
+                behavior.as_ptr(),
+                updates.as_ptr(),
+            ),
+            unsafe {
+                SzConfigTool_handleSetGenericThreshold(
+                    handle,
+                    1,
+                    behavior.as_ptr(),
+                    updates.as_ptr(),
+                )
+            },
+        );
+
+        let (ftype, efunc, elements, virt) = (
+            c("NAME"),
+            c("EXPR"),
+            c(r#"[["FULL_NAME", "Yes", "NAME"], {"element": "FULL_NAME", "required": "No"}]"#),
+            c("No"),
+        );
+        expected = step(
+            SzConfigTool_addExpressionCall(
+                c(&expected).as_ptr(),
+                ftype.as_ptr(),
+                std::ptr::null(),
+                -1,
+                efunc.as_ptr(),
+                elements.as_ptr(),
+                std::ptr::null(),
+                virt.as_ptr(),
+            ),
+            unsafe {
+                SzConfigTool_handleAddExpressionCall(
+                    handle,
+                    ftype.as_ptr(),
+                    std::ptr::null(),
+                    -1,
+                    efunc.as_ptr(),
+                    elements.as_ptr(),
+                    std::ptr::null(),
+                    virt.as_ptr(),
+                )
+            },
+        );
+
+        let serialized = take_response(unsafe { SzConfigTool_serialize(handle) });
+        let parsed = |s: &str| serde_json::from_str::<serde_json::Value>(s).unwrap();
+        assert_eq!(parsed(&serialized), parsed(&expected));
+        assert!(serialized.contains("Parse names") && serialized.contains(r#""SAME_SCORE":99"#));
+
+        // Unknown plan ID is reported like any other edit failure
+        let rc = unsafe {
+            SzConfigTool_handleSetGenericThreshold(handle, 99, behavior.as_ptr(), updates.as_ptr())
+        };
+        assert!(rc < 0);
+        unsafe { SzConfigTool_close(handle) };
+    }
+
+    #[test]
+    fn test_handle_argument_errors() {
+        let bad = CString::new("{not json").unwrap();
+        assert!(unsafe { SzConfigTool_open(bad.as_ptr()) }.is_null());
+
+        let code = CString::new("TEST").unwrap();
+        assert_eq!(
+            unsafe { SzConfigTool_handleAddDataSource(std::ptr::null_mut(), code.as_ptr()) },
+            -1
+        );
+
+        let config = CString::new(r#"{"G2_CONFIG":{"CFG_DSRC":[]}}"#).unwrap();
+        let handle = unsafe { SzConfigTool_open(config.as_ptr()) };
+        assert_eq!(
+            unsafe { SzConfigTool_handleSetDataSource(handle, code.as_ptr(), bad.as_ptr()) },
+            -3
+        );
+        unsafe { SzConfigTool_close(handle) };
+    }
+
+    #[test]
+    fn test_apply_commands_reports_failed_line() {
+        let config = CString::new(r#"{"G2_CONFIG":{"CFG_DSRC":[]}}"#).unwrap();
+        let script = "# comment\naddConfigSection {\"section\": \"CFG_TEST\"}\nbogus {}\n";
+
+        let result = unsafe {
+            SzConfigTool_applyCommands(
+                config.as_ptr(),
+                script.as_ptr() as *const c_char,
+                script.len(),
+            )
+        };
+        assert_eq!(result.returnCode, -2);
+        assert!(result.response.is_null());
+
+        // Only the first two lines
+        let len = script.find("bogus").unwrap();
+        let json = take_response(unsafe {
+            SzConfigTool_applyCommands(config.as_ptr(), script.as_ptr() as *const c_char, len)
+        });
+        assert!(json.contains("CFG_TEST"));
+    }
+
+    #[test]
+    fn test_profile_commands() {
+        let config = CString::new(r#"{"G2_CONFIG":{"CFG_DSRC":[]}}"#).unwrap();
+        let script = "addConfigSection {\"section\": \"CFG_TEST\"}\nsave\nbogus {}\n";
+
+        let report = take_response(unsafe {
+            SzConfigTool_profileCommands(
+                config.as_ptr(),
+                script.as_ptr() as *const c_char,
+                script.len(),
+            )
+        });
+        let report: serde_json::Value = serde_json::from_str(&report).unwrap();
+        assert!(report["config"].is_null());
+        assert!(report["error"].as_str().unwrap().contains("Line 3"));
+
+        let len = script.find("bogus").unwrap();
+        let report = take_response(unsafe {
+            SzConfigTool_profileCommands(config.as_ptr(), script.as_ptr() as *const c_char, len)
+        });
+        let report: serde_json::Value = serde_json::from_str(&report).unwrap();
+        assert!(report["config"].as_str().unwrap().contains("CFG_TEST"));
+        let commands = report["profile"]["commands"].as_array().unwrap();
+        assert_eq!(commands.len(), 2);
+        assert_eq!(commands[0]["command"], "addConfigSection");
+        assert_eq!(commands[0]["sections"], serde_json::json!(["CFG_TEST"]));
+    }
+
+    #[test]
+    fn test_patch_round_trip() {
+        let live = r#"{"G2_CONFIG":{"CFG_DSRC":[{"DSRC_ID":1,"DSRC_CODE":"TEST"}]}}"#;
+        let config = CString::new(live).unwrap();
+        let handle = unsafe { SzConfigTool_open(config.as_ptr()) };
+
+        let script = "addConfigSection {\"section\": \"CFG_TEST\"}\n";
+        let patch = take_response(unsafe {
+            SzConfigTool_handleApplyCommandsAsPatch(
+                handle,
+                script.as_ptr() as *const c_char,
+                script.len(),
+            )
+        });
+        assert!(patch.contains("/G2_CONFIG/CFG_TEST"));
+        let edited = take_response(unsafe { SzConfigTool_serialize(handle) });
+        unsafe { SzConfigTool_close(handle) };
+
+        let patch = CString::new(patch).unwrap();
+        let replayed =
+            take_response(unsafe { SzConfigTool_applyPatch(config.as_ptr(), patch.as_ptr()) });
+        assert_eq!(replayed, edited);
+
+        let after = CString::new(edited).unwrap();
+        let diffed =
+            take_response(unsafe { SzConfigTool_diffAsPatch(config.as_ptr(), after.as_ptr()) });
+        assert_eq!(diffed.as_bytes(), patch.as_bytes());
+
+        let bad = CString::new(r#"[{"op":"remove","path":"/G2_CONFIG/NOPE"}]"#).unwrap();
+        let result = unsafe { SzConfigTool_applyPatch(config.as_ptr(), bad.as_ptr()) };
+        assert_eq!(result.returnCode, -2);
+    }
+
+    #[test]
+    fn test_open_and_save_file() {
+        let dir = tempfile::tempdir().unwrap();
+        let input = dir.path().join("in.json");
+        let output = dir.path().join("out.json");
+        std::fs::write(&input, r#"{"G2_CONFIG":{"CFG_DSRC":[]}}"#).unwrap();
+
+        let input = CString::new(input.to_str().unwrap()).unwrap();
+        let handle = unsafe { SzConfigTool_openFile(input.as_ptr()) };
+        assert!(!handle.is_null());
+        let code = CString::new("CUSTOMERS").unwrap();
+        assert_eq!(
+            unsafe { SzConfigTool_handleAddDataSource(handle, code.as_ptr()) },
+            0
+        );
+
+        let output_c = CString::new(output.to_str().unwrap()).unwrap();
+        assert_eq!(
+            unsafe { SzConfigTool_saveFile(handle, output_c.as_ptr()) },
+            0
+        );
+        unsafe { SzConfigTool_close(handle) };
+        assert!(
+            std::fs::read_to_string(&output)
+                .unwrap()
+                .contains("CUSTOMERS")
+        );
+
+        let missing = CString::new(dir.path().join("missing.json").to_str().unwrap()).unwrap();
+        assert!(unsafe { SzConfigTool_openFile(missing.as_ptr()) }.is_null());
+    }
+
+    #[test]
+    fn test_handle_snapshot_rollback() {
+        let config = CString::new(r#"{"G2_CONFIG":{"CFG_DSRC":[]}}"#).unwrap();
+        let handle = unsafe { SzConfigTool_open(config.as_ptr()) };
+        let before = take_response(unsafe { SzConfigTool_serialize(handle) });
+
+        let snapshot = unsafe { SzConfigTool_handleSnapshot(handle) };
+        assert!(snapshot > 0);
+        let script = r#"addConfigSection {"section": "CFG_A"}"#;
+        let rc = unsafe {
+            SzConfigTool_handleApplyCommands(handle, script.as_ptr() as *const c_char, script.len())
+        };
+        assert_eq!(rc, 0);
+        assert_eq!(unsafe { SzConfigTool_handleRollback(handle, snapshot) }, 0);
+        assert_eq!(
+            take_response(unsafe { SzConfigTool_serialize(handle) }),
+            before
+        );
+        assert!(unsafe { SzConfigTool_handleRelease(handle, snapshot) } < 0);
+
+        // The last line fails, so the first is undone
+        let script = "addConfigSection {\"section\": \"CFG_B\"}\nsave\naddConfigSection {\"section\": \"CFG_B\"}";
+        let rc = unsafe {
+            SzConfigTool_handleApplyCommandsAtomic(
+                handle,
+                script.as_ptr() as *const c_char,
+                script.len(),
+            )
+        };
+        assert!(rc < 0);
+        assert_eq!(
+            take_response(unsafe { SzConfigTool_serialize(handle) }),
+            before
+        );
+        unsafe { SzConfigTool_close(handle) };
+    }
+
+    #[test]
+    fn test_validate_config() {
+        let json = r#"{"G2_CONFIG":{"CFG_FTYPE":[{"FTYPE_ID":1,"FTYPE_CODE":"NAME"}],"CFG_FBOM":[{"FTYPE_ID":2,"FELEM_ID":-1}]}}"#;
+        let config = CString::new(json).unwrap();
+        let report: serde_json::Value = serde_json::from_str(&take_response(unsafe {
+            SzConfigTool_validateConfig(config.as_ptr())
+        }))
+        .unwrap();
+        assert_eq!(report["valid"], false);
+        assert_eq!(report["findings"][0]["target"], "CFG_FTYPE.FTYPE_ID");
+
+        let handle = unsafe { SzConfigTool_open(config.as_ptr()) };
+        let from_handle = take_response(unsafe { SzConfigTool_handleValidateConfig(handle) });
+        assert_eq!(
+            serde_json::from_str::<serde_json::Value>(&from_handle).unwrap(),
+            report
+        );
+        unsafe { SzConfigTool_close(handle) };
+    }
+
+    #[test]
+    fn test_handle_index_field_filter() {
+        let json = r#"{"G2_CONFIG":{"CFG_FBOM":[{"FTYPE_ID":1,"FELEM_ID":2},{"FTYPE_ID":3,"FELEM_ID":2}]}}"#;
+        let config = CString::new(json).unwrap();
+        let handle = unsafe { SzConfigTool_open(config.as_ptr()) };
+        let section = CString::new("CFG_FBOM").unwrap();
+        let field = CString::new("FTYPE_ID").unwrap();
+        let filter = CString::new("FTYPE_ID=3").unwrap();
+
+        let rc = unsafe { SzConfigTool_handleIndexField(handle, section.as_ptr(), field.as_ptr()) };
+        assert_eq!(rc, 0);
+        let mut out = std::ptr::null();
+        let mut len = 0;
+        let rc = unsafe {
+            SzConfigTool_handleGetConfigSection(
+                handle,
+                section.as_ptr(),
+                filter.as_ptr(),
+                &mut out,
+                &mut len,
+            )
+        };
+        assert_eq!(rc, 0);
+        let view = unsafe { std::slice::from_raw_parts(out as *const u8, len) };
+        assert_eq!(view, br#"[{"FTYPE_ID":3,"FELEM_ID":2}]"#);
+
+        let missing = CString::new("CFG_MISSING").unwrap();
+        let rc = unsafe { SzConfigTool_handleIndexField(handle, missing.as_ptr(), field.as_ptr()) };
+        assert!(rc < 0);
+        unsafe { SzConfigTool_close(handle) };
+    }
+
+    #[test]
+    fn test_handle_snapshot_file_round_trip() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = CString::new(dir.path().join("config.bin").to_str().unwrap()).unwrap();
+        let config = CString::new(
+            r#"{"G2_CONFIG":{"CONFIG_BASE_VERSION":{"COMPATIBILITY_VERSION":{"CONFIG_VERSION":"11"}},"CFG_DSRC":[]}}"#,
+        )
+        .unwrap();
+
+        unsafe {
+            let handle = SzConfigTool_open(config.as_ptr());
+            assert_eq!(SzConfigTool_saveSnapshot(handle, path.as_ptr()), 0);
+            SzConfigTool_close(handle);
+
+            let wrong = CString::new("10").unwrap();
+            assert!(SzConfigTool_openSnapshot(path.as_ptr(), wrong.as_ptr()).is_null());
+            assert_eq!(SzConfigTool_getLastErrorCode(), -2);
+
+            let expected = CString::new("11").unwrap();
+            let loaded = SzConfigTool_openSnapshot(path.as_ptr(), expected.as_ptr());
+            assert!(!loaded.is_null());
+            let json = take_response(SzConfigTool_serialize(loaded));
+            assert_eq!(json, config.to_str().unwrap());
+            SzConfigTool_close(loaded);
+        }
+    }
+
+    #[test]
+    fn test_config_fingerprint_matches_handle() {
+        let config = CString::new(r#"{"G2_CONFIG":{"CFG_DSRC":[{"DSRC_ID":1}]}}"#).unwrap();
+        let spaced =
+            CString::new(r#"{ "G2_CONFIG": { "CFG_DSRC": [ { "DSRC_ID": 1 } ] } }"#).unwrap();
+
+        unsafe {
+            let from_json = take_response(SzConfigTool_configFingerprint(config.as_ptr()));
+            let handle = SzConfigTool_open(spaced.as_ptr());
+            let from_handle = take_response(SzConfigTool_handleConfigFingerprint(handle));
+            SzConfigTool_close(handle);
+
+            assert_eq!(from_json, from_handle);
+            let value: serde_json::Value = serde_json::from_str(&from_json).unwrap();
+            assert_eq!(value["fingerprint"].as_str().unwrap().len(), 32);
+            assert!(value["sections"]["CFG_DSRC"].is_string());
+        }
+    }
+
+    #[test]
+    fn test_shared_reads_across_threads() {
+        let config = CString::new(
+            r#"{"G2_CONFIG":{"CFG_FCLASS":[{"FCLASS_ID":1,"FCLASS_CODE":"OTHER"}],"CFG_FTYPE":[{"FTYPE_ID":1,"FTYPE_CODE":"NAME","FCLASS_ID":1}],"CFG_FBOM":[],"CFG_FELEM":[],"CFG_ATTR":[],"CFG_CFRTN":[],"CFG_DSRC":[]}}"#,
+        )
+        .unwrap();
+        let shared = unsafe { SzConfigTool_sharedOpen(config.as_ptr()) };
+        assert!(!shared.is_null());
+        let address = shared as usize;
+
+        std::thread::scope(|s| {
+            for _ in 0..4 {
+                s.spawn(move || {
+                    let shared = address as *const SzConfigTool_shared;
+                    let name = CString::new("NAME").unwrap();
+                    for _ in 0..50 {
+                        let feature = take_response(unsafe {
+                            SzConfigTool_sharedGetFeature(shared, name.as_ptr())
+                        });
+                        assert!(feature.contains("\"NAME\""));
+                        let attrs =
+                            take_response(unsafe { SzConfigTool_sharedListAttributes(shared) });
+                        assert_eq!(attrs, "[]");
+                    }
+                });
+            }
+        });
+
+        let script = r#"addConfigSection {"section": "CFG_CUSTOM"}"#;
+        let rc = unsafe {
+            SzConfigTool_sharedApplyCommands(shared, script.as_ptr() as *const c_char, script.len())
+        };
+        assert_eq!(rc, 0);
+        assert_eq!(unsafe { SzConfigTool_sharedGeneration(shared) }, 1);
+        assert!(
+            take_response(unsafe { SzConfigTool_sharedSerialize(shared) }).contains("CFG_CUSTOM")
+        );
+
+        // A failing script publishes nothing
+        let rc = unsafe {
+            SzConfigTool_sharedApplyCommands(shared, script.as_ptr() as *const c_char, script.len())
+        };
+        assert_eq!(rc, -2);
+        assert_eq!(unsafe { SzConfigTool_sharedGeneration(shared) }, 1);
+
+        let missing = CString::new("NOPE").unwrap();
+        let result = unsafe { SzConfigTool_sharedGetFeature(shared, missing.as_ptr()) };
+        assert_eq!(result.returnCode, -2);
+        assert!(result.response.is_null());
+
+        unsafe { SzConfigTool_sharedClose(shared) };
+    }
+
+    #[test]
+    fn test_bulk_add_data_sources_and_attributes() {
+        let config = CString::new(r#"{"G2_CONFIG":{"CFG_DSRC":[],"CFG_ATTR":[]}}"#).unwrap();
+        let data_sources =
+            CString::new(r#"[{"code": "CUSTOMERS"}, {"code": "WATCHLIST", "reliability": 2}]"#)
+                .unwrap();
+        let json = take_response(unsafe {
+            SzConfigTool_addDataSources(config.as_ptr(), data_sources.as_ptr())
+        });
+        assert!(json.contains(
+            r#""DSRC_ID":2,"DSRC_CODE":"WATCHLIST","DSRC_DESC":"WATCHLIST","DSRC_RELY":2"#
+        ));
+
+        let handle = unsafe { SzConfigTool_open(config.as_ptr()) };
+        let attrs = CString::new(
+            r#"[{"attribute": "NAME_FULL", "feature": "NAME", "element": "FULL_NAME", "class": "NAME"},
+                {"attribute": "NAME_ORG", "feature": "NAME", "element": "ORG_NAME", "class": "NAME"}]"#,
+        )
+        .unwrap();
+        assert_eq!(
+            unsafe { SzConfigTool_handleAddAttributes(handle, attrs.as_ptr()) },
+            0
+        );
+        assert!(take_response(unsafe { SzConfigTool_serialize(handle) }).contains("NAME_ORG"));
+
+        // A missing field names the entry; a clash rejects the whole batch
+        let bad = CString::new(r#"[{"code": "A"}, {"retentionLevel": "Forget"}]"#).unwrap();
+        assert_eq!(
+            unsafe { SzConfigTool_handleAddDataSources(handle, bad.as_ptr()) },
+            -3
+        );
+        let error = unsafe { CStr::from_ptr(SzConfigTool_getLastError()) };
+        assert!(error.to_str().unwrap().starts_with("data_sources_json[1]:"));
+        assert_eq!(
+            unsafe { SzConfigTool_handleAddAttributes(handle, attrs.as_ptr()) },
+            -2
+        );
+        let result = unsafe { SzConfigTool_addAttributes(config.as_ptr(), c"{}".as_ptr()) };
+        assert_eq!(result.returnCode, -3);
+        unsafe { SzConfigTool_close(handle) };
+    }
+
+    #[test]
+    fn test_build_generic_plan() {
+        let config = CString::new(
+            r#"{"G2_CONFIG":{"CFG_FTYPE":[],"CFG_GPLAN":[{"GPLAN_ID":1,"GPLAN_CODE":"INGEST"}],"CFG_GENERIC_THRESHOLD":[{"GPLAN_ID":1,"BEHAVIOR":"NAME","FTYPE_ID":0,"CANDIDATE_CAP":10,"SCORING_CAP":-1,"SEND_TO_REDO":"Yes"}]}}"#,
+        )
+        .unwrap();
+        let source = CString::new("INGEST").unwrap();
+        let new_code = CString::new("TENANT_A").unwrap();
+        let overrides = CString::new(r#"[{"behavior": "NAME", "scoringCap": 99}]"#).unwrap();
+
+        let json = take_response(unsafe {
+            SzConfigTool_buildGenericPlan(
+                config.as_ptr(),
+                source.as_ptr(),
+                new_code.as_ptr(),
+                std::ptr::null(),
+                overrides.as_ptr(),
+            )
+        });
+        assert!(json.contains(
+            r#"{"GPLAN_ID":2,"BEHAVIOR":"NAME","FTYPE_ID":0,"CANDIDATE_CAP":10,"SCORING_CAP":99"#
+        ));
+
+        let handle = unsafe { SzConfigTool_open(config.as_ptr()) };
+        let missing =
+            CString::new(r#"[{"behavior": "F1", "feature": "NOPE", "scoringCap": 1}]"#).unwrap();
+        let rc = unsafe {
+            SzConfigTool_handleBuildGenericPlan(
+                handle,
+                source.as_ptr(),
+                new_code.as_ptr(),
+                std::ptr::null(),
+                missing.as_ptr(),
+            )
+        };
+        assert_eq!(rc, -2);
+        assert_eq!(
+            take_response(unsafe { SzConfigTool_serialize(handle) }),
+            config.to_str().unwrap()
+        );
+        unsafe { SzConfigTool_close(handle) };
+    }
+
+    #[test]
+    fn test_handle_name_hash_many() {
+        let config = CString::new(r#"{"G2_CONFIG":{"SYS_OOM":{}}}"#).unwrap();
+        let handle = unsafe { SzConfigTool_open(config.as_ptr()) };
+
+        let names: Vec<CString> = ["JOHN", "MARY"]
+            .iter()
+            .map(|n| CString::new(*n).unwrap())
+            .collect();
+        let ptrs: Vec<*const c_char> = names.iter().map(|n| n.as_ptr()).collect();
+        assert_eq!(
+            unsafe { SzConfigTool_handleAddToNameHashMany(handle, ptrs.as_ptr(), ptrs.len()) },
+            0
+        );
+        assert_eq!(
+            unsafe { SzConfigTool_handleAddToNameHashMany(handle, std::ptr::null(), 1) },
+            -1
+        );
+
+        let json = take_response(unsafe { SzConfigTool_serialize(handle) });
+        assert!(json.contains(r#""NAME_HASH":["JOHN","MARY"]"#));
+        unsafe { SzConfigTool_close(handle) };
+    }
+
+    #[test]
+    fn test_borrowed_and_buffer_reads() {
+        let json = r#"{"G2_CONFIG":{"CFG_FTYPE":[{"FTYPE_ID":1,"FTYPE_CODE":"NAME"}]}}"#;
+        let config = CString::new(json).unwrap();
+
+        // Size query, then fill
+        let mut needed = 0usize;
+        let rc = unsafe {
+            SzConfigTool_listFeaturesToBuffer(config.as_ptr(), std::ptr::null_mut(), 0, &mut needed)
+        };
+        assert_eq!(rc, BUFFER_TOO_SMALL);
+        let mut buf = vec![0 as c_char; needed + 1];
+        let rc = unsafe {
+            SzConfigTool_listFeaturesToBuffer(
+                config.as_ptr(),
+                buf.as_mut_ptr(),
+                buf.len(),
+                &mut needed,
+            )
+        };
+        assert_eq!(rc, 0);
+        let filled = unsafe { CStr::from_ptr(buf.as_ptr()) }
+            .to_str()
+            .unwrap()
+            .to_string();
+        assert_eq!(filled.len(), needed);
+
+        // The borrowed view of the same read matches
+        let handle = unsafe { SzConfigTool_open(config.as_ptr()) };
+        let mut view: *const c_char = std::ptr::null();
+        let mut len = 0usize;
+        assert_eq!(
+            unsafe { SzConfigTool_handleListFeatures(handle, &mut view, &mut len) },
+            0
+        );
+        let bytes = unsafe { std::slice::from_raw_parts(view as *const u8, len) };
+        assert_eq!(std::str::from_utf8(bytes).unwrap(), filled);
+        assert!(filled.contains(r#""feature":"NAME""#));
+
+        let section = CString::new("CFG_FTYPE").unwrap();
+        assert_eq!(
+            unsafe {
+                SzConfigTool_handleGetConfigSection(
+                    handle,
+                    section.as_ptr(),
+                    std::ptr::null(),
+                    &mut view,
+                    &mut len,
+                )
+            },
+            0
+        );
+        assert_eq!(unsafe { CStr::from_ptr(view) }.to_bytes().len(), len);
+        unsafe { SzConfigTool_close(handle) };
+    }
+
+    #[test]
+    fn test_errors_are_per_thread() {
+        set_error("main thread error".to_string(), -2);
+
+        std::thread::spawn(|| {
+            assert_eq!(SzConfigTool_getLastErrorCode(), 0);
+            assert!(SzConfigTool_getLastError().is_null());
+            set_error("worker error".to_string(), -3);
+        })
+        .join()
+        .unwrap();
+
+        assert_eq!(SzConfigTool_getLastErrorCode(), -2);
+        let msg = unsafe { CStr::from_ptr(SzConfigTool_getLastError()) };
+        assert_eq!(msg.to_str().unwrap(), "main thread error");
+
+        SzConfigTool_clearLastError();
+        assert!(SzConfigTool_getLastError().is_null());
+    }
+}
@@ -0,0 +1,443 @@
+//! Content fingerprints of configurations
+//!
+//! [`ConfigHandle::config_fingerprint`] hashes the parsed document, so two
+//! configurations with the same content get the same fingerprint however
+//! their JSON was formatted (whitespace, string escapes). Field and row order
+//! are part of the content: they show in the serialized output.
+//!
+//! Each `G2_CONFIG` member is hashed on its own and the document fingerprint
+//! combines the member fingerprints, so comparing two [`ConfigFingerprint`]s
+//! also tells which sections differ
+//! ([`changed_sections`](ConfigFingerprint::changed_sections)).
+//!
+//! Fingerprints are 128-bit and fast to compute, but not cryptographic and
+//! not collision-resistant: two different documents with the same
+//! fingerprint can be constructed with modest effort. Use them to detect
+//! accidental changes, not to identify or authenticate content from
+//! untrusted sources. Where a key must hold up against crafted inputs (such
+//! as [`UpgradeMemo`](crate::batch_upgrade::UpgradeMemo), shared between
+//! tenants) use a [`Digest`], the SHA-256 of the same content.
+//!
+//! # Example
+//!
+//! ```
+//! use sz_configtool_lib::ConfigHandle;
+//!
+//! let a = ConfigHandle::from_json(r#"{"G2_CONFIG":{"CFG_DSRC":[{"DSRC_ID":1}],"CFG_ATTR":[]}}"#)?;
+//! let b = ConfigHandle::from_json(r#"{ "G2_CONFIG": { "CFG_DSRC": [ {"DSRC_ID": 1} ], "CFG_ATTR": [] } }"#)?;
+//! let c = ConfigHandle::from_json(r#"{"G2_CONFIG":{"CFG_DSRC":[{"DSRC_ID":2}],"CFG_ATTR":[]}}"#)?;
+//!
+//! assert_eq!(a.config_fingerprint(), b.config_fingerprint());
+//! assert_eq!(a.config_fingerprint().changed_sections(&c.config_fingerprint()), vec!["CFG_DSRC"]);
+//! # Ok::<(), sz_configtool_lib::SzConfigError>(())
+//! ```
+
+use crate::error::Result;
+use crate::handle::{self, ConfigHandle};
+use crate::helpers::run_parallel;
+use crate::sha256::Sha256;
+use serde_json::{Map, Value, json};
+use std::fmt;
+use std::io::{self, Read};
+use std::thread;
+
+/// Total rows above which sections are hashed on several threads
+const PARALLEL_THRESHOLD: usize = 20_000;
+
+/// A 128-bit content hash
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash, PartialOrd, Ord)]
+pub struct Fingerprint(pub u128);
+
+impl Fingerprint {
+    /// Fingerprint of raw bytes (e.g. a script or an unparsed document)
+    pub fn of_bytes(bytes: &[u8]) -> Self {
+        let mut hasher = Hasher::default();
+        hasher.bytes(bytes);
+        hasher.finish()
+    }
+
+    /// Fingerprint of a JSON value's content
+    pub fn of_value(value: &Value) -> Self {
+        let mut hasher = Hasher::default();
+        hasher.value(value);
+        hasher.finish()
+    }
+}
+
+impl fmt::Display for Fingerprint {
+    /// 32 lowercase hex digits
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        write!(f, "{:032x}", self.0)
+    }
+}
+
+/// A SHA-256 content digest
+///
+/// Covers the same content as a [`Fingerprint`] (formatting does not count)
+/// but is collision-resistant, so it can key results shared between untrusted
+/// inputs.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub(crate) struct Digest([u8; 32]);
+
+impl Digest {
+    /// Digest of raw bytes
+    pub(crate) fn of_bytes(bytes: &[u8]) -> Self {
+        Self(Sha256::digest(bytes))
+    }
+
+    /// Digest of the raw bytes read from `reader`, without holding them
+    pub(crate) fn of_reader<R: Read>(mut reader: R) -> io::Result<Self> {
+        let mut sha = Sha256::default();
+        let mut buf = [0u8; 64 * 1024];
+        loop {
+            match reader.read(&mut buf) {
+                Ok(0) => return Ok(Self(sha.finish())),
+                Ok(n) => sha.update(&buf[..n]),
+                Err(e) if e.kind() == io::ErrorKind::Interrupted => {}
+                Err(e) => return Err(e),
+            }
+        }
+    }
+
+    /// Digest of a JSON value's content
+    pub(crate) fn of_value(value: &Value) -> Self {
+        let mut sha = Sha256::default();
+        sha.value(value);
+        Self(sha.finish())
+    }
+
+    /// Digest of a token stream written by `f`
+    pub(crate) fn of_tokens(f: impl FnOnce(&mut dyn Tokens)) -> Self {
+        let mut sha = Sha256::default();
+        f(&mut sha);
+        Self(sha.finish())
+    }
+}
+
+/// Fingerprint of a configuration and of each of its `G2_CONFIG` members
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct ConfigFingerprint {
+    /// Fingerprint of the whole document
+    pub fingerprint: Fingerprint,
+    /// (member name, fingerprint), in document order
+    pub sections: Vec<(String, Fingerprint)>,
+}
+
+impl ConfigFingerprint {
+    /// Fingerprint of one `G2_CONFIG` member
+    pub fn section(&self, name: &str) -> Option<Fingerprint> {
+        self.sections
+            .iter()
+            .find(|(n, _)| n == name)
+            .map(|&(_, fingerprint)| fingerprint)
+    }
+
+    /// Members that differ from `other`, or exist in only one of them
+    ///
+    /// Members of `self` come first in document order, then those only in
+    /// `other`.
+    pub fn changed_sections(&self, other: &ConfigFingerprint) -> Vec<String> {
+        let mut changed: Vec<String> = self
+            .sections
+            .iter()
+            .filter(|(name, fingerprint)| other.section(name) != Some(*fingerprint))
+            .map(|(name, _)| name.clone())
+            .collect();
+        changed.extend(
+            other
+                .sections
+                .iter()
+                .filter(|(name, _)| self.section(name).is_none())
+                .map(|(name, _)| name.clone()),
+        );
+        changed
+    }
+
+    /// `{"fingerprint": "...", "sections": {"CFG_ATTR": "...", ...}}`
+    pub fn to_json(&self) -> Value {
+        let sections: Map<String, Value> = self
+            .sections
+            .iter()
+            .map(|(name, fingerprint)| (name.clone(), json!(fingerprint.to_string())))
+            .collect();
+        json!({
+            "fingerprint": self.fingerprint.to_string(),
+            "sections": sections,
+        })
+    }
+}
+
+impl ConfigHandle {
+    /// Fingerprint the configuration (see [`crate::fingerprint`])
+    ///
+    /// Not collision-resistant: don't use it to recognize content from
+    /// untrusted sources.
+    pub fn config_fingerprint(&self) -> ConfigFingerprint {
+        let members: Vec<(&String, &Value)> = self
+            .g2_config()
+            .map(|g2_config| g2_config.iter().collect())
+            .unwrap_or_default();
+
+        let rows: usize = members
+            .iter()
+            .map(|(_, value)| value.as_array().map_or(0, |rows| rows.len()))
+            .sum();
+        let threads = if rows > PARALLEL_THRESHOLD {
+            thread::available_parallelism().map_or(1, |n| n.get())
+        } else {
+            1
+        };
+        let sections: Vec<(String, Fingerprint)> = run_parallel(members.len(), threads, |i| {
+            Fingerprint::of_value(members[i].1)
+        })
+        .into_iter()
+        .zip(&members)
+        .map(|(fingerprint, (name, _))| (name.to_string(), fingerprint))
+        .collect();
+
+        // The document hash covers the member hashes instead of their content
+        let mut hasher = Hasher::default();
+        match self.as_value() {
+            Value::Object(top) => {
+                hasher.word(OBJECT);
+                hasher.word(top.len() as u64);
+                for (key, value) in top {
+                    hasher.str(key);
+                    match value {
+                        Value::Object(_) if key == "G2_CONFIG" => {
+                            hasher.word(SECTIONS);
+                            hasher.word(sections.len() as u64);
+                            for (name, fingerprint) in &sections {
+                                hasher.str(name);
+                                hasher.word(fingerprint.0 as u64);
+                                hasher.word((fingerprint.0 >> 64) as u64);
+                            }
+                        }
+                        other => hasher.value(other),
+                    }
+                }
+            }
+            other => hasher.value(other),
+        }
+
+        ConfigFingerprint {
+            fingerprint: hasher.finish(),
+            sections,
+        }
+    }
+}
+
+/// Fingerprint a configuration JSON string
+///
+/// Not collision-resistant (see [`crate::fingerprint`]).
+///
+/// # Returns
+/// JSON `{"fingerprint": "<32 hex digits>", "sections": {"<member>": "<32 hex digits>", ...}}`
+///
+/// # Errors
+/// - `JsonParse` if config_json is invalid
+pub fn config_fingerprint(config_json: &str) -> Result<String> {
+    handle::read(config_json, |config| {
+        Ok(config.config_fingerprint().to_json().to_string())
+    })
+}
+
+// Value tags, so that e.g. "1" and 1 or [] and {} hash differently
+const NULL: u64 = 1;
+const FALSE: u64 = 2;
+const TRUE: u64 = 3;
+const INT: u64 = 4;
+const UINT: u64 = 5;
+const FLOAT: u64 = 6;
+const STRING: u64 = 7;
+const ARRAY: u64 = 8;
+const OBJECT: u64 = 9;
+/// `G2_CONFIG` hashed as its member fingerprints
+const SECTIONS: u64 = 10;
+
+/// Receiver of the token stream that content hashes are computed over
+///
+/// Inputs are fed as tagged, length-prefixed tokens, so the word sequence is
+/// unambiguous.
+pub(crate) trait Tokens {
+    fn word(&mut self, w: u64);
+
+    fn bytes(&mut self, bytes: &[u8]) {
+        self.word(bytes.len() as u64);
+        let mut chunks = bytes.chunks_exact(8);
+        for chunk in &mut chunks {
+            self.word(u64::from_le_bytes(chunk.try_into().expect("8 bytes")));
+        }
+        let rest = chunks.remainder();
+        if !rest.is_empty() {
+            let mut last = [0u8; 8];
+            last[..rest.len()].copy_from_slice(rest);
+            self.word(u64::from_le_bytes(last));
+        }
+    }
+
+    fn str(&mut self, s: &str) {
+        self.bytes(s.as_bytes());
+    }
+
+    fn value(&mut self, value: &Value) {
+        match value {
+            Value::Null => self.word(NULL),
+            Value::Bool(false) => self.word(FALSE),
+            Value::Bool(true) => self.word(TRUE),
+            Value::Number(n) => {
+                if let Some(i) = n.as_i64() {
+                    self.word(INT);
+                    self.word(i as u64);
+                } else if let Some(u) = n.as_u64() {
+                    self.word(UINT);
+                    self.word(u);
+                } else {
+                    self.word(FLOAT);
+                    self.word(n.as_f64().unwrap_or_default().to_bits());
+                }
+            }
+            Value::String(s) => {
+                self.word(STRING);
+                self.str(s);
+            }
+            Value::Array(items) => {
+                self.word(ARRAY);
+                self.word(items.len() as u64);
+                for item in items {
+                    self.value(item);
+                }
+            }
+            Value::Object(members) => {
+                self.word(OBJECT);
+                self.word(members.len() as u64);
+                for (key, member) in members {
+                    self.str(key);
+                    self.value(member);
+                }
+            }
+        }
+    }
+}
+
+impl Tokens for Sha256 {
+    fn word(&mut self, w: u64) {
+        self.update(&w.to_le_bytes());
+    }
+
+    fn bytes(&mut self, bytes: &[u8]) {
+        self.word(bytes.len() as u64);
+        self.update(bytes);
+    }
+}
+
+/// Two-lane multiply-mix hash over 64-bit words
+///
+/// Fast, but each step can be inverted, so collisions can be constructed.
+pub(crate) struct Hasher {
+    a: u64,
+    b: u64,
+}
+
+impl Default for Hasher {
+    fn default() -> Self {
+        Self {
+            a: 0x243f_6a88_85a3_08d3,
+            b: 0x1319_8a2e_0370_7344,
+        }
+    }
+}
+
+impl Tokens for Hasher {
+    fn word(&mut self, w: u64) {
+        self.a = (self.a ^ w).wrapping_mul(0x9e37_79b9_7f4a_7c15);
+        self.a ^= self.a >> 32;
+        self.b = (self.b ^ w.rotate_left(29)).wrapping_mul(0xc2b2_ae3d_27d4_eb4f);
+        self.b ^= self.b >> 29;
+    }
+}
+
+impl Hasher {
+    pub(crate) fn finish(self) -> Fingerprint {
+        // murmur3 finalizer on each lane, after mixing in the other
+        let fmix = |mut h: u64| {
+            h ^= h >> 33;
+            h = h.wrapping_mul(0xff51_afd7_ed55_8ccd);
+            h ^= h >> 33;
+            h = h.wrapping_mul(0xc4ce_b9fe_1a85_ec53);
+            h ^ (h >> 33)
+        };
+        let a = fmix(self.a ^ self.b.rotate_left(32));
+        let b = fmix(self.b.wrapping_add(a));
+        Fingerprint((u128::from(a) << 64) | u128::from(b))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_fingerprint_ignores_formatting_only() {
+        let a = ConfigHandle::from_json(r#"{"G2_CONFIG":{"CFG_A":[{"X":"é","N":10}]}}"#).unwrap();
+        let b = ConfigHandle::from_json(
+            "{\"G2_CONFIG\": {\"CFG_A\": [ {\"X\": \"\\u00e9\", \"N\": 10} ]}}",
+        )
+        .unwrap();
+        let reordered =
+            ConfigHandle::from_json(r#"{"G2_CONFIG":{"CFG_A":[{"N":10,"X":"é"}]}}"#).unwrap();
+
+        assert_eq!(a.config_fingerprint(), b.config_fingerprint());
+        assert_ne!(a.config_fingerprint(), reordered.config_fingerprint());
+    }
+
+    #[test]
+    fn test_tokens_are_unambiguous() {
+        let pairs = [
+            (json!(["ab", "c"]), json!(["a", "bc"])),
+            (json!([1]), json!(["1"])),
+            (json!([[]]), json!([{}])),
+            (json!({"a": null}), json!({"a": false})),
+            (json!([0]), json!([0.0])),
+        ];
+        for (x, y) in pairs {
+            assert_ne!(
+                Fingerprint::of_value(&x),
+                Fingerprint::of_value(&y),
+                "{x} vs {y}"
+            );
+        }
+    }
+
+    #[test]
+    fn test_digest_covers_content() {
+        let a = json!({"CFG_A": [{"X": "é", "N": 10}]});
+        let b: Value =
+            serde_json::from_str(r#"{ "CFG_A": [ {"X": "\u00e9", "N": 10} ] }"#).unwrap();
+        assert_eq!(Digest::of_value(&a), Digest::of_value(&b));
+        assert_ne!(
+            Digest::of_value(&json!(["ab", "c"])),
+            Digest::of_value(&json!(["a", "bc"]))
+        );
+        assert_ne!(Digest::of_bytes(b"{}"), Digest::of_bytes(b"{ }"));
+    }
+
+    #[test]
+    fn test_changed_sections() {
+        let mut config = ConfigHandle::from_value(json!({"G2_CONFIG": {
+            "CFG_A": [1], "CFG_B": [2], "CFG_C": [3]
+        }}));
+        let before = config.config_fingerprint();
+        config.section_mut("CFG_B").unwrap().push(json!(4));
+        config.g2_config_mut().unwrap().shift_remove("CFG_C");
+        let after = config.config_fingerprint();
+
+        assert_eq!(before.section("CFG_A"), after.section("CFG_A"));
+        assert_ne!(before.fingerprint, after.fingerprint);
+        assert_eq!(before.changed_sections(&after), vec!["CFG_B", "CFG_C"]);
+        assert_eq!(
+            after.to_json()["sections"]["CFG_A"],
+            json!(before.section("CFG_A").unwrap().to_string())
+        );
+    }
+}
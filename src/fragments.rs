@@ -4,7 +4,7 @@
 //! Fragments define matching criteria used by rules.
 
 use crate::error::{Result, SzConfigError};
-use crate::helpers;
+use crate::handle::{self, ConfigHandle};
 use serde_json::{Value, json};
 
 /// Validates a fragment source XPath expression and computes dependencies
@@ -14,7 +14,7 @@ use serde_json::{Value, json};
 ///
 /// # Arguments
 ///
-/// * `config_json` - Configuration JSON string
+/// * `config` - Parsed configuration
 /// * `source_string` - Fragment source XPath expression
 ///
 /// # Returns
@@ -31,12 +31,7 @@ use serde_json::{Value, json};
 /// let config = r#"{"G2_CONFIG": {"CFG_ERFRAG": []}}"#;
 /// // Note: validate_fragment_source is private, used internally by add_fragment
 /// ```
-fn validate_fragment_source(config_json: &str, source_string: &str) -> (Vec<String>, String) {
-    // Validate JSON parses correctly
-    if let Err(e) = serde_json::from_str::<Value>(config_json) {
-        return (vec![], format!("Invalid JSON: {}", e));
-    }
-
+fn validate_fragment_source(config: &ConfigHandle, source_string: &str) -> (Vec<String>, String) {
     let mut dependency_list = Vec::new();
     let mut source = source_string.to_string();
 
@@ -56,26 +51,19 @@ fn validate_fragment_source(config_json: &str, source_string: &str) -> (Vec<Stri
                     // Start or continue parsing fragment name
                     if in_fragment && !current_frag.is_empty() {
                         // End of previous fragment, lookup and validate
-                        match helpers::find_in_config_array(
-                            config_json,
+                        match config.find_in_config_array(
                             "CFG_ERFRAG",
                             "ERFRAG_CODE",
                             &current_frag,
                         ) {
-                            Ok(Some(frag_record)) => {
+                            Some(frag_record) => {
                                 if let Some(frag_id) =
                                     frag_record.get("ERFRAG_ID").and_then(|v| v.as_i64())
                                 {
                                     dependency_list.push(frag_id.to_string());
                                 }
                             }
-                            Ok(None) => {
-                                return (
-                                    vec![],
-                                    format!("Invalid fragment reference: {}", current_frag),
-                                );
-                            }
-                            Err(_) => {
+                            None => {
                                 return (
                                     vec![],
                                     format!("Invalid fragment reference: {}", current_frag),
@@ -90,26 +78,19 @@ fn validate_fragment_source(config_json: &str, source_string: &str) -> (Vec<Stri
                     if "|=><)] ".contains(ch) {
                         if !current_frag.is_empty() {
                             // Lookup fragment
-                            match helpers::find_in_config_array(
-                                config_json,
+                            match config.find_in_config_array(
                                 "CFG_ERFRAG",
                                 "ERFRAG_CODE",
                                 &current_frag,
                             ) {
-                                Ok(Some(frag_record)) => {
+                                Some(frag_record) => {
                                     if let Some(frag_id) =
                                         frag_record.get("ERFRAG_ID").and_then(|v| v.as_i64())
                                     {
                                         dependency_list.push(frag_id.to_string());
                                     }
                                 }
-                                Ok(None) => {
-                                    return (
-                                        vec![],
-                                        format!("Invalid fragment reference: {}", current_frag),
-                                    );
-                                }
-                                Err(_) => {
+                                None => {
                                     return (
                                         vec![],
                                         format!("Invalid fragment reference: {}", current_frag),
@@ -138,6 +119,157 @@ fn validate_fragment_source(config_json: &str, source_string: &str) -> (Vec<Stri
     (dependency_list, String::new())
 }
 
+impl ConfigHandle {
+    /// Add a new fragment (in-place form of [`add_fragment`])
+    ///
+    /// Returns the new fragment ID.
+    pub fn add_fragment(&mut self, fragment_config: &Value) -> Result<i64> {
+        let code = fragment_config
+            .get("ERFRAG_CODE")
+            .and_then(|v| v.as_str())
+            .ok_or_else(|| SzConfigError::MissingField("ERFRAG_CODE".to_string()))?;
+
+        let source = fragment_config
+            .get("ERFRAG_SOURCE")
+            .and_then(|v| v.as_str())
+            .ok_or_else(|| SzConfigError::MissingField("ERFRAG_SOURCE".to_string()))?;
+
+        // Validate source and compute dependencies
+        let (dependency_list, error_message) = validate_fragment_source(self, source);
+        if !error_message.is_empty() {
+            return Err(SzConfigError::InvalidInput(error_message));
+        }
+
+        // Get next ID
+        let next_id = if let Some(g2_config) = self.as_value().get("G2_CONFIG") {
+            if let Some(array) = g2_config.get("CFG_ERFRAG").and_then(|v| v.as_array()) {
+                array
+                    .iter()
+                    .filter_map(|item| item.get("ERFRAG_ID").and_then(|v| v.as_i64()))
+                    .max()
+                    .unwrap_or(0)
+                    + 1
+            } else {
+                1
+            }
+        } else {
+            return Err(SzConfigError::InvalidConfig(
+                "G2_CONFIG not found".to_string(),
+            ));
+        };
+
+        // Create new item with provided config plus ID and computed dependencies
+        let mut new_item = fragment_config.clone();
+        if let Some(obj) = new_item.as_object_mut() {
+            obj.insert("ERFRAG_ID".to_string(), json!(next_id));
+            obj.insert("ERFRAG_CODE".to_string(), json!(code.to_uppercase()));
+            obj.insert("ERFRAG_DESC".to_string(), json!(code.to_uppercase()));
+
+            // Set ERFRAG_DEPENDS to comma-separated list or null
+            if dependency_list.is_empty() {
+                obj.insert("ERFRAG_DEPENDS".to_string(), Value::Null);
+            } else {
+                obj.insert(
+                    "ERFRAG_DEPENDS".to_string(),
+                    json!(dependency_list.join(",")),
+                );
+            }
+        }
+
+        // Add to config
+        self.add_to_config_array("CFG_ERFRAG", new_item)?;
+
+        Ok(next_id)
+    }
+
+    /// Delete a fragment (in-place form of [`delete_fragment`])
+    pub fn delete_fragment(&mut self, fragment_code: &str) -> Result<()> {
+        let frag_code = fragment_code.to_uppercase();
+
+        // Verify fragment exists before deletion
+        if self
+            .find_in_config_array("CFG_ERFRAG", "ERFRAG_CODE", &frag_code)
+            .is_none()
+        {
+            return Err(SzConfigError::NotFound(format!(
+                "Fragment not found: {}",
+                frag_code
+            )));
+        }
+
+        // Remove from config
+        self.delete_from_config_array("CFG_ERFRAG", "ERFRAG_CODE", &frag_code)
+    }
+
+    /// Get a fragment by code or ID (see [`get_fragment`])
+    pub fn get_fragment(&self, code_or_id: &str) -> Result<Value> {
+        let search_value = code_or_id.to_uppercase();
+
+        // Try to find by CODE first, then by ID
+        self.find_in_config_array("CFG_ERFRAG", "ERFRAG_CODE", &search_value)
+            .or_else(|| self.find_in_config_array("CFG_ERFRAG", "ERFRAG_ID", &search_value))
+            .cloned()
+            .ok_or_else(|| SzConfigError::NotFound(format!("Fragment not found: {}", search_value)))
+    }
+
+    /// List all fragments (see [`list_fragments`])
+    pub fn list_fragments(&self) -> Vec<Value> {
+        // Extract fragments and transform to Python format
+        self.section("CFG_ERFRAG")
+            .map(|array| {
+                array
+                    .iter()
+                    .map(|item| {
+                        json!({
+                            "id": item.get("ERFRAG_ID").and_then(|v| v.as_i64()).unwrap_or(0),
+                            "fragment": item.get("ERFRAG_CODE").and_then(|v| v.as_str()).unwrap_or(""),
+                            "source": item.get("ERFRAG_SOURCE").and_then(|v| v.as_str()).unwrap_or(""),
+                            "depends": item.get("ERFRAG_DEPENDS").and_then(|v| v.as_str()).unwrap_or("")
+                        })
+                    })
+                    .collect()
+            })
+            .unwrap_or_default()
+    }
+
+    /// Update an existing fragment (in-place form of [`set_fragment`])
+    pub fn set_fragment(&mut self, fragment_code: &str, fragment_config: &Value) -> Result<()> {
+        let code = fragment_code.to_uppercase();
+
+        // Validate and compute dependencies if SOURCE is being updated
+        let mut updated_item = fragment_config.clone();
+        if let Some(new_source) = fragment_config
+            .get("ERFRAG_SOURCE")
+            .and_then(|v| v.as_str())
+        {
+            let (dependency_list, error_message) = validate_fragment_source(self, new_source);
+            if !error_message.is_empty() {
+                return Err(SzConfigError::InvalidInput(error_message));
+            }
+
+            // Update ERFRAG_DEPENDS in the update
+            if let Some(obj) = updated_item.as_object_mut() {
+                if dependency_list.is_empty() {
+                    obj.insert("ERFRAG_DEPENDS".to_string(), Value::Null);
+                } else {
+                    obj.insert(
+                        "ERFRAG_DEPENDS".to_string(),
+                        json!(dependency_list.join(",")),
+                    );
+                }
+            }
+        }
+
+        // Ensure the code field matches
+        if let Some(obj) = updated_item.as_object_mut() {
+            obj.insert("ERFRAG_CODE".to_string(), json!(code.clone()));
+        }
+
+        // Update the item in the config
+        self.update_in_config_array("CFG_ERFRAG", "ERFRAG_CODE", &code, updated_item)
+    }
+}
+
 /// Add a new fragment to the configuration
 ///
 /// # Arguments
@@ -164,64 +296,7 @@ fn validate_fragment_source(config_json: &str, source_string: &str) -> (Vec<Stri
 /// assert_eq!(frag_id, 1);
 /// ```
 pub fn add_fragment(config_json: &str, fragment_config: &Value) -> Result<(String, i64)> {
-    let code = fragment_config
-        .get("ERFRAG_CODE")
-        .and_then(|v| v.as_str())
-        .ok_or_else(|| SzConfigError::MissingField("ERFRAG_CODE".to_string()))?;
-
-    let source = fragment_config
-        .get("ERFRAG_SOURCE")
-        .and_then(|v| v.as_str())
-        .ok_or_else(|| SzConfigError::MissingField("ERFRAG_SOURCE".to_string()))?;
-
-    // Validate source and compute dependencies
-    let (dependency_list, error_message) = validate_fragment_source(config_json, source);
-    if !error_message.is_empty() {
-        return Err(SzConfigError::InvalidInput(error_message));
-    }
-
-    let config_data: Value = serde_json::from_str(config_json)?;
-
-    // Get next ID
-    let next_id = if let Some(g2_config) = config_data.get("G2_CONFIG") {
-        if let Some(array) = g2_config.get("CFG_ERFRAG").and_then(|v| v.as_array()) {
-            array
-                .iter()
-                .filter_map(|item| item.get("ERFRAG_ID").and_then(|v| v.as_i64()))
-                .max()
-                .unwrap_or(0)
-                + 1
-        } else {
-            1
-        }
-    } else {
-        return Err(SzConfigError::InvalidConfig(
-            "G2_CONFIG not found".to_string(),
-        ));
-    };
-
-    // Create new item with provided config plus ID and computed dependencies
-    let mut new_item = fragment_config.clone();
-    if let Some(obj) = new_item.as_object_mut() {
-        obj.insert("ERFRAG_ID".to_string(), json!(next_id));
-        obj.insert("ERFRAG_CODE".to_string(), json!(code.to_uppercase()));
-        obj.insert("ERFRAG_DESC".to_string(), json!(code.to_uppercase()));
-
-        // Set ERFRAG_DEPENDS to comma-separated list or null
-        if dependency_list.is_empty() {
-            obj.insert("ERFRAG_DEPENDS".to_string(), Value::Null);
-        } else {
-            obj.insert(
-                "ERFRAG_DEPENDS".to_string(),
-                json!(dependency_list.join(",")),
-            );
-        }
-    }
-
-    // Add to config
-    let modified_json = helpers::add_to_config_array(config_json, "CFG_ERFRAG", new_item)?;
-
-    Ok((modified_json, next_id))
+    handle::edit_returning(config_json, |config| config.add_fragment(fragment_config))
 }
 
 /// Delete a fragment from the configuration
@@ -244,14 +319,7 @@ pub fn add_fragment(config_json: &str, fragment_config: &Value) -> Result<(Strin
 /// let modified = fragments::delete_fragment(config, "TEST").unwrap();
 /// ```
 pub fn delete_fragment(config_json: &str, fragment_code: &str) -> Result<String> {
-    let frag_code = fragment_code.to_uppercase();
-
-    // Verify fragment exists before deletion
-    let _ = helpers::find_in_config_array(config_json, "CFG_ERFRAG", "ERFRAG_CODE", &frag_code)?
-        .ok_or_else(|| SzConfigError::NotFound(format!("Fragment not found: {}", frag_code)))?;
-
-    // Remove from config
-    helpers::remove_from_config_array(config_json, "CFG_ERFRAG", "ERFRAG_CODE", &frag_code)
+    handle::edit(config_json, |config| config.delete_fragment(fragment_code))
 }
 
 /// Get a fragment by code or ID
@@ -274,23 +342,9 @@ pub fn delete_fragment(config_json: &str, fragment_code: &str) -> Result<String>
 /// let fragment = fragments::get_fragment(config, "TEST").unwrap();
 /// ```
 pub fn get_fragment(config_json: &str, code_or_id: &str) -> Result<Value> {
-    let search_value = code_or_id.to_uppercase();
-
-    // Try to find by CODE first, then by ID
-    if let Some(item) =
-        helpers::find_in_config_array(config_json, "CFG_ERFRAG", "ERFRAG_CODE", &search_value)?
-    {
-        Ok(item)
-    } else if let Some(item) =
-        helpers::find_in_config_array(config_json, "CFG_ERFRAG", "ERFRAG_ID", &search_value)?
-    {
-        Ok(item)
-    } else {
-        Err(SzConfigError::NotFound(format!(
-            "Fragment not found: {}",
-            search_value
-        )))
-    }
+    handle::read_sections(config_json, &["CFG_ERFRAG"], |config| {
+        config.get_fragment(code_or_id)
+    })
 }
 
 /// List all fragments in the configuration
@@ -313,30 +367,9 @@ pub fn get_fragment(config_json: &str, code_or_id: &str) -> Result<Value> {
 /// assert_eq!(fragments.len(), 1);
 /// ```
 pub fn list_fragments(config_json: &str) -> Result<Vec<Value>> {
-    let config_data: Value = serde_json::from_str(config_json)?;
-
-    // Extract fragments and transform to Python format
-    let items: Vec<Value> = if let Some(g2_config) = config_data.get("G2_CONFIG") {
-        if let Some(array) = g2_config.get("CFG_ERFRAG").and_then(|v| v.as_array()) {
-            array
-                .iter()
-                .map(|item| {
-                    json!({
-                        "id": item.get("ERFRAG_ID").and_then(|v| v.as_i64()).unwrap_or(0),
-                        "fragment": item.get("ERFRAG_CODE").and_then(|v| v.as_str()).unwrap_or(""),
-                        "source": item.get("ERFRAG_SOURCE").and_then(|v| v.as_str()).unwrap_or(""),
-                        "depends": item.get("ERFRAG_DEPENDS").and_then(|v| v.as_str()).unwrap_or("")
-                    })
-                })
-                .collect()
-        } else {
-            Vec::new()
-        }
-    } else {
-        Vec::new()
-    };
-
-    Ok(items)
+    handle::read_sections(config_json, &["CFG_ERFRAG"], |config| {
+        Ok(config.list_fragments())
+    })
 }
 
 /// Update an existing fragment in the configuration
@@ -366,43 +399,7 @@ pub fn set_fragment(
     fragment_code: &str,
     fragment_config: &Value,
 ) -> Result<String> {
-    let code = fragment_code.to_uppercase();
-
-    // Validate and compute dependencies if SOURCE is being updated
-    let mut updated_item = fragment_config.clone();
-    if let Some(new_source) = fragment_config
-        .get("ERFRAG_SOURCE")
-        .and_then(|v| v.as_str())
-    {
-        let (dependency_list, error_message) = validate_fragment_source(config_json, new_source);
-        if !error_message.is_empty() {
-            return Err(SzConfigError::InvalidInput(error_message));
-        }
-
-        // Update ERFRAG_DEPENDS in the update
-        if let Some(obj) = updated_item.as_object_mut() {
-            if dependency_list.is_empty() {
-                obj.insert("ERFRAG_DEPENDS".to_string(), Value::Null);
-            } else {
-                obj.insert(
-                    "ERFRAG_DEPENDS".to_string(),
-                    json!(dependency_list.join(",")),
-                );
-            }
-        }
-    }
-
-    // Ensure the code field matches
-    if let Some(obj) = updated_item.as_object_mut() {
-        obj.insert("ERFRAG_CODE".to_string(), json!(code.clone()));
-    }
-
-    // Update the item in the config
-    helpers::update_in_config_array(
-        config_json,
-        "CFG_ERFRAG",
-        "ERFRAG_CODE",
-        &code,
-        updated_item,
-    )
+    handle::edit(config_json, |config| {
+        config.set_fragment(fragment_code, fragment_config)
+    })
 }
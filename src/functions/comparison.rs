@@ -4,9 +4,7 @@
 //! and comparison function return codes (CFG_CFRTN) in the Senzing configuration JSON.
 
 use crate::error::SzConfigError;
-use crate::helpers::{
-    add_to_config_array, delete_from_config_array, find_in_config_array, get_next_id,
-};
+use crate::handle::{self, ConfigHandle};
 use serde_json::{Value, json};
 
 // ============================================================================
@@ -47,6 +45,189 @@ pub struct SetComparisonFunctionParams<'a> {
     pub anon_support: Option<&'a str>,
 }
 
+impl ConfigHandle {
+    /// Add a new comparison function (in-place form of [`add_comparison_function`])
+    ///
+    /// Returns the new function record.
+    pub fn add_comparison_function(
+        &mut self,
+        cfunc_code: &str,
+        params: AddComparisonFunctionParams,
+    ) -> Result<Value, SzConfigError> {
+        let cfunc_code = cfunc_code.to_uppercase();
+
+        // Check if function already exists
+        if self
+            .find_in_config_array("CFG_CFUNC", "CFUNC_CODE", &cfunc_code)
+            .is_some()
+        {
+            return Err(SzConfigError::validation(format!(
+                "Comparison function already exists: {}",
+                cfunc_code
+            )));
+        }
+
+        // Get next CFUNC_ID
+        let cfunc_id = self.next_id("CFG_CFUNC", "CFUNC_ID", Some(1))?;
+
+        // Create new function record
+        let mut new_record = json!({
+            "CFUNC_ID": cfunc_id,
+            "CFUNC_CODE": cfunc_code,
+            "CONNECT_STR": params.connect_str,
+        });
+
+        // Add optional fields
+        if let Some(obj) = new_record.as_object_mut() {
+            if let Some(desc) = params.description {
+                obj.insert("CFUNC_DESC".to_string(), json!(desc));
+            }
+            if let Some(lang) = params.language {
+                obj.insert("LANGUAGE".to_string(), json!(lang));
+            }
+            if let Some(anon) = params.anon_support {
+                obj.insert("ANON_SUPPORT".to_string(), json!(anon));
+            }
+        }
+
+        // Add to CFG_CFUNC
+        self.add_to_config_array("CFG_CFUNC", new_record.clone())?;
+
+        Ok(new_record)
+    }
+
+    /// Delete a comparison function by code (in-place form of [`delete_comparison_function`])
+    ///
+    /// Returns the deleted function record.
+    pub fn delete_comparison_function(&mut self, cfunc_code: &str) -> Result<Value, SzConfigError> {
+        let function = self.get_comparison_function(cfunc_code)?;
+
+        // Delete from CFG_CFUNC
+        self.delete_from_config_array("CFG_CFUNC", "CFUNC_CODE", &cfunc_code.to_uppercase())?;
+
+        Ok(function)
+    }
+
+    /// Get a comparison function by code (see [`get_comparison_function`])
+    pub fn get_comparison_function(&self, cfunc_code: &str) -> Result<Value, SzConfigError> {
+        let cfunc_code = cfunc_code.to_uppercase();
+
+        self.find_in_config_array("CFG_CFUNC", "CFUNC_CODE", &cfunc_code)
+            .cloned()
+            .ok_or_else(|| {
+                SzConfigError::not_found(format!("Comparison function not found: {}", cfunc_code))
+            })
+    }
+
+    /// List all comparison functions in display format (see [`list_comparison_functions`])
+    pub fn list_comparison_functions(&self) -> Vec<Value> {
+        self.section("CFG_CFUNC")
+            .map(|items| {
+                items
+                    .iter()
+                    .map(|item| {
+                        json!({
+                            "id": item.get("CFUNC_ID").and_then(|v| v.as_i64()).unwrap_or(0),
+                            "function": item.get("CFUNC_CODE").and_then(|v| v.as_str()).unwrap_or(""),
+                            "connectStr": item.get("CONNECT_STR").and_then(|v| v.as_str()).unwrap_or(""),
+                            "language": item.get("LANGUAGE").and_then(|v| v.as_str()).unwrap_or(""),
+                    "anonSupport": item.get("ANON_SUPPORT").and_then(|v| v.as_str()).unwrap_or("")
+                        })
+                    })
+                    .collect()
+            })
+            .unwrap_or_default()
+    }
+
+    /// Set (update) a comparison function (in-place form of [`set_comparison_function`])
+    ///
+    /// Returns the updated function record.
+    pub fn set_comparison_function(
+        &mut self,
+        cfunc_code: &str,
+        params: SetComparisonFunctionParams,
+    ) -> Result<Value, SzConfigError> {
+        let mut function = self.get_comparison_function(cfunc_code)?;
+
+        // Update fields if provided
+        if let Some(obj) = function.as_object_mut() {
+            if let Some(conn) = params.connect_str {
+                obj.insert("CONNECT_STR".to_string(), json!(conn));
+            }
+            if let Some(desc) = params.description {
+                obj.insert("CFUNC_DESC".to_string(), json!(desc));
+            }
+            if let Some(lang) = params.language {
+                obj.insert("LANGUAGE".to_string(), json!(lang));
+            }
+            if let Some(anon) = params.anon_support {
+                obj.insert("ANON_SUPPORT".to_string(), json!(anon));
+            }
+        }
+
+        // Delete old and add updated
+        self.delete_from_config_array("CFG_CFUNC", "CFUNC_CODE", &cfunc_code.to_uppercase())?;
+        self.add_to_config_array("CFG_CFUNC", function.clone())?;
+
+        Ok(function)
+    }
+
+    /// Add a comparison function return code (in-place form of [`add_comparison_func_return_code`])
+    ///
+    /// Returns the new return code record.
+    pub fn add_comparison_func_return_code(
+        &mut self,
+        cfunc_code: &str,
+        cfrtn_code: &str,
+        cfrtn_desc: Option<&str>,
+    ) -> Result<Value, SzConfigError> {
+        let cfunc_code = cfunc_code.to_uppercase();
+        let cfrtn_code = cfrtn_code.to_uppercase();
+
+        // Find the function
+        let cfunc_id = self
+            .get_comparison_function(&cfunc_code)?
+            .get("CFUNC_ID")
+            .and_then(|v| v.as_i64())
+            .ok_or_else(|| SzConfigError::validation("CFUNC_ID not found"))?;
+
+        // Check if return code already exists for this function
+        if let Ok(items) = self.section("CFG_CFRTN")
+            && items.iter().any(|item| {
+                item.get("CFUNC_ID").and_then(|v| v.as_i64()) == Some(cfunc_id)
+                    && item.get("CFRTN_CODE").and_then(|v| v.as_str()) == Some(&cfrtn_code)
+            })
+        {
+            return Err(SzConfigError::validation(format!(
+                "Return code {} already exists for function {}",
+                cfrtn_code, cfunc_code
+            )));
+        }
+
+        // Get next CFRTN_ID
+        let cfrtn_id = self.next_id("CFG_CFRTN", "CFRTN_ID", Some(1))?;
+
+        // Create new return code record
+        let mut new_record = json!({
+            "CFRTN_ID": cfrtn_id,
+            "CFUNC_ID": cfunc_id,
+            "CFRTN_CODE": cfrtn_code,
+        });
+
+        // Add optional description
+        if let Some(desc) = cfrtn_desc
+            && let Some(obj) = new_record.as_object_mut()
+        {
+            obj.insert("CFRTN_DESC".to_string(), json!(desc));
+        }
+
+        // Add to CFG_CFRTN
+        self.add_to_config_array("CFG_CFRTN", new_record.clone())?;
+
+        Ok(new_record)
+    }
+}
+
 /// Add a new comparison function
 ///
 /// # Arguments
@@ -64,45 +245,9 @@ pub fn add_comparison_function(
     cfunc_code: &str,
     params: AddComparisonFunctionParams,
 ) -> Result<(String, Value), SzConfigError> {
-    let cfunc_code = cfunc_code.to_uppercase();
-
-    // Check if function already exists
-    if find_in_config_array(config_json, "CFG_CFUNC", "CFUNC_CODE", &cfunc_code)?.is_some() {
-        return Err(SzConfigError::validation(format!(
-            "Comparison function already exists: {}",
-            cfunc_code
-        )));
-    }
-
-    // Get next CFUNC_ID
-    let config_data: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::json_parse(e.to_string()))?;
-    let cfunc_id = get_next_id(&config_data, "G2_CONFIG.CFG_CFUNC", "CFUNC_ID", 1)?;
-
-    // Create new function record
-    let mut new_record = json!({
-        "CFUNC_ID": cfunc_id,
-        "CFUNC_CODE": cfunc_code,
-        "CONNECT_STR": params.connect_str,
-    });
-
-    // Add optional fields
-    if let Some(obj) = new_record.as_object_mut() {
-        if let Some(desc) = params.description {
-            obj.insert("CFUNC_DESC".to_string(), json!(desc));
-        }
-        if let Some(lang) = params.language {
-            obj.insert("LANGUAGE".to_string(), json!(lang));
-        }
-        if let Some(anon) = params.anon_support {
-            obj.insert("ANON_SUPPORT".to_string(), json!(anon));
-        }
-    }
-
-    // Add to CFG_CFUNC
-    let modified_json = add_to_config_array(config_json, "CFG_CFUNC", new_record.clone())?;
-
-    Ok((modified_json, new_record))
+    handle::edit_returning(config_json, |config| {
+        config.add_comparison_function(cfunc_code, params)
+    })
 }
 
 /// Delete a comparison function by code
@@ -120,19 +265,9 @@ pub fn delete_comparison_function(
     config_json: &str,
     cfunc_code: &str,
 ) -> Result<(String, Value), SzConfigError> {
-    let cfunc_code = cfunc_code.to_uppercase();
-
-    // Find the function
-    let function = find_in_config_array(config_json, "CFG_CFUNC", "CFUNC_CODE", &cfunc_code)?
-        .ok_or_else(|| {
-            SzConfigError::not_found(format!("Comparison function not found: {}", cfunc_code))
-        })?;
-
-    // Delete from CFG_CFUNC
-    let modified_json =
-        delete_from_config_array(config_json, "CFG_CFUNC", "CFUNC_CODE", &cfunc_code)?;
-
-    Ok((modified_json, function))
+    handle::edit_returning(config_json, |config| {
+        config.delete_comparison_function(cfunc_code)
+    })
 }
 
 /// Get a comparison function by code
@@ -150,10 +285,8 @@ pub fn get_comparison_function(
     config_json: &str,
     cfunc_code: &str,
 ) -> Result<Value, SzConfigError> {
-    let cfunc_code = cfunc_code.to_uppercase();
-
-    find_in_config_array(config_json, "CFG_CFUNC", "CFUNC_CODE", &cfunc_code)?.ok_or_else(|| {
-        SzConfigError::not_found(format!("Comparison function not found: {}", cfunc_code))
+    handle::read_sections(config_json, &["CFG_CFUNC"], |config| {
+        config.get_comparison_function(cfunc_code)
     })
 }
 
@@ -168,30 +301,9 @@ pub fn get_comparison_function(
 /// # Errors
 /// Returns error if JSON is invalid
 pub fn list_comparison_functions(config_json: &str) -> Result<Vec<Value>, SzConfigError> {
-    let config_data: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::json_parse(e.to_string()))?;
-
-    let items: Vec<Value> = if let Some(g2_config) = config_data.get("G2_CONFIG")
-        && let Some(array) = g2_config.get("CFG_CFUNC")
-        && let Some(items) = array.as_array()
-    {
-        items
-            .iter()
-            .map(|item| {
-                json!({
-                    "id": item.get("CFUNC_ID").and_then(|v| v.as_i64()).unwrap_or(0),
-                    "function": item.get("CFUNC_CODE").and_then(|v| v.as_str()).unwrap_or(""),
-                    "connectStr": item.get("CONNECT_STR").and_then(|v| v.as_str()).unwrap_or(""),
-                    "language": item.get("LANGUAGE").and_then(|v| v.as_str()).unwrap_or(""),
-                    "anonSupport": item.get("ANON_SUPPORT").and_then(|v| v.as_str()).unwrap_or("")
-                })
-            })
-            .collect()
-    } else {
-        Vec::new()
-    };
-
-    Ok(items)
+    handle::read_sections(config_json, &["CFG_CFUNC"], |config| {
+        Ok(config.list_comparison_functions())
+    })
 }
 
 /// Set (update) a comparison function
@@ -211,35 +323,9 @@ pub fn set_comparison_function(
     cfunc_code: &str,
     params: SetComparisonFunctionParams,
 ) -> Result<(String, Value), SzConfigError> {
-    let cfunc_code = cfunc_code.to_uppercase();
-
-    // Find existing function
-    let mut function = find_in_config_array(config_json, "CFG_CFUNC", "CFUNC_CODE", &cfunc_code)?
-        .ok_or_else(|| {
-        SzConfigError::not_found(format!("Comparison function not found: {}", cfunc_code))
-    })?;
-
-    // Update fields if provided
-    if let Some(obj) = function.as_object_mut() {
-        if let Some(conn) = params.connect_str {
-            obj.insert("CONNECT_STR".to_string(), json!(conn));
-        }
-        if let Some(desc) = params.description {
-            obj.insert("CFUNC_DESC".to_string(), json!(desc));
-        }
-        if let Some(lang) = params.language {
-            obj.insert("LANGUAGE".to_string(), json!(lang));
-        }
-        if let Some(anon) = params.anon_support {
-            obj.insert("ANON_SUPPORT".to_string(), json!(anon));
-        }
-    }
-
-    // Delete old and add updated
-    let temp_json = delete_from_config_array(config_json, "CFG_CFUNC", "CFUNC_CODE", &cfunc_code)?;
-    let modified_json = add_to_config_array(&temp_json, "CFG_CFUNC", function.clone())?;
-
-    Ok((modified_json, function))
+    handle::edit_returning(config_json, |config| {
+        config.set_comparison_function(cfunc_code, params)
+    })
 }
 
 /// Add a comparison function return code
@@ -261,59 +347,9 @@ pub fn add_comparison_func_return_code(
     cfrtn_code: &str,
     cfrtn_desc: Option<&str>,
 ) -> Result<(String, Value), SzConfigError> {
-    let cfunc_code = cfunc_code.to_uppercase();
-    let cfrtn_code = cfrtn_code.to_uppercase();
-
-    // Find the function
-    let config_data: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::json_parse(e.to_string()))?;
-
-    let cfunc = find_in_config_array(config_json, "CFG_CFUNC", "CFUNC_CODE", &cfunc_code)?
-        .ok_or_else(|| {
-            SzConfigError::not_found(format!("Comparison function not found: {}", cfunc_code))
-        })?;
-
-    let cfunc_id = cfunc
-        .get("CFUNC_ID")
-        .and_then(|v| v.as_i64())
-        .ok_or_else(|| SzConfigError::validation("CFUNC_ID not found"))?;
-
-    // Check if return code already exists for this function
-    if let Some(g2_config) = config_data.get("G2_CONFIG")
-        && let Some(array) = g2_config.get("CFG_CFRTN")
-        && let Some(items) = array.as_array()
-        && items.iter().any(|item| {
-            item.get("CFUNC_ID").and_then(|v| v.as_i64()) == Some(cfunc_id)
-                && item.get("CFRTN_CODE").and_then(|v| v.as_str()) == Some(&cfrtn_code)
-        })
-    {
-        return Err(SzConfigError::validation(format!(
-            "Return code {} already exists for function {}",
-            cfrtn_code, cfunc_code
-        )));
-    }
-
-    // Get next CFRTN_ID
-    let cfrtn_id = get_next_id(&config_data, "G2_CONFIG.CFG_CFRTN", "CFRTN_ID", 1)?;
-
-    // Create new return code record
-    let mut new_record = json!({
-        "CFRTN_ID": cfrtn_id,
-        "CFUNC_ID": cfunc_id,
-        "CFRTN_CODE": cfrtn_code,
-    });
-
-    // Add optional description
-    if let Some(desc) = cfrtn_desc {
-        if let Some(obj) = new_record.as_object_mut() {
-            obj.insert("CFRTN_DESC".to_string(), json!(desc));
-        }
-    }
-
-    // Add to CFG_CFRTN
-    let modified_json = add_to_config_array(config_json, "CFG_CFRTN", new_record.clone())?;
-
-    Ok((modified_json, new_record))
+    handle::edit_returning(config_json, |config| {
+        config.add_comparison_func_return_code(cfunc_code, cfrtn_code, cfrtn_desc)
+    })
 }
 
 #[cfg(test)]
@@ -4,9 +4,7 @@
 //! in the Senzing configuration JSON.
 
 use crate::error::SzConfigError;
-use crate::helpers::{
-    add_to_config_array, delete_from_config_array, find_in_config_array, get_next_id,
-};
+use crate::handle::{self, ConfigHandle};
 use serde_json::{Value, json};
 
 // ============================================================================
@@ -44,6 +42,127 @@ pub struct SetDistinctFunctionParams<'a> {
     pub language: Option<&'a str>,
 }
 
+impl ConfigHandle {
+    /// Add a new distinct function (in-place form of [`add_distinct_function`])
+    ///
+    /// Returns the new function record.
+    pub fn add_distinct_function(
+        &mut self,
+        dfunc_code: &str,
+        params: AddDistinctFunctionParams,
+    ) -> Result<Value, SzConfigError> {
+        let dfunc_code = dfunc_code.to_uppercase();
+
+        // Check if function already exists
+        if self
+            .find_in_config_array("CFG_DFUNC", "DFUNC_CODE", &dfunc_code)
+            .is_some()
+        {
+            return Err(SzConfigError::validation(format!(
+                "Distinct function already exists: {}",
+                dfunc_code
+            )));
+        }
+
+        // Get next DFUNC_ID
+        let dfunc_id = self.next_id("CFG_DFUNC", "DFUNC_ID", Some(1))?;
+
+        // Create new function record
+        let mut new_record = json!({
+            "DFUNC_ID": dfunc_id,
+            "DFUNC_CODE": dfunc_code,
+            "CONNECT_STR": params.connect_str,
+        });
+
+        // Add optional fields
+        if let Some(obj) = new_record.as_object_mut() {
+            if let Some(desc) = params.description {
+                obj.insert("DFUNC_DESC".to_string(), json!(desc));
+            }
+            if let Some(lang) = params.language {
+                obj.insert("LANGUAGE".to_string(), json!(lang));
+            }
+        }
+
+        // Add to CFG_DFUNC
+        self.add_to_config_array("CFG_DFUNC", new_record.clone())?;
+
+        Ok(new_record)
+    }
+
+    /// Delete a distinct function by code (in-place form of [`delete_distinct_function`])
+    ///
+    /// Returns the deleted function record.
+    pub fn delete_distinct_function(&mut self, dfunc_code: &str) -> Result<Value, SzConfigError> {
+        let function = self.get_distinct_function(dfunc_code)?;
+
+        // Delete from CFG_DFUNC
+        self.delete_from_config_array("CFG_DFUNC", "DFUNC_CODE", &dfunc_code.to_uppercase())?;
+
+        Ok(function)
+    }
+
+    /// Get a distinct function by code (see [`get_distinct_function`])
+    pub fn get_distinct_function(&self, dfunc_code: &str) -> Result<Value, SzConfigError> {
+        let dfunc_code = dfunc_code.to_uppercase();
+
+        self.find_in_config_array("CFG_DFUNC", "DFUNC_CODE", &dfunc_code)
+            .cloned()
+            .ok_or_else(|| {
+                SzConfigError::not_found(format!("Distinct function not found: {}", dfunc_code))
+            })
+    }
+
+    /// List all distinct functions in display format (see [`list_distinct_functions`])
+    pub fn list_distinct_functions(&self) -> Vec<Value> {
+        self.section("CFG_DFUNC")
+            .map(|items| {
+                items
+                    .iter()
+                    .map(|item| {
+                        json!({
+                            "id": item.get("DFUNC_ID").and_then(|v| v.as_i64()).unwrap_or(0),
+                            "function": item.get("DFUNC_CODE").and_then(|v| v.as_str()).unwrap_or(""),
+                            "connectStr": item.get("CONNECT_STR").and_then(|v| v.as_str()).unwrap_or(""),
+                            "language": item.get("LANGUAGE").and_then(|v| v.as_str()).unwrap_or("")
+                        })
+                    })
+                    .collect()
+            })
+            .unwrap_or_default()
+    }
+
+    /// Set (update) a distinct function (in-place form of [`set_distinct_function`])
+    ///
+    /// Returns the updated function record.
+    pub fn set_distinct_function(
+        &mut self,
+        dfunc_code: &str,
+        params: SetDistinctFunctionParams,
+    ) -> Result<Value, SzConfigError> {
+        let mut function = self.get_distinct_function(dfunc_code)?;
+
+        // Update fields if provided
+        if let Some(obj) = function.as_object_mut() {
+            if let Some(conn) = params.connect_str {
+                obj.insert("CONNECT_STR".to_string(), json!(conn));
+            }
+            if let Some(desc) = params.description {
+                obj.insert("DFUNC_DESC".to_string(), json!(desc));
+            }
+            if let Some(lang) = params.language {
+                obj.insert("LANGUAGE".to_string(), json!(lang));
+            }
+        }
+
+        // Delete old and add updated
+        self.delete_from_config_array("CFG_DFUNC", "DFUNC_CODE", &dfunc_code.to_uppercase())?;
+        self.add_to_config_array("CFG_DFUNC", function.clone())?;
+
+        Ok(function)
+    }
+}
+
 /// Add a new distinct function
 ///
 /// # Arguments
@@ -61,42 +180,9 @@ pub fn add_distinct_function(
     dfunc_code: &str,
     params: AddDistinctFunctionParams,
 ) -> Result<(String, Value), SzConfigError> {
-    let dfunc_code = dfunc_code.to_uppercase();
-
-    // Check if function already exists
-    if find_in_config_array(config_json, "CFG_DFUNC", "DFUNC_CODE", &dfunc_code)?.is_some() {
-        return Err(SzConfigError::validation(format!(
-            "Distinct function already exists: {}",
-            dfunc_code
-        )));
-    }
-
-    // Get next DFUNC_ID
-    let config_data: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::json_parse(e.to_string()))?;
-    let dfunc_id = get_next_id(&config_data, "G2_CONFIG.CFG_DFUNC", "DFUNC_ID", 1)?;
-
-    // Create new function record
-    let mut new_record = json!({
-        "DFUNC_ID": dfunc_id,
-        "DFUNC_CODE": dfunc_code,
-        "CONNECT_STR": params.connect_str,
-    });
-
-    // Add optional fields
-    if let Some(obj) = new_record.as_object_mut() {
-        if let Some(desc) = params.description {
-            obj.insert("DFUNC_DESC".to_string(), json!(desc));
-        }
-        if let Some(lang) = params.language {
-            obj.insert("LANGUAGE".to_string(), json!(lang));
-        }
-    }
-
-    // Add to CFG_DFUNC
-    let modified_json = add_to_config_array(config_json, "CFG_DFUNC", new_record.clone())?;
-
-    Ok((modified_json, new_record))
+    handle::edit_returning(config_json, |config| {
+        config.add_distinct_function(dfunc_code, params)
+    })
 }
 
 /// Delete a distinct function by code
@@ -114,19 +200,9 @@ pub fn delete_distinct_function(
     config_json: &str,
     dfunc_code: &str,
 ) -> Result<(String, Value), SzConfigError> {
-    let dfunc_code = dfunc_code.to_uppercase();
-
-    // Find the function
-    let function = find_in_config_array(config_json, "CFG_DFUNC", "DFUNC_CODE", &dfunc_code)?
-        .ok_or_else(|| {
-            SzConfigError::not_found(format!("Distinct function not found: {}", dfunc_code))
-        })?;
-
-    // Delete from CFG_DFUNC
-    let modified_json =
-        delete_from_config_array(config_json, "CFG_DFUNC", "DFUNC_CODE", &dfunc_code)?;
-
-    Ok((modified_json, function))
+    handle::edit_returning(config_json, |config| {
+        config.delete_distinct_function(dfunc_code)
+    })
 }
 
 /// Get a distinct function by code
@@ -141,10 +217,8 @@ pub fn delete_distinct_function(
 /// # Errors
 /// Returns error if function not found or JSON is invalid
 pub fn get_distinct_function(config_json: &str, dfunc_code: &str) -> Result<Value, SzConfigError> {
-    let dfunc_code = dfunc_code.to_uppercase();
-
-    find_in_config_array(config_json, "CFG_DFUNC", "DFUNC_CODE", &dfunc_code)?.ok_or_else(|| {
-        SzConfigError::not_found(format!("Distinct function not found: {}", dfunc_code))
+    handle::read_sections(config_json, &["CFG_DFUNC"], |config| {
+        config.get_distinct_function(dfunc_code)
     })
 }
 
@@ -159,29 +233,9 @@ pub fn get_distinct_function(config_json: &str, dfunc_code: &str) -> Result<Valu
 /// # Errors
 /// Returns error if JSON is invalid
 pub fn list_distinct_functions(config_json: &str) -> Result<Vec<Value>, SzConfigError> {
-    let config_data: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::json_parse(e.to_string()))?;
-
-    let items: Vec<Value> = if let Some(g2_config) = config_data.get("G2_CONFIG")
-        && let Some(array) = g2_config.get("CFG_DFUNC")
-        && let Some(items) = array.as_array()
-    {
-        items
-            .iter()
-            .map(|item| {
-                json!({
-                    "id": item.get("DFUNC_ID").and_then(|v| v.as_i64()).unwrap_or(0),
-                    "function": item.get("DFUNC_CODE").and_then(|v| v.as_str()).unwrap_or(""),
-                    "connectStr": item.get("CONNECT_STR").and_then(|v| v.as_str()).unwrap_or(""),
-                    "language": item.get("LANGUAGE").and_then(|v| v.as_str()).unwrap_or("")
-                })
-            })
-            .collect()
-    } else {
-        Vec::new()
-    };
-
-    Ok(items)
+    handle::read_sections(config_json, &["CFG_DFUNC"], |config| {
+        Ok(config.list_distinct_functions())
+    })
 }
 
 /// Set (update) a distinct function
@@ -201,32 +255,9 @@ pub fn set_distinct_function(
     dfunc_code: &str,
     params: SetDistinctFunctionParams,
 ) -> Result<(String, Value), SzConfigError> {
-    let dfunc_code = dfunc_code.to_uppercase();
-
-    // Find existing function
-    let mut function = find_in_config_array(config_json, "CFG_DFUNC", "DFUNC_CODE", &dfunc_code)?
-        .ok_or_else(|| {
-        SzConfigError::not_found(format!("Distinct function not found: {}", dfunc_code))
-    })?;
-
-    // Update fields if provided
-    if let Some(obj) = function.as_object_mut() {
-        if let Some(conn) = params.connect_str {
-            obj.insert("CONNECT_STR".to_string(), json!(conn));
-        }
-        if let Some(desc) = params.description {
-            obj.insert("DFUNC_DESC".to_string(), json!(desc));
-        }
-        if let Some(lang) = params.language {
-            obj.insert("LANGUAGE".to_string(), json!(lang));
-        }
-    }
-
-    // Delete old and add updated
-    let temp_json = delete_from_config_array(config_json, "CFG_DFUNC", "DFUNC_CODE", &dfunc_code)?;
-    let modified_json = add_to_config_array(&temp_json, "CFG_DFUNC", function.clone())?;
-
-    Ok((modified_json, function))
+    handle::edit_returning(config_json, |config| {
+        config.set_distinct_function(dfunc_code, params)
+    })
 }
 
 #[cfg(test)]
@@ -4,9 +4,7 @@
 //! in the Senzing configuration JSON.
 
 use crate::error::SzConfigError;
-use crate::helpers::{
-    add_to_config_array, delete_from_config_array, find_in_config_array, get_next_id,
-};
+use crate::handle::{self, ConfigHandle};
 use serde_json::{Value, json};
 
 // ============================================================================
@@ -44,6 +42,127 @@ pub struct SetExpressionFunctionParams<'a> {
     pub language: Option<&'a str>,
 }
 
+impl ConfigHandle {
+    /// Add a new expression function (in-place form of [`add_expression_function`])
+    ///
+    /// Returns the new function record.
+    pub fn add_expression_function(
+        &mut self,
+        efunc_code: &str,
+        params: AddExpressionFunctionParams,
+    ) -> Result<Value, SzConfigError> {
+        let efunc_code = efunc_code.to_uppercase();
+
+        // Check if function already exists
+        if self
+            .find_in_config_array("CFG_EFUNC", "EFUNC_CODE", &efunc_code)
+            .is_some()
+        {
+            return Err(SzConfigError::validation(format!(
+                "Expression function already exists: {}",
+                efunc_code
+            )));
+        }
+
+        // Get next EFUNC_ID
+        let efunc_id = self.next_id("CFG_EFUNC", "EFUNC_ID", Some(1))?;
+
+        // Create new function record
+        let mut new_record = json!({
+            "EFUNC_ID": efunc_id,
+            "EFUNC_CODE": efunc_code,
+            "CONNECT_STR": params.connect_str,
+        });
+
+        // Add optional fields
+        if let Some(obj) = new_record.as_object_mut() {
+            if let Some(desc) = params.description {
+                obj.insert("EFUNC_DESC".to_string(), json!(desc));
+            }
+            if let Some(lang) = params.language {
+                obj.insert("LANGUAGE".to_string(), json!(lang));
+            }
+        }
+
+        // Add to CFG_EFUNC
+        self.add_to_config_array("CFG_EFUNC", new_record.clone())?;
+
+        Ok(new_record)
+    }
+
+    /// Delete an expression function by code (in-place form of [`delete_expression_function`])
+    ///
+    /// Returns the deleted function record.
+    pub fn delete_expression_function(&mut self, efunc_code: &str) -> Result<Value, SzConfigError> {
+        let function = self.get_expression_function(efunc_code)?;
+
+        // Delete from CFG_EFUNC
+        self.delete_from_config_array("CFG_EFUNC", "EFUNC_CODE", &efunc_code.to_uppercase())?;
+
+        Ok(function)
+    }
+
+    /// Get an expression function by code (see [`get_expression_function`])
+    pub fn get_expression_function(&self, efunc_code: &str) -> Result<Value, SzConfigError> {
+        let efunc_code = efunc_code.to_uppercase();
+
+        self.find_in_config_array("CFG_EFUNC", "EFUNC_CODE", &efunc_code)
+            .cloned()
+            .ok_or_else(|| {
+                SzConfigError::not_found(format!("Expression function not found: {}", efunc_code))
+            })
+    }
+
+    /// List all expression functions in display format (see [`list_expression_functions`])
+    pub fn list_expression_functions(&self) -> Vec<Value> {
+        self.section("CFG_EFUNC")
+            .map(|items| {
+                items
+                    .iter()
+                    .map(|item| {
+                        json!({
+                            "id": item.get("EFUNC_ID").and_then(|v| v.as_i64()).unwrap_or(0),
+                            "function": item.get("EFUNC_CODE").and_then(|v| v.as_str()).unwrap_or(""),
+                            "connectStr": item.get("CONNECT_STR").and_then(|v| v.as_str()).unwrap_or(""),
+                            "language": item.get("LANGUAGE").and_then(|v| v.as_str()).unwrap_or("")
+                        })
+                    })
+                    .collect()
+            })
+            .unwrap_or_default()
+    }
+
+    /// Set (update) an expression function (in-place form of [`set_expression_function`])
+    ///
+    /// Returns the updated function record.
+    pub fn set_expression_function(
+        &mut self,
+        efunc_code: &str,
+        params: SetExpressionFunctionParams,
+    ) -> Result<Value, SzConfigError> {
+        let mut function = self.get_expression_function(efunc_code)?;
+
+        // Update fields if provided
+        if let Some(obj) = function.as_object_mut() {
+            if let Some(conn) = params.connect_str {
+                obj.insert("CONNECT_STR".to_string(), json!(conn));
+            }
+            if let Some(desc) = params.description {
+                obj.insert("EFUNC_DESC".to_string(), json!(desc));
+            }
+            if let Some(lang) = params.language {
+                obj.insert("LANGUAGE".to_string(), json!(lang));
+            }
+        }
+
+        // Delete old and add updated
+        self.delete_from_config_array("CFG_EFUNC", "EFUNC_CODE", &efunc_code.to_uppercase())?;
+        self.add_to_config_array("CFG_EFUNC", function.clone())?;
+
+        Ok(function)
+    }
+}
+
 /// Add a new expression function
 ///
 /// # Arguments
@@ -61,42 +180,9 @@ pub fn add_expression_function(
     efunc_code: &str,
     params: AddExpressionFunctionParams,
 ) -> Result<(String, Value), SzConfigError> {
-    let efunc_code = efunc_code.to_uppercase();
-
-    // Check if function already exists
-    if find_in_config_array(config_json, "CFG_EFUNC", "EFUNC_CODE", &efunc_code)?.is_some() {
-        return Err(SzConfigError::validation(format!(
-            "Expression function already exists: {}",
-            efunc_code
-        )));
-    }
-
-    // Get next EFUNC_ID
-    let config_data: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::json_parse(e.to_string()))?;
-    let efunc_id = get_next_id(&config_data, "G2_CONFIG.CFG_EFUNC", "EFUNC_ID", 1)?;
-
-    // Create new function record
-    let mut new_record = json!({
-        "EFUNC_ID": efunc_id,
-        "EFUNC_CODE": efunc_code,
-        "CONNECT_STR": params.connect_str,
-    });
-
-    // Add optional fields
-    if let Some(obj) = new_record.as_object_mut() {
-        if let Some(desc) = params.description {
-            obj.insert("EFUNC_DESC".to_string(), json!(desc));
-        }
-        if let Some(lang) = params.language {
-            obj.insert("LANGUAGE".to_string(), json!(lang));
-        }
-    }
-
-    // Add to CFG_EFUNC
-    let modified_json = add_to_config_array(config_json, "CFG_EFUNC", new_record.clone())?;
-
-    Ok((modified_json, new_record))
+    handle::edit_returning(config_json, |config| {
+        config.add_expression_function(efunc_code, params)
+    })
 }
 
 /// Delete an expression function by code
@@ -114,19 +200,9 @@ pub fn delete_expression_function(
     config_json: &str,
     efunc_code: &str,
 ) -> Result<(String, Value), SzConfigError> {
-    let efunc_code = efunc_code.to_uppercase();
-
-    // Find the function
-    let function = find_in_config_array(config_json, "CFG_EFUNC", "EFUNC_CODE", &efunc_code)?
-        .ok_or_else(|| {
-            SzConfigError::not_found(format!("Expression function not found: {}", efunc_code))
-        })?;
-
-    // Delete from CFG_EFUNC
-    let modified_json =
-        delete_from_config_array(config_json, "CFG_EFUNC", "EFUNC_CODE", &efunc_code)?;
-
-    Ok((modified_json, function))
+    handle::edit_returning(config_json, |config| {
+        config.delete_expression_function(efunc_code)
+    })
 }
 
 /// Get an expression function by code
@@ -144,10 +220,8 @@ pub fn get_expression_function(
     config_json: &str,
     efunc_code: &str,
 ) -> Result<Value, SzConfigError> {
-    let efunc_code = efunc_code.to_uppercase();
-
-    find_in_config_array(config_json, "CFG_EFUNC", "EFUNC_CODE", &efunc_code)?.ok_or_else(|| {
-        SzConfigError::not_found(format!("Expression function not found: {}", efunc_code))
+    handle::read_sections(config_json, &["CFG_EFUNC"], |config| {
+        config.get_expression_function(efunc_code)
     })
 }
 
@@ -162,29 +236,9 @@ pub fn get_expression_function(
 /// # Errors
 /// Returns error if JSON is invalid
 pub fn list_expression_functions(config_json: &str) -> Result<Vec<Value>, SzConfigError> {
-    let config_data: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::json_parse(e.to_string()))?;
-
-    let items: Vec<Value> = if let Some(g2_config) = config_data.get("G2_CONFIG")
-        && let Some(array) = g2_config.get("CFG_EFUNC")
-        && let Some(items) = array.as_array()
-    {
-        items
-            .iter()
-            .map(|item| {
-                json!({
-                    "id": item.get("EFUNC_ID").and_then(|v| v.as_i64()).unwrap_or(0),
-                    "function": item.get("EFUNC_CODE").and_then(|v| v.as_str()).unwrap_or(""),
-                    "connectStr": item.get("CONNECT_STR").and_then(|v| v.as_str()).unwrap_or(""),
-                    "language": item.get("LANGUAGE").and_then(|v| v.as_str()).unwrap_or("")
-                })
-            })
-            .collect()
-    } else {
-        Vec::new()
-    };
-
-    Ok(items)
+    handle::read_sections(config_json, &["CFG_EFUNC"], |config| {
+        Ok(config.list_expression_functions())
+    })
 }
 
 /// Set (update) an expression function
@@ -204,32 +258,9 @@ pub fn set_expression_function(
     efunc_code: &str,
     params: SetExpressionFunctionParams,
 ) -> Result<(String, Value), SzConfigError> {
-    let efunc_code = efunc_code.to_uppercase();
-
-    // Find existing function
-    let mut function = find_in_config_array(config_json, "CFG_EFUNC", "EFUNC_CODE", &efunc_code)?
-        .ok_or_else(|| {
-        SzConfigError::not_found(format!("Expression function not found: {}", efunc_code))
-    })?;
-
-    // Update fields if provided
-    if let Some(obj) = function.as_object_mut() {
-        if let Some(conn) = params.connect_str {
-            obj.insert("CONNECT_STR".to_string(), json!(conn));
-        }
-        if let Some(desc) = params.description {
-            obj.insert("EFUNC_DESC".to_string(), json!(desc));
-        }
-        if let Some(lang) = params.language {
-            obj.insert("LANGUAGE".to_string(), json!(lang));
-        }
-    }
-
-    // Delete old and add updated
-    let temp_json = delete_from_config_array(config_json, "CFG_EFUNC", "EFUNC_CODE", &efunc_code)?;
-    let modified_json = add_to_config_array(&temp_json, "CFG_EFUNC", function.clone())?;
-
-    Ok((modified_json, function))
+    handle::edit_returning(config_json, |config| {
+        config.set_expression_function(efunc_code, params)
+    })
 }
 
 #[cfg(test)]
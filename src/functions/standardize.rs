@@ -4,9 +4,7 @@
 //! in the Senzing configuration JSON.
 
 use crate::error::SzConfigError;
-use crate::helpers::{
-    add_to_config_array, delete_from_config_array, find_in_config_array, get_next_id,
-};
+use crate::handle::{self, ConfigHandle};
 use serde_json::{Value, json};
 
 // ============================================================================
@@ -44,6 +42,130 @@ pub struct SetStandardizeFunctionParams<'a> {
     pub language: Option<&'a str>,
 }
 
+impl ConfigHandle {
+    /// Add a new standardize function (in-place form of [`add_standardize_function`])
+    ///
+    /// Returns the new function record.
+    pub fn add_standardize_function(
+        &mut self,
+        sfunc_code: &str,
+        params: AddStandardizeFunctionParams,
+    ) -> Result<Value, SzConfigError> {
+        let sfunc_code = sfunc_code.to_uppercase();
+
+        // Check if function already exists
+        if self
+            .find_in_config_array("CFG_SFUNC", "SFUNC_CODE", &sfunc_code)
+            .is_some()
+        {
+            return Err(SzConfigError::validation(format!(
+                "Standardize function already exists: {}",
+                sfunc_code
+            )));
+        }
+
+        // Get next SFUNC_ID
+        let sfunc_id = self.next_id("CFG_SFUNC", "SFUNC_ID", Some(1))?;
+
+        // Create new function record
+        let mut new_record = json!({
+            "SFUNC_ID": sfunc_id,
+            "SFUNC_CODE": sfunc_code,
+            "CONNECT_STR": params.connect_str,
+        });
+
+        // Add optional fields
+        if let Some(obj) = new_record.as_object_mut() {
+            if let Some(desc) = params.description {
+                obj.insert("SFUNC_DESC".to_string(), json!(desc));
+            }
+            if let Some(lang) = params.language {
+                obj.insert("LANGUAGE".to_string(), json!(lang));
+            }
+        }
+
+        // Add to CFG_SFUNC
+        self.add_to_config_array("CFG_SFUNC", new_record.clone())?;
+
+        Ok(new_record)
+    }
+
+    /// Delete a standardize function by code (in-place form of [`delete_standardize_function`])
+    ///
+    /// Returns the deleted function record.
+    pub fn delete_standardize_function(
+        &mut self,
+        sfunc_code: &str,
+    ) -> Result<Value, SzConfigError> {
+        let function = self.get_standardize_function(sfunc_code)?;
+
+        // Delete from CFG_SFUNC
+        self.delete_from_config_array("CFG_SFUNC", "SFUNC_CODE", &sfunc_code.to_uppercase())?;
+
+        Ok(function)
+    }
+
+    /// Get a standardize function by code (see [`get_standardize_function`])
+    pub fn get_standardize_function(&self, sfunc_code: &str) -> Result<Value, SzConfigError> {
+        let sfunc_code = sfunc_code.to_uppercase();
+
+        self.find_in_config_array("CFG_SFUNC", "SFUNC_CODE", &sfunc_code)
+            .cloned()
+            .ok_or_else(|| {
+                SzConfigError::not_found(format!("Standardize function not found: {}", sfunc_code))
+            })
+    }
+
+    /// List all standardize functions in display format (see [`list_standardize_functions`])
+    pub fn list_standardize_functions(&self) -> Vec<Value> {
+        self.section("CFG_SFUNC")
+            .map(|items| {
+                items
+                    .iter()
+                    .map(|item| {
+                        json!({
+                            "id": item.get("SFUNC_ID").and_then(|v| v.as_i64()).unwrap_or(0),
+                            "function": item.get("SFUNC_CODE").and_then(|v| v.as_str()).unwrap_or(""),
+                            "connectStr": item.get("CONNECT_STR").and_then(|v| v.as_str()).unwrap_or(""),
+                            "language": item.get("LANGUAGE").and_then(|v| v.as_str()).unwrap_or("")
+                        })
+                    })
+                    .collect()
+            })
+            .unwrap_or_default()
+    }
+
+    /// Set (update) a standardize function (in-place form of [`set_standardize_function`])
+    ///
+    /// Returns the updated function record.
+    pub fn set_standardize_function(
+        &mut self,
+        sfunc_code: &str,
+        params: SetStandardizeFunctionParams,
+    ) -> Result<Value, SzConfigError> {
+        let mut function = self.get_standardize_function(sfunc_code)?;
+
+        // Update fields if provided
+        if let Some(obj) = function.as_object_mut() {
+            if let Some(conn) = params.connect_str {
+                obj.insert("CONNECT_STR".to_string(), json!(conn));
+            }
+            if let Some(desc) = params.description {
+                obj.insert("SFUNC_DESC".to_string(), json!(desc));
+            }
+            if let Some(lang) = params.language {
+                obj.insert("LANGUAGE".to_string(), json!(lang));
+            }
+        }
+
+        // Delete old and add updated
+        self.delete_from_config_array("CFG_SFUNC", "SFUNC_CODE", &sfunc_code.to_uppercase())?;
+        self.add_to_config_array("CFG_SFUNC", function.clone())?;
+
+        Ok(function)
+    }
+}
+
 /// Add a new standardize function
 ///
 /// # Arguments
@@ -61,42 +183,9 @@ pub fn add_standardize_function(
     sfunc_code: &str,
     params: AddStandardizeFunctionParams,
 ) -> Result<(String, Value), SzConfigError> {
-    let sfunc_code = sfunc_code.to_uppercase();
-
-    // Check if function already exists
-    if find_in_config_array(config_json, "CFG_SFUNC", "SFUNC_CODE", &sfunc_code)?.is_some() {
-        return Err(SzConfigError::validation(format!(
-            "Standardize function already exists: {}",
-            sfunc_code
-        )));
-    }
-
-    // Get next SFUNC_ID
-    let config_data: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::json_parse(e.to_string()))?;
-    let sfunc_id = get_next_id(&config_data, "G2_CONFIG.CFG_SFUNC", "SFUNC_ID", 1)?;
-
-    // Create new function record
-    let mut new_record = json!({
-        "SFUNC_ID": sfunc_id,
-        "SFUNC_CODE": sfunc_code,
-        "CONNECT_STR": params.connect_str,
-    });
-
-    // Add optional fields
-    if let Some(obj) = new_record.as_object_mut() {
-        if let Some(desc) = params.description {
-            obj.insert("SFUNC_DESC".to_string(), json!(desc));
-        }
-        if let Some(lang) = params.language {
-            obj.insert("LANGUAGE".to_string(), json!(lang));
-        }
-    }
-
-    // Add to CFG_SFUNC
-    let modified_json = add_to_config_array(config_json, "CFG_SFUNC", new_record.clone())?;
-
-    Ok((modified_json, new_record))
+    handle::edit_returning(config_json, |config| {
+        config.add_standardize_function(sfunc_code, params)
+    })
 }
 
 /// Delete a standardize function by code
@@ -114,19 +203,9 @@ pub fn delete_standardize_function(
     config_json: &str,
     sfunc_code: &str,
 ) -> Result<(String, Value), SzConfigError> {
-    let sfunc_code = sfunc_code.to_uppercase();
-
-    // Find the function
-    let function = find_in_config_array(config_json, "CFG_SFUNC", "SFUNC_CODE", &sfunc_code)?
-        .ok_or_else(|| {
-            SzConfigError::not_found(format!("Standardize function not found: {}", sfunc_code))
-        })?;
-
-    // Delete from CFG_SFUNC
-    let modified_json =
-        delete_from_config_array(config_json, "CFG_SFUNC", "SFUNC_CODE", &sfunc_code)?;
-
-    Ok((modified_json, function))
+    handle::edit_returning(config_json, |config| {
+        config.delete_standardize_function(sfunc_code)
+    })
 }
 
 /// Get a standardize function by code
@@ -144,10 +223,8 @@ pub fn get_standardize_function(
     config_json: &str,
     sfunc_code: &str,
 ) -> Result<Value, SzConfigError> {
-    let sfunc_code = sfunc_code.to_uppercase();
-
-    find_in_config_array(config_json, "CFG_SFUNC", "SFUNC_CODE", &sfunc_code)?.ok_or_else(|| {
-        SzConfigError::not_found(format!("Standardize function not found: {}", sfunc_code))
+    handle::read_sections(config_json, &["CFG_SFUNC"], |config| {
+        config.get_standardize_function(sfunc_code)
     })
 }
 
@@ -162,29 +239,9 @@ pub fn get_standardize_function(
 /// # Errors
 /// Returns error if JSON is invalid
 pub fn list_standardize_functions(config_json: &str) -> Result<Vec<Value>, SzConfigError> {
-    let config_data: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::json_parse(e.to_string()))?;
-
-    let items: Vec<Value> = if let Some(g2_config) = config_data.get("G2_CONFIG")
-        && let Some(array) = g2_config.get("CFG_SFUNC")
-        && let Some(items) = array.as_array()
-    {
-        items
-            .iter()
-            .map(|item| {
-                json!({
-                    "id": item.get("SFUNC_ID").and_then(|v| v.as_i64()).unwrap_or(0),
-                    "function": item.get("SFUNC_CODE").and_then(|v| v.as_str()).unwrap_or(""),
-                    "connectStr": item.get("CONNECT_STR").and_then(|v| v.as_str()).unwrap_or(""),
-                    "language": item.get("LANGUAGE").and_then(|v| v.as_str()).unwrap_or("")
-                })
-            })
-            .collect()
-    } else {
-        Vec::new()
-    };
-
-    Ok(items)
+    handle::read_sections(config_json, &["CFG_SFUNC"], |config| {
+        Ok(config.list_standardize_functions())
+    })
 }
 
 /// Set (update) a standardize function
@@ -204,32 +261,9 @@ pub fn set_standardize_function(
     sfunc_code: &str,
     params: SetStandardizeFunctionParams,
 ) -> Result<(String, Value), SzConfigError> {
-    let sfunc_code = sfunc_code.to_uppercase();
-
-    // Find existing function
-    let mut function = find_in_config_array(config_json, "CFG_SFUNC", "SFUNC_CODE", &sfunc_code)?
-        .ok_or_else(|| {
-        SzConfigError::not_found(format!("Standardize function not found: {}", sfunc_code))
-    })?;
-
-    // Update fields if provided
-    if let Some(obj) = function.as_object_mut() {
-        if let Some(conn) = params.connect_str {
-            obj.insert("CONNECT_STR".to_string(), json!(conn));
-        }
-        if let Some(desc) = params.description {
-            obj.insert("SFUNC_DESC".to_string(), json!(desc));
-        }
-        if let Some(lang) = params.language {
-            obj.insert("LANGUAGE".to_string(), json!(lang));
-        }
-    }
-
-    // Delete old and add updated
-    let temp_json = delete_from_config_array(config_json, "CFG_SFUNC", "SFUNC_CODE", &sfunc_code)?;
-    let modified_json = add_to_config_array(&temp_json, "CFG_SFUNC", function.clone())?;
-
-    Ok((modified_json, function))
+    handle::edit_returning(config_json, |config| {
+        config.set_standardize_function(sfunc_code, params)
+    })
 }
 
 #[cfg(test)]
@@ -4,9 +4,297 @@
 //! Generic plans contain thresholds for entity resolution scoring.
 
 use crate::error::{Result, SzConfigError};
-use crate::helpers;
+use crate::handle::{self, ConfigHandle};
+use crate::thresholds::lookup_threshold_ftype_id;
 use serde_json::{Value, json};
 
+/// A threshold row to set on a plan built by [`ConfigHandle::build_generic_plan`]
+///
+/// Rows are matched by behavior and feature. An override of an existing row
+/// changes only the given fields; an override without a matching row adds
+/// one and needs all three of `candidate_cap`, `scoring_cap` and `send_to_redo`.
+#[derive(Debug, Clone, Default)]
+pub struct GenericThresholdOverride<'a> {
+    pub behavior: &'a str,
+    /// Feature code (None or "ALL" for the plan-wide row)
+    pub feature: Option<&'a str>,
+    pub candidate_cap: Option<i64>,
+    pub scoring_cap: Option<i64>,
+    pub send_to_redo: Option<&'a str>,
+}
+
+impl<'a> TryFrom<&'a Value> for GenericThresholdOverride<'a> {
+    type Error = SzConfigError;
+
+    fn try_from(json: &'a Value) -> Result<Self> {
+        Ok(Self {
+            behavior: json
+                .get("behavior")
+                .and_then(|v| v.as_str())
+                .ok_or_else(|| SzConfigError::MissingField("behavior".to_string()))?,
+            feature: json.get("feature").and_then(|v| v.as_str()),
+            candidate_cap: json.get("candidateCap").and_then(|v| v.as_i64()),
+            scoring_cap: json.get("scoringCap").and_then(|v| v.as_i64()),
+            send_to_redo: json.get("sendToRedo").and_then(|v| v.as_str()),
+        })
+    }
+}
+
+impl ConfigHandle {
+    /// Clone a generic plan with all its thresholds (in-place form of [`clone_generic_plan`])
+    ///
+    /// Returns the new plan ID.
+    pub fn clone_generic_plan(
+        &mut self,
+        source_gplan_code: &str,
+        new_gplan_code: &str,
+        new_gplan_desc: Option<&str>,
+    ) -> Result<i64> {
+        self.build_generic_plan(source_gplan_code, new_gplan_code, new_gplan_desc, &[])
+    }
+
+    /// Clone a generic plan and apply threshold overrides to the copy
+    /// (in-place form of [`build_generic_plan`])
+    ///
+    /// Returns the new plan ID.
+    pub fn build_generic_plan(
+        &mut self,
+        source_gplan_code: &str,
+        new_gplan_code: &str,
+        new_gplan_desc: Option<&str>,
+        overrides: &[GenericThresholdOverride],
+    ) -> Result<i64> {
+        let source_code = source_gplan_code.to_uppercase();
+        let new_code = new_gplan_code.to_uppercase();
+        let new_desc = new_gplan_desc.unwrap_or(&new_code);
+
+        let source_gplan_id = self
+            .lookup_id("CFG_GPLAN", "GPLAN_CODE", "GPLAN_ID", &source_code)
+            .ok_or_else(|| {
+                SzConfigError::NotFound(format!("Source generic plan not found: {}", source_code))
+            })?;
+
+        if self.has_code("CFG_GPLAN", "GPLAN_CODE", "GPLAN_ID", &new_code) {
+            return Err(SzConfigError::AlreadyExists(format!(
+                "Generic plan already exists: {}",
+                new_code
+            )));
+        }
+
+        let new_gplan_id = self.next_id("CFG_GPLAN", "GPLAN_ID", None)?;
+
+        // Build the new plan's rows aside, so nothing changes if an override fails
+        let mut thresholds: Vec<Value> = match self.section("CFG_GENERIC_THRESHOLD") {
+            Ok(rows) => rows
+                .iter()
+                .filter(|item| {
+                    item.get("GPLAN_ID").and_then(|v| v.as_i64()) == Some(source_gplan_id)
+                })
+                .map(|item| {
+                    let mut cloned = item.clone();
+                    if let Some(obj) = cloned.as_object_mut() {
+                        obj.insert("GPLAN_ID".to_string(), json!(new_gplan_id));
+                    }
+                    cloned
+                })
+                .collect(),
+            Err(_) if overrides.is_empty() => Vec::new(),
+            Err(e) => return Err(e),
+        };
+        for threshold in overrides {
+            apply_threshold_override(self, &mut thresholds, new_gplan_id, threshold)?;
+        }
+
+        self.add_to_config_array(
+            "CFG_GPLAN",
+            json!({
+                "GPLAN_ID": new_gplan_id,
+                "GPLAN_CODE": new_code,
+                "GPLAN_DESC": new_desc
+            }),
+        )?;
+        if !thresholds.is_empty() {
+            self.section_mut("CFG_GENERIC_THRESHOLD")?
+                .extend(thresholds);
+        }
+
+        Ok(new_gplan_id)
+    }
+
+    /// Delete a generic plan and all its thresholds (in-place form of [`delete_generic_plan`])
+    pub fn delete_generic_plan(&mut self, gplan_code: &str) -> Result<()> {
+        let gplan_code = gplan_code.to_uppercase();
+
+        // Find the plan
+        let plan = self
+            .find_in_config_array("CFG_GPLAN", "GPLAN_CODE", &gplan_code)
+            .ok_or_else(|| {
+                SzConfigError::NotFound(format!("Generic plan not found: {}", gplan_code))
+            })?;
+
+        let gplan_id = plan
+            .get("GPLAN_ID")
+            .and_then(|v| v.as_i64())
+            .ok_or_else(|| SzConfigError::InvalidConfig("Invalid GPLAN_ID".to_string()))?;
+
+        // Delete the plan
+        if let Ok(gplan_array) = self.section_mut("CFG_GPLAN") {
+            gplan_array
+                .retain(|item| item.get("GPLAN_ID").and_then(|v| v.as_i64()) != Some(gplan_id));
+        }
+
+        // Delete all associated thresholds
+        if let Ok(gthresh_array) = self.section_mut("CFG_GENERIC_THRESHOLD") {
+            gthresh_array
+                .retain(|item| item.get("GPLAN_ID").and_then(|v| v.as_i64()) != Some(gplan_id));
+        }
+
+        Ok(())
+    }
+
+    /// List all generic plans (see [`list_generic_plans`])
+    pub fn list_generic_plans(&self, filter: Option<&str>) -> Vec<Value> {
+        // Transform and filter items from CFG_GPLAN
+        let mut result: Vec<Value> = self
+            .section("CFG_GPLAN")
+            .map(|items| items.as_slice())
+            .unwrap_or_default()
+            .iter()
+            .filter(|item| {
+                if let Some(f) = filter {
+                    // Filter if search term appears anywhere in the record
+                    let item_str = item.to_string().to_lowercase();
+                    item_str.contains(&f.to_lowercase())
+                } else {
+                    true
+                }
+            })
+            .map(|item| {
+                json!({
+                    "id": item.get("GPLAN_ID").and_then(|v| v.as_i64()).unwrap_or(0),
+                    "plan": item.get("GPLAN_CODE").and_then(|v| v.as_str()).unwrap_or(""),
+                    "description": item.get("GPLAN_DESC").and_then(|v| v.as_str()).unwrap_or("")
+                })
+            })
+            .collect();
+
+        // Sort by ID
+        result.sort_by_key(|item| item.get("id").and_then(|v| v.as_i64()).unwrap_or(0));
+
+        result
+    }
+
+    /// Set (create or update) a generic plan (in-place form of [`set_generic_plan`])
+    ///
+    /// Returns `(plan_id, was_created)`.
+    pub fn set_generic_plan(&mut self, gplan_code: &str, gplan_desc: &str) -> Result<(i64, bool)> {
+        let code = gplan_code.to_uppercase();
+
+        // Check if plan already exists
+        if let Some(existing) = self.find_in_config_array("CFG_GPLAN", "GPLAN_CODE", &code) {
+            // Update existing plan
+            let plan_id = existing
+                .get("GPLAN_ID")
+                .and_then(|v| v.as_i64())
+                .unwrap_or(0);
+            let mut updated = existing.clone();
+            if let Some(obj) = updated.as_object_mut() {
+                obj.insert("GPLAN_DESC".to_string(), json!(gplan_desc));
+            }
+            self.update_in_config_array("CFG_GPLAN", "GPLAN_CODE", &code, updated)?;
+            Ok((plan_id, false))
+        } else {
+            // Create new plan
+            let new_id = next_gplan_id(self);
+            self.add_to_config_array(
+                "CFG_GPLAN",
+                json!({
+                    "GPLAN_ID": new_id,
+                    "GPLAN_CODE": code,
+                    "GPLAN_DESC": gplan_desc
+                }),
+            )?;
+            Ok((new_id, true))
+        }
+    }
+}
+
+/// Update or add the row of `thresholds` an override targets
+fn apply_threshold_override(
+    config: &ConfigHandle,
+    thresholds: &mut Vec<Value>,
+    gplan_id: i64,
+    threshold: &GenericThresholdOverride,
+) -> Result<()> {
+    let behavior = threshold.behavior.to_uppercase();
+    let feature = threshold.feature.unwrap_or("ALL").to_uppercase();
+    let ftype_id = lookup_threshold_ftype_id(config, &feature)?;
+
+    let redo = threshold.send_to_redo.map(str::to_uppercase);
+    if let Some(redo) = &redo
+        && redo != "YES"
+        && redo != "NO"
+    {
+        return Err(SzConfigError::InvalidInput(format!(
+            "Invalid sendToRedo value '{}'. Must be 'Yes' or 'No'",
+            redo
+        )));
+    }
+
+    let existing = thresholds.iter_mut().find(|record| {
+        record["BEHAVIOR"].as_str() == Some(behavior.as_str())
+            && record["FTYPE_ID"].as_i64() == Some(ftype_id)
+    });
+    match existing {
+        Some(record) => {
+            if let Some(obj) = record.as_object_mut() {
+                if let Some(cap) = threshold.candidate_cap {
+                    obj.insert("CANDIDATE_CAP".to_string(), json!(cap));
+                }
+                if let Some(cap) = threshold.scoring_cap {
+                    obj.insert("SCORING_CAP".to_string(), json!(cap));
+                }
+                if let Some(redo) = redo {
+                    obj.insert("SEND_TO_REDO".to_string(), json!(redo));
+                }
+            }
+        }
+        None => {
+            let (Some(candidate_cap), Some(scoring_cap), Some(redo)) =
+                (threshold.candidate_cap, threshold.scoring_cap, redo)
+            else {
+                return Err(SzConfigError::MissingField(format!(
+                    "candidateCap, scoringCap and sendToRedo for new threshold: behavior={}, feature={}",
+                    behavior, feature
+                )));
+            };
+            thresholds.push(json!({
+                "GPLAN_ID": gplan_id,
+                "BEHAVIOR": behavior,
+                "FTYPE_ID": ftype_id,
+                "CANDIDATE_CAP": candidate_cap,
+                "SCORING_CAP": scoring_cap,
+                "SEND_TO_REDO": redo
+            }));
+        }
+    }
+    Ok(())
+}
+
+/// Next free GPLAN_ID (max + 1, or 1 for an empty or missing CFG_GPLAN)
+fn next_gplan_id(config: &ConfigHandle) -> i64 {
+    config
+        .section("CFG_GPLAN")
+        .map(|arr| {
+            arr.iter()
+                .filter_map(|item| item.get("GPLAN_ID").and_then(|v| v.as_i64()))
+                .max()
+                .unwrap_or(0)
+        })
+        .unwrap_or(0)
+        + 1
+}
+
 /// Clone a generic plan with all its thresholds
 ///
 /// # Arguments
@@ -34,83 +322,75 @@ pub fn clone_generic_plan(
     new_gplan_code: &str,
     new_gplan_desc: Option<&str>,
 ) -> Result<(String, i64)> {
-    let source_code = source_gplan_code.to_uppercase();
-    let new_code = new_gplan_code.to_uppercase();
-    let new_desc = new_gplan_desc.unwrap_or(&new_code);
-
-    // Find source plan
-    let source_plan =
-        helpers::find_in_config_array(config_json, "CFG_GPLAN", "GPLAN_CODE", &source_code)?
-            .ok_or_else(|| {
-                SzConfigError::NotFound(format!("Source generic plan not found: {}", source_code))
-            })?;
-
-    let source_gplan_id = source_plan
-        .get("GPLAN_ID")
-        .and_then(|v| v.as_i64())
-        .ok_or_else(|| {
-            SzConfigError::InvalidConfig("Invalid GPLAN_ID in source plan".to_string())
-        })?;
-
-    // Check if new plan already exists
-    if helpers::find_in_config_array(config_json, "CFG_GPLAN", "GPLAN_CODE", &new_code)?.is_some() {
-        return Err(SzConfigError::AlreadyExists(format!(
-            "Generic plan already exists: {}",
-            new_code
-        )));
-    }
-
-    // Get next GPLAN_ID
-    let config_data: Value = serde_json::from_str(config_json)?;
-    let max_gplan_id = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_GPLAN"))
-        .and_then(|v| v.as_array())
-        .map(|arr| {
-            arr.iter()
-                .filter_map(|item| item.get("GPLAN_ID").and_then(|v| v.as_i64()))
-                .max()
-                .unwrap_or(0)
-        })
-        .unwrap_or(0);
-
-    let new_gplan_id = max_gplan_id + 1;
-
-    // Create new plan
-    let new_plan = json!({
-        "GPLAN_ID": new_gplan_id,
-        "GPLAN_CODE": new_code,
-        "GPLAN_DESC": new_desc
-    });
-
-    let mut modified_json = helpers::add_to_config_array(config_json, "CFG_GPLAN", new_plan)?;
-
-    // Clone all thresholds from source plan to new plan
-    let config_data: Value = serde_json::from_str(&modified_json)?;
-    if let Some(gthresh_array) = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_GENERIC_THRESHOLD"))
-        .and_then(|v| v.as_array())
-    {
-        let mut cloned_thresholds = Vec::new();
-        for item in gthresh_array {
-            if item.get("GPLAN_ID").and_then(|v| v.as_i64()) == Some(source_gplan_id) {
-                let mut cloned = item.clone();
-                if let Some(obj) = cloned.as_object_mut() {
-                    obj.insert("GPLAN_ID".to_string(), json!(new_gplan_id));
-                }
-                cloned_thresholds.push(cloned);
-            }
-        }
-
-        // Add cloned thresholds
-        for threshold in cloned_thresholds {
-            modified_json =
-                helpers::add_to_config_array(&modified_json, "CFG_GENERIC_THRESHOLD", threshold)?;
-        }
-    }
+    handle::edit_returning(config_json, |config| {
+        config.clone_generic_plan(source_gplan_code, new_gplan_code, new_gplan_desc)
+    })
+}
 
-    Ok((modified_json, new_gplan_id))
+/// Clone a generic plan and customize its thresholds in one pass
+///
+/// Produces the same configuration as [`clone_generic_plan`] followed by an
+/// edit per override, but parses and serializes once. Rows are matched by
+/// behavior and feature: an override of a cloned row changes only the fields
+/// it sets, any other override adds a row. Every override is checked before
+/// the plan is created, so on error nothing changes.
+///
+/// # Arguments
+///
+/// * `config_json` - Configuration JSON string
+/// * `source_gplan_code` - Source plan code to clone from
+/// * `new_gplan_code` - New plan code to create
+/// * `new_gplan_desc` - Optional description for new plan (uses code if None)
+/// * `overrides` - Threshold rows to set on the new plan, applied in order
+///
+/// # Returns
+///
+/// Returns `(modified_config, new_plan_id)` tuple on success
+///
+/// # Errors
+///
+/// * `NotFound` if the source plan or an override's feature doesn't exist
+/// * `AlreadyExists` if the new plan code is taken
+/// * `MissingField` if an override adds a row without both caps and sendToRedo
+/// * `InvalidInput` if sendToRedo is not Yes or No
+///
+/// # Example
+///
+/// ```
+/// use sz_configtool_lib::generic_plans::{self, GenericThresholdOverride};
+///
+/// let config = r#"{"G2_CONFIG": {"CFG_GPLAN": [{"GPLAN_ID": 1, "GPLAN_CODE": "INGEST"}], "CFG_FTYPE": [], "CFG_GENERIC_THRESHOLD": [{"GPLAN_ID": 1, "BEHAVIOR": "NAME", "FTYPE_ID": 0, "CANDIDATE_CAP": 10, "SCORING_CAP": -1, "SEND_TO_REDO": "Yes"}]}}"#;
+/// let overrides = [
+///     GenericThresholdOverride {
+///         behavior: "NAME",
+///         candidate_cap: Some(50),
+///         ..Default::default()
+///     },
+///     GenericThresholdOverride {
+///         behavior: "F1",
+///         candidate_cap: Some(100),
+///         scoring_cap: Some(20),
+///         send_to_redo: Some("No"),
+///         ..Default::default()
+///     },
+/// ];
+/// let (modified, plan_id) =
+///     generic_plans::build_generic_plan(config, "INGEST", "TENANT_A", None, &overrides)?;
+/// assert_eq!(plan_id, 2);
+/// assert!(modified.contains(r#"{"GPLAN_ID":2,"BEHAVIOR":"NAME","FTYPE_ID":0,"CANDIDATE_CAP":50"#));
+/// assert!(modified.contains(r#"{"GPLAN_ID":2,"BEHAVIOR":"F1","FTYPE_ID":0,"CANDIDATE_CAP":100"#));
+/// # Ok::<(), sz_configtool_lib::SzConfigError>(())
+/// ```
+pub fn build_generic_plan(
+    config_json: &str,
+    source_gplan_code: &str,
+    new_gplan_code: &str,
+    new_gplan_desc: Option<&str>,
+    overrides: &[GenericThresholdOverride],
+) -> Result<(String, i64)> {
+    handle::edit_returning(config_json, |config| {
+        config.build_generic_plan(source_gplan_code, new_gplan_code, new_gplan_desc, overrides)
+    })
 }
 
 /// Delete a generic plan and all its thresholds
@@ -133,43 +413,7 @@ pub fn clone_generic_plan(
 /// let modified = generic_plans::delete_generic_plan(config, "TEST").unwrap();
 /// ```
 pub fn delete_generic_plan(config_json: &str, gplan_code: &str) -> Result<String> {
-    let gplan_code = gplan_code.to_uppercase();
-
-    // Find the plan
-    let plan = helpers::find_in_config_array(config_json, "CFG_GPLAN", "GPLAN_CODE", &gplan_code)?
-        .ok_or_else(|| {
-            SzConfigError::NotFound(format!("Generic plan not found: {}", gplan_code))
-        })?;
-
-    let gplan_id = plan
-        .get("GPLAN_ID")
-        .and_then(|v| v.as_i64())
-        .ok_or_else(|| SzConfigError::InvalidConfig("Invalid GPLAN_ID".to_string()))?;
-
-    // Parse and modify config
-    let mut config_data: Value = serde_json::from_str(config_json)?;
-
-    // Delete the plan
-    if let Some(g2_config) = config_data.get_mut("G2_CONFIG") {
-        if let Some(gplan_array) = g2_config
-            .get_mut("CFG_GPLAN")
-            .and_then(|v| v.as_array_mut())
-        {
-            gplan_array
-                .retain(|item| item.get("GPLAN_ID").and_then(|v| v.as_i64()) != Some(gplan_id));
-        }
-
-        // Delete all associated thresholds
-        if let Some(gthresh_array) = g2_config
-            .get_mut("CFG_GENERIC_THRESHOLD")
-            .and_then(|v| v.as_array_mut())
-        {
-            gthresh_array
-                .retain(|item| item.get("GPLAN_ID").and_then(|v| v.as_i64()) != Some(gplan_id));
-        }
-    }
-
-    Ok(serde_json::to_string(&config_data)?)
+    handle::edit(config_json, |config| config.delete_generic_plan(gplan_code))
 }
 
 /// List all generic plans in the configuration
@@ -193,34 +437,9 @@ pub fn delete_generic_plan(config_json: &str, gplan_code: &str) -> Result<String
 /// assert_eq!(plans.len(), 1);
 /// ```
 pub fn list_generic_plans(config_json: &str, filter: Option<&str>) -> Result<Vec<Value>> {
-    // Get all items from CFG_GPLAN
-    let items = helpers::list_from_config_array(config_json, "CFG_GPLAN")?;
-
-    // Transform and filter items
-    let mut result: Vec<Value> = items
-        .into_iter()
-        .filter(|item| {
-            if let Some(f) = filter {
-                // Filter if search term appears anywhere in the record
-                let item_str = item.to_string().to_lowercase();
-                item_str.contains(&f.to_lowercase())
-            } else {
-                true
-            }
-        })
-        .map(|item| {
-            json!({
-                "id": item.get("GPLAN_ID").and_then(|v| v.as_i64()).unwrap_or(0),
-                "plan": item.get("GPLAN_CODE").and_then(|v| v.as_str()).unwrap_or(""),
-                "description": item.get("GPLAN_DESC").and_then(|v| v.as_str()).unwrap_or("")
-            })
-        })
-        .collect();
-
-    // Sort by ID
-    result.sort_by_key(|item| item.get("id").and_then(|v| v.as_i64()).unwrap_or(0));
-
-    Ok(result)
+    handle::read_sections(config_json, &["CFG_GPLAN"], |config| {
+        Ok(config.list_generic_plans(filter))
+    })
 }
 
 /// Set (create or update) a generic plan
@@ -249,52 +468,8 @@ pub fn set_generic_plan(
     gplan_code: &str,
     gplan_desc: &str,
 ) -> Result<(String, i64, bool)> {
-    let code = gplan_code.to_uppercase();
-
-    // Check if plan already exists
-    if let Some(existing) =
-        helpers::find_in_config_array(config_json, "CFG_GPLAN", "GPLAN_CODE", &code)?
-    {
-        // Update existing plan
-        let plan_id = existing
-            .get("GPLAN_ID")
-            .and_then(|v| v.as_i64())
-            .unwrap_or(0);
-        let mut updated = existing.clone();
-        if let Some(obj) = updated.as_object_mut() {
-            obj.insert("GPLAN_DESC".to_string(), json!(gplan_desc));
-        }
-        let modified = helpers::update_in_config_array(
-            config_json,
-            "CFG_GPLAN",
-            "GPLAN_CODE",
-            &code,
-            updated,
-        )?;
-        Ok((modified, plan_id, false))
-    } else {
-        // Create new plan
-        let config_data: Value = serde_json::from_str(config_json)?;
-        let max_id = config_data
-            .get("G2_CONFIG")
-            .and_then(|g| g.get("CFG_GPLAN"))
-            .and_then(|v| v.as_array())
-            .map(|arr| {
-                arr.iter()
-                    .filter_map(|item| item.get("GPLAN_ID").and_then(|v| v.as_i64()))
-                    .max()
-                    .unwrap_or(0)
-            })
-            .unwrap_or(0);
-
-        let new_id = max_id + 1;
-        let new_plan = json!({
-            "GPLAN_ID": new_id,
-            "GPLAN_CODE": code,
-            "GPLAN_DESC": gplan_desc
-        });
-
-        let modified = helpers::add_to_config_array(config_json, "CFG_GPLAN", new_plan)?;
-        Ok((modified, new_id, true))
-    }
+    let (modified, (plan_id, was_created)) = handle::edit_returning(config_json, |config| {
+        config.set_generic_plan(gplan_code, gplan_desc)
+    })?;
+    Ok((modified, plan_id, was_created))
 }
@@ -0,0 +1,941 @@
+//! Parsed configuration handle
+//!
+//! The string-based functions in this crate take `config_json`, parse it,
+//! apply one change and serialize the whole document again. [`ConfigHandle`]
+//! owns the parsed document instead, so a caller making many edits pays for
+//! one parse and one serialize in total.
+//!
+//! Each module adds its operations to `ConfigHandle` as methods with the same
+//! name as the string function, e.g. `datasources::add_data_source(json, params)`
+//! becomes `handle.add_data_source(params)`. The string functions are thin
+//! wrappers around those methods, so both forms always behave identically.
+//!
+//! # Example
+//!
+//! ```
+//! use sz_configtool_lib::datasources::AddDataSourceParams;
+//! use sz_configtool_lib::handle::ConfigHandle;
+//!
+//! let mut config = ConfigHandle::from_json(r#"{"G2_CONFIG":{"CFG_DSRC":[]}}"#)?;
+//! for code in ["CUSTOMERS", "WATCHLIST", "EMPLOYEES"] {
+//!     config.add_data_source(AddDataSourceParams {
+//!         code,
+//!         ..Default::default()
+//!     })?;
+//! }
+//! let json = config.to_json()?;
+//! assert!(json.contains("WATCHLIST"));
+//! # Ok::<(), sz_configtool_lib::SzConfigError>(())
+//! ```
+
+use crate::error::{Result, SzConfigError};
+use crate::index::{self, LookupIndex};
+use crate::serial::SerialCache;
+use crate::snapshot::UndoLog;
+use serde::de::{self, DeserializeSeed, IgnoredAny, MapAccess, SeqAccess, Visitor};
+use serde_json::{Map, Value};
+use std::collections::BTreeSet;
+use std::fmt;
+use std::fs::File;
+use std::io::{BufReader, BufWriter, Read, Write};
+use std::path::Path;
+
+/// A parsed configuration document that can be edited in place
+///
+/// Operations are added by the individual modules (`datasources`, `features`,
+/// `thresholds`, ...). If an operation returns an error the document is left
+/// as it was before the call.
+///
+/// Code → ID lookups (`lookup_feature_id`, ...) are served from an index that
+/// is built on first use and discarded when its section is mutated.
+#[derive(Debug, Clone)]
+pub struct ConfigHandle {
+    root: Value,
+    index: LookupIndex,
+    /// `G2_CONFIG` members mutably accessed since the last
+    /// [`take_touched_sections`](Self::take_touched_sections), when recording
+    touched: Option<BTreeSet<String>>,
+    /// Sections saved for open snapshots (see [`crate::snapshot`])
+    undo: UndoLog,
+    /// Where the members unchanged since parsing sit in the parsed text
+    serialized: SerialCache,
+}
+
+impl ConfigHandle {
+    /// Parse a configuration JSON string into a handle
+    ///
+    /// # Errors
+    /// - `JsonParse` if config_json is invalid
+    pub fn from_json(config_json: &str) -> Result<Self> {
+        let root: Value = serde_json::from_str(config_json)
+            .map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
+        Ok(Self::from_value(root))
+    }
+
+    /// Parse a configuration and keep its text for later serializations
+    ///
+    /// When `config_json` is compact serde_json output (as written by
+    /// [`to_json`](Self::to_json) or [`save_config_file`]), serializing the
+    /// handle copies the bytes of every `G2_CONFIG` member not changed since
+    /// and serializes only the edited ones. The handle holds a shared copy of
+    /// the text until every member has been edited; input in another format
+    /// keeps nothing and is serialized in full. Either way the output is
+    /// identical to serializing the whole document.
+    ///
+    /// # Errors
+    /// - `JsonParse` if config_json is invalid
+    ///
+    /// # Example
+    /// ```
+    /// use sz_configtool_lib::ConfigHandle;
+    /// use sz_configtool_lib::datasources::AddDataSourceParams;
+    ///
+    /// let json = r#"{"G2_CONFIG":{"CFG_DSRC":[],"CFG_FTYPE":[{"FTYPE_ID":1}]}}"#;
+    /// let mut config = ConfigHandle::from_json_cached(json)?;
+    /// config.add_data_source(AddDataSourceParams {
+    ///     code: "TEST",
+    ///     ..Default::default()
+    /// })?;
+    /// // CFG_FTYPE is copied from `json`, CFG_DSRC is serialized again
+    /// assert_eq!(config.to_json()?, serde_json::to_string(config.as_value())?);
+    /// # Ok::<(), sz_configtool_lib::SzConfigError>(())
+    /// ```
+    pub fn from_json_cached(config_json: &str) -> Result<Self> {
+        let mut config = Self::from_json(config_json)?;
+        config.serialized = SerialCache::keeping(config_json);
+        Ok(config)
+    }
+
+    /// Parse `config_json` and record where its members sit, without keeping
+    /// it; pass the same text to [`to_json_from`](Self::to_json_from)
+    pub(crate) fn from_json_with_spans(config_json: &str) -> Result<Self> {
+        let mut config = Self::from_json(config_json)?;
+        config.serialized = SerialCache::scan(config_json);
+        Ok(config)
+    }
+
+    /// Parse a configuration from a reader
+    ///
+    /// Parses directly from the stream, without first reading the whole
+    /// document into a string. Pass a buffered reader (see
+    /// [`open_config_file`]).
+    ///
+    /// # Errors
+    /// - `JsonParse` if the content is invalid or cannot be read
+    pub fn from_reader<R: Read>(reader: R) -> Result<Self> {
+        let root: Value =
+            serde_json::from_reader(reader).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
+        Ok(Self::from_value(root))
+    }
+
+    /// Parse only some `G2_CONFIG` members of a configuration JSON string
+    ///
+    /// The other members (and any other top-level keys) are scanned over and
+    /// checked for syntax without building them, so reading one small section
+    /// of a large configuration costs a byte scan rather than a full parse.
+    /// The handle holds `{"G2_CONFIG": {...}}` with just the requested members,
+    /// in document order.
+    ///
+    /// # Errors
+    /// - `JsonParse` if config_json is invalid
+    ///
+    /// # Example
+    /// ```
+    /// use sz_configtool_lib::ConfigHandle;
+    ///
+    /// let json = r#"{"G2_CONFIG":{"CFG_FTYPE":[{"FTYPE_ID":1}],"CFG_DSRC":[]}}"#;
+    /// let config = ConfigHandle::from_json_sections(json, &["CFG_DSRC"])?;
+    /// assert_eq!(config.to_json()?, r#"{"G2_CONFIG":{"CFG_DSRC":[]}}"#);
+    /// # Ok::<(), sz_configtool_lib::SzConfigError>(())
+    /// ```
+    pub fn from_json_sections(config_json: &str, sections: &[&str]) -> Result<Self> {
+        let mut deserializer = serde_json::Deserializer::from_str(config_json);
+        let root = Selective::Root(sections)
+            .deserialize(&mut deserializer)
+            .and_then(|root| deserializer.end().map(|()| root))
+            .map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
+        Ok(Self::from_value(root))
+    }
+
+    /// Wrap an already parsed configuration document
+    pub fn from_value(root: Value) -> Self {
+        Self {
+            root,
+            index: LookupIndex::default(),
+            touched: None,
+            undo: UndoLog::default(),
+            serialized: SerialCache::default(),
+        }
+    }
+
+    /// Serialize the configuration to a compact JSON string
+    ///
+    /// A handle from [`from_json_cached`](Self::from_json_cached) copies the
+    /// members unchanged since it was parsed; otherwise the whole document is
+    /// serialized.
+    pub fn to_json(&self) -> Result<String> {
+        let mut out = Vec::new();
+        self.serialized
+            .write(&self.root, None, &mut out)
+            .map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
+        String::from_utf8(out).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    }
+
+    /// Serialize a handle from [`from_json_with_spans`](Self::from_json_with_spans),
+    /// copying unchanged members from `config_json`, the text it was parsed from
+    pub(crate) fn to_json_from(&self, config_json: &str) -> Result<String> {
+        let mut out = Vec::with_capacity(config_json.len());
+        self.serialized
+            .write(&self.root, Some(config_json), &mut out)
+            .map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
+        String::from_utf8(out).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    }
+
+    /// Replace `config_json`, the text the handle was parsed from (or last
+    /// synced to), with the current document
+    ///
+    /// Unchanged members are copied from the old text and the spans of the
+    /// new one are recorded, so repeated syncs stay incremental.
+    pub(crate) fn sync_json(&mut self, config_json: &mut String) -> Result<()> {
+        *config_json = self
+            .serialized
+            .rewrite(&self.root, config_json)
+            .map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
+        Ok(())
+    }
+
+    /// Serialize the configuration as compact JSON to a writer
+    ///
+    /// Writes directly to the stream, without building the document as a
+    /// string first, and reuses unchanged members like
+    /// [`to_json`](Self::to_json). Pass a buffered writer (see
+    /// [`save_config_file`]).
+    ///
+    /// # Errors
+    /// - `JsonParse` if serialization or writing fails
+    pub fn to_writer<W: Write>(&self, writer: W) -> Result<()> {
+        self.serialized
+            .write(&self.root, None, writer)
+            .map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    }
+
+    /// Serialize the configuration to an indented JSON string
+    pub fn to_json_pretty(&self) -> Result<String> {
+        serde_json::to_string_pretty(&self.root)
+            .map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    }
+
+    /// Borrow the whole configuration document
+    pub fn as_value(&self) -> &Value {
+        &self.root
+    }
+
+    /// Mutably borrow the whole configuration document
+    pub fn as_value_mut(&mut self) -> &mut Value {
+        self.index.invalidate_all();
+        self.before_write("G2_CONFIG");
+        &mut self.root
+    }
+
+    /// Consume the handle and return the configuration document
+    pub fn into_value(self) -> Value {
+        self.root
+    }
+
+    /// Borrow the `G2_CONFIG` object
+    pub fn g2_config(&self) -> Option<&Map<String, Value>> {
+        self.root.get("G2_CONFIG").and_then(|g| g.as_object())
+    }
+
+    /// Mutably borrow the `G2_CONFIG` object
+    pub fn g2_config_mut(&mut self) -> Option<&mut Map<String, Value>> {
+        self.index.invalidate_all();
+        self.before_write("G2_CONFIG");
+        self.root
+            .get_mut("G2_CONFIG")
+            .and_then(|g| g.as_object_mut())
+    }
+
+    /// Borrow a member of `G2_CONFIG` of any type (e.g. "SYS_OOM")
+    pub fn g2_entry(&self, key: &str) -> Option<&Value> {
+        self.root.get("G2_CONFIG").and_then(|g| g.get(key))
+    }
+
+    /// Mutably borrow a member of `G2_CONFIG` of any type
+    pub fn g2_entry_mut(&mut self, key: &str) -> Option<&mut Value> {
+        self.index.invalidate_section(key);
+        self.before_write(key);
+        self.root.get_mut("G2_CONFIG").and_then(|g| g.get_mut(key))
+    }
+
+    /// Add or replace a `G2_CONFIG` member, leaving the others' caches intact
+    ///
+    /// Returns false if there is no `G2_CONFIG` object.
+    pub(crate) fn insert_member(&mut self, key: &str, value: Value) -> bool {
+        if self.g2_config().is_none() {
+            return false;
+        }
+        self.index.invalidate_section(key);
+        self.before_write(key);
+        self.root
+            .get_mut("G2_CONFIG")
+            .and_then(|g| g.as_object_mut())
+            .map(|g| g.insert(key.to_string(), value))
+            .is_some()
+    }
+
+    /// Remove a `G2_CONFIG` member, keeping the order of the others
+    pub(crate) fn remove_member(&mut self, key: &str) -> Option<Value> {
+        self.g2_entry(key)?;
+        self.index.invalidate_section(key);
+        self.before_write(key);
+        self.root
+            .get_mut("G2_CONFIG")
+            .and_then(|g| g.as_object_mut())
+            .and_then(|g| g.shift_remove(key))
+    }
+
+    /// Borrow a `G2_CONFIG` array section (e.g. "CFG_DSRC")
+    ///
+    /// # Errors
+    /// - `MissingSection` if the section doesn't exist or is not an array
+    pub fn section(&self, name: &str) -> Result<&Vec<Value>> {
+        self.g2_entry(name)
+            .and_then(|v| v.as_array())
+            .ok_or_else(|| SzConfigError::MissingSection(name.to_string()))
+    }
+
+    /// Mutably borrow a `G2_CONFIG` array section
+    ///
+    /// # Errors
+    /// - `MissingSection` if the section doesn't exist or is not an array
+    pub fn section_mut(&mut self, name: &str) -> Result<&mut Vec<Value>> {
+        self.g2_entry_mut(name)
+            .and_then(|v| v.as_array_mut())
+            .ok_or_else(|| SzConfigError::MissingSection(name.to_string()))
+    }
+
+    /// Mutably borrow the whole document to change only the given `G2_CONFIG` members
+    ///
+    /// Unlike [`as_value_mut`](Self::as_value_mut), only the indexes of the
+    /// named sections are discarded. The caller must not modify anything else.
+    pub(crate) fn value_mut_in<'a>(
+        &mut self,
+        sections: impl IntoIterator<Item = &'a str>,
+    ) -> &mut Value {
+        for section in sections {
+            self.index.invalidate_section(section);
+            self.before_write(section);
+        }
+        &mut self.root
+    }
+
+    /// Next ID for a section: one more than the largest `id_field`, and at
+    /// least `min` if given (1 for an empty section without a minimum)
+    ///
+    /// Same result as [`helpers::get_next_id_with_min`](crate::helpers::get_next_id_with_min)
+    /// (or `get_next_id_from_array` without a minimum), but the section is
+    /// scanned only once until it is mutated other than through
+    /// [`push_row`](Self::push_row).
+    ///
+    /// # Errors
+    /// - `MissingSection` if the section doesn't exist or is not an array
+    pub fn next_id(&mut self, section: &str, id_field: &str, min: Option<i64>) -> Result<i64> {
+        let items = Self::array_in(&self.root, section)?;
+        Ok(self.index.ids(section, id_field, items).next(min))
+    }
+
+    /// True if a record of the section already uses the ID
+    ///
+    /// # Errors
+    /// - `MissingSection` if the section doesn't exist or is not an array
+    pub fn is_id_taken(&mut self, section: &str, id_field: &str, id: i64) -> Result<bool> {
+        let items = Self::array_in(&self.root, section)?;
+        Ok(self.index.ids(section, id_field, items).is_taken(id))
+    }
+
+    /// Index a field of an array section for filtered reads
+    ///
+    /// [`get_config_section`](Self::get_config_section) filters with a
+    /// `FIELD=value` condition on an indexed field visit only the matching
+    /// rows instead of the whole section. The index is kept current by
+    /// [`push_row`](Self::push_row) and dropped, like the lookup indexes, on
+    /// any other mutation of the section.
+    ///
+    /// # Errors
+    /// - `MissingSection` if the section doesn't exist or is not an array
+    pub fn index_field(&mut self, section: &str, field: &str) -> Result<()> {
+        let items = Self::array_in(&self.root, section)?;
+        self.index.build_field(section, field, items);
+        Ok(())
+    }
+
+    /// Value index of a section's field, if [`index_field`](Self::index_field) built one
+    pub(crate) fn field_index(&self, section: &str, field: &str) -> Option<&index::FieldIndex> {
+        self.index.field(section, field)
+    }
+
+    /// Append a row to a `G2_CONFIG` array section
+    ///
+    /// Unlike pushing through [`section_mut`](Self::section_mut), the section's
+    /// lookup index and ID allocators are updated with the row instead of
+    /// being discarded, so adding many rows stays linear.
+    ///
+    /// # Errors
+    /// - `MissingSection` if the section doesn't exist or is not an array
+    pub fn push_row(&mut self, section: &str, row: Value) -> Result<()> {
+        let position = Self::array_in(&self.root, section)?.len();
+        self.before_write(section);
+        self.index.row_appended(section, position, &row);
+        self.root["G2_CONFIG"][section]
+            .as_array_mut()
+            .expect("checked above")
+            .push(row);
+        Ok(())
+    }
+
+    /// Remove the rows of a `G2_CONFIG` array section matching `doomed`
+    ///
+    /// The section is mutably accessed (dropping its indexes and saving it
+    /// for open snapshots) only if some row matches. A missing section has
+    /// nothing to remove.
+    ///
+    /// # Returns
+    /// Number of rows removed
+    pub(crate) fn remove_rows<F>(&mut self, section: &str, doomed: F) -> usize
+    where
+        F: Fn(&Value) -> bool,
+    {
+        let Ok(rows) = Self::array_in(&self.root, section) else {
+            return 0;
+        };
+        let positions: Vec<usize> = rows
+            .iter()
+            .enumerate()
+            .filter(|(_, row)| doomed(row))
+            .map(|(i, _)| i)
+            .collect();
+        if positions.is_empty() {
+            return 0;
+        }
+
+        let rows = self.section_mut(section).expect("checked above");
+        let mut position = 0;
+        let mut next = positions.iter().peekable();
+        rows.retain(|_| {
+            let keep = next.next_if_eq(&&position).is_none();
+            position += 1;
+            keep
+        });
+        positions.len()
+    }
+
+    fn array_in<'a>(root: &'a Value, section: &str) -> Result<&'a Vec<Value>> {
+        root.get("G2_CONFIG")
+            .and_then(|g| g.get(section))
+            .and_then(|v| v.as_array())
+            .ok_or_else(|| SzConfigError::MissingSection(section.to_string()))
+    }
+
+    /// Start recording which `G2_CONFIG` members are mutably accessed
+    ///
+    /// Used by profiling to report the sections each command touched.
+    /// Access through [`as_value_mut`](Self::as_value_mut) or
+    /// [`g2_config_mut`](Self::g2_config_mut) is recorded as "G2_CONFIG".
+    pub(crate) fn record_touched_sections(&mut self) {
+        self.touched.get_or_insert_with(BTreeSet::new);
+    }
+
+    /// Sections recorded since the last call, in name order
+    pub(crate) fn take_touched_sections(&mut self) -> Vec<String> {
+        self.touched
+            .as_mut()
+            .map(|touched| std::mem::take(touched).into_iter().collect())
+            .unwrap_or_default()
+    }
+
+    /// Record a coming mutation of a `G2_CONFIG` member ("G2_CONFIG" for the
+    /// whole document) for profiling and open snapshots
+    fn before_write(&mut self, key: &str) {
+        self.undo.save(&self.root, key);
+        self.serialized.invalidate(key);
+        self.touch(key);
+    }
+
+    /// The document and undo log, for [`crate::snapshot`]
+    pub(crate) fn undo_log(&mut self) -> (&mut Value, &mut UndoLog) {
+        (&mut self.root, &mut self.undo)
+    }
+
+    /// Drop the indexes of a member restored behind the accessors' back
+    pub(crate) fn forget_section(&mut self, key: &str) {
+        if key == "G2_CONFIG" {
+            self.index.invalidate_all();
+        } else {
+            self.index.invalidate_section(key);
+        }
+        self.serialized.invalidate(key);
+        self.touch(key);
+    }
+
+    pub(crate) fn touch(&mut self, key: &str) {
+        if let Some(touched) = &mut self.touched
+            && !touched.contains(key)
+        {
+            touched.insert(key.to_string());
+        }
+    }
+
+    /// Case-insensitive code → ID lookup in a section
+    ///
+    /// Uses the section index when the (section, fields) triple is indexed,
+    /// otherwise scans the section. Returns None if the section or code
+    /// doesn't exist.
+    pub(crate) fn lookup_id(
+        &self,
+        section: &str,
+        code_field: &str,
+        id_field: &str,
+        code: &str,
+    ) -> Option<i64> {
+        let items = self.section(section).ok()?;
+        match index::slot(section, code_field, id_field) {
+            Some(slot) => self.index.get(slot, items).id(code),
+            None => items
+                .iter()
+                .find(|item| {
+                    item.get(code_field)
+                        .and_then(|v| v.as_str())
+                        .is_some_and(|s| s.eq_ignore_ascii_case(code))
+                })
+                .and_then(|item| item.get(id_field))
+                .and_then(|v| v.as_i64()),
+        }
+    }
+
+    /// True if a record of `section` has `code` (case-insensitive),
+    /// whether or not it has an ID
+    ///
+    /// Use this rather than [`lookup_id`](Self::lookup_id) to reject
+    /// duplicates: records with a missing or non-integer ID have no entry
+    /// there.
+    pub(crate) fn has_code(
+        &self,
+        section: &str,
+        code_field: &str,
+        id_field: &str,
+        code: &str,
+    ) -> bool {
+        let Ok(items) = self.section(section) else {
+            return false;
+        };
+        match index::slot(section, code_field, id_field) {
+            Some(slot) => self.index.get(slot, items).contains_code(code),
+            None => items.iter().any(|item| {
+                item.get(code_field)
+                    .and_then(|v| v.as_str())
+                    .is_some_and(|s| s.eq_ignore_ascii_case(code))
+            }),
+        }
+    }
+
+    /// ID → code lookup in a section (the code as stored in the config)
+    pub(crate) fn lookup_code(
+        &self,
+        section: &str,
+        code_field: &str,
+        id_field: &str,
+        id: i64,
+    ) -> Option<&str> {
+        let items = self.section(section).ok()?;
+        match index::slot(section, code_field, id_field) {
+            Some(slot) => self.index.get(slot, items).code(id),
+            None => items
+                .iter()
+                .find(|item| item.get(id_field).and_then(|v| v.as_i64()) == Some(id))
+                .and_then(|item| item.get(code_field))
+                .and_then(|v| v.as_str()),
+        }
+    }
+}
+
+/// Open a configuration file as a handle
+///
+/// The file is parsed through a buffered reader, so the document is never
+/// held in memory as a string as well as in parsed form.
+///
+/// # Errors
+/// - `InvalidConfig` if the file cannot be opened
+/// - `JsonParse` if the content is invalid or cannot be read
+pub fn open_config_file<P: AsRef<Path>>(path: P) -> Result<ConfigHandle> {
+    let path = path.as_ref();
+    let file = File::open(path).map_err(|e| {
+        SzConfigError::InvalidConfig(format!("Failed to read {}: {}", path.display(), e))
+    })?;
+    ConfigHandle::from_reader(BufReader::new(file))
+}
+
+/// Save a handle's configuration to a file as compact JSON
+///
+/// The document is serialized through a buffered writer instead of being
+/// built as a string first.
+///
+/// # Errors
+/// - `InvalidConfig` if the file cannot be created or written
+pub fn save_config_file<P: AsRef<Path>>(config: &ConfigHandle, path: P) -> Result<()> {
+    let path = path.as_ref();
+    let write_error = |e: &dyn std::fmt::Display| {
+        SzConfigError::InvalidConfig(format!("Failed to write {}: {}", path.display(), e))
+    };
+
+    let file = File::create(path).map_err(|e| write_error(&e))?;
+    let mut writer = BufWriter::new(file);
+    config
+        .serialized
+        .write(config.as_value(), None, &mut writer)
+        .map_err(|e| write_error(&e))?;
+    writer.flush().map_err(|e| write_error(&e))
+}
+
+/// Deserializer for [`ConfigHandle::from_json_sections`]
+///
+/// Non-object values where an object is expected become null, so a handle
+/// reports them as missing exactly as it would after a full parse.
+#[derive(Clone, Copy)]
+enum Selective<'a> {
+    /// The document root: keep only `G2_CONFIG`
+    Root(&'a [&'a str]),
+    /// `G2_CONFIG`: keep only the listed members
+    Members(&'a [&'a str]),
+}
+
+impl<'de> DeserializeSeed<'de> for Selective<'_> {
+    type Value = Value;
+
+    fn deserialize<D: de::Deserializer<'de>>(
+        self,
+        deserializer: D,
+    ) -> std::result::Result<Value, D::Error> {
+        deserializer.deserialize_any(self)
+    }
+}
+
+impl<'de> Visitor<'de> for Selective<'_> {
+    type Value = Value;
+
+    fn expecting(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        f.write_str("a configuration object")
+    }
+
+    fn visit_map<A: MapAccess<'de>>(self, mut map: A) -> std::result::Result<Value, A::Error> {
+        let mut out = Map::new();
+        while let Some(key) = map.next_key::<String>()? {
+            let value = match self {
+                Selective::Root(sections) if key == "G2_CONFIG" => {
+                    map.next_value_seed(Selective::Members(sections))?
+                }
+                Selective::Members(sections) if sections.contains(&key.as_str()) => {
+                    map.next_value()?
+                }
+                _ => {
+                    map.next_value::<IgnoredAny>()?;
+                    continue;
+                }
+            };
+            out.insert(key, value);
+        }
+        Ok(Value::Object(out))
+    }
+
+    fn visit_seq<A: SeqAccess<'de>>(self, mut seq: A) -> std::result::Result<Value, A::Error> {
+        while seq.next_element::<IgnoredAny>()?.is_some() {}
+        Ok(Value::Null)
+    }
+
+    fn visit_bool<E: de::Error>(self, _: bool) -> std::result::Result<Value, E> {
+        Ok(Value::Null)
+    }
+
+    fn visit_i64<E: de::Error>(self, _: i64) -> std::result::Result<Value, E> {
+        Ok(Value::Null)
+    }
+
+    fn visit_u64<E: de::Error>(self, _: u64) -> std::result::Result<Value, E> {
+        Ok(Value::Null)
+    }
+
+    fn visit_f64<E: de::Error>(self, _: f64) -> std::result::Result<Value, E> {
+        Ok(Value::Null)
+    }
+
+    fn visit_str<E: de::Error>(self, _: &str) -> std::result::Result<Value, E> {
+        Ok(Value::Null)
+    }
+
+    fn visit_unit<E: de::Error>(self) -> std::result::Result<Value, E> {
+        Ok(Value::Null)
+    }
+}
+
+/// Parse `config_json`, apply `f` to the handle and serialize the result
+pub(crate) fn edit<F>(config_json: &str, f: F) -> Result<String>
+where
+    F: FnOnce(&mut ConfigHandle) -> Result<()>,
+{
+    let mut config = ConfigHandle::from_json_with_spans(config_json)?;
+    f(&mut config)?;
+    config.to_json_from(config_json)
+}
+
+/// Like [`edit`], but also returns the value produced by `f`
+pub(crate) fn edit_returning<T, F>(config_json: &str, f: F) -> Result<(String, T)>
+where
+    F: FnOnce(&mut ConfigHandle) -> Result<T>,
+{
+    let mut config = ConfigHandle::from_json_with_spans(config_json)?;
+    let value = f(&mut config)?;
+    Ok((config.to_json_from(config_json)?, value))
+}
+
+/// Parse `config_json` and run a read-only query against it
+pub(crate) fn read<T, F>(config_json: &str, f: F) -> Result<T>
+where
+    F: FnOnce(&ConfigHandle) -> Result<T>,
+{
+    let config = ConfigHandle::from_json(config_json)?;
+    f(&config)
+}
+
+/// Like [`read`], but parses only the `G2_CONFIG` members the query uses
+///
+/// `sections` must list every member `f` reads (see
+/// [`ConfigHandle::from_json_sections`]).
+pub(crate) fn read_sections<T, F>(config_json: &str, sections: &[&str], f: F) -> Result<T>
+where
+    F: FnOnce(&ConfigHandle) -> Result<T>,
+{
+    let config = ConfigHandle::from_json_sections(config_json, sections)?;
+    f(&config)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_from_json_sections() {
+        let json = r#"{"VERSION":1,"G2_CONFIG":{"CFG_FTYPE":[{"FTYPE_ID":1,"S":"x\"}"}],"CFG_DSRC":[{"DSRC_ID":1}],"SYS_OOM":{}}}"#;
+        let config = ConfigHandle::from_json_sections(json, &["SYS_OOM", "CFG_DSRC"]).unwrap();
+        assert_eq!(
+            config.to_json().unwrap(),
+            r#"{"G2_CONFIG":{"CFG_DSRC":[{"DSRC_ID":1}],"SYS_OOM":{}}}"#
+        );
+
+        // Skipped members are still checked for syntax
+        assert!(
+            ConfigHandle::from_json_sections(r#"{"G2_CONFIG":{"CFG_FTYPE":[1,]}}"#, &[]).is_err()
+        );
+        assert!(ConfigHandle::from_json_sections(r#"{"G2_CONFIG":{}} x"#, &[]).is_err());
+
+        // A non-object G2_CONFIG is missing, as after a full parse
+        let config =
+            ConfigHandle::from_json_sections(r#"{"G2_CONFIG":[1]}"#, &["CFG_DSRC"]).unwrap();
+        assert!(config.g2_config().is_none());
+    }
+
+    #[test]
+    fn test_round_trip_preserves_document() {
+        let json = r#"{"G2_CONFIG":{"CFG_DSRC":[{"DSRC_ID":1,"DSRC_CODE":"TEST"}]}}"#;
+        let config = ConfigHandle::from_json(json).unwrap();
+        assert_eq!(config.to_json().unwrap(), json);
+    }
+
+    #[test]
+    fn test_incremental_serialize_tracks_edits() {
+        let json = concat!(
+            r#"{"G2_CONFIG":{"CFG_DSRC":[{"DSRC_ID":1,"DSRC_CODE":"A"}],"#,
+            r#""CFG_FBOM":[{"FTYPE_ID":1,"FELEM_ID":2}],"SYS_OOM":{"NAME_HASH":[]}}}"#
+        );
+        let mut config = ConfigHandle::from_json_cached(json).unwrap();
+        let full = |c: &ConfigHandle| serde_json::to_string(c.as_value()).unwrap();
+        assert_eq!(config.to_json().unwrap(), json);
+
+        let snapshot = config.snapshot();
+        config
+            .push_row("CFG_DSRC", serde_json::json!({"DSRC_ID": 2}))
+            .unwrap();
+        assert_eq!(config.to_json().unwrap(), full(&config));
+        config.g2_entry_mut("SYS_OOM").unwrap()["NAME_HASH"] = serde_json::json!(["X"]);
+        config.section_mut("CFG_FBOM").unwrap().clear();
+        assert_eq!(config.to_json().unwrap(), full(&config));
+        config.g2_config_mut().unwrap().shift_remove("CFG_DSRC");
+        assert_eq!(config.to_json().unwrap(), full(&config));
+
+        config.rollback(snapshot).unwrap();
+        assert_eq!(config.clone().to_json().unwrap(), json);
+        let mut written = Vec::new();
+        config.to_writer(&mut written).unwrap();
+        assert_eq!(String::from_utf8(written).unwrap(), json);
+    }
+
+    #[test]
+    fn test_member_edits_keep_other_spans() {
+        let json = concat!(
+            r#"{"G2_CONFIG":{"CFG_DSRC":[{"DSRC_ID":1}],"CFG_FBOM":[{"FTYPE_ID":1}],"#,
+            r#""CFG_OLD":[],"SYS_OOM":{"NAME_HASH":[],"SSN_LAST4_HASH":[]},"#,
+            r#""CONFIG_BASE_VERSION":{"COMPATIBILITY_VERSION":{"CONFIG_VERSION":"10"}}}}"#
+        );
+        let mut config = ConfigHandle::from_json_with_spans(json).unwrap();
+        config.record_touched_sections();
+
+        config.add_to_name_hash("A").unwrap();
+        config.add_to_ssn_last4_hash("1234").unwrap();
+        config.delete_from_ssn_last4_hash("1234").unwrap();
+        config.update_compatibility_version("11").unwrap();
+        config.add_config_section("CFG_NEW").unwrap();
+        config.remove_config_section("CFG_OLD").unwrap();
+        config
+            .add_config_section_field("CFG_FBOM", "X", &serde_json::json!(1))
+            .unwrap();
+        config.remove_config_section_field("CFG_FBOM", "X").unwrap();
+        assert!(
+            !config
+                .take_touched_sections()
+                .contains(&"G2_CONFIG".to_string())
+        );
+
+        // Changed behind the cache's back: the old bytes show through only
+        // if CFG_DSRC's span survived the edits above
+        config.root["G2_CONFIG"]["CFG_DSRC"] = serde_json::json!([]);
+        let mut expected: Value = serde_json::from_str(json).unwrap();
+        let g2 = expected["G2_CONFIG"].as_object_mut().unwrap();
+        g2.shift_remove("CFG_OLD");
+        g2.insert("CFG_NEW".to_string(), serde_json::json!([]));
+        expected["G2_CONFIG"]["SYS_OOM"]["NAME_HASH"] = serde_json::json!(["A"]);
+        expected["G2_CONFIG"]["CONFIG_BASE_VERSION"]["COMPATIBILITY_VERSION"]["CONFIG_VERSION"] =
+            serde_json::json!("11");
+        assert_eq!(
+            config.to_json_from(json).unwrap(),
+            serde_json::to_string(&expected).unwrap()
+        );
+    }
+
+    #[test]
+    fn test_string_edits_copy_unchanged_sections() {
+        // Non-canonical members (float, \u escape) are serialized as usual
+        let json = concat!(
+            r#"{"G2_CONFIG":{"CFG_DSRC":[],"CFG_RTYPE":[{"W":1.50}],"#,
+            r#""CFG_X":["\u0041"],"SYS_OOM":{}}}"#
+        );
+        let out = edit(json, |config| {
+            config.push_row("CFG_DSRC", serde_json::json!({"DSRC_ID": 1}))
+        })
+        .unwrap();
+        let mut expected: Value = serde_json::from_str(json).unwrap();
+        expected["G2_CONFIG"]["CFG_DSRC"] = serde_json::json!([{"DSRC_ID": 1}]);
+        assert_eq!(out, serde_json::to_string(&expected).unwrap());
+    }
+
+    #[test]
+    fn test_section_missing() {
+        let config = ConfigHandle::from_json(r#"{"G2_CONFIG":{}}"#).unwrap();
+        assert!(matches!(
+            config.section("CFG_DSRC"),
+            Err(SzConfigError::MissingSection(_))
+        ));
+    }
+
+    #[test]
+    fn test_lookup_index_tracks_edits() {
+        let mut config = ConfigHandle::from_json(
+            r#"{"G2_CONFIG":{"CFG_FTYPE":[{"FTYPE_ID":1,"FTYPE_CODE":"NAME"}]}}"#,
+        )
+        .unwrap();
+        assert_eq!(
+            config.lookup_id("CFG_FTYPE", "FTYPE_CODE", "FTYPE_ID", "name"),
+            Some(1)
+        );
+
+        config
+            .section_mut("CFG_FTYPE")
+            .unwrap()
+            .push(serde_json::json!({"FTYPE_ID": 2, "FTYPE_CODE": "ADDRESS"}));
+        assert_eq!(
+            config.lookup_id("CFG_FTYPE", "FTYPE_CODE", "FTYPE_ID", "ADDRESS"),
+            Some(2)
+        );
+        assert_eq!(
+            config.lookup_code("CFG_FTYPE", "FTYPE_CODE", "FTYPE_ID", 2),
+            Some("ADDRESS")
+        );
+
+        config.as_value_mut()["G2_CONFIG"]["CFG_FTYPE"] = serde_json::json!([]);
+        assert_eq!(
+            config.lookup_id("CFG_FTYPE", "FTYPE_CODE", "FTYPE_ID", "NAME"),
+            None
+        );
+    }
+
+    #[test]
+    fn test_config_file_round_trip() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("g2config.json");
+        let json = r#"{"G2_CONFIG":{"CFG_DSRC":[{"DSRC_ID":1,"DSRC_CODE":"TEST"}]}}"#;
+
+        save_config_file(&ConfigHandle::from_json(json).unwrap(), &path).unwrap();
+        assert_eq!(std::fs::read_to_string(&path).unwrap(), json);
+        assert_eq!(open_config_file(&path).unwrap().to_json().unwrap(), json);
+
+        let missing = open_config_file(dir.path().join("missing.json")).unwrap_err();
+        assert!(matches!(missing, SzConfigError::InvalidConfig(_)));
+        std::fs::write(&path, "{truncated").unwrap();
+        assert!(matches!(
+            open_config_file(&path),
+            Err(SzConfigError::JsonParse(_))
+        ));
+    }
+
+    #[test]
+    fn test_next_id_follows_deletes_and_manual_inserts() {
+        let mut config = ConfigHandle::from_json(
+            r#"{"G2_CONFIG":{"CFG_DSRC":[{"DSRC_ID":1,"DSRC_CODE":"A"},{"DSRC_ID":5,"DSRC_CODE":"B"}]}}"#,
+        )
+        .unwrap();
+        assert_eq!(config.next_id("CFG_DSRC", "DSRC_ID", None).unwrap(), 6);
+
+        config
+            .push_row(
+                "CFG_DSRC",
+                serde_json::json!({"DSRC_ID": 6, "DSRC_CODE": "C"}),
+            )
+            .unwrap();
+        assert_eq!(config.next_id("CFG_DSRC", "DSRC_ID", None).unwrap(), 7);
+        assert!(config.is_id_taken("CFG_DSRC", "DSRC_ID", 6).unwrap());
+        assert_eq!(
+            config.lookup_id("CFG_DSRC", "DSRC_CODE", "DSRC_ID", "c"),
+            Some(6)
+        );
+
+        // Deleting the largest ID makes it available again, as a scan would
+        config.section_mut("CFG_DSRC").unwrap().truncate(2);
+        assert_eq!(config.next_id("CFG_DSRC", "DSRC_ID", None).unwrap(), 6);
+
+        config
+            .section_mut("CFG_DSRC")
+            .unwrap()
+            .push(serde_json::json!({"DSRC_ID": 40}));
+        assert_eq!(
+            config.next_id("CFG_DSRC", "DSRC_ID", Some(1000)).unwrap(),
+            1000
+        );
+        assert_eq!(config.next_id("CFG_DSRC", "DSRC_ID", None).unwrap(), 41);
+    }
+
+    #[test]
+    fn test_invalid_json() {
+        assert!(matches!(
+            ConfigHandle::from_json("{not json"),
+            Err(SzConfigError::JsonParse(_))
+        ));
+    }
+}
@@ -4,7 +4,259 @@
 //! These hashes control special matching behavior for common names and SSN last 4 digits.
 
 use crate::error::{Result, SzConfigError};
+use crate::handle::{self, ConfigHandle};
 use serde_json::{Value, json};
+use std::collections::HashSet;
+
+impl ConfigHandle {
+    /// Add a name to the NAME_HASH array (in-place form of [`add_to_name_hash`])
+    pub fn add_to_name_hash(&mut self, name: &str) -> Result<()> {
+        if self.g2_config().is_some() {
+            if let Some(sys_oom) = self.g2_entry_mut("SYS_OOM") {
+                if let Some(sys_oom_obj) = sys_oom.as_object_mut() {
+                    // Get or create NAME_HASH array
+                    let name_hash = sys_oom_obj.entry("NAME_HASH").or_insert(json!([]));
+
+                    if let Some(name_hash_arr) = name_hash.as_array_mut() {
+                        // Check if already exists
+                        if name_hash_arr.iter().any(|v| v.as_str() == Some(name)) {
+                            return Err(SzConfigError::AlreadyExists(format!(
+                                "Name already in hash: {}",
+                                name
+                            )));
+                        }
+
+                        // Add to hash
+                        name_hash_arr.push(json!(name));
+                    } else {
+                        return Err(SzConfigError::InvalidConfig(
+                            "NAME_HASH is not an array".to_string(),
+                        ));
+                    }
+                }
+            } else {
+                return Err(SzConfigError::NotFound(
+                    "SYS_OOM section not found".to_string(),
+                ));
+            }
+        }
+
+        Ok(())
+    }
+
+    /// Delete a name from the NAME_HASH array (in-place form of [`delete_from_name_hash`])
+    pub fn delete_from_name_hash(&mut self, name: &str) -> Result<()> {
+        let mut found = false;
+
+        if let Some(name_hash_arr) = self
+            .g2_entry_mut("SYS_OOM")
+            .and_then(|sys_oom| sys_oom.get_mut("NAME_HASH"))
+            .and_then(|name_hash| name_hash.as_array_mut())
+        {
+            let before_len = name_hash_arr.len();
+            name_hash_arr.retain(|v| v.as_str() != Some(name));
+            found = name_hash_arr.len() < before_len;
+        }
+
+        if !found {
+            return Err(SzConfigError::NotFound(format!(
+                "Name not found in hash: {}",
+                name
+            )));
+        }
+
+        Ok(())
+    }
+
+    /// Add a name to the SSN_LAST4_HASH array (in-place form of [`add_to_ssn_last4_hash`])
+    pub fn add_to_ssn_last4_hash(&mut self, name: &str) -> Result<()> {
+        if self.g2_config().is_some() {
+            if let Some(sys_oom) = self.g2_entry_mut("SYS_OOM") {
+                if let Some(sys_oom_obj) = sys_oom.as_object_mut() {
+                    // Get or create SSN_LAST4_HASH array
+                    let ssn_last4_hash = sys_oom_obj.entry("SSN_LAST4_HASH").or_insert(json!([]));
+
+                    if let Some(ssn_last4_hash_arr) = ssn_last4_hash.as_array_mut() {
+                        // Check if already exists
+                        if ssn_last4_hash_arr.iter().any(|v| v.as_str() == Some(name)) {
+                            return Err(SzConfigError::AlreadyExists(format!(
+                                "Name already in SSN_LAST4_HASH: {}",
+                                name
+                            )));
+                        }
+
+                        // Add to hash
+                        ssn_last4_hash_arr.push(json!(name));
+                    } else {
+                        return Err(SzConfigError::InvalidConfig(
+                            "SSN_LAST4_HASH is not an array".to_string(),
+                        ));
+                    }
+                }
+            } else {
+                return Err(SzConfigError::NotFound(
+                    "SYS_OOM section not found".to_string(),
+                ));
+            }
+        }
+
+        Ok(())
+    }
+
+    /// Delete a name from the SSN_LAST4_HASH array (in-place form of [`delete_from_ssn_last4_hash`])
+    pub fn delete_from_ssn_last4_hash(&mut self, name: &str) -> Result<()> {
+        let mut removed = false;
+
+        if self.g2_config().is_some() {
+            if let Some(sys_oom) = self.g2_entry_mut("SYS_OOM") {
+                if let Some(sys_oom_obj) = sys_oom.as_object_mut() {
+                    if let Some(ssn_last4_hash) = sys_oom_obj.get_mut("SSN_LAST4_HASH") {
+                        if let Some(ssn_last4_hash_arr) = ssn_last4_hash.as_array_mut() {
+                            // Find and remove the name
+                            if let Some(pos) = ssn_last4_hash_arr
+                                .iter()
+                                .position(|v| v.as_str() == Some(name))
+                            {
+                                ssn_last4_hash_arr.remove(pos);
+                                removed = true;
+                            }
+                        } else {
+                            return Err(SzConfigError::InvalidConfig(
+                                "SSN_LAST4_HASH is not an array".to_string(),
+                            ));
+                        }
+                    } else {
+                        return Err(SzConfigError::NotFound(
+                            "SSN_LAST4_HASH not found in SYS_OOM".to_string(),
+                        ));
+                    }
+                }
+            } else {
+                return Err(SzConfigError::NotFound(
+                    "SYS_OOM section not found".to_string(),
+                ));
+            }
+        }
+
+        if !removed {
+            return Err(SzConfigError::NotFound(format!(
+                "Name not found in SSN_LAST4_HASH: {}",
+                name
+            )));
+        }
+
+        Ok(())
+    }
+
+    /// Add many names to the NAME_HASH array (in-place form of [`add_to_name_hash_many`])
+    pub fn add_to_name_hash_many(&mut self, names: &[&str]) -> Result<()> {
+        self.add_many_to_oom_hash("NAME_HASH", names)
+    }
+
+    /// Delete many names from the NAME_HASH array (in-place form of
+    /// [`delete_from_name_hash_many`])
+    pub fn delete_from_name_hash_many(&mut self, names: &[&str]) -> Result<()> {
+        self.delete_many_from_oom_hash("NAME_HASH", names, true)
+    }
+
+    /// Add many values to the SSN_LAST4_HASH array (in-place form of
+    /// [`add_to_ssn_last4_hash_many`])
+    pub fn add_to_ssn_last4_hash_many(&mut self, names: &[&str]) -> Result<()> {
+        self.add_many_to_oom_hash("SSN_LAST4_HASH", names)
+    }
+
+    /// Delete many values from the SSN_LAST4_HASH array (in-place form of
+    /// [`delete_from_ssn_last4_hash_many`])
+    pub fn delete_from_ssn_last4_hash_many(&mut self, names: &[&str]) -> Result<()> {
+        self.delete_many_from_oom_hash("SSN_LAST4_HASH", names, false)
+    }
+
+    /// Current members of a SYS_OOM hash array (empty if the array doesn't exist)
+    fn oom_hash_members(&self, key: &str) -> Result<HashSet<&str>> {
+        let sys_oom = self
+            .g2_entry("SYS_OOM")
+            .ok_or_else(|| SzConfigError::NotFound("SYS_OOM section not found".to_string()))?;
+
+        match sys_oom.get(key) {
+            None => Ok(HashSet::new()),
+            Some(Value::Array(arr)) => Ok(arr.iter().filter_map(|v| v.as_str()).collect()),
+            Some(_) => Err(SzConfigError::InvalidConfig(format!(
+                "{} is not an array",
+                key
+            ))),
+        }
+    }
+
+    /// Append names to a SYS_OOM hash array, checking membership in a set
+    ///
+    /// Every name is checked before the array is modified, so on error
+    /// nothing is added.
+    fn add_many_to_oom_hash(&mut self, key: &str, names: &[&str]) -> Result<()> {
+        let mut members = self.oom_hash_members(key)?;
+        for name in names {
+            if !members.insert(name) {
+                return Err(SzConfigError::AlreadyExists(format!(
+                    "Name already in {}: {}",
+                    key, name
+                )));
+            }
+        }
+
+        let Some(sys_oom_obj) = self
+            .g2_entry_mut("SYS_OOM")
+            .and_then(|sys_oom| sys_oom.as_object_mut())
+        else {
+            return Err(SzConfigError::InvalidConfig(
+                "SYS_OOM is not an object".to_string(),
+            ));
+        };
+
+        // Get or create the array
+        if let Some(arr) = sys_oom_obj.entry(key).or_insert(json!([])).as_array_mut() {
+            arr.extend(names.iter().map(|name| json!(name)));
+        }
+
+        Ok(())
+    }
+
+    /// Remove names from a SYS_OOM hash array in one pass
+    ///
+    /// With `all_occurrences` every copy of a name is removed (like
+    /// [`delete_from_name_hash`]), otherwise only the first (like
+    /// [`delete_from_ssn_last4_hash`]). Every name is checked before the array
+    /// is modified, so on error nothing is removed.
+    fn delete_many_from_oom_hash(
+        &mut self,
+        key: &str,
+        names: &[&str],
+        all_occurrences: bool,
+    ) -> Result<()> {
+        let members = self.oom_hash_members(key)?;
+        let mut pending: HashSet<&str> = HashSet::with_capacity(names.len());
+        for name in names {
+            if !members.contains(name) || !pending.insert(name) {
+                return Err(SzConfigError::NotFound(format!(
+                    "Name not found in {}: {}",
+                    key, name
+                )));
+            }
+        }
+
+        if let Some(arr) = self
+            .g2_entry_mut("SYS_OOM")
+            .and_then(|sys_oom| sys_oom.get_mut(key))
+            .and_then(|hash| hash.as_array_mut())
+        {
+            if all_occurrences {
+                arr.retain(|v| !v.as_str().is_some_and(|s| pending.contains(s)));
+            } else {
+                arr.retain(|v| !v.as_str().is_some_and(|s| pending.remove(s)));
+            }
+        }
+
+        Ok(())
+    }
+}
 
 /// Add a name to the NAME_HASH array
 ///
@@ -26,39 +278,7 @@ use serde_json::{Value, json};
 /// let modified = hashes::add_to_name_hash(config, "JOHN").unwrap();
 /// ```
 pub fn add_to_name_hash(config_json: &str, name: &str) -> Result<String> {
-    let mut config_data: Value = serde_json::from_str(config_json)?;
-
-    if let Some(g2_config) = config_data.get_mut("G2_CONFIG") {
-        if let Some(sys_oom) = g2_config.get_mut("SYS_OOM") {
-            if let Some(sys_oom_obj) = sys_oom.as_object_mut() {
-                // Get or create NAME_HASH array
-                let name_hash = sys_oom_obj.entry("NAME_HASH").or_insert(json!([]));
-
-                if let Some(name_hash_arr) = name_hash.as_array_mut() {
-                    // Check if already exists
-                    if name_hash_arr.iter().any(|v| v.as_str() == Some(name)) {
-                        return Err(SzConfigError::AlreadyExists(format!(
-                            "Name already in hash: {}",
-                            name
-                        )));
-                    }
-
-                    // Add to hash
-                    name_hash_arr.push(json!(name));
-                } else {
-                    return Err(SzConfigError::InvalidConfig(
-                        "NAME_HASH is not an array".to_string(),
-                    ));
-                }
-            }
-        } else {
-            return Err(SzConfigError::NotFound(
-                "SYS_OOM section not found".to_string(),
-            ));
-        }
-    }
-
-    Ok(serde_json::to_string(&config_data)?)
+    handle::edit(config_json, |config| config.add_to_name_hash(name))
 }
 
 /// Delete a name from the NAME_HASH array
@@ -81,31 +301,7 @@ pub fn add_to_name_hash(config_json: &str, name: &str) -> Result<String> {
 /// let modified = hashes::delete_from_name_hash(config, "JOHN").unwrap();
 /// ```
 pub fn delete_from_name_hash(config_json: &str, name: &str) -> Result<String> {
-    let mut config_data: Value = serde_json::from_str(config_json)?;
-    let mut found = false;
-
-    if let Some(g2_config) = config_data.get_mut("G2_CONFIG") {
-        if let Some(sys_oom) = g2_config.get_mut("SYS_OOM") {
-            if let Some(sys_oom_obj) = sys_oom.as_object_mut() {
-                if let Some(name_hash) = sys_oom_obj.get_mut("NAME_HASH") {
-                    if let Some(name_hash_arr) = name_hash.as_array_mut() {
-                        let before_len = name_hash_arr.len();
-                        name_hash_arr.retain(|v| v.as_str() != Some(name));
-                        found = name_hash_arr.len() < before_len;
-                    }
-                }
-            }
-        }
-    }
-
-    if !found {
-        return Err(SzConfigError::NotFound(format!(
-            "Name not found in hash: {}",
-            name
-        )));
-    }
-
-    Ok(serde_json::to_string(&config_data)?)
+    handle::edit(config_json, |config| config.delete_from_name_hash(name))
 }
 
 /// Add a name to the SSN_LAST4_HASH array
@@ -128,39 +324,7 @@ pub fn delete_from_name_hash(config_json: &str, name: &str) -> Result<String> {
 /// let modified = hashes::add_to_ssn_last4_hash(config, "SMITH").unwrap();
 /// ```
 pub fn add_to_ssn_last4_hash(config_json: &str, name: &str) -> Result<String> {
-    let mut config_data: Value = serde_json::from_str(config_json)?;
-
-    if let Some(g2_config) = config_data.get_mut("G2_CONFIG") {
-        if let Some(sys_oom) = g2_config.get_mut("SYS_OOM") {
-            if let Some(sys_oom_obj) = sys_oom.as_object_mut() {
-                // Get or create SSN_LAST4_HASH array
-                let ssn_last4_hash = sys_oom_obj.entry("SSN_LAST4_HASH").or_insert(json!([]));
-
-                if let Some(ssn_last4_hash_arr) = ssn_last4_hash.as_array_mut() {
-                    // Check if already exists
-                    if ssn_last4_hash_arr.iter().any(|v| v.as_str() == Some(name)) {
-                        return Err(SzConfigError::AlreadyExists(format!(
-                            "Name already in SSN_LAST4_HASH: {}",
-                            name
-                        )));
-                    }
-
-                    // Add to hash
-                    ssn_last4_hash_arr.push(json!(name));
-                } else {
-                    return Err(SzConfigError::InvalidConfig(
-                        "SSN_LAST4_HASH is not an array".to_string(),
-                    ));
-                }
-            }
-        } else {
-            return Err(SzConfigError::NotFound(
-                "SYS_OOM section not found".to_string(),
-            ));
-        }
-    }
-
-    Ok(serde_json::to_string(&config_data)?)
+    handle::edit(config_json, |config| config.add_to_ssn_last4_hash(name))
 }
 
 /// Delete a name from the SSN_LAST4_HASH array
@@ -183,46 +347,145 @@ pub fn add_to_ssn_last4_hash(config_json: &str, name: &str) -> Result<String> {
 /// let modified = hashes::delete_from_ssn_last4_hash(config, "SMITH").unwrap();
 /// ```
 pub fn delete_from_ssn_last4_hash(config_json: &str, name: &str) -> Result<String> {
-    let mut config_data: Value = serde_json::from_str(config_json)?;
-    let mut removed = false;
+    handle::edit(config_json, |config| {
+        config.delete_from_ssn_last4_hash(name)
+    })
+}
 
-    if let Some(g2_config) = config_data.get_mut("G2_CONFIG") {
-        if let Some(sys_oom) = g2_config.get_mut("SYS_OOM") {
-            if let Some(sys_oom_obj) = sys_oom.as_object_mut() {
-                if let Some(ssn_last4_hash) = sys_oom_obj.get_mut("SSN_LAST4_HASH") {
-                    if let Some(ssn_last4_hash_arr) = ssn_last4_hash.as_array_mut() {
-                        // Find and remove the name
-                        if let Some(pos) = ssn_last4_hash_arr
-                            .iter()
-                            .position(|v| v.as_str() == Some(name))
-                        {
-                            ssn_last4_hash_arr.remove(pos);
-                            removed = true;
-                        }
-                    } else {
-                        return Err(SzConfigError::InvalidConfig(
-                            "SSN_LAST4_HASH is not an array".to_string(),
-                        ));
-                    }
-                } else {
-                    return Err(SzConfigError::NotFound(
-                        "SSN_LAST4_HASH not found in SYS_OOM".to_string(),
-                    ));
-                }
-            }
-        } else {
-            return Err(SzConfigError::NotFound(
-                "SYS_OOM section not found".to_string(),
-            ));
-        }
-    }
+/// Add many names to the NAME_HASH array
+///
+/// Membership is checked against a hash set built once, so loading a large
+/// reference list costs O(n) instead of the O(n²) of repeated
+/// [`add_to_name_hash`] calls.
+///
+/// # Arguments
+///
+/// * `config_json` - Configuration JSON string
+/// * `names` - Name values to add
+///
+/// # Returns
+///
+/// Returns modified configuration JSON on success
+///
+/// # Errors
+///
+/// * `AlreadyExists` if a name is already present or listed twice (nothing is added)
+/// * `NotFound` if SYS_OOM doesn't exist
+///
+/// # Example
+///
+/// ```
+/// use sz_configtool_lib::hashes;
+///
+/// let config = r#"{"G2_CONFIG": {"SYS_OOM": {"NAME_HASH": ["JOHN"]}}}"#;
+/// let modified = hashes::add_to_name_hash_many(config, &["MARY", "SMITH"]).unwrap();
+/// assert!(modified.contains(r#"["JOHN","MARY","SMITH"]"#));
+/// ```
+pub fn add_to_name_hash_many(config_json: &str, names: &[&str]) -> Result<String> {
+    handle::edit(config_json, |config| config.add_to_name_hash_many(names))
+}
 
-    if !removed {
-        return Err(SzConfigError::NotFound(format!(
-            "Name not found in SSN_LAST4_HASH: {}",
-            name
-        )));
+/// Delete many names from the NAME_HASH array
+///
+/// # Arguments
+///
+/// * `config_json` - Configuration JSON string
+/// * `names` - Name values to remove
+///
+/// # Returns
+///
+/// Returns modified configuration JSON on success
+///
+/// # Errors
+///
+/// * `NotFound` if a name is not present or listed twice (nothing is removed)
+pub fn delete_from_name_hash_many(config_json: &str, names: &[&str]) -> Result<String> {
+    handle::edit(config_json, |config| {
+        config.delete_from_name_hash_many(names)
+    })
+}
+
+/// Add many values to the SSN_LAST4_HASH array
+///
+/// # Arguments
+///
+/// * `config_json` - Configuration JSON string
+/// * `names` - Values to add
+///
+/// # Returns
+///
+/// Returns modified configuration JSON on success
+///
+/// # Errors
+///
+/// * `AlreadyExists` if a value is already present or listed twice (nothing is added)
+/// * `NotFound` if SYS_OOM doesn't exist
+pub fn add_to_ssn_last4_hash_many(config_json: &str, names: &[&str]) -> Result<String> {
+    handle::edit(config_json, |config| {
+        config.add_to_ssn_last4_hash_many(names)
+    })
+}
+
+/// Delete many values from the SSN_LAST4_HASH array
+///
+/// # Arguments
+///
+/// * `config_json` - Configuration JSON string
+/// * `names` - Values to remove
+///
+/// # Returns
+///
+/// Returns modified configuration JSON on success
+///
+/// # Errors
+///
+/// * `NotFound` if a value is not present or listed twice (nothing is removed)
+pub fn delete_from_ssn_last4_hash_many(config_json: &str, names: &[&str]) -> Result<String> {
+    handle::edit(config_json, |config| {
+        config.delete_from_ssn_last4_hash_many(names)
+    })
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_name_hash_many_round_trip() {
+        let mut config = ConfigHandle::from_json(r#"{"G2_CONFIG": {"SYS_OOM": {}}}"#).unwrap();
+
+        config
+            .add_to_name_hash_many(&["JOHN", "MARY", "SMITH"])
+            .unwrap();
+        assert!(matches!(
+            config.add_to_name_hash_many(&["BOB", "MARY"]),
+            Err(SzConfigError::AlreadyExists(_))
+        ));
+        assert!(matches!(
+            config.delete_from_name_hash_many(&["JOHN", "BOB"]),
+            Err(SzConfigError::NotFound(_))
+        ));
+
+        // Failed calls changed nothing
+        let hash = &config.as_value()["G2_CONFIG"]["SYS_OOM"]["NAME_HASH"];
+        assert_eq!(hash, &json!(["JOHN", "MARY", "SMITH"]));
+
+        config
+            .delete_from_name_hash_many(&["SMITH", "JOHN"])
+            .unwrap();
+        let hash = &config.as_value()["G2_CONFIG"]["SYS_OOM"]["NAME_HASH"];
+        assert_eq!(hash, &json!(["MARY"]));
     }
 
-    Ok(serde_json::to_string(&config_data)?)
+    #[test]
+    fn test_ssn_last4_delete_many_removes_first_occurrence() {
+        let mut config = ConfigHandle::from_json(
+            r#"{"G2_CONFIG": {"SYS_OOM": {"SSN_LAST4_HASH": ["1234", "5678", "1234"]}}}"#,
+        )
+        .unwrap();
+
+        config.delete_from_ssn_last4_hash_many(&["1234"]).unwrap();
+        let hash = &config.as_value()["G2_CONFIG"]["SYS_OOM"]["SSN_LAST4_HASH"];
+        assert_eq!(hash, &json!(["5678", "1234"]));
+    }
 }
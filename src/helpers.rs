@@ -1,10 +1,17 @@
 use crate::error::{Result, SzConfigError};
+use crate::handle::{self, ConfigHandle};
 use serde_json::Value;
+use std::sync::Mutex;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::thread;
 
 /// Get the next available ID for a config array
 ///
 /// Finds the maximum value of the specified ID field and returns max + 1
 ///
+/// Scans the whole array; for repeated inserts into a [`ConfigHandle`] use
+/// [`ConfigHandle::next_id`], which keeps the result between inserts.
+///
 /// # Arguments
 /// * `array` - Array of configuration items
 /// * `id_field` - Name of the ID field (e.g., "DSRC_ID", "ATTR_ID")
@@ -27,6 +34,9 @@ pub fn get_next_id_from_array(array: &[Value], id_field: &str) -> Result<i64> {
 /// Navigates to a config section using a path and finds the next available ID.
 /// Useful for user-created items that should start at a specific ID (e.g., 1000).
 ///
+/// Scans the whole array; for repeated inserts into a [`ConfigHandle`] use
+/// [`ConfigHandle::next_id`], which keeps the result between inserts.
+///
 /// # Arguments
 /// * `config_data` - Parsed configuration JSON Value
 /// * `section_path` - Dot-separated path (e.g., "G2_CONFIG.CFG_SFCALL")
@@ -73,6 +83,9 @@ pub fn get_next_id(
 /// Finds the maximum value of the specified ID field and returns max(max_id + 1, min_value)
 /// This is useful for user-created items that should start at a high ID (e.g., 1000)
 ///
+/// Scans the whole array; for repeated inserts into a [`ConfigHandle`] use
+/// [`ConfigHandle::next_id`], which keeps the result between inserts.
+///
 /// # Arguments
 /// * `array` - Array of configuration items
 /// * `id_field` - Name of the ID field (e.g., "FTYPE_ID", "FELEM_ID")
@@ -93,6 +106,8 @@ pub fn get_next_id_with_min(array: &[Value], id_field: &str, min_value: i64) ->
 
 /// Check if an ID is already taken in a config array
 ///
+/// Scans the whole array; [`ConfigHandle::is_id_taken`] keeps a set of used IDs.
+///
 /// # Arguments
 /// * `array` - Array of configuration items
 /// * `id_field` - Name of the ID field (e.g., "DSRC_ID", "ATTR_ID")
@@ -226,6 +241,141 @@ pub fn find_in_array_mut<'a>(
     })
 }
 
+impl ConfigHandle {
+    /// Add item to a config array section (in-place form of [`add_to_config_array`])
+    pub fn add_to_config_array(&mut self, section: &str, item: Value) -> Result<()> {
+        self.push_row(section, item)
+    }
+
+    /// Delete items matching a field value (in-place form of [`delete_from_config_array`])
+    pub fn delete_from_config_array(
+        &mut self,
+        section: &str,
+        field: &str,
+        value: &str,
+    ) -> Result<()> {
+        let array = self.section_mut(section)?;
+
+        let original_len = array.len();
+        array.retain(|item| {
+            item.get(field)
+                .and_then(|v| v.as_str())
+                .map(|s| s != value)
+                .unwrap_or(true)
+        });
+
+        if array.len() == original_len {
+            return Err(SzConfigError::NotFound(format!(
+                "{} '{}' not found",
+                section, value
+            )));
+        }
+
+        Ok(())
+    }
+
+    /// Find item in a config array section by string or numeric field value
+    ///
+    /// Returns None if the section or the item doesn't exist.
+    pub fn find_in_config_array(&self, section: &str, field: &str, value: &str) -> Option<&Value> {
+        self.section(section).ok()?.iter().find(|item| {
+            item.get(field)
+                .and_then(|v| v.as_str())
+                .map(|s| s == value)
+                .or_else(|| {
+                    // Also try numeric comparison
+                    item.get(field)
+                        .and_then(|v| v.as_i64())
+                        .and_then(|id| value.parse::<i64>().ok().map(|val| id == val))
+                })
+                .unwrap_or(false)
+        })
+    }
+
+    /// Replace an item in a config array section (in-place form of [`update_in_config_array`])
+    pub fn update_in_config_array(
+        &mut self,
+        section: &str,
+        field: &str,
+        value: &str,
+        new_item: Value,
+    ) -> Result<()> {
+        let array = self.section_mut(section)?;
+
+        let item = find_in_array_mut(array, field, value)
+            .ok_or_else(|| SzConfigError::NotFound(format!("{} '{}' not found", section, value)))?;
+
+        // Replace the entire item
+        *item = new_item;
+
+        Ok(())
+    }
+
+    /// List all items in a config array section (empty if the section doesn't exist)
+    pub fn list_from_config_array(&self, section: &str) -> Vec<Value> {
+        self.section(section).cloned().unwrap_or_default()
+    }
+
+    /// Lookup feature ID by feature code (case-insensitive)
+    pub fn lookup_feature_id(&self, feature_code: &str) -> Result<i64> {
+        self.lookup_id("CFG_FTYPE", "FTYPE_CODE", "FTYPE_ID", feature_code)
+            .ok_or_else(|| SzConfigError::NotFound(format!("Feature '{}' not found", feature_code)))
+    }
+
+    /// Lookup element ID by element code (case-insensitive)
+    pub fn lookup_element_id(&self, element_code: &str) -> Result<i64> {
+        self.lookup_id("CFG_FELEM", "FELEM_CODE", "FELEM_ID", element_code)
+            .ok_or_else(|| SzConfigError::NotFound(format!("Element '{}' not found", element_code)))
+    }
+
+    /// Lookup standardize function ID by function code (case-insensitive)
+    pub fn lookup_sfunc_id(&self, func_code: &str) -> Result<i64> {
+        self.lookup_id("CFG_SFUNC", "SFUNC_CODE", "SFUNC_ID", func_code)
+            .ok_or_else(|| {
+                SzConfigError::NotFound(format!("Standardize function '{}' not found", func_code))
+            })
+    }
+
+    /// Lookup expression function ID by function code (case-insensitive)
+    pub fn lookup_efunc_id(&self, func_code: &str) -> Result<i64> {
+        self.lookup_id("CFG_EFUNC", "EFUNC_CODE", "EFUNC_ID", func_code)
+            .ok_or_else(|| {
+                SzConfigError::NotFound(format!("Expression function '{}' not found", func_code))
+            })
+    }
+
+    /// Lookup comparison function ID by function code (case-insensitive)
+    pub fn lookup_cfunc_id(&self, func_code: &str) -> Result<i64> {
+        self.lookup_id("CFG_CFUNC", "CFUNC_CODE", "CFUNC_ID", func_code)
+            .ok_or_else(|| {
+                SzConfigError::NotFound(format!("Comparison function '{}' not found", func_code))
+            })
+    }
+
+    /// Lookup distinct function ID by function code (case-insensitive)
+    pub fn lookup_dfunc_id(&self, func_code: &str) -> Result<i64> {
+        self.lookup_id("CFG_DFUNC", "DFUNC_CODE", "DFUNC_ID", func_code)
+            .ok_or_else(|| {
+                SzConfigError::NotFound(format!("Distinct function '{}' not found", func_code))
+            })
+    }
+
+    /// Lookup generic plan ID by plan code (case-insensitive)
+    pub fn lookup_gplan_id(&self, plan_code: &str) -> Result<i64> {
+        self.lookup_id("CFG_GPLAN", "GPLAN_CODE", "GPLAN_ID", plan_code)
+            .ok_or_else(|| {
+                SzConfigError::NotFound(format!("Generic plan '{}' not found", plan_code))
+            })
+    }
+
+    /// Internal: Lookup generic plan code by plan ID (for FFI use)
+    pub(crate) fn lookup_gplan_code(&self, gplan_id: i64) -> Result<String> {
+        self.lookup_code("CFG_GPLAN", "GPLAN_CODE", "GPLAN_ID", gplan_id)
+            .map(|s| s.to_string())
+            .ok_or_else(|| SzConfigError::NotFound(format!("Generic plan ID: {}", gplan_id)))
+    }
+}
+
 /// Add item to config array (generic)
 ///
 /// # Arguments
@@ -240,18 +390,9 @@ pub fn find_in_array_mut<'a>(
 /// - `JsonParse` if config_json is invalid
 /// - `MissingSection` if section doesn't exist
 pub fn add_to_config_array(config_json: &str, section: &str, item: Value) -> Result<String> {
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let array = config
-        .get_mut("G2_CONFIG")
-        .and_then(|g| g.get_mut(section))
-        .and_then(|v| v.as_array_mut())
-        .ok_or_else(|| SzConfigError::MissingSection(section.to_string()))?;
-
-    array.push(item);
-
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config_json, |config| {
+        config.add_to_config_array(section, item)
+    })
 }
 
 /// Delete item from config array by field value
@@ -275,31 +416,9 @@ pub fn delete_from_config_array(
     field: &str,
     value: &str,
 ) -> Result<String> {
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let array = config
-        .get_mut("G2_CONFIG")
-        .and_then(|g| g.get_mut(section))
-        .and_then(|v| v.as_array_mut())
-        .ok_or_else(|| SzConfigError::MissingSection(section.to_string()))?;
-
-    let original_len = array.len();
-    array.retain(|item| {
-        item.get(field)
-            .and_then(|v| v.as_str())
-            .map(|s| s != value)
-            .unwrap_or(true)
-    });
-
-    if array.len() == original_len {
-        return Err(SzConfigError::NotFound(format!(
-            "{} '{}' not found",
-            section, value
-        )));
-    }
-
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config_json, |config| {
+        config.delete_from_config_array(section, field, value)
+    })
 }
 
 /// Find item in config array by field value (returns owned value)
@@ -321,31 +440,9 @@ pub fn find_in_config_array(
     field: &str,
     value: &str,
 ) -> Result<Option<Value>> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let array = config
-        .get("G2_CONFIG")
-        .and_then(|g| g.get(section))
-        .and_then(|v| v.as_array());
-
-    if let Some(arr) = array {
-        let item = arr.iter().find(|item| {
-            item.get(field)
-                .and_then(|v| v.as_str())
-                .map(|s| s == value)
-                .or_else(|| {
-                    // Also try numeric comparison
-                    item.get(field)
-                        .and_then(|v| v.as_i64())
-                        .and_then(|id| value.parse::<i64>().ok().map(|val| id == val))
-                })
-                .unwrap_or(false)
-        });
-        Ok(item.cloned())
-    } else {
-        Ok(None)
-    }
+    handle::read_sections(config_json, &[section], |config| {
+        Ok(config.find_in_config_array(section, field, value).cloned())
+    })
 }
 
 /// Alias for delete_from_config_array for compatibility
@@ -376,22 +473,9 @@ pub fn update_in_config_array(
     value: &str,
     new_item: Value,
 ) -> Result<String> {
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let array = config
-        .get_mut("G2_CONFIG")
-        .and_then(|g| g.get_mut(section))
-        .and_then(|v| v.as_array_mut())
-        .ok_or_else(|| SzConfigError::MissingSection(section.to_string()))?;
-
-    let item = find_in_array_mut(array, field, value)
-        .ok_or_else(|| SzConfigError::NotFound(format!("{} '{}' not found", section, value)))?;
-
-    // Replace the entire item
-    *item = new_item;
-
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config_json, |config| {
+        config.update_in_config_array(section, field, value, new_item)
+    })
 }
 
 /// List all items from a config array
@@ -406,20 +490,9 @@ pub fn update_in_config_array(
 /// # Errors
 /// - `JsonParse` if config_json is invalid
 pub fn list_from_config_array(config_json: &str, section: &str) -> Result<Vec<Value>> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let items = if let Some(g2_config) = config.get("G2_CONFIG") {
-        if let Some(array) = g2_config.get(section).and_then(|v| v.as_array()) {
-            array.clone()
-        } else {
-            Vec::new()
-        }
-    } else {
-        Vec::new()
-    };
-
-    Ok(items)
+    handle::read_sections(config_json, &[section], |config| {
+        Ok(config.list_from_config_array(section))
+    })
 }
 
 /// Lookup feature ID by feature code
@@ -434,25 +507,9 @@ pub fn list_from_config_array(config_json: &str, section: &str) -> Result<Vec<Va
 /// # Errors
 /// Returns error if feature not found or JSON is invalid
 pub fn lookup_feature_id(config_json: &str, feature_code: &str) -> Result<i64> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    config
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_FTYPE"))
-        .and_then(|v| v.as_array())
-        .and_then(|arr| {
-            arr.iter()
-                .find(|f| {
-                    f.get("FTYPE_CODE")
-                        .and_then(|v| v.as_str())
-                        .map(|s| s.eq_ignore_ascii_case(feature_code))
-                        .unwrap_or(false)
-                })
-                .and_then(|f| f.get("FTYPE_ID"))
-                .and_then(|v| v.as_i64())
-        })
-        .ok_or_else(|| SzConfigError::NotFound(format!("Feature '{}' not found", feature_code)))
+    handle::read_sections(config_json, &["CFG_FTYPE"], |config| {
+        config.lookup_feature_id(feature_code)
+    })
 }
 
 /// Lookup element ID by element code
@@ -467,25 +524,9 @@ pub fn lookup_feature_id(config_json: &str, feature_code: &str) -> Result<i64> {
 /// # Errors
 /// Returns error if element not found or JSON is invalid
 pub fn lookup_element_id(config_json: &str, element_code: &str) -> Result<i64> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    config
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_FELEM"))
-        .and_then(|v| v.as_array())
-        .and_then(|arr| {
-            arr.iter()
-                .find(|e| {
-                    e.get("FELEM_CODE")
-                        .and_then(|v| v.as_str())
-                        .map(|s| s.eq_ignore_ascii_case(element_code))
-                        .unwrap_or(false)
-                })
-                .and_then(|e| e.get("FELEM_ID"))
-                .and_then(|v| v.as_i64())
-        })
-        .ok_or_else(|| SzConfigError::NotFound(format!("Element '{}' not found", element_code)))
+    handle::read_sections(config_json, &["CFG_FELEM"], |config| {
+        config.lookup_element_id(element_code)
+    })
 }
 
 /// Lookup standardize function ID by function code
@@ -500,27 +541,9 @@ pub fn lookup_element_id(config_json: &str, element_code: &str) -> Result<i64> {
 /// # Errors
 /// Returns error if function not found or JSON is invalid
 pub fn lookup_sfunc_id(config_json: &str, func_code: &str) -> Result<i64> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    config
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_SFUNC"))
-        .and_then(|v| v.as_array())
-        .and_then(|arr| {
-            arr.iter()
-                .find(|f| {
-                    f.get("SFUNC_CODE")
-                        .and_then(|v| v.as_str())
-                        .map(|s| s.eq_ignore_ascii_case(func_code))
-                        .unwrap_or(false)
-                })
-                .and_then(|f| f.get("SFUNC_ID"))
-                .and_then(|v| v.as_i64())
-        })
-        .ok_or_else(|| {
-            SzConfigError::NotFound(format!("Standardize function '{}' not found", func_code))
-        })
+    handle::read_sections(config_json, &["CFG_SFUNC"], |config| {
+        config.lookup_sfunc_id(func_code)
+    })
 }
 
 /// Lookup expression function ID by function code
@@ -535,27 +558,9 @@ pub fn lookup_sfunc_id(config_json: &str, func_code: &str) -> Result<i64> {
 /// # Errors
 /// Returns error if function not found or JSON is invalid
 pub fn lookup_efunc_id(config_json: &str, func_code: &str) -> Result<i64> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    config
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_EFUNC"))
-        .and_then(|v| v.as_array())
-        .and_then(|arr| {
-            arr.iter()
-                .find(|f| {
-                    f.get("EFUNC_CODE")
-                        .and_then(|v| v.as_str())
-                        .map(|s| s.eq_ignore_ascii_case(func_code))
-                        .unwrap_or(false)
-                })
-                .and_then(|f| f.get("EFUNC_ID"))
-                .and_then(|v| v.as_i64())
-        })
-        .ok_or_else(|| {
-            SzConfigError::NotFound(format!("Expression function '{}' not found", func_code))
-        })
+    handle::read_sections(config_json, &["CFG_EFUNC"], |config| {
+        config.lookup_efunc_id(func_code)
+    })
 }
 
 /// Lookup comparison function ID by function code
@@ -570,27 +575,9 @@ pub fn lookup_efunc_id(config_json: &str, func_code: &str) -> Result<i64> {
 /// # Errors
 /// Returns error if function not found or JSON is invalid
 pub fn lookup_cfunc_id(config_json: &str, func_code: &str) -> Result<i64> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    config
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_CFUNC"))
-        .and_then(|v| v.as_array())
-        .and_then(|arr| {
-            arr.iter()
-                .find(|f| {
-                    f.get("CFUNC_CODE")
-                        .and_then(|v| v.as_str())
-                        .map(|s| s.eq_ignore_ascii_case(func_code))
-                        .unwrap_or(false)
-                })
-                .and_then(|f| f.get("CFUNC_ID"))
-                .and_then(|v| v.as_i64())
-        })
-        .ok_or_else(|| {
-            SzConfigError::NotFound(format!("Comparison function '{}' not found", func_code))
-        })
+    handle::read_sections(config_json, &["CFG_CFUNC"], |config| {
+        config.lookup_cfunc_id(func_code)
+    })
 }
 
 /// Lookup distinct function ID by function code
@@ -605,27 +592,9 @@ pub fn lookup_cfunc_id(config_json: &str, func_code: &str) -> Result<i64> {
 /// # Errors
 /// Returns error if function not found or JSON is invalid
 pub fn lookup_dfunc_id(config_json: &str, func_code: &str) -> Result<i64> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    config
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_DFUNC"))
-        .and_then(|v| v.as_array())
-        .and_then(|arr| {
-            arr.iter()
-                .find(|f| {
-                    f.get("DFUNC_CODE")
-                        .and_then(|v| v.as_str())
-                        .map(|s| s.eq_ignore_ascii_case(func_code))
-                        .unwrap_or(false)
-                })
-                .and_then(|f| f.get("DFUNC_ID"))
-                .and_then(|v| v.as_i64())
-        })
-        .ok_or_else(|| {
-            SzConfigError::NotFound(format!("Distinct function '{}' not found", func_code))
-        })
+    handle::read_sections(config_json, &["CFG_DFUNC"], |config| {
+        config.lookup_dfunc_id(func_code)
+    })
 }
 
 /// Lookup generic plan ID by plan code
@@ -640,25 +609,9 @@ pub fn lookup_dfunc_id(config_json: &str, func_code: &str) -> Result<i64> {
 /// # Errors
 /// Returns error if plan not found or JSON is invalid
 pub fn lookup_gplan_id(config_json: &str, plan_code: &str) -> Result<i64> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    config
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_GPLAN"))
-        .and_then(|v| v.as_array())
-        .and_then(|arr| {
-            arr.iter()
-                .find(|p| {
-                    p.get("GPLAN_CODE")
-                        .and_then(|v| v.as_str())
-                        .map(|s| s.eq_ignore_ascii_case(plan_code))
-                        .unwrap_or(false)
-                })
-                .and_then(|p| p.get("GPLAN_ID"))
-                .and_then(|v| v.as_i64())
-        })
-        .ok_or_else(|| SzConfigError::NotFound(format!("Generic plan '{}' not found", plan_code)))
+    handle::read_sections(config_json, &["CFG_GPLAN"], |config| {
+        config.lookup_gplan_id(plan_code)
+    })
 }
 
 /// Internal: Lookup generic plan code by plan ID (for FFI use)
@@ -673,19 +626,38 @@ pub fn lookup_gplan_id(config_json: &str, plan_code: &str) -> Result<i64> {
 /// # Errors
 /// Returns error if plan not found or JSON is invalid
 pub(crate) fn lookup_gplan_code(config_json: &str, gplan_id: i64) -> Result<String> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    config
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CFG_GPLAN"))
-        .and_then(|v| v.as_array())
-        .and_then(|arr| {
-            arr.iter()
-                .find(|p| p.get("GPLAN_ID").and_then(|v| v.as_i64()) == Some(gplan_id))
-                .and_then(|p| p.get("GPLAN_CODE"))
-                .and_then(|v| v.as_str())
-                .map(|s| s.to_string())
-        })
-        .ok_or_else(|| SzConfigError::NotFound(format!("Generic plan ID: {}", gplan_id)))
+    handle::read_sections(config_json, &["CFG_GPLAN"], |config| {
+        config.lookup_gplan_code(gplan_id)
+    })
+}
+
+/// Run `job` for 0..count on up to `threads` threads, collecting in index order
+pub(crate) fn run_parallel<T, F>(count: usize, threads: usize, job: F) -> Vec<T>
+where
+    T: Send,
+    F: Fn(usize) -> T + Sync,
+{
+    if threads <= 1 || count <= 1 {
+        return (0..count).map(job).collect();
+    }
+
+    let next = AtomicUsize::new(0);
+    let slots: Vec<Mutex<Option<T>>> = (0..count).map(|_| Mutex::new(None)).collect();
+    thread::scope(|scope| {
+        for _ in 0..threads.min(count) {
+            scope.spawn(|| {
+                loop {
+                    let i = next.fetch_add(1, Ordering::Relaxed);
+                    if i >= count {
+                        break;
+                    }
+                    *slots[i].lock().unwrap() = Some(job(i));
+                }
+            });
+        }
+    });
+    slots
+        .into_iter()
+        .map(|slot| slot.into_inner().unwrap().expect("every job ran"))
+        .collect()
 }
@@ -0,0 +1,416 @@
+//! Code ↔ ID index for [`ConfigHandle`](crate::handle::ConfigHandle) lookups
+//!
+//! Resolving a code such as `"NAME"` to its `FTYPE_ID` is a case-insensitive
+//! scan of the section. A single operation may resolve several codes, so the
+//! handle keeps one lazily built index per section listed in [`INDEXED_SECTIONS`].
+//! An index is built on the first lookup and dropped whenever its section may
+//! have been modified (any mutable access to the section or to the document).
+//!
+//! New IDs are handed out by an [`IdAllocator`] per (section, ID field) that
+//! tracks the largest and the used IDs. It is built on first use, kept current
+//! by [`ConfigHandle::push_row`](crate::handle::ConfigHandle::push_row), and
+//! dropped like the indexes on any other mutable access.
+//!
+//! [`FieldIndex`]es, value → rows maps for filtered section reads, are only
+//! built on request (see
+//! [`ConfigHandle::index_field`](crate::handle::ConfigHandle::index_field)) and
+//! follow the same rules.
+
+use serde_json::Value;
+use std::collections::{HashMap, HashSet};
+use std::sync::OnceLock;
+
+/// Sections with an index: (section, code field, ID field)
+pub(crate) const INDEXED_SECTIONS: [(&str, &str, &str); 11] = [
+    ("CFG_FTYPE", "FTYPE_CODE", "FTYPE_ID"),
+    ("CFG_FELEM", "FELEM_CODE", "FELEM_ID"),
+    ("CFG_SFUNC", "SFUNC_CODE", "SFUNC_ID"),
+    ("CFG_EFUNC", "EFUNC_CODE", "EFUNC_ID"),
+    ("CFG_CFUNC", "CFUNC_CODE", "CFUNC_ID"),
+    ("CFG_DFUNC", "DFUNC_CODE", "DFUNC_ID"),
+    ("CFG_GPLAN", "GPLAN_CODE", "GPLAN_ID"),
+    ("CFG_DSRC", "DSRC_CODE", "DSRC_ID"),
+    ("CFG_ATTR", "ATTR_CODE", "ATTR_ID"),
+    ("CFG_ERFRAG", "ERFRAG_CODE", "ERFRAG_ID"),
+    ("CFG_ERRULE", "ERRULE_CODE", "ERRULE_ID"),
+];
+
+/// Position of a section in [`INDEXED_SECTIONS`]
+pub(crate) fn slot(section: &str, code_field: &str, id_field: &str) -> Option<usize> {
+    INDEXED_SECTIONS
+        .iter()
+        .position(|&(s, c, i)| s == section && c == code_field && i == id_field)
+}
+
+/// Code → ID and ID → code maps for one section
+///
+/// Codes are keyed in upper case. When several records share a code or an
+/// ID the first one wins, matching the linear scan it replaces. Codes of
+/// records without an integer ID are kept apart, so existence checks still
+/// see them.
+#[derive(Debug, Clone, Default)]
+pub(crate) struct SectionIndex {
+    by_code: HashMap<String, i64>,
+    by_id: HashMap<i64, String>,
+    unnumbered: HashSet<String>,
+}
+
+impl SectionIndex {
+    fn build(items: &[Value], code_field: &str, id_field: &str) -> Self {
+        let mut index = SectionIndex {
+            by_code: HashMap::with_capacity(items.len()),
+            by_id: HashMap::with_capacity(items.len()),
+            unnumbered: HashSet::new(),
+        };
+
+        for item in items {
+            let code = item.get(code_field).and_then(|v| v.as_str());
+            let Some(id) = item.get(id_field).and_then(|v| v.as_i64()) else {
+                if let Some(code) = code {
+                    index.unnumbered.insert(code.to_ascii_uppercase());
+                }
+                continue;
+            };
+            let Some(code) = code else {
+                continue;
+            };
+            index.by_code.entry(code.to_ascii_uppercase()).or_insert(id);
+            index.by_id.entry(id).or_insert_with(|| code.to_string());
+        }
+
+        index
+    }
+
+    /// ID for a code (case-insensitive)
+    pub(crate) fn id(&self, code: &str) -> Option<i64> {
+        self.by_code.get(&code.to_ascii_uppercase()).copied()
+    }
+
+    /// True if any record has the code (case-insensitive), with or without an ID
+    pub(crate) fn contains_code(&self, code: &str) -> bool {
+        let code = code.to_ascii_uppercase();
+        self.by_code.contains_key(&code) || self.unnumbered.contains(&code)
+    }
+
+    /// Code for an ID, as stored in the config
+    pub(crate) fn code(&self, id: i64) -> Option<&str> {
+        self.by_id.get(&id).map(|s| s.as_str())
+    }
+}
+
+/// Largest and used values of one ID field in a section
+#[derive(Debug, Clone, Default)]
+pub(crate) struct IdAllocator {
+    max: Option<i64>,
+    used: HashSet<i64>,
+}
+
+impl IdAllocator {
+    fn build(items: &[Value], id_field: &str) -> Self {
+        let mut ids = IdAllocator {
+            max: None,
+            used: HashSet::with_capacity(items.len()),
+        };
+        for item in items {
+            if let Some(id) = item.get(id_field).and_then(|v| v.as_i64()) {
+                ids.record(id);
+            }
+        }
+        ids
+    }
+
+    fn record(&mut self, id: i64) {
+        self.max = Some(self.max.map_or(id, |max| max.max(id)));
+        self.used.insert(id);
+    }
+
+    /// One more than the largest ID, at least `min` (1 for an empty section
+    /// without a minimum)
+    pub(crate) fn next(&self, min: Option<i64>) -> i64 {
+        match (self.max, min) {
+            (Some(max), Some(min)) => (max + 1).max(min),
+            (Some(max), None) => max + 1,
+            (None, Some(min)) => min,
+            (None, None) => 1,
+        }
+    }
+
+    /// True if a record already uses the ID
+    pub(crate) fn is_taken(&self, id: i64) -> bool {
+        self.used.contains(&id)
+    }
+}
+
+/// Rows of a section by the value of one field
+///
+/// Scalar values are keyed by [`scalar_key`]; rows whose field holds an array
+/// or object are kept apart and always returned as candidates.
+#[derive(Debug, Clone, Default)]
+pub(crate) struct FieldIndex {
+    by_value: HashMap<String, Vec<usize>>,
+    nested: Vec<usize>,
+}
+
+impl FieldIndex {
+    fn build(items: &[Value], field: &str) -> Self {
+        let mut index = FieldIndex::default();
+        for (position, item) in items.iter().enumerate() {
+            index.record(position, item, field);
+        }
+        index
+    }
+
+    fn record(&mut self, position: usize, item: &Value, field: &str) {
+        match item.get(field) {
+            Some(value @ (Value::Array(_) | Value::Object(_))) if !is_empty(value) => {
+                self.nested.push(position)
+            }
+            Some(value) => {
+                if let Some(key) = scalar_key(value) {
+                    self.by_value.entry(key).or_default().push(position);
+                }
+            }
+            None => {}
+        }
+    }
+
+    /// Rows whose field may equal `text` (case-insensitive), in row order
+    pub(crate) fn candidates(&self, text: &str) -> Vec<usize> {
+        let exact = self
+            .by_value
+            .get(&text.to_ascii_lowercase())
+            .map_or(&[][..], |rows| rows.as_slice());
+        if self.nested.is_empty() {
+            return exact.to_vec();
+        }
+
+        let mut rows: Vec<usize> = exact.iter().chain(&self.nested).copied().collect();
+        rows.sort_unstable();
+        rows
+    }
+}
+
+fn is_empty(value: &Value) -> bool {
+    match value {
+        Value::Array(items) => items.is_empty(),
+        Value::Object(map) => map.is_empty(),
+        _ => false,
+    }
+}
+
+/// Lower-case text of a scalar value, as compared by section filters
+pub(crate) fn scalar_key(value: &Value) -> Option<String> {
+    match value {
+        Value::String(s) => Some(s.to_ascii_lowercase()),
+        Value::Number(n) => Some(n.to_string()),
+        Value::Bool(b) => Some(b.to_string()),
+        _ => None,
+    }
+}
+
+/// Lazily built indexes for all [`INDEXED_SECTIONS`], plus ID allocators
+#[derive(Debug, Clone, Default)]
+pub(crate) struct LookupIndex {
+    sections: [OnceLock<SectionIndex>; INDEXED_SECTIONS.len()],
+    /// Keyed by (section, ID field)
+    ids: HashMap<(String, String), IdAllocator>,
+    /// Keyed by (section, field); only built on request
+    fields: HashMap<(String, String), FieldIndex>,
+}
+
+impl LookupIndex {
+    /// Index for a slot, built from `items` on first use
+    pub(crate) fn get(&self, slot: usize, items: &[Value]) -> &SectionIndex {
+        let (_, code_field, id_field) = INDEXED_SECTIONS[slot];
+        self.sections[slot].get_or_init(|| SectionIndex::build(items, code_field, id_field))
+    }
+
+    /// ID allocator for a section's ID field, built from `items` on first use
+    pub(crate) fn ids(&mut self, section: &str, id_field: &str, items: &[Value]) -> &IdAllocator {
+        self.ids
+            .entry((section.to_string(), id_field.to_string()))
+            .or_insert_with(|| IdAllocator::build(items, id_field))
+    }
+
+    /// Build (or rebuild) the value index of a section's field
+    pub(crate) fn build_field(&mut self, section: &str, field: &str, items: &[Value]) {
+        self.fields.insert(
+            (section.to_string(), field.to_string()),
+            FieldIndex::build(items, field),
+        );
+    }
+
+    /// Value index of a section's field, if one was built
+    pub(crate) fn field(&self, section: &str, field: &str) -> Option<&FieldIndex> {
+        if self.fields.is_empty() {
+            return None;
+        }
+        self.fields.get(&(section.to_string(), field.to_string()))
+    }
+
+    /// Record a row appended to a section (at `position`) in the indexes and
+    /// allocators that have been built, instead of dropping them
+    pub(crate) fn row_appended(&mut self, section: &str, position: usize, row: &Value) {
+        for (slot, &(name, code_field, id_field)) in INDEXED_SECTIONS.iter().enumerate() {
+            if name != section {
+                continue;
+            }
+            let Some(index) = self.sections[slot].get_mut() else {
+                continue;
+            };
+            let Some(code) = row.get(code_field).and_then(|v| v.as_str()) else {
+                continue;
+            };
+            match row.get(id_field).and_then(|v| v.as_i64()) {
+                Some(id) => {
+                    index.by_code.entry(code.to_ascii_uppercase()).or_insert(id);
+                    index.by_id.entry(id).or_insert_with(|| code.to_string());
+                }
+                None => {
+                    index.unnumbered.insert(code.to_ascii_uppercase());
+                }
+            }
+        }
+
+        for ((name, id_field), ids) in &mut self.ids {
+            if name == section
+                && let Some(id) = row.get(id_field.as_str()).and_then(|v| v.as_i64())
+            {
+                ids.record(id);
+            }
+        }
+
+        for ((name, field), index) in &mut self.fields {
+            if name == section {
+                index.record(position, row, field);
+            }
+        }
+    }
+
+    /// Drop the index and allocators of one section (no-op for sections
+    /// without either)
+    pub(crate) fn invalidate_section(&mut self, section: &str) {
+        for (slot, &(name, _, _)) in INDEXED_SECTIONS.iter().enumerate() {
+            if name == section {
+                self.sections[slot].take();
+            }
+        }
+        if !self.ids.is_empty() {
+            self.ids.retain(|(name, _), _| name != section);
+        }
+        if !self.fields.is_empty() {
+            self.fields.retain(|(name, _), _| name != section);
+        }
+    }
+
+    /// Drop every index and allocator
+    pub(crate) fn invalidate_all(&mut self) {
+        for index in &mut self.sections {
+            index.take();
+        }
+        self.ids.clear();
+        self.fields.clear();
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use serde_json::json;
+
+    #[test]
+    fn test_section_index_first_match_wins() {
+        let items = vec![
+            json!({"FTYPE_ID": 1, "FTYPE_CODE": "Name"}),
+            json!({"FTYPE_ID": 2, "FTYPE_CODE": "NAME"}),
+            json!({"FTYPE_ID": 3}),
+        ];
+        let index = SectionIndex::build(&items, "FTYPE_CODE", "FTYPE_ID");
+
+        assert_eq!(index.id("name"), Some(1));
+        assert_eq!(index.code(1), Some("Name"));
+        assert_eq!(index.code(2), Some("NAME"));
+        assert_eq!(index.code(3), None);
+    }
+
+    #[test]
+    fn test_section_index_sees_codes_without_ids() {
+        let items = vec![
+            json!({"DSRC_ID": 1, "DSRC_CODE": "TEST"}),
+            json!({"DSRC_CODE": "NO_ID"}),
+            json!({"DSRC_ID": "2", "DSRC_CODE": "TEXT_ID"}),
+        ];
+        let index = SectionIndex::build(&items, "DSRC_CODE", "DSRC_ID");
+
+        assert_eq!(index.id("no_id"), None);
+        assert!(index.contains_code("test"));
+        assert!(index.contains_code("no_id"));
+        assert!(index.contains_code("TEXT_ID"));
+        assert!(!index.contains_code("OTHER"));
+    }
+
+    #[test]
+    fn test_id_allocator_tracks_appends() {
+        let mut lookup = LookupIndex::default();
+        let items = vec![json!({"DSRC_ID": 1}), json!({"DSRC_ID": 7})];
+
+        let ids = lookup.ids("CFG_DSRC", "DSRC_ID", &items);
+        assert_eq!(ids.next(None), 8);
+        assert_eq!(ids.next(Some(1000)), 1000);
+        assert!(ids.is_taken(7) && !ids.is_taken(2));
+
+        lookup.row_appended("CFG_DSRC", 2, &json!({"DSRC_ID": 8}));
+        assert_eq!(lookup.ids("CFG_DSRC", "DSRC_ID", &[]).next(None), 9);
+
+        lookup.invalidate_section("CFG_DSRC");
+        assert_eq!(lookup.ids("CFG_DSRC", "DSRC_ID", &[]).next(None), 1);
+    }
+
+    #[test]
+    fn test_field_index_candidates() {
+        let mut lookup = LookupIndex::default();
+        let items = vec![
+            json!({"FTYPE_ID": 1, "FTYPE_CODE": "Name"}),
+            json!({"FTYPE_ID": 2, "FTYPE_CODE": ["NAME", "X"]}),
+            json!({"FTYPE_ID": 1}),
+        ];
+        lookup.build_field("CFG_FBOM", "FTYPE_CODE", &items);
+        lookup.build_field("CFG_FBOM", "FTYPE_ID", &items);
+
+        let codes = lookup.field("CFG_FBOM", "FTYPE_CODE").unwrap();
+        assert_eq!(codes.candidates("NAME"), vec![0, 1]);
+        assert_eq!(
+            lookup
+                .field("CFG_FBOM", "FTYPE_ID")
+                .unwrap()
+                .candidates("1"),
+            vec![0, 2]
+        );
+
+        lookup.row_appended("CFG_FBOM", 3, &json!({"FTYPE_ID": 1}));
+        assert_eq!(
+            lookup
+                .field("CFG_FBOM", "FTYPE_ID")
+                .unwrap()
+                .candidates("1"),
+            vec![0, 2, 3]
+        );
+
+        lookup.invalidate_section("CFG_FBOM");
+        assert!(lookup.field("CFG_FBOM", "FTYPE_ID").is_none());
+    }
+
+    #[test]
+    fn test_invalidate_section() {
+        let mut lookup = LookupIndex::default();
+        let slot = slot("CFG_FTYPE", "FTYPE_CODE", "FTYPE_ID").unwrap();
+        let items = vec![json!({"FTYPE_ID": 1, "FTYPE_CODE": "NAME"})];
+
+        assert_eq!(lookup.get(slot, &items).id("NAME"), Some(1));
+
+        // Stale until invalidated
+        assert_eq!(lookup.get(slot, &[]).id("NAME"), Some(1));
+        lookup.invalidate_section("CFG_FTYPE");
+        assert_eq!(lookup.get(slot, &[]).id("NAME"), None);
+    }
+}
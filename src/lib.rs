@@ -27,6 +27,7 @@
 //! - No display logic (no formatting, colors, or output)
 //! - Type-safe error handling
 //! - Parameters aligned with sz_configtool CLI commands
+//! - [`ConfigHandle`] for applying many edits with a single parse and serialize
 //!
 //! ## Example Usage
 //!
@@ -68,7 +69,11 @@
 //! ```
 
 pub mod error;
+pub mod handle;
 pub mod helpers;
+mod index;
+mod serial;
+mod sha256;
 
 // Core entity modules
 pub mod attributes;
@@ -79,13 +84,22 @@ pub mod features;
 pub mod thresholds;
 
 // Advanced operations modules
+pub mod batch_upgrade;
+pub mod binary;
 pub mod command_processor;
+pub mod compact;
 pub mod config_sections;
+pub mod diff;
+pub mod fingerprint;
 pub mod fragments;
 pub mod generic_plans;
 pub mod hashes;
+pub mod patch;
 pub mod rules;
+pub mod shared;
+pub mod snapshot;
 pub mod system_params;
+pub mod validate;
 pub mod versioning;
 
 // Function and call management modules
@@ -94,6 +108,7 @@ pub mod functions;
 
 // Re-export commonly used types
 pub use error::{Result, SzConfigError};
+pub use handle::ConfigHandle;
 
 // C FFI module
 pub mod ffi;
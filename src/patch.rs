@@ -0,0 +1,687 @@
+//! JSON Patch (RFC 6902) deltas between configurations
+//!
+//! The mutators return the whole modified configuration. To replicate or
+//! audit a change, [`diff`] turns two versions of a document into the list of
+//! `add` / `remove` / `replace` operations between them, and
+//! [`ConfigHandle::apply_patch`] applies such a list, so only the change has
+//! to be shipped or stored.
+//!
+//! Arrays are compared by position after stripping their common leading and
+//! trailing rows, so adding or deleting one record in a `CFG_*` section is a
+//! single operation regardless of the section size.
+//!
+//! # Example
+//!
+//! ```
+//! use sz_configtool_lib::datasources::AddDataSourceParams;
+//! use sz_configtool_lib::handle::ConfigHandle;
+//!
+//! let live = r#"{"G2_CONFIG":{"CFG_DSRC":[{"DSRC_ID":1,"DSRC_CODE":"TEST"}]}}"#;
+//! let mut config = ConfigHandle::from_json(live)?;
+//! let patch = config.edit_as_patch(|c| {
+//!     c.add_data_source(AddDataSourceParams {
+//!         code: "CUSTOMERS",
+//!         ..Default::default()
+//!     })
+//! })?;
+//! assert_eq!(patch[0]["op"], "add");
+//! assert_eq!(patch[0]["path"], "/G2_CONFIG/CFG_DSRC/1");
+//!
+//! // Replay the change on another copy of the live configuration
+//! let mut replica = ConfigHandle::from_json(live)?;
+//! replica.apply_patch(&patch)?;
+//! assert_eq!(replica.to_json()?, config.to_json()?);
+//! # Ok::<(), sz_configtool_lib::SzConfigError>(())
+//! ```
+
+use crate::error::{Result, SzConfigError};
+use crate::handle::{self, ConfigHandle};
+use crate::snapshot::{Before, Snapshot};
+use serde_json::{Value, json};
+use std::collections::BTreeSet;
+
+/// Compute the JSON Patch that turns `before` into `after`
+///
+/// # Returns
+/// JSON array of RFC 6902 operations (empty if the documents are equal)
+pub fn diff(before: &Value, after: &Value) -> Value {
+    let mut ops = Vec::new();
+    diff_values(&mut String::new(), before, after, &mut ops);
+    Value::Array(ops)
+}
+
+/// Compute the JSON Patch between two configuration JSON strings
+///
+/// # Returns
+/// JSON Patch as a compact JSON string
+///
+/// # Errors
+/// - `JsonParse` if either document is invalid
+pub fn diff_json(before_json: &str, after_json: &str) -> Result<String> {
+    let before: Value = serde_json::from_str(before_json)?;
+    let after: Value = serde_json::from_str(after_json)?;
+    Ok(diff(&before, &after).to_string())
+}
+
+/// Apply a JSON Patch to a configuration JSON string
+///
+/// # Arguments
+/// * `config_json` - Configuration JSON string
+/// * `patch` - JSON Patch (array of RFC 6902 operations)
+///
+/// # Returns
+/// Modified configuration JSON string
+///
+/// # Errors
+/// See [`ConfigHandle::apply_patch`]
+pub fn apply_patch(config_json: &str, patch: &Value) -> Result<String> {
+    handle::edit(config_json, |config| config.apply_patch(patch))
+}
+
+impl ConfigHandle {
+    /// Apply a JSON Patch (in-place form of [`apply_patch`])
+    ///
+    /// Supports all RFC 6902 operations (`add`, `remove`, `replace`, `move`,
+    /// `copy`, `test`). The patch is applied atomically: if any operation
+    /// fails, the operations before it are rolled back.
+    ///
+    /// # Errors
+    /// - `InvalidInput` if the patch is malformed or a `test` operation fails
+    /// - `NotFound` if an operation refers to a location that doesn't exist
+    pub fn apply_patch(&mut self, patch: &Value) -> Result<()> {
+        let ops = patch
+            .as_array()
+            .ok_or_else(|| SzConfigError::InvalidInput("Patch must be a JSON array".to_string()))?
+            .iter()
+            .enumerate()
+            .map(|(i, op)| PatchOp::parse(op).map_err(|e| annotate(i, e)))
+            .collect::<Result<Vec<_>>>()?;
+
+        // Only the sections the patch can change lose their lookup index
+        let mut sections = BTreeSet::new();
+        let mut whole_document = false;
+        for op in &ops {
+            for tokens in [Some(&op.path), op.from.as_ref()].into_iter().flatten() {
+                match tokens.as_slice() {
+                    [root, section, ..] if root == "G2_CONFIG" => {
+                        sections.insert(section.as_str());
+                    }
+                    _ => whole_document = true,
+                }
+            }
+        }
+        let root = if whole_document {
+            self.as_value_mut()
+        } else {
+            self.value_mut_in(sections)
+        };
+
+        let mut undo = Vec::new();
+        for (i, op) in ops.iter().enumerate() {
+            if let Err(e) = op.apply(root, &mut undo) {
+                while let Some(step) = undo.pop() {
+                    step.revert(root);
+                }
+                return Err(annotate(i, e));
+            }
+        }
+        Ok(())
+    }
+
+    /// Run an edit and return the JSON Patch of what it changed
+    ///
+    /// The handle is modified as by `f`; the returned patch turns the
+    /// configuration as it was before the call into the result. If `f` fails
+    /// the handle is rolled back to how it was before the call and the error
+    /// is returned.
+    ///
+    /// `f` runs under a [snapshot](crate::snapshot), so only the `G2_CONFIG`
+    /// members it mutates are copied and diffed (the whole document if it
+    /// takes [`as_value_mut`](Self::as_value_mut) or
+    /// [`g2_config_mut`](Self::g2_config_mut)).
+    pub fn edit_as_patch<F>(&mut self, f: F) -> Result<Value>
+    where
+        F: FnOnce(&mut ConfigHandle) -> Result<()>,
+    {
+        let snapshot = self.snapshot();
+        if let Err(e) = f(self) {
+            self.rollback(snapshot)?;
+            return Err(e);
+        }
+
+        let patch = self.patch_since(&snapshot)?;
+        self.release(snapshot)?;
+        Ok(patch)
+    }
+
+    /// The JSON Patch from the configuration at `snapshot` to the current one
+    ///
+    /// Diffs only the members saved since the snapshot; the snapshot stays
+    /// open.
+    pub(crate) fn patch_since(&mut self, snapshot: &Snapshot) -> Result<Value> {
+        let (root, undo) = self.undo_log();
+        let mut ops = Vec::new();
+        match undo.before(snapshot)? {
+            Before::Whole(before) => diff_values(&mut String::new(), &before, root, &mut ops),
+            Before::Sections(sections) => {
+                let g2_config = root.get("G2_CONFIG").and_then(|g| g.as_object());
+                let mut path = String::from("/G2_CONFIG");
+                let mut added = Vec::new();
+                // Same order as diff: changes and removals by old position,
+                // then additions by new position
+                for (_, key, old) in sections {
+                    let new = g2_config.and_then(|g| {
+                        let position = g.keys().position(|k| k == key)?;
+                        Some((position, &g[key]))
+                    });
+                    let len = push_token(&mut path, key);
+                    match (old, new) {
+                        (Some(old), Some((_, new))) => diff_values(&mut path, old, new, &mut ops),
+                        (Some(_), None) => ops.push(json!({"op": "remove", "path": path})),
+                        (None, Some((position, new))) => added.push((position, path.clone(), new)),
+                        (None, None) => {}
+                    }
+                    path.truncate(len);
+                }
+                added.sort_unstable_by_key(|&(position, ..)| position);
+                for (_, path, new) in added {
+                    ops.push(json!({"op": "add", "path": path, "value": new}));
+                }
+            }
+        }
+        Ok(Value::Array(ops))
+    }
+}
+
+/// Prefix an operation error with its position in the patch
+fn annotate(index: usize, e: SzConfigError) -> SzConfigError {
+    match e {
+        SzConfigError::NotFound(msg) => {
+            SzConfigError::NotFound(format!("Patch operation {}: {}", index, msg))
+        }
+        SzConfigError::InvalidInput(msg) => {
+            SzConfigError::InvalidInput(format!("Patch operation {}: {}", index, msg))
+        }
+        SzConfigError::MissingField(field) => {
+            SzConfigError::MissingField(format!("{} (patch operation {})", field, index))
+        }
+        other => other,
+    }
+}
+
+// ============================================================================
+// Diff
+// ============================================================================
+
+fn diff_values(path: &mut String, before: &Value, after: &Value, ops: &mut Vec<Value>) {
+    match (before, after) {
+        (Value::Object(a), Value::Object(b)) => {
+            for (key, old) in a {
+                let len = push_token(path, key);
+                match b.get(key) {
+                    Some(new) => diff_values(path, old, new, ops),
+                    None => ops.push(json!({"op": "remove", "path": path})),
+                }
+                path.truncate(len);
+            }
+            for (key, new) in b {
+                if !a.contains_key(key) {
+                    let len = push_token(path, key);
+                    ops.push(json!({"op": "add", "path": path, "value": new}));
+                    path.truncate(len);
+                }
+            }
+        }
+        (Value::Array(a), Value::Array(b)) => diff_arrays(path, a, b, ops),
+        _ if before == after => {}
+        _ => ops.push(json!({"op": "replace", "path": path, "value": after})),
+    }
+}
+
+/// Diff two arrays by position, after skipping their common prefix and suffix
+///
+/// Rows present in both middles are diffed pairwise; the surplus is removed
+/// (from the end, so earlier indexes stay valid) or added.
+fn diff_arrays(path: &mut String, a: &[Value], b: &[Value], ops: &mut Vec<Value>) {
+    let prefix = a.iter().zip(b).take_while(|(x, y)| x == y).count();
+    let suffix = a[prefix..]
+        .iter()
+        .rev()
+        .zip(b[prefix..].iter().rev())
+        .take_while(|(x, y)| x == y)
+        .count();
+    let old = &a[prefix..a.len() - suffix];
+    let new = &b[prefix..b.len() - suffix];
+    let paired = old.len().min(new.len());
+
+    for i in 0..paired {
+        let len = push_token(path, &(prefix + i).to_string());
+        diff_values(path, &old[i], &new[i], ops);
+        path.truncate(len);
+    }
+    for i in (paired..old.len()).rev() {
+        let len = push_token(path, &(prefix + i).to_string());
+        ops.push(json!({"op": "remove", "path": path}));
+        path.truncate(len);
+    }
+    for (i, value) in new.iter().enumerate().skip(paired) {
+        let len = push_token(path, &(prefix + i).to_string());
+        ops.push(json!({"op": "add", "path": path, "value": value}));
+        path.truncate(len);
+    }
+}
+
+/// Append an escaped JSON Pointer token, returning the length to truncate back to
+fn push_token(path: &mut String, token: &str) -> usize {
+    let len = path.len();
+    path.push('/');
+    for c in token.chars() {
+        match c {
+            '~' => path.push_str("~0"),
+            '/' => path.push_str("~1"),
+            c => path.push(c),
+        }
+    }
+    len
+}
+
+// ============================================================================
+// Apply
+// ============================================================================
+
+/// One parsed patch operation
+struct PatchOp {
+    kind: OpKind,
+    path: Vec<String>,
+    from: Option<Vec<String>>,
+    value: Option<Value>,
+}
+
+#[derive(Clone, Copy, PartialEq)]
+enum OpKind {
+    Add,
+    Remove,
+    Replace,
+    Move,
+    Copy,
+    Test,
+}
+
+impl PatchOp {
+    fn parse(op: &Value) -> Result<Self> {
+        let field = |name: &str| {
+            op.get(name)
+                .and_then(|v| v.as_str())
+                .ok_or_else(|| SzConfigError::MissingField(name.to_string()))
+        };
+
+        let kind = match field("op")? {
+            "add" => OpKind::Add,
+            "remove" => OpKind::Remove,
+            "replace" => OpKind::Replace,
+            "move" => OpKind::Move,
+            "copy" => OpKind::Copy,
+            "test" => OpKind::Test,
+            other => {
+                return Err(SzConfigError::InvalidInput(format!(
+                    "Unknown patch operation '{}'",
+                    other
+                )));
+            }
+        };
+
+        let value = match kind {
+            OpKind::Add | OpKind::Replace | OpKind::Test => Some(
+                op.get("value")
+                    .cloned()
+                    .ok_or_else(|| SzConfigError::MissingField("value".to_string()))?,
+            ),
+            _ => None,
+        };
+        let from = match kind {
+            OpKind::Move | OpKind::Copy => Some(parse_pointer(field("from")?)?),
+            _ => None,
+        };
+
+        Ok(Self {
+            kind,
+            path: parse_pointer(field("path")?)?,
+            from,
+            value,
+        })
+    }
+
+    fn apply(&self, root: &mut Value, undo: &mut Vec<Undo>) -> Result<()> {
+        match self.kind {
+            OpKind::Add => {
+                let value = self.value.clone().unwrap_or_default();
+                undo.push(insert(root, &self.path, value)?);
+            }
+            OpKind::Remove => {
+                let (_, step) = take(root, &self.path)?;
+                undo.push(step);
+            }
+            OpKind::Replace => {
+                let target = resolve(root, &self.path)?;
+                let old = std::mem::replace(target, self.value.clone().unwrap_or_default());
+                undo.push(Undo::Set {
+                    path: self.path.clone(),
+                    old,
+                });
+            }
+            OpKind::Move => {
+                let from = self.from.as_ref().expect("move has from");
+                if from == &self.path {
+                    return Ok(());
+                }
+                if self.path.starts_with(from) {
+                    return Err(SzConfigError::InvalidInput(format!(
+                        "Cannot move {} into itself",
+                        pointer(from)
+                    )));
+                }
+                let (value, step) = take(root, from)?;
+                undo.push(step);
+                undo.push(insert(root, &self.path, value)?);
+            }
+            OpKind::Copy => {
+                let from = self.from.as_ref().expect("copy has from");
+                let value = resolve(root, from)?.clone();
+                undo.push(insert(root, &self.path, value)?);
+            }
+            OpKind::Test => {
+                if resolve(root, &self.path)? != self.value.as_ref().expect("test has value") {
+                    return Err(SzConfigError::InvalidInput(format!(
+                        "Test failed at {}",
+                        pointer(&self.path)
+                    )));
+                }
+            }
+        }
+        Ok(())
+    }
+}
+
+/// How to revert one applied step
+enum Undo {
+    /// Put back the value at a location that was replaced
+    Set { path: Vec<String>, old: Value },
+    /// Remove a value that was added (object key or array element)
+    Remove { path: Vec<String> },
+    /// Put back an object key or array element that was removed
+    Restore {
+        path: Vec<String>,
+        position: usize,
+        old: Value,
+    },
+}
+
+impl Undo {
+    /// Revert the step (the document is in the state the step left it in)
+    fn revert(self, root: &mut Value) {
+        match self {
+            Undo::Set { path, old } => {
+                if let Ok(target) = resolve(root, &path) {
+                    *target = old;
+                }
+            }
+            Undo::Remove { path } => {
+                let _ = take(root, &path);
+            }
+            Undo::Restore {
+                mut path,
+                position,
+                old,
+            } => {
+                let Some(last) = path.pop() else {
+                    return;
+                };
+                match resolve(root, &path) {
+                    Ok(Value::Object(map)) => {
+                        map.shift_insert(position, last, old);
+                    }
+                    Ok(Value::Array(items)) => items.insert(position, old),
+                    _ => {}
+                }
+            }
+        }
+    }
+}
+
+/// Add `value` at `path` (RFC 6902 `add` semantics)
+fn insert(root: &mut Value, path: &[String], value: Value) -> Result<Undo> {
+    let Some((last, parent)) = path.split_last() else {
+        let old = std::mem::replace(root, value);
+        return Ok(Undo::Set {
+            path: Vec::new(),
+            old,
+        });
+    };
+
+    match resolve(root, parent)? {
+        Value::Object(map) => match map.get_mut(last) {
+            Some(existing) => {
+                let old = std::mem::replace(existing, value);
+                Ok(Undo::Set {
+                    path: path.to_vec(),
+                    old,
+                })
+            }
+            None => {
+                map.insert(last.clone(), value);
+                Ok(Undo::Remove {
+                    path: path.to_vec(),
+                })
+            }
+        },
+        Value::Array(items) => {
+            let index = if last == "-" {
+                items.len()
+            } else {
+                array_index(last, items.len() + 1, path)?
+            };
+            items.insert(index, value);
+            let mut path = path.to_vec();
+            *path.last_mut().expect("non-empty path") = index.to_string();
+            Ok(Undo::Remove { path })
+        }
+        _ => Err(not_found(path)),
+    }
+}
+
+/// Remove and return the value at `path` (RFC 6902 `remove` semantics)
+fn take(root: &mut Value, path: &[String]) -> Result<(Value, Undo)> {
+    let Some((last, parent)) = path.split_last() else {
+        return Err(SzConfigError::InvalidInput(
+            "Cannot remove the whole document".to_string(),
+        ));
+    };
+
+    let (position, old) = match resolve(root, parent)? {
+        Value::Object(map) => {
+            let position = map
+                .keys()
+                .position(|k| k == last)
+                .ok_or_else(|| not_found(path))?;
+            (position, map.shift_remove(last).expect("key present"))
+        }
+        Value::Array(items) => {
+            let index = array_index(last, items.len(), path)?;
+            (index, items.remove(index))
+        }
+        _ => return Err(not_found(path)),
+    };
+
+    let undo = Undo::Restore {
+        path: path.to_vec(),
+        position,
+        old: old.clone(),
+    };
+    Ok((old, undo))
+}
+
+/// Mutable reference to the value at `path`
+fn resolve<'a>(root: &'a mut Value, path: &[String]) -> Result<&'a mut Value> {
+    let mut current = root;
+    for (depth, token) in path.iter().enumerate() {
+        current = match current {
+            Value::Object(map) => map.get_mut(token),
+            Value::Array(items) => {
+                let index = array_index(token, items.len(), &path[..=depth])?;
+                items.get_mut(index)
+            }
+            _ => None,
+        }
+        .ok_or_else(|| not_found(&path[..=depth]))?;
+    }
+    Ok(current)
+}
+
+/// Parse an array index token, which must be below `bound`
+fn array_index(token: &str, bound: usize, path: &[String]) -> Result<usize> {
+    let valid = !token.is_empty()
+        && token.bytes().all(|b| b.is_ascii_digit())
+        && (token == "0" || !token.starts_with('0'));
+    match token.parse::<usize>() {
+        Ok(index) if valid && index < bound => Ok(index),
+        _ => Err(not_found(path)),
+    }
+}
+
+/// Split a JSON Pointer into unescaped tokens ("" is the whole document)
+fn parse_pointer(pointer: &str) -> Result<Vec<String>> {
+    if pointer.is_empty() {
+        return Ok(Vec::new());
+    }
+    let Some(rest) = pointer.strip_prefix('/') else {
+        return Err(SzConfigError::InvalidInput(format!(
+            "Invalid JSON Pointer '{}'",
+            pointer
+        )));
+    };
+    Ok(rest
+        .split('/')
+        .map(|token| token.replace("~1", "/").replace("~0", "~"))
+        .collect())
+}
+
+/// Format tokens back into a JSON Pointer
+fn pointer(path: &[String]) -> String {
+    let mut out = String::new();
+    for token in path {
+        push_token(&mut out, token);
+    }
+    out
+}
+
+fn not_found(path: &[String]) -> SzConfigError {
+    SzConfigError::NotFound(format!("Path not found: {}", pointer(path)))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_diff_round_trips() {
+        let before = json!({"G2_CONFIG": {
+            "CFG_DSRC": [{"DSRC_ID": 1, "DSRC_CODE": "A"}, {"DSRC_ID": 2, "DSRC_CODE": "B"},
+                         {"DSRC_ID": 3, "DSRC_CODE": "C"}],
+            "SYS_OOM": {"NAME_HASH": ["X"]},
+            "CFG_OLD": [],
+        }});
+        let after = json!({"G2_CONFIG": {
+            "CFG_DSRC": [{"DSRC_ID": 1, "DSRC_CODE": "A"}, {"DSRC_ID": 3, "DSRC_CODE": "C2"},
+                         {"DSRC_ID": 4, "DSRC_CODE": "D"}],
+            "SYS_OOM": {"NAME_HASH": ["X"], "a/b~c": 1},
+        }});
+
+        let patch = diff(&before, &after);
+        let mut config = ConfigHandle::from_value(before.clone());
+        config.apply_patch(&patch).unwrap();
+        assert_eq!(config.as_value(), &after);
+        assert!(patch.to_string().contains("/G2_CONFIG/SYS_OOM/a~1b~0c"));
+
+        assert_eq!(diff(&after, &after), json!([]));
+    }
+
+    #[test]
+    fn test_diff_single_row_delete_is_one_op() {
+        let rows: Vec<Value> = (0..100).map(|i| json!({"ID": i})).collect();
+        let mut fewer = rows.clone();
+        fewer.remove(40);
+
+        let patch = diff(&json!(rows), &json!(fewer));
+        assert_eq!(patch, json!([{"op": "remove", "path": "/40"}]));
+    }
+
+    #[test]
+    fn test_edit_as_patch_matches_full_diff() {
+        let before = json!({"G2_CONFIG": {
+            "CFG_DSRC": [{"DSRC_ID": 1, "DSRC_CODE": "A"}],
+            "SYS_OOM": {"NAME_HASH": ["X"]},
+            "CFG_ATTR": [],
+        }});
+        let edit = |c: &mut ConfigHandle| {
+            c.section_mut("CFG_ATTR")?.push(json!({"ATTR_ID": 1}));
+            // A snapshot left open inside the edit is folded into the patch
+            let _inner = c.snapshot();
+            c.push_row("CFG_DSRC", json!({"DSRC_ID": 2}))?;
+            c.g2_entry_mut("SYS_OOM").unwrap()["NAME_HASH"] = json!([]);
+            Ok(())
+        };
+
+        let mut expected = ConfigHandle::from_value(before.clone());
+        edit(&mut expected).unwrap();
+        let mut config = ConfigHandle::from_value(before.clone());
+        let outer = config.snapshot();
+        let patch = config.edit_as_patch(edit).unwrap();
+        assert_eq!(patch, diff(&before, expected.as_value()));
+
+        // Whole-document edits are diffed in full
+        let whole = config
+            .edit_as_patch(|c| {
+                c.g2_config_mut().unwrap().shift_remove("CFG_ATTR");
+                Ok(())
+            })
+            .unwrap();
+        assert_eq!(
+            whole,
+            json!([{"op": "remove", "path": "/G2_CONFIG/CFG_ATTR"}])
+        );
+
+        // A failed edit is undone
+        let edited = config.as_value().clone();
+        let err = config.edit_as_patch(|c| {
+            c.push_row("CFG_DSRC", json!({"DSRC_ID": 3}))?;
+            c.section_mut("CFG_MISSING").map(|_| ())
+        });
+        assert!(err.is_err());
+        assert_eq!(config.as_value(), &edited);
+
+        // The edits stay in the enclosing snapshot
+        config.rollback(outer).unwrap();
+        assert_eq!(config.as_value(), &before);
+    }
+
+    #[test]
+    fn test_apply_patch_rolls_back_on_failure() {
+        let json = r#"{"G2_CONFIG":{"CFG_DSRC":[{"DSRC_ID":1}],"SYS_OOM":{"A":1,"B":2}}}"#;
+        let mut config = ConfigHandle::from_json(json).unwrap();
+        let patch = json!([
+            {"op": "remove", "path": "/G2_CONFIG/SYS_OOM/A"},
+            {"op": "add", "path": "/G2_CONFIG/CFG_DSRC/0", "value": {"DSRC_ID": 0}},
+            {"op": "move", "from": "/G2_CONFIG/CFG_DSRC/1", "path": "/G2_CONFIG/CFG_DSRC/-"},
+            {"op": "test", "path": "/G2_CONFIG/CFG_DSRC/0/DSRC_ID", "value": 9},
+        ]);
+
+        let err = config.apply_patch(&patch).unwrap_err();
+        assert!(err.to_string().contains("Patch operation 3"));
+        assert_eq!(config.to_json().unwrap(), json);
+
+        let err = config
+            .apply_patch(&json!([{"op": "remove", "path": "/G2_CONFIG/CFG_DSRC/01"}]))
+            .unwrap_err();
+        assert!(matches!(err, SzConfigError::NotFound(_)));
+    }
+}
@@ -4,7 +4,7 @@
 //! Rules define matching and relationship logic based on fragments.
 
 use crate::error::{Result, SzConfigError};
-use crate::helpers;
+use crate::handle::{self, ConfigHandle};
 use serde_json::{Value, json};
 
 // ============================================================================
@@ -48,6 +48,134 @@ impl<'a> TryFrom<&'a Value> for SetRuleParams<'a> {
     }
 }
 
+impl ConfigHandle {
+    /// Add a new rule (in-place form of [`add_rule`])
+    ///
+    /// Returns the new rule ID.
+    pub fn add_rule(&mut self, rule_config: &Value) -> Result<i64> {
+        let code = rule_config
+            .get("ERRULE_CODE")
+            .and_then(|v| v.as_str())
+            .ok_or_else(|| SzConfigError::MissingField("ERRULE_CODE".to_string()))?;
+
+        // Get next ID
+        let next_id = if let Some(g2_config) = self.as_value().get("G2_CONFIG") {
+            if let Some(array) = g2_config.get("CFG_ERRULE").and_then(|v| v.as_array()) {
+                array
+                    .iter()
+                    .filter_map(|item| item.get("ERRULE_ID").and_then(|v| v.as_i64()))
+                    .max()
+                    .unwrap_or(0)
+                    + 1
+            } else {
+                1
+            }
+        } else {
+            return Err(SzConfigError::InvalidConfig(
+                "G2_CONFIG not found".to_string(),
+            ));
+        };
+
+        // Create new item with provided config plus ID
+        let mut new_item = rule_config.clone();
+        if let Some(obj) = new_item.as_object_mut() {
+            obj.insert("ERRULE_ID".to_string(), json!(next_id));
+            obj.insert("ERRULE_CODE".to_string(), json!(code.to_uppercase()));
+        }
+
+        // Add to config
+        self.add_to_config_array("CFG_ERRULE", new_item)?;
+
+        Ok(next_id)
+    }
+
+    /// Delete a rule (in-place form of [`delete_rule`])
+    pub fn delete_rule(&mut self, rule_code: &str) -> Result<()> {
+        let rule_code = rule_code.to_uppercase();
+
+        // Verify rule exists before deletion
+        if self
+            .find_in_config_array("CFG_ERRULE", "ERRULE_CODE", &rule_code)
+            .is_none()
+        {
+            return Err(SzConfigError::NotFound(format!(
+                "Rule not found: {}",
+                rule_code
+            )));
+        }
+
+        // Remove from config
+        self.delete_from_config_array("CFG_ERRULE", "ERRULE_CODE", &rule_code)
+    }
+
+    /// Get a rule by code or ID (see [`get_rule`])
+    pub fn get_rule(&self, code_or_id: &str) -> Result<Value> {
+        let search_value = code_or_id.to_uppercase();
+
+        // Try to find by CODE first, then by ID
+        self.find_in_config_array("CFG_ERRULE", "ERRULE_CODE", &search_value)
+            .or_else(|| self.find_in_config_array("CFG_ERRULE", "ERRULE_ID", &search_value))
+            .cloned()
+            .ok_or_else(|| SzConfigError::NotFound(format!("Rule not found: {}", search_value)))
+    }
+
+    /// List all rules (see [`list_rules`])
+    pub fn list_rules(&self) -> Vec<Value> {
+        // Extract rules and transform to Python format
+        self.section("CFG_ERRULE")
+            .map(|array| {
+                array
+                    .iter()
+                    .map(|item| {
+                        let resolve = item.get("RESOLVE").and_then(|v| v.as_str()).unwrap_or("");
+                        let tier = if resolve == "Yes" {
+                            item.get("ERRULE_TIER").and_then(|v| v.as_i64())
+                        } else {
+                            None
+                        };
+
+                        json!({
+                            "id": item.get("ERRULE_ID").and_then(|v| v.as_i64()).unwrap_or(0),
+                            "rule": item.get("ERRULE_CODE").and_then(|v| v.as_str()).unwrap_or(""),
+                            "resolve": resolve,
+                            "relate": item.get("RELATE").and_then(|v| v.as_str()).unwrap_or(""),
+                            "rtype_id": item.get("RTYPE_ID").and_then(|v| v.as_i64()).unwrap_or(0),
+                            "fragment": item.get("QUAL_ERFRAG_CODE").and_then(|v| v.as_str()).unwrap_or(""),
+                            "disqualifier": item.get("DISQ_ERFRAG_CODE").and_then(|v| v.as_str()).unwrap_or(""),
+                            "tier": tier
+                        })
+                    })
+                    .collect()
+            })
+            .unwrap_or_default()
+    }
+
+    /// Update an existing rule (in-place form of [`set_rule`])
+    pub fn set_rule(&mut self, params: SetRuleParams) -> Result<()> {
+        let code = params.code.to_uppercase();
+
+        // Build update object from params
+        let mut updated_item = json!({
+            "ERRULE_CODE": code.clone()
+        });
+
+        if let Some(obj) = updated_item.as_object_mut() {
+            if let Some(resolve) = params.resolve {
+                obj.insert("RESOLVE".to_string(), json!(resolve));
+            }
+            if let Some(relate) = params.relate {
+                obj.insert("RELATE".to_string(), json!(relate));
+            }
+            if let Some(rtype_id) = params.rtype_id {
+                obj.insert("RTYPE_ID".to_string(), json!(rtype_id));
+            }
+        }
+
+        // Update the item in the config
+        self.update_in_config_array("CFG_ERRULE", "ERRULE_CODE", &code, updated_item)
+    }
+}
+
 /// Add a new rule to the configuration
 ///
 /// # Arguments
@@ -76,42 +204,7 @@ impl<'a> TryFrom<&'a Value> for SetRuleParams<'a> {
 /// assert_eq!(rule_id, 1);
 /// ```
 pub fn add_rule(config_json: &str, rule_config: &Value) -> Result<(String, i64)> {
-    let code = rule_config
-        .get("ERRULE_CODE")
-        .and_then(|v| v.as_str())
-        .ok_or_else(|| SzConfigError::MissingField("ERRULE_CODE".to_string()))?;
-
-    let config_data: Value = serde_json::from_str(config_json)?;
-
-    // Get next ID
-    let next_id = if let Some(g2_config) = config_data.get("G2_CONFIG") {
-        if let Some(array) = g2_config.get("CFG_ERRULE").and_then(|v| v.as_array()) {
-            array
-                .iter()
-                .filter_map(|item| item.get("ERRULE_ID").and_then(|v| v.as_i64()))
-                .max()
-                .unwrap_or(0)
-                + 1
-        } else {
-            1
-        }
-    } else {
-        return Err(SzConfigError::InvalidConfig(
-            "G2_CONFIG not found".to_string(),
-        ));
-    };
-
-    // Create new item with provided config plus ID
-    let mut new_item = rule_config.clone();
-    if let Some(obj) = new_item.as_object_mut() {
-        obj.insert("ERRULE_ID".to_string(), json!(next_id));
-        obj.insert("ERRULE_CODE".to_string(), json!(code.to_uppercase()));
-    }
-
-    // Add to config
-    let modified_json = helpers::add_to_config_array(config_json, "CFG_ERRULE", new_item)?;
-
-    Ok((modified_json, next_id))
+    handle::edit_returning(config_json, |config| config.add_rule(rule_config))
 }
 
 /// Delete a rule from the configuration
@@ -134,14 +227,7 @@ pub fn add_rule(config_json: &str, rule_config: &Value) -> Result<(String, i64)>
 /// let modified = rules::delete_rule(config, "TEST").unwrap();
 /// ```
 pub fn delete_rule(config_json: &str, rule_code: &str) -> Result<String> {
-    let rule_code = rule_code.to_uppercase();
-
-    // Verify rule exists before deletion
-    let _ = helpers::find_in_config_array(config_json, "CFG_ERRULE", "ERRULE_CODE", &rule_code)?
-        .ok_or_else(|| SzConfigError::NotFound(format!("Rule not found: {}", rule_code)))?;
-
-    // Remove from config
-    helpers::remove_from_config_array(config_json, "CFG_ERRULE", "ERRULE_CODE", &rule_code)
+    handle::edit(config_json, |config| config.delete_rule(rule_code))
 }
 
 /// Get a rule by code or ID
@@ -164,23 +250,9 @@ pub fn delete_rule(config_json: &str, rule_code: &str) -> Result<String> {
 /// let rule = rules::get_rule(config, "TEST").unwrap();
 /// ```
 pub fn get_rule(config_json: &str, code_or_id: &str) -> Result<Value> {
-    let search_value = code_or_id.to_uppercase();
-
-    // Try to find by CODE first, then by ID
-    if let Some(item) =
-        helpers::find_in_config_array(config_json, "CFG_ERRULE", "ERRULE_CODE", &search_value)?
-    {
-        Ok(item)
-    } else if let Some(item) =
-        helpers::find_in_config_array(config_json, "CFG_ERRULE", "ERRULE_ID", &search_value)?
-    {
-        Ok(item)
-    } else {
-        Err(SzConfigError::NotFound(format!(
-            "Rule not found: {}",
-            search_value
-        )))
-    }
+    handle::read_sections(config_json, &["CFG_ERRULE"], |config| {
+        config.get_rule(code_or_id)
+    })
 }
 
 /// List all rules in the configuration
@@ -203,41 +275,9 @@ pub fn get_rule(config_json: &str, code_or_id: &str) -> Result<Value> {
 /// assert_eq!(rules.len(), 1);
 /// ```
 pub fn list_rules(config_json: &str) -> Result<Vec<Value>> {
-    let config_data: Value = serde_json::from_str(config_json)?;
-
-    // Extract rules and transform to Python format
-    let items: Vec<Value> = if let Some(g2_config) = config_data.get("G2_CONFIG") {
-        if let Some(array) = g2_config.get("CFG_ERRULE").and_then(|v| v.as_array()) {
-            array
-                .iter()
-                .map(|item| {
-                    let resolve = item.get("RESOLVE").and_then(|v| v.as_str()).unwrap_or("");
-                    let tier = if resolve == "Yes" {
-                        item.get("ERRULE_TIER").and_then(|v| v.as_i64())
-                    } else {
-                        None
-                    };
-
-                    json!({
-                        "id": item.get("ERRULE_ID").and_then(|v| v.as_i64()).unwrap_or(0),
-                        "rule": item.get("ERRULE_CODE").and_then(|v| v.as_str()).unwrap_or(""),
-                        "resolve": resolve,
-                        "relate": item.get("RELATE").and_then(|v| v.as_str()).unwrap_or(""),
-                        "rtype_id": item.get("RTYPE_ID").and_then(|v| v.as_i64()).unwrap_or(0),
-                        "fragment": item.get("QUAL_ERFRAG_CODE").and_then(|v| v.as_str()).unwrap_or(""),
-                        "disqualifier": item.get("DISQ_ERFRAG_CODE").and_then(|v| v.as_str()).unwrap_or(""),
-                        "tier": tier
-                    })
-                })
-                .collect()
-        } else {
-            Vec::new()
-        }
-    } else {
-        Vec::new()
-    };
-
-    Ok(items)
+    handle::read_sections(config_json, &["CFG_ERRULE"], |config| {
+        Ok(config.list_rules())
+    })
 }
 
 /// Update an existing rule in the configuration
@@ -267,31 +307,5 @@ pub fn list_rules(config_json: &str) -> Result<Vec<Value>> {
 /// let modified = rules::set_rule(config, params).unwrap();
 /// ```
 pub fn set_rule(config_json: &str, params: SetRuleParams) -> Result<String> {
-    let code = params.code.to_uppercase();
-
-    // Build update object from params
-    let mut updated_item = json!({
-        "ERRULE_CODE": code.clone()
-    });
-
-    if let Some(obj) = updated_item.as_object_mut() {
-        if let Some(resolve) = params.resolve {
-            obj.insert("RESOLVE".to_string(), json!(resolve));
-        }
-        if let Some(relate) = params.relate {
-            obj.insert("RELATE".to_string(), json!(relate));
-        }
-        if let Some(rtype_id) = params.rtype_id {
-            obj.insert("RTYPE_ID".to_string(), json!(rtype_id));
-        }
-    }
-
-    // Update the item in the config
-    helpers::update_in_config_array(
-        config_json,
-        "CFG_ERRULE",
-        "ERRULE_CODE",
-        &code,
-        updated_item,
-    )
+    handle::edit(config_json, |config| config.set_rule(params))
 }
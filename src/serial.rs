@@ -0,0 +1,522 @@
+//! Section-level serialization reuse for [`ConfigHandle`](crate::handle::ConfigHandle)
+//!
+//! A configuration is usually saved after touching a few `G2_CONFIG` members
+//! of a document that was itself parsed from compact JSON. [`scan`] records
+//! where each member's value sits in that text; serializing copies those bytes
+//! for every member not mutably accessed since (see the handle's
+//! `before_write`) and serializes only the dirty ones.
+//!
+//! The output is byte-identical to `serde_json::to_string` of the document, so
+//! a member is recorded only if its bytes are exactly what serde_json writes
+//! for the parsed value: no whitespace, integers only (float formatting is not
+//! checked), strings using serde_json's own escapes and no repeated object
+//! keys. Input that was pretty-printed or written by another serializer simply
+//! records nothing and is serialized in full.
+//!
+//! The cache holds no copy of the text by default; callers pass the text the
+//! spans were recorded in. Handles opened with
+//! [`ConfigHandle::from_json_cached`](crate::handle::ConfigHandle::from_json_cached)
+//! keep a shared copy instead. Nothing here locks, so shared readers can
+//! serialize concurrently.
+
+use serde_json::Value;
+use std::collections::{HashMap, HashSet};
+use std::io::{self, Write};
+use std::ops::Range;
+use std::sync::Arc;
+
+/// Limit on the keys of one object checked for repeats; larger objects are
+/// never reused (real configurations hold rows of a few dozen fields)
+const MAX_CHECKED_KEYS: usize = 256;
+
+type Spans = HashMap<String, Range<usize>>;
+
+/// Byte ranges of reusable `G2_CONFIG` members in a recorded text
+#[derive(Debug, Clone, Default)]
+pub(crate) struct SerialCache {
+    /// Value of each clean, canonical member
+    spans: Spans,
+    /// Length of the recorded text, to refuse a different one
+    text_len: usize,
+    /// The recorded text, when the handle keeps it
+    text: Option<Arc<str>>,
+}
+
+impl SerialCache {
+    /// Record the reusable members of `text` without keeping it
+    pub(crate) fn scan(text: &str) -> Self {
+        Self {
+            spans: scan(text),
+            text_len: text.len(),
+            text: None,
+        }
+    }
+
+    /// Record the reusable members of `text` and keep a shared copy of it
+    pub(crate) fn keeping(text: &str) -> Self {
+        let mut cache = Self::scan(text);
+        if !cache.spans.is_empty() {
+            cache.text = Some(Arc::from(text));
+        }
+        cache
+    }
+
+    /// Forget the bytes of `key` ("G2_CONFIG" for the whole document)
+    pub(crate) fn invalidate(&mut self, key: &str) {
+        if key == "G2_CONFIG" {
+            self.spans.clear();
+        } else {
+            self.spans.remove(key);
+        }
+        if self.spans.is_empty() {
+            self.text = None;
+        }
+    }
+
+    /// Serialize `root` as compact JSON, copying clean members from `text`
+    /// (the kept text when `None`)
+    pub(crate) fn write<W: Write>(
+        &self,
+        root: &Value,
+        text: Option<&str>,
+        writer: W,
+    ) -> io::Result<()> {
+        let reuse = self.reusable(text.or(self.text.as_deref()));
+        let mut writer = Counting {
+            inner: writer,
+            written: 0,
+        };
+        write_document(&mut writer, root, reuse, None)
+    }
+
+    /// Serialize `root` like [`write`](Self::write) and record the spans of
+    /// the output, which becomes the recorded text
+    pub(crate) fn rewrite(&mut self, root: &Value, text: &str) -> io::Result<String> {
+        let mut spans = Spans::new();
+        let mut writer = Counting {
+            inner: Vec::new(),
+            written: 0,
+        };
+        write_document(
+            &mut writer,
+            root,
+            self.reusable(Some(text)),
+            Some(&mut spans),
+        )?;
+        let out = String::from_utf8(writer.inner).map_err(io::Error::other)?;
+
+        self.spans = spans;
+        self.text_len = out.len();
+        if self.text.is_some() {
+            self.text = Some(Arc::from(out.as_str()));
+        }
+        Ok(out)
+    }
+
+    fn reusable<'a>(&'a self, text: Option<&'a str>) -> Option<(&'a str, &'a Spans)> {
+        text.filter(|text| text.len() == self.text_len && !self.spans.is_empty())
+            .map(|text| (text, &self.spans))
+    }
+}
+
+/// Byte ranges of the `G2_CONFIG` member values in `text` that are exactly
+/// what serde_json writes for them
+///
+/// `text` must already have parsed as JSON (that bounds the nesting depth);
+/// anything unexpected yields no spans.
+pub(crate) fn scan(text: &str) -> HashMap<String, Range<usize>> {
+    Scanner {
+        bytes: text.as_bytes(),
+        pos: 0,
+        keys: Vec::new(),
+    }
+    .document()
+    .unwrap_or_default()
+}
+
+fn write_document<W: Write>(
+    writer: &mut Counting<W>,
+    root: &Value,
+    reuse: Option<(&str, &Spans)>,
+    mut record: Option<&mut Spans>,
+) -> io::Result<()> {
+    let Value::Object(top) = root else {
+        return serde_json::to_writer(writer, root).map_err(io::Error::from);
+    };
+
+    writer.write_all(b"{")?;
+    for (i, (key, value)) in top.iter().enumerate() {
+        if i > 0 {
+            writer.write_all(b",")?;
+        }
+        write_key(writer, key)?;
+        let Value::Object(g2_config) = value else {
+            serde_json::to_writer(&mut *writer, value)?;
+            continue;
+        };
+        if key != "G2_CONFIG" {
+            serde_json::to_writer(&mut *writer, value)?;
+            continue;
+        }
+
+        writer.write_all(b"{")?;
+        for (j, (name, member)) in g2_config.iter().enumerate() {
+            if j > 0 {
+                writer.write_all(b",")?;
+            }
+            write_key(writer, name)?;
+            let start = writer.written;
+            match reuse.and_then(|(text, spans)| text.get(spans.get(name)?.clone())) {
+                Some(bytes) => writer.write_all(bytes.as_bytes())?,
+                None => serde_json::to_writer(&mut *writer, member)?,
+            }
+            if let Some(record) = record.as_deref_mut() {
+                record.insert(name.clone(), start..writer.written);
+            }
+        }
+        writer.write_all(b"}")?;
+    }
+    writer.write_all(b"}")
+}
+
+fn write_key<W: Write>(writer: &mut W, key: &str) -> io::Result<()> {
+    serde_json::to_writer(&mut *writer, key)?;
+    writer.write_all(b":")
+}
+
+/// Writer that counts the bytes written, for recording spans
+struct Counting<W> {
+    inner: W,
+    written: usize,
+}
+
+impl<W: Write> Write for Counting<W> {
+    fn write(&mut self, buf: &[u8]) -> io::Result<usize> {
+        let n = self.inner.write(buf)?;
+        self.written += n;
+        Ok(n)
+    }
+
+    fn flush(&mut self) -> io::Result<()> {
+        self.inner.flush()
+    }
+}
+
+/// Byte-level walk of already validated JSON
+///
+/// The value methods return `None` for unexpected input and otherwise whether
+/// the value is in serde_json's compact form.
+struct Scanner<'a> {
+    bytes: &'a [u8],
+    pos: usize,
+    /// Raw keys of the objects being walked, innermost last
+    keys: Vec<&'a [u8]>,
+}
+
+impl<'a> Scanner<'a> {
+    fn document(&mut self) -> Option<Spans> {
+        let mut spans = None;
+        self.skip_ws();
+        self.eat(b'{')?;
+        self.skip_ws();
+        if self.eat(b'}').is_some() {
+            return spans;
+        }
+        let mut seen_g2_config = false;
+        loop {
+            let (key, _) = self.string()?;
+            self.skip_ws();
+            self.eat(b':')?;
+            self.skip_ws();
+            if key == b"G2_CONFIG" {
+                // A repeated key keeps the first position but the last value
+                if seen_g2_config {
+                    return None;
+                }
+                seen_g2_config = true;
+            }
+            if key == b"G2_CONFIG" && self.peek() == Some(b'{') {
+                spans = Some(self.members()?);
+            } else {
+                self.value()?;
+            }
+            self.skip_ws();
+            if self.eat(b',').is_some() {
+                self.skip_ws();
+                continue;
+            }
+            self.eat(b'}')?;
+            return spans;
+        }
+    }
+
+    fn members(&mut self) -> Option<Spans> {
+        let mut spans = Spans::new();
+        let mut names = HashSet::new();
+        self.eat(b'{')?;
+        self.skip_ws();
+        if self.eat(b'}').is_some() {
+            return Some(spans);
+        }
+        loop {
+            let (name, _) = self.string()?;
+            // Names are looked up decoded, so escaped or repeated ones would
+            // need decoding to match; real configurations have neither
+            if name.contains(&b'\\') || !names.insert(name) {
+                return None;
+            }
+            self.skip_ws();
+            self.eat(b':')?;
+            self.skip_ws();
+            let start = self.pos;
+            if self.value()? {
+                let name = std::str::from_utf8(name).ok()?;
+                spans.insert(name.to_string(), start..self.pos);
+            }
+            self.skip_ws();
+            if self.eat(b',').is_some() {
+                self.skip_ws();
+                continue;
+            }
+            self.eat(b'}')?;
+            return Some(spans);
+        }
+    }
+
+    fn value(&mut self) -> Option<bool> {
+        match self.peek()? {
+            b'{' => self.object(),
+            b'[' => self.array(),
+            b'"' => self.string().map(|(_, canonical)| canonical),
+            b't' => self.literal(b"true"),
+            b'f' => self.literal(b"false"),
+            b'n' => self.literal(b"null"),
+            _ => self.number(),
+        }
+    }
+
+    fn object(&mut self) -> Option<bool> {
+        self.pos += 1;
+        let mut canonical = !self.skip_ws();
+        let first_key = self.keys.len();
+        if self.eat(b'}').is_none() {
+            loop {
+                let (key, plain) = self.string()?;
+                canonical &= plain;
+                // Only serde_json's escapes are allowed, so equal raw keys
+                // are exactly equal keys
+                if canonical {
+                    let keys = &self.keys[first_key..];
+                    canonical = keys.len() < MAX_CHECKED_KEYS && !keys.contains(&key);
+                    self.keys.push(key);
+                }
+                canonical &= !self.skip_ws();
+                self.eat(b':')?;
+                canonical &= !self.skip_ws();
+                canonical &= self.value()?;
+                canonical &= !self.skip_ws();
+                if self.eat(b',').is_some() {
+                    canonical &= !self.skip_ws();
+                    continue;
+                }
+                self.eat(b'}')?;
+                break;
+            }
+        }
+        self.keys.truncate(first_key);
+        Some(canonical)
+    }
+
+    fn array(&mut self) -> Option<bool> {
+        self.pos += 1;
+        let mut canonical = !self.skip_ws();
+        if self.eat(b']').is_some() {
+            return Some(canonical);
+        }
+        loop {
+            canonical &= self.value()?;
+            canonical &= !self.skip_ws();
+            if self.eat(b',').is_some() {
+                canonical &= !self.skip_ws();
+                continue;
+            }
+            self.eat(b']')?;
+            return Some(canonical);
+        }
+    }
+
+    /// Raw contents of a string, and whether it uses only serde_json's escapes
+    fn string(&mut self) -> Option<(&'a [u8], bool)> {
+        self.eat(b'"')?;
+        let start = self.pos;
+        let mut canonical = true;
+        loop {
+            match *self.bytes.get(self.pos)? {
+                b'"' => break,
+                b'\\' => {
+                    // serde_json writes '/' raw and \u only for control characters
+                    if !matches!(
+                        self.bytes.get(self.pos + 1)?,
+                        b'"' | b'\\' | b'n' | b'r' | b't' | b'b' | b'f'
+                    ) {
+                        canonical = false;
+                    }
+                    self.pos += 2;
+                }
+                0x00..=0x1f => return None,
+                _ => self.pos += 1,
+            }
+        }
+        let raw = &self.bytes[start..self.pos];
+        self.pos += 1;
+        Some((raw, canonical))
+    }
+
+    /// Canonical only for integers serde_json keeps as i64 or u64
+    fn number(&mut self) -> Option<bool> {
+        let start = self.pos;
+        while let Some(b'0'..=b'9' | b'-' | b'+' | b'.' | b'e' | b'E') = self.peek() {
+            self.pos += 1;
+        }
+        let number = std::str::from_utf8(&self.bytes[start..self.pos]).ok()?;
+        let (digits, fits) = match number.strip_prefix('-') {
+            // -0 parses as a float
+            Some(digits) => (digits, digits != "0" && number.parse::<i64>().is_ok()),
+            None => (number, number.parse::<u64>().is_ok()),
+        };
+        if digits.is_empty() {
+            return None;
+        }
+        let plain = digits.bytes().all(|b| b.is_ascii_digit())
+            && (digits.len() == 1 || !digits.starts_with('0'));
+        Some(fits && plain)
+    }
+
+    fn literal(&mut self, word: &[u8]) -> Option<bool> {
+        self.bytes[self.pos..].starts_with(word).then(|| {
+            self.pos += word.len();
+            true
+        })
+    }
+
+    fn peek(&self) -> Option<u8> {
+        self.bytes.get(self.pos).copied()
+    }
+
+    fn eat(&mut self, byte: u8) -> Option<()> {
+        (self.peek() == Some(byte)).then(|| self.pos += 1)
+    }
+
+    /// Skip whitespace; true if there was any
+    fn skip_ws(&mut self) -> bool {
+        let start = self.pos;
+        while let Some(b' ' | b'\n' | b'\r' | b'\t') = self.peek() {
+            self.pos += 1;
+        }
+        self.pos > start
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use serde_json::json;
+
+    fn render(cache: &SerialCache, root: &Value, text: Option<&str>) -> String {
+        let mut out = Vec::new();
+        cache.write(root, text, &mut out).unwrap();
+        String::from_utf8(out).unwrap()
+    }
+
+    #[test]
+    fn test_scan_records_only_canonical_members() {
+        let text = concat!(
+            r#"{"VERSION":1.5,"G2_CONFIG":{"CFG_A":[{"ID":1,"S":"é\"\n","N":null,"T":true}],"#,
+            r#""CFG_FLOAT":[1.0],"CFG_NEG0":[-0],"CFG_BIG":[18446744073709551616],"#,
+            r#""CFG_MIN":[-9223372036854775808],"CFG_SLASH":["a\/b"],"CFG_U":["\u0041"],"#,
+            r#""CFG_WS":[1, 2],"CFG_DUP":{"K":1,"K":2},"SYS_OOM":{}}}"#
+        );
+        let spans = scan(text);
+        let mut names: Vec<&str> = spans.keys().map(String::as_str).collect();
+        names.sort_unstable();
+        assert_eq!(names, ["CFG_A", "CFG_MIN", "SYS_OOM"]);
+
+        let root: Value = serde_json::from_str(text).unwrap();
+        for (name, span) in &spans {
+            let member = &root["G2_CONFIG"][name];
+            assert_eq!(&text[span.clone()], serde_json::to_string(member).unwrap());
+        }
+
+        // Escaped or repeated member names disable reuse
+        assert!(scan(r#"{"G2_CONFIG":{"CFG_\u0041":[],"CFG_A":[1]}}"#).is_empty());
+        assert!(scan(r#"{"G2_CONFIG":{"CFG_A":[],"CFG_A":[1]}}"#).is_empty());
+        assert!(scan(r#"{"G2_CONFIG":{"CFG_A":[]},"G2_CONFIG":{"CFG_A":[1]}}"#).is_empty());
+
+        // Whitespace outside the members is fine
+        let spans = scan("{\n  \"G2_CONFIG\" : { \"CFG_A\" : [1] }\n}");
+        assert_eq!(spans.len(), 1);
+    }
+
+    #[test]
+    fn test_matches_full_serialize() {
+        for text in [
+            r#"{"A":[1,"é\n"],"G2_CONFIG":{"CFG_X":[{"K":1.5}],"SYS\"Q":{},"CFG_Y":[7]},"Z":null}"#,
+            r#"{"G2_CONFIG":[]}"#,
+            "[1,2]",
+            "{}",
+            "{ \"G2_CONFIG\": {\"CFG_A\": [1, 2], \"CFG_B\": [\"\\u00e9\"]} }",
+        ] {
+            let root: Value = serde_json::from_str(text).unwrap();
+            let full = serde_json::to_string(&root).unwrap();
+            let cache = SerialCache::scan(text);
+            assert_eq!(render(&cache, &root, Some(text)), full, "{text}");
+            assert_eq!(render(&cache, &root, None), full, "{text}");
+        }
+    }
+
+    #[test]
+    fn test_reuses_only_clean_members() {
+        let text = r#"{"G2_CONFIG":{"CFG_A":[1],"CFG_B":[2]}}"#;
+        let mut cache = SerialCache::keeping(text);
+
+        // The document differs from the text in both members, so the text
+        // shows through wherever bytes are reused
+        let mut root = json!({"G2_CONFIG": {"CFG_A": [3], "CFG_B": ["changed"]}});
+        cache.invalidate("CFG_A");
+        assert_eq!(
+            render(&cache, &root, None),
+            r#"{"G2_CONFIG":{"CFG_A":[3],"CFG_B":[2]}}"#
+        );
+
+        // A text of another length is never sliced
+        assert_eq!(
+            render(&cache, &root, Some("{}")),
+            serde_json::to_string(&root).unwrap()
+        );
+
+        root["G2_CONFIG"].as_object_mut().unwrap().remove("CFG_B");
+        cache.invalidate("G2_CONFIG");
+        assert_eq!(
+            render(&cache, &root, None),
+            r#"{"G2_CONFIG":{"CFG_A":[3]}}"#
+        );
+        assert!(cache.text.is_none());
+    }
+
+    #[test]
+    fn test_rewrite_records_output() {
+        let text = r#"{"G2_CONFIG":{"CFG_A":[1],"CFG_B":[2.5]}}"#;
+        let mut cache = SerialCache::scan(text);
+        let mut root: Value = serde_json::from_str(text).unwrap();
+
+        root["G2_CONFIG"]["CFG_A"] = json!([1, 2]);
+        cache.invalidate("CFG_A");
+        let out = cache.rewrite(&root, text).unwrap();
+        assert_eq!(out, serde_json::to_string(&root).unwrap());
+
+        // Every member of the output is reusable, floats included
+        assert_eq!(cache.spans.len(), 2);
+        root["G2_CONFIG"]["CFG_B"] = json!("stale");
+        assert_eq!(render(&cache, &root, Some(&out)), out);
+    }
+}
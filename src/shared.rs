@@ -0,0 +1,307 @@
+//! A configuration shared between many reader threads
+//!
+//! [`SharedConfig`] holds the current configuration as an immutable
+//! [`ConfigHandle`] behind an `Arc`. Writers never modify it in place:
+//! [`update`](SharedConfig::update) applies an edit to a copy and publishes
+//! the copy as the new current configuration, so a reader always sees one
+//! whole version, before or after an edit.
+//!
+//! Readers go through a [`SharedReader`], one per thread. It keeps the `Arc`
+//! of the version it last saw together with that version's generation number,
+//! and [`SharedReader::get`] only loads the shared generation counter to check
+//! it is still current: one atomic load, no lock and no write to shared
+//! memory, so reads scale across cores. After a publish, each reader takes a
+//! short lock once to pick up the new version.
+//!
+//! A reader keeps the version it last saw alive until it next calls `get` (or
+//! is dropped), so memory for an old version is released once every reader
+//! has moved on.
+//!
+//! # Example
+//!
+//! ```
+//! use sz_configtool_lib::datasources::AddDataSourceParams;
+//! use sz_configtool_lib::shared::SharedConfig;
+//!
+//! let shared = SharedConfig::from_json(r#"{"G2_CONFIG":{"CFG_DSRC":[]}}"#)?;
+//!
+//! std::thread::scope(|s| {
+//!     for _ in 0..4 {
+//!         let mut reader = shared.reader();
+//!         s.spawn(move || {
+//!             let config = reader.get();
+//!             assert!(config.section("CFG_DSRC").is_ok());
+//!         });
+//!     }
+//! });
+//!
+//! let mut reader = shared.reader();
+//! shared.update(|config| {
+//!     config.add_data_source(AddDataSourceParams {
+//!         code: "CUSTOMERS",
+//!         ..Default::default()
+//!     })
+//! })?;
+//! assert_eq!(reader.get().section("CFG_DSRC")?.len(), 1);
+//! # Ok::<(), sz_configtool_lib::SzConfigError>(())
+//! ```
+
+use crate::error::Result;
+use crate::handle::ConfigHandle;
+use std::sync::atomic::{AtomicU64, AtomicUsize, Ordering};
+use std::sync::{Arc, Mutex, MutexGuard};
+
+/// A configuration read by many threads and occasionally replaced
+///
+/// Cloning is cheap; clones share the same configuration.
+#[derive(Debug)]
+pub struct SharedConfig {
+    inner: Arc<Inner>,
+}
+
+#[derive(Debug)]
+struct Inner {
+    /// Generation of `current`, bumped (under the `current` lock) on publish
+    generation: AtomicU64,
+    current: Mutex<Arc<ConfigHandle>>,
+    /// Serializes writers, so concurrent updates don't overwrite each other
+    writer: Mutex<()>,
+    /// Number of live `SharedConfig`s (readers not included)
+    owners: AtomicUsize,
+}
+
+impl Inner {
+    fn current(&self) -> MutexGuard<'_, Arc<ConfigHandle>> {
+        // Every critical section is a plain swap or clone of the Arc, so a
+        // poisoned lock still holds a whole version
+        self.current.lock().unwrap_or_else(|e| e.into_inner())
+    }
+
+    fn load(&self) -> (u64, Arc<ConfigHandle>) {
+        let current = self.current();
+        (
+            self.generation.load(Ordering::Relaxed),
+            Arc::clone(&current),
+        )
+    }
+}
+
+impl SharedConfig {
+    /// Share a configuration
+    pub fn new(config: ConfigHandle) -> Self {
+        Self {
+            inner: Arc::new(Inner {
+                generation: AtomicU64::new(0),
+                current: Mutex::new(Arc::new(config)),
+                writer: Mutex::new(()),
+                owners: AtomicUsize::new(1),
+            }),
+        }
+    }
+
+    /// Parse a configuration JSON string and share it
+    ///
+    /// # Errors
+    /// - `JsonParse` if config_json is invalid
+    pub fn from_json(config_json: &str) -> Result<Self> {
+        ConfigHandle::from_json(config_json).map(Self::new)
+    }
+
+    /// Create a reader for the calling thread
+    pub fn reader(&self) -> SharedReader {
+        let (generation, config) = self.inner.load();
+        SharedReader {
+            inner: Arc::clone(&self.inner),
+            generation,
+            config,
+        }
+    }
+
+    /// The current configuration
+    ///
+    /// Takes a short lock; threads that read repeatedly should keep a
+    /// [`SharedReader`] instead.
+    pub fn load(&self) -> Arc<ConfigHandle> {
+        self.inner.load().1
+    }
+
+    /// Number of configurations published so far (0 for the initial one)
+    pub fn generation(&self) -> u64 {
+        self.inner.generation.load(Ordering::Acquire)
+    }
+
+    /// Apply an edit to a copy of the current configuration and publish it
+    ///
+    /// Updates from several threads run one after the other, each on the
+    /// result of the previous one. If `f` fails nothing is published.
+    ///
+    /// # Errors
+    /// Whatever `f` returns
+    pub fn update<T, F>(&self, f: F) -> Result<T>
+    where
+        F: FnOnce(&mut ConfigHandle) -> Result<T>,
+    {
+        let _writer = self.inner.writer.lock().unwrap_or_else(|e| e.into_inner());
+        let mut config = ConfigHandle::clone(&self.load());
+        let value = f(&mut config)?;
+        self.store(config);
+        Ok(value)
+    }
+
+    /// Replace the current configuration
+    pub fn publish(&self, config: ConfigHandle) {
+        let _writer = self.inner.writer.lock().unwrap_or_else(|e| e.into_inner());
+        self.store(config);
+    }
+
+    fn store(&self, config: ConfigHandle) {
+        let config = Arc::new(config);
+        let previous = {
+            let mut current = self.inner.current();
+            let previous = std::mem::replace(&mut *current, config);
+            self.inner.generation.fetch_add(1, Ordering::Release);
+            previous
+        };
+        // Dropped outside the lock: the last reference may free a large document
+        drop(previous);
+    }
+}
+
+impl Clone for SharedConfig {
+    fn clone(&self) -> Self {
+        self.inner.owners.fetch_add(1, Ordering::Relaxed);
+        Self {
+            inner: Arc::clone(&self.inner),
+        }
+    }
+}
+
+impl Drop for SharedConfig {
+    fn drop(&mut self) {
+        self.inner.owners.fetch_sub(1, Ordering::Release);
+    }
+}
+
+/// A thread's view of a [`SharedConfig`]
+///
+/// `SharedReader` is `Send`, so it can be created on one thread and moved to
+/// the thread that uses it.
+#[derive(Debug)]
+pub struct SharedReader {
+    inner: Arc<Inner>,
+    generation: u64,
+    config: Arc<ConfigHandle>,
+}
+
+impl SharedReader {
+    /// The current configuration
+    ///
+    /// One atomic load while nothing has been published since the last call;
+    /// otherwise picks up the new version first.
+    pub fn get(&mut self) -> &ConfigHandle {
+        if self.inner.generation.load(Ordering::Acquire) != self.generation {
+            (self.generation, self.config) = self.inner.load();
+        }
+        &self.config
+    }
+
+    /// Generation of the configuration returned by the last [`get`](Self::get)
+    pub fn generation(&self) -> u64 {
+        self.generation
+    }
+
+    /// Whether this reader belongs to `shared`
+    pub fn reads(&self, shared: &SharedConfig) -> bool {
+        Arc::ptr_eq(&self.inner, &shared.inner)
+    }
+
+    /// Whether every [`SharedConfig`] this reader was created from is gone
+    ///
+    /// The configuration can no longer change; the reader only keeps the last
+    /// version alive.
+    pub fn is_detached(&self) -> bool {
+        self.inner.owners.load(Ordering::Acquire) == 0
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::datasources::AddDataSourceParams;
+    use crate::error::SzConfigError;
+
+    fn add(config: &mut ConfigHandle, code: &str) -> Result<()> {
+        config.add_data_source(AddDataSourceParams {
+            code,
+            ..Default::default()
+        })?;
+        Ok(())
+    }
+
+    #[test]
+    fn test_readers_see_published_versions() {
+        let shared = SharedConfig::from_json(r#"{"G2_CONFIG":{"CFG_DSRC":[]}}"#).unwrap();
+        let mut reader = shared.reader();
+        let before = Arc::clone(&reader.config);
+
+        shared.update(|config| add(config, "CUSTOMERS")).unwrap();
+        assert_eq!(shared.generation(), 1);
+        // The version a reader already holds is never modified
+        assert!(before.section("CFG_DSRC").unwrap().is_empty());
+        assert_eq!(reader.get().section("CFG_DSRC").unwrap().len(), 1);
+        assert_eq!(reader.generation(), 1);
+
+        let err = shared
+            .update(|config| add(config, "CUSTOMERS"))
+            .unwrap_err();
+        assert!(matches!(err, SzConfigError::AlreadyExists(_)));
+        assert_eq!(shared.generation(), 1);
+
+        shared.publish(ConfigHandle::from_json(r#"{"G2_CONFIG":{}}"#).unwrap());
+        assert!(reader.get().section("CFG_DSRC").is_err());
+        assert!(reader.reads(&shared));
+    }
+
+    #[test]
+    fn test_concurrent_updates_and_reads() {
+        let shared = SharedConfig::from_json(r#"{"G2_CONFIG":{"CFG_DSRC":[]}}"#).unwrap();
+
+        std::thread::scope(|s| {
+            for t in 0..4 {
+                let shared = &shared;
+                s.spawn(move || {
+                    for i in 0..25 {
+                        shared
+                            .update(|config| add(config, &format!("DS_{}_{}", t, i)))
+                            .unwrap();
+                    }
+                });
+            }
+            for _ in 0..4 {
+                let mut reader = shared.reader();
+                s.spawn(move || {
+                    let mut seen = 0;
+                    while seen < 100 {
+                        let rows = reader.get().section("CFG_DSRC").unwrap().len();
+                        // Versions only grow, one whole update at a time
+                        assert!(rows >= seen);
+                        seen = rows;
+                    }
+                });
+            }
+        });
+        assert_eq!(shared.generation(), 100);
+    }
+
+    #[test]
+    fn test_reader_detaches_when_owners_drop() {
+        let shared = SharedConfig::from_json(r#"{"G2_CONFIG":{}}"#).unwrap();
+        let other = shared.clone();
+        let mut reader = shared.reader();
+        drop(shared);
+        assert!(!reader.is_detached());
+        drop(other);
+        assert!(reader.is_detached());
+        assert!(reader.get().g2_config().is_some());
+    }
+}
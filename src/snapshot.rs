@@ -0,0 +1,367 @@
+//! Snapshots and rollback for [`ConfigHandle`]
+//!
+//! [`ConfigHandle::snapshot`] is O(1): it only opens an undo level. The first
+//! time a `G2_CONFIG` member is mutated after that, the handle saves a copy of
+//! that member (copy-on-write at section granularity), so
+//! [`ConfigHandle::rollback`] restores just the sections that changed and
+//! [`ConfigHandle::release`] simply drops the copies. Snapshots nest.
+//!
+//! Mutating through [`ConfigHandle::as_value_mut`] or
+//! [`ConfigHandle::g2_config_mut`] saves the whole document, since any member
+//! may change.
+//!
+//! # Example
+//!
+//! ```
+//! use sz_configtool_lib::datasources::AddDataSourceParams;
+//! use sz_configtool_lib::handle::ConfigHandle;
+//!
+//! let mut config = ConfigHandle::from_json(r#"{"G2_CONFIG":{"CFG_DSRC":[]}}"#)?;
+//! let before = config.to_json()?;
+//!
+//! let checkpoint = config.snapshot();
+//! config.add_data_source(AddDataSourceParams {
+//!     code: "CUSTOMERS",
+//!     ..Default::default()
+//! })?;
+//! config.rollback(checkpoint)?;
+//! assert_eq!(config.to_json()?, before);
+//!
+//! // All or nothing
+//! let result = config.transaction(|c| {
+//!     c.add_data_source(AddDataSourceParams { code: "A", ..Default::default() })?;
+//!     c.add_data_source(AddDataSourceParams { code: "A", ..Default::default() })
+//! });
+//! assert!(result.is_err());
+//! assert_eq!(config.to_json()?, before);
+//! # Ok::<(), sz_configtool_lib::SzConfigError>(())
+//! ```
+
+use crate::error::{Result, SzConfigError};
+use crate::handle::ConfigHandle;
+use serde_json::Value;
+use std::collections::HashMap;
+
+/// A checkpoint returned by [`ConfigHandle::snapshot`]
+///
+/// Pass it to [`ConfigHandle::rollback`] or [`ConfigHandle::release`]. Ending
+/// a snapshot also ends every snapshot taken after it.
+#[derive(Debug, PartialEq, Eq)]
+#[must_use = "a snapshot stays open (and keeps copies of changed sections) until released or rolled back"]
+pub struct Snapshot {
+    serial: u64,
+}
+
+impl Snapshot {
+    /// Numeric ID of the snapshot (used by the FFI)
+    pub fn id(&self) -> u64 {
+        self.serial
+    }
+
+    /// Snapshot with a given ID (see [`id`](Self::id))
+    pub fn from_id(id: u64) -> Self {
+        Self { serial: id }
+    }
+}
+
+/// Copies of the members changed since each open snapshot
+#[derive(Debug, Clone, Default)]
+pub(crate) struct UndoLog {
+    levels: Vec<Level>,
+    last_serial: u64,
+}
+
+#[derive(Debug, Clone)]
+struct Level {
+    serial: u64,
+    /// The whole document, once it was mutably accessed as a whole
+    whole: Option<Value>,
+    /// `G2_CONFIG` members as they were at their first mutation
+    sections: HashMap<String, Saved>,
+}
+
+#[derive(Debug, Clone)]
+struct Saved {
+    position: usize,
+    /// None if the member did not exist
+    value: Option<Value>,
+}
+
+impl UndoLog {
+    /// Save `key` ("G2_CONFIG" for the whole document) before it is mutated
+    pub(crate) fn save(&mut self, root: &Value, key: &str) {
+        let Some(level) = self.levels.last_mut() else {
+            return;
+        };
+        if level.whole.is_some() || level.sections.contains_key(key) {
+            return;
+        }
+
+        if key == "G2_CONFIG" {
+            level.whole = Some(root.clone());
+            return;
+        }
+
+        let g2_config = root.get("G2_CONFIG").and_then(|g| g.as_object());
+        let saved = match g2_config.and_then(|g| g.get(key)) {
+            Some(value) => Saved {
+                position: g2_config.map_or(0, |g| g.keys().position(|k| k == key).unwrap_or(0)),
+                value: Some(value.clone()),
+            },
+            None => Saved {
+                position: g2_config.map_or(0, |g| g.len()),
+                value: None,
+            },
+        };
+        level.sections.insert(key.to_string(), saved);
+    }
+
+    fn begin(&mut self) -> Snapshot {
+        self.last_serial += 1;
+        self.levels.push(Level {
+            serial: self.last_serial,
+            whole: None,
+            sections: HashMap::new(),
+        });
+        Snapshot {
+            serial: self.last_serial,
+        }
+    }
+
+    /// Number of levels to keep when ending `snapshot`
+    fn depth_of(&self, snapshot: &Snapshot) -> Result<usize> {
+        self.levels
+            .iter()
+            .position(|level| level.serial == snapshot.serial)
+            .ok_or_else(|| {
+                SzConfigError::InvalidInput(format!(
+                    "Snapshot {} is not open (already released or rolled back)",
+                    snapshot.serial
+                ))
+            })
+    }
+
+    /// Restore the document to `snapshot`, returning the restored keys
+    fn rollback(&mut self, root: &mut Value, snapshot: &Snapshot) -> Result<Vec<String>> {
+        let depth = self.depth_of(snapshot)?;
+        let mut restored = Vec::new();
+
+        while self.levels.len() > depth {
+            let level = self.levels.pop().expect("level above depth");
+            if let Some(whole) = level.whole {
+                *root = whole;
+                restored.push("G2_CONFIG".to_string());
+            }
+            for (key, saved) in level.sections {
+                restore(root, &key, saved);
+                restored.push(key);
+            }
+        }
+        Ok(restored)
+    }
+
+    /// Drop `snapshot`, keeping its changes
+    fn release(&mut self, snapshot: &Snapshot) -> Result<()> {
+        let depth = self.depth_of(snapshot)?;
+        self.collapse(depth);
+        Ok(())
+    }
+
+    /// What the document was at `snapshot`, as far as it changed since
+    ///
+    /// Snapshots taken after it are released into it first.
+    pub(crate) fn before(&mut self, snapshot: &Snapshot) -> Result<Before<'_>> {
+        let depth = self.depth_of(snapshot)?;
+        self.collapse(depth + 1);
+        let level = &self.levels[depth];
+
+        Ok(match &level.whole {
+            Some(whole) => {
+                let mut whole = whole.clone();
+                for (key, saved) in &level.sections {
+                    restore(&mut whole, key, saved.clone());
+                }
+                Before::Whole(whole)
+            }
+            None => {
+                let mut sections: Vec<_> = level
+                    .sections
+                    .iter()
+                    .map(|(key, saved)| (saved.position, key.as_str(), saved.value.as_ref()))
+                    .collect();
+                sections.sort_unstable_by_key(|&(position, key, _)| (position, key));
+                Before::Sections(sections)
+            }
+        })
+    }
+
+    /// End every level above `depth`, merging its copies into the one below
+    fn collapse(&mut self, depth: usize) {
+        while self.levels.len() > depth {
+            let level = self.levels.pop().expect("level above depth");
+            let Some(parent) = self.levels.last_mut() else {
+                continue;
+            };
+            if parent.whole.is_some() {
+                continue;
+            }
+
+            match level.whole {
+                // The parent needs the document as it was when `level` opened:
+                // the saved whole with the members saved before it put back
+                Some(mut whole) => {
+                    for (key, saved) in level.sections {
+                        restore(&mut whole, &key, saved);
+                    }
+                    parent.whole = Some(whole);
+                }
+                None => {
+                    for (key, saved) in level.sections {
+                        parent.sections.entry(key).or_insert(saved);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/// The state at a snapshot of what changed after it (see [`UndoLog::before`])
+pub(crate) enum Before<'a> {
+    /// The whole document, once it was mutably accessed as a whole
+    Whole(Value),
+    /// (position, name, value) of each mutated `G2_CONFIG` member in
+    /// position order; value is None if the member did not exist
+    Sections(Vec<(usize, &'a str, Option<&'a Value>)>),
+}
+
+/// Put a saved member back into `G2_CONFIG`
+fn restore(root: &mut Value, key: &str, saved: Saved) {
+    let Some(g2_config) = root.get_mut("G2_CONFIG").and_then(|g| g.as_object_mut()) else {
+        return;
+    };
+    match saved.value {
+        None => {
+            g2_config.shift_remove(key);
+        }
+        Some(value) => match g2_config.get_mut(key) {
+            Some(current) => *current = value,
+            None => {
+                let position = saved.position.min(g2_config.len());
+                g2_config.shift_insert(position, key.to_string(), value);
+            }
+        },
+    }
+}
+
+impl ConfigHandle {
+    /// Open a snapshot to roll back to later
+    ///
+    /// O(1); each section is copied when it is first mutated afterwards.
+    pub fn snapshot(&mut self) -> Snapshot {
+        self.undo_log().1.begin()
+    }
+
+    /// Restore the configuration to the state it had at `snapshot`
+    ///
+    /// Only the sections changed since the snapshot are restored. Ends the
+    /// snapshot and any taken after it.
+    ///
+    /// # Errors
+    /// - `InvalidInput` if the snapshot is not open
+    pub fn rollback(&mut self, snapshot: Snapshot) -> Result<()> {
+        let (root, undo) = self.undo_log();
+        for key in undo.rollback(root, &snapshot)? {
+            self.forget_section(&key);
+        }
+        Ok(())
+    }
+
+    /// End `snapshot` (and any taken after it), keeping the changes
+    ///
+    /// # Errors
+    /// - `InvalidInput` if the snapshot is not open
+    pub fn release(&mut self, snapshot: Snapshot) -> Result<()> {
+        self.undo_log().1.release(&snapshot)
+    }
+
+    /// Run `f` as a transaction: if it fails, every change it made is rolled back
+    pub fn transaction<T, F>(&mut self, f: F) -> Result<T>
+    where
+        F: FnOnce(&mut ConfigHandle) -> Result<T>,
+    {
+        let snapshot = self.snapshot();
+        match f(self) {
+            Ok(value) => {
+                self.release(snapshot)?;
+                Ok(value)
+            }
+            Err(e) => {
+                self.rollback(snapshot)?;
+                Err(e)
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use serde_json::json;
+
+    fn config() -> ConfigHandle {
+        ConfigHandle::from_value(json!({"G2_CONFIG": {
+            "CFG_DSRC": [{"DSRC_ID": 1, "DSRC_CODE": "A"}],
+            "CFG_ATTR": [],
+            "SYS_OOM": {},
+        }}))
+    }
+
+    #[test]
+    fn test_rollback_restores_changed_sections() {
+        let mut config = config();
+        let original = config.to_json().unwrap();
+
+        let outer = config.snapshot();
+        config
+            .push_row("CFG_DSRC", json!({"DSRC_ID": 2, "DSRC_CODE": "B"}))
+            .unwrap();
+        let inner = config.snapshot();
+        config.g2_config_mut().unwrap().shift_remove("CFG_DSRC");
+        config.g2_entry_mut("SYS_OOM").unwrap()["NAME_HASH"] = json!([]);
+        config.add_config_section("CFG_NEW").unwrap();
+        config.release(inner).unwrap();
+
+        config.rollback(outer).unwrap();
+        assert_eq!(config.to_json().unwrap(), original);
+        assert_eq!(
+            config.lookup_id("CFG_DSRC", "DSRC_CODE", "DSRC_ID", "B"),
+            None
+        );
+        assert_eq!(config.next_id("CFG_DSRC", "DSRC_ID", None).unwrap(), 2);
+    }
+
+    #[test]
+    fn test_nested_rollback_and_stale_snapshot() {
+        let mut config = config();
+        let outer = config.snapshot();
+        config
+            .section_mut("CFG_ATTR")
+            .unwrap()
+            .push(json!({"ATTR_ID": 1}));
+        let after_attr = config.to_json().unwrap();
+
+        let inner = config.snapshot();
+        let inner_id = inner.id();
+        config.section_mut("CFG_ATTR").unwrap().clear();
+        config.section_mut("CFG_DSRC").unwrap().clear();
+        config.rollback(inner).unwrap();
+        assert_eq!(config.to_json().unwrap(), after_attr);
+
+        assert!(matches!(
+            config.rollback(Snapshot::from_id(inner_id)),
+            Err(SzConfigError::InvalidInput(_))
+        ));
+        config.release(outer).unwrap();
+        assert_eq!(config.to_json().unwrap(), after_attr);
+    }
+}
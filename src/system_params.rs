@@ -4,9 +4,79 @@
 //! Currently supports the relationshipsBreakMatches parameter (BREAK_RES in RCLASS_ID=2).
 
 use crate::error::{Result, SzConfigError};
+use crate::handle::{self, ConfigHandle};
 use serde_json::Value;
 use std::collections::HashMap;
 
+impl ConfigHandle {
+    /// List all system parameters (see [`list_system_parameters`])
+    pub fn list_system_parameters(&self) -> HashMap<String, String> {
+        let mut params = HashMap::new();
+
+        // Find RCLASS_ID == 2 in CFG_RTYPE to get BREAK_RES value
+        if let Ok(rtype_array) = self.section("CFG_RTYPE") {
+            for rtype in rtype_array {
+                if let Some(rclass_id) = rtype.get("RCLASS_ID").and_then(|v| v.as_i64()) {
+                    if rclass_id == 2 {
+                        if let Some(break_res) = rtype.get("BREAK_RES").and_then(|v| v.as_i64()) {
+                            params.insert(
+                                "relationshipsBreakMatches".to_string(),
+                                break_res.to_string(),
+                            );
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+
+        params
+    }
+
+    /// Set a system parameter (in-place form of [`set_system_parameter`])
+    pub fn set_system_parameter(
+        &mut self,
+        parameter_name: &str,
+        parameter_value: &Value,
+    ) -> Result<()> {
+        let parameter_name = parameter_name.to_uppercase();
+        let mut found = false;
+
+        // Currently, the main system parameter is "relationshipsBreakMatches" which maps to BREAK_RES in RCLASS_ID=2
+        if parameter_name == "RELATIONSHIPSBREAKMATCHES"
+            || parameter_name == "RELATIONSHIPS_BREAK_MATCHES"
+        {
+            if let Ok(rtype_array) = self.section_mut("CFG_RTYPE") {
+                for rtype in rtype_array.iter_mut() {
+                    if let Some(rclass_id) = rtype.get("RCLASS_ID").and_then(|v| v.as_i64()) {
+                        if rclass_id == 2 {
+                            if let Some(rtype_obj) = rtype.as_object_mut() {
+                                rtype_obj.insert("BREAK_RES".to_string(), parameter_value.clone());
+                                found = true;
+                            }
+                            break;
+                        }
+                    }
+                }
+            }
+        } else {
+            return Err(SzConfigError::InvalidConfig(format!(
+                "Unknown system parameter: {}",
+                parameter_name
+            )));
+        }
+
+        if !found {
+            return Err(SzConfigError::NotFound(format!(
+                "Failed to set system parameter: {}",
+                parameter_name
+            )));
+        }
+
+        Ok(())
+    }
+}
+
 /// List all system parameters
 ///
 /// # Arguments
@@ -27,29 +97,9 @@ use std::collections::HashMap;
 /// assert!(params.contains_key("relationshipsBreakMatches"));
 /// ```
 pub fn list_system_parameters(config_json: &str) -> Result<HashMap<String, String>> {
-    let config_data: Value = serde_json::from_str(config_json)?;
-    let mut params = HashMap::new();
-
-    // Find RCLASS_ID == 2 in CFG_RTYPE to get BREAK_RES value
-    if let Some(g2_config) = config_data.get("G2_CONFIG") {
-        if let Some(rtype_array) = g2_config.get("CFG_RTYPE").and_then(|v| v.as_array()) {
-            for rtype in rtype_array {
-                if let Some(rclass_id) = rtype.get("RCLASS_ID").and_then(|v| v.as_i64()) {
-                    if rclass_id == 2 {
-                        if let Some(break_res) = rtype.get("BREAK_RES").and_then(|v| v.as_i64()) {
-                            params.insert(
-                                "relationshipsBreakMatches".to_string(),
-                                break_res.to_string(),
-                            );
-                        }
-                        break;
-                    }
-                }
-            }
-        }
-    }
-
-    Ok(params)
+    handle::read_sections(config_json, &["CFG_RTYPE"], |config| {
+        Ok(config.list_system_parameters())
+    })
 }
 
 /// Set a system parameter
@@ -78,45 +128,7 @@ pub fn set_system_parameter(
     parameter_name: &str,
     parameter_value: &Value,
 ) -> Result<String> {
-    let parameter_name = parameter_name.to_uppercase();
-    let mut config_data: Value = serde_json::from_str(config_json)?;
-    let mut found = false;
-
-    // Currently, the main system parameter is "relationshipsBreakMatches" which maps to BREAK_RES in RCLASS_ID=2
-    if parameter_name == "RELATIONSHIPSBREAKMATCHES"
-        || parameter_name == "RELATIONSHIPS_BREAK_MATCHES"
-    {
-        if let Some(g2_config) = config_data.get_mut("G2_CONFIG") {
-            if let Some(rtype_array) = g2_config
-                .get_mut("CFG_RTYPE")
-                .and_then(|v| v.as_array_mut())
-            {
-                for rtype in rtype_array.iter_mut() {
-                    if let Some(rclass_id) = rtype.get("RCLASS_ID").and_then(|v| v.as_i64()) {
-                        if rclass_id == 2 {
-                            if let Some(rtype_obj) = rtype.as_object_mut() {
-                                rtype_obj.insert("BREAK_RES".to_string(), parameter_value.clone());
-                                found = true;
-                            }
-                            break;
-                        }
-                    }
-                }
-            }
-        }
-    } else {
-        return Err(SzConfigError::InvalidConfig(format!(
-            "Unknown system parameter: {}",
-            parameter_name
-        )));
-    }
-
-    if !found {
-        return Err(SzConfigError::NotFound(format!(
-            "Failed to set system parameter: {}",
-            parameter_name
-        )));
-    }
-
-    Ok(serde_json::to_string(&config_data)?)
+    handle::edit(config_json, |config| {
+        config.set_system_parameter(parameter_name, parameter_value)
+    })
 }
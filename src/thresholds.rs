@@ -1,4 +1,5 @@
 use crate::error::{Result, SzConfigError};
+use crate::handle::{self, ConfigHandle};
 use crate::helpers;
 use serde_json::{Value, json};
 
@@ -189,6 +190,576 @@ impl<'a> TryFrom<&'a Value> for DeleteGenericThresholdParams<'a> {
     }
 }
 
+/// Apply the optional score columns shared by the comparison threshold setters
+fn apply_cfrtn_scores(
+    record: &mut Value,
+    same_score: Option<i64>,
+    close_score: Option<i64>,
+    likely_score: Option<i64>,
+    plausible_score: Option<i64>,
+    un_likely_score: Option<i64>,
+) {
+    if let Some(score) = same_score {
+        record["SAME_SCORE"] = json!(score);
+    }
+    if let Some(score) = close_score {
+        record["CLOSE_SCORE"] = json!(score);
+    }
+    if let Some(score) = likely_score {
+        record["LIKELY_SCORE"] = json!(score);
+    }
+    if let Some(score) = plausible_score {
+        record["PLAUSIBLE_SCORE"] = json!(score);
+    }
+    if let Some(score) = un_likely_score {
+        record["UN_LIKELY_SCORE"] = json!(score);
+    }
+}
+
+/// Resolve a threshold feature code to its FTYPE_ID ("ALL" maps to 0)
+pub(crate) fn lookup_threshold_ftype_id(config: &ConfigHandle, feature_upper: &str) -> Result<i64> {
+    if feature_upper == "ALL" {
+        return Ok(0);
+    }
+
+    config
+        .section("CFG_FTYPE")?
+        .iter()
+        .find(|f| f["FTYPE_CODE"].as_str() == Some(feature_upper))
+        .and_then(|f| f["FTYPE_ID"].as_i64())
+        .ok_or_else(|| SzConfigError::NotFound(format!("Feature: {}", feature_upper)))
+}
+
+impl ConfigHandle {
+    /// Add a new comparison threshold (in-place form of [`add_comparison_threshold`])
+    pub fn add_comparison_threshold(&mut self, params: AddComparisonThresholdParams) -> Result<()> {
+        // Extract and validate required fields
+        let cfunc_code = params
+            .cfunc_code
+            .ok_or_else(|| SzConfigError::MissingField("cfunc_code".to_string()))?;
+        let ftype_code = params
+            .ftype_code
+            .ok_or_else(|| SzConfigError::MissingField("ftype_code".to_string()))?;
+        let cfunc_rtnval = params
+            .cfunc_rtnval
+            .ok_or_else(|| SzConfigError::MissingField("cfunc_rtnval".to_string()))?;
+
+        // Lookup IDs from codes
+        let cfunc_id = self.lookup_cfunc_id(cfunc_code)?;
+        let ftype_id = self.lookup_feature_id(ftype_code)?;
+
+        let rtnval_upper = cfunc_rtnval.to_uppercase();
+
+        // Check if already exists
+        let cfrtn_array = self.section_mut("CFG_CFRTN")?;
+
+        if cfrtn_array.iter().any(|item| {
+            item["CFUNC_ID"].as_i64() == Some(cfunc_id)
+                && item["FTYPE_ID"].as_i64() == Some(ftype_id)
+                && item["CFUNC_RTNVAL"].as_str() == Some(rtnval_upper.as_str())
+        }) {
+            return Err(SzConfigError::AlreadyExists(format!(
+                "Comparison threshold: {}+{}+{}",
+                cfunc_code, ftype_code, rtnval_upper
+            )));
+        }
+
+        // Get next ID
+        let cfrtn_id = helpers::get_next_id_from_array(cfrtn_array, "CFRTN_ID")?;
+
+        // Build record
+        let mut record = json!({
+            "CFRTN_ID": cfrtn_id,
+            "CFUNC_ID": cfunc_id,
+            "FTYPE_ID": ftype_id,
+            "CFUNC_RTNVAL": rtnval_upper,
+        });
+
+        if let Some(order) = params.exec_order {
+            record["EXEC_ORDER"] = json!(order);
+        }
+        apply_cfrtn_scores(
+            &mut record,
+            params.same_score,
+            params.close_score,
+            params.likely_score,
+            params.plausible_score,
+            params.un_likely_score,
+        );
+
+        cfrtn_array.push(record);
+        Ok(())
+    }
+
+    /// Add a comparison threshold by CFUNC_ID / FTYPE_ID (used by the FFI layer)
+    #[allow(clippy::too_many_arguments)]
+    pub(crate) fn add_comparison_threshold_by_id(
+        &mut self,
+        cfunc_id: i64,
+        ftype_id: Option<i64>,
+        cfunc_rtnval: &str,
+        exec_order: Option<i64>,
+        same_score: Option<i64>,
+        close_score: Option<i64>,
+        likely_score: Option<i64>,
+        plausible_score: Option<i64>,
+        un_likely_score: Option<i64>,
+    ) -> Result<()> {
+        let ftype = ftype_id.unwrap_or(0);
+        let rtnval_upper = cfunc_rtnval.to_uppercase();
+
+        // Check if already exists
+        let cfrtn_array = self.section_mut("CFG_CFRTN")?;
+
+        if cfrtn_array.iter().any(|item| {
+            item["CFUNC_ID"].as_i64() == Some(cfunc_id)
+                && item["FTYPE_ID"].as_i64() == Some(ftype)
+                && item["CFUNC_RTNVAL"].as_str() == Some(rtnval_upper.as_str())
+        }) {
+            return Err(SzConfigError::AlreadyExists(
+                "Comparison threshold already exists".to_string(),
+            ));
+        }
+
+        // Get next ID
+        let cfrtn_id = helpers::get_next_id_from_array(cfrtn_array, "CFRTN_ID")?;
+
+        // Build record
+        let mut record = json!({
+            "CFRTN_ID": cfrtn_id,
+            "CFUNC_ID": cfunc_id,
+            "FTYPE_ID": ftype,
+            "CFUNC_RTNVAL": rtnval_upper,
+        });
+
+        if let Some(order) = exec_order {
+            record["EXEC_ORDER"] = json!(order);
+        }
+        apply_cfrtn_scores(
+            &mut record,
+            same_score,
+            close_score,
+            likely_score,
+            plausible_score,
+            un_likely_score,
+        );
+
+        cfrtn_array.push(record);
+        Ok(())
+    }
+
+    /// Update a comparison threshold by CFRTN_ID (used by the FFI layer)
+    pub(crate) fn set_comparison_threshold_by_id(
+        &mut self,
+        cfrtn_id: i64,
+        same_score: Option<i64>,
+        close_score: Option<i64>,
+        likely_score: Option<i64>,
+        plausible_score: Option<i64>,
+        un_likely_score: Option<i64>,
+    ) -> Result<()> {
+        let cfrtn = self
+            .section_mut("CFG_CFRTN")?
+            .iter_mut()
+            .find(|item| item["CFRTN_ID"].as_i64() == Some(cfrtn_id))
+            .ok_or_else(|| {
+                SzConfigError::NotFound(format!("Comparison threshold ID: {}", cfrtn_id))
+            })?;
+
+        // Update fields from params
+        if cfrtn.is_object() {
+            apply_cfrtn_scores(
+                cfrtn,
+                same_score,
+                close_score,
+                likely_score,
+                plausible_score,
+                un_likely_score,
+            );
+        }
+
+        Ok(())
+    }
+
+    /// Delete a comparison threshold by CFRTN_ID (used by the FFI layer)
+    pub(crate) fn delete_comparison_threshold_by_id(&mut self, cfrtn_id: i64) -> Result<()> {
+        let mut found = false;
+
+        if let Ok(cfrtn_array) = self.section_mut("CFG_CFRTN") {
+            cfrtn_array.retain(|item| {
+                let matches = item["CFRTN_ID"].as_i64() == Some(cfrtn_id);
+                if matches {
+                    found = true;
+                }
+                !matches
+            });
+        }
+
+        if !found {
+            return Err(SzConfigError::NotFound(format!(
+                "Comparison threshold ID: {}",
+                cfrtn_id
+            )));
+        }
+
+        Ok(())
+    }
+
+    /// Delete a comparison threshold (in-place form of [`delete_comparison_threshold`])
+    pub fn delete_comparison_threshold(
+        &mut self,
+        cfunc_code: &str,
+        ftype_code: &str,
+    ) -> Result<()> {
+        let cfunc_id = self.lookup_cfunc_id(cfunc_code)?;
+        let ftype_id = self.lookup_feature_id(ftype_code)?;
+
+        // Find the CFRTN_ID for this combination
+        let cfrtn_array = self.section_mut("CFG_CFRTN")?;
+
+        let cfrtn_id = cfrtn_array
+            .iter()
+            .find(|item| {
+                item["CFUNC_ID"].as_i64() == Some(cfunc_id)
+                    && item["FTYPE_ID"].as_i64() == Some(ftype_id)
+            })
+            .and_then(|item| item["CFRTN_ID"].as_i64())
+            .ok_or_else(|| {
+                SzConfigError::NotFound(format!(
+                    "Comparison threshold for cfunc='{}', ftype='{}'",
+                    cfunc_code, ftype_code
+                ))
+            })?;
+
+        cfrtn_array.retain(|item| item["CFRTN_ID"].as_i64() != Some(cfrtn_id));
+
+        Ok(())
+    }
+
+    /// Update a comparison threshold (in-place form of [`set_comparison_threshold`])
+    pub fn set_comparison_threshold(&mut self, params: SetComparisonThresholdParams) -> Result<()> {
+        // Extract and validate required fields
+        let cfunc_code = params
+            .cfunc_code
+            .ok_or_else(|| SzConfigError::MissingField("cfunc_code".to_string()))?;
+        let ftype_code = params
+            .ftype_code
+            .ok_or_else(|| SzConfigError::MissingField("ftype_code".to_string()))?;
+
+        // Lookup IDs from codes
+        let cfunc_id = self.lookup_cfunc_id(cfunc_code)?;
+        let ftype_id = self.lookup_feature_id(ftype_code)?;
+
+        let cfrtn = self
+            .section_mut("CFG_CFRTN")?
+            .iter_mut()
+            .find(|item| {
+                item["CFUNC_ID"].as_i64() == Some(cfunc_id)
+                    && item["FTYPE_ID"].as_i64() == Some(ftype_id)
+            })
+            .ok_or_else(|| {
+                SzConfigError::NotFound(format!(
+                    "Comparison threshold: {}+{}",
+                    cfunc_code, ftype_code
+                ))
+            })?;
+
+        // Update fields from params
+        if cfrtn.is_object() {
+            apply_cfrtn_scores(
+                cfrtn,
+                params.same_score,
+                params.close_score,
+                params.likely_score,
+                params.plausible_score,
+                params.un_likely_score,
+            );
+        }
+
+        Ok(())
+    }
+
+    /// List all comparison thresholds (see [`list_comparison_thresholds`])
+    pub fn list_comparison_thresholds(&self) -> Result<Vec<Value>> {
+        let cfrtn_array = self.section("CFG_CFRTN")?;
+        let cfunc_array = self.section("CFG_CFUNC")?;
+        let ftype_array = self.section("CFG_FTYPE")?;
+
+        let mut result: Vec<Value> = cfrtn_array
+            .iter()
+            .map(|item| {
+                let cfunc_id = item["CFUNC_ID"].as_i64().unwrap_or(0);
+                let ftype_id = item["FTYPE_ID"].as_i64().unwrap_or(0);
+                let cfrtn_id = item["CFRTN_ID"].as_i64().unwrap_or(0);
+
+                // Resolve function name
+                let function = cfunc_array
+                    .iter()
+                    .find(|cf| cf["CFUNC_ID"].as_i64() == Some(cfunc_id))
+                    .and_then(|cf| cf["CFUNC_CODE"].as_str())
+                    .unwrap_or("unknown")
+                    .to_string();
+
+                // Resolve feature name
+                let feature = if ftype_id == 0 {
+                    "all".to_string()
+                } else {
+                    ftype_array
+                        .iter()
+                        .find(|ft| ft["FTYPE_ID"].as_i64() == Some(ftype_id))
+                        .and_then(|ft| ft["FTYPE_CODE"].as_str())
+                        .unwrap_or("unknown")
+                        .to_string()
+                };
+
+                json!({
+                    "id": cfrtn_id,
+                    "cfunc_id": cfunc_id,  // Keep for sorting
+                    "function": function,
+                    "returnOrder": item["EXEC_ORDER"].as_i64().unwrap_or(0),
+                    "scoreName": item["CFUNC_RTNVAL"].as_str().unwrap_or(""),
+                    "feature": feature,
+                    "sameScore": item["SAME_SCORE"].as_i64().unwrap_or(0),
+                    "closeScore": item["CLOSE_SCORE"].as_i64().unwrap_or(0),
+                    "likelyScore": item["LIKELY_SCORE"].as_i64().unwrap_or(0),
+                    "plausibleScore": item["PLAUSIBLE_SCORE"].as_i64().unwrap_or(0),
+                    "unlikelyScore": item["UN_LIKELY_SCORE"].as_i64().unwrap_or(0)
+                })
+            })
+            .collect();
+
+        // Sort by CFUNC_ID and CFRTN_ID (like Python) - not by function name
+        result.sort_by_key(|e| {
+            (
+                e["cfunc_id"].as_i64().unwrap_or(0),
+                e["id"].as_i64().unwrap_or(0),
+            )
+        });
+
+        // Remove cfunc_id from output (it was only for sorting)
+        for item in &mut result {
+            if let Some(obj) = item.as_object_mut() {
+                obj.remove("cfunc_id");
+            }
+        }
+
+        Ok(result)
+    }
+
+    /// Add a new generic threshold (in-place form of [`add_generic_threshold`])
+    pub fn add_generic_threshold(&mut self, params: AddGenericThresholdParams) -> Result<()> {
+        // Extract and validate required fields
+        let plan = params
+            .plan
+            .ok_or_else(|| SzConfigError::MissingField("plan".to_string()))?;
+        let behavior = params
+            .behavior
+            .ok_or_else(|| SzConfigError::MissingField("behavior".to_string()))?;
+        let scoring_cap = params
+            .scoring_cap
+            .ok_or_else(|| SzConfigError::MissingField("scoring_cap".to_string()))?;
+        let candidate_cap = params
+            .candidate_cap
+            .ok_or_else(|| SzConfigError::MissingField("candidate_cap".to_string()))?;
+        let send_to_redo = params
+            .send_to_redo
+            .ok_or_else(|| SzConfigError::MissingField("send_to_redo".to_string()))?;
+
+        let plan_upper = plan.to_uppercase();
+        let behavior_upper = behavior.to_uppercase();
+        let redo_upper = send_to_redo.to_uppercase();
+        let feature_upper = params.feature.unwrap_or("ALL").to_uppercase();
+
+        // Validate sendToRedo
+        if redo_upper != "YES" && redo_upper != "NO" {
+            return Err(SzConfigError::InvalidInput(format!(
+                "Invalid sendToRedo value '{}'. Must be 'Yes' or 'No'",
+                send_to_redo
+            )));
+        }
+
+        // Lookup plan ID
+        let gplan_id = self
+            .section("CFG_GPLAN")?
+            .iter()
+            .find(|p| p["GPLAN_CODE"].as_str() == Some(plan_upper.as_str()))
+            .and_then(|p| p["GPLAN_ID"].as_i64())
+            .ok_or_else(|| {
+                SzConfigError::NotFound(format!("Generic plan: {}", plan_upper.clone()))
+            })?;
+
+        // Lookup feature ID (0 for "all")
+        let ftype_id = lookup_threshold_ftype_id(self, &feature_upper)?;
+
+        // Check if threshold already exists
+        let gthresh_array = self.section_mut("CFG_GENERIC_THRESHOLD")?;
+
+        if gthresh_array.iter().any(|record| {
+            record["GPLAN_ID"].as_i64() == Some(gplan_id)
+                && record["BEHAVIOR"].as_str() == Some(behavior_upper.as_str())
+                && record["FTYPE_ID"].as_i64() == Some(ftype_id)
+        }) {
+            return Err(SzConfigError::AlreadyExists(format!(
+                "Generic threshold: plan={}, behavior={}, feature={}",
+                plan_upper, behavior_upper, feature_upper
+            )));
+        }
+
+        // Create new threshold record
+        gthresh_array.push(json!({
+            "GPLAN_ID": gplan_id,
+            "BEHAVIOR": behavior_upper,
+            "FTYPE_ID": ftype_id,
+            "CANDIDATE_CAP": candidate_cap,
+            "SCORING_CAP": scoring_cap,
+            "SEND_TO_REDO": redo_upper
+        }));
+
+        Ok(())
+    }
+
+    /// Delete a generic threshold (in-place form of [`delete_generic_threshold`])
+    pub fn delete_generic_threshold(&mut self, params: DeleteGenericThresholdParams) -> Result<()> {
+        // Extract and validate required fields
+        let plan = params
+            .plan
+            .ok_or_else(|| SzConfigError::MissingField("plan".to_string()))?;
+        let behavior = params
+            .behavior
+            .ok_or_else(|| SzConfigError::MissingField("behavior".to_string()))?;
+
+        let gplan_id = self.lookup_gplan_id(plan)?;
+
+        let behavior_upper = behavior.to_uppercase();
+        let feature_upper = params.feature.unwrap_or("ALL").to_uppercase();
+
+        // Lookup feature ID (0 for "all")
+        let ftype_id = lookup_threshold_ftype_id(self, &feature_upper)?;
+
+        // Find and delete threshold record
+        let mut found = false;
+        if let Ok(threshold_array) = self.section_mut("CFG_GENERIC_THRESHOLD") {
+            threshold_array.retain(|record| {
+                let matches = record["GPLAN_ID"].as_i64() == Some(gplan_id)
+                    && record["BEHAVIOR"].as_str() == Some(behavior_upper.as_str())
+                    && record["FTYPE_ID"].as_i64() == Some(ftype_id);
+                if matches {
+                    found = true;
+                }
+                !matches
+            });
+        }
+
+        if !found {
+            return Err(SzConfigError::NotFound(format!(
+                "Generic threshold not found: GPLAN_ID={}, behavior={}, feature={}",
+                gplan_id, behavior_upper, feature_upper
+            )));
+        }
+
+        Ok(())
+    }
+
+    /// Update a generic threshold (in-place form of [`set_generic_threshold`])
+    pub fn set_generic_threshold(&mut self, params: SetGenericThresholdParams) -> Result<()> {
+        // Extract and validate required fields
+        let plan = params
+            .plan
+            .ok_or_else(|| SzConfigError::MissingField("plan".to_string()))?;
+        let behavior = params
+            .behavior
+            .ok_or_else(|| SzConfigError::MissingField("behavior".to_string()))?;
+
+        let gplan_id = self.lookup_gplan_id(plan)?;
+
+        let behavior_upper = behavior.to_uppercase();
+
+        let position = self
+            .section("CFG_GENERIC_THRESHOLD")?
+            .iter()
+            .position(|item| {
+                item["GPLAN_ID"].as_i64() == Some(gplan_id)
+                    && item["BEHAVIOR"].as_str() == Some(behavior_upper.as_str())
+            })
+            .ok_or_else(|| {
+                SzConfigError::NotFound(format!(
+                    "Generic threshold not found: plan={:?}, behavior={}",
+                    params.plan, behavior_upper
+                ))
+            })?;
+
+        let new_ftype_id = params
+            .feature
+            .map(|feature_code| self.lookup_feature_id(feature_code))
+            .transpose()?;
+
+        // Update fields from params
+        let gthresh = &mut self.section_mut("CFG_GENERIC_THRESHOLD")?[position];
+        if let Some(dest_obj) = gthresh.as_object_mut() {
+            if let Some(ftype_id) = new_ftype_id {
+                dest_obj.insert("FTYPE_ID".to_string(), json!(ftype_id));
+            }
+            if let Some(cap) = params.candidate_cap {
+                dest_obj.insert("CANDIDATE_CAP".to_string(), json!(cap));
+            }
+            if let Some(cap) = params.scoring_cap {
+                dest_obj.insert("SCORING_CAP".to_string(), json!(cap));
+            }
+            if let Some(redo) = params.send_to_redo {
+                dest_obj.insert("SEND_TO_REDO".to_string(), json!(redo.to_uppercase()));
+            }
+        }
+
+        Ok(())
+    }
+
+    /// List all generic thresholds with resolved names (see [`list_generic_thresholds`])
+    pub fn list_generic_thresholds(&self) -> Result<Vec<Value>> {
+        let gthresh_array = self.section("CFG_GENERIC_THRESHOLD")?;
+        let gplan_array = self.section("CFG_GPLAN")?;
+        let ftype_array = self.section("CFG_FTYPE")?;
+
+        let result: Vec<Value> = gthresh_array
+            .iter()
+            .map(|item| {
+                let gplan_id = item["GPLAN_ID"].as_i64().unwrap_or(0);
+                let ftype_id = item["FTYPE_ID"].as_i64().unwrap_or(0);
+
+                // Resolve plan name
+                let plan = gplan_array
+                    .iter()
+                    .find(|gp| gp["GPLAN_ID"].as_i64() == Some(gplan_id))
+                    .and_then(|gp| gp["GPLAN_CODE"].as_str())
+                    .unwrap_or("unknown")
+                    .to_string();
+
+                // Resolve feature name
+                let feature = if ftype_id == 0 {
+                    "all".to_string()
+                } else {
+                    ftype_array
+                        .iter()
+                        .find(|ft| ft["FTYPE_ID"].as_i64() == Some(ftype_id))
+                        .and_then(|ft| ft["FTYPE_CODE"].as_str())
+                        .unwrap_or("unknown")
+                        .to_string()
+                };
+
+                json!({
+                    "plan": plan,
+                    "behavior": item["BEHAVIOR"].as_str().unwrap_or(""),
+                    "feature": feature,
+                    "candidateCap": item["CANDIDATE_CAP"].as_i64().unwrap_or(0),
+                    "scoringCap": item["SCORING_CAP"].as_i64().unwrap_or(0),
+                    "sendToRedo": item["SEND_TO_REDO"].as_str().unwrap_or("")
+                })
+            })
+            .collect();
+
+        Ok(result)
+    }
+}
+
 // ===== Comparison Thresholds (CFG_CFRTN) =====
 
 /// Add a new comparison threshold (CFG_CFRTN record)
@@ -203,73 +774,9 @@ pub fn add_comparison_threshold(
     config_json: &str,
     params: AddComparisonThresholdParams,
 ) -> Result<String> {
-    // Extract and validate required fields
-    let cfunc_code = params
-        .cfunc_code
-        .ok_or_else(|| SzConfigError::MissingField("cfunc_code".to_string()))?;
-    let ftype_code = params
-        .ftype_code
-        .ok_or_else(|| SzConfigError::MissingField("ftype_code".to_string()))?;
-    let cfunc_rtnval = params
-        .cfunc_rtnval
-        .ok_or_else(|| SzConfigError::MissingField("cfunc_rtnval".to_string()))?;
-
-    // Lookup IDs from codes
-    let cfunc_id = helpers::lookup_cfunc_id(config_json, cfunc_code)?;
-    let ftype_id = helpers::lookup_feature_id(config_json, ftype_code)?;
-
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let rtnval_upper = cfunc_rtnval.to_uppercase();
-
-    // Check if already exists
-    let cfrtn_array = config["G2_CONFIG"]["CFG_CFRTN"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_CFRTN".to_string()))?;
-
-    if cfrtn_array.iter().any(|item| {
-        item["CFUNC_ID"].as_i64() == Some(cfunc_id)
-            && item["FTYPE_ID"].as_i64() == Some(ftype_id)
-            && item["CFUNC_RTNVAL"].as_str() == Some(rtnval_upper.as_str())
-    }) {
-        return Err(SzConfigError::AlreadyExists(format!(
-            "Comparison threshold: {}+{}+{}",
-            cfunc_code, ftype_code, rtnval_upper
-        )));
-    }
-
-    // Get next ID
-    let cfrtn_id = helpers::get_next_id_from_array(cfrtn_array, "CFRTN_ID")?;
-
-    // Build record
-    let mut record = json!({
-        "CFRTN_ID": cfrtn_id,
-        "CFUNC_ID": cfunc_id,
-        "FTYPE_ID": ftype_id,
-        "CFUNC_RTNVAL": rtnval_upper,
-    });
-
-    if let Some(order) = params.exec_order {
-        record["EXEC_ORDER"] = json!(order);
-    }
-    if let Some(score) = params.same_score {
-        record["SAME_SCORE"] = json!(score);
-    }
-    if let Some(score) = params.close_score {
-        record["CLOSE_SCORE"] = json!(score);
-    }
-    if let Some(score) = params.likely_score {
-        record["LIKELY_SCORE"] = json!(score);
-    }
-    if let Some(score) = params.plausible_score {
-        record["PLAUSIBLE_SCORE"] = json!(score);
-    }
-    if let Some(score) = params.un_likely_score {
-        record["UN_LIKELY_SCORE"] = json!(score);
-    }
-
-    helpers::add_to_config_array(config_json, "CFG_CFRTN", record)
+    handle::edit(config_json, |config| {
+        config.add_comparison_threshold(params)
+    })
 }
 
 /// Internal: Add comparison threshold by ID (for FFI use)
@@ -286,58 +793,19 @@ pub(crate) fn add_comparison_threshold_by_id(
     plausible_score: Option<i64>,
     un_likely_score: Option<i64>,
 ) -> Result<String> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let ftype = ftype_id.unwrap_or(0);
-    let rtnval_upper = cfunc_rtnval.to_uppercase();
-
-    // Check if already exists
-    let cfrtn_array = config["G2_CONFIG"]["CFG_CFRTN"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_CFRTN".to_string()))?;
-
-    if cfrtn_array.iter().any(|item| {
-        item["CFUNC_ID"].as_i64() == Some(cfunc_id)
-            && item["FTYPE_ID"].as_i64() == Some(ftype)
-            && item["CFUNC_RTNVAL"].as_str() == Some(rtnval_upper.as_str())
-    }) {
-        return Err(SzConfigError::AlreadyExists(
-            "Comparison threshold already exists".to_string(),
-        ));
-    }
-
-    // Get next ID
-    let cfrtn_id = crate::helpers::get_next_id_from_array(cfrtn_array, "CFRTN_ID")?;
-
-    // Build record
-    let mut record = json!({
-        "CFRTN_ID": cfrtn_id,
-        "CFUNC_ID": cfunc_id,
-        "FTYPE_ID": ftype,
-        "CFUNC_RTNVAL": rtnval_upper,
-    });
-
-    if let Some(order) = exec_order {
-        record["EXEC_ORDER"] = json!(order);
-    }
-    if let Some(score) = same_score {
-        record["SAME_SCORE"] = json!(score);
-    }
-    if let Some(score) = close_score {
-        record["CLOSE_SCORE"] = json!(score);
-    }
-    if let Some(score) = likely_score {
-        record["LIKELY_SCORE"] = json!(score);
-    }
-    if let Some(score) = plausible_score {
-        record["PLAUSIBLE_SCORE"] = json!(score);
-    }
-    if let Some(score) = un_likely_score {
-        record["UN_LIKELY_SCORE"] = json!(score);
-    }
-
-    crate::helpers::add_to_config_array(config_json, "CFG_CFRTN", record)
+    handle::edit(config_json, |config| {
+        config.add_comparison_threshold_by_id(
+            cfunc_id,
+            ftype_id,
+            cfunc_rtnval,
+            exec_order,
+            same_score,
+            close_score,
+            likely_score,
+            plausible_score,
+            un_likely_score,
+        )
+    })
 }
 
 /// Internal: Set comparison threshold by ID (for FFI use)
@@ -350,38 +818,16 @@ pub(crate) fn set_comparison_threshold_by_id(
     plausible_score: Option<i64>,
     un_likely_score: Option<i64>,
 ) -> Result<String> {
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let cfrtn_array = config["G2_CONFIG"]["CFG_CFRTN"]
-        .as_array_mut()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_CFRTN".to_string()))?;
-
-    let cfrtn = cfrtn_array
-        .iter_mut()
-        .find(|item| item["CFRTN_ID"].as_i64() == Some(cfrtn_id))
-        .ok_or_else(|| SzConfigError::NotFound(format!("Comparison threshold ID: {}", cfrtn_id)))?;
-
-    // Update fields from params
-    if let Some(dest_obj) = cfrtn.as_object_mut() {
-        if let Some(score) = same_score {
-            dest_obj.insert("SAME_SCORE".to_string(), json!(score));
-        }
-        if let Some(score) = close_score {
-            dest_obj.insert("CLOSE_SCORE".to_string(), json!(score));
-        }
-        if let Some(score) = likely_score {
-            dest_obj.insert("LIKELY_SCORE".to_string(), json!(score));
-        }
-        if let Some(score) = plausible_score {
-            dest_obj.insert("PLAUSIBLE_SCORE".to_string(), json!(score));
-        }
-        if let Some(score) = un_likely_score {
-            dest_obj.insert("UN_LIKELY_SCORE".to_string(), json!(score));
-        }
-    }
-
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config_json, |config| {
+        config.set_comparison_threshold_by_id(
+            cfrtn_id,
+            same_score,
+            close_score,
+            likely_score,
+            plausible_score,
+            un_likely_score,
+        )
+    })
 }
 
 /// Internal: Delete comparison threshold by ID (for FFI use)
@@ -393,29 +839,9 @@ pub(crate) fn delete_comparison_threshold_by_id(
     config_json: &str,
     cfrtn_id: i64,
 ) -> Result<String> {
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let mut found = false;
-
-    if let Some(cfrtn_array) = config["G2_CONFIG"]["CFG_CFRTN"].as_array_mut() {
-        cfrtn_array.retain(|item| {
-            let matches = item["CFRTN_ID"].as_i64() == Some(cfrtn_id);
-            if matches {
-                found = true;
-            }
-            !matches
-        });
-    }
-
-    if !found {
-        return Err(SzConfigError::NotFound(format!(
-            "Comparison threshold ID: {}",
-            cfrtn_id
-        )));
-    }
-
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config_json, |config| {
+        config.delete_comparison_threshold_by_id(cfrtn_id)
+    })
 }
 
 pub fn delete_comparison_threshold(
@@ -423,54 +849,9 @@ pub fn delete_comparison_threshold(
     cfunc_code: &str,
     ftype_code: &str,
 ) -> Result<String> {
-    let cfunc_id = helpers::lookup_cfunc_id(config_json, cfunc_code)?;
-    let ftype_id = helpers::lookup_feature_id(config_json, ftype_code)?;
-
-    // Find the CFRTN_ID for this combination
-    let config_lookup: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let cfrtn_array = config_lookup["G2_CONFIG"]["CFG_CFRTN"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_CFRTN".to_string()))?;
-
-    let cfrtn_id = cfrtn_array
-        .iter()
-        .find(|item| {
-            item["CFUNC_ID"].as_i64() == Some(cfunc_id)
-                && item["FTYPE_ID"].as_i64() == Some(ftype_id)
-        })
-        .and_then(|item| item["CFRTN_ID"].as_i64())
-        .ok_or_else(|| {
-            SzConfigError::NotFound(format!(
-                "Comparison threshold for cfunc='{}', ftype='{}'",
-                cfunc_code, ftype_code
-            ))
-        })?;
-
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let mut found = false;
-
-    if let Some(cfrtn_array) = config["G2_CONFIG"]["CFG_CFRTN"].as_array_mut() {
-        cfrtn_array.retain(|item| {
-            let matches = item["CFRTN_ID"].as_i64() == Some(cfrtn_id);
-            if matches {
-                found = true;
-            }
-            !matches
-        });
-    }
-
-    if !found {
-        return Err(SzConfigError::NotFound(format!(
-            "Comparison threshold: {}",
-            cfrtn_id
-        )));
-    }
-
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config_json, |config| {
+        config.delete_comparison_threshold(cfunc_code, ftype_code)
+    })
 }
 
 /// Set (update) a comparison threshold
@@ -485,58 +866,9 @@ pub fn set_comparison_threshold(
     config_json: &str,
     params: SetComparisonThresholdParams,
 ) -> Result<String> {
-    // Extract and validate required fields
-    let cfunc_code = params
-        .cfunc_code
-        .ok_or_else(|| SzConfigError::MissingField("cfunc_code".to_string()))?;
-    let ftype_code = params
-        .ftype_code
-        .ok_or_else(|| SzConfigError::MissingField("ftype_code".to_string()))?;
-
-    // Lookup IDs from codes
-    let cfunc_id = helpers::lookup_cfunc_id(config_json, cfunc_code)?;
-    let ftype_id = helpers::lookup_feature_id(config_json, ftype_code)?;
-
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let cfrtn_array = config["G2_CONFIG"]["CFG_CFRTN"]
-        .as_array_mut()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_CFRTN".to_string()))?;
-
-    let cfrtn = cfrtn_array
-        .iter_mut()
-        .find(|item| {
-            item["CFUNC_ID"].as_i64() == Some(cfunc_id)
-                && item["FTYPE_ID"].as_i64() == Some(ftype_id)
-        })
-        .ok_or_else(|| {
-            SzConfigError::NotFound(format!(
-                "Comparison threshold: {}+{}",
-                cfunc_code, ftype_code
-            ))
-        })?;
-
-    // Update fields from params
-    if let Some(dest_obj) = cfrtn.as_object_mut() {
-        if let Some(score) = params.same_score {
-            dest_obj.insert("SAME_SCORE".to_string(), json!(score));
-        }
-        if let Some(score) = params.close_score {
-            dest_obj.insert("CLOSE_SCORE".to_string(), json!(score));
-        }
-        if let Some(score) = params.likely_score {
-            dest_obj.insert("LIKELY_SCORE".to_string(), json!(score));
-        }
-        if let Some(score) = params.plausible_score {
-            dest_obj.insert("PLAUSIBLE_SCORE".to_string(), json!(score));
-        }
-        if let Some(score) = params.un_likely_score {
-            dest_obj.insert("UN_LIKELY_SCORE".to_string(), json!(score));
-        }
-    }
-
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config_json, |config| {
+        config.set_comparison_threshold(params)
+    })
 }
 
 /// List all comparison thresholds with resolved names
@@ -547,80 +879,7 @@ pub fn set_comparison_threshold(
 /// # Returns
 /// Vector of JSON Values with id, function, returnOrder, scoreName, feature, and score fields
 pub fn list_comparison_thresholds(config_json: &str) -> Result<Vec<Value>> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let cfrtn_array = config["G2_CONFIG"]["CFG_CFRTN"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_CFRTN".to_string()))?;
-
-    let cfunc_array = config["G2_CONFIG"]["CFG_CFUNC"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_CFUNC".to_string()))?;
-
-    let ftype_array = config["G2_CONFIG"]["CFG_FTYPE"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FTYPE".to_string()))?;
-
-    let mut result: Vec<Value> = cfrtn_array
-        .iter()
-        .map(|item| {
-            let cfunc_id = item["CFUNC_ID"].as_i64().unwrap_or(0);
-            let ftype_id = item["FTYPE_ID"].as_i64().unwrap_or(0);
-            let cfrtn_id = item["CFRTN_ID"].as_i64().unwrap_or(0);
-
-            // Resolve function name
-            let function = cfunc_array
-                .iter()
-                .find(|cf| cf["CFUNC_ID"].as_i64() == Some(cfunc_id))
-                .and_then(|cf| cf["CFUNC_CODE"].as_str())
-                .unwrap_or("unknown")
-                .to_string();
-
-            // Resolve feature name
-            let feature = if ftype_id == 0 {
-                "all".to_string()
-            } else {
-                ftype_array
-                    .iter()
-                    .find(|ft| ft["FTYPE_ID"].as_i64() == Some(ftype_id))
-                    .and_then(|ft| ft["FTYPE_CODE"].as_str())
-                    .unwrap_or("unknown")
-                    .to_string()
-            };
-
-            json!({
-                "id": cfrtn_id,
-                "cfunc_id": cfunc_id,  // Keep for sorting
-                "function": function,
-                "returnOrder": item["EXEC_ORDER"].as_i64().unwrap_or(0),
-                "scoreName": item["CFUNC_RTNVAL"].as_str().unwrap_or(""),
-                "feature": feature,
-                "sameScore": item["SAME_SCORE"].as_i64().unwrap_or(0),
-                "closeScore": item["CLOSE_SCORE"].as_i64().unwrap_or(0),
-                "likelyScore": item["LIKELY_SCORE"].as_i64().unwrap_or(0),
-                "plausibleScore": item["PLAUSIBLE_SCORE"].as_i64().unwrap_or(0),
-                "unlikelyScore": item["UN_LIKELY_SCORE"].as_i64().unwrap_or(0)
-            })
-        })
-        .collect();
-
-    // Sort by CFUNC_ID and CFRTN_ID (like Python) - not by function name
-    result.sort_by_key(|e| {
-        (
-            e["cfunc_id"].as_i64().unwrap_or(0),
-            e["id"].as_i64().unwrap_or(0),
-        )
-    });
-
-    // Remove cfunc_id from output (it was only for sorting)
-    for item in &mut result {
-        if let Some(obj) = item.as_object_mut() {
-            obj.remove("cfunc_id");
-        }
-    }
-
-    Ok(result)
+    handle::read(config_json, |config| config.list_comparison_thresholds())
 }
 
 // ===== Generic Thresholds (CFG_GENERIC_THRESHOLD) =====
@@ -637,96 +896,7 @@ pub fn add_generic_threshold(
     config_json: &str,
     params: AddGenericThresholdParams,
 ) -> Result<String> {
-    // Extract and validate required fields
-    let plan = params
-        .plan
-        .ok_or_else(|| SzConfigError::MissingField("plan".to_string()))?;
-    let behavior = params
-        .behavior
-        .ok_or_else(|| SzConfigError::MissingField("behavior".to_string()))?;
-    let scoring_cap = params
-        .scoring_cap
-        .ok_or_else(|| SzConfigError::MissingField("scoring_cap".to_string()))?;
-    let candidate_cap = params
-        .candidate_cap
-        .ok_or_else(|| SzConfigError::MissingField("candidate_cap".to_string()))?;
-    let send_to_redo = params
-        .send_to_redo
-        .ok_or_else(|| SzConfigError::MissingField("send_to_redo".to_string()))?;
-
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let plan_upper = plan.to_uppercase();
-    let behavior_upper = behavior.to_uppercase();
-    let redo_upper = send_to_redo.to_uppercase();
-    let feature_upper = params.feature.unwrap_or("ALL").to_uppercase();
-
-    // Validate sendToRedo
-    if redo_upper != "YES" && redo_upper != "NO" {
-        return Err(SzConfigError::InvalidInput(format!(
-            "Invalid sendToRedo value '{}'. Must be 'Yes' or 'No'",
-            send_to_redo
-        )));
-    }
-
-    // Lookup plan ID
-    let gplan_array = config["G2_CONFIG"]["CFG_GPLAN"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_GPLAN".to_string()))?;
-
-    let gplan_id = gplan_array
-        .iter()
-        .find(|p| p["GPLAN_CODE"].as_str() == Some(plan_upper.as_str()))
-        .and_then(|p| p["GPLAN_ID"].as_i64())
-        .ok_or_else(|| SzConfigError::NotFound(format!("Generic plan: {}", plan_upper.clone())))?;
-
-    // Lookup feature ID (0 for "all")
-    let ftype_id = if feature_upper == "ALL" {
-        0
-    } else {
-        let ftype_array = config["G2_CONFIG"]["CFG_FTYPE"]
-            .as_array()
-            .ok_or_else(|| SzConfigError::MissingSection("CFG_FTYPE".to_string()))?;
-
-        ftype_array
-            .iter()
-            .find(|f| f["FTYPE_CODE"].as_str() == Some(feature_upper.as_str()))
-            .and_then(|f| f["FTYPE_ID"].as_i64())
-            .ok_or_else(|| SzConfigError::NotFound(format!("Feature: {}", feature_upper.clone())))?
-    };
-
-    // Check if threshold already exists
-    let gthresh_array = config["G2_CONFIG"]["CFG_GENERIC_THRESHOLD"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_GENERIC_THRESHOLD".to_string()))?;
-
-    if gthresh_array.iter().any(|record| {
-        record["GPLAN_ID"].as_i64() == Some(gplan_id)
-            && record["BEHAVIOR"].as_str() == Some(behavior_upper.as_str())
-            && record["FTYPE_ID"].as_i64() == Some(ftype_id)
-    }) {
-        return Err(SzConfigError::AlreadyExists(format!(
-            "Generic threshold: plan={}, behavior={}, feature={}",
-            plan_upper, behavior_upper, feature_upper
-        )));
-    }
-
-    // Create new threshold record
-    let new_threshold = json!({
-        "GPLAN_ID": gplan_id,
-        "BEHAVIOR": behavior_upper,
-        "FTYPE_ID": ftype_id,
-        "CANDIDATE_CAP": candidate_cap,
-        "SCORING_CAP": scoring_cap,
-        "SEND_TO_REDO": redo_upper
-    });
-
-    if let Some(threshold_array) = config["G2_CONFIG"]["CFG_GENERIC_THRESHOLD"].as_array_mut() {
-        threshold_array.push(new_threshold);
-    }
-
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config_json, |config| config.add_generic_threshold(params))
 }
 
 /// Delete a generic threshold
@@ -741,59 +911,9 @@ pub fn delete_generic_threshold(
     config_json: &str,
     params: DeleteGenericThresholdParams,
 ) -> Result<String> {
-    // Extract and validate required fields
-    let plan = params
-        .plan
-        .ok_or_else(|| SzConfigError::MissingField("plan".to_string()))?;
-    let behavior = params
-        .behavior
-        .ok_or_else(|| SzConfigError::MissingField("behavior".to_string()))?;
-
-    let gplan_id = helpers::lookup_gplan_id(config_json, plan)?;
-
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let behavior_upper = behavior.to_uppercase();
-    let feature_upper = params.feature.unwrap_or("ALL").to_uppercase();
-
-    // Lookup feature ID (0 for "all")
-    let ftype_id = if feature_upper == "ALL" {
-        0
-    } else {
-        let ftype_array = config["G2_CONFIG"]["CFG_FTYPE"]
-            .as_array()
-            .ok_or_else(|| SzConfigError::MissingSection("CFG_FTYPE".to_string()))?;
-
-        ftype_array
-            .iter()
-            .find(|f| f["FTYPE_CODE"].as_str() == Some(feature_upper.as_str()))
-            .and_then(|f| f["FTYPE_ID"].as_i64())
-            .ok_or_else(|| SzConfigError::NotFound(format!("Feature: {}", feature_upper.clone())))?
-    };
-
-    // Find and delete threshold record
-    let mut found = false;
-    if let Some(threshold_array) = config["G2_CONFIG"]["CFG_GENERIC_THRESHOLD"].as_array_mut() {
-        threshold_array.retain(|record| {
-            let matches = record["GPLAN_ID"].as_i64() == Some(gplan_id)
-                && record["BEHAVIOR"].as_str() == Some(behavior_upper.as_str())
-                && record["FTYPE_ID"].as_i64() == Some(ftype_id);
-            if matches {
-                found = true;
-            }
-            !matches
-        });
-    }
-
-    if !found {
-        return Err(SzConfigError::NotFound(format!(
-            "Generic threshold not found: GPLAN_ID={}, behavior={}, feature={}",
-            gplan_id, behavior_upper, feature_upper
-        )));
-    }
-
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config_json, |config| {
+        config.delete_generic_threshold(params)
+    })
 }
 
 /// Set (update) a generic threshold
@@ -808,56 +928,7 @@ pub fn set_generic_threshold(
     config_json: &str,
     params: SetGenericThresholdParams,
 ) -> Result<String> {
-    // Extract and validate required fields
-    let plan = params
-        .plan
-        .ok_or_else(|| SzConfigError::MissingField("plan".to_string()))?;
-    let behavior = params
-        .behavior
-        .ok_or_else(|| SzConfigError::MissingField("behavior".to_string()))?;
-
-    let gplan_id = helpers::lookup_gplan_id(config_json, plan)?;
-
-    let mut config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let behavior_upper = behavior.to_uppercase();
-
-    let gthresh_array = config["G2_CONFIG"]["CFG_GENERIC_THRESHOLD"]
-        .as_array_mut()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_GENERIC_THRESHOLD".to_string()))?;
-
-    let gthresh = gthresh_array
-        .iter_mut()
-        .find(|item| {
-            item["GPLAN_ID"].as_i64() == Some(gplan_id)
-                && item["BEHAVIOR"].as_str() == Some(behavior_upper.as_str())
-        })
-        .ok_or_else(|| {
-            SzConfigError::NotFound(format!(
-                "Generic threshold not found: plan={:?}, behavior={}",
-                params.plan, behavior_upper
-            ))
-        })?;
-
-    // Update fields from params
-    if let Some(dest_obj) = gthresh.as_object_mut() {
-        if let Some(feature_code) = params.feature {
-            let new_ftype_id = helpers::lookup_feature_id(config_json, feature_code)?;
-            dest_obj.insert("FTYPE_ID".to_string(), json!(new_ftype_id));
-        }
-        if let Some(cap) = params.candidate_cap {
-            dest_obj.insert("CANDIDATE_CAP".to_string(), json!(cap));
-        }
-        if let Some(cap) = params.scoring_cap {
-            dest_obj.insert("SCORING_CAP".to_string(), json!(cap));
-        }
-        if let Some(redo) = params.send_to_redo {
-            dest_obj.insert("SEND_TO_REDO".to_string(), json!(redo.to_uppercase()));
-        }
-    }
-
-    serde_json::to_string(&config).map_err(|e| SzConfigError::JsonParse(e.to_string()))
+    handle::edit(config_json, |config| config.set_generic_threshold(params))
 }
 
 /// List all generic thresholds with resolved names
@@ -868,59 +939,7 @@ pub fn set_generic_threshold(
 /// # Returns
 /// Vector of JSON Values with plan, behavior, feature, candidateCap, scoringCap, and sendToRedo fields
 pub fn list_generic_thresholds(config_json: &str) -> Result<Vec<Value>> {
-    let config: Value =
-        serde_json::from_str(config_json).map_err(|e| SzConfigError::JsonParse(e.to_string()))?;
-
-    let gthresh_array = config["G2_CONFIG"]["CFG_GENERIC_THRESHOLD"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_GENERIC_THRESHOLD".to_string()))?;
-
-    let gplan_array = config["G2_CONFIG"]["CFG_GPLAN"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_GPLAN".to_string()))?;
-
-    let ftype_array = config["G2_CONFIG"]["CFG_FTYPE"]
-        .as_array()
-        .ok_or_else(|| SzConfigError::MissingSection("CFG_FTYPE".to_string()))?;
-
-    let result: Vec<Value> = gthresh_array
-        .iter()
-        .map(|item| {
-            let gplan_id = item["GPLAN_ID"].as_i64().unwrap_or(0);
-            let ftype_id = item["FTYPE_ID"].as_i64().unwrap_or(0);
-
-            // Resolve plan name
-            let plan = gplan_array
-                .iter()
-                .find(|gp| gp["GPLAN_ID"].as_i64() == Some(gplan_id))
-                .and_then(|gp| gp["GPLAN_CODE"].as_str())
-                .unwrap_or("unknown")
-                .to_string();
-
-            // Resolve feature name
-            let feature = if ftype_id == 0 {
-                "all".to_string()
-            } else {
-                ftype_array
-                    .iter()
-                    .find(|ft| ft["FTYPE_ID"].as_i64() == Some(ftype_id))
-                    .and_then(|ft| ft["FTYPE_CODE"].as_str())
-                    .unwrap_or("unknown")
-                    .to_string()
-            };
-
-            json!({
-                "plan": plan,
-                "behavior": item["BEHAVIOR"].as_str().unwrap_or(""),
-                "feature": feature,
-                "candidateCap": item["CANDIDATE_CAP"].as_i64().unwrap_or(0),
-                "scoringCap": item["SCORING_CAP"].as_i64().unwrap_or(0),
-                "sendToRedo": item["SEND_TO_REDO"].as_str().unwrap_or("")
-            })
-        })
-        .collect();
-
-    Ok(result)
+    handle::read(config_json, |config| config.list_generic_thresholds())
 }
 
 /// Get threshold level by ID
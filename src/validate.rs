@@ -0,0 +1,555 @@
+//! Referential integrity checks for a configuration
+//!
+//! [`validate_config`] checks that every cross-table reference resolves
+//! (`CFG_FBOM.FTYPE_ID`, `CFG_ATTR.FTYPE_CODE`, `CFG_CFCALL.CFUNC_ID`,
+//! `CFG_GENERIC_THRESHOLD.GPLAN_ID`, ... see [`REFERENCES`]) and that no
+//! section holds two rows with the same key (see [`UNIQUE_KEYS`] and
+//! [`diff::SECTION_KEYS`](crate::diff::SECTION_KEYS)).
+//!
+//! Each referenced key is indexed once, into a hash set; the reference and
+//! duplicate checks are then independent and run in parallel when the
+//! configuration is large. A null, empty or non-positive reference means "no
+//! reference" (for example `FELEM_ID: -1` on a feature-level call, or
+//! `FTYPE_ID: 0` on an all-features threshold) and is not checked.
+//!
+//! # Example
+//!
+//! ```
+//! use sz_configtool_lib::validate::FindingKind;
+//! use sz_configtool_lib::ConfigHandle;
+//!
+//! let config = ConfigHandle::from_json(r#"{"G2_CONFIG":{
+//!     "CFG_FTYPE":[{"FTYPE_ID":1,"FTYPE_CODE":"NAME"}],
+//!     "CFG_FELEM":[{"FELEM_ID":2,"FELEM_CODE":"FULL_NAME"}],
+//!     "CFG_FBOM":[{"FTYPE_ID":1,"FELEM_ID":2},{"FTYPE_ID":7,"FELEM_ID":2}]}}"#)?;
+//!
+//! let report = config.validate_config()?;
+//! assert!(!report.is_valid());
+//! assert_eq!(report.findings[0].kind, FindingKind::DanglingReference);
+//! assert_eq!(report.findings[0].section, "CFG_FBOM");
+//! assert_eq!(report.findings[0].row, 1);
+//! # Ok::<(), sz_configtool_lib::SzConfigError>(())
+//! ```
+
+use crate::diff::SECTION_KEYS;
+use crate::error::{Result, SzConfigError};
+use crate::handle::ConfigHandle;
+use crate::helpers::run_parallel;
+use serde_json::{Map, Value, json};
+use std::collections::{HashMap, HashSet};
+use std::thread;
+
+/// Cross-table references: (section, field, target section, target field)
+///
+/// `CFG_ERFRAG.ERFRAG_DEPENDS`, a comma-separated list of `ERFRAG_ID`s, is
+/// checked as well.
+pub const REFERENCES: &[(&str, &str, &str, &str)] = &[
+    ("CFG_ATTR", "FTYPE_CODE", "CFG_FTYPE", "FTYPE_CODE"),
+    ("CFG_ATTR", "FELEM_CODE", "CFG_FELEM", "FELEM_CODE"),
+    ("CFG_CFBOM", "CFCALL_ID", "CFG_CFCALL", "CFCALL_ID"),
+    ("CFG_CFBOM", "FTYPE_ID", "CFG_FTYPE", "FTYPE_ID"),
+    ("CFG_CFBOM", "FELEM_ID", "CFG_FELEM", "FELEM_ID"),
+    ("CFG_CFCALL", "FTYPE_ID", "CFG_FTYPE", "FTYPE_ID"),
+    ("CFG_CFCALL", "CFUNC_ID", "CFG_CFUNC", "CFUNC_ID"),
+    ("CFG_CFRTN", "CFUNC_ID", "CFG_CFUNC", "CFUNC_ID"),
+    ("CFG_CFRTN", "FTYPE_ID", "CFG_FTYPE", "FTYPE_ID"),
+    ("CFG_DFBOM", "DFCALL_ID", "CFG_DFCALL", "DFCALL_ID"),
+    ("CFG_DFBOM", "FTYPE_ID", "CFG_FTYPE", "FTYPE_ID"),
+    ("CFG_DFBOM", "FELEM_ID", "CFG_FELEM", "FELEM_ID"),
+    ("CFG_DFCALL", "FTYPE_ID", "CFG_FTYPE", "FTYPE_ID"),
+    ("CFG_DFCALL", "DFUNC_ID", "CFG_DFUNC", "DFUNC_ID"),
+    ("CFG_EFBOM", "EFCALL_ID", "CFG_EFCALL", "EFCALL_ID"),
+    ("CFG_EFBOM", "FTYPE_ID", "CFG_FTYPE", "FTYPE_ID"),
+    ("CFG_EFBOM", "FELEM_ID", "CFG_FELEM", "FELEM_ID"),
+    ("CFG_EFCALL", "FTYPE_ID", "CFG_FTYPE", "FTYPE_ID"),
+    ("CFG_EFCALL", "FELEM_ID", "CFG_FELEM", "FELEM_ID"),
+    ("CFG_EFCALL", "EFUNC_ID", "CFG_EFUNC", "EFUNC_ID"),
+    ("CFG_EFCALL", "EFEAT_FTYPE_ID", "CFG_FTYPE", "FTYPE_ID"),
+    (
+        "CFG_ERRULE",
+        "QUAL_ERFRAG_CODE",
+        "CFG_ERFRAG",
+        "ERFRAG_CODE",
+    ),
+    (
+        "CFG_ERRULE",
+        "DISQ_ERFRAG_CODE",
+        "CFG_ERFRAG",
+        "ERFRAG_CODE",
+    ),
+    ("CFG_ERRULE", "RTYPE_ID", "CFG_RTYPE", "RTYPE_ID"),
+    ("CFG_FBOM", "FTYPE_ID", "CFG_FTYPE", "FTYPE_ID"),
+    ("CFG_FBOM", "FELEM_ID", "CFG_FELEM", "FELEM_ID"),
+    ("CFG_FBOVR", "FTYPE_ID", "CFG_FTYPE", "FTYPE_ID"),
+    ("CFG_FTYPE", "FCLASS_ID", "CFG_FCLASS", "FCLASS_ID"),
+    ("CFG_FTYPE", "RTYPE_ID", "CFG_RTYPE", "RTYPE_ID"),
+    ("CFG_GENERIC_THRESHOLD", "GPLAN_ID", "CFG_GPLAN", "GPLAN_ID"),
+    ("CFG_GENERIC_THRESHOLD", "FTYPE_ID", "CFG_FTYPE", "FTYPE_ID"),
+    ("CFG_SFCALL", "FTYPE_ID", "CFG_FTYPE", "FTYPE_ID"),
+    ("CFG_SFCALL", "FELEM_ID", "CFG_FELEM", "FELEM_ID"),
+    ("CFG_SFCALL", "SFUNC_ID", "CFG_SFUNC", "SFUNC_ID"),
+];
+
+/// Unique keys checked in addition to each section's primary key
+pub const UNIQUE_KEYS: &[(&str, &[&str])] = &[
+    ("CFG_ATTR", &["ATTR_ID"]),
+    ("CFG_CFUNC", &["CFUNC_CODE"]),
+    ("CFG_DFUNC", &["DFUNC_CODE"]),
+    ("CFG_DSRC", &["DSRC_ID"]),
+    ("CFG_EFUNC", &["EFUNC_CODE"]),
+    ("CFG_ERFRAG", &["ERFRAG_ID"]),
+    ("CFG_ERRULE", &["ERRULE_ID"]),
+    ("CFG_FCLASS", &["FCLASS_CODE"]),
+    ("CFG_FELEM", &["FELEM_CODE"]),
+    ("CFG_FTYPE", &["FTYPE_CODE"]),
+    ("CFG_GPLAN", &["GPLAN_CODE"]),
+    ("CFG_RTYPE", &["RTYPE_CODE"]),
+    ("CFG_SFUNC", &["SFUNC_CODE"]),
+];
+
+/// Comma-separated ID list references: (section, field, target section, target field)
+const LIST_REFERENCES: &[(&str, &str, &str, &str)] =
+    &[("CFG_ERFRAG", "ERFRAG_DEPENDS", "CFG_ERFRAG", "ERFRAG_ID")];
+
+/// Total rows above which the checks run on several threads
+const PARALLEL_THRESHOLD: usize = 20_000;
+
+/// What a [`Finding`] reports
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum FindingKind {
+    /// Two rows of a section share a key
+    Duplicate,
+    /// A reference names a row that does not exist
+    DanglingReference,
+    /// Rows reference a section that does not exist
+    MissingSection,
+}
+
+impl FindingKind {
+    fn as_str(self) -> &'static str {
+        match self {
+            FindingKind::Duplicate => "duplicate",
+            FindingKind::DanglingReference => "danglingReference",
+            FindingKind::MissingSection => "missingSection",
+        }
+    }
+}
+
+/// One integrity problem
+#[derive(Debug, Clone, PartialEq)]
+pub struct Finding {
+    pub kind: FindingKind,
+    /// Section holding the offending row
+    pub section: &'static str,
+    /// Index of the offending row in its section (for a duplicate, the later one)
+    pub row: usize,
+    /// Key or reference fields checked
+    pub fields: &'static [&'static str],
+    /// Offending key or reference value
+    pub value: Value,
+    /// Referenced section and field (None for duplicates)
+    pub target: Option<(&'static str, &'static str)>,
+    /// For a duplicate, index of the first row with the same key
+    pub first_row: Option<usize>,
+}
+
+impl Finding {
+    /// Human-readable description
+    pub fn message(&self) -> String {
+        let fields = self.fields.join(", ");
+        match (self.kind, self.target) {
+            (FindingKind::Duplicate, _) => format!(
+                "{} row {}: duplicate {} {} (first in row {})",
+                self.section,
+                self.row,
+                fields,
+                self.value,
+                self.first_row.unwrap_or_default()
+            ),
+            (FindingKind::DanglingReference, Some((section, field))) => format!(
+                "{} row {}: {} {} not found in {}.{}",
+                self.section, self.row, fields, self.value, section, field
+            ),
+            (_, target) => format!(
+                "{} row {}: {} references missing section {}",
+                self.section,
+                self.row,
+                fields,
+                target.map_or("", |(section, _)| section)
+            ),
+        }
+    }
+}
+
+/// Result of [`validate_config`]
+#[derive(Debug, Clone, Default, PartialEq)]
+pub struct ValidationReport {
+    /// Findings in the order of [`REFERENCES`] and then the unique-key checks
+    pub findings: Vec<Finding>,
+    /// Rows in the sections that were checked
+    pub rows_checked: usize,
+}
+
+impl ValidationReport {
+    /// True if there are no findings
+    pub fn is_valid(&self) -> bool {
+        self.findings.is_empty()
+    }
+
+    /// Number of findings of one kind
+    pub fn count(&self, kind: FindingKind) -> usize {
+        self.findings.iter().filter(|f| f.kind == kind).count()
+    }
+
+    /// Report as JSON
+    ///
+    /// ```text
+    /// {"valid": false, "rowsChecked": 1200,
+    ///  "summary": {"duplicate": 0, "danglingReference": 1, "missingSection": 0},
+    ///  "findings": [{"kind": "danglingReference", "section": "CFG_FBOM",
+    ///                "row": 7, "fields": ["FTYPE_ID"], "value": 99,
+    ///                "target": "CFG_FTYPE.FTYPE_ID", "message": "..."}]}
+    /// ```
+    pub fn to_json(&self) -> Value {
+        let findings: Vec<Value> = self
+            .findings
+            .iter()
+            .map(|f| {
+                let mut entry = json!({
+                    "kind": f.kind.as_str(),
+                    "section": f.section,
+                    "row": f.row,
+                    "fields": f.fields,
+                    "value": f.value,
+                    "message": f.message(),
+                });
+                if let Some((section, field)) = f.target {
+                    entry["target"] = json!(format!("{}.{}", section, field));
+                }
+                if let Some(first_row) = f.first_row {
+                    entry["firstRow"] = json!(first_row);
+                }
+                entry
+            })
+            .collect();
+
+        let kinds = [
+            FindingKind::Duplicate,
+            FindingKind::DanglingReference,
+            FindingKind::MissingSection,
+        ];
+        let summary: Map<String, Value> = kinds
+            .iter()
+            .map(|&kind| (kind.as_str().to_string(), json!(self.count(kind))))
+            .collect();
+
+        json!({
+            "valid": self.is_valid(),
+            "rowsChecked": self.rows_checked,
+            "summary": summary,
+            "findings": findings,
+        })
+    }
+}
+
+/// Check the referential integrity of a configuration JSON string
+///
+/// # Returns
+/// JSON report (see [`ValidationReport::to_json`])
+///
+/// # Errors
+/// - `JsonParse` if the document is invalid
+/// - `MissingSection` if it has no `G2_CONFIG` object
+pub fn validate_config(config_json: &str) -> Result<String> {
+    let config = ConfigHandle::from_json(config_json)?;
+    Ok(config.validate_config()?.to_json().to_string())
+}
+
+/// A key value, borrowed from the document
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+enum Key<'a> {
+    Int(i64),
+    Str(&'a str),
+}
+
+impl<'a> Key<'a> {
+    /// Key of a value (None for null, empty strings and other types)
+    fn of(value: &'a Value) -> Option<Self> {
+        match value {
+            Value::Number(n) => n.as_i64().map(Key::Int),
+            Value::String(s) if !s.is_empty() => Some(Key::Str(s)),
+            _ => None,
+        }
+    }
+
+    /// Key of a reference (as [`of`](Self::of), but non-positive IDs mean none)
+    fn reference(value: &'a Value) -> Option<Self> {
+        Self::of(value).filter(|key| !matches!(key, Key::Int(id) if *id <= 0))
+    }
+}
+
+/// Keys of one referenced field (None if the section is missing)
+type TargetIndex<'a> = Option<HashSet<Key<'a>>>;
+
+/// One independent check
+enum Check {
+    Reference(&'static (&'static str, &'static str, &'static str, &'static str)),
+    List(&'static (&'static str, &'static str, &'static str, &'static str)),
+    Unique(&'static str, &'static [&'static str]),
+}
+
+impl ConfigHandle {
+    /// Check referential integrity (in-place form of [`validate_config`])
+    ///
+    /// # Errors
+    /// - `MissingSection` if the configuration has no `G2_CONFIG` object
+    pub fn validate_config(&self) -> Result<ValidationReport> {
+        let g2_config = self
+            .g2_config()
+            .ok_or_else(|| SzConfigError::MissingSection("G2_CONFIG".to_string()))?;
+        let rows = |section: &str| g2_config.get(section).and_then(|v| v.as_array());
+
+        let checks: Vec<Check> = REFERENCES
+            .iter()
+            .map(Check::Reference)
+            .chain(LIST_REFERENCES.iter().map(Check::List))
+            .chain(
+                SECTION_KEYS
+                    .iter()
+                    .chain(UNIQUE_KEYS)
+                    .map(|(section, fields)| Check::Unique(section, fields)),
+            )
+            .collect();
+
+        let mut sections: Vec<&str> = checks
+            .iter()
+            .map(|check| match check {
+                Check::Reference((section, ..)) | Check::List((section, ..)) => *section,
+                Check::Unique(section, _) => section,
+            })
+            .collect();
+        sections.sort_unstable();
+        sections.dedup();
+        let rows_checked = sections
+            .iter()
+            .map(|section| rows(section).map_or(0, |r| r.len()))
+            .sum();
+        let threads = if rows_checked > PARALLEL_THRESHOLD {
+            thread::available_parallelism().map_or(1, |n| n.get())
+        } else {
+            1
+        };
+
+        // Index every referenced key once
+        let mut targets: Vec<(&str, &str)> = REFERENCES
+            .iter()
+            .chain(LIST_REFERENCES)
+            .map(|(_, _, section, field)| (*section, *field))
+            .collect();
+        targets.sort_unstable();
+        targets.dedup();
+        let indexes: HashMap<(&str, &str), TargetIndex> = targets
+            .iter()
+            .copied()
+            .zip(run_parallel(targets.len(), threads, |i| {
+                let (section, field) = targets[i];
+                rows(section)
+                    .map(|rows| rows.iter().filter_map(|row| Key::of(&row[field])).collect())
+            }))
+            .collect();
+
+        let findings = run_parallel(checks.len(), threads, |i| match &checks[i] {
+            Check::Reference(reference) => {
+                let (section, field, target_section, target_field) = **reference;
+                let index = &indexes[&(target_section, target_field)];
+                check_references(rows(section), section, field, reference, index, |value| {
+                    Key::reference(value).into_iter().collect()
+                })
+            }
+            Check::List(reference) => {
+                let (section, field, target_section, target_field) = **reference;
+                let index = &indexes[&(target_section, target_field)];
+                check_references(rows(section), section, field, reference, index, |value| {
+                    list_keys(value)
+                })
+            }
+            Check::Unique(section, fields) => check_unique(rows(section), section, fields),
+        });
+
+        Ok(ValidationReport {
+            findings: findings.into_iter().flatten().collect(),
+            rows_checked,
+        })
+    }
+}
+
+/// Keys of a comma-separated ID list
+fn list_keys(value: &Value) -> Vec<Key<'_>> {
+    value
+        .as_str()
+        .unwrap_or("")
+        .split(',')
+        .filter_map(|id| id.trim().parse().ok())
+        .map(Key::Int)
+        .collect()
+}
+
+fn check_references<'a>(
+    rows: Option<&'a Vec<Value>>,
+    section: &'static str,
+    field: &'static str,
+    reference: &'static (&'static str, &'static str, &'static str, &'static str),
+    index: &TargetIndex<'_>,
+    keys: impl Fn(&'a Value) -> Vec<Key<'a>>,
+) -> Vec<Finding> {
+    let (_, fields, target_section, target_field) = reference;
+    let fields = std::slice::from_ref(fields);
+    let target = Some((*target_section, *target_field));
+    let mut findings = Vec::new();
+
+    for (row, item) in rows.into_iter().flatten().enumerate() {
+        let value = &item[field];
+        let missing = keys(value)
+            .into_iter()
+            .any(|key| index.as_ref().is_none_or(|index| !index.contains(&key)));
+        if !missing {
+            continue;
+        }
+
+        let finding = Finding {
+            kind: if index.is_some() {
+                FindingKind::DanglingReference
+            } else {
+                FindingKind::MissingSection
+            },
+            section,
+            row,
+            fields,
+            value: value.clone(),
+            target,
+            first_row: None,
+        };
+        // A missing section is reported once, at the first referencing row
+        let stop = finding.kind == FindingKind::MissingSection;
+        findings.push(finding);
+        if stop {
+            break;
+        }
+    }
+    findings
+}
+
+fn check_unique(
+    rows: Option<&Vec<Value>>,
+    section: &'static str,
+    fields: &'static [&'static str],
+) -> Vec<Finding> {
+    let mut seen: HashMap<Vec<Key>, usize> = HashMap::new();
+    let mut findings = Vec::new();
+
+    for (row, item) in rows.into_iter().flatten().enumerate() {
+        // Rows missing a key field are not keyed
+        let Some(key) = fields
+            .iter()
+            .map(|field| Key::of(&item[*field]))
+            .collect::<Option<Vec<_>>>()
+        else {
+            continue;
+        };
+
+        if let Some(&first_row) = seen.get(&key) {
+            let value = if let [field] = fields {
+                item[*field].clone()
+            } else {
+                Value::Object(
+                    fields
+                        .iter()
+                        .map(|field| (field.to_string(), item[*field].clone()))
+                        .collect(),
+                )
+            };
+            findings.push(Finding {
+                kind: FindingKind::Duplicate,
+                section,
+                row,
+                fields,
+                value,
+                target: None,
+                first_row: Some(first_row),
+            });
+        } else {
+            seen.insert(key, row);
+        }
+    }
+    findings
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn config() -> Value {
+        json!({"G2_CONFIG": {
+            "CFG_FCLASS": [{"FCLASS_ID": 1, "FCLASS_CODE": "OTHER"}],
+            "CFG_FTYPE": [
+                {"FTYPE_ID": 1, "FTYPE_CODE": "NAME", "FCLASS_ID": 1, "RTYPE_ID": 0},
+                {"FTYPE_ID": 2, "FTYPE_CODE": "PHONE", "FCLASS_ID": 1, "RTYPE_ID": 0}
+            ],
+            "CFG_FELEM": [{"FELEM_ID": 10, "FELEM_CODE": "FULL_NAME"}],
+            "CFG_FBOM": [{"FTYPE_ID": 1, "FELEM_ID": 10}],
+            "CFG_ATTR": [{"ATTR_ID": 1, "ATTR_CODE": "NAME_FULL", "FTYPE_CODE": "NAME", "FELEM_CODE": "FULL_NAME"}],
+            "CFG_CFUNC": [{"CFUNC_ID": 1, "CFUNC_CODE": "CMP"}],
+            "CFG_CFCALL": [{"CFCALL_ID": 1, "FTYPE_ID": 1, "CFUNC_ID": 1}],
+            "CFG_ERFRAG": [
+                {"ERFRAG_ID": 1, "ERFRAG_CODE": "SAME_NAME", "ERFRAG_DEPENDS": null},
+                {"ERFRAG_ID": 2, "ERFRAG_CODE": "CLOSE_NAME", "ERFRAG_DEPENDS": "1"}
+            ],
+            "CFG_ERRULE": [{"ERRULE_ID": 1, "ERRULE_CODE": "R1", "QUAL_ERFRAG_CODE": "SAME_NAME", "DISQ_ERFRAG_CODE": null, "RTYPE_ID": 0}],
+            "CFG_SFCALL": [{"SFCALL_ID": 1, "FTYPE_ID": -1, "FELEM_ID": 10, "SFUNC_ID": 1}],
+            "CFG_SFUNC": [{"SFUNC_ID": 1, "SFUNC_CODE": "PARSE"}]
+        }})
+    }
+
+    #[test]
+    fn test_validate_config_clean() {
+        let report = ConfigHandle::from_value(config())
+            .validate_config()
+            .unwrap();
+        assert!(report.is_valid(), "{:?}", report.findings);
+        assert!(report.rows_checked > 0);
+    }
+
+    #[test]
+    fn test_validate_config_findings() {
+        let mut value = config();
+        let g2 = &mut value["G2_CONFIG"];
+        g2["CFG_CFCALL"][0]["CFUNC_ID"] = json!(9);
+        g2["CFG_ATTR"][0]["FTYPE_CODE"] = json!("MISSING");
+        g2["CFG_ERFRAG"][1]["ERFRAG_DEPENDS"] = json!("1,7");
+        g2["CFG_FTYPE"][1]["FTYPE_CODE"] = json!("NAME");
+        g2["CFG_GENERIC_THRESHOLD"] = json!([{"GPLAN_ID": 1, "BEHAVIOR": "NAME", "FTYPE_ID": 0}]);
+
+        let report = ConfigHandle::from_value(value).validate_config().unwrap();
+        let messages: Vec<String> = report.findings.iter().map(|f| f.message()).collect();
+        assert_eq!(
+            report.count(FindingKind::DanglingReference),
+            3,
+            "{messages:?}"
+        );
+        assert_eq!(report.count(FindingKind::Duplicate), 1, "{messages:?}");
+        assert_eq!(report.count(FindingKind::MissingSection), 1, "{messages:?}");
+
+        let duplicate = report
+            .findings
+            .iter()
+            .find(|f| f.kind == FindingKind::Duplicate)
+            .unwrap();
+        assert_eq!((duplicate.section, duplicate.row), ("CFG_FTYPE", 1));
+        assert_eq!(duplicate.first_row, Some(0));
+
+        let json = report.to_json();
+        assert_eq!(json["valid"], false);
+        assert_eq!(json["summary"]["danglingReference"], 3);
+        assert_eq!(json["findings"][0]["target"], "CFG_FTYPE.FTYPE_CODE");
+    }
+}
@@ -4,7 +4,77 @@
 //! Includes VERSION and COMPATIBILITY_VERSION fields.
 
 use crate::error::{Result, SzConfigError};
-use serde_json::Value;
+use crate::handle::{self, ConfigHandle};
+
+impl ConfigHandle {
+    /// Get the configuration version (see [`get_version`])
+    pub fn get_version(&self) -> Result<String> {
+        self.g2_entry("CONFIG_BASE_VERSION")
+            .and_then(|bv| bv.get("VERSION"))
+            .and_then(|v| v.as_str())
+            .map(|s| s.to_string())
+            .ok_or_else(|| {
+                SzConfigError::NotFound("VERSION not found in configuration".to_string())
+            })
+    }
+
+    /// Get the compatibility version (see [`get_compatibility_version`])
+    pub fn get_compatibility_version(&self) -> Result<String> {
+        self.compatibility_config_version().ok_or_else(|| {
+            SzConfigError::NotFound("COMPATIBILITY_VERSION not found in configuration".to_string())
+        })
+    }
+
+    /// Update the compatibility version (in-place form of [`update_compatibility_version`])
+    pub fn update_compatibility_version(&mut self, new_version: &str) -> Result<()> {
+        if self.g2_config().is_some() {
+            if let Some(base_version) = self.g2_entry_mut("CONFIG_BASE_VERSION") {
+                if let Some(compat_version) = base_version.get_mut("COMPATIBILITY_VERSION") {
+                    if let Some(compat_obj) = compat_version.as_object_mut() {
+                        compat_obj
+                            .insert("CONFIG_VERSION".to_string(), serde_json::json!(new_version));
+                    } else {
+                        return Err(SzConfigError::InvalidConfig(
+                            "COMPATIBILITY_VERSION is not an object".to_string(),
+                        ));
+                    }
+                } else {
+                    return Err(SzConfigError::NotFound(
+                        "COMPATIBILITY_VERSION not found".to_string(),
+                    ));
+                }
+            } else {
+                return Err(SzConfigError::NotFound(
+                    "CONFIG_BASE_VERSION not found".to_string(),
+                ));
+            }
+        }
+
+        Ok(())
+    }
+
+    /// Verify the compatibility version matches expected value (see [`verify_compatibility_version`])
+    ///
+    /// Returns `(current_version, matches)`.
+    pub fn verify_compatibility_version(&self, expected_version: &str) -> Result<(String, bool)> {
+        let current_version = self
+            .compatibility_config_version()
+            .ok_or_else(|| SzConfigError::NotFound("CONFIG_VERSION not found".to_string()))?;
+
+        let matches = current_version == expected_version;
+
+        Ok((current_version, matches))
+    }
+
+    /// COMPATIBILITY_VERSION.CONFIG_VERSION, if present
+    fn compatibility_config_version(&self) -> Option<String> {
+        self.g2_entry("CONFIG_BASE_VERSION")
+            .and_then(|bv| bv.get("COMPATIBILITY_VERSION"))
+            .and_then(|cv| cv.get("CONFIG_VERSION"))
+            .and_then(|v| v.as_str())
+            .map(|s| s.to_string())
+    }
+}
 
 /// Get the configuration version
 ///
@@ -26,16 +96,9 @@ use serde_json::Value;
 /// assert_eq!(version, "4.0.0");
 /// ```
 pub fn get_version(config_json: &str) -> Result<String> {
-    let config_data: Value = serde_json::from_str(config_json)?;
-
-    let version = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CONFIG_BASE_VERSION"))
-        .and_then(|bv| bv.get("VERSION"))
-        .and_then(|v| v.as_str())
-        .ok_or_else(|| SzConfigError::NotFound("VERSION not found in configuration".to_string()))?;
-
-    Ok(version.to_string())
+    handle::read_sections(config_json, &["CONFIG_BASE_VERSION"], |config| {
+        config.get_version()
+    })
 }
 
 /// Get the compatibility version
@@ -58,19 +121,9 @@ pub fn get_version(config_json: &str) -> Result<String> {
 /// assert_eq!(version, "11");
 /// ```
 pub fn get_compatibility_version(config_json: &str) -> Result<String> {
-    let config_data: Value = serde_json::from_str(config_json)?;
-
-    let version = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CONFIG_BASE_VERSION"))
-        .and_then(|bv| bv.get("COMPATIBILITY_VERSION"))
-        .and_then(|cv| cv.get("CONFIG_VERSION"))
-        .and_then(|v| v.as_str())
-        .ok_or_else(|| {
-            SzConfigError::NotFound("COMPATIBILITY_VERSION not found in configuration".to_string())
-        })?;
-
-    Ok(version.to_string())
+    handle::read_sections(config_json, &["CONFIG_BASE_VERSION"], |config| {
+        config.get_compatibility_version()
+    })
 }
 
 /// Update the compatibility version
@@ -93,31 +146,9 @@ pub fn get_compatibility_version(config_json: &str) -> Result<String> {
 /// let modified = versioning::update_compatibility_version(config, "11").unwrap();
 /// ```
 pub fn update_compatibility_version(config_json: &str, new_version: &str) -> Result<String> {
-    let mut config_data: Value = serde_json::from_str(config_json)?;
-
-    if let Some(g2_config) = config_data.get_mut("G2_CONFIG") {
-        if let Some(base_version) = g2_config.get_mut("CONFIG_BASE_VERSION") {
-            if let Some(compat_version) = base_version.get_mut("COMPATIBILITY_VERSION") {
-                if let Some(compat_obj) = compat_version.as_object_mut() {
-                    compat_obj.insert("CONFIG_VERSION".to_string(), serde_json::json!(new_version));
-                } else {
-                    return Err(SzConfigError::InvalidConfig(
-                        "COMPATIBILITY_VERSION is not an object".to_string(),
-                    ));
-                }
-            } else {
-                return Err(SzConfigError::NotFound(
-                    "COMPATIBILITY_VERSION not found".to_string(),
-                ));
-            }
-        } else {
-            return Err(SzConfigError::NotFound(
-                "CONFIG_BASE_VERSION not found".to_string(),
-            ));
-        }
-    }
-
-    Ok(serde_json::to_string(&config_data)?)
+    handle::edit(config_json, |config| {
+        config.update_compatibility_version(new_version)
+    })
 }
 
 /// Verify the compatibility version matches expected value
@@ -144,17 +175,7 @@ pub fn verify_compatibility_version(
     config_json: &str,
     expected_version: &str,
 ) -> Result<(String, bool)> {
-    let config_data: Value = serde_json::from_str(config_json)?;
-
-    let current_version = config_data
-        .get("G2_CONFIG")
-        .and_then(|g| g.get("CONFIG_BASE_VERSION"))
-        .and_then(|bv| bv.get("COMPATIBILITY_VERSION"))
-        .and_then(|cv| cv.get("CONFIG_VERSION"))
-        .and_then(|v| v.as_str())
-        .ok_or_else(|| SzConfigError::NotFound("CONFIG_VERSION not found".to_string()))?;
-
-    let matches = current_version == expected_version;
-
-    Ok((current_version.to_string(), matches))
+    handle::read_sections(config_json, &["CONFIG_BASE_VERSION"], |config| {
+        config.verify_compatibility_version(expected_version)
+    })
 }
@@ -0,0 +1,254 @@
+/**
+ * Multithreaded FFI stress test and latency benchmark for libSzConfigTool
+ *
+ * Runs 1, 2, 4, ... up to max_threads native threads against one shared,
+ * read-only config string. Each call is timed individually. The mix is:
+ * - reads:  listFeatures, getConfigSection (CFG_DSRC)
+ * - writes: addDataSource, setFeature (each returns a new config, freed)
+ * - errors: getConfigSection on a per-thread missing section, after which the
+ *           thread checks that SzConfigTool_getLastError names its own
+ *           section (errors must never leak between threads)
+ *
+ * Reports p50/p99 latency, throughput and the speedup over one thread for each
+ * thread count, plus resident memory after each round so allocator growth
+ * from CString results shows up. Exits non-zero on any failed call.
+ *
+ * Usage: stress_ffi [config.json|-] [ops_per_thread] [max_threads]
+ *
+ * Generate large configs with:
+ *   cargo bench --bench configtool -- --emit-config 10 g2config_10x.json
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include "../../include/libSzConfigTool.h"
+
+static const char *DEFAULT_CONFIG =
+    "{\"G2_CONFIG\":{\"CFG_DSRC\":[],\"CFG_FCLASS\":[{\"FCLASS_ID\":1,\"FCLASS_CODE\":\"OTHER\"}],"
+    "\"CFG_FTYPE\":[{\"FTYPE_ID\":1,\"FTYPE_CODE\":\"NAME\",\"FCLASS_ID\":1}],"
+    "\"CFG_FELEM\":[{\"FELEM_ID\":1,\"FELEM_CODE\":\"FULL_NAME\"}],"
+    "\"CFG_FBOM\":[{\"FTYPE_ID\":1,\"FELEM_ID\":1,\"EXEC_ORDER\":1}],"
+    "\"CFG_GENERIC_THRESHOLD\":[],\"CFG_GPLAN\":[]}}";
+
+/* One operation in ten is a write, one in twenty a deliberate error */
+#define WRITE_EVERY 10
+#define ERROR_EVERY 20
+
+struct worker {
+    pthread_t thread;
+    int id;
+    const char *config;
+    int ops;
+    double *latencies_us;
+    const char *failure;
+};
+
+/* Set by the first failing thread; the others stop at their next call */
+static atomic_int failed;
+
+/* Keeps results alive so the calls are not optimized away */
+static atomic_size_t sink;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* Current resident set size in KiB (peak RSS where /proc is unavailable) */
+static long rss_kib(void) {
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (f != NULL) {
+        long size = 0;
+        long resident = 0;
+        int read = fscanf(f, "%ld %ld", &size, &resident);
+        fclose(f);
+        if (read == 2) {
+            return resident * (sysconf(_SC_PAGESIZE) / 1024);
+        }
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+static char *read_file(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        exit(1);
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *data = malloc((size_t)size + 1);
+    if (data == NULL || fread(data, 1, (size_t)size, f) != (size_t)size) {
+        fprintf(stderr, "FAIL: could not read %s\n", path);
+        exit(1);
+    }
+    data[size] = '\0';
+    fclose(f);
+    return data;
+}
+
+static int fail(struct worker *w, const char *message) {
+    w->failure = message;
+    fprintf(stderr, "FAIL: thread %d: %s: %s\n", w->id, message, SzConfigTool_getLastError());
+    atomic_store(&failed, 1);
+    return 1;
+}
+
+/* Frees a successful result, or records the failure */
+static int consume(struct worker *w, struct SzConfigTool_result result, const char *message) {
+    if (result.returnCode != 0 || result.response == NULL) {
+        return fail(w, message);
+    }
+    atomic_fetch_add_explicit(&sink, strlen(result.response), memory_order_relaxed);
+    SzConfigTool_free(result.response);
+    return 0;
+}
+
+static int run_op(struct worker *w, int i, char *code, size_t code_size) {
+    if (i % ERROR_EVERY == ERROR_EVERY - 1) {
+        snprintf(code, code_size, "CFG_MISSING_%d", w->id);
+        struct SzConfigTool_result result = SzConfigTool_getConfigSection(w->config, code, NULL);
+        if (result.returnCode == 0) {
+            SzConfigTool_free(result.response);
+            return fail(w, "getConfigSection on a missing section should fail");
+        }
+        if (strstr(SzConfigTool_getLastError(), code) == NULL) {
+            return fail(w, "last error does not belong to this thread");
+        }
+        return 0;
+    }
+    if (i % WRITE_EVERY == WRITE_EVERY - 1) {
+        if ((i / WRITE_EVERY) % 2 == 0) {
+            snprintf(code, code_size, "STRESS_DS_%d_%d", w->id, i);
+            return consume(w, SzConfigTool_addDataSource(w->config, code), "addDataSource");
+        }
+        return consume(w, SzConfigTool_setFeature(w->config, "NAME", "{\"candidates\": \"Yes\"}"),
+                       "setFeature");
+    }
+    if (i % 2 == 0) {
+        return consume(w, SzConfigTool_listFeatures(w->config), "listFeatures");
+    }
+    return consume(w, SzConfigTool_getConfigSection(w->config, "CFG_DSRC", NULL), "getConfigSection");
+}
+
+static void *worker_main(void *arg) {
+    struct worker *w = arg;
+    char code[64];
+    for (int i = 0; i < w->ops && !atomic_load_explicit(&failed, memory_order_relaxed); i++) {
+        double start = now_seconds();
+        if (run_op(w, i, code, sizeof(code)) != 0) {
+            break;
+        }
+        w->latencies_us[i] = (now_seconds() - start) * 1e6;
+    }
+    return NULL;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of a sorted array */
+static double percentile(const double *sorted, size_t n, double p) {
+    size_t rank = (size_t)(p / 100.0 * (double)n + 0.5);
+    if (rank == 0) {
+        rank = 1;
+    }
+    return sorted[rank > n ? n - 1 : rank - 1];
+}
+
+/* Runs one round with `threads` workers; returns throughput in ops/s, or -1 */
+static double run_round(const char *config, int threads, int ops, double *latencies) {
+    struct worker *workers = calloc((size_t)threads, sizeof(struct worker));
+    if (workers == NULL) {
+        fprintf(stderr, "FAIL: out of memory\n");
+        exit(1);
+    }
+
+    double start = now_seconds();
+    for (int t = 0; t < threads; t++) {
+        workers[t].id = t;
+        workers[t].config = config;
+        workers[t].ops = ops;
+        workers[t].latencies_us = latencies + (size_t)t * (size_t)ops;
+        if (pthread_create(&workers[t].thread, NULL, worker_main, &workers[t]) != 0) {
+            fprintf(stderr, "FAIL: could not start thread %d\n", t);
+            exit(1);
+        }
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(workers[t].thread, NULL);
+    }
+    double elapsed = now_seconds() - start;
+    free(workers);
+
+    if (atomic_load(&failed)) {
+        return -1;
+    }
+    return (double)threads * (double)ops / elapsed;
+}
+
+int main(int argc, char **argv) {
+    char *config = argc > 1 && strcmp(argv[1], "-") != 0 ? read_file(argv[1]) : strdup(DEFAULT_CONFIG);
+    int ops = argc > 2 ? atoi(argv[2]) : 200;
+    int max_threads = argc > 3 ? atoi(argv[3]) : 64;
+    if (ops <= 0) {
+        ops = 200;
+    }
+    if (max_threads <= 0) {
+        max_threads = 64;
+    }
+
+    printf("=== libSzConfigTool FFI stress (%zu byte config, %d ops/thread, %ld CPUs) ===\n",
+           strlen(config), ops, sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%8s %12s %12s %14s %9s %12s\n", "threads", "p50 us", "p99 us", "ops/s", "speedup",
+           "RSS KiB");
+
+    long rss_start = rss_kib();
+    double *latencies = malloc((size_t)max_threads * (size_t)ops * sizeof(double));
+    if (latencies == NULL) {
+        fprintf(stderr, "FAIL: out of memory\n");
+        return 1;
+    }
+
+    double single_thread = 0.0;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        double throughput = run_round(config, threads, ops, latencies);
+        if (throughput < 0) {
+            free(latencies);
+            free(config);
+            return 1;
+        }
+        if (threads == 1) {
+            single_thread = throughput;
+        }
+
+        size_t n = (size_t)threads * (size_t)ops;
+        qsort(latencies, n, sizeof(double), compare_doubles);
+        printf("%8d %12.3f %12.3f %14.0f %8.2fx %12ld\n", threads, percentile(latencies, n, 50),
+               percentile(latencies, n, 99), throughput, throughput / single_thread, rss_kib());
+        fflush(stdout);
+    }
+
+    free(latencies);
+    printf("\nRSS growth over the run: %ld KiB\n", rss_kib() - rss_start);
+    printf("✓ All calls succeeded; per-thread errors stayed per-thread\n");
+    free(config);
+    return 0;
+}
@@ -4,7 +4,10 @@
 //! configuration JSON documents.
 
 use serde_json::json;
-use sz_configtool_lib::{datasources, elements, helpers};
+use sz_configtool_lib::{
+    ConfigHandle, attributes, behavior_overrides, config_sections, datasources, elements, helpers,
+    versioning,
+};
 
 const TEST_CONFIG: &str = r#"{
   "G2_CONFIG": {
@@ -128,3 +131,181 @@ fn test_chained_operations() {
         datasources::list_data_sources(&config).expect("Failed to list data sources after delete");
     assert_eq!(sources.len(), 2);
 }
+
+#[test]
+fn test_config_handle_batch_edits() {
+    let mut config = ConfigHandle::from_json(TEST_CONFIG).expect("Failed to parse config");
+
+    for code in ["CUSTOMERS", "WATCHLIST", "EMPLOYEES"] {
+        config
+            .add_data_source(datasources::AddDataSourceParams {
+                code,
+                ..Default::default()
+            })
+            .expect("Failed to add data source");
+    }
+
+    // A failed edit leaves the document untouched
+    let before = config.to_json().unwrap();
+    assert!(config.delete_data_source("MISSING").is_err());
+    assert_eq!(config.to_json().unwrap(), before);
+
+    // The handle and string forms produce the same document
+    let mut expected = TEST_CONFIG.to_string();
+    for code in ["CUSTOMERS", "WATCHLIST", "EMPLOYEES"] {
+        expected = datasources::add_data_source(
+            &expected,
+            datasources::AddDataSourceParams {
+                code,
+                ..Default::default()
+            },
+        )
+        .unwrap();
+    }
+    assert_eq!(before, expected);
+}
+
+#[test]
+fn test_bulk_adds_match_single_adds() {
+    let data_sources: Vec<_> = ["CUSTOMERS", "watchlist", "EMPLOYEES"]
+        .into_iter()
+        .map(|code| datasources::AddDataSourceParams {
+            code,
+            reliability: Some(2),
+            ..Default::default()
+        })
+        .collect();
+    let attrs: Vec<_> = ["NAME_FULL", "ADDR_FULL"]
+        .into_iter()
+        .map(|attribute| attributes::AddAttributeParams {
+            attribute,
+            feature: "name",
+            element: "full_name",
+            class: "NAME",
+            default_value: None,
+            internal: None,
+            required: Some("Yes"),
+        })
+        .collect();
+
+    let mut expected = TEST_CONFIG.to_string();
+    for params in &data_sources {
+        expected = datasources::add_data_source(&expected, params.clone()).unwrap();
+    }
+    let mut expected_attrs = Vec::new();
+    for params in &attrs {
+        let (json, attr) = attributes::add_attribute(&expected, params.clone()).unwrap();
+        expected = json;
+        expected_attrs.push(attr);
+    }
+
+    let config = datasources::add_data_sources(TEST_CONFIG, &data_sources).unwrap();
+    let (config, added) = attributes::add_attributes(&config, &attrs).unwrap();
+    assert_eq!(config, expected);
+    assert_eq!(added, expected_attrs);
+
+    // All or nothing: one clash rejects the whole batch
+    let mut handle = ConfigHandle::from_json(&config).unwrap();
+    let clash = [
+        datasources::AddDataSourceParams {
+            code: "NEW_SOURCE",
+            ..Default::default()
+        },
+        datasources::AddDataSourceParams {
+            code: "Watchlist",
+            ..Default::default()
+        },
+    ];
+    assert!(handle.add_data_sources(&clash).is_err());
+    let repeated = [attrs[0].clone(), attrs[0].clone()];
+    let mut fresh = ConfigHandle::from_json(TEST_CONFIG).unwrap();
+    assert!(fresh.add_attributes(&repeated).is_err());
+    let bad_class = [attributes::AddAttributeParams {
+        attribute: "OTHER_ATTR",
+        class: "BOGUS",
+        ..attrs[0].clone()
+    }];
+    assert!(handle.add_attributes(&bad_class).is_err());
+    assert_eq!(handle.to_json().unwrap(), config);
+    assert_eq!(
+        fresh.to_json().unwrap(),
+        ConfigHandle::from_json(TEST_CONFIG)
+            .unwrap()
+            .to_json()
+            .unwrap()
+    );
+
+    // Codes of records without a usable ID still count as taken
+    let mut unnumbered = ConfigHandle::from_value(json!({"G2_CONFIG": {
+        "CFG_DSRC": [{"DSRC_CODE": "CUSTOMERS"}],
+        "CFG_ATTR": [{"ATTR_ID": "7", "ATTR_CODE": "NAME_FULL"}],
+        "CFG_FTYPE": [], "CFG_FELEM": [],
+    }}));
+    assert!(unnumbered.add_data_sources(&data_sources[..1]).is_err());
+    assert!(unnumbered.add_attributes(&attrs[..1]).is_err());
+
+    // Also once appended to an index that is already built
+    let mut appended = ConfigHandle::from_json(TEST_CONFIG).unwrap();
+    appended.add_data_sources(&data_sources[..1]).unwrap();
+    appended
+        .push_row("CFG_DSRC", json!({"DSRC_CODE": "APPENDED"}))
+        .unwrap();
+    let again = datasources::AddDataSourceParams {
+        code: "appended",
+        ..Default::default()
+    };
+    assert!(appended.add_data_source(again).is_err());
+}
+
+#[test]
+fn test_section_reads_match_full_parse() {
+    let config = json!({
+        "G2_CONFIG": {
+            "CFG_DSRC": [{"DSRC_ID": 1, "DSRC_CODE": "TEST"}],
+            "CFG_ATTR": [{"ATTR_ID": 1, "ATTR_CODE": "NAME_FULL", "ATTR_CLASS": "NAME",
+                          "FTYPE_CODE": "NAME", "FELEM_CODE": "FULL_NAME"}],
+            "CFG_FTYPE": [{"FTYPE_ID": 1, "FTYPE_CODE": "NAME"}],
+            "CFG_FELEM": [{"FELEM_ID": 2, "FELEM_CODE": "FULL_NAME", "DATA_TYPE": "string"}],
+            "CFG_FBOVR": [{"FTYPE_ID": 1, "UTYPE_CODE": "BUSINESS", "FTYPE_FREQ": "F1"}],
+            "CFG_GPLAN": [{"GPLAN_ID": 1, "GPLAN_CODE": "INGEST"}],
+            "CONFIG_BASE_VERSION": {"VERSION": "4.0.0",
+                                    "COMPATIBILITY_VERSION": {"CONFIG_VERSION": "11"}}
+        }
+    });
+    let json = config.to_string();
+    let handle = ConfigHandle::from_value(config);
+
+    assert_eq!(
+        versioning::get_version(&json).unwrap(),
+        handle.get_version().unwrap()
+    );
+    assert_eq!(
+        versioning::get_compatibility_version(&json).unwrap(),
+        handle.get_compatibility_version().unwrap()
+    );
+    assert_eq!(
+        datasources::list_data_sources(&json).unwrap(),
+        handle.list_data_sources().unwrap()
+    );
+    assert_eq!(
+        attributes::list_attributes(&json).unwrap(),
+        handle.list_attributes().unwrap()
+    );
+    assert_eq!(
+        elements::list_elements(&json).unwrap(),
+        handle.list_elements().unwrap()
+    );
+    assert_eq!(
+        behavior_overrides::get_behavior_override(&json, "NAME", "BUSINESS").unwrap(),
+        handle.get_behavior_override("NAME", "BUSINESS").unwrap()
+    );
+    assert_eq!(helpers::lookup_gplan_id(&json, "INGEST").unwrap(), 1);
+    assert_eq!(
+        config_sections::get_config_section(&json, "CFG_FTYPE", None).unwrap(),
+        handle.get_config_section("CFG_FTYPE", None).unwrap()
+    );
+
+    // Errors are unchanged
+    assert!(datasources::list_data_sources(r#"{"G2_CONFIG":{}}"#).is_err());
+    assert!(versioning::get_version(r#"{"G2_CONFIG":{"CFG_DSRC":[}}"#).is_err());
+}
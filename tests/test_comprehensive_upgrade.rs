@@ -3,6 +3,7 @@
 //! This test processes a larger subset of the actual upgrade-10-to-11.gtc script
 //! to validate end-to-end functionality.
 
+use sz_configtool_lib::batch_upgrade::BatchUpgrader;
 use sz_configtool_lib::command_processor::CommandProcessor;
 
 /// Minimal but complete config for testing upgrade commands
@@ -275,3 +276,36 @@ updateCompatibilityVersion {"fromVersion": "10", "toVersion": "11"}
         "Should track executed commands even in dry-run"
     );
 }
+
+#[test]
+fn test_batch_upgrade_files() {
+    // Same script across several tenant configs, one of them missing
+    let script = r#"
+verifyCompatibilityVersion {"expectedVersion": "10"}
+updateCompatibilityVersion {"fromVersion": "10", "toVersion": "11"}
+save
+"#;
+
+    let dir = tempfile::tempdir().unwrap();
+    let mut jobs = Vec::new();
+    for tenant in ["a", "b", "c", "missing"] {
+        let input = dir.path().join(format!("{tenant}.json"));
+        if tenant != "missing" {
+            std::fs::write(&input, MINIMAL_V10_CONFIG).unwrap();
+        }
+        jobs.push((input, dir.path().join(format!("{tenant}_v11.json"))));
+    }
+
+    let report = BatchUpgrader::new(script).unwrap().upgrade_files(&jobs);
+
+    assert_eq!(report.succeeded(), 3);
+    assert_eq!(report.failed(), 1);
+    assert!(report.outcomes[3].error.is_some());
+
+    let upgraded = std::fs::read_to_string(&jobs[1].1).unwrap();
+    let config_val: serde_json::Value = serde_json::from_str(&upgraded).unwrap();
+    assert_eq!(
+        config_val["G2_CONFIG"]["CONFIG_BASE_VERSION"]["COMPATIBILITY_VERSION"]["CONFIG_VERSION"],
+        "11"
+    );
+}